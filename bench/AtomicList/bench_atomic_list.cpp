@@ -0,0 +1,33 @@
+#include <mutex>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+#include "gungnir/AtomicList.hpp"
+using gungnir::AtomicList;
+using gungnir::List;
+
+BENCHMARK("AtomicList/load") {
+    const AtomicList<int> a(bench::makeList());
+    state.run([&a] {
+        bench::keep(a.load());
+    });
+}
+
+BENCHMARK("std::mutex/load") {
+    std::mutex m;
+    const auto xs = bench::makeList();
+    state.run([&m, &xs] {
+        std::lock_guard<std::mutex> lock(m);
+        bench::keep(List<int>(xs));
+    });
+}
+
+BENCHMARK("AtomicList/update") {
+    AtomicList<int> a;
+    state.run([&a] {
+        bench::keep(a.update([](const List<int>& xs) {
+            return xs.isEmpty() ? xs.prepend(1) : xs.tail();
+        }));
+    });
+}
@@ -0,0 +1,91 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+#include "gungnir/ColumnList.hpp"
+#include "gungnir/List.hpp"
+using gungnir::ColumnList;
+using gungnir::List;
+using gungnir::ListBuilder;
+
+namespace {
+
+// A record of 48 bytes, of which the scans below read 8.
+struct Trade {
+    double px;
+    std::int64_t ts;
+    std::int64_t id;
+    double fee;
+    int qty;
+    int venue;
+    int side;
+    int flags;
+};
+
+using Trades = ColumnList<double, std::int64_t, std::int64_t, double, int, int, int, int>;
+
+// Scans are timed over 64 times the usual number of elements, so that the
+// records do not all fit in the L1 cache.
+constexpr std::size_t scanSize = bench::N * 64;
+
+List<Trade> makeTrades()
+{
+    ListBuilder<Trade> buf;
+    for (std::size_t i = 0; i < scanSize; ++i) {
+        const auto k = static_cast<int>(i);
+        buf.append(Trade{ static_cast<double>(k % 1000), k, k, 0.5, k % 100, k % 4, k % 2, 0 });
+    }
+    return buf.result();
+}
+
+Trades toColumns(const List<Trade>& xs)
+{
+    return Trades::fromList(xs,
+                            [](const Trade& t) { return t.px; },
+                            [](const Trade& t) { return t.ts; },
+                            [](const Trade& t) { return t.id; },
+                            [](const Trade& t) { return t.fee; },
+                            [](const Trade& t) { return t.qty; },
+                            [](const Trade& t) { return t.venue; },
+                            [](const Trade& t) { return t.side; },
+                            [](const Trade& t) { return t.flags; });
+}
+
+}  // unnamed namespace
+
+BENCHMARK("ColumnList/count/List<Trade>/65536") {
+    const auto xs = makeTrades();
+    state.run([&xs] {
+        bench::keep(xs.count([](const Trade& t) { return t.px > 500.0; }));
+    });
+}
+
+BENCHMARK("ColumnList/count/rows/65536") {
+    const auto xs = toColumns(makeTrades());
+    state.run([&xs] {
+        bench::keep(xs.count([](double px, std::int64_t, std::int64_t, double, int, int, int, int) {
+            return px > 500.0;
+        }));
+    });
+}
+
+BENCHMARK("ColumnList/count/column/65536") {
+    const auto xs = toColumns(makeTrades());
+    state.run([&xs] {
+        bench::keep(xs.column<0>().count([](double px) { return px > 500.0; }));
+    });
+}
+
+BENCHMARK("ColumnList/sum/List<Trade>/65536") {
+    const auto xs = makeTrades();
+    state.run([&xs] {
+        bench::keep(xs.foldLeft(0L, [](long acc, const Trade& t) { return acc + t.qty; }));
+    });
+}
+
+BENCHMARK("ColumnList/sum/column/65536") {
+    const auto xs = toColumns(makeTrades());
+    state.run([&xs] { bench::keep(xs.column<4>().sum()); });
+}
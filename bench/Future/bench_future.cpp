@@ -0,0 +1,49 @@
+#include "bench.hpp"
+
+#include "gungnir/Future.hpp"
+using gungnir::Future;
+using gungnir::List;
+using gungnir::ListBuilder;
+using gungnir::Promise;
+using gungnir::traverse;
+
+namespace {
+
+const auto inc = [](int x) { return x + 1; };
+
+List<int> makeList(int n)
+{
+    ListBuilder<int> buf;
+    for (int i = 0; i < n; ++i) {
+        buf.append(i);
+    }
+    return buf.result();
+}
+
+}  // namespace
+
+BENCHMARK("Future/map/8/pending") {
+    state.run([] {
+        Promise<int> p;
+        const auto f = p.future().map(inc).map(inc).map(inc).map(inc)
+                                 .map(inc).map(inc).map(inc).map(inc);
+        p.success(0);
+        bench::keep(f.get());
+    });
+}
+
+BENCHMARK("Future/map/8/completed") {
+    state.run([] {
+        const auto f = Future<int>::successful(0).map(inc).map(inc).map(inc).map(inc)
+                                                 .map(inc).map(inc).map(inc).map(inc);
+        bench::keep(f.get());
+    });
+}
+
+BENCHMARK("Future/traverse/1000") {
+    const auto xs = makeList(1000);
+    state.run([&xs] {
+        const auto f = traverse(xs, [](int x) { return Future<int>::successful(x).map(inc); });
+        bench::keep(f.get());
+    });
+}
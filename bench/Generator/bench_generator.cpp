@@ -0,0 +1,53 @@
+#include "bench.hpp"
+
+#include "gungnir/Generator.hpp"
+
+#if GUNGNIR_HAS_COROUTINES
+
+#include <utility>
+
+#include "gungnir/Option.hpp"
+#include "gungnir/Stream.hpp"
+using gungnir::Generator;
+using gungnir::Option;
+using gungnir::Stream;
+
+namespace {
+
+Generator<int> range(int from, int until)
+{
+    for (auto i = from; i < until; ++i) {
+        co_yield i;
+    }
+}
+
+Stream<int> rangeStream(int from, int until)
+{
+    using R = std::pair<int, int>;
+    return Stream<int>::unfold(from, [until](int i) {
+        return i < until ? Option<R>(R(i, i + 1)) : Option<R>();
+    });
+}
+
+const auto plus = [](int a, int x) { return a + x; };
+
+}  // namespace
+
+BENCHMARK("Generator/foldLeft/1000") {
+    state.run([] { bench::keep(range(0, 1000).foldLeft(0, plus)); });
+}
+
+BENCHMARK("Generator/view/mapFilter/1000") {
+    state.run([] {
+        bench::keep(range(0, 1000).view()
+            .map([](int x) { return x * 3; })
+            .filter([](int x) { return x % 2 == 0; })
+            .foldLeft(0, plus));
+    });
+}
+
+BENCHMARK("Stream/unfold/foldLeft/1000") {
+    state.run([] { bench::keep(rangeStream(0, 1000).foldLeft(0, plus)); });
+}
+
+#endif  // GUNGNIR_HAS_COROUTINES
@@ -0,0 +1,77 @@
+#include <cstddef>
+#include <unordered_map>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+#include "gungnir/HashMap.hpp"
+using gungnir::HashMap;
+
+namespace {
+
+HashMap<int, int> makeMap(std::size_t n = bench::N)
+{
+    HashMap<int, int> m;
+    for (int i = 0; i < static_cast<int>(n); ++i) {
+        m = m.updated(i, i);
+    }
+    return m;
+}
+
+}  // unnamed namespace
+
+BENCHMARK("HashMap/construct/updated/1024") {
+    state.run([] { bench::keep(makeMap()); });
+}
+
+BENCHMARK("HashMap/construct/transient/1024") {
+    state.run([] {
+        gungnir::TransientHashMap<int, int> t;
+        for (int i = 0; i < static_cast<int>(bench::N); ++i) {
+            t.update(i, i);
+        }
+        bench::keep(t.persistent());
+    });
+}
+
+BENCHMARK("HashMap/construct/std::unordered_map/1024") {
+    state.run([] {
+        std::unordered_map<int, int> m;
+        for (int i = 0; i < static_cast<int>(bench::N); ++i) {
+            m[i] = i;
+        }
+        bench::keep(m);
+    });
+}
+
+BENCHMARK("HashMap/get/random/64K") {
+    const auto m = makeMap(1 << 16);
+    int i = 0;
+    state.run([&m, &i] {
+        i = (i * 1103515245 + 12345) & ((1 << 16) - 1);
+        bench::keep(m.get(i).getOrElse(0));
+    });
+}
+
+BENCHMARK("HashMap/get/std::unordered_map/64K") {
+    std::unordered_map<int, int> m;
+    for (int i = 0; i < (1 << 16); ++i) {
+        m[i] = i;
+    }
+    int i = 0;
+    state.run([&m, &i] {
+        i = (i * 1103515245 + 12345) & ((1 << 16) - 1);
+        bench::keep(m.find(i)->second);
+    });
+}
+
+BENCHMARK("HashMap/removed/1024") {
+    const auto m = makeMap();
+    state.run([&m] {
+        auto n = m;
+        for (int i = 0; i < static_cast<int>(bench::N); i += 2) {
+            n = n.removed(i);
+        }
+        bench::keep(n);
+    });
+}
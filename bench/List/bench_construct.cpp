@@ -0,0 +1,95 @@
+#include <forward_list>
+#include <vector>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+#include "gungnir/PoolAllocator.hpp"
+#include "gungnir/reclaim.hpp"
+
+using gungnir::List;
+
+BENCHMARK("List/construct/variadic/8") {
+    state.run([] {
+        bench::keep(List<int>(1, 2, 3, 4, 5, 6, 7, 8));
+    });
+}
+
+BENCHMARK("std::vector/construct/initializer_list/8") {
+    state.run([] {
+        bench::keep(std::vector<int>{ 1, 2, 3, 4, 5, 6, 7, 8 });
+    });
+}
+
+BENCHMARK("List/construct/range/1024") {
+    const auto v = bench::makeVector();
+    state.run([&v] {
+        bench::keep(List<int>(v.begin(), v.end()));
+    });
+}
+
+BENCHMARK("std::vector/construct/range/1024") {
+    const auto v = bench::makeVector();
+    state.run([&v] {
+        bench::keep(std::vector<int>(v.begin(), v.end()));
+    });
+}
+
+BENCHMARK("std::forward_list/construct/range/1024") {
+    const auto v = bench::makeVector();
+    state.run([&v] {
+        bench::keep(std::forward_list<int>(v.begin(), v.end()));
+    });
+}
+
+BENCHMARK("List/construct/prepend/1024") {
+    state.run([] {
+        List<int> xs;
+        for (int i = 0; i < static_cast<int>(bench::N); ++i) {
+            xs = xs.prepend(i);
+        }
+        bench::keep(xs);
+    });
+}
+
+BENCHMARK("std::forward_list/construct/push_front/1024") {
+    state.run([] {
+        std::forward_list<int> xs;
+        for (int i = 0; i < static_cast<int>(bench::N); ++i) {
+            xs.push_front(i);
+        }
+        bench::keep(xs);
+    });
+}
+
+BENCHMARK("std::vector/construct/push_back/1024") {
+    state.run([] {
+        std::vector<int> xs;
+        for (int i = 0; i < static_cast<int>(bench::N); ++i) {
+            xs.push_back(i);
+        }
+        bench::keep(xs);
+    });
+}
+
+BENCHMARK("List/construct/variadic/8/pool") {
+    state.run([] {
+        bench::keep(List<int, gungnir::PoolAllocator<int>>(1, 2, 3, 4, 5, 6, 7, 8));
+    });
+}
+
+// The latency of dropping the last reference to a long list; under
+// DeferredReclaim most of the nodes are freed on another thread.
+BENCHMARK("List/drop/4096") {
+    const auto v = bench::makeVector(4096);
+    state.run([&v] { return List<int>(v.begin(), v.end()); },
+              [](List<int> xs) { bench::keep(xs); });
+}
+
+BENCHMARK("List/drop/4096/deferred") {
+    using L = List<int, gungnir::DeferredAllocator<int>>;
+    const auto v = bench::makeVector(4096);
+    state.run([&v] { return L(v.begin(), v.end()); },
+              [](L xs) { bench::keep(xs); });
+    gungnir::waitForReclamation();
+}
@@ -0,0 +1,141 @@
+#include <cstddef>
+#include <forward_list>
+#include <vector>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+using gungnir::List;
+
+BENCHMARK("List/iterate/StdIterator/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        long sum = 0;
+        for (const auto& x : xs) {
+            sum += x;
+        }
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("List/iterate/foreach/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        long sum = 0;
+        xs.foreach([&sum](int x) { sum += x; });
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("std::vector/iterate/1024") {
+    const auto xs = bench::makeVector();
+    state.run([&xs] {
+        long sum = 0;
+        for (const auto& x : xs) {
+            sum += x;
+        }
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("std::forward_list/iterate/1024") {
+    const auto xs = bench::makeForwardList();
+    state.run([&xs] {
+        long sum = 0;
+        for (const auto& x : xs) {
+            sum += x;
+        }
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("List/operator[]/stride64/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        long sum = 0;
+        for (std::size_t i = 0; i < xs.size(); i += 64) {
+            sum += xs[i];
+        }
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("std::vector/operator[]/stride64/1024") {
+    const auto xs = bench::makeVector();
+    state.run([&xs] {
+        long sum = 0;
+        for (std::size_t i = 0; i < xs.size(); i += 64) {
+            sum += xs[i];
+        }
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("List/last/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] { bench::keep(xs.last()); });
+}
+
+BENCHMARK("List/tail+last/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] { bench::keep(xs.tail().last()); });
+}
+
+BENCHMARK("List/iterate/tail/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        long sum = 0;
+        for (auto ys = xs; !ys.isEmpty(); ys = ys.tail()) {
+            sum += ys.head();
+        }
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("List/iterate/tail/LocalRefCount/1024") {
+    const auto v = bench::makeVector();
+    const List<int, gungnir::LocalAllocator<int>> xs(v.begin(), v.end());
+    state.run([&xs] {
+        long sum = 0;
+        for (auto ys = xs; !ys.isEmpty(); ys = ys.tail()) {
+            sum += ys.head();
+        }
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("List/iterate/borrow/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        long sum = 0;
+        for (auto ys = xs.borrow(); !ys.isEmpty(); ys = ys.tail()) {
+            sum += ys.head();
+        }
+        bench::keep(sum);
+    });
+}
+
+// Each iteration reads every element of the list by position.
+
+BENCHMARK("List/iterate/operator[]/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        long sum = 0;
+        for (std::size_t i = 0; i < xs.size(); ++i) {
+            sum += xs[i];
+        }
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("List/iterate/indexed/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        const auto ix = xs.indexed();
+        long sum = 0;
+        for (std::size_t i = 0; i < ix.size(); ++i) {
+            sum += ix[i];
+        }
+        bench::keep(sum);
+    });
+}
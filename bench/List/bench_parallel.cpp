@@ -0,0 +1,70 @@
+#include <cmath>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+using gungnir::List;
+using gungnir::par;
+
+namespace {
+
+constexpr std::size_t M = 1 << 18;
+
+// Enough work per element for the parallel versions to pay off.
+const auto heavy = [](int x) {
+    double y = x;
+    for (int i = 0; i < 32; ++i) {
+        y = std::sqrt(y + i);
+    }
+    return y;
+};
+const auto heavyEven = [](int x) { return heavy(x) < 5.0; };
+
+}  // unnamed namespace
+
+BENCHMARK("List/map/heavy/262144") {
+    const auto xs = bench::makeList(M);
+    state.run([&xs] { bench::keep(xs.map(heavy)); });
+}
+
+BENCHMARK("List/map/par/heavy/262144") {
+    const auto xs = bench::makeList(M);
+    state.run([&xs] { bench::keep(xs.map(par, heavy)); });
+}
+
+BENCHMARK("List/filter/heavy/262144") {
+    const auto xs = bench::makeList(M);
+    state.run([&xs] { bench::keep(xs.filter(heavyEven)); });
+}
+
+BENCHMARK("List/filter/par/heavy/262144") {
+    const auto xs = bench::makeList(M);
+    state.run([&xs] { bench::keep(xs.filter(par, heavyEven)); });
+}
+
+BENCHMARK("List/sorted/262144") {
+    const auto xs = bench::makeList(M);
+    state.run([&xs] { bench::keep(xs.sorted(true)); });
+}
+
+BENCHMARK("List/sorted/par/262144") {
+    const auto xs = bench::makeList(M);
+    state.run([&xs] { bench::keep(xs.sorted(par)); });
+}
+
+BENCHMARK("List/sorted/byKey/262144") {
+    const auto xs = bench::makeList(M);
+    state.run([&xs] {
+        bench::keep(xs.sorted([](int x, int y) { return x % 1000 < y % 1000; }, true));
+    });
+}
+
+BENCHMARK("List/sortedBy/262144") {
+    const auto xs = bench::makeList(M);
+    state.run([&xs] { bench::keep(xs.sortedBy([](int x) { return x % 1000; })); });
+}
+
+BENCHMARK("List/sortedBy/par/262144") {
+    const auto xs = bench::makeList(M);
+    state.run([&xs] { bench::keep(xs.sortedBy(par, [](int x) { return x % 1000; })); });
+}
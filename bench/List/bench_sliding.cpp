@@ -0,0 +1,54 @@
+#include <cstddef>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+using gungnir::List;
+
+// Each iteration computes the sums of all 64-element windows of a list of
+// 1024 elements.
+
+namespace {
+
+constexpr std::size_t width = 64;
+
+long plus(long a, int x)
+{
+    return a + x;
+}
+
+long minus(long a, int x)
+{
+    return a - x;
+}
+
+}  // unnamed namespace
+
+BENCHMARK("List/sliding/drop+take/64of1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        long total = 0;
+        for (std::size_t i = 0; i + width <= xs.size(); ++i) {
+            total += xs.drop(i).take(width).foldLeft(0L, plus);
+        }
+        bench::keep(total);
+    });
+}
+
+BENCHMARK("List/sliding/foldLeft/64of1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        long total = 0;
+        for (const auto& w : xs.sliding(width)) {
+            total += w.foldLeft(0L, plus);
+        }
+        bench::keep(total);
+    });
+}
+
+BENCHMARK("List/sliding/scanLeft/64of1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        bench::keep(xs.sliding(width).scanLeft(0L, plus, minus));
+    });
+}
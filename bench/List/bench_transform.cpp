@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <forward_list>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+using gungnir::List;
+
+namespace {
+
+const auto inc = [](int x) { return x + 1; };
+const auto even = [](int x) { return x % 2 == 0; };
+
+}  // unnamed namespace
+
+BENCHMARK("List/map/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] { bench::keep(xs.map(inc)); });
+}
+
+BENCHMARK("List/map+map/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        const auto ys = xs.map(inc);
+        bench::keep(ys.map(inc));
+    });
+}
+
+BENCHMARK("List/map+map/rvalue/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        auto ys = xs.map(inc);
+        bench::keep(std::move(ys).map(inc));
+    });
+}
+
+BENCHMARK("std::vector/map/1024") {
+    const auto xs = bench::makeVector();
+    state.run([&xs] {
+        std::vector<int> ys;
+        ys.reserve(xs.size());
+        std::transform(xs.begin(), xs.end(), std::back_inserter(ys), inc);
+        bench::keep(ys);
+    });
+}
+
+BENCHMARK("List/filter/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] { bench::keep(xs.filter(even)); });
+}
+
+BENCHMARK("std::vector/filter/1024") {
+    const auto xs = bench::makeVector();
+    state.run([&xs] {
+        std::vector<int> ys;
+        std::copy_if(xs.begin(), xs.end(), std::back_inserter(ys), even);
+        bench::keep(ys);
+    });
+}
+
+BENCHMARK("List/flatMap/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] {
+        bench::keep(xs.flatMap([](int x) { return List<int>(x, x); }));
+    });
+}
+
+BENCHMARK("List/sorted/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] { bench::keep(xs.sorted()); });
+}
+
+BENCHMARK("std::vector/sort/1024") {
+    const auto xs = bench::makeVector();
+    state.run([&xs] {
+        auto ys = xs;
+        std::sort(ys.begin(), ys.end());
+        bench::keep(ys);
+    });
+}
+
+BENCHMARK("std::forward_list/sort/1024") {
+    const auto xs = bench::makeForwardList();
+    state.run([&xs] {
+        auto ys = xs;
+        ys.sort();
+        bench::keep(ys);
+    });
+}
+
+BENCHMARK("List/zip/1024") {
+    const auto xs = bench::makeList();
+    const auto ys = bench::makeList();
+    state.run([&xs, &ys] { bench::keep(xs.zip(ys)); });
+}
+
+BENCHMARK("List/concat/1024+1024") {
+    const auto xs = bench::makeList();
+    const auto ys = bench::makeList();
+    state.run([&xs, &ys] { bench::keep(xs.concat(ys)); });
+}
+
+BENCHMARK("List/concat/rvalue/1024+1024") {
+    const auto ys = bench::makeList();
+    state.run([&ys] { bench::keep(bench::makeList().concat(ys)); });
+}
+
+BENCHMARK("List/concat/accumulate/128x8") {
+    state.run([] {
+        gungnir::List<int> acc;
+        for (int i = 0; i < 128; ++i) {
+            acc = acc.concat(gungnir::List<int>(i, i, i, i, i, i, i, i));
+        }
+        bench::keep(acc);
+    });
+}
+
+BENCHMARK("List/concat/rvalue/accumulate/128x8") {
+    state.run([] {
+        gungnir::List<int> acc;
+        for (int i = 0; i < 128; ++i) {
+            acc = std::move(acc).concat(gungnir::List<int>(i, i, i, i, i, i, i, i));
+        }
+        bench::keep(acc);
+    });
+}
+
+BENCHMARK("std::vector/concat/1024+1024") {
+    const auto xs = bench::makeVector();
+    const auto ys = bench::makeVector();
+    state.run([&xs, &ys] {
+        std::vector<int> zs;
+        zs.reserve(xs.size() + ys.size());
+        zs.insert(zs.end(), xs.begin(), xs.end());
+        zs.insert(zs.end(), ys.begin(), ys.end());
+        bench::keep(zs);
+    });
+}
+
+BENCHMARK("List/updated/middle/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] { bench::keep(xs.updated(bench::N / 2, 42)); });
+}
+
+BENCHMARK("std::vector/updated/middle/1024") {
+    const auto xs = bench::makeVector();
+    state.run([&xs] {
+        auto ys = xs;
+        ys[bench::N / 2] = 42;
+        bench::keep(ys);
+    });
+}
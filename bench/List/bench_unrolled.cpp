@@ -0,0 +1,89 @@
+#include <cstddef>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+#include "gungnir/UnrolledList.hpp"
+using gungnir::UnrolledList;
+
+namespace {
+
+UnrolledList<int> makeUnrolledList(std::size_t n = bench::N)
+{
+    const auto v = bench::makeVector(n);
+    return UnrolledList<int>(v.begin(), v.end());
+}
+
+}  // unnamed namespace
+
+BENCHMARK("UnrolledList/construct/prepend/1024") {
+    state.run([] {
+        UnrolledList<int> xs;
+        for (int i = 0; i < static_cast<int>(bench::N); ++i) {
+            xs = xs.prepend(i);
+        }
+        bench::keep(xs);
+    });
+}
+
+BENCHMARK("UnrolledList/iterate/StdIterator/1024") {
+    const auto xs = makeUnrolledList();
+    state.run([&xs] {
+        long sum = 0;
+        for (const auto& x : xs) {
+            sum += x;
+        }
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("UnrolledList/iterate/foreach/1024") {
+    const auto xs = makeUnrolledList();
+    state.run([&xs] {
+        long sum = 0;
+        xs.foreach([&sum](int x) { sum += x; });
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("List/contains/missing/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] { bench::keep(xs.contains(-1)); });
+}
+
+BENCHMARK("UnrolledList/contains/missing/1024") {
+    const auto xs = makeUnrolledList();
+    state.run([&xs] { bench::keep(xs.contains(-1)); });
+}
+
+BENCHMARK("List/operator==/1024") {
+    const auto xs = bench::makeList();
+    const auto ys = bench::makeList();
+    state.run([&xs, &ys] { bench::keep(xs == ys); });
+}
+
+BENCHMARK("UnrolledList/operator==/1024") {
+    const auto xs = makeUnrolledList();
+    const auto ys = makeUnrolledList();
+    state.run([&xs, &ys] { bench::keep(xs == ys); });
+}
+
+BENCHMARK("UnrolledList/map/1024") {
+    const auto xs = makeUnrolledList();
+    state.run([&xs] { bench::keep(xs.map([](int x) { return x + 1; })); });
+}
+
+BENCHMARK("List/sum/1024") {
+    const auto xs = bench::makeList();
+    state.run([&xs] { bench::keep(xs.sum()); });
+}
+
+BENCHMARK("UnrolledList/sum/1024") {
+    const auto xs = makeUnrolledList();
+    state.run([&xs] { bench::keep(xs.sum()); });
+}
+
+BENCHMARK("UnrolledList/count/1024") {
+    const auto xs = makeUnrolledList();
+    state.run([&xs] { bench::keep(xs.count(3)); });
+}
@@ -0,0 +1,39 @@
+#ifndef GUNGNIR_BENCH_LIST_COMMON_HPP
+#define GUNGNIR_BENCH_LIST_COMMON_HPP
+
+#include <cstddef>
+#include <forward_list>
+#include <vector>
+
+#include "gungnir/List.hpp"
+
+namespace bench {
+
+/** Number of elements used by the List benchmarks. */
+constexpr std::size_t N = 1024;
+
+inline std::vector<int> makeVector(std::size_t n = N)
+{
+    std::vector<int> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        v.push_back(static_cast<int>((i * 7919) % n));
+    }
+    return v;
+}
+
+inline std::forward_list<int> makeForwardList(std::size_t n = N)
+{
+    const auto v = makeVector(n);
+    return std::forward_list<int>(v.begin(), v.end());
+}
+
+inline gungnir::List<int> makeList(std::size_t n = N)
+{
+    const auto v = makeVector(n);
+    return gungnir::List<int>(v.begin(), v.end());
+}
+
+}  // namespace bench
+
+#endif  // GUNGNIR_BENCH_LIST_COMMON_HPP
@@ -0,0 +1,45 @@
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "bench.hpp"
+
+#include "gungnir/Option.hpp"
+using gungnir::Option;
+
+BENCHMARK("Option/move/int") {
+    Option<int> a(42);
+    state.run([&a] {
+        Option<int> b(std::move(a));
+        bench::keep(b);
+        a = std::move(b);
+    });
+}
+
+BENCHMARK("Option/move/string") {
+    Option<std::string> a(std::string(64, 'x'));
+    state.run([&a] {
+        Option<std::string> b(std::move(a));
+        bench::keep(b);
+        a = std::move(b);
+    });
+}
+
+BENCHMARK("std::unique_ptr/move/int") {
+    auto a = std::unique_ptr<int>(new int(42));
+    state.run([&a] {
+        auto b = std::move(a);
+        bench::keep(b);
+        a = std::move(b);
+    });
+}
+
+BENCHMARK("Option/map/nonEmpty") {
+    const Option<int> a(42);
+    state.run([&a] { bench::keep(a.map([](int x) { return x + 1; })); });
+}
+
+BENCHMARK("Option/map/empty") {
+    const Option<int> a;
+    state.run([&a] { bench::keep(a.map([](int x) { return x + 1; })); });
+}
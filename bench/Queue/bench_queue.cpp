@@ -0,0 +1,65 @@
+#include <deque>
+
+#include "bench.hpp"
+
+#include "gungnir/Deque.hpp"
+#include "gungnir/List.hpp"
+#include "gungnir/Queue.hpp"
+using gungnir::Deque;
+using gungnir::List;
+using gungnir::Queue;
+
+// Each iteration appends 1000 elements to an empty queue, then removes
+// them all from its head.
+
+BENCHMARK("Queue/fifo/1000") {
+    state.run([] {
+        Queue<int> q;
+        for (int i = 0; i < 1000; ++i) {
+            q = q.appended(i);
+        }
+        while (!q.isEmpty()) {
+            bench::keep(q.head());
+            q = std::move(q).tail();
+        }
+    });
+}
+
+BENCHMARK("Deque/fifo/1000") {
+    state.run([] {
+        Deque<int> d;
+        for (int i = 0; i < 1000; ++i) {
+            d = d.appended(i);
+        }
+        while (!d.isEmpty()) {
+            bench::keep(d.head());
+            d = d.tail();
+        }
+    });
+}
+
+BENCHMARK("List/concat/fifo/1000") {
+    state.run([] {
+        List<int> xs;
+        for (int i = 0; i < 1000; ++i) {
+            xs = xs.concat(List<int>(i));
+        }
+        while (!xs.isEmpty()) {
+            bench::keep(xs.head());
+            xs = xs.tail();
+        }
+    });
+}
+
+BENCHMARK("std::deque/fifo/1000") {
+    state.run([] {
+        std::deque<int> d;
+        for (int i = 0; i < 1000; ++i) {
+            d.push_back(i);
+        }
+        while (!d.empty()) {
+            bench::keep(d.front());
+            d.pop_front();
+        }
+    });
+}
@@ -0,0 +1,71 @@
+#include <cstddef>
+#include <string>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+#include "gungnir/List.hpp"
+#include "gungnir/Rope.hpp"
+using gungnir::List;
+using gungnir::ListBuilder;
+using gungnir::Rope;
+
+namespace {
+
+// A document of `bench::N` lines of about a kilobyte each.
+List<std::string> makeLines()
+{
+    ListBuilder<std::string> buf;
+    for (std::size_t i = 0; i < bench::N; ++i) {
+        buf.append(std::string(1000, static_cast<char>('a' + i % 26)) + "\n");
+    }
+    return buf.result();
+}
+
+}  // unnamed namespace
+
+BENCHMARK("Rope/edit/insertAt/1024") {
+    const auto doc = Rope::fromList(makeLines());
+    state.run([&doc] {
+        auto r = doc;
+        for (std::size_t i = 0; i < 64; ++i) {
+            r = r.insertAt(r.size() / 2 + i * 31, "edit");
+        }
+        bench::keep(r);
+    });
+}
+
+BENCHMARK("Rope/edit/List::updated/1024") {
+    const auto doc = makeLines();
+    state.run([&doc] {
+        auto xs = doc;
+        for (std::size_t i = 0; i < 64; ++i) {
+            const auto at = xs.size() / 2 + i % 8;
+            xs = xs.updated(at, xs[at] + "edit");
+        }
+        bench::keep(xs);
+    });
+}
+
+BENCHMARK("Rope/edit/std::string::insert/1024") {
+    std::string doc;
+    makeLines().foreach([&doc](const std::string& s) { doc += s; });
+    state.run([&doc] {
+        auto s = doc;
+        for (std::size_t i = 0; i < 64; ++i) {
+            s.insert(s.size() / 2 + i * 31, "edit");
+        }
+        bench::keep(s);
+    });
+}
+
+BENCHMARK("Rope/charAt/1024") {
+    const auto doc = Rope::fromList(makeLines());
+    state.run([&doc] {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < doc.size(); i += 997) {
+            n += doc.charAt(i) == 'a';
+        }
+        bench::keep(n);
+    });
+}
@@ -0,0 +1,19 @@
+#include "bench.hpp"
+
+#include "gungnir/StaticList.hpp"
+using gungnir::List;
+using gungnir::StaticList;
+
+BENCHMARK("List/constructFold/8") {
+    state.run([] {
+        const List<int> xs(1, 2, 3, 4, 5, 6, 7, 8);
+        bench::keep(xs.foldLeft(0, [](int a, int x) { return a + x; }));
+    });
+}
+
+BENCHMARK("StaticList/constructFold/8") {
+    state.run([] {
+        const StaticList<int, 8> xs(1, 2, 3, 4, 5, 6, 7, 8);
+        bench::keep(xs.foldLeft(0, [](int a, int x) { return a + x; }));
+    });
+}
@@ -0,0 +1,154 @@
+#include <cstddef>
+#include <map>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+#include "gungnir/List.hpp"
+#include "gungnir/TreeMap.hpp"
+#include "gungnir/TreeSet.hpp"
+using gungnir::List;
+using gungnir::ListBuilder;
+using gungnir::TreeMap;
+using gungnir::TreeSet;
+
+namespace {
+
+// A permutation of [0, n), so that insertions land all over the tree.
+int scrambled(int i, std::size_t n)
+{
+    return static_cast<int>((static_cast<std::size_t>(i) * 7919) % n);
+}
+
+TreeMap<int, int> makeMap(std::size_t n = bench::N)
+{
+    TreeMap<int, int> m;
+    for (int i = 0; i < static_cast<int>(n); ++i) {
+        m = m.updated(scrambled(i, n), i);
+    }
+    return m;
+}
+
+List<int> sortedKeys(std::size_t n)
+{
+    ListBuilder<int> buf;
+    for (int i = 0; i < static_cast<int>(n); ++i) {
+        buf.append(i);
+    }
+    return buf.result();
+}
+
+}  // unnamed namespace
+
+BENCHMARK("TreeMap/construct/updated/1024") {
+    state.run([] { bench::keep(makeMap()); });
+}
+
+BENCHMARK("TreeMap/construct/std::map/1024") {
+    state.run([] {
+        std::map<int, int> m;
+        for (int i = 0; i < static_cast<int>(bench::N); ++i) {
+            m[scrambled(i, bench::N)] = i;
+        }
+        bench::keep(m);
+    });
+}
+
+BENCHMARK("TreeSet/construct/fromSorted/1024") {
+    const auto xs = sortedKeys(bench::N);
+    state.run([&xs] { bench::keep(TreeSet<int>::fromSorted(xs)); });
+}
+
+// The index this replaces: re-sorting a list after each insertion.
+BENCHMARK("TreeSet/construct/List::sorted/256") {
+    state.run([] {
+        List<int> xs;
+        for (int i = 0; i < 256; ++i) {
+            xs = xs.prepend(scrambled(i, 256)).sorted();
+        }
+        bench::keep(xs);
+    });
+}
+
+BENCHMARK("TreeSet/construct/added/256") {
+    state.run([] {
+        TreeSet<int> s;
+        for (int i = 0; i < 256; ++i) {
+            s = s.added(scrambled(i, 256));
+        }
+        bench::keep(s);
+    });
+}
+
+BENCHMARK("TreeMap/get/random/64K") {
+    const auto m = makeMap(1 << 16);
+    int i = 0;
+    state.run([&m, &i] {
+        i = (i * 1103515245 + 12345) & ((1 << 16) - 1);
+        bench::keep(m.get(i).getOrElse(0));
+    });
+}
+
+BENCHMARK("TreeMap/get/std::map/64K") {
+    std::map<int, int> m;
+    for (int i = 0; i < (1 << 16); ++i) {
+        m[i] = i;
+    }
+    int i = 0;
+    state.run([&m, &i] {
+        i = (i * 1103515245 + 12345) & ((1 << 16) - 1);
+        bench::keep(m.find(i)->second);
+    });
+}
+
+// Each iteration sums the 64 entries of a range of a map of 64K entries.
+
+BENCHMARK("TreeMap/range/64of64K") {
+    const auto m = makeMap(1 << 16);
+    int i = 0;
+    state.run([&m, &i] {
+        i = (i * 1103515245 + 12345) & ((1 << 15) - 1);
+        bench::keep(m.range(i, i + 64).foldLeft(0L, [](long a, const std::pair<const int, int>& e) {
+            return a + e.second;
+        }));
+    });
+}
+
+BENCHMARK("TreeMap/range/std::map/64of64K") {
+    std::map<int, int> m;
+    for (int i = 0; i < (1 << 16); ++i) {
+        m[scrambled(i, 1 << 16)] = i;
+    }
+    int i = 0;
+    state.run([&m, &i] {
+        i = (i * 1103515245 + 12345) & ((1 << 15) - 1);
+        long a = 0;
+        for (auto it = m.lower_bound(i), end = m.lower_bound(i + 64); it != end; ++it) {
+            a += it->second;
+        }
+        bench::keep(a);
+    });
+}
+
+BENCHMARK("TreeSet/range/List::dropWhile/64of64K") {
+    const auto xs = sortedKeys(1 << 16);
+    int i = 0;
+    state.run([&xs, &i] {
+        i = (i * 1103515245 + 12345) & ((1 << 15) - 1);
+        const auto lo = i;
+        bench::keep(xs.dropWhile([lo](int x) { return x < lo; })
+                      .takeWhile([lo](int x) { return x < lo + 64; })
+                      .sum());
+    });
+}
+
+BENCHMARK("TreeMap/removed/1024") {
+    const auto m = makeMap();
+    state.run([&m] {
+        auto n = m;
+        for (int i = 0; i < static_cast<int>(bench::N); i += 2) {
+            n = n.removed(i);
+        }
+        bench::keep(n);
+    });
+}
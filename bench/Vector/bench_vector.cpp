@@ -0,0 +1,141 @@
+#include <cstddef>
+#include <vector>
+
+#include "bench.hpp"
+#include "List/common.hpp"
+
+#include "gungnir/Vector.hpp"
+using gungnir::Vector;
+
+namespace {
+
+Vector<int> makeVector(std::size_t n = bench::N)
+{
+    const auto v = bench::makeVector(n);
+    return Vector<int>(v.begin(), v.end());
+}
+
+}  // unnamed namespace
+
+BENCHMARK("Vector/construct/range/1024") {
+    const auto v = bench::makeVector();
+    state.run([&v] {
+        bench::keep(Vector<int>(v.begin(), v.end()));
+    });
+}
+
+BENCHMARK("Vector/construct/appended/1024") {
+    state.run([] {
+        Vector<int> xs;
+        for (int i = 0; i < static_cast<int>(bench::N); ++i) {
+            xs = xs.appended(i);
+        }
+        bench::keep(xs);
+    });
+}
+
+BENCHMARK("Vector/construct/transient/1024") {
+    state.run([] {
+        gungnir::TransientVector<int> t;
+        for (int i = 0; i < static_cast<int>(bench::N); ++i) {
+            t.append(i);
+        }
+        bench::keep(t.persistent());
+    });
+}
+
+BENCHMARK("Vector/map/1024") {
+    const auto xs = makeVector();
+    state.run([&xs] { bench::keep(xs.map([](int x) { return x + 1; })); });
+}
+
+BENCHMARK("Vector/iterate/StdIterator/1024") {
+    const auto xs = makeVector();
+    state.run([&xs] {
+        long sum = 0;
+        for (const auto& x : xs) {
+            sum += x;
+        }
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("Vector/iterate/foreach/1024") {
+    const auto xs = makeVector();
+    state.run([&xs] {
+        long sum = 0;
+        xs.foreach([&sum](int x) { sum += x; });
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("Vector/operator[]/stride64/1024") {
+    const auto xs = makeVector();
+    state.run([&xs] {
+        long sum = 0;
+        for (std::size_t i = 0; i < xs.size(); i += 64) {
+            sum += xs[i];
+        }
+        bench::keep(sum);
+    });
+}
+
+BENCHMARK("Vector/operator[]/random/1M") {
+    const auto xs = makeVector(1 << 20);
+    std::size_t i = 0;
+    state.run([&xs, &i] {
+        i = (i * 1103515245 + 12345) & ((1 << 20) - 1);
+        bench::keep(xs[i]);
+    });
+}
+
+BENCHMARK("Vector/updated/middle/1M") {
+    const auto xs = makeVector(1 << 20);
+    state.run([&xs] { bench::keep(xs.updated(1 << 19, 42)); });
+}
+
+BENCHMARK("Vector/sum/1024") {
+    const auto xs = makeVector();
+    state.run([&xs] { bench::keep(xs.sum()); });
+}
+
+BENCHMARK("Vector/contains/missing/1024") {
+    const auto xs = makeVector();
+    state.run([&xs] { bench::keep(xs.contains(-1)); });
+}
+
+BENCHMARK("Vector/count/1024") {
+    const auto xs = makeVector();
+    state.run([&xs] { bench::keep(xs.count(3)); });
+}
+
+BENCHMARK("Vector/concat/1M+1M") {
+    const auto xs = makeVector(1 << 20);
+    const auto ys = makeVector(1 << 20).drop(5);
+    state.run([&xs, &ys] { bench::keep(xs.concat(ys)); });
+}
+
+BENCHMARK("Vector/slice/middle/1M") {
+    const auto xs = makeVector(1 << 20);
+    state.run([&xs] { bench::keep(xs.slice(1000, (1 << 20) - 1000)); });
+}
+
+BENCHMARK("Vector/insertAt/middle/1M") {
+    const auto xs = makeVector(1 << 20);
+    state.run([&xs] { bench::keep(xs.insertAt(1 << 19, 42)); });
+}
+
+BENCHMARK("Vector/operator[]/random/1M/relaxed") {
+    auto xs = makeVector(1 << 20);
+    for (std::size_t i = 0; i < 64; ++i) {
+        xs = xs.insertAt(i * 16001, 42);
+    }
+    const auto n = xs.size();
+    state.run([&xs, n] {
+        long sum = 0;
+        for (std::size_t i = 0, k = 12345; i < 64; ++i, k = (k * 7919 + 1) % n) {
+            sum += xs[k];
+        }
+        bench::keep(sum);
+    });
+}
@@ -0,0 +1,198 @@
+/**
+ * @file bench.hpp
+ * A minimal self-contained micro-benchmark harness.
+ *
+ * Benchmarks are registered with `BENCHMARK(name)`; the body receives a
+ * `bench::State&` and is expected to run `state.iterations()` repetitions
+ * of the operation being measured:
+ *
+ *     BENCHMARK("List/map/1000") {
+ *         const auto xs = makeList(1000);
+ *         state.run([&] { bench::keep(xs.map(inc)); });
+ *     }
+ *
+ * The iteration count is calibrated until a run takes at least a minimum
+ * wall time, and the best of several runs is reported in nanoseconds per
+ * iteration. If `GUNGNIR_LIST_STATS` is defined, the number of `List` node
+ * allocations per iteration is reported as well.
+ */
+
+#ifndef GUNGNIR_BENCH_HPP
+#define GUNGNIR_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gungnir/ListStats.hpp"
+
+namespace bench {
+
+/**
+ * Prevents the compiler from optimizing away the computation of `x`.
+ */
+template<typename T>
+inline void keep(const T& x)
+{
+    asm volatile("" : : "g"(&x) : "memory");
+}
+
+/**
+ * Forces the compiler to assume all memory may have been read or written.
+ */
+inline void clobber()
+{
+    asm volatile("" : : : "memory");
+}
+
+class State final {
+public:
+    explicit State(std::size_t iterations) noexcept
+        : iterations_(iterations)
+    {}
+
+    std::size_t iterations() const { return iterations_; }
+
+    /**
+     * Runs `f` `iterations()` times and records the elapsed time.
+     */
+    template<typename Fn>
+    void run(Fn f)
+    {
+        const auto stats = gungnir::listStats();
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < iterations_; ++i) {
+            f();
+            clobber();
+        }
+        elapsed_ = Clock::now() - start;
+        stats_ = gungnir::listStats() - stats;
+    }
+
+    /**
+     * Runs `f(setup())` `iterations()` times and records the time spent in
+     * `f` alone, for operations that consume state built per iteration.
+     */
+    template<typename Setup, typename Fn>
+    void run(Setup setup, Fn f)
+    {
+        const auto stats = gungnir::listStats();
+        elapsed_ = Clock::duration::zero();
+        for (std::size_t i = 0; i < iterations_; ++i) {
+            auto x = setup();
+            clobber();
+            const auto start = Clock::now();
+            f(std::move(x));
+            clobber();
+            elapsed_ += Clock::now() - start;
+        }
+        stats_ = gungnir::listStats() - stats;
+    }
+
+    double seconds() const
+    {
+        return std::chrono::duration<double>(elapsed_).count();
+    }
+
+    /** Returns the `List` counters accumulated by the last `run`. */
+    const gungnir::ListStats& stats() const { return stats_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::size_t iterations_;
+    Clock::duration elapsed_ = Clock::duration::zero();
+    gungnir::ListStats stats_;
+};
+
+using Function = void (*)(State&);
+
+struct Benchmark final {
+    const char* name;
+    Function fn;
+};
+
+inline std::vector<Benchmark>& registry()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Registrar final {
+    Registrar(const char* name, Function fn)
+    {
+        registry().push_back({ name, fn });
+    }
+};
+
+/**
+ * Runs every registered benchmark whose name contains one of `filters`
+ * (or all of them if `filters` is empty) and prints the results.
+ */
+inline int runAll(const std::vector<std::string>& filters)
+{
+    constexpr double minSeconds = 0.05;
+    constexpr int repetitions = 5;
+
+    std::printf("%-48s %14s %12s %14s\n",
+            "benchmark", "ns/iter", "iterations", "allocs/iter");
+    for (const auto& b : registry()) {
+        bool selected = filters.empty();
+        for (const auto& f : filters) {
+            selected = selected || std::strstr(b.name, f.c_str()) != nullptr;
+        }
+        if (!selected) {
+            continue;
+        }
+
+        std::size_t n = 1;
+        for (;;) {
+            State state(n);
+            b.fn(state);
+            if (state.seconds() >= minSeconds || n >= (std::size_t(1) << 40)) {
+                break;
+            }
+            n *= state.seconds() > minSeconds / 100 ? 2 : 10;
+        }
+
+        double best = -1;
+        double allocs = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            State state(n);
+            b.fn(state);
+            const auto ns = state.seconds() * 1e9 / static_cast<double>(n);
+            if (best < 0 || ns < best) {
+                best = ns;
+            }
+            allocs = static_cast<double>(state.stats().nodeAllocations)
+                / static_cast<double>(n);
+        }
+#ifdef GUNGNIR_LIST_STATS
+        std::printf("%-48s %14.2f %12zu %14.2f\n", b.name, best, n, allocs);
+#else
+        (void) allocs;
+        std::printf("%-48s %14.2f %12zu %14s\n", b.name, best, n, "-");
+#endif
+        std::fflush(stdout);
+    }
+    return 0;
+}
+
+}  // namespace bench
+
+#define BENCH_CAT_(a, b) a ## b
+#define BENCH_CAT(a, b) BENCH_CAT_(a, b)
+#define BENCH_UNIQUE(prefix) BENCH_CAT(prefix, __LINE__)
+
+#define BENCHMARK(name) \
+    static void BENCH_UNIQUE(bench_fn_)(::bench::State&); \
+    static const ::bench::Registrar BENCH_UNIQUE(bench_reg_)( \
+            name, &BENCH_UNIQUE(bench_fn_)); \
+    static void BENCH_UNIQUE(bench_fn_)(::bench::State& state)
+
+#endif  // GUNGNIR_BENCH_HPP
@@ -0,0 +1,9 @@
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+int main(int argc, char* argv[])
+{
+    return bench::runAll(std::vector<std::string>(argv + 1, argv + argc));
+}
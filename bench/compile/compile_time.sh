@@ -0,0 +1,40 @@
+#!/bin/sh
+# Measures how long translation units using List take to compile: one
+# including only List_fwd.hpp, and one including List.hpp with and without
+# the extern templates of GUNGNIR_EXTERN_TEMPLATES, at -O0 and -O2. Each is
+# compiled several times and the fastest run reported, in milliseconds,
+# along with the size of the object file. Requires GNU date.
+#
+# Usage: bench/compile/compile_time.sh [runs]
+
+set -e
+
+src=$(cd "$(dirname "$0")" && pwd)
+runs=${1:-5}
+cxx=${CXX:-c++}
+std=${GUNGNIR_CXX_STANDARD:-11}
+out=$(mktemp -d)
+trap 'rm -rf "$out"' EXIT
+
+measure() {
+  name=$1
+  shift
+  best=
+  i=0
+  while [ "$i" -lt "$runs" ]; do
+    start=$(date +%s%N)
+    "$cxx" -std=c++"$std" -I"$src/../../include" -c -o "$out/tu.o" "$@"
+    ms=$(( ($(date +%s%N) - start) / 1000000 ))
+    if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then
+      best=$ms
+    fi
+    i=$((i + 1))
+  done
+  printf '%-40s %8s ms %10s bytes\n' "$name" "$best" "$(wc -c < "$out/tu.o")"
+}
+
+for opt in -O0 -O2; do
+  measure "List_fwd.hpp $opt" "$opt" "$src/list_fwd_user.cpp"
+  measure "List.hpp $opt" "$opt" "$src/list_user.cpp"
+  measure "List.hpp, extern templates $opt" "$opt" -DGUNGNIR_EXTERN_TEMPLATES "$src/list_user.cpp"
+done
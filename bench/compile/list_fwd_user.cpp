@@ -0,0 +1,14 @@
+// A translation unit only passing lists along, for `compile_time.sh`. It is
+// compiled, not linked.
+
+#include <cstddef>
+
+#include "gungnir/List_fwd.hpp"
+using gungnir::List;
+
+std::size_t summarize(const List<int>& xs, const List<int>& ys);
+
+std::size_t summarizeBoth(const List<int>& xs, const List<int>& ys)
+{
+    return summarize(xs, ys) + summarize(ys, xs);
+}
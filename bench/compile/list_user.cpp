@@ -0,0 +1,30 @@
+// A translation unit using `List<int>` the way application code does, for
+// `compile_time.sh`. It is compiled, not linked.
+
+#include <cstddef>
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+using gungnir::ListBuilder;
+
+std::size_t summarize(const List<int>& xs, const List<int>& ys)
+{
+    ListBuilder<int> buf;
+    for (int i = 0; i < 10; ++i) {
+        buf.append(i);
+    }
+    const auto zs = buf.result();
+
+    const auto s = xs.sorted().distinct().reverse().drop(1).take(5).intersect(ys).diff(zs);
+    const auto t = xs.sorted(true).init().tail().slice(1, 3).takeRight(2).dropRight(1);
+    auto n = s.size() + t.size() + s.hash() + (s == t) + xs.contains(3) + xs.count(2);
+    n += xs.sum() + xs.product() + xs.last() + xs[0] + xs.head();
+    n += xs.splitAt(2).first.size() + zs.zipWithIndex().size();
+    for (const auto x : xs.concat(ys)) {
+        n += x;
+    }
+    n += xs.map([](int x) { return x + 1; })
+        .filter([](int x) { return x % 2 == 0; })
+        .foldLeft(0, [](int a, int x) { return a + x; });
+    return n;
+}
@@ -0,0 +1,61 @@
+#include <string>
+
+#include "bench.hpp"
+
+#include "gungnir/lazy.hpp"
+using gungnir::lazy;
+using gungnir::lazyVal;
+using gungnir::syncLazyVal;
+
+BENCHMARK("LazyVal/get/hit") {
+    const auto v = lazyVal<std::string>(64, 'x');
+    bench::keep(v.get());
+    state.run([&v] { bench::keep(v.get()); });
+}
+
+BENCHMARK("LazyVal/get/miss") {
+    state.run([] {
+        const auto v = lazyVal<std::string>(64, 'x');
+        bench::keep(v.get());
+    });
+}
+
+BENCHMARK("LazyVal/construct/unforced") {
+    state.run([] {
+        const auto v = lazyVal<std::string>(64, 'x');
+        bench::keep(v);
+    });
+}
+
+BENCHMARK("Lazy/get/hit") {
+    const auto v = lazy([] { return std::string(64, 'x'); });
+    bench::keep(v.get());
+    state.run([&v] { bench::keep(v.get()); });
+}
+
+BENCHMARK("Lazy/get/miss") {
+    state.run([] {
+        const auto v = lazy([] { return std::string(64, 'x'); });
+        bench::keep(v.get());
+    });
+}
+
+BENCHMARK("Lazy/construct/unforced") {
+    state.run([] {
+        const auto v = lazy([] { return std::string(64, 'x'); });
+        bench::keep(v);
+    });
+}
+
+BENCHMARK("SyncLazyVal/get/hit") {
+    const auto v = syncLazyVal<std::string>(64, 'x');
+    bench::keep(v.get());
+    state.run([&v] { bench::keep(v.get()); });
+}
+
+BENCHMARK("SyncLazyVal/get/miss") {
+    state.run([] {
+        const auto v = syncLazyVal<std::string>(64, 'x');
+        bench::keep(v.get());
+    });
+}
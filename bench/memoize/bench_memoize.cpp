@@ -0,0 +1,67 @@
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.hpp"
+
+#include "gungnir/lazy.hpp"
+#include "gungnir/memoize.hpp"
+using gungnir::LazyVal;
+using gungnir::memoize;
+
+namespace {
+
+const int threads = 8;
+const int keys = 1024;
+const int lookups = 10000;
+
+int square(int x)
+{
+    return x * x;
+}
+
+// Runs `lookups` calls of `f` with keys cycling through `keys` on each of
+// `threads` threads.
+template<typename Fn>
+void hammer(const Fn& f)
+{
+    std::vector<std::thread> ts;
+    for (int t = 0; t < threads; ++t) {
+        ts.emplace_back([&f, t] {
+            int sum = 0;
+            for (int i = 0; i < lookups; ++i) {
+                sum += f((i * 31 + t) % keys);
+            }
+            bench::keep(sum);
+        });
+    }
+    for (auto& t : ts) {
+        t.join();
+    }
+}
+
+}  // namespace
+
+BENCHMARK("memoize/hit/8threads") {
+    const auto f = memoize<int>(&square);
+    hammer(f);
+    state.run([&f] { hammer(f); });
+}
+
+BENCHMARK("memoize/hit/8threads/mutexMap") {
+    // The hand-written alternative: one map of lazy values behind one lock.
+    std::mutex m;
+    std::unordered_map<int, LazyVal<int, int>> table;
+    const auto f = [&m, &table](int x) {
+        std::lock_guard<std::mutex> lock(m);
+        auto it = table.find(x);
+        if (it == table.end()) {
+            it = table.emplace(x, LazyVal<int, int>(square(x))).first;
+        }
+        return it->second.get();
+    };
+    hammer(f);
+    state.run([&f] { hammer(f); });
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/AtomicList.hpp
+ * A mutable reference to a `List`, which threads can read and replace
+ * concurrently without locks.
+ */
+
+#ifndef GUNGNIR_ATOMIC_LIST_HPP
+#define GUNGNIR_ATOMIC_LIST_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "gungnir/List.hpp"
+#include "gungnir/refcount.hpp"
+
+namespace gungnir {
+
+/**
+ * @brief A mutable reference to an immutable list, which threads can load
+ *        and replace concurrently without locks.
+ *
+ * Readers take snapshots with `load()`, which is wait-free: it takes three
+ * atomic read-modify-write operations whatever other threads do. Writers
+ * publish new lists with `store()`, `exchange()` or `update()`; the last
+ * applies a function to the current list and installs the result with
+ * compare-and-swap, retrying if another writer got there first.
+ *
+ * The list is held in a heap-allocated box, which is reclaimed with split
+ * reference counting: a single 64-bit word holds the address of the
+ * current box in its low 48 bits and the number of readers that have
+ * pinned that box in its high 16 bits. A reader pins the box by
+ * incrementing that word, copies the list and then releases its pin on
+ * the box itself; a writer that replaces the box transfers the pins it
+ * finds in the word to the box, which is freed once they have all been
+ * released. Box addresses must therefore fit in 48 bits, as user-space
+ * addresses do on x86-64 and AArch64.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements
+ * @tparam Alloc the type of the allocator of the lists; its reference
+ *               counting policy must be `AtomicRefCount`
+ */
+template<typename A, typename Alloc = std::allocator<A>>
+class AtomicList final {
+    static_assert(sizeof (void*) == 8, "AtomicList requires 64-bit addresses");
+    static_assert(std::is_same<detail::RefCountOf<Alloc>, AtomicRefCount>::value,
+                  "lists shared across threads must use AtomicRefCount");
+
+public:
+    /** @brief The type of the lists referenced. */
+    using ListType = List<A, Alloc>;
+
+    /**
+     * @brief Constructs a reference to an empty list.
+     */
+    AtomicList() : AtomicList(ListType()) {}
+
+    /**
+     * @brief Constructs a reference to `xs`.
+     *
+     * @param xs the initially referenced list
+     */
+    explicit AtomicList(ListType xs) : word_(install(std::move(xs))) {}
+
+    AtomicList(const AtomicList&) = delete;
+    AtomicList& operator=(const AtomicList&) = delete;
+
+    ~AtomicList()
+    {
+        uninstall(word_.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Returns the referenced list. Wait-free.
+     *
+     * @return the referenced list
+     */
+    ListType load() const
+    {
+        const auto b = pin();
+        ListType xs(b->list);
+        unpin(b);
+        return xs;
+    }
+
+    /**
+     * @brief Makes this reference refer to `xs`.
+     *
+     * @param xs the list to refer to
+     */
+    void store(ListType xs)
+    {
+        exchange(std::move(xs));
+    }
+
+    /**
+     * @brief Makes this reference refer to `xs`, returning the list it
+     *        referred to.
+     *
+     * @param xs the list to refer to
+     * @return the list previously referred to
+     */
+    ListType exchange(ListType xs)
+    {
+        const auto w = word_.exchange(install(std::move(xs)), std::memory_order_acq_rel);
+        ListType old(boxOf(w)->list);
+        uninstall(w);
+        return old;
+    }
+
+    /**
+     * @brief Replaces the referenced list with the result of applying a
+     *        function to it.
+     *
+     * If another thread replaces the list between the call to `f` and
+     * the installation of its result, `f` is called again on the new
+     * list, so it should have no side effects.
+     *
+     * @tparam Fn the type of the function
+     * @param f the function computing the new list from the current one
+     * @return the installed list
+     */
+    template<typename Fn>
+    ListType update(Fn f)
+    {
+        for (;;) {
+            // Pinning `b` keeps it from being freed and its address from
+            // being reused, so that the compare-and-swap cannot succeed on
+            // a different box at the same address.
+            const auto b = pin();
+            ListType xs = f(static_cast<const ListType&>(b->list));
+            const auto desired = install(xs);
+            auto w = word_.load(std::memory_order_acquire);
+            while (boxOf(w) == b) {
+                if (word_.compare_exchange_weak(w, desired, std::memory_order_acq_rel)) {
+                    uninstall(w);
+                    unpin(b);
+                    return xs;
+                }
+            }
+            uninstall(desired);
+            unpin(b);
+        }
+    }
+
+private:
+    struct Box {
+        explicit Box(ListType xs) : list(std::move(xs)), refs(bias) {}
+
+        const ListType list;
+        // The pins released on this box, as a negative count, plus `bias`
+        // while it is installed; the pins acquired on it are added when it
+        // is uninstalled or flushed.
+        std::atomic<std::int64_t> refs;
+    };
+
+    static constexpr unsigned addrBits = 48;
+    static constexpr std::uint64_t addrMask = (std::uint64_t(1) << addrBits) - 1;
+    static constexpr std::uint64_t onePin = std::uint64_t(1) << addrBits;
+
+    // Readers flush the pins held in the word once this many have piled up,
+    // well before the 16 bits holding them overflow.
+    static constexpr std::uint64_t flushPins = std::uint64_t(1) << 15;
+
+    // Keeps the count of an installed box positive however many pins have
+    // been released on it.
+    static constexpr std::int64_t bias = std::int64_t(1) << 62;
+
+    static Box* boxOf(std::uint64_t w)
+    {
+        return reinterpret_cast<Box*>(static_cast<std::uintptr_t>(w & addrMask));
+    }
+
+    static std::uint64_t pinsOf(std::uint64_t w)
+    {
+        return w >> addrBits;
+    }
+
+    // Returns the word referring to a new box holding `xs`, with no pins.
+    static std::uint64_t install(ListType xs)
+    {
+        std::unique_ptr<Box> b(new Box(std::move(xs)));
+        const auto w = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(b.get()));
+        if (w & ~addrMask) {
+            throw std::runtime_error("AtomicList box address exceeds 48 bits");
+        }
+        b.release();
+        return w;
+    }
+
+    // Releases the box referred to by `w`, which has just been replaced,
+    // transferring the pins held in `w` to it.
+    static void uninstall(std::uint64_t w)
+    {
+        const auto b = boxOf(w);
+        const auto delta = static_cast<std::int64_t>(pinsOf(w)) - bias;
+        if (b->refs.fetch_add(delta, std::memory_order_acq_rel) + delta == 0) {
+            delete b;
+        }
+    }
+
+    // Pins the installed box and returns it.
+    Box* pin() const
+    {
+        const auto w = word_.fetch_add(onePin, std::memory_order_acquire);
+        const auto b = boxOf(w);
+        if (pinsOf(w) + 1 >= flushPins) {
+            flush(b);
+        }
+        return b;
+    }
+
+    // Moves the pins held in the word to `b`, if it is still installed.
+    // The caller holds a pin on `b`, so its count cannot drop to zero here.
+    void flush(Box* b) const
+    {
+        auto w = word_.load(std::memory_order_acquire);
+        if (boxOf(w) != b || pinsOf(w) < flushPins) {
+            return;
+        }
+        const auto n = static_cast<std::int64_t>(pinsOf(w));
+        b->refs.fetch_add(n, std::memory_order_acq_rel);
+        if (!word_.compare_exchange_strong(
+                w, w & addrMask, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            b->refs.fetch_sub(n, std::memory_order_acq_rel);
+        }
+    }
+
+    static void unpin(Box* b)
+    {
+        if (b->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete b;
+        }
+    }
+
+    mutable std::atomic<std::uint64_t> word_;
+};
+
+template<typename A, typename Alloc>
+constexpr std::uint64_t AtomicList<A, Alloc>::addrMask;
+
+template<typename A, typename Alloc>
+constexpr std::uint64_t AtomicList<A, Alloc>::onePin;
+
+template<typename A, typename Alloc>
+constexpr std::uint64_t AtomicList<A, Alloc>::flushPins;
+
+template<typename A, typename Alloc>
+constexpr std::int64_t AtomicList<A, Alloc>::bias;
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_ATOMIC_LIST_HPP
@@ -0,0 +1,500 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/BufferView.hpp
+ * A persistent list view over a contiguous buffer owned elsewhere.
+ */
+
+#ifndef GUNGNIR_BUFFER_VIEW_HPP
+#define GUNGNIR_BUFFER_VIEW_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "gungnir/List.hpp"
+#include "gungnir/ListView.hpp"
+#include "gungnir/detail/simd.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+namespace detail {
+
+namespace stage {
+
+// A view pipeline source over a contiguous array.
+template<typename A>
+struct BufferSource {
+    using Elem = A;
+    using Allocator = std::allocator<A>;
+
+    Allocator allocator() const { return Allocator(); }
+
+    template<typename Sink>
+    void run(Sink& k) const
+    {
+        for (auto p = data.get(), e = p + size; p != e; ++p) {
+            if (!k(*p)) {
+                return;
+            }
+        }
+    }
+
+    std::shared_ptr<const A> data;
+    std::size_t size;
+};
+
+}  // namespace stage
+
+}  // namespace detail
+
+/**
+ * @brief An immutable, list-like view of a contiguous range of elements
+ *        owned by a shared buffer.
+ *
+ * A `BufferView` refers to a run of elements of an existing array, such as
+ * the contents of a `std::vector` or a memory-mapped file, and keeps that
+ * array alive through an aliasing `std::shared_ptr`. Creating views and
+ * taking sub-views with `tail()`, `take()`, `drop()` or `slice()` is O(1) and
+ * never copies or allocates per element, while operations producing new
+ * elements, such as `map()`, return `List`s. The elements must not be
+ * modified through other means while viewed.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements
+ */
+template<typename A>
+class BufferView final {
+public:
+    /** @brief An iterator over the elements of a view. */
+    using StdIterator = const A*;
+
+    /**
+     * @brief Constructs an empty view.
+     */
+    BufferView() noexcept : size_(0) {}
+
+    /**
+     * @brief Constructs a view of the `size` elements starting at `data`.
+     *
+     * `data` may share ownership with any object keeping the elements
+     * alive, e.g. `std::shared_ptr<const A>(mapping, mapping->address())`.
+     *
+     * @param data a pointer to the first element, sharing ownership of the
+     *             buffer
+     * @param size the number of elements
+     */
+    BufferView(std::shared_ptr<const A> data, std::size_t size) noexcept
+        : data_(std::move(data))
+        , size_(size)
+    {}
+
+    /**
+     * @brief Constructs a view of all elements of a shared vector.
+     *
+     * @tparam Alloc the allocator type of the vector
+     * @param v the vector, kept alive by this view and the views derived
+     *          from it
+     */
+    template<typename Alloc>
+    explicit BufferView(std::shared_ptr<const std::vector<A, Alloc>> v) noexcept
+        : data_(v, v->data())
+        , size_(v->size())
+    {}
+
+    /**
+     * @brief Constructs a view of all elements of a vector, taking
+     *        ownership of its buffer without copying the elements.
+     *
+     * @tparam Alloc the allocator type of the vector
+     * @param v the vector to take ownership of
+     */
+    template<typename Alloc>
+    explicit BufferView(std::vector<A, Alloc>&& v)
+        : BufferView(std::make_shared<const std::vector<A, Alloc>>(std::move(v)))
+    {}
+
+    /**
+     * @brief Returns `true` if this view contains no elements, `false`
+     *        otherwise.
+     *
+     * @return `true` if this view contains no elements, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Returns the number of elements of this view.
+     *
+     * @return the number of elements of this view
+     */
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Returns a pointer to the first element of this view.
+     *
+     * @return a pointer to the first element of this view, or `nullptr` if
+     *         it has never referred to a buffer
+     */
+    const A* data() const
+    {
+        return data_.get();
+    }
+
+    /**
+     * @brief Returns the first element of this view.
+     *
+     * @return the first element of this view
+     * @throws std::out_of_range if this view is empty
+     */
+    const A& head() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("head of empty view");
+        }
+        return data_.get()[0];
+    }
+
+    /**
+     * @brief Returns the last element of this view.
+     *
+     * @return the last element of this view
+     * @throws std::out_of_range if this view is empty
+     */
+    const A& last() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("last of empty view");
+        }
+        return data_.get()[size_ - 1];
+    }
+
+    /**
+     * @brief Returns all elements of this view except the first one.
+     *
+     * @return all elements of this view except the first one
+     * @throws std::out_of_range if this view is empty
+     */
+    BufferView tail() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("tail of empty view");
+        }
+        return drop(1);
+    }
+
+    /**
+     * @brief Returns the element at the specified position.
+     *
+     * @param index the position of the element to return
+     * @return the element at the specified position
+     * @throws std::out_of_range if `index >= size()`
+     */
+    const A& operator[](std::size_t index) const
+    {
+        if (index >= size_) {
+            throw std::out_of_range("index out of range");
+        }
+        return data_.get()[index];
+    }
+
+    /**
+     * @brief Returns the first `n` elements of this view.
+     *
+     * @param n the number of elements to take
+     * @return a view of the first `n` elements of this view,
+     *         or the whole view if `n > size()`
+     */
+    BufferView take(std::size_t n) const
+    {
+        return BufferView(data_, std::min(n, size_));
+    }
+
+    /**
+     * @brief Returns all elements of this view except the first `n` ones.
+     *
+     * @param n the number of elements to drop
+     * @return a view of all elements of this view except the first `n` ones,
+     *         or an empty view if `n > size()`
+     */
+    BufferView drop(std::size_t n) const
+    {
+        n = std::min(n, size_);
+        return BufferView(std::shared_ptr<const A>(data_, data_.get() + n), size_ - n);
+    }
+
+    /**
+     * @brief Returns the elements in the range [`from`, `until`).
+     *
+     * @param from the position of the first element
+     * @param until the position past the last element
+     * @return a view of the elements at positions [`from`, `until`), clamped
+     *         to this view
+     */
+    BufferView slice(std::size_t from, std::size_t until) const
+    {
+        return drop(from).take(until > from ? until - from : 0);
+    }
+
+    /**
+     * @brief Applies a function to each element of this view.
+     *
+     * @tparam Fn the type of the function to apply
+     * @param f the function to apply to each element of this view
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        for (const auto& x : *this) {
+            f(x);
+        }
+    }
+
+    /**
+     * @brief Returns a new list resulting from applying a function to
+     *        each element of this view.
+     *
+     * @tparam Fn the type of the function to apply
+     * @tparam B the element type of the returned list
+     * @param f the function to apply to each element of this view
+     * @return a list of the results of applying `f` to each element
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    List<B> map(Fn f) const
+    {
+        ListBuilder<B> buf;
+        for (const auto& x : *this) {
+            buf.append(f(x));
+        }
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns a list of all elements of this view that satisfy a
+     *        predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return a list of all elements of this view that satisfy `p`, in order
+     */
+    template<typename Fn>
+    List<A> filter(Fn p) const
+    {
+        ListBuilder<A> buf;
+        for (const auto& x : *this) {
+            if (p(x)) {
+                buf.append(x);
+            }
+        }
+        return buf.result();
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this view, going left to right.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this view, going left to right with the start value `z`
+     *         on the left, or `z` if this view is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) const
+    {
+        for (const auto& x : *this) {
+            z = op(std::move(z), x);
+        }
+        return z;
+    }
+
+    /**
+     * @brief Returns `true` if any element of this view satisfies a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return `true` if any element satisfies `p`, `false` otherwise
+     */
+    template<typename Fn>
+    bool exists(Fn p) const
+    {
+        return std::any_of(begin(), end(), std::move(p));
+    }
+
+    /**
+     * @brief Returns `true` if all elements of this view satisfy a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return `true` if all elements satisfy `p`, `false` otherwise
+     */
+    template<typename Fn>
+    bool forall(Fn p) const
+    {
+        return std::all_of(begin(), end(), std::move(p));
+    }
+
+    /**
+     * @brief Returns `true` if this view contains an element equal to `x`.
+     *
+     * @param x the element to look for
+     * @return `true` if this view contains an element equal to `x`
+     */
+    bool contains(const A& x) const
+    {
+        return !isEmpty() && simd::contains(data(), size_, x);
+    }
+
+    /**
+     * @brief Returns the number of elements of this view equal to `x`.
+     *
+     * @param x the element to count
+     * @return the number of elements of this view equal to `x`
+     */
+    std::size_t count(const A& x) const
+    {
+        return isEmpty() ? 0 : simd::count(data(), size_, x);
+    }
+
+    /**
+     * @brief Returns the number of elements of this view that satisfy a
+     *        predicate.
+     *
+     * The matches are added up without branching, so that the loop can be
+     * vectorized for simple predicates on arithmetic elements.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return the number of elements that satisfy `p`
+     */
+    template<typename Fn>
+    std::size_t count(Fn p) const
+    {
+        std::size_t n = 0;
+        for (const auto& x : *this) {
+            n += p(x) ? 1 : 0;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Returns the sum of all elements of this view, or 0 if this view
+     *        is empty.
+     *
+     * @return the sum of all elements of this view
+     */
+    A sum() const
+    {
+        return isEmpty() ? A(0) : simd::sum(data(), size_);
+    }
+
+    /**
+     * @brief Returns the product of all elements of this view, or 1 if this
+     *        view is empty.
+     *
+     * @return the product of all elements of this view
+     */
+    A product() const
+    {
+        return isEmpty() ? A(1) : simd::product(data(), size_);
+    }
+
+    /**
+     * @brief Returns a list of all elements of this view.
+     *
+     * @return a list of copies of all elements of this view
+     */
+    List<A> toList() const
+    {
+        return List<A>(begin(), end());
+    }
+
+    /**
+     * @brief Returns a lazy view of the elements of this view, on which
+     *        transformations are fused into a single pass.
+     *
+     * @return a `ListView` over the elements of this view
+     */
+    ListView<stage::BufferSource<A>> view() const
+    {
+        return ListView<stage::BufferSource<A>>(stage::BufferSource<A>{data_, size_});
+    }
+
+    /**
+     * @brief Returns `true` if the two views contain equal elements in the
+     *        same order.
+     *
+     * @param that the view to compare against
+     * @return `true` if the two views are equal, `false` otherwise
+     */
+    bool operator==(const BufferView& that) const
+    {
+        return size_ == that.size_ &&
+               (data() == that.data() || std::equal(begin(), end(), that.begin()));
+    }
+
+    /**
+     * @brief Returns `true` if the two views are not equal.
+     *
+     * @param that the view to compare against
+     * @return `true` if the two views are not equal, `false` otherwise
+     */
+    bool operator!=(const BufferView& that) const
+    {
+        return !(*this == that);
+    }
+
+    /**
+     * @brief Returns an iterator to the first element of this view.
+     *
+     * @return an iterator to the first element of this view
+     */
+    StdIterator begin() const
+    {
+        return data_.get();
+    }
+
+    /**
+     * @brief Returns an iterator past the last element of this view.
+     *
+     * @return an iterator past the last element of this view
+     */
+    StdIterator end() const
+    {
+        return data_.get() + size_;
+    }
+
+private:
+    std::shared_ptr<const A> data_;
+    std::size_t size_;
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_BUFFER_VIEW_HPP
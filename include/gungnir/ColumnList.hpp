@@ -0,0 +1,499 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/ColumnList.hpp
+ * A persistent list of records stored column by column.
+ */
+
+#ifndef GUNGNIR_COLUMN_LIST_HPP
+#define GUNGNIR_COLUMN_LIST_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "gungnir/BufferView.hpp"
+#include "gungnir/List.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+using namespace detail;
+
+/**
+ * @brief An immutable list of records whose fields are stored in separate
+ *        contiguous arrays, one per field.
+ *
+ * A `ColumnList<F0, F1, ...>` holds the same rows as a list of
+ * `std::tuple<F0, F1, ...>`, but stores the `F0` fields of all rows in one
+ * array, the `F1` fields in another, and so on. Scanning one or two fields
+ * of each row then reads only the arrays of those fields instead of whole
+ * records: `column<I>()` returns the array of the `I`-th fields as a
+ * `BufferView`, whose `count()`, `contains()` and `sum()` are vectorized for
+ * arithmetic fields.
+ *
+ * The functions passed to `foreach()`, `map()`, `count()` and the other
+ * combinators take the fields of a row as separate arguments, so a function
+ * that ignores some of them, once inlined, does not load them at all.
+ * `take()`, `drop()` and `slice()` share the arrays and take O(1) time;
+ * `filter()` copies the fields of the rows kept. The columns are built in
+ * bulk, with the constructor or `fromList()`, and never modified.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam Fields the types of the fields of the rows; must be copy
+ *                constructible
+ */
+template<typename... Fields>
+class ColumnList final {
+    static_assert(sizeof...(Fields) > 0, "a ColumnList must have at least one column");
+
+public:
+    /** @brief The type of a row. */
+    using Row = std::tuple<Fields...>;
+
+    /** @brief The type of the `I`-th field of a row. */
+    template<std::size_t I>
+    using Field = typename std::tuple_element<I, Row>::type;
+
+    /**
+     * @brief Constructs an empty list.
+     */
+    ColumnList() = default;
+
+    /**
+     * @brief Constructs a list from its columns, taking ownership of their
+     *        buffers without copying the fields.
+     *
+     * @param columns the fields of the rows, one vector per field
+     * @throws std::invalid_argument if the columns have different sizes
+     */
+    explicit ColumnList(std::vector<Fields>... columns)
+        : columns_(BufferView<Fields>(std::move(columns))...)
+    {
+        if (!sameSizes(Indices())) {
+            throw std::invalid_argument("columns have different sizes");
+        }
+    }
+
+    /**
+     * @brief Returns a list of the fields of the records of a list, in
+     *        O(n) time.
+     *
+     * @tparam R the type of the records
+     * @tparam RAlloc the allocator type of the list of records
+     * @tparam Fns the types of the projections
+     * @param xs the records
+     * @param fs the projections, one per field, each returning the field
+     *           of a record
+     * @return a list whose `i`-th row holds the results of applying `fs` to
+     *         the `i`-th record of `xs`
+     */
+    template<typename R, typename RAlloc, typename... Fns>
+    static ColumnList fromList(const List<R, RAlloc>& xs, Fns... fs)
+    {
+        static_assert(sizeof...(Fns) == sizeof...(Fields), "one projection is needed per field");
+        return fromListImpl(xs, Indices(), fs...);
+    }
+
+    /**
+     * @brief Returns whether this list is empty.
+     *
+     * @return `true` if this list has no rows, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Returns the number of rows of this list.
+     *
+     * @return the number of rows of this list
+     */
+    std::size_t size() const
+    {
+        return std::get<0>(columns_).size();
+    }
+
+    /**
+     * @brief Returns the `I`-th fields of all rows, as a view of their
+     *        contiguous array.
+     *
+     * @tparam I the index of the field
+     * @return a view of the `I`-th field of each row, in order
+     */
+    template<std::size_t I>
+    const BufferView<Field<I>>& column() const
+    {
+        return std::get<I>(columns_);
+    }
+
+    /**
+     * @brief Returns the row at a position.
+     *
+     * @param index the index of the row
+     * @return a tuple of copies of the fields of the row at position `index`
+     * @throws std::out_of_range if `index >= size()`
+     */
+    Row operator[](std::size_t index) const
+    {
+        if (index >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+        return apply(MakeRow(), pointers(Indices()), index);
+    }
+
+    /**
+     * @brief Returns the first `n` rows of this list, in O(1) time.
+     *
+     * @param n the number of rows to take
+     * @return a list of the first `n` rows of this list, or the whole list
+     *         if `n > size()`
+     */
+    ColumnList take(std::size_t n) const
+    {
+        return slice(0, n);
+    }
+
+    /**
+     * @brief Returns all rows of this list except the first `n`, in O(1)
+     *        time.
+     *
+     * @param n the number of rows to drop
+     * @return a list of all rows of this list except the first `n`, or an
+     *         empty list if `n > size()`
+     */
+    ColumnList drop(std::size_t n) const
+    {
+        return slice(n, size());
+    }
+
+    /**
+     * @brief Returns the rows of this list from position `from` up until
+     *        position `until`, in O(1) time.
+     *
+     * @param from the index of the starting position (included)
+     * @param until the index of the ending position (excluded)
+     * @return a list of the rows of this list starting at position `from`
+     *         and extending up until position `until`, or an empty list if
+     *         `from >= until` or `from >= size()`
+     */
+    ColumnList slice(std::size_t from, std::size_t until) const
+    {
+        return sliceImpl(from, until, Indices());
+    }
+
+    /**
+     * @brief Applies a function to the fields of each row of this list.
+     *
+     * @tparam Fn the type of the function to apply
+     * @param f the function to apply to the fields of each row
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        const auto ps = pointers(Indices());
+        for (std::size_t i = 0, n = size(); i < n; ++i) {
+            apply(f, ps, i);
+        }
+    }
+
+    /**
+     * @brief Returns a new list resulting from applying a function to the
+     *        fields of each row of this list.
+     *
+     * @tparam Fn the type of the function to apply
+     * @tparam B the element type of the returned list
+     * @param f the function to apply to the fields of each row
+     * @return a list of the results of applying `f` to each row
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, const Fields&...>>>
+    List<B> map(Fn f) const
+    {
+        ListBuilder<B> buf;
+        const auto ps = pointers(Indices());
+        for (std::size_t i = 0, n = size(); i < n; ++i) {
+            buf.append(apply(f, ps, i));
+        }
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns all rows of this list whose fields satisfy a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test the fields of rows
+     * @return a list of the rows that satisfy `p`, in order
+     */
+    template<typename Fn>
+    ColumnList filter(Fn p) const
+    {
+        std::vector<std::size_t> kept;
+        const auto ps = pointers(Indices());
+        for (std::size_t i = 0, n = size(); i < n; ++i) {
+            if (apply(p, ps, i)) {
+                kept.push_back(i);
+            }
+        }
+        return select(kept);
+    }
+
+    /**
+     * @brief Returns all rows of this list whose fields do not satisfy a
+     *        predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test the fields of rows
+     * @return a list of the rows that do not satisfy `p`, in order
+     */
+    template<typename Fn>
+    ColumnList filterNot(Fn p) const
+    {
+        return filter([&p](const Fields&... xs) { return !p(xs...); });
+    }
+
+    /**
+     * @brief Returns all rows of this list whose `I`-th field satisfies a
+     *        predicate.
+     *
+     * Only the `I`-th column is scanned, and the other columns are read for
+     * the rows kept.
+     *
+     * @tparam I the index of the field tested
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test the `I`-th field of rows
+     * @return a list of the rows whose `I`-th field satisfies `p`, in order
+     */
+    template<std::size_t I, typename Fn>
+    ColumnList filterBy(Fn p) const
+    {
+        std::vector<std::size_t> kept;
+        const auto xs = column<I>().data();
+        for (std::size_t i = 0, n = size(); i < n; ++i) {
+            if (p(xs[i])) {
+                kept.push_back(i);
+            }
+        }
+        return select(kept);
+    }
+
+    /**
+     * @brief Returns the number of rows of this list whose fields satisfy a
+     *        predicate.
+     *
+     * The matches are added up without branching, so that the loop can be
+     * vectorized for simple predicates on arithmetic fields.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test the fields of rows
+     * @return the number of rows that satisfy `p`
+     */
+    template<typename Fn>
+    std::size_t count(Fn p) const
+    {
+        std::size_t k = 0;
+        const auto ps = pointers(Indices());
+        for (std::size_t i = 0, n = size(); i < n; ++i) {
+            k += apply(p, ps, i) ? 1 : 0;
+        }
+        return k;
+    }
+
+    /**
+     * @brief Returns `true` if the fields of any row of this list satisfy a
+     *        predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test the fields of rows
+     * @return `true` if any row satisfies `p`, `false` otherwise
+     */
+    template<typename Fn>
+    bool exists(Fn p) const
+    {
+        const auto ps = pointers(Indices());
+        for (std::size_t i = 0, n = size(); i < n; ++i) {
+            if (apply(p, ps, i)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns `true` if the fields of all rows of this list satisfy a
+     *        predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test the fields of rows
+     * @return `true` if all rows satisfy `p`, `false` otherwise
+     */
+    template<typename Fn>
+    bool forall(Fn p) const
+    {
+        return !exists([&p](const Fields&... xs) { return !p(xs...); });
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and the fields of
+     *        all rows of this list, going left to right.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator, called with the value so
+     *            far followed by the fields of a row
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of applying `op` to the value so far and each row,
+     *         going left to right with the start value `z`, or `z` if this
+     *         list is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) const
+    {
+        const auto ps = pointers(Indices());
+        for (std::size_t i = 0, n = size(); i < n; ++i) {
+            z = applyAt(op, ps, i, Indices(), std::move(z));
+        }
+        return z;
+    }
+
+    /**
+     * @brief Returns a list of the rows of this list.
+     *
+     * @return a list of tuples of copies of the fields of each row
+     */
+    List<Row> toList() const
+    {
+        return map(MakeRow());
+    }
+
+    /**
+     * @brief Compares this list with the given list for equality.
+     *
+     * @param that the list to be compared for equality with this list
+     * @return `true` if `that` has equal rows in the same order, `false`
+     *         otherwise
+     */
+    bool operator==(const ColumnList& that) const
+    {
+        return columns_ == that.columns_;
+    }
+
+    /**
+     * @brief Compares this list with the given list for inequality.
+     *
+     * @param that the list to be compared for inequality with this list
+     * @return `true` if `that` does not have equal rows in the same order,
+     *         `false` otherwise
+     */
+    bool operator!=(const ColumnList& that) const
+    {
+        return !(*this == that);
+    }
+
+private:
+    using Indices = typename GenSeq<sizeof...(Fields)>::type;
+    using Pointers = std::tuple<const Fields*...>;
+
+    struct MakeRow {
+        Row operator()(const Fields&... xs) const
+        {
+            return Row(xs...);
+        }
+    };
+
+    explicit ColumnList(std::tuple<BufferView<Fields>...> columns) : columns_(std::move(columns)) {}
+
+    template<typename R, typename RAlloc, std::size_t... S, typename... Fns>
+    static ColumnList fromListImpl(const List<R, RAlloc>& xs, Seq<S...>, Fns&... fs)
+    {
+        std::tuple<std::vector<Fields>...> columns;
+        using Expand = int[];
+        (void) Expand {0, (std::get<S>(columns).reserve(xs.size()), 0)...};
+        for (const auto& x : xs) {
+            (void) Expand {0, (std::get<S>(columns).push_back(fs(x)), 0)...};
+        }
+        return ColumnList(std::move(std::get<S>(columns))...);
+    }
+
+    template<std::size_t... S>
+    bool sameSizes(Seq<S...>) const
+    {
+        bool same = true;
+        using Expand = int[];
+        (void) Expand {0, (same = same && std::get<S>(columns_).size() == size(), 0)...};
+        return same;
+    }
+
+    template<std::size_t... S>
+    ColumnList sliceImpl(std::size_t from, std::size_t until, Seq<S...>) const
+    {
+        return ColumnList(std::make_tuple(std::get<S>(columns_).slice(from, until)...));
+    }
+
+    // Returns a list of the rows at the given ascending positions.
+    ColumnList select(const std::vector<std::size_t>& rows) const
+    {
+        return rows.size() == size() ? *this : selectImpl(rows, Indices());
+    }
+
+    template<std::size_t... S>
+    ColumnList selectImpl(const std::vector<std::size_t>& rows, Seq<S...>) const
+    {
+        return ColumnList(gather(std::get<S>(columns_), rows)...);
+    }
+
+    template<typename A>
+    static std::vector<A> gather(const BufferView<A>& column, const std::vector<std::size_t>& rows)
+    {
+        std::vector<A> xs;
+        xs.reserve(rows.size());
+        for (const auto i : rows) {
+            xs.push_back(column.data()[i]);
+        }
+        return xs;
+    }
+
+    template<std::size_t... S>
+    Pointers pointers(Seq<S...>) const
+    {
+        return Pointers(std::get<S>(columns_).data()...);
+    }
+
+    // Calls `f` with `args` followed by the fields of row `i`.
+    template<typename Fn, std::size_t... S, typename... Args>
+    static auto applyAt(Fn& f, const Pointers& ps, std::size_t i, Seq<S...>, Args&&... args)
+        -> decltype(f(std::forward<Args>(args)..., std::get<S>(ps)[i]...))
+    {
+        return f(std::forward<Args>(args)..., std::get<S>(ps)[i]...);
+    }
+
+    template<typename Fn>
+    static auto apply(Fn&& f, const Pointers& ps, std::size_t i)
+        -> decltype(applyAt(f, ps, i, Indices()))
+    {
+        return applyAt(f, ps, i, Indices());
+    }
+
+    std::tuple<BufferView<Fields>...> columns_;
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_COLUMN_LIST_HPP
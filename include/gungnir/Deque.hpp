@@ -0,0 +1,374 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/Deque.hpp
+ * A persistent double-ended queue with worst-case constant-time operations.
+ */
+
+#ifndef GUNGNIR_DEQUE_HPP
+#define GUNGNIR_DEQUE_HPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gungnir/List.hpp"
+#include "gungnir/Stream.hpp"
+
+namespace gungnir {
+
+/// @cond GUNGNIR_PRIVATE
+namespace detail {
+
+// How many times longer than the other one either end of a `Deque` may
+// grow before the two are rebalanced.
+constexpr std::size_t dequeBalance = 3;
+
+}  // namespace detail
+/// @endcond
+
+/**
+ * @brief An immutable double-ended queue.
+ *
+ * This is the real-time deque of Okasaki's *Purely Functional Data
+ * Structures*. The elements are kept in two `Stream`s: the front, in
+ * order, and the rear, in reverse order. Once one of them grows more than
+ * three times as long as the other, half of its elements are moved to the
+ * other one by a lazy rotation, which the following operations advance a
+ * constant number of steps each. All operations therefore do a worst-case
+ * constant amount of work, however the deques derived from one another are
+ * shared, and deques can be shared across threads. The exception is
+ * freeing: the elements a rotation moves away stay reachable through the
+ * old front until the rotation ends, and are then freed together.
+ *
+ * The streams make each operation allocate; for first-in, first-out use
+ * in which each queue is consumed once, `Queue` is several times faster.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements; must be copy constructible
+ */
+template<typename A>
+class Deque final {
+    using S = Stream<A>;
+
+public:
+    /**
+     * @brief Constructs an empty deque.
+     */
+    Deque() noexcept = default;
+
+    /**
+     * @brief Constructs a deque with the given elements, the first of which
+     *        is at its head.
+     *
+     * @param xs the elements of this deque
+     */
+    Deque(std::initializer_list<A> xs) : Deque(xs.begin(), xs.end()) {}
+
+    /**
+     * @brief Constructs a deque with the elements of a list, the head of
+     *        which is at its head.
+     *
+     * @tparam Alloc the allocator type of the list
+     * @param xs the elements of this deque
+     */
+    template<typename Alloc>
+    explicit Deque(const List<A, Alloc>& xs) : Deque(xs.begin(), xs.end()) {}
+
+    /**
+     * @brief Constructs a deque with the elements in the range [`first`, `last`).
+     *
+     * @tparam InputIt the type of the iterators
+     * @param first the iterator pointing to the start of the range
+     * @param last the iterator pointing to the end of the range
+     */
+    template<
+        typename InputIt,
+        typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<InputIt>::value_type, A
+        >::value>::type
+    >
+    Deque(InputIt first, InputIt last)
+    {
+        std::vector<A> xs(first, last);
+        lenf_ = (xs.size() + 1) / 2;
+        lenr_ = xs.size() - lenf_;
+        for (auto i = lenf_; i > 0; --i) {
+            f_ = S(std::move(xs[i - 1]), std::move(f_));
+        }
+        for (auto i = lenf_; i < xs.size(); ++i) {
+            r_ = S(std::move(xs[i]), std::move(r_));
+        }
+    }
+
+    /**
+     * @brief Returns `true` if this deque contains no elements,
+     *        `false` otherwise.
+     *
+     * @return `true` if this deque contains no elements, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return lenf_ + lenr_ == 0;
+    }
+
+    /**
+     * @brief Returns the number of elements in this deque.
+     *
+     * @return the number of elements in this deque
+     */
+    std::size_t size() const
+    {
+        return lenf_ + lenr_;
+    }
+
+    /**
+     * @brief Returns the first element of this deque.
+     *
+     * @return the first element of this deque
+     * @throws std::out_of_range if this deque is empty
+     */
+    const A& head() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("head of empty deque");
+        }
+        return lenf_ == 0 ? r_.head() : f_.head();
+    }
+
+    /**
+     * @brief Returns the last element of this deque.
+     *
+     * @return the last element of this deque
+     * @throws std::out_of_range if this deque is empty
+     */
+    const A& last() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("last of empty deque");
+        }
+        return lenr_ == 0 ? f_.head() : r_.head();
+    }
+
+    /**
+     * @brief Returns all elements of this deque except the first one.
+     *
+     * @return all elements of this deque except the first one
+     * @throws std::out_of_range if this deque is empty
+     */
+    Deque tail() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("tail of empty deque");
+        }
+        if (lenf_ == 0) {
+            return Deque();
+        }
+        return balanced(lenf_ - 1, f_.tail(), exec2(sf_), lenr_, r_, exec2(sr_));
+    }
+
+    /**
+     * @brief Returns all elements of this deque except the last one.
+     *
+     * @return all elements of this deque except the last one
+     * @throws std::out_of_range if this deque is empty
+     */
+    Deque init() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("init of empty deque");
+        }
+        if (lenr_ == 0) {
+            return Deque();
+        }
+        return balanced(lenf_, f_, exec2(sf_), lenr_ - 1, r_.tail(), exec2(sr_));
+    }
+
+    /**
+     * @brief Returns a deque with the given element prepended to this deque.
+     *
+     * @param x the element to prepend
+     * @return a deque with `x` prepended to this deque
+     */
+    Deque prepend(A x) const
+    {
+        return balanced(lenf_ + 1, S(std::move(x), f_), exec1(sf_), lenr_, r_, exec1(sr_));
+    }
+
+    /**
+     * @brief Returns a deque with the given element appended to this deque.
+     *
+     * @param x the element to append
+     * @return a deque with `x` appended to this deque
+     */
+    Deque appended(A x) const
+    {
+        return balanced(lenf_, f_, exec1(sf_), lenr_ + 1, S(std::move(x), r_), exec1(sr_));
+    }
+
+    /**
+     * @brief Applies a function to each element of this deque, from the
+     *        first to the last.
+     *
+     * @param f the function to apply, for its side-effect, to each element
+     *          of this deque
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        for (const auto& x : f_) {
+            f(x);
+        }
+        std::vector<const A*> rear;
+        rear.reserve(lenr_);
+        for (const auto& x : r_) {
+            rear.push_back(&x);
+        }
+        for (auto it = rear.crbegin(); it != rear.crend(); ++it) {
+            f(**it);
+        }
+    }
+
+    /**
+     * @brief Returns a list of the elements of this deque, from the first
+     *        to the last.
+     *
+     * @return a list of the elements of this deque
+     */
+    List<A> toList() const
+    {
+        ListBuilder<A> buf;
+        foreach([&buf](const A& x) { buf.append(x); });
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns `true` if this deque and `that` have equal elements
+     *        in the same order, `false` otherwise.
+     *
+     * @param that the deque to compare with
+     * @return `true` if the deques have equal elements in the same order
+     */
+    bool operator==(const Deque& that) const
+    {
+        return size() == that.size() && toList() == that.toList();
+    }
+
+    /**
+     * @brief Returns `true` if this deque and `that` differ, `false` otherwise.
+     *
+     * @param that the deque to compare with
+     * @return `false` if the deques have equal elements in the same order
+     */
+    bool operator!=(const Deque& that) const
+    {
+        return !(*this == that);
+    }
+
+private:
+    Deque(std::size_t lenf, S f, S sf, std::size_t lenr, S r, S sr) noexcept
+        : lenf_(lenf), f_(std::move(f)), sf_(std::move(sf))
+        , lenr_(lenr), r_(std::move(r)), sr_(std::move(sr))
+    {}
+
+    // Rebalances the ends if either has grown too long, starting the
+    // rotations that move half of the elements of the longer one to the
+    // shorter one; the rotated streams are also the schedules that force
+    // them.
+    static Deque balanced(std::size_t lenf, S f, S sf, std::size_t lenr, S r, S sr)
+    {
+        if (lenf > detail::dequeBalance * lenr + 1) {
+            const auto i = (lenf + lenr) / 2;
+            const auto j = lenf + lenr - i;
+            const auto f1 = f.take(i);
+            const auto r1 = rotateDrop(std::move(r), i, std::move(f));
+            return Deque(i, f1, f1, j, r1, r1);
+        } else if (lenr > detail::dequeBalance * lenf + 1) {
+            const auto j = (lenf + lenr) / 2;
+            const auto i = lenf + lenr - j;
+            const auto r1 = r.take(j);
+            const auto f1 = rotateDrop(std::move(f), j, std::move(r));
+            return Deque(i, f1, f1, j, r1, r1);
+        }
+        return Deque(lenf, std::move(f), std::move(sf), lenr, std::move(r), std::move(sr));
+    }
+
+    // Forces the next element of a schedule.
+    static S exec1(const S& s)
+    {
+        return s.isEmpty() ? s : s.tail();
+    }
+
+    static S exec2(const S& s)
+    {
+        return exec1(exec1(s));
+    }
+
+    // The first `n` elements of `r` in reverse order, followed by `a`.
+    static S reverseOnto(S r, std::size_t n, S a)
+    {
+        for (; n > 0 && !r.isEmpty(); --n) {
+            a = S(r.head(), std::move(a));
+            S next = r.tail();
+            r = std::move(next);
+        }
+        return a;
+    }
+
+    // `f`, then `r` in reverse order, then `a`, one element of `f` and
+    // `dequeBalance` elements of `r` per step.
+    static S rotateRev(S f, S r, S a)
+    {
+        if (f.isEmpty()) {
+            return reverseOnto(std::move(r), std::numeric_limits<std::size_t>::max(), std::move(a));
+        }
+        const auto& x = f.head();
+        return S::cons(x, [f, r, a] {
+            return rotateRev(f.tail(), r.drop(detail::dequeBalance),
+                             reverseOnto(r, detail::dequeBalance, a));
+        });
+    }
+
+    // `f`, then `r` without its first `j` elements in reverse order.
+    static S rotateDrop(S f, std::size_t j, S r)
+    {
+        if (j < detail::dequeBalance) {
+            return rotateRev(std::move(f), r.drop(j), S());
+        }
+        const auto& x = f.head();
+        return S::cons(x, [f, j, r] {
+            return rotateDrop(f.tail(), j - detail::dequeBalance, r.drop(detail::dequeBalance));
+        });
+    }
+
+    std::size_t lenf_ = 0;
+    S f_;
+    S sf_;
+    std::size_t lenr_ = 0;
+    S r_;
+    S sr_;
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_DEQUE_HPP
@@ -0,0 +1,442 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/Executor.hpp
+ * A work-stealing thread pool running the parallel algorithms.
+ */
+
+#ifndef GUNGNIR_EXECUTOR_HPP
+#define GUNGNIR_EXECUTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gungnir {
+
+/**
+ * @brief A work-stealing thread pool.
+ *
+ * Each worker owns a deque of tasks: it pushes and pops work at the back,
+ * while idle workers steal from the front, where the largest pieces of
+ * work are. Work is submitted in fork-join style with `parallelFor()`,
+ * which splits its index range recursively so that idle workers can steal
+ * halves of it; the calling thread takes part as well, so nested calls
+ * from inside a task cannot deadlock. Submitting work does not allocate
+ * per task.
+ *
+ * Workers are either threads owned by the executor, or threads of a host
+ * application's pool lent to it through the spawning constructor. One
+ * executor is meant to be shared by the whole process; `global()` is the
+ * one used by parallel algorithms unless a policy names another, as in
+ * `xs.map(par.on(executor), f)`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ */
+class Executor final {
+    struct Job;
+    struct Task;
+
+public:
+    /**
+     * @brief The body of a worker of an executor.
+     *
+     * Calling a `Worker` runs tasks of its executor on the calling thread
+     * until the executor is destroyed.
+     */
+    class Worker final {
+    public:
+        /**
+         * @brief Runs tasks until the executor is destroyed.
+         */
+        void operator()() const
+        {
+            executor_->work(index_);
+        }
+
+    private:
+        friend class Executor;
+
+        Worker(Executor* executor, std::size_t index) noexcept
+            : executor_(executor)
+            , index_(index)
+        {}
+
+        Executor* executor_;
+        std::size_t index_;
+    };
+
+    /**
+     * @brief Returns the process-wide executor, with one worker thread per
+     *        hardware thread besides the calling thread.
+     *
+     * @return the process-wide executor
+     */
+    static Executor& global()
+    {
+        static Executor executor(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return executor;
+    }
+
+    /**
+     * @brief Constructs an executor with `threads` worker threads of its own.
+     *
+     * @param threads the number of worker threads; with 0, all work runs on
+     *                the threads submitting it
+     */
+    explicit Executor(std::size_t threads)
+        : Executor(threads, [this](Worker w) { threads_.emplace_back(w); })
+    {}
+
+    /**
+     * @brief Constructs an executor whose `workers` workers run on threads
+     *        provided by the caller.
+     *
+     * `spawn` is called once per worker with a `Worker`, which must be called
+     * exactly once on some thread, e.g. by submitting it to a host
+     * application's pool; it occupies that thread until the executor is
+     * destroyed. The destructor waits for every worker to have been started
+     * and to return.
+     *
+     * @tparam Spawn the type of the function starting workers
+     * @param workers the number of workers
+     * @param spawn the function starting workers
+     */
+    template<typename Spawn>
+    Executor(std::size_t workers, Spawn spawn)
+        : queues_(new Queue[workers + 1])
+        , workers_(workers)
+        , epoch_(0)
+        , idle_(0)
+        , exited_(0)
+        , stop_(false)
+    {
+        threads_.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i) {
+            spawn(Worker(this, i));
+        }
+    }
+
+    /** @brief Deleted copy constructor. */
+    Executor(const Executor&) = delete;
+
+    /** @brief Deleted copy assignment operator. */
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * @brief Stops all workers and waits for them to return.
+     *
+     * No work may be running on, or submitted to, this executor.
+     */
+    ~Executor()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stop_ = true;
+            ++epoch_;
+            cv_.notify_all();
+            cv_.wait(lock, [this] { return exited_ == workers_; });
+        }
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    /**
+     * @brief Returns the number of threads that can run tasks of a
+     *        `parallelFor()` at once, counting the caller's.
+     *
+     * @return the number of workers plus one
+     */
+    std::size_t concurrency() const
+    {
+        return workers_ + 1;
+    }
+
+    /**
+     * @brief Calls `f(i)` for each `i` in `[0, n)` in parallel and waits for
+     *        all calls to return.
+     *
+     * The calls may run in any order and on any thread, including the
+     * calling one. If any of them throws, the first exception caught is
+     * rethrown after all calls have finished.
+     *
+     * @tparam Fn the type of the function to call
+     * @param n the number of calls
+     * @param f the function to call with each index
+     */
+    template<typename Fn>
+    void parallelFor(std::size_t n, Fn f)
+    {
+        if (n == 0) {
+            return;
+        } else if (n == 1 || workers_ == 0) {
+            for (std::size_t i = 0; i < n; ++i) {
+                f(i);
+            }
+            return;
+        }
+
+        Job job(n, &invoke<Fn>, &f);
+        const auto self = index();
+        execute(Task{&job, 0, n}, self);
+        while (job.pending != 0) {
+            const std::uint64_t epoch = epoch_;
+            Task task;
+            if (take(task, self)) {
+                execute(task, self);
+            } else {
+                sleep(epoch, [&job] { return job.pending == 0; });
+            }
+        }
+
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+    /**
+     * @brief Schedules `f()` to run on a worker and returns immediately.
+     *
+     * `f` is moved into a heap-allocated task, which the submitting thread
+     * pushes onto its queue like a piece of a `parallelFor()`, so workers
+     * steal it the same way. With no workers, `f()` runs on the calling
+     * thread before `post()` returns. `f` must not throw; exceptions
+     * escaping it are discarded.
+     *
+     * @tparam Fn the type of the function to call
+     * @param f the function to call
+     */
+    template<typename Fn>
+    void post(Fn f)
+    {
+        if (workers_ == 0) {
+            try {
+                f();
+            } catch (...) {
+            }
+            return;
+        }
+        push(Task{new Posted<Fn>(std::move(f)), 0, 1}, index());
+    }
+
+private:
+    struct Job {
+        Job(std::size_t n, void (*run)(void*, std::size_t), void* fn,
+            void (*release)(Job*) = nullptr) noexcept
+            : run(run), fn(fn), release(release), pending(n)
+        {}
+
+        void (* const run)(void*, std::size_t);
+        void* const fn;
+        // Frees a job submitted with `post()` once it has run; no one waits
+        // for such jobs.
+        void (* const release)(Job*);
+        std::atomic<std::size_t> pending;
+        std::exception_ptr error;
+        std::mutex errorMutex;
+    };
+
+    // The calls of `job` for the indices in `[lo, hi)`.
+    struct Task {
+        Job* job;
+        std::size_t lo;
+        std::size_t hi;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // A job of a single call to `f()`, owning `f`.
+    template<typename Fn>
+    struct Posted : Job {
+        explicit Posted(Fn f)
+            : Job(1, &invokePosted<Fn>, this, &releasePosted<Fn>)
+            , f(std::move(f))
+        {}
+
+        Fn f;
+    };
+
+    template<typename Fn>
+    static void invoke(void* fn, std::size_t i)
+    {
+        (*static_cast<Fn*>(fn))(i);
+    }
+
+    template<typename Fn>
+    static void invokePosted(void* job, std::size_t)
+    {
+        static_cast<Posted<Fn>*>(job)->f();
+    }
+
+    template<typename Fn>
+    static void releasePosted(Job* job)
+    {
+        delete static_cast<Posted<Fn>*>(job);
+    }
+
+    // The executor and queue index of the worker running on this thread.
+    struct Current {
+        const Executor* executor;
+        std::size_t index;
+    };
+
+    static Current& current()
+    {
+        static thread_local Current c {nullptr, 0};
+        return c;
+    }
+
+    // Returns the index of the queue used by this thread: its own if it is
+    // one of our workers, or the shared one for all other threads.
+    std::size_t index() const
+    {
+        const auto& c = current();
+        return c.executor == this ? c.index : workers_;
+    }
+
+    void push(const Task& task, std::size_t self)
+    {
+        {
+            auto& q = queues_[self];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(task);
+        }
+        wake();
+    }
+
+    // Takes a task from the back of this thread's queue, or else steals one
+    // from the front of another queue.
+    bool take(Task& task, std::size_t self)
+    {
+        for (std::size_t k = 0; k <= workers_; ++k) {
+            const auto i = (self + k) % (workers_ + 1);
+            auto& q = queues_[i];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (!q.tasks.empty()) {
+                if (i == self) {
+                    task = q.tasks.back();
+                    q.tasks.pop_back();
+                } else {
+                    task = q.tasks.front();
+                    q.tasks.pop_front();
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Runs `task`, leaving all but its first call for others to steal.
+    void execute(Task task, std::size_t self)
+    {
+        auto& job = *task.job;
+        while (task.hi - task.lo > 1) {
+            const auto mid = task.lo + (task.hi - task.lo) / 2;
+            push(Task{&job, mid, task.hi}, self);
+            task.hi = mid;
+        }
+
+        try {
+            job.run(job.fn, task.lo);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job.errorMutex);
+            if (!job.error) {
+                job.error = std::current_exception();
+            }
+        }
+        if (job.release) {
+            job.release(&job);
+            return;
+        }
+        // The owner of `job` may destroy it as soon as nothing is pending.
+        if (--job.pending == 0) {
+            wake();
+        }
+    }
+
+    // Wakes all sleeping threads to look for work or check their jobs.
+    void wake()
+    {
+        ++epoch_;
+        if (idle_ != 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_all();
+        }
+    }
+
+    // Sleeps until `done()` or until `wake()` is called after `epoch` was
+    // observed.
+    template<typename Done>
+    void sleep(std::uint64_t epoch, Done done)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++idle_;
+        while (epoch_ == epoch && !done()) {
+            cv_.wait(lock);
+        }
+        --idle_;
+    }
+
+    void work(std::size_t self)
+    {
+        current() = Current{this, self};
+        for (;;) {
+            const std::uint64_t epoch = epoch_;
+            Task task;
+            if (take(task, self)) {
+                execute(task, self);
+            } else if (stop_) {
+                break;
+            } else {
+                sleep(epoch, [this] { return stop_.load(); });
+            }
+        }
+        current() = Current{nullptr, 0};
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++exited_;
+        cv_.notify_all();
+    }
+
+    std::unique_ptr<Queue[]> queues_;  // one per worker, then a shared one
+    const std::size_t workers_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<std::uint64_t> epoch_;
+    std::atomic<std::size_t> idle_;
+    std::size_t exited_;  // guarded by `mutex_`
+    std::atomic<bool> stop_;
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_EXECUTOR_HPP
@@ -0,0 +1,906 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/Future.hpp
+ * Values computed asynchronously, and combinators composing them.
+ */
+
+#ifndef GUNGNIR_FUTURE_HPP
+#define GUNGNIR_FUTURE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "gungnir/Executor.hpp"
+#include "gungnir/List.hpp"
+#include "gungnir/Option.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+template<typename T> class Future;
+template<typename T> class Promise;
+
+/// @cond GUNGNIR_PRIVATE
+namespace detail {
+
+template<typename T> class FutureState;
+
+// A function to call once a future completes, linked into the list kept by
+// the state of the future. Continuations live inside the objects that
+// register them, mostly the states of derived futures, so registering one
+// does not allocate.
+template<typename T>
+struct Continuation {
+    using Fire = void (*)(Continuation*, const FutureState<T>&);
+
+    explicit Continuation(Fire fire) noexcept : fire(fire), next(nullptr) {}
+
+    const Fire fire;
+    Continuation* next;
+};
+
+// A continuation that is the `I`th one of its owner, so that an owner can
+// listen to two futures of the same type.
+template<typename T, int I>
+struct Link : Continuation<T> {
+    explicit Link(typename Continuation<T>::Fire fire) noexcept
+        : Continuation<T>(fire)
+    {}
+};
+
+// The state shared by a future and its promise: the result, once claimed
+// and written by the first completion, and a lock-free stack of the
+// continuations registered before then. Completing swaps the stack for a
+// sentinel marking the state ready, and fires what it swapped out.
+template<typename T>
+class FutureState {
+public:
+    FutureState() noexcept : refs_(1), claimed_(false), head_(nullptr) {}
+
+    FutureState(const FutureState&) = delete;
+    FutureState& operator=(const FutureState&) = delete;
+
+    virtual ~FutureState() = default;
+
+    void retain() noexcept
+    {
+        refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() noexcept
+    {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    bool isReady() const noexcept
+    {
+        return head_.load(std::memory_order_acquire) == ready();
+    }
+
+    bool isClaimed() const noexcept
+    {
+        return claimed_.load(std::memory_order_relaxed);
+    }
+
+    // Valid once ready: the value, or null if the future failed.
+    const T* value() const noexcept
+    {
+        return value_.ptr();
+    }
+
+    const std::exception_ptr& error() const noexcept
+    {
+        return error_;
+    }
+
+    template<typename... Args>
+    bool trySucceed(Args&&... args)
+    {
+        if (!claim()) {
+            return false;
+        }
+        try {
+            value_.emplace(std::forward<Args>(args)...);
+        } catch (...) {
+            error_ = std::current_exception();
+        }
+        publish();
+        return true;
+    }
+
+    bool tryFail(std::exception_ptr e)
+    {
+        if (!claim()) {
+            return false;
+        }
+        error_ = std::move(e);
+        publish();
+        return true;
+    }
+
+    // Completes this state with the result of `s`, which is ready.
+    bool tryCopy(const FutureState& s)
+    {
+        return s.value() ? trySucceed(*s.value()) : tryFail(s.error());
+    }
+
+    // Calls `c->fire(c, *this)` once this state is ready: right away, on
+    // the calling thread, if it already is, or else on the thread that
+    // completes it.
+    void subscribe(Continuation<T>* c)
+    {
+        auto h = head_.load(std::memory_order_acquire);
+        do {
+            if (h == ready()) {
+                c->fire(c, *this);
+                return;
+            }
+            c->next = h;
+        } while (!head_.compare_exchange_weak(
+            h, c, std::memory_order_release, std::memory_order_acquire));
+    }
+
+    // Blocks until this state is ready.
+    void wait()
+    {
+        if (isReady()) {
+            return;
+        }
+        Waiter w;
+        subscribe(&w);
+        std::unique_lock<std::mutex> lock(w.m);
+        w.cv.wait(lock, [&w] { return w.done; });
+    }
+
+private:
+    struct Waiter : Continuation<T> {
+        Waiter() : Continuation<T>(&wake), done(false) {}
+
+        static void wake(Continuation<T>* c, const FutureState&)
+        {
+            const auto w = static_cast<Waiter*>(c);
+            std::lock_guard<std::mutex> lock(w->m);
+            w->done = true;
+            w->cv.notify_one();
+        }
+
+        std::mutex m;
+        std::condition_variable cv;
+        bool done;
+    };
+
+    static Continuation<T>* ready() noexcept
+    {
+        return reinterpret_cast<Continuation<T>*>(std::uintptr_t(1));
+    }
+
+    bool claim() noexcept
+    {
+        return !claimed_.load(std::memory_order_relaxed) &&
+               !claimed_.exchange(true, std::memory_order_acquire);
+    }
+
+    // Marks this state ready and fires the continuations registered so
+    // far, in the order they were registered. A continuation may free its
+    // owner, so each one's successor is read before it fires.
+    void publish()
+    {
+        auto h = head_.exchange(ready(), std::memory_order_acq_rel);
+        Continuation<T>* fifo = nullptr;
+        while (h) {
+            const auto next = h->next;
+            h->next = fifo;
+            fifo = h;
+            h = next;
+        }
+        while (fifo) {
+            const auto next = fifo->next;
+            fifo->fire(fifo, *this);
+            fifo = next;
+        }
+    }
+
+    std::atomic<std::size_t> refs_;
+    std::atomic<bool> claimed_;
+    std::atomic<Continuation<T>*> head_;
+    Option<T> value_;
+    std::exception_ptr error_;
+};
+
+// Creates futures from states and reaches the states of futures.
+struct FutureAccess {
+    template<typename T>
+    static FutureState<T>* state(const Future<T>& f) noexcept
+    {
+        return f.s_;
+    }
+
+    // Takes over the reference to `s` held by the caller.
+    template<typename T>
+    static Future<T> adopt(FutureState<T>* s) noexcept
+    {
+        return Future<T>(s);
+    }
+};
+
+// The state of a future derived from a single other one: `D::run(s)` is
+// called once `s` is ready, and must complete this state.
+template<typename D, typename A, typename B>
+class Derived : public FutureState<B>, public Link<A, 0> {
+public:
+    // Returns the future of a new `D` listening to `src`.
+    template<typename... Args>
+    static Future<B> listen(const Future<A>& src, Args&&... args)
+    {
+        const auto d = new D(std::forward<Args>(args)...);
+        d->retain();
+        FutureAccess::state(src)->subscribe(static_cast<Link<A, 0>*>(d));
+        return FutureAccess::adopt<B>(d);
+    }
+
+protected:
+    Derived() noexcept : Link<A, 0>(&fire) {}
+
+private:
+    static void fire(Continuation<A>* c, const FutureState<A>& s)
+    {
+        const auto d = static_cast<D*>(static_cast<Link<A, 0>*>(c));
+        d->run(s);
+        d->release();
+    }
+};
+
+template<typename A, typename B, typename Fn>
+class MapState final : public Derived<MapState<A, B, Fn>, A, B> {
+public:
+    explicit MapState(Fn f) : f_(std::move(f)) {}
+
+    void run(const FutureState<A>& s)
+    {
+        if (!s.value()) {
+            this->tryFail(s.error());
+            return;
+        }
+        try {
+            this->trySucceed(f_(*s.value()));
+        } catch (...) {
+            this->tryFail(std::current_exception());
+        }
+    }
+
+private:
+    Fn f_;
+};
+
+template<typename A, typename Fn>
+class FilterState final : public Derived<FilterState<A, Fn>, A, A> {
+public:
+    explicit FilterState(Fn p) : p_(std::move(p)) {}
+
+    void run(const FutureState<A>& s)
+    {
+        if (!s.value()) {
+            this->tryFail(s.error());
+            return;
+        }
+        try {
+            if (p_(*s.value())) {
+                this->trySucceed(*s.value());
+            } else {
+                throw std::out_of_range("future value does not satisfy the predicate");
+            }
+        } catch (...) {
+            this->tryFail(std::current_exception());
+        }
+    }
+
+private:
+    Fn p_;
+};
+
+template<typename A, typename Fn>
+class RecoverState final : public Derived<RecoverState<A, Fn>, A, A> {
+public:
+    explicit RecoverState(Fn f) : f_(std::move(f)) {}
+
+    void run(const FutureState<A>& s)
+    {
+        if (s.value()) {
+            this->trySucceed(*s.value());
+            return;
+        }
+        try {
+            this->trySucceed(f_(s.error()));
+        } catch (...) {
+            this->tryFail(std::current_exception());
+        }
+    }
+
+private:
+    Fn f_;
+};
+
+// Listens to the future returned by `f` as well, through its second link.
+template<typename A, typename B, typename Fn>
+class FlatMapState final
+    : public Derived<FlatMapState<A, B, Fn>, A, B>
+    , public Link<B, 1> {
+public:
+    explicit FlatMapState(Fn f) : Link<B, 1>(&fireInner), f_(std::move(f)) {}
+
+    void run(const FutureState<A>& s)
+    {
+        if (!s.value()) {
+            this->tryFail(s.error());
+            return;
+        }
+        try {
+            const Future<B> inner = f_(*s.value());
+            this->retain();
+            FutureAccess::state(inner)->subscribe(static_cast<Link<B, 1>*>(this));
+        } catch (...) {
+            this->tryFail(std::current_exception());
+        }
+    }
+
+private:
+    static void fireInner(Continuation<B>* c, const FutureState<B>& s)
+    {
+        const auto d = static_cast<FlatMapState*>(static_cast<Link<B, 1>*>(c));
+        d->tryCopy(s);
+        d->release();
+    }
+
+    Fn f_;
+};
+
+template<typename A, typename B>
+class ZipState final
+    : public FutureState<std::pair<A, B>>
+    , public Link<A, 0>
+    , public Link<B, 1> {
+public:
+    static Future<std::pair<A, B>> listen(const Future<A>& a, const Future<B>& b)
+    {
+        const auto d = new ZipState(a, b);
+        d->retain();
+        d->retain();
+        FutureAccess::state(a)->subscribe(static_cast<Link<A, 0>*>(d));
+        FutureAccess::state(b)->subscribe(static_cast<Link<B, 1>*>(d));
+        return FutureAccess::adopt<std::pair<A, B>>(d);
+    }
+
+private:
+    ZipState(const Future<A>& a, const Future<B>& b)
+        : Link<A, 0>(&fireA)
+        , Link<B, 1>(&fireB)
+        , a_(a)
+        , b_(b)
+        , pending_(2)
+    {}
+
+    static void fireA(Continuation<A>* c, const FutureState<A>& s)
+    {
+        static_cast<ZipState*>(static_cast<Link<A, 0>*>(c))->arrive(s.error());
+    }
+
+    static void fireB(Continuation<B>* c, const FutureState<B>& s)
+    {
+        static_cast<ZipState*>(static_cast<Link<B, 1>*>(c))->arrive(s.error());
+    }
+
+    // Fails on the first error, and succeeds once both sides have.
+    void arrive(const std::exception_ptr& error)
+    {
+        if (error) {
+            this->tryFail(error);
+        } else if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            this->trySucceed(a_.get(), b_.get());
+        }
+        this->release();
+    }
+
+    const Future<A> a_;
+    const Future<B> b_;
+    std::atomic<int> pending_;
+};
+
+// Listens to all futures of a list, with one continuation per future in a
+// single array.
+template<typename A>
+class SequenceState final : public FutureState<List<A>> {
+public:
+    static Future<List<A>> listen(const List<Future<A>>& fs)
+    {
+        const auto d = new SequenceState(fs);
+        if (fs.isEmpty()) {
+            d->trySucceed();
+        }
+        std::size_t i = 0;
+        for (const auto& f : fs) {
+            d->retain();
+            FutureAccess::state(f)->subscribe(&d->nodes_[i++]);
+        }
+        return FutureAccess::adopt<List<A>>(d);
+    }
+
+private:
+    struct Node : Continuation<A> {
+        Node() noexcept : Continuation<A>(&fire), owner(nullptr) {}
+
+        static void fire(Continuation<A>* c, const FutureState<A>& s)
+        {
+            static_cast<Node*>(c)->owner->arrive(s.error());
+        }
+
+        SequenceState* owner;
+    };
+
+    explicit SequenceState(const List<Future<A>>& fs)
+        : fs_(fs)
+        , nodes_(new Node[fs.size()])
+        , pending_(fs.size())
+    {
+        for (std::size_t i = 0; i < fs.size(); ++i) {
+            nodes_[i].owner = this;
+        }
+    }
+
+    void arrive(const std::exception_ptr& error)
+    {
+        if (error) {
+            this->tryFail(error);
+        } else if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1 && !this->isClaimed()) {
+            this->trySucceed(fs_.map([](const Future<A>& f) { return f.get(); }));
+        }
+        this->release();
+    }
+
+    const List<Future<A>> fs_;
+    const std::unique_ptr<Node[]> nodes_;
+    std::atomic<std::size_t> pending_;
+};
+
+template<typename T>
+struct FutureValue;
+
+template<typename T>
+struct FutureValue<Future<T>> {
+    using type = T;
+};
+
+template<typename B, typename Fn>
+struct AsyncTask {
+    void operator()()
+    {
+        try {
+            p.success(f());
+        } catch (...) {
+            p.failure(std::current_exception());
+        }
+    }
+
+    Promise<B> p;
+    Fn f;
+};
+
+}  // namespace detail
+/// @endcond
+
+/**
+ * @brief The result of an asynchronous computation: a value of type `T`, or
+ *        an exception if the computation failed.
+ *
+ * A future is completed once, through its `Promise`, and its result never
+ * changes afterwards. Futures are cheap to copy, and their copies share
+ * the result. Combinators such as `map()` and `flatMap()` return new
+ * futures derived from this one without blocking; the functions passed to
+ * them run once this future completes, on the thread that completes it, or
+ * right away on the calling thread if it already has, so they should be
+ * short. Longer computations can be moved onto an `Executor` with
+ * `async()`, e.g. `f.flatMap([](const A& x) { return async([x] { ... }); })`.
+ * Exceptions thrown by those functions fail the derived futures, and
+ * failures propagate through `map()`, `flatMap()`, `filter()` and `zip()`
+ * untouched until a `recover()` handles them.
+ *
+ * Completion is lock-free: a future keeps the continuations registered on
+ * it in a lock-free stack, and the first completion takes the stack and
+ * fires them. The continuation a combinator registers is stored inside
+ * the future it returns, so composing futures allocates just that future.
+ * Only `get()` and `wait()` block, on a condition variable, when the result
+ * is not ready yet.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam T the type of the value; must be a non-reference type
+ */
+template<typename T>
+class Future final {
+public:
+    /** @brief The type of the value of a future. */
+    using ValueType = T;
+
+    /**
+     * @brief Returns a future that has succeeded with the given value.
+     *
+     * @param x the value
+     * @return a future that has succeeded with `x`
+     */
+    static Future successful(T x)
+    {
+        const auto s = new detail::FutureState<T>;
+        s->trySucceed(std::move(x));
+        return Future(s);
+    }
+
+    /**
+     * @brief Returns a future that has failed with the given exception.
+     *
+     * @param e the exception
+     * @return a future that has failed with `e`
+     */
+    static Future failed(std::exception_ptr e)
+    {
+        const auto s = new detail::FutureState<T>;
+        s->tryFail(std::move(e));
+        return Future(s);
+    }
+
+    Future(const Future& that) noexcept : s_(that.s_)
+    {
+        if (s_) {
+            s_->retain();
+        }
+    }
+
+    Future(Future&& that) noexcept : s_(that.s_)
+    {
+        that.s_ = nullptr;
+    }
+
+    Future& operator=(Future that) noexcept
+    {
+        std::swap(s_, that.s_);
+        return *this;
+    }
+
+    ~Future()
+    {
+        if (s_) {
+            s_->release();
+        }
+    }
+
+    /**
+     * @brief Returns `true` if this future has completed.
+     *
+     * @return `true` if this future has completed, `false` otherwise
+     */
+    bool isReady() const noexcept
+    {
+        return s_->isReady();
+    }
+
+    /**
+     * @brief Blocks until this future has completed.
+     */
+    void wait() const
+    {
+        s_->wait();
+    }
+
+    /**
+     * @brief Blocks until this future has completed, and returns its value.
+     *
+     * @return the value of this future
+     * @throws the exception this future failed with, if it failed
+     */
+    const T& get() const
+    {
+        s_->wait();
+        if (!s_->value()) {
+            std::rethrow_exception(s_->error());
+        }
+        return *s_->value();
+    }
+
+    /**
+     * @brief Returns a future of the result of applying a function to the
+     *        value of this future.
+     *
+     * @tparam Fn the type of the function to apply
+     * @tparam B the result type of the function
+     * @param f the function to apply to the value of this future
+     * @return a future of `f` applied to the value of this future
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, const T&>>>
+    Future<B> map(Fn f) const
+    {
+        return detail::MapState<T, B, Fn>::listen(*this, std::move(f));
+    }
+
+    /**
+     * @brief Returns a future of the result of the future returned by
+     *        a function applied to the value of this future.
+     *
+     * @tparam Fn the type of the function to apply
+     * @tparam B the value type of the futures returned by the function
+     * @param f the function to apply to the value of this future
+     * @return a future of the result of the future returned by `f`
+     */
+    template<
+        typename Fn,
+        typename B = typename detail::FutureValue<Decay<Ret<Fn, const T&>>>::type
+    >
+    Future<B> flatMap(Fn f) const
+    {
+        return detail::FlatMapState<T, B, Fn>::listen(*this, std::move(f));
+    }
+
+    /**
+     * @brief Returns a future of the value of this future, if it satisfies
+     *        a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test the value
+     * @return a future of the value of this future, which fails with
+     *         `std::out_of_range` if the value does not satisfy `p`
+     */
+    template<typename Fn>
+    Future filter(Fn p) const
+    {
+        return detail::FilterState<T, Fn>::listen(*this, std::move(p));
+    }
+
+    /**
+     * @brief Returns a future of the value of this future, or if this future
+     *        fails, of the result of a function applied to its exception.
+     *
+     * `f` can rethrow the exception, or throw another one, to leave the
+     * failure unhandled.
+     *
+     * @tparam Fn the type of the function handling failures
+     * @param f the function computing a value from an `std::exception_ptr`
+     * @return a future of the value of this future, or of `f` applied to
+     *         its exception
+     */
+    template<typename Fn>
+    Future recover(Fn f) const
+    {
+        return detail::RecoverState<T, Fn>::listen(*this, std::move(f));
+    }
+
+    /**
+     * @brief Returns a future of the pair of the values of this future and
+     *        another one.
+     *
+     * @tparam B the value type of `that`
+     * @param that the future providing the second value
+     * @return a future of the pair of the values of this future and `that`,
+     *         which fails as soon as either of them does
+     */
+    template<typename B>
+    Future<std::pair<T, B>> zip(const Future<B>& that) const
+    {
+        return detail::ZipState<T, B>::listen(*this, that);
+    }
+
+private:
+    friend struct detail::FutureAccess;
+
+    explicit Future(detail::FutureState<T>* s) noexcept : s_(s) {}
+
+    detail::FutureState<T>* s_;
+};
+
+/**
+ * @brief The producer side of a `Future`, completing it once.
+ *
+ * A promise that is destroyed before completing fails its future with
+ * `std::runtime_error`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam T the type of the value
+ */
+template<typename T>
+class Promise final {
+public:
+    /**
+     * @brief Constructs a promise of a new future.
+     */
+    Promise() : s_(new detail::FutureState<T>) {}
+
+    Promise(Promise&& that) noexcept : s_(that.s_)
+    {
+        that.s_ = nullptr;
+    }
+
+    Promise& operator=(Promise that) noexcept
+    {
+        std::swap(s_, that.s_);
+        return *this;
+    }
+
+    ~Promise()
+    {
+        if (s_) {
+            s_->tryFail(std::make_exception_ptr(std::runtime_error("broken promise")));
+            s_->release();
+        }
+    }
+
+    /**
+     * @brief Returns the future completed by this promise.
+     *
+     * @return the future completed by this promise
+     */
+    Future<T> future() const noexcept
+    {
+        s_->retain();
+        return detail::FutureAccess::adopt(s_);
+    }
+
+    /**
+     * @brief Completes the future with a value constructed from the given
+     *        arguments, if it has not been completed yet.
+     *
+     * @tparam Args the types of the arguments
+     * @param args the arguments to the constructor of the value
+     * @return `true` if this call completed the future, `false` otherwise
+     */
+    template<typename... Args>
+    bool trySuccess(Args&&... args)
+    {
+        return s_->trySucceed(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Fails the future with the given exception, if it has not been
+     *        completed yet.
+     *
+     * @param e the exception
+     * @return `true` if this call completed the future, `false` otherwise
+     */
+    bool tryFailure(std::exception_ptr e)
+    {
+        return s_->tryFail(std::move(e));
+    }
+
+    /**
+     * @brief Completes the future with a value constructed from the given
+     *        arguments.
+     *
+     * @tparam Args the types of the arguments
+     * @param args the arguments to the constructor of the value
+     * @throws std::logic_error if the future has already been completed
+     */
+    template<typename... Args>
+    void success(Args&&... args)
+    {
+        if (!trySuccess(std::forward<Args>(args)...)) {
+            throw std::logic_error("promise already completed");
+        }
+    }
+
+    /**
+     * @brief Fails the future with the given exception.
+     *
+     * @param e the exception
+     * @throws std::logic_error if the future has already been completed
+     */
+    void failure(std::exception_ptr e)
+    {
+        if (!tryFailure(std::move(e))) {
+            throw std::logic_error("promise already completed");
+        }
+    }
+
+private:
+    detail::FutureState<T>* s_;
+};
+
+/**
+ * @brief Runs a function on an executor and returns a future of its result.
+ *
+ * @tparam Fn the type of the function
+ * @tparam B the result type of the function
+ * @param executor the executor to run `f` on
+ * @param f the function to run
+ * @return a future of the result of `f()`, which fails with the exception
+ *         `f()` throws, if any
+ */
+template<typename Fn, typename B = Decay<Ret<Fn>>>
+Future<B> async(Executor& executor, Fn f)
+{
+    Promise<B> p;
+    auto future = p.future();
+    executor.post(detail::AsyncTask<B, Fn> { std::move(p), std::move(f) });
+    return future;
+}
+
+/**
+ * @brief Runs a function on the global executor and returns a future of its
+ *        result.
+ *
+ * @tparam Fn the type of the function
+ * @tparam B the result type of the function
+ * @param f the function to run
+ * @return a future of the result of `f()`, which fails with the exception
+ *         `f()` throws, if any
+ */
+template<typename Fn, typename B = Decay<Ret<Fn>>>
+Future<B> async(Fn f)
+{
+    return async(Executor::global(), std::move(f));
+}
+
+/**
+ * @brief Returns a future of the list of the values of a list of futures.
+ *
+ * @tparam A the value type of the futures
+ * @param fs the futures
+ * @return a future of the values of `fs`, in order, which fails as soon as
+ *         any of them does
+ */
+template<typename A>
+Future<List<A>> sequence(const List<Future<A>>& fs)
+{
+    return detail::SequenceState<A>::listen(fs);
+}
+
+/**
+ * @brief Applies an asynchronous function to each element of a list, and
+ *        returns a future of the list of the results.
+ *
+ * @tparam A the element type of the list
+ * @tparam Alloc the allocator type of the list
+ * @tparam Fn the type of the function, returning `Future`s
+ * @tparam B the value type of the futures returned by the function
+ * @param xs the list
+ * @param f the function to apply to each element of `xs`
+ * @return a future of the values of the futures returned by `f`, in order,
+ *         which fails as soon as any of them does
+ */
+template<
+    typename A,
+    typename Alloc,
+    typename Fn,
+    typename B = typename detail::FutureValue<Decay<Ret<Fn, const A&>>>::type
+>
+Future<List<B>> traverse(const List<A, Alloc>& xs, Fn f)
+{
+    ListBuilder<Future<B>> buf;
+    for (const auto& x : xs) {
+        buf.append(f(x));
+    }
+    return sequence(buf.result());
+}
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_FUTURE_HPP
@@ -0,0 +1,563 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/Generator.hpp
+ * A sequence of elements produced on demand by a C++20 coroutine.
+ *
+ * The contents of this header are only available if the compiler supports
+ * coroutines, in which case `GUNGNIR_HAS_COROUTINES` is defined to 1;
+ * otherwise it is defined to 0 and the header declares nothing.
+ */
+
+#ifndef GUNGNIR_GENERATOR_HPP
+#define GUNGNIR_GENERATOR_HPP
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define GUNGNIR_HAS_COROUTINES 1
+#else
+#define GUNGNIR_HAS_COROUTINES 0
+#endif
+
+#if GUNGNIR_HAS_COROUTINES
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "gungnir/List.hpp"
+#include "gungnir/Option.hpp"
+#include "gungnir/PoolAllocator.hpp"
+#include "gungnir/Stream.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+template<typename A> class Generator;
+
+/// @cond GUNGNIR_PRIVATE
+namespace detail {
+
+template<std::size_t N>
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FrameBlock {
+    unsigned char bytes[N];
+};
+
+// Coroutine frames of up to 1 KiB are recycled through per-thread caches,
+// one per power-of-two size class, so that a producer started once per
+// page or per file reuses the frame of the previous one; larger frames go
+// straight to the global `operator new`.
+template<std::size_t N>
+using FrameCache = BlockCache<FrameBlock<N>, std::allocator<FrameBlock<N>>, 64>;
+
+template<std::size_t N>
+void* allocateFrameIn()
+{
+    if (const auto p = FrameCache<N>::pop()) {
+        return p;
+    }
+    return std::allocator<FrameBlock<N>>().allocate(1);
+}
+
+template<std::size_t N>
+void deallocateFrameIn(void* p)
+{
+    const auto b = static_cast<FrameBlock<N>*>(p);
+    if (!FrameCache<N>::push(b)) {
+        std::allocator<FrameBlock<N>>().deallocate(b, 1);
+    }
+}
+
+inline void* allocateFrame(std::size_t n)
+{
+    if (n <= 128) {
+        return allocateFrameIn<128>();
+    } else if (n <= 256) {
+        return allocateFrameIn<256>();
+    } else if (n <= 512) {
+        return allocateFrameIn<512>();
+    } else if (n <= 1024) {
+        return allocateFrameIn<1024>();
+    }
+    return ::operator new(n);
+}
+
+inline void deallocateFrame(void* p, std::size_t n)
+{
+    if (n <= 128) {
+        deallocateFrameIn<128>(p);
+    } else if (n <= 256) {
+        deallocateFrameIn<256>(p);
+    } else if (n <= 512) {
+        deallocateFrameIn<512>(p);
+    } else if (n <= 1024) {
+        deallocateFrameIn<1024>(p);
+    } else {
+        ::operator delete(p);
+    }
+}
+
+// The request to yield all elements of a nested generator, as returned by
+// `elementsOf()`.
+template<typename A>
+struct ElementsOf {
+    Generator<A> g;
+};
+
+namespace stage {
+
+// A view pipeline source draining a generator, which the pipeline shares
+// so that it can be copied like the other stages.
+template<typename A>
+struct GeneratorSource {
+    using Elem = A;
+    using Allocator = std::allocator<A>;
+
+    Allocator allocator() const { return Allocator(); }
+
+    template<typename Sink>
+    void run(Sink& k) const
+    {
+        for (const auto& x : *g) {
+            if (!k(x)) {
+                return;
+            }
+        }
+    }
+
+    std::shared_ptr<Generator<A>> g;
+};
+
+}  // namespace stage
+
+}  // namespace detail
+/// @endcond
+
+/**
+ * @brief Returns a request to yield all elements of `g`, for use as
+ *        `co_yield elementsOf(std::move(g))` in the body of a generator.
+ *
+ * The outer generator transfers control directly to `g` and `g` back to
+ * it when done, so the elements of nested generators reach the consumer
+ * without passing through each enclosing level, however deep the nesting.
+ *
+ * @tparam A the type of the elements
+ * @param g the generator whose elements to yield
+ * @return the request to yield all elements of `g`
+ */
+template<typename A>
+detail::ElementsOf<A> elementsOf(Generator<A>&& g) noexcept
+{
+    return detail::ElementsOf<A> { std::move(g) };
+}
+
+/**
+ * @brief A single-pass sequence of elements produced on demand by a
+ *        coroutine.
+ *
+ * A function returning `Generator<A>` is a coroutine that produces its
+ * elements with `co_yield`, e.g. reading one page of results or one block
+ * of a file at a time:
+ *
+ *     Generator<Row> rows(Client& c)
+ *     {
+ *         for (auto page = c.first(); !page.empty(); page = c.next(page)) {
+ *             for (auto& row : page.rows()) {
+ *                 co_yield row;
+ *             }
+ *         }
+ *     }
+ *
+ * The body runs only as elements are requested, up to the next `co_yield`.
+ * Yielding an element hands the consumer a reference to it rather than a
+ * copy, so elements cost no allocation; the frame of the coroutine is
+ * allocated once, from a per-thread cache of recently freed frames. A
+ * generator can yield the elements of another with `elementsOf()`.
+ *
+ * The elements are consumed by iterating the generator, by `foreach()`,
+ * `foldLeft()` or `toList()`, or lazily through `view()` and `toStream()`,
+ * which feed them to `ListView` and `Stream` pipelines. Each element is
+ * produced once: a generator can be traversed only once, and a traversal
+ * that stops early leaves the remaining elements to the next one.
+ * Exceptions thrown by the body propagate to the consumer.
+ *
+ * Only available if `GUNGNIR_HAS_COROUTINES` is 1.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements
+ */
+template<typename A>
+class Generator final {
+public:
+    class promise_type;
+
+private:
+    using Handle = std::coroutine_handle<promise_type>;
+
+public:
+    /** @brief The promise type of generator coroutines. */
+    class promise_type final {
+        struct FinalAwaiter;
+        struct NestedAwaiter;
+
+    public:
+        promise_type() noexcept : root_(this), leaf_(this) {}
+
+        static void* operator new(std::size_t n)
+        {
+            return detail::allocateFrame(n);
+        }
+
+        static void operator delete(void* p, std::size_t n) noexcept
+        {
+            detail::deallocateFrame(p, n);
+        }
+
+        Generator get_return_object() noexcept
+        {
+            return Generator(Handle::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        // `x` outlives the suspension: it is either an lvalue in the
+        // coroutine or a temporary of the enclosing full expression.
+        std::suspend_always yield_value(const A& x) noexcept
+        {
+            root_->value_ = std::addressof(x);
+            return {};
+        }
+
+        NestedAwaiter yield_value(detail::ElementsOf<A> e) noexcept
+        {
+            return NestedAwaiter { std::move(e.g) };
+        }
+
+        void return_void() const noexcept {}
+
+        void unhandled_exception() noexcept
+        {
+            error_ = std::current_exception();
+        }
+
+        template<typename X>
+        void await_transform(X&&) = delete;
+
+    private:
+        friend class Generator;
+
+        // The promise of the outermost generator, which holds the current
+        // element and the innermost generator producing elements.
+        promise_type* root_;
+        promise_type* leaf_;
+        promise_type* parent_ = nullptr;
+        const A* value_ = nullptr;
+        std::exception_ptr error_;
+    };
+
+    /** @brief An `InputIterator` over the elements of a generator. */
+    class StdIterator final {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = A;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const A*;
+        using reference = const A&;
+
+        StdIterator() noexcept = default;
+
+        reference operator*() const noexcept
+        {
+            return g_->value();
+        }
+
+        pointer operator->() const noexcept
+        {
+            return std::addressof(g_->value());
+        }
+
+        StdIterator& operator++()
+        {
+            g_->resume();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        bool operator==(const StdIterator& that) const noexcept
+        {
+            return isEnd() == that.isEnd();
+        }
+
+        bool operator!=(const StdIterator& that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+    private:
+        friend class Generator;
+
+        explicit StdIterator(Generator* g) noexcept : g_(g) {}
+
+        bool isEnd() const noexcept
+        {
+            return !g_ || g_->isDone();
+        }
+
+        Generator* g_ = nullptr;
+    };
+
+    /**
+     * @brief Constructs a generator with no elements.
+     */
+    Generator() noexcept = default;
+
+    Generator(Generator&& that) noexcept : h_(that.h_)
+    {
+        that.h_ = nullptr;
+    }
+
+    Generator& operator=(Generator that) noexcept
+    {
+        std::swap(h_, that.h_);
+        return *this;
+    }
+
+    ~Generator()
+    {
+        if (h_) {
+            h_.destroy();
+        }
+    }
+
+    /**
+     * @brief Runs the coroutine to its first element, and returns an
+     *        iterator to it.
+     *
+     * May only be called once.
+     *
+     * @return an iterator to the first element of this generator
+     */
+    StdIterator begin()
+    {
+        resume();
+        return StdIterator(this);
+    }
+
+    /**
+     * @brief Returns an iterator past the last element of this generator.
+     *
+     * @return an iterator past the last element of this generator
+     */
+    StdIterator end() noexcept
+    {
+        return StdIterator();
+    }
+
+    /**
+     * @brief Applies a function to each element of this generator.
+     *
+     * @tparam Fn the type of the function to apply
+     * @param f the function to apply to each element of this generator
+     */
+    template<typename Fn>
+    void foreach(Fn f)
+    {
+        for (const auto& x : *this) {
+            f(x);
+        }
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this generator, going left to right.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this generator, going left to right with the start value `z`
+     *         on the left, or `z` if this generator is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op)
+    {
+        for (const auto& x : *this) {
+            z = op(std::move(z), x);
+        }
+        return z;
+    }
+
+    /**
+     * @brief Returns a list of the elements of this generator.
+     *
+     * @tparam Alloc the allocator type of the returned list
+     * @param alloc the allocator used by the returned list
+     * @return a list of copies of the elements of this generator, in order
+     */
+    template<typename Alloc = std::allocator<A>>
+    List<A, Alloc> toList(const Alloc& alloc = Alloc())
+    {
+        ListBuilder<A, Alloc> buf(alloc);
+        for (const auto& x : *this) {
+            buf.append(x);
+        }
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns a lazy view of the elements of this generator, taking
+     *        it over.
+     *
+     * Transformations chained on the view are fused into the loop driving
+     * the coroutine, which runs only when a terminal operation is invoked
+     * on the view. The view remains single-pass.
+     *
+     * @return a lazy view of the elements of this generator
+     */
+    ListView<detail::stage::GeneratorSource<A>> view() &&
+    {
+        return ListView<detail::stage::GeneratorSource<A>>(
+            { std::make_shared<Generator>(std::move(*this)) });
+    }
+
+    /**
+     * @brief Returns a stream of the elements of this generator, taking it
+     *        over.
+     *
+     * The coroutine runs to the first element right away, and to each
+     * next element only when the tail of the stream preceding it is first
+     * accessed. The stream memoizes the elements, so unlike the generator
+     * it can be traversed more than once.
+     *
+     * @return a stream of the elements of this generator
+     */
+    Stream<A> toStream() &&
+    {
+        using G = std::shared_ptr<Generator>;
+        using R = std::pair<A, G>;
+
+        return Stream<A>::unfold(std::make_shared<Generator>(std::move(*this)), [](G g) {
+            g->resume();
+            if (g->isDone()) {
+                return Option<R>();
+            }
+            return Option<R>(R(g->value(), std::move(g)));
+        });
+    }
+
+private:
+    explicit Generator(Handle h) noexcept : h_(h) {}
+
+    bool isDone() const noexcept
+    {
+        return !h_ || h_.done();
+    }
+
+    const A& value() const noexcept
+    {
+        return *h_.promise().value_;
+    }
+
+    // Runs the innermost active coroutine to its next element, or to the
+    // end of this generator.
+    void resume()
+    {
+        if (isDone()) {
+            return;
+        }
+        auto& p = h_.promise();
+        Handle::from_promise(*p.leaf_).resume();
+        if (p.error_) {
+            std::rethrow_exception(std::exchange(p.error_, nullptr));
+        }
+    }
+
+    Handle h_;
+};
+
+// Transfers control to the generator that yielded the elements of this
+// one, if any, or back to the consumer otherwise.
+template<typename A>
+struct Generator<A>::promise_type::FinalAwaiter {
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(Handle h) const noexcept
+    {
+        auto& p = h.promise();
+        if (!p.parent_) {
+            return std::noop_coroutine();
+        }
+        p.root_->leaf_ = p.parent_;
+        return Handle::from_promise(*p.parent_);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+// Transfers control to a nested generator, which yields its elements
+// directly to the consumer.
+template<typename A>
+struct Generator<A>::promise_type::NestedAwaiter {
+    bool await_ready() const noexcept
+    {
+        return g.isDone();
+    }
+
+    Handle await_suspend(Handle h) noexcept
+    {
+        auto& p = h.promise();
+        auto& q = g.h_.promise();
+        q.root_ = p.root_;
+        q.parent_ = &p;
+        p.root_->leaf_ = &q;
+        return g.h_;
+    }
+
+    void await_resume() const
+    {
+        if (g.h_ && g.h_.promise().error_) {
+            std::rethrow_exception(g.h_.promise().error_);
+        }
+    }
+
+    Generator g;
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_HAS_COROUTINES
+
+#endif  // GUNGNIR_GENERATOR_HPP
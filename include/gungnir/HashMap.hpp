@@ -0,0 +1,618 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/HashMap.hpp
+ * A persistent hash map with effectively constant-time lookups and updates.
+ */
+
+#ifndef GUNGNIR_HASH_MAP_HPP
+#define GUNGNIR_HASH_MAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "gungnir/Option.hpp"
+#include "gungnir/detail/hamt.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+using namespace detail;
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Alloc>
+class TransientHashMap;
+
+/**
+ * @brief An immutable hash map.
+ *
+ * The entries are stored in a hash array mapped trie: each node consumes
+ * 5 bits of the hash of a key and stores only its occupied slots, located
+ * with a popcount of its bitmaps. Lookups, `updated()` and `removed()`
+ * take O(log32 n) time, and maps derived from one another share all but
+ * the modified paths of their tries.
+ *
+ * The entries are visited in an unspecified order.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam K the type of the keys; must be copy constructible
+ * @tparam V the type of the values; must be copy constructible
+ * @tparam Hash the type of the hash function of the keys, which is default
+ *              constructed to hash each key
+ * @tparam KeyEqual the type of the equality of the keys, which is default
+ *                  constructed to compare each pair of keys
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               this map
+ */
+template<
+    typename K,
+    typename V,
+    typename Hash = std::hash<K>,
+    typename KeyEqual = std::equal_to<K>,
+    typename Alloc = std::allocator<std::pair<const K, V>>
+>
+class HashMap final {
+public:
+    /** @brief The type of the entries. */
+    using value_type = std::pair<const K, V>;
+
+    /**
+     * @brief Constructs an empty map.
+     */
+    HashMap() noexcept : HashMap(Alloc()) {}
+
+    /**
+     * @brief Constructs an empty map whose nodes will be allocated
+     *        with `alloc`.
+     *
+     * @param alloc the allocator used by this map and the maps derived
+     *              from it
+     */
+    explicit HashMap(const Alloc& alloc) noexcept : trie_(alloc) {}
+
+    /**
+     * @brief Constructs a map with the given entries. Of entries with equal
+     *        keys, the last one is kept.
+     *
+     * @param entries the entries of this map
+     * @param alloc the allocator used by this map and the maps derived
+     *              from it
+     */
+    HashMap(std::initializer_list<value_type> entries, const Alloc& alloc = Alloc())
+        : HashMap(entries.begin(), entries.end(), alloc)
+    {}
+
+    /**
+     * @brief Constructs a map with the entries in the range [`first`, `last`).
+     *        Of entries with equal keys, the last one is kept.
+     *
+     * @tparam InputIt the type of the iterators
+     * @param first the iterator pointing to the start of the range
+     * @param last the iterator pointing to the end of the range
+     * @param alloc the allocator used by this map and the maps derived
+     *              from it
+     */
+    template<
+        typename InputIt,
+        typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<InputIt>::value_type, value_type
+        >::value>::type
+    >
+    HashMap(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : trie_(alloc)
+    {
+        for (; first != last; ++first) {
+            trie_.insert(*first);
+        }
+    }
+
+    /** @brief Default copy constructor. */
+    HashMap(const HashMap&) = default;
+
+    /** @brief Move constructor. The moved-from map is left empty. */
+    HashMap(HashMap&&) = default;
+
+    /** @brief Default copy assignment operator. */
+    HashMap& operator=(const HashMap&) = default;
+
+    /** @brief Move assignment operator. The moved-from map is left empty. */
+    HashMap& operator=(HashMap&&) = default;
+
+    /**
+     * @brief Returns a copy of the allocator used by this map.
+     *
+     * @return a copy of the allocator used by this map
+     */
+    Alloc allocator() const
+    {
+        return trie_.allocator();
+    }
+
+    /**
+     * @brief Returns `true` if this map contains no entries, `false` otherwise.
+     *
+     * @return `true` if this map contains no entries, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Returns the number of entries of this map.
+     *
+     * @return the number of entries of this map
+     */
+    std::size_t size() const
+    {
+        return trie_.size();
+    }
+
+    /**
+     * @brief Tests whether this map has an entry with the given key.
+     *
+     * @param key the key to look up
+     * @return `true` if this map has an entry with key `key`, `false` otherwise
+     */
+    bool contains(const K& key) const
+    {
+        return trie_.find(key) != nullptr;
+    }
+
+    /**
+     * @brief Returns the value associated with a key, if any.
+     *
+     * @param key the key to look up
+     * @return an option referring to the value associated with `key`, which
+     *         is empty if there is none; valid as long as this map is alive
+     */
+    UnownedOption<const V> get(const K& key) const
+    {
+        const auto e = trie_.find(key);
+        return UnownedOption<const V>(e ? &e->second : nullptr);
+    }
+
+    /**
+     * @brief Returns the value associated with a key.
+     *
+     * @param key the key to look up
+     * @return the value associated with `key`
+     * @throws std::out_of_range if this map has no entry with key `key`
+     */
+    const V& operator[](const K& key) const
+    {
+        const auto e = trie_.find(key);
+        if (!e) {
+            throw std::out_of_range("key not found");
+        }
+        return e->second;
+    }
+
+    /**
+     * @brief Returns a copy of this map in which a key is associated with
+     *        a new value.
+     *
+     * Only the trie nodes on the path to the entry are copied.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `V`
+     * @param key the key of the entry
+     * @param args the arguments passed to the constructor of `V`
+     * @return a copy of this map in which `key` is associated with a value
+     *         constructed in-place from `args`
+     */
+    template<typename... Args>
+    HashMap updated(const K& key, Args&&... args) const
+    {
+        HashMap m(*this);
+        m.trie_.insert(value_type(std::piecewise_construct,
+                                  std::forward_as_tuple(key),
+                                  std::forward_as_tuple(std::forward<Args>(args)...)));
+        return m;
+    }
+
+    /**
+     * @brief Returns a copy of this map without the entry with a key.
+     *
+     * Only the trie nodes on the path to the entry are copied; if there is
+     * no such entry, the whole trie is shared.
+     *
+     * @param key the key of the entry to remove
+     * @return a copy of this map without an entry with key `key`
+     */
+    HashMap removed(const K& key) const
+    {
+        HashMap m(*this);
+        m.trie_.erase(key);
+        return m;
+    }
+
+    /**
+     * Applies a function to each entry of this map.
+     *
+     * @param f the function to apply, for its side-effect,
+     *          to each entry of this map
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        trie_.foreachWhile([&f](const value_type& e) {
+            f(e);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Returns a map with the same keys as this map, whose values
+     *        result from applying a function to each entry of this map.
+     *
+     * The keys are not rehashed: the returned map has the same shape as
+     * this one.
+     *
+     * @tparam Fn the type of the function
+     * @tparam B the result type of the function
+     * @param f the function to apply to each entry of this map
+     * @return a map associating the key of each entry `e` of this map with
+     *         `f(e)`
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, const value_type&>>>
+    HashMap<K, B, Hash, KeyEqual, Rebind<Alloc, std::pair<const K, B>>> map(Fn f) const
+    {
+        using M = HashMap<K, B, Hash, KeyEqual, Rebind<Alloc, std::pair<const K, B>>>;
+        M m(allocator());
+        m.trie_ = trie_.template mapEntries<typename M::Trie>([&f](const value_type& e) {
+            return std::pair<const K, B>(e.first, f(e));
+        });
+        return m;
+    }
+
+    /**
+     * @brief Returns all entries of this map that satisfy a predicate.
+     *
+     * The subtrees all of whose entries satisfy the predicate are shared.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test entries
+     * @return a new map consisting of all entries of this map that
+     *         satisfy the given predicate `p`
+     */
+    template<typename Fn>
+    HashMap filter(Fn p) const
+    {
+        HashMap m(allocator());
+        m.trie_ = trie_.filter(std::move(p));
+        return m;
+    }
+
+    /**
+     * @brief Returns all entries of this map that violate a predicate.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test entries
+     * @return a new map consisting of all entries of this map that
+     *         violate the given predicate `p`
+     */
+    template<typename Fn>
+    HashMap filterNot(Fn p) const
+    {
+        return filter([&p](const value_type& e) { return !p(e); });
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for some entry of this map.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test entries
+     * @return `true` if the given predicate `p` holds for some entry of
+     *         this map, `false` otherwise
+     */
+    template<typename Fn>
+    bool exists(Fn p) const
+    {
+        return !trie_.foreachWhile([&p](const value_type& e) { return !p(e); });
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for all entries of this map.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test entries
+     * @return `true` if this map is empty or the given predicate `p`
+     *         holds for all entries of this map, `false` otherwise
+     */
+    template<typename Fn>
+    bool forall(Fn p) const
+    {
+        return trie_.foreachWhile([&p](const value_type& e) { return static_cast<bool>(p(e)); });
+    }
+
+    /**
+     * @brief Counts the number of entries in this map that satisfy
+     *        a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test entries
+     * @return the number of entries satisfying the given predicate `p`
+     */
+    template<typename Fn>
+    std::size_t count(Fn p) const
+    {
+        std::size_t n = 0;
+        foreach([&p, &n](const value_type& e) {
+            if (p(e)) {
+                ++n;
+            }
+        });
+        return n;
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all entries of
+     *        this map, in the order `foreach()` visits them.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive entries of
+     *         this map, with the start value `z` on the left, or `z` if
+     *         this map is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) const
+    {
+        foreach([&z, &op](const value_type& e) {
+            z = op(std::move(z), e);
+        });
+        return z;
+    }
+
+    /**
+     * @brief Compares this map with the given map for equality.
+     *
+     * @param that the map to be compared for equality with this map
+     * @return `true` if `that` has the same keys as this map, associated
+     *         with equal values, `false` otherwise
+     */
+    bool operator==(const HashMap& that) const
+    {
+        if (size() != that.size()) {
+            return false;
+        } else if (trie_.same(that.trie_)) {
+            return true;
+        }
+        return forall([&that](const value_type& e) {
+            const auto f = that.trie_.find(e.first);
+            return f && f->second == e.second;
+        });
+    }
+
+    /**
+     * @brief Compares this map with the given map for inequality.
+     *
+     * @param that the map to be compared for inequality with this map
+     * @return `true` if `that` does not have the same keys as this map,
+     *         associated with equal values, `false` otherwise
+     */
+    bool operator!=(const HashMap& that) const
+    {
+        return !(*this == that);
+    }
+
+    /**
+     * @brief Swaps the contents of this map and `that`.
+     *
+     * @param that the map to swap contents with
+     */
+    void swap(HashMap& that) noexcept
+    {
+        trie_.swap(that.trie_);
+    }
+
+    /**
+     * @brief Returns a transient copy of this map, which can be modified
+     *        in place and then frozen with `persistent()`.
+     *
+     * The transient shares the trie of this map, so this takes O(1) time;
+     * each node is copied at most once, the first time the transient
+     * modifies it.
+     *
+     * @return a transient map with the entries of this map
+     */
+    TransientHashMap<K, V, Hash, KeyEqual, Alloc> asTransient() const&
+    {
+        return TransientHashMap<K, V, Hash, KeyEqual, Alloc>(*this);
+    }
+
+    /**
+     * @brief Returns a transient map with the entries of this map, which
+     *        can be modified in place and then frozen with `persistent()`.
+     *
+     * @return a transient map with the entries of this map
+     */
+    TransientHashMap<K, V, Hash, KeyEqual, Alloc> asTransient() &&
+    {
+        return TransientHashMap<K, V, Hash, KeyEqual, Alloc>(std::move(*this));
+    }
+
+private:
+    template<typename, typename, typename, typename, typename>
+    friend class HashMap;
+
+    template<typename, typename, typename, typename, typename>
+    friend class TransientHashMap;
+
+    struct KeyOf {
+        const K& operator()(const value_type& e) const
+        {
+            return e.first;
+        }
+    };
+
+    using Trie = HashTrie<value_type, KeyOf, Hash, KeyEqual, Alloc>;
+
+    Trie trie_;
+};
+
+/**
+ * @brief A hash map under construction that is modified in place.
+ *
+ * A persistent map pays for persistence on every step of a bulk load:
+ * each `updated()` or `removed()` copies every node on the path to the
+ * entry. A transient map instead modifies the nodes only it references in
+ * place, copying each shared node at most once, and freezes them into a
+ * map once, with `persistent()`. Nodes that gain or lose a slot are still
+ * reallocated, since their slots are stored inline, but their contents are
+ * moved rather than copied.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam K the type of the keys; must be copy constructible
+ * @tparam V the type of the values; must be copy constructible
+ * @tparam Hash the type of the hash function of the keys
+ * @tparam KeyEqual the type of the equality of the keys
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               the map
+ */
+template<
+    typename K,
+    typename V,
+    typename Hash = std::hash<K>,
+    typename KeyEqual = std::equal_to<K>,
+    typename Alloc = std::allocator<std::pair<const K, V>>
+>
+class TransientHashMap final {
+    using M = HashMap<K, V, Hash, KeyEqual, Alloc>;
+
+public:
+    /** @brief The type of the entries. */
+    using value_type = std::pair<const K, V>;
+
+    /**
+     * @brief Constructs an empty transient map.
+     */
+    TransientHashMap() : TransientHashMap(M()) {}
+
+    /**
+     * @brief Constructs a transient map with the entries of `m`.
+     *
+     * @param m the map whose entries the transient starts with
+     */
+    explicit TransientHashMap(M m) noexcept : m_(std::move(m)) {}
+
+    /** @brief Deleted copy constructor. */
+    TransientHashMap(const TransientHashMap&) = delete;
+
+    /** @brief Move constructor. The moved-from transient is left empty. */
+    TransientHashMap(TransientHashMap&&) = default;
+
+    /** @brief Deleted copy assignment operator. */
+    TransientHashMap& operator=(const TransientHashMap&) = delete;
+
+    /** @brief Deleted move assignment operator. */
+    TransientHashMap& operator=(TransientHashMap&&) = delete;
+
+    /**
+     * @brief Returns the number of entries of this transient map.
+     *
+     * @return the number of entries of this transient map
+     */
+    std::size_t size() const
+    {
+        return m_.size();
+    }
+
+    /**
+     * @brief Tests whether this transient map has an entry with the given key.
+     *
+     * @param key the key to look up
+     * @return `true` if this transient map has an entry with key `key`,
+     *         `false` otherwise
+     */
+    bool contains(const K& key) const
+    {
+        return m_.contains(key);
+    }
+
+    /**
+     * @brief Returns the value associated with a key, if any.
+     *
+     * @param key the key to look up
+     * @return an option referring to the value associated with `key`, which
+     *         is empty if there is none; valid until this transient map is
+     *         next modified
+     */
+    UnownedOption<const V> get(const K& key) const
+    {
+        return m_.get(key);
+    }
+
+    /**
+     * @brief Associates a key with a new value.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `V`
+     * @param key the key of the entry
+     * @param args the arguments passed to the constructor of `V`
+     * @return a reference to this transient map
+     */
+    template<typename... Args>
+    TransientHashMap& update(const K& key, Args&&... args)
+    {
+        m_.trie_.insert(value_type(std::piecewise_construct,
+                                   std::forward_as_tuple(key),
+                                   std::forward_as_tuple(std::forward<Args>(args)...)));
+        return *this;
+    }
+
+    /**
+     * @brief Removes the entry with a key, if any.
+     *
+     * @param key the key of the entry to remove
+     * @return a reference to this transient map
+     */
+    TransientHashMap& remove(const K& key)
+    {
+        m_.trie_.erase(key);
+        return *this;
+    }
+
+    /**
+     * @brief Returns the map of all entries of this transient map and
+     *        empties it.
+     *
+     * @return the map of all entries of this transient map
+     */
+    M persistent()
+    {
+        M m(m_.allocator());
+        m.swap(m_);
+        return m;
+    }
+
+private:
+    M m_;
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_HASH_MAP_HPP
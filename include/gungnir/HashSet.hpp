@@ -0,0 +1,397 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/HashSet.hpp
+ * A persistent hash set with effectively constant-time lookups and updates.
+ */
+
+#ifndef GUNGNIR_HASH_SET_HPP
+#define GUNGNIR_HASH_SET_HPP
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "gungnir/detail/hamt.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+using namespace detail;
+
+/**
+ * @brief An immutable hash set.
+ *
+ * The elements are stored in a hash array mapped trie, like the entries of
+ * a `HashMap`. Lookups, `added()` and `removed()` take O(log32 n) time, and
+ * sets derived from one another share all but the modified paths of their
+ * tries.
+ *
+ * The elements are visited in an unspecified order.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements; must be copy constructible
+ * @tparam Hash the type of the hash function of the elements, which is
+ *              default constructed to hash each element
+ * @tparam KeyEqual the type of the equality of the elements, which is
+ *                  default constructed to compare each pair of elements
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               this set
+ */
+template<
+    typename A,
+    typename Hash = std::hash<A>,
+    typename KeyEqual = std::equal_to<A>,
+    typename Alloc = std::allocator<A>
+>
+class HashSet final {
+public:
+    /**
+     * @brief Constructs an empty set.
+     */
+    HashSet() noexcept : HashSet(Alloc()) {}
+
+    /**
+     * @brief Constructs an empty set whose nodes will be allocated
+     *        with `alloc`.
+     *
+     * @param alloc the allocator used by this set and the sets derived
+     *              from it
+     */
+    explicit HashSet(const Alloc& alloc) noexcept : trie_(alloc) {}
+
+    /**
+     * @brief Constructs a set with the given elements.
+     *
+     * @param xs the elements of this set
+     * @param alloc the allocator used by this set and the sets derived
+     *              from it
+     */
+    HashSet(std::initializer_list<A> xs, const Alloc& alloc = Alloc())
+        : HashSet(xs.begin(), xs.end(), alloc)
+    {}
+
+    /**
+     * @brief Constructs a set with the elements in the range [`first`, `last`).
+     *
+     * @tparam InputIt the type of the iterators
+     * @param first the iterator pointing to the start of the range
+     * @param last the iterator pointing to the end of the range
+     * @param alloc the allocator used by this set and the sets derived
+     *              from it
+     */
+    template<
+        typename InputIt,
+        typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<InputIt>::value_type, A
+        >::value>::type
+    >
+    HashSet(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : trie_(alloc)
+    {
+        for (; first != last; ++first) {
+            trie_.insert(*first);
+        }
+    }
+
+    /** @brief Default copy constructor. */
+    HashSet(const HashSet&) = default;
+
+    /** @brief Move constructor. The moved-from set is left empty. */
+    HashSet(HashSet&&) = default;
+
+    /** @brief Default copy assignment operator. */
+    HashSet& operator=(const HashSet&) = default;
+
+    /** @brief Move assignment operator. The moved-from set is left empty. */
+    HashSet& operator=(HashSet&&) = default;
+
+    /**
+     * @brief Returns a copy of the allocator used by this set.
+     *
+     * @return a copy of the allocator used by this set
+     */
+    Alloc allocator() const
+    {
+        return trie_.allocator();
+    }
+
+    /**
+     * @brief Returns `true` if this set contains no elements, `false` otherwise.
+     *
+     * @return `true` if this set contains no elements, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Returns the number of elements of this set.
+     *
+     * @return the number of elements of this set
+     */
+    std::size_t size() const
+    {
+        return trie_.size();
+    }
+
+    /**
+     * @brief Tests whether this set contains a given value as an element.
+     *
+     * @param x the value to test
+     * @return `true` if this set has an element equal to `x`, `false` otherwise
+     */
+    bool contains(const A& x) const
+    {
+        return trie_.find(x) != nullptr;
+    }
+
+    /**
+     * @brief Returns a copy of this set with an element added.
+     *
+     * Only the trie nodes on the path to the element are copied; if the
+     * set already contains it, the whole trie is shared.
+     *
+     * @param x the element to add
+     * @return a set consisting of all elements of this set and `x`
+     */
+    HashSet added(A x) const
+    {
+        if (contains(x)) {
+            return *this;
+        }
+        HashSet s(*this);
+        s.trie_.insert(std::move(x));
+        return s;
+    }
+
+    /**
+     * @brief Returns a copy of this set without an element.
+     *
+     * Only the trie nodes on the path to the element are copied; if the
+     * set does not contain it, the whole trie is shared.
+     *
+     * @param x the element to remove
+     * @return a set consisting of all elements of this set except `x`
+     */
+    HashSet removed(const A& x) const
+    {
+        HashSet s(*this);
+        s.trie_.erase(x);
+        return s;
+    }
+
+    /**
+     * Applies a function to each element of this set.
+     *
+     * @param f the function to apply, for its side-effect,
+     *          to each element of this set
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        trie_.foreachWhile([&f](const A& x) {
+            f(x);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Returns a new set resulting from applying a function to
+     *        each element of this set.
+     *
+     * @tparam Fn the type of the function
+     * @tparam B the result type of the function
+     * @param f the function to apply to each element of this set
+     * @return a new set of the results of applying the given function `f`
+     *         to each element of this set
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    HashSet<B, std::hash<B>, std::equal_to<B>, Rebind<Alloc, B>> map(Fn f) const
+    {
+        HashSet<B, std::hash<B>, std::equal_to<B>, Rebind<Alloc, B>> ys(allocator());
+        foreach([&f, &ys](const A& x) {
+            ys.trie_.insert(f(x));
+        });
+        return ys;
+    }
+
+    /**
+     * @brief Returns all elements of this set that satisfy a predicate.
+     *
+     * The subtrees all of whose elements satisfy the predicate are shared.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test elements
+     * @return a new set consisting of all elements of this set that
+     *         satisfy the given predicate `p`
+     */
+    template<typename Fn>
+    HashSet filter(Fn p) const
+    {
+        HashSet s(allocator());
+        s.trie_ = trie_.filter(std::move(p));
+        return s;
+    }
+
+    /**
+     * @brief Returns all elements of this set that violate a predicate.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test elements
+     * @return a new set consisting of all elements of this set that
+     *         violate the given predicate `p`
+     */
+    template<typename Fn>
+    HashSet filterNot(Fn p) const
+    {
+        return filter([&p](const A& x) { return !p(x); });
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for some element of this set.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return `true` if the given predicate `p` holds for some element of
+     *         this set, `false` otherwise
+     */
+    template<typename Fn>
+    bool exists(Fn p) const
+    {
+        return !trie_.foreachWhile([&p](const A& x) { return !p(x); });
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for all elements of this set.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return `true` if this set is empty or the given predicate `p`
+     *         holds for all elements of this set, `false` otherwise
+     */
+    template<typename Fn>
+    bool forall(Fn p) const
+    {
+        return trie_.foreachWhile([&p](const A& x) { return static_cast<bool>(p(x)); });
+    }
+
+    /**
+     * @brief Counts the number of elements in this set that satisfy
+     *        a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return the number of elements satisfying the given predicate `p`
+     */
+    template<typename Fn>
+    std::size_t count(Fn p) const
+    {
+        std::size_t n = 0;
+        foreach([&p, &n](const A& x) {
+            if (p(x)) {
+                ++n;
+            }
+        });
+        return n;
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this set, in the order `foreach()` visits them.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this set, with the start value `z` on the left, or `z` if
+     *         this set is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) const
+    {
+        foreach([&z, &op](const A& x) {
+            z = op(std::move(z), x);
+        });
+        return z;
+    }
+
+    /**
+     * @brief Compares this set with the given set for equality.
+     *
+     * @param that the set to be compared for equality with this set
+     * @return `true` if `that` has the same elements as this set,
+     *         `false` otherwise
+     */
+    bool operator==(const HashSet& that) const
+    {
+        if (size() != that.size()) {
+            return false;
+        } else if (trie_.same(that.trie_)) {
+            return true;
+        }
+        return forall([&that](const A& x) { return that.contains(x); });
+    }
+
+    /**
+     * @brief Compares this set with the given set for inequality.
+     *
+     * @param that the set to be compared for inequality with this set
+     * @return `true` if `that` does not have the same elements as this set,
+     *         `false` otherwise
+     */
+    bool operator!=(const HashSet& that) const
+    {
+        return !(*this == that);
+    }
+
+    /**
+     * @brief Swaps the contents of this set and `that`.
+     *
+     * @param that the set to swap contents with
+     */
+    void swap(HashSet& that) noexcept
+    {
+        trie_.swap(that.trie_);
+    }
+
+private:
+    template<typename, typename, typename, typename>
+    friend class HashSet;
+
+    struct KeyOf {
+        const A& operator()(const A& x) const
+        {
+            return x;
+        }
+    };
+
+    using Trie = HashTrie<A, KeyOf, Hash, KeyEqual, Alloc>;
+
+    Trie trie_;
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_HASH_SET_HPP
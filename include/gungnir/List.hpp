@@ -18,35 +18,93 @@
 #define GUNGNIR_LIST_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <new>
 #include <stdexcept>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "gungnir/HashMap.hpp"
+#include "gungnir/ListStats.hpp"
+#include "gungnir/List_fwd.hpp"
+#include "gungnir/Option.hpp"
+#include "gungnir/execution.hpp"
+#include "gungnir/reclaim.hpp"
+#include "gungnir/refcount.hpp"
+#include "gungnir/detail/probe.hpp"
+#include "gungnir/detail/sort.hpp"
+#include "gungnir/detail/trace.hpp"
 #include "gungnir/detail/util.hpp"
 
 namespace gungnir {
 
 using namespace detail;
 
+template<typename G>
+class ListView;
+
+namespace detail {
+
+namespace stage {
+
+template<typename A, typename Alloc>
+struct Source;
+
+}  // namespace stage
+
+// The distance between the nodes an `IndexedList` points to.
+constexpr std::size_t indexStride = 32;
+
+}  // namespace detail
+
 /**
  * @brief An immutable linked list.
  *
+ * The nodes are reference counted with the policy the allocator names as
+ * its member type `refcount_policy`, `AtomicRefCount` by default. Lists
+ * confined to a single thread can use `LocalRefCount`, e.g. through a
+ * `LocalAllocator`, to retain and release nodes without atomic operations;
+ * the overloads taking a `ParallelPolicy` then run sequentially.
+ * Likewise, the nodes are freed with the policy the allocator names as its
+ * member type `reclaim_policy`; `DeferredReclaim`, e.g. through a
+ * `DeferredAllocator`, frees most of a long list in the background when
+ * its last reference is dropped.
+ *
  * @author Zizheng Tai
  * @since 1.0
  * @tparam A the type of the elements; must be a non-reference type
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               this list, e.g., a per-thread pool or a monotonic arena
  */
-template<typename A>
-class List final {
+template<typename A, typename Alloc>
+class List final : private Compressed<Alloc> {
 public:
     /**
      * @brief Constructs an empty list.
      */
-    List() noexcept : size_(0), node_(Node::create()) {}
+    List() noexcept : List(Alloc()) {}
+
+    /**
+     * @brief Constructs an empty list whose nodes will be allocated
+     *        with `alloc`.
+     *
+     * @param alloc the allocator used by this list and the lists derived
+     *              from it
+     */
+    explicit List(const Alloc& alloc) noexcept
+        : Compressed<Alloc>(alloc)
+        , size_(0)
+        , node_(Node::create())
+    {}
 
     /**
      * @brief Constructs a list with the given element.
@@ -54,10 +112,9 @@ public:
      * @param x the only element of this list
      */
     explicit List(A x) noexcept
-        : size_(1)
-        , node_(Node::create(
-                    std::make_shared<const A>(std::move(x)),
-                    Node::create()))
+        : Compressed<Alloc>(Alloc())
+        , size_(1)
+        , node_(Node::emplace(allocator(), Node::create(), std::move(x)))
     {}
 
     /**
@@ -67,10 +124,9 @@ public:
      * @param tail all elements of this list except the first one
      */
     List(A head, List tail) noexcept
-        : size_(tail.size_ + 1)
-        , node_(Node::create(
-                    std::make_shared<const A>(std::move(head)),
-                    std::move(tail.node_)))
+        : Compressed<Alloc>(tail.allocator())
+        , size_(tail.size_ + 1)
+        , node_(Node::emplace(allocator(), std::move(tail.node_), std::move(head)))
     {}
 
     /**
@@ -87,15 +143,32 @@ public:
         >::type
     >
     List(A head, Args&&... tail) noexcept
-        : List(std::move(head), List(std::forward<Args>(tail)...))
+        : List(of(std::move(head), std::forward<Args>(tail)...))
+    {}
+
+    /**
+     * @brief Constructs a list with the elements of an initializer list.
+     *
+     * @param xs the elements of this list
+     * @param alloc the allocator used by this list and the lists derived
+     *              from it
+     */
+    List(std::initializer_list<A> xs, const Alloc& alloc = Alloc()) noexcept
+        : List(xs.begin(), xs.end(), alloc)
     {}
 
     /**
      * @brief Constructs a list with the contents of the range [`first`, `last`).
      *
+     * The range is traversed once, so it only needs to be single-pass, e.g.
+     * a range of `std::istream_iterator`s. To process a long input without
+     * holding all of it, use `Stream::from()` instead.
+     *
      * @tparam InputIt the type of the iterators
      * @param first the iterator pointing to the start of the range
      * @param last the iterator pointing to the end of the range
+     * @param alloc the allocator used by this list and the lists derived
+     *              from it
      */
     template<
         typename InputIt,
@@ -103,21 +176,55 @@ public:
             typename std::iterator_traits<InputIt>::value_type, A
         >::value>::type
     >
-    List(InputIt first, InputIt last) noexcept
-        : List([&first, &last] {
-            std::vector<Ptr<A>> buf;
-            buf.reserve(std::distance(first, last));
+    List(InputIt first, InputIt last, const Alloc& alloc = Alloc()) noexcept
+        : List([&first, &last, &alloc] {
+            Builder buf(alloc);
             for (; first != last; ++first) {
-                buf.emplace_back(std::make_shared<A>(*first));
+                buf.append(*first);
             }
-
-            return toList(
-                    buf.size(),
-                    std::make_move_iterator(buf.rbegin()),
-                    std::make_move_iterator(buf.rend()));
+            return buf.result();
         }())
     {}
 
+    /**
+     * @brief Returns a list whose elements are constructed in-place from
+     *        each of the given arguments, in order.
+     *
+     * The list is built in a single pass, without temporary lists or
+     * intermediate copies of the elements.
+     *
+     * @tparam Args the types of the arguments
+     * @param args the arguments each passed to the constructor of `A`
+     * @return a list whose elements are constructed in-place from `args`
+     */
+    template<typename... Args>
+    static List of(Args&&... args)
+    {
+        Builder buf;
+        using Expand = int[];
+        (void) Expand {0, (buf.append(std::forward<Args>(args)), 0)...};
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns a list of `n` elements, each constructed in-place from
+     *        the given arguments.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `A`
+     * @param n the number of elements
+     * @param args the arguments passed to the constructor of each element
+     * @return a list of `n` elements constructed in-place from `args`
+     */
+    template<typename... Args>
+    static List fill(std::size_t n, const Args&... args)
+    {
+        Builder buf;
+        for (; n > 0; --n) {
+            buf.append(args...);
+        }
+        return buf.result();
+    }
+
     /** @brief Default copy constructor. */
     List(const List&) = default;
 
@@ -130,6 +237,16 @@ public:
     /** @brief Default move assignment operator. */
     List& operator=(List&&) = default;
 
+    /**
+     * @brief Returns a copy of the allocator used by this list.
+     *
+     * @return a copy of the allocator used by this list
+     */
+    Alloc allocator() const
+    {
+        return this->get();
+    }
+
     /**
      * @brief Returns `true` if this list contains no elements, `false` otherwise.
      *
@@ -161,7 +278,7 @@ public:
         if (isEmpty()) {
             throw std::out_of_range("head of empty list");
         }
-        return *(node_->head);
+        return *node_->head();
     }
 
     /**
@@ -175,7 +292,8 @@ public:
         if (isEmpty()) {
             throw std::out_of_range("tail of empty list");
         }
-        return List(size() - 1, node_->tail);
+        Node::shareLast(node_.get());
+        return List(size() - 1, node_->tail, allocator());
     }
 
     /**
@@ -203,7 +321,7 @@ public:
         if (isEmpty()) {
             throw std::out_of_range("last of empty list");
         }
-        return (*this)[size() - 1];
+        return *Node::last(node_.get())->head();
     }
 
     /**
@@ -229,7 +347,7 @@ public:
     template<typename Fn>
     void foreach(Fn f) const
     {
-        foreachImpl([&f](const Ptr<A>& x) { f(*x); });
+        foreachImpl([&f](const Node* n) { f(*n->head()); });
     }
 
     /**
@@ -243,20 +361,83 @@ public:
      *         each element of this list
      */
     template<typename Fn, typename B = Decay<Ret<Fn, A>>>
-    List<B> map(Fn f) const
+    List<B, Rebind<Alloc, B>> map(Fn f) const&
     {
-        const auto ff = std::bind(std::move(f), std::placeholders::_1);
+        trace::Scope scope("List::map", size());
+        auto ys = mapCopy(std::bind(std::move(f), std::placeholders::_1));
+        scope.done(ys.size());
+        return ys;
+    }
 
-        std::vector<Ptr<B>> buf;
-        buf.reserve(size());
-        foreachImpl([&buf, &ff](const Ptr<A>& x) {
-            buf.emplace_back(std::make_shared<const B>(ff(*x)));
-        });
+    /**
+     * @brief Returns a new list resulting from applying a function to
+     *        each element of this list, reusing what it can of this list.
+     *
+     * Elements that this list alone holds are passed to `f` as rvalues, so
+     * they can be moved from. If `B` is `A` and can be move-assigned, the
+     * results replace them in place, so the leading nodes that no other
+     * list shares are reused instead of allocating new ones.
+     *
+     * @tparam Fn the type of the function to apply to each element of this list
+     * @tparam B the element type of returned list
+     * @param f the function to apply to each element of this list
+     * @return a new list resulting from applying the given function `f` to
+     *         each element of this list
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    List<B, Rebind<Alloc, B>> map(Fn f) &&
+    {
+        using InPlace = std::integral_constant<bool,
+            std::is_same<B, A>::value &&
+            std::is_same<Rebind<Alloc, B>, Alloc>::value &&
+            std::is_move_assignable<A>::value
+        >;
+        trace::Scope scope("List::map", size());
+        auto ys = std::move(*this).mapImpl(std::bind(std::move(f), std::placeholders::_1), InPlace());
+        scope.done(ys.size());
+        return ys;
+    }
+
+    /**
+     * @brief Returns a new list resulting from applying a function to
+     *        each element of this list, in parallel.
+     *
+     * The list is split into chunks that are mapped concurrently and then
+     * linked together in order, so the result is the same as `map(f)`.
+     *
+     * @tparam Fn the type of the function to apply to each element of this list
+     * @tparam B the element type of returned list
+     * @param policy the parallel execution policy
+     * @param f the function to apply to each element of this list; may be
+     *          called concurrently
+     * @return a new list resulting from applying the given function `f` to
+     *         each element of this list
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    List<B, Rebind<Alloc, B>> map(const ParallelPolicy& policy, Fn f) const
+    {
+        const auto runs = chunks(policy);
+        if (runs.size() <= 1) {
+            return map(std::move(f));
+        }
 
-        return List<B>::toList(
-                size(),
-                std::make_move_iterator(buf.rbegin()),
-                std::make_move_iterator(buf.rend()));
+        trace::Scope scope("List::map/par", size());
+        const Rebind<Alloc, B> alloc(allocator());
+        std::vector<ListBuilder<B, Rebind<Alloc, B>>> bufs;
+        bufs.reserve(runs.size());
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            bufs.emplace_back(alloc);
+        }
+        policy.executor().parallelFor(runs.size(), [&](std::size_t i) {
+            auto& buf = bufs[i];
+            auto n = runs[i].first;
+            for (auto k = runs[i].second; k > 0; --k, n = n->tail.get()) {
+                buf.append(f(*n->head()));
+            }
+        });
+        auto ys = stitch(bufs);
+        scope.done(ys.size());
+        return ys;
     }
 
     /**
@@ -270,19 +451,83 @@ public:
      *         the given predicate `p`
      */
     template<typename Fn>
-    List filter(Fn p) const
+    List filter(Fn p) const&
     {
-        std::vector<Ptr<A>> buf;
-        foreachImpl([&p, &buf](const Ptr<A>& x) {
-            if (p(*x)) {
-                buf.emplace_back(x);
+        Builder buf(allocator());
+        foreachImpl([&p, &buf](const Node* n) {
+            if (p(*n->head())) {
+                buf.share(n);
             }
         });
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns all elements of this list that satisfy a predicate,
+     *        reusing what it can of this list.
+     *
+     * The order of the elements is preserved. The leading nodes of this list
+     * that no other list shares are relinked in place rather than copied.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test elements
+     * @return a new list consisting of all elements of this list that satisfy
+     *         the given predicate `p`
+     */
+    template<typename Fn>
+    List filter(Fn p) &&
+    {
+        Builder buf(allocator());
+        auto rest = std::move(node_);
+        auto size = size_;
+        for (; rest->head() && Node::unique(rest.get()); --size) {
+            auto next = Node::unlink(rest.get());
+            if (p(*rest->head())) {
+                buf.link(std::move(rest));
+            }
+            rest = std::move(next);
+        }
+
+        const List xs(size, std::move(rest), allocator());
+        const auto ys = xs.filter(std::move(p));
+        return buf.result(ys.node_, ys.size());
+    }
+
+    /**
+     * @brief Returns all elements of this list that satisfy a predicate,
+     *        testing them in parallel.
+     *
+     * The order of the elements is preserved.
+     *
+     * @tparam Fn type of the predicate
+     * @param policy the parallel execution policy
+     * @param p the predicate used to test elements; may be called concurrently
+     * @return a new list consisting of all elements of this list that satisfy
+     *         the given predicate `p`
+     */
+    template<typename Fn>
+    List filter(const ParallelPolicy& policy, Fn p) const
+    {
+        const auto runs = chunks(policy);
+        if (runs.size() <= 1) {
+            return filter(std::move(p));
+        }
 
-        return toList(
-                buf.size(),
-                std::make_move_iterator(buf.rbegin()),
-                std::make_move_iterator(buf.rend()));
+        std::vector<Builder> bufs;
+        bufs.reserve(runs.size());
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            bufs.emplace_back(allocator());
+        }
+        policy.executor().parallelFor(runs.size(), [&](std::size_t i) {
+            auto& buf = bufs[i];
+            auto n = runs[i].first;
+            for (auto k = runs[i].second; k > 0; --k, n = n->tail.get()) {
+                if (p(*n->head())) {
+                    buf.share(n);
+                }
+            }
+        });
+        return stitch(bufs);
     }
 
     /**
@@ -306,13 +551,38 @@ public:
      *
      * @return a new list with elements of this list in reversed order
      */
-    List reverse() const
+    List reverse() const&
     {
         auto hd = Node::create();
-        foreachImpl([&hd](const Ptr<A>& x) {
-            hd = Node::create(x, std::move(hd));
+        foreachImpl([&hd](const Node* n) {
+            hd = Node::create(n, std::move(hd));
         });
-        return List(size(), std::move(hd));
+        return List(size(), std::move(hd), allocator());
+    }
+
+    /**
+     * @brief Returns a new list with elements of this list in reversed order,
+     *        reusing what it can of this list.
+     *
+     * The leading nodes of this list that no other list shares are relinked
+     * in place rather than copied.
+     *
+     * @return a new list with elements of this list in reversed order
+     */
+    List reverse() &&
+    {
+        auto hd = Node::create();
+        auto rest = std::move(node_);
+        while (rest->head() && Node::unique(rest.get())) {
+            auto next = Node::unlink(rest.get());
+            Node::link(rest.get(), std::move(hd));
+            hd = std::move(rest);
+            rest = std::move(next);
+        }
+        for (auto n = rest.get(); n->head(); n = n->tail.get()) {
+            hd = Node::create(n, std::move(hd));
+        }
+        return List(size(), std::move(hd), allocator());
     }
 
     /**
@@ -322,19 +592,50 @@ public:
      * @return a list consisting of the first `n` elements of this list,
      *         or the whole list if `n > size()`
      */
-    List take(std::size_t n) const
+    List take(std::size_t n) const&
     {
-        n = std::min(n, size());
+        if (n >= size()) {
+            return *this;
+        }
 
-        std::vector<Ptr<A>> buf;
+        Builder buf(allocator());
         for (auto nd = node_.get(); n > 0; nd = nd->tail.get(), --n) {
-            buf.emplace_back(nd->head);
+            buf.share(nd);
+        }
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns the first `n` elements of this list, reusing what it can
+     *        of this list.
+     *
+     * If the first `n` nodes of this list are shared with no other list,
+     * the rest of the list is cut off instead of copying them.
+     *
+     * @param n the number of elements to take
+     * @return a list consisting of the first `n` elements of this list,
+     *         or the whole list if `n > size()`
+     */
+    List take(std::size_t n) &&
+    {
+        if (n >= size()) {
+            return std::move(*this);
+        } else if (n == 0) {
+            return List(allocator());
+        }
+
+        Builder buf(allocator());
+        auto rest = std::move(node_);
+        auto k = n;
+        for (; k > 0 && Node::unique(rest.get()); --k) {
+            auto next = Node::unlink(rest.get());
+            buf.link(std::move(rest));
+            rest = std::move(next);
         }
 
-        return toList(
-                buf.size(),
-                std::make_move_iterator(buf.rbegin()),
-                std::make_move_iterator(buf.rend()));
+        const List xs(size() - (n - k), std::move(rest), allocator());
+        const auto ys = xs.take(k);
+        return buf.result(ys.node_, ys.size());
     }
 
     /**
@@ -361,17 +662,13 @@ public:
     template<typename Fn>
     List takeWhile(Fn p) const
     {
-        std::vector<Ptr<A>> buf;
+        Builder buf(allocator());
         for (auto n = node_.get();
-                n->head && p(*(n->head));
+                n->head() && p(*n->head());
                 n = n->tail.get()) {
-            buf.emplace_back(n->head);
+            buf.share(n);
         }
-
-        return toList(
-                buf.size(),
-                std::make_move_iterator(buf.rbegin()),
-                std::make_move_iterator(buf.rend()));
+        return buf.result();
     }
 
     /**
@@ -384,11 +681,11 @@ public:
     List drop(std::size_t n) const
     {
         if (n >= size()) {
-            return List();
+            return List(allocator());
         }
         auto pn = &node_;
         for (std::size_t i = 0; i < n; pn = &(*pn)->tail, ++i) {}
-        return List(size() - n, *pn);
+        return List(size() - n, *pn, allocator());
     }
 
     /**
@@ -417,8 +714,8 @@ public:
     {
         auto s = size();
         auto pn = &node_;
-        for (; (*pn)->head && p(*((*pn)->head)); --s, pn = &(*pn)->tail) {}
-        return List(s, *pn);
+        for (; (*pn)->head() && p(*(*pn)->head()); --s, pn = &(*pn)->tail) {}
+        return List(s, *pn, allocator());
     }
 
     /**
@@ -436,236 +733,582 @@ public:
     List slice(std::size_t from, std::size_t until) const
     {
         if (from >= until) {
-            return List();
+            return List(allocator());
         }
         return drop(from).take(until - from);
     }
 
     /**
-     * @brief Returns a list resulting from applying the given function `f`
-     *        to each element of this list and concatenating the results.
+     * @brief Returns the elements of this list without duplicates.
      *
-     * @tparam Fn the type of the function to apply to each element of this list
-     * @tparam B the element type of the returned list
-     * @return a list resulting from applying the given function `f` to each
-     *         element of this list and concatenating the results
-     */
-    template<typename Fn, typename B = Decay<typename HKT<Ret<Fn, A>>::L>>
-    List<B> flatMap(Fn f) const
-    {
-        std::vector<Ptr<B>> buf;
-        foreachImpl([&f, &buf](const Ptr<A>& x) {
-            f(*x).foreachImpl([&buf](const Ptr<B>& y) {
-                buf.emplace_back(y);
-            });
-        });
-
-        return List<B>::toList(
-                buf.size(),
-                std::make_move_iterator(buf.rbegin()),
-                std::make_move_iterator(buf.rend()));
-    }
-
-    /**
-     * @brief Returns a list resulting from concatenating all element lists
-     *        of this list.
+     * Of equal elements, only the first one is kept. Membership is tested
+     * with a hash set of the elements, so this takes O(n) expected time;
+     * `A` must be hashable with `std::hash<A>`.
      *
-     * @tparam A1 the same as A, used to make SFINAE work
-     * @tparam B the element type of the returned list
-     * @return a list resulting from concatenating all element lists of this list.
+     * @return a list of the distinct elements of this list, in the order
+     *         of their first occurrences
      */
-    template<typename A1 = A, typename B = typename HKT<A1>::L>
-    List<B> flatten() const
+    List distinct() const
     {
-        std::vector<Ptr<B>> buf;
-        foreachImpl([&buf](const Ptr<List<B>>& ys) {
-            ys->foreachImpl([&buf](const Ptr<B>& y) {
-                buf.emplace_back(y);
-            });
-        });
-
-        return List<B>::toList(
-                buf.size(),
-                std::make_move_iterator(buf.rbegin()),
-                std::make_move_iterator(buf.rend()));
+        ProbeSet<A> seen(size());
+        stats::onBuffer(seen.bytes());
+        return filter([&seen](const A& x) { return seen.insert(&x); });
     }
 
     /**
-     * @brief Returns `true` if at least one element of this list satisfy
-     *        the given predicate, `false` otherwise.
+     * @brief Returns the elements of this list without those whose keys
+     *        are duplicates.
      *
-     * @tparam Fn the type of the predicate
-     * @param p the predicate
-     * @return `true` if at least one element of this list satisfy the given
-     *         predicate, `false` otherwise
+     * Of elements with equal keys, only the first one is kept. Each key is
+     * computed once; the keys must be hashable with `std::hash<K>`.
+     *
+     * @tparam Fn the type of the key function
+     * @tparam K the type of the keys
+     * @param key the function computing the key of each element
+     * @return a list of the elements of this list whose keys occur first,
+     *         in order
      */
-    template<typename Fn>
-    bool exists(Fn p) const
+    template<typename Fn, typename K = Decay<Ret<Fn, const A&>>>
+    List distinctBy(Fn key) const
     {
-        for (auto n = node_.get(); n->head; n = n->tail.get()) {
-            if (p(*(n->head))) {
+        // The keys are never reallocated, so that the set can point to them.
+        std::vector<K> keys;
+        keys.reserve(size());
+        ProbeSet<K> seen(size());
+        stats::onBuffer(keys.capacity() * sizeof (K) + seen.bytes());
+        return filter([&key, &keys, &seen](const A& x) {
+            keys.push_back(key(x));
+            if (seen.insert(&keys.back())) {
                 return true;
             }
-        }
-        return false;
+            keys.pop_back();
+            return false;
+        });
     }
 
     /**
-     * @brief Returns `true` if this list is empty or the given predicate
-     *        holds for all elements of this list, `false` otherwise.
+     * @brief Returns the elements of this list that also occur in `that`.
      *
-     * @tparam Fn the type of the predicate
-     * @param p the predicate
-     * @return `true` if this list is empty or the given predicate holds for
-     *         all elements of this list, `false` otherwise
+     * Membership is tested with a hash set of the elements of `that`, so
+     * this takes O(n + m) expected time; `A` must be hashable with
+     * `std::hash<A>`.
+     *
+     * @param that the list whose elements to keep
+     * @return a list of the elements of this list equal to some element of
+     *         `that`, in order and including duplicates
      */
-    template<typename Fn>
-    bool forall(Fn p) const
+    List intersect(const List& that) const
     {
-        for (auto n = node_.get(); n->head; n = n->tail.get()) {
-            if (!p(*(n->head))) {
-                return false;
-            }
-        }
-        return true;
+        const auto set = that.probeSet();
+        return filter([&set](const A& x) { return set.contains(x); });
     }
 
     /**
-     * @brief Returns `true` if this list has an element that is equal
-     *        (as determined by `==`) to `x`, `false` otherwise.
+     * @brief Returns the elements of this list that do not occur in `that`.
      *
-     * @param x the object to test against
-     * @return `true` if this list has an element that is equal
-     *         (as determined by `==`) to `x`, `false` otherwise
+     * Membership is tested with a hash set of the elements of `that`, so
+     * this takes O(n + m) expected time; `A` must be hashable with
+     * `std::hash<A>`.
+     *
+     * @param that the list whose elements to remove
+     * @return a list of the elements of this list not equal to any element
+     *         of `that`, in order and including duplicates
      */
-    bool contains(const A& x) const
+    List diff(const List& that) const
     {
-        for (auto n = node_.get(); n->head; n = n->tail.get()) {
-            if (*(n->head) == x) {
-                return true;
-            }
-        }
-        return false;
+        const auto set = that.probeSet();
+        return filter([&set](const A& x) { return !set.contains(x); });
     }
 
     /**
-     * @brief Returns the number of elements of this list that are equal
-     *        (as determined by `==`) to `x`.
+     * @brief Splits this list into the elements that satisfy a predicate
+     *        and the ones that do not, in a single pass.
      *
-     * @param x the object to test against
-     * @return the number of elements of this list that are equal
-     *         (as determined by `==`) to `x`
+     * The order of the elements is preserved, and the returned lists share
+     * the elements of this list.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test elements
+     * @return a pair of the list of all elements of this list that satisfy
+     *         `p` and the list of all that do not
      */
-    std::size_t count(const A& x) const
+    template<typename Fn>
+    std::pair<List, List> partition(Fn p) const
     {
-        std::size_t num = 0;
-        foreachImpl([&x, &num](const Ptr<A>& y) {
-            if (*y == x) {
-                ++num;
-            }
+        Builder yes(allocator());
+        Builder no(allocator());
+        foreachImpl([&p, &yes, &no](const Node* n) {
+            (p(*n->head()) ? yes : no).share(n);
         });
-        return num;
+        return std::make_pair(yes.result(), no.result());
     }
 
     /**
-     * @brief Returns the number of elements of this list that satisfy
-     *        the given predicate.
+     * @brief Splits this list into its longest prefix whose elements satisfy
+     *        a predicate and the rest, in a single pass.
      *
-     * @tparam Fn the type of the predicate
+     * Equivalent to `std::make_pair(takeWhile(p), dropWhile(p))`, but `p` is
+     * applied only once per element, and the rest shares the nodes of this
+     * list.
+     *
+     * @tparam Fn type of the predicate
      * @param p the predicate
-     * @return the number of elements of this list that satisfy
-     *         the given predicate
+     * @return a pair of the longest prefix of this list whose elements
+     *         satisfy `p` and the remaining elements
      */
     template<typename Fn>
-    std::size_t count(Fn p) const
+    std::pair<List, List> span(Fn p) const
     {
-        std::size_t num = 0;
-        foreachImpl([&p, &num](const Ptr<A>& y) {
-            if (p(*y)) {
-                ++num;
-            }
-        });
-        return num;
+        Builder buf(allocator());
+        auto pn = &node_;
+        for (; (*pn)->head() && p(*(*pn)->head()); pn = &(*pn)->tail) {
+            buf.share(pn->get());
+        }
+        const auto k = buf.size();
+        return std::make_pair(buf.result(), List(size() - k, *pn, allocator()));
     }
 
     /**
-     * @brief Returns a list whose head is constructed in-place from `args`,
-     *        and tail is this list.
+     * @brief Splits this list at a position, in a single pass.
      *
-     * @tparam Args the types of the arguments passed to the constructor of `A`
-     * @param args the arguments passed to the constructor of `A`
-     * @return a list whose head is constructed in-place from `args`,
-     *         and tail is this list
+     * Equivalent to `std::make_pair(take(n), drop(n))`; the second list
+     * shares the nodes of this list.
+     *
+     * @param n the position to split at
+     * @return a pair of the first `n` elements of this list, or the whole
+     *         list if `n > size()`, and the remaining elements
      */
-    template<typename... Args>
-    List prepend(Args&&... args) const
+    std::pair<List, List> splitAt(std::size_t n) const
     {
-        return List(
-                size() + 1,
-                Node::create(
-                    std::make_shared<A>(std::forward<Args>(args)...),
-                    node_));
+        if (n >= size()) {
+            return std::make_pair(*this, List(allocator()));
+        }
+        Builder buf(allocator());
+        auto pn = &node_;
+        for (std::size_t i = 0; i < n; pn = &(*pn)->tail, ++i) {
+            buf.share(pn->get());
+        }
+        return std::make_pair(buf.result(), List(size() - n, *pn, allocator()));
     }
 
     /**
-     * @brief Returns a list resulting from concatenating this list and `that`.
+     * @brief Groups the elements of this list by a key, in a single pass.
      *
-     * @param that the list whose elements follow those of this list
-     *             in the returned list
-     * @return a list resulting from concatenating this list and `that`
+     * The elements of each group keep their order in this list, and are
+     * shared with it.
+     *
+     * @tparam Fn the type of the key function
+     * @tparam K the type of the keys, which must be hashable with
+     *           `std::hash<K>`
+     * @param key the function computing the key of each element
+     * @return a map associating each key with the list of all elements of
+     *         this list with that key
      */
-    List concat(const List& that) const
+    template<typename Fn, typename K = Decay<Ret<Fn, const A&>>>
+    HashMap<K, List> groupBy(Fn key) const
     {
-        if (isEmpty()) {
-            return that;
-        } else if (that.isEmpty()) {
-            return *this;
-        }
-
-        std::vector<Ptr<A>> buf;
-        buf.reserve(size());
-        foreachImpl([&buf](const Ptr<A>& x) {
-            buf.emplace_back(x);
+        std::unordered_map<K, Builder> groups;
+        foreachImpl([this, &key, &groups](const Node* n) {
+            auto k = key(*n->head());
+            auto it = groups.find(k);
+            if (it == groups.end()) {
+                it = groups.emplace(std::piecewise_construct,
+                                    std::forward_as_tuple(std::move(k)),
+                                    std::forward_as_tuple(allocator())).first;
+            }
+            it->second.share(n);
         });
 
-        return toList(
-                size() + that.size(),
-                std::make_move_iterator(buf.rbegin()),
-                std::make_move_iterator(buf.rend()),
-                that.node_);
+        TransientHashMap<K, List> m;
+        for (auto& g : groups) {
+            m.update(g.first, g.second.result());
+        }
+        return m.persistent();
     }
 
     /**
-     * @brief Returns a copy of this list with one single replaced element.
+     * @brief Returns a list resulting from applying the given function `f`
+     *        to each element of this list and concatenating the results.
      *
-     * @tparam Args the types of the argument passed to the constructor of `A`
-     * @param index the position of the replacement
-     * @param args the argument passed to the constructor of `A`
-     * @return a copy of this list with the element at position `index`
+     * The returned list uses the allocator of the list returned by `f` for
+     * the first element of this list.
+     *
+     * @tparam Fn the type of the function to apply to each element of this list
+     * @tparam L the type of the list returned by `f`
+     * @return a list resulting from applying the given function `f` to each
+     *         element of this list and concatenating the results
+     */
+    template<
+        typename Fn,
+        typename L = Decay<Ret<Fn, A>>,
+        typename = typename HKT<L>::L
+    >
+    L flatMap(Fn f) const
+    {
+        auto n = node_.get();
+        if (!n->head()) {
+            return L();
+        }
+
+        trace::Scope scope("List::flatMap", size());
+        L ys = f(*n->head());
+        typename L::Builder buf(ys.allocator());
+        for (;;) {
+            buf.appendAll(ys);
+            n = n->tail.get();
+            if (!n->head()) {
+                break;
+            }
+            ys = f(*n->head());
+        }
+        auto zs = buf.result();
+        scope.done(zs.size());
+        return zs;
+    }
+
+    /**
+     * @brief Returns a list resulting from concatenating all element lists
+     *        of this list.
+     *
+     * The returned list uses the allocator of the first element list.
+     *
+     * @tparam A1 the same as A, used to make SFINAE work
+     * @return a list resulting from concatenating all element lists of this list.
+     */
+    template<typename A1 = A, typename = typename HKT<A1>::L>
+    A1 flatten() const
+    {
+        if (isEmpty()) {
+            return A1();
+        }
+
+        typename A1::Builder buf(head().allocator());
+        foreachImpl([&buf](const Node* n) {
+            buf.appendAll(*n->head());
+        });
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns the list of the values of the options in this list,
+     *        if none of them is empty.
+     *
+     * Stops at the first empty option. The values are copied into the
+     * returned list, which is built in a single forward pass.
+     *
+     * @tparam A1 the same as A, used to make SFINAE work
+     * @tparam B the value type of the options in this list
+     * @return the list of the values of the options in this list, or an
+     *         empty option if any of them is empty
+     */
+    template<
+        typename A1 = A,
+        typename B = typename HKT<A1>::L,
+        typename = typename std::enable_if<std::is_same<A1, Option<B>>::value>::type
+    >
+    Option<List<B, Rebind<Alloc, B>>> sequence() const
+    {
+        const Rebind<Alloc, B> alloc(allocator());
+        ListBuilder<B, Rebind<Alloc, B>> buf(alloc);
+        for (auto n = node_.get(); n->head(); n = n->tail.get()) {
+            const A1& opt = *n->head();
+            if (opt.isEmpty()) {
+                return Option<List<B, Rebind<Alloc, B>>>();
+            }
+            buf.append(opt.get());
+        }
+        return Option<List<B, Rebind<Alloc, B>>>(buf.result());
+    }
+
+    /**
+     * @brief Returns the list of the values of the options returned by
+     *        a function applied to each element of this list, if none of
+     *        them is empty.
+     *
+     * Stops at the first empty option, without applying `f` to the
+     * remaining elements. The values are moved into the returned list,
+     * which is built in a single forward pass.
+     *
+     * @tparam Fn the type of the function to apply to each element of this list
+     * @tparam Opt the type of the option returned by `f`
+     * @tparam B the value type of `Opt`
+     * @param f the function to apply to each element of this list
+     * @return the list of the values of the options returned by `f`, or an
+     *         empty option if any of them is empty
+     */
+    template<
+        typename Fn,
+        typename Opt = Decay<Ret<Fn, A>>,
+        typename B = typename HKT<Opt>::L,
+        typename = typename std::enable_if<std::is_same<Opt, Option<B>>::value>::type
+    >
+    Option<List<B, Rebind<Alloc, B>>> traverse(Fn f) const
+    {
+        const Rebind<Alloc, B> alloc(allocator());
+        ListBuilder<B, Rebind<Alloc, B>> buf(alloc);
+        for (auto n = node_.get(); n->head(); n = n->tail.get()) {
+            auto opt = f(*n->head());
+            if (opt.isEmpty()) {
+                return Option<List<B, Rebind<Alloc, B>>>();
+            }
+            buf.append(std::move(opt.get()));
+        }
+        return Option<List<B, Rebind<Alloc, B>>>(buf.result());
+    }
+
+    /**
+     * @brief Returns the list of the values of the non-empty options
+     *        returned by a function applied to each element of this list.
+     *
+     * @tparam Fn the type of the function to apply to each element of this list
+     * @tparam Opt the type of the option returned by `f`
+     * @tparam B the value type of `Opt`
+     * @param f the function to apply to each element of this list
+     * @return the list of the values of the non-empty options returned by `f`
+     */
+    template<
+        typename Fn,
+        typename Opt = Decay<Ret<Fn, A>>,
+        typename B = typename HKT<Opt>::L,
+        typename = typename std::enable_if<std::is_same<Opt, Option<B>>::value>::type
+    >
+    List<B, Rebind<Alloc, B>> flatMapOption(Fn f) const
+    {
+        const Rebind<Alloc, B> alloc(allocator());
+        ListBuilder<B, Rebind<Alloc, B>> buf(alloc);
+        foreachImpl([&buf, &f](const Node* n) {
+            auto opt = f(*n->head());
+            if (!opt.isEmpty()) {
+                buf.append(std::move(opt.get()));
+            }
+        });
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns `true` if at least one element of this list satisfy
+     *        the given predicate, `false` otherwise.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return `true` if at least one element of this list satisfy the given
+     *         predicate, `false` otherwise
+     */
+    template<typename Fn>
+    bool exists(Fn p) const
+    {
+        for (auto n = node_.get(); n->head(); n = n->tail.get()) {
+            if (p(*n->head())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns `true` if this list is empty or the given predicate
+     *        holds for all elements of this list, `false` otherwise.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return `true` if this list is empty or the given predicate holds for
+     *         all elements of this list, `false` otherwise
+     */
+    template<typename Fn>
+    bool forall(Fn p) const
+    {
+        for (auto n = node_.get(); n->head(); n = n->tail.get()) {
+            if (!p(*n->head())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Returns `true` if this list has an element that is equal
+     *        (as determined by `==`) to `x`, `false` otherwise.
+     *
+     * @param x the object to test against
+     * @return `true` if this list has an element that is equal
+     *         (as determined by `==`) to `x`, `false` otherwise
+     */
+    bool contains(const A& x) const
+    {
+        for (auto n = node_.get(); n->head(); n = n->tail.get()) {
+            if (*n->head() == x) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the number of elements of this list that are equal
+     *        (as determined by `==`) to `x`.
+     *
+     * @param x the object to test against
+     * @return the number of elements of this list that are equal
+     *         (as determined by `==`) to `x`
+     */
+    std::size_t count(const A& x) const
+    {
+        std::size_t num = 0;
+        foreachImpl([&x, &num](const Node* n) {
+            if (*n->head() == x) {
+                ++num;
+            }
+        });
+        return num;
+    }
+
+    /**
+     * @brief Returns the number of elements of this list that satisfy
+     *        the given predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return the number of elements of this list that satisfy
+     *         the given predicate
+     */
+    template<typename Fn>
+    std::size_t count(Fn p) const
+    {
+        std::size_t num = 0;
+        foreachImpl([&p, &num](const Node* n) {
+            if (p(*n->head())) {
+                ++num;
+            }
+        });
+        return num;
+    }
+
+    /**
+     * @brief Returns a list whose head is constructed in-place from `args`,
+     *        and tail is this list.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `A`
+     * @param args the arguments passed to the constructor of `A`
+     * @return a list whose head is constructed in-place from `args`,
+     *         and tail is this list
+     */
+    template<typename... Args>
+    List prepend(Args&&... args) const
+    {
+        return List(
+                size() + 1,
+                Node::emplace(allocator(), node_, std::forward<Args>(args)...),
+                allocator());
+    }
+
+    /**
+     * @brief Returns a list resulting from concatenating this list and `that`.
+     *
+     * @param that the list whose elements follow those of this list
+     *             in the returned list
+     * @return a list resulting from concatenating this list and `that`
+     */
+    List concat(const List& that) const&
+    {
+        if (isEmpty()) {
+            return that;
+        } else if (that.isEmpty()) {
+            return *this;
+        }
+
+        Builder buf(allocator());
+        buf.appendAll(*this);
+        return buf.result(that.node_, that.size());
+    }
+
+    /**
+     * @brief Returns a list resulting from concatenating this list and `that`.
+     *
+     * If no node of this list is shared with any other list, `that` is
+     * linked directly behind the last node instead of copying this list.
+     *
+     * @param that the list whose elements follow those of this list
+     *             in the returned list
+     * @return a list resulting from concatenating this list and `that`
+     */
+    List concat(const List& that) &&
+    {
+        if (isEmpty()) {
+            return that;
+        } else if (that.isEmpty()) {
+            return std::move(*this);
+        }
+
+        // `that` aliasing this list is the only way for it to point into a
+        // uniquely referenced chain; splicing then would create a cycle.
+        if (&that != this && Node::splice(node_.get(), that.node_)) {
+            return List(size() + that.size(), std::move(node_), allocator());
+        }
+        return static_cast<const List&>(*this).concat(that);
+    }
+
+    /**
+     * @brief Returns a copy of this list with one single replaced element.
+     *
+     * @tparam Args the types of the argument passed to the constructor of `A`
+     * @param index the position of the replacement
+     * @param args the argument passed to the constructor of `A`
+     * @return a copy of this list with the element at position `index`
      *         replaced by a new element constructed in-place from `args`
      * @throws std::out_of_range if `index >= size()`
      */
     template<typename... Args>
-    List updated(std::size_t index, Args&&... args) const
+    List updated(std::size_t index, Args&&... args) const&
     {
         if (index >= size()) {
             throw std::out_of_range("index out of range");
         }
 
-        std::vector<Ptr<A>> buf;
-        buf.reserve(index);
+        Builder buf(allocator());
         auto n = node_.get();
-        for (; index > 0; n = n->tail.get(), --index) {
-            buf.emplace_back(n->head);
+        for (auto i = index; i > 0; n = n->tail.get(), --i) {
+            buf.share(n);
+        }
+        buf.append(std::forward<Args>(args)...);
+        return buf.result(n->tail, size() - index - 1);
+    }
+
+    /**
+     * @brief Returns a copy of this list with one single replaced element,
+     *        reusing what it can of this list.
+     *
+     * If the first `index + 1` nodes of this list are shared with no other
+     * list, the element is replaced in place instead of copying them.
+     *
+     * @tparam Args the types of the argument passed to the constructor of `A`
+     * @param index the position of the replacement
+     * @param args the argument passed to the constructor of `A`
+     * @return a copy of this list with the element at position `index`
+     *         replaced by a new element constructed in-place from `args`
+     * @throws std::out_of_range if `index >= size()`
+     */
+    template<typename... Args>
+    List updated(std::size_t index, Args&&... args) &&
+    {
+        if (index >= size()) {
+            throw std::out_of_range("index out of range");
         }
 
-        return toList(
-                size(),
-                std::make_move_iterator(buf.rbegin()),
-                std::make_move_iterator(buf.rend()),
-                Node::create(
-                    std::make_shared<A>(std::forward<Args>(args)...),
-                    n->tail));
+        // Forgetting the cached values of the nodes before the element
+        // is harmless even if one of them turns out to be shared.
+        auto n = node_.get();
+        auto i = index;
+        for (; i > 0 && Node::unique(n); --i) {
+            Node::forget(n);
+            n = n->tail.get();
+        }
+        if (i == 0 && Node::owns(n)) {
+            Node::forget(n);
+            if (assign(std::is_move_assignable<A>(), Node::value(n), std::forward<Args>(args)...)) {
+                return std::move(*this);
+            }
+        }
+        return static_cast<const List&>(*this).updated(index, std::forward<Args>(args)...);
     }
 
     /**
@@ -712,12 +1355,62 @@ public:
     template<typename B, typename Fn>
     B foldLeft(B z, Fn op) const
     {
-        foreachImpl([&z, &op](const Ptr<A>& x) {
-            z = op(std::move(z), *x);
+        foreachImpl([&z, &op](const Node* n) {
+            z = op(std::move(z), *n->head());
         });
         return z;
     }
 
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this list in parallel, combining partial results left to right.
+     *
+     * Each chunk of the list is folded left starting from a copy of `z`,
+     * and the partial results are then merged in order with `combine`. The
+     * result equals `foldLeft(z, op)` if `z` is an identity of `combine` and
+     * `combine(b, foldLeft(z, op) over ys) == foldLeft(b, op) over ys`,
+     * as for `0` with `+`.
+     *
+     * @tparam B the result type of the binary operators
+     * @tparam Fn the type of the binary operator folding elements
+     * @tparam Combine the type of the binary operator merging partial results
+     * @param policy the parallel execution policy
+     * @param z the start value of each chunk
+     * @param op the binary operator folding elements; may be called
+     *           concurrently
+     * @param combine the binary operator merging partial results
+     * @return the result of folding all elements of this list, or `z` if
+     *         this list is empty
+     */
+    template<typename B, typename Fn, typename Combine>
+    B foldLeft(const ParallelPolicy& policy, B z, Fn op, Combine combine) const
+    {
+        const auto runs = chunks(policy);
+        if (runs.size() <= 1) {
+            return foldLeft(std::move(z), std::move(op));
+        }
+
+        // Each partial result gets a slot of its own, which `std::vector<B>`
+        // would not give to `bool`s.
+        struct Slot {
+            B value;
+        };
+        std::vector<Slot> partials(runs.size(), Slot{z});
+        policy.executor().parallelFor(runs.size(), [&](std::size_t i) {
+            auto& acc = partials[i].value;
+            auto n = runs[i].first;
+            for (auto k = runs[i].second; k > 0; --k, n = n->tail.get()) {
+                acc = op(std::move(acc), *n->head());
+            }
+        });
+
+        auto acc = std::move(partials.front().value);
+        for (std::size_t i = 1; i < partials.size(); ++i) {
+            acc = combine(std::move(acc), std::move(partials[i].value));
+        }
+        return acc;
+    }
+
     /**
      * @brief Applies a binary operator to a start value and all elements of
      *        this list, going right to left.
@@ -733,15 +1426,9 @@ public:
     template<typename B, typename Fn>
     B foldRight(B z, Fn op) const
     {
-        std::vector<const A*> buf;
-        buf.reserve(size());
-        foreachImpl([&buf](const Ptr<A>& x) {
-            buf.emplace_back(&*x);
+        foreachRightImpl([&z, &op](const Node* n) {
+            z = op(*n->head(), std::move(z));
         });
-
-        for (auto it = buf.crbegin(); it != buf.crend(); ++it) {
-            z = op(**it, std::move(z));
-        }
         return z;
     }
 
@@ -754,8 +1441,8 @@ public:
     A sum() const
     {
         A acc = 0;
-        foreachImpl([&acc](const Ptr<A>& x) {
-            acc += *x;
+        foreachImpl([&acc](const Node* n) {
+            acc += *n->head();
         });
         return acc;
     }
@@ -770,8 +1457,8 @@ public:
     A product() const
     {
         A acc = 1;
-        foreachImpl([&acc](const Ptr<A>& x) {
-            acc *= *x;
+        foreachImpl([&acc](const Node* n) {
+            acc *= *n->head();
         });
         return acc;
     }
@@ -809,14 +1496,16 @@ public:
     template<typename Fn>
     List sorted(Fn lt, bool stable = false) const
     {
-        std::vector<Ptr<A>> buf;
+        trace::Scope scope("List::sorted", size());
+        std::vector<const Node*> buf;
         buf.reserve(size());
-        foreachImpl([&buf](const Ptr<A>& x) {
-            buf.emplace_back(x);
+        stats::onBuffer(buf.capacity() * sizeof (const Node*));
+        foreachImpl([&buf](const Node* n) {
+            buf.emplace_back(n);
         });
 
-        auto comp = [&lt](const Ptr<A>& x, const Ptr<A>& y) {
-            return lt(*x, *y);
+        auto comp = [&lt](const Node* x, const Node* y) {
+            return lt(*x->head(), *y->head());
         };
         if (stable) {
             std::stable_sort(buf.begin(), buf.end(), comp);
@@ -824,20 +1513,186 @@ public:
             std::sort(buf.begin(), buf.end(), comp);
         }
 
-        return toList(
-                size(),
-                std::make_move_iterator(buf.rbegin()),
-                std::make_move_iterator(buf.rend()));
+        Builder ys(allocator());
+        for (const auto n : buf) {
+            ys.share(n);
+        }
+        auto zs = ys.result();
+        scope.done(zs.size());
+        return zs;
     }
 
     /**
-     * @brief Returns a list resulting from wrapping the elements of this list
+     * @brief Returns a list consisting of elements of this list stably
+     *        sorted in ascending order, as determined by the `<` operator,
+     *        sorting in parallel.
+     *
+     * @param policy the parallel execution policy
+     * @return a list consisting of elements of this list sorted in
+     *         ascending order, as determined by the `<` operator
+     */
+    List sorted(const ParallelPolicy& policy) const
+    {
+        return sorted(policy, [](const A& x, const A& y) { return x < y; });
+    }
+
+    /**
+     * @brief Returns a list consisting of elements of this list stably
+     *        sorted in ascending order, as determined by the given comparator,
+     *        sorting in parallel.
+     *
+     * Chunks of the list are sorted concurrently and then merged pairwise,
+     * with the merges of each round also running concurrently. Equal
+     * elements keep their original order.
+     *
+     * @tparam Fn the type of the comparator
+     * @param policy the parallel execution policy
+     * @param lt a comparator that returns `true` if its first argument
+     *           is *less* than (i.e., is ordered *before*) the second;
+     *           may be called concurrently
+     * @return a list consisting of elements of this list sorted in
+     *         ascending order, as determined by the given comparator
+     */
+    template<typename Fn>
+    List sorted(const ParallelPolicy& policy, Fn lt) const
+    {
+        const auto k = tasks(policy);
+        if (k <= 1) {
+            return sorted(std::move(lt), true);
+        }
+
+        trace::Scope scope("List::sorted/par", size());
+        std::vector<const Node*> buf;
+        buf.reserve(size());
+        stats::onBuffer(buf.capacity() * sizeof (const Node*));
+        foreachImpl([&buf](const Node* n) {
+            buf.emplace_back(n);
+        });
+
+        auto comp = [&lt](const Node* x, const Node* y) {
+            return lt(*x->head(), *y->head());
+        };
+        const auto len = (size() + k - 1) / k;
+        const auto first = buf.begin();
+        auto bound = [&](std::size_t i) {
+            return static_cast<std::ptrdiff_t>(std::min(i * len, size()));
+        };
+        auto& executor = policy.executor();
+        executor.parallelFor(k, [&](std::size_t i) {
+            std::stable_sort(first + bound(i), first + bound(i + 1), comp);
+        });
+        sort::mergeRuns(executor, first, k, bound, comp);
+
+        Builder ys(allocator());
+        for (const auto n : buf) {
+            ys.share(n);
+        }
+        auto zs = ys.result();
+        scope.done(zs.size());
+        return zs;
+    }
+
+    /**
+     * @brief Returns a list consisting of elements of this list stably
+     *        sorted in ascending order of the keys computed by a function,
+     *        as determined by the `<` operator.
+     *
+     * `key` is called once per element, and the keys are stored
+     * contiguously with the elements they belong to while sorting. Integral
+     * keys are sorted with a radix sort.
+     *
+     * @tparam Fn the type of the key function
+     * @tparam K the type of the keys
+     * @param key the function computing the key of an element
+     * @return a list consisting of elements of this list sorted in
+     *         ascending order of their keys
+     */
+    template<typename Fn, typename K = Decay<Ret<Fn, A>>>
+    List sortedBy(Fn key) const
+    {
+        std::vector<std::pair<K, const Node*>> buf;
+        buf.reserve(size());
+        stats::onBuffer(buf.capacity() * sizeof (std::pair<K, const Node*>));
+        foreachImpl([&buf, &key](const Node* n) {
+            buf.emplace_back(key(*n->head()), n);
+        });
+        sort::byKey(buf);
+
+        Builder ys(allocator());
+        for (const auto& x : buf) {
+            ys.share(x.second);
+        }
+        return ys.result();
+    }
+
+    /**
+     * @brief Returns a list consisting of elements of this list stably
+     *        sorted in ascending order of the keys computed by a function,
+     *        as determined by the `<` operator, sorting in parallel.
+     *
+     * Chunks of the list have their keys computed and are sorted
+     * concurrently, after which they are merged pairwise as in
+     * `sorted(policy, lt)`.
+     *
+     * @tparam Fn the type of the key function
+     * @tparam K the type of the keys
+     * @param policy the parallel execution policy
+     * @param key the function computing the key of an element; may be called
+     *            concurrently
+     * @return a list consisting of elements of this list sorted in
+     *         ascending order of their keys
+     */
+    template<typename Fn, typename K = Decay<Ret<Fn, A>>>
+    List sortedBy(const ParallelPolicy& policy, Fn key) const
+    {
+        using P = std::pair<K, const Node*>;
+
+        const auto runs = chunks(policy);
+        if (runs.size() <= 1) {
+            return sortedBy(std::move(key));
+        }
+
+        std::vector<std::vector<P>> parts(runs.size());
+        auto& executor = policy.executor();
+        executor.parallelFor(runs.size(), [&](std::size_t i) {
+            auto& part = parts[i];
+            part.reserve(runs[i].second);
+            auto n = runs[i].first;
+            for (auto k = runs[i].second; k > 0; --k, n = n->tail.get()) {
+                part.emplace_back(key(*n->head()), n);
+            }
+            sort::byKey(part);
+        });
+
+        std::vector<P> buf;
+        buf.reserve(size());
+        stats::onBuffer(2 * buf.capacity() * sizeof (P));
+        std::vector<std::ptrdiff_t> bounds(1, 0);
+        for (auto& part : parts) {
+            std::move(part.begin(), part.end(), std::back_inserter(buf));
+            bounds.push_back(static_cast<std::ptrdiff_t>(buf.size()));
+            std::vector<P>().swap(part);
+        }
+        sort::mergeRuns(executor, buf.begin(), parts.size(),
+            [&bounds](std::size_t i) { return bounds[i]; },
+            [](const P& x, const P& y) { return x.first < y.first; });
+
+        Builder ys(allocator());
+        for (const auto& x : buf) {
+            ys.share(x.second);
+        }
+        return ys.result();
+    }
+
+    /**
+     * @brief Returns a list resulting from wrapping the elements of this list
      *        in `std::reference_wrapper<const A>`s.
      *
      * @return a list resulting from wrapping the elements of this list
      *         in `std::reference_wrapper<const A>`s
      */
-    List<std::reference_wrapper<const A>> cref() const
+    List<std::reference_wrapper<const A>, Rebind<Alloc, std::reference_wrapper<const A>>>
+    cref() const
     {
         return map([](const A& x) { return std::cref(x); });
     }
@@ -849,33 +1704,175 @@ public:
      * If one of the two lists is longer than the other, its remaining elements
      * are ignored.
      *
-     * The list elements are copied into the pairs. To avoid copying, transform
-     * the lists with `cref()` and zip the resulting lists instead.
+     * The list elements are copied into the pairs, which are constructed
+     * in place. To avoid copying, use `zipRef()` or `zipWith()` instead.
      *
      * @tparam B the element type of `that`
      * @param that the list providing the second element of each result pair
      * @return a list formed from this list and `that` by combining
      *         corresponding elements in pairs
      */
-    template<typename B>
-    List<std::pair<A, B>> zip(const List<B>& that) const
+    template<typename B, typename BAlloc>
+    List<std::pair<A, B>, Rebind<Alloc, std::pair<A, B>>> zip(
+            const List<B, BAlloc>& that) const
     {
         using AB = std::pair<A, B>;
 
+        const Rebind<Alloc, AB> alloc(allocator());
+        ListBuilder<AB, Rebind<Alloc, AB>> buf(alloc);
+
         std::size_t s = std::min(size(), that.size());
-        std::vector<Ptr<AB>> buf;
-        buf.reserve(s);
+        auto n1 = node_.get();
+        auto n2 = that.node_.get();
+        for (; s > 0; n1 = n1->tail.get(), n2 = n2->tail.get(), --s) {
+            buf.append(*n1->head(), *n2->head());
+        }
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns a list formed from this list and `that` by pairing
+     *        references to corresponding elements.
+     *
+     * If one of the two lists is longer than the other, its remaining elements
+     * are ignored. The references are valid as long as the zipped lists are
+     * alive.
+     *
+     * @tparam B the element type of `that`
+     * @param that the list providing the second element of each result pair
+     * @return a list of pairs of references to corresponding elements of
+     *         this list and `that`
+     */
+    template<typename B, typename BAlloc>
+    List<
+        std::pair<std::reference_wrapper<const A>, std::reference_wrapper<const B>>,
+        Rebind<Alloc, std::pair<std::reference_wrapper<const A>, std::reference_wrapper<const B>>>
+    > zipRef(const List<B, BAlloc>& that) const
+    {
+        using AB = std::pair<std::reference_wrapper<const A>, std::reference_wrapper<const B>>;
+        return zipWith(that, [](const A& x, const B& y) {
+            return AB(std::cref(x), std::cref(y));
+        });
+    }
+
+    /**
+     * @brief Returns a list formed from this list and `that` by combining
+     *        corresponding elements with a function.
+     *
+     * If one of the two lists is longer than the other, its remaining elements
+     * are ignored. The elements are passed to `f` by reference, and its
+     * results are moved into the returned list, so no intermediate pairs
+     * are constructed.
+     *
+     * @tparam B the element type of `that`
+     * @tparam Fn the type of the function
+     * @tparam C the result type of the function
+     * @param that the list providing the second argument of each call to `f`
+     * @param f the function combining corresponding elements
+     * @return a list of the results of applying `f` to corresponding
+     *         elements of this list and `that`
+     */
+    template<
+        typename B,
+        typename BAlloc,
+        typename Fn,
+        typename C = Decay<Ret<Fn, const A&, const B&>>
+    >
+    List<C, Rebind<Alloc, C>> zipWith(const List<B, BAlloc>& that, Fn f) const
+    {
+        const Rebind<Alloc, C> alloc(allocator());
+        ListBuilder<C, Rebind<Alloc, C>> buf(alloc);
 
+        std::size_t s = std::min(size(), that.size());
         auto n1 = node_.get();
         auto n2 = that.node_.get();
         for (; s > 0; n1 = n1->tail.get(), n2 = n2->tail.get(), --s) {
-            buf.emplace_back(std::make_shared<AB>(*(n1->head), *(n2->head)));
+            buf.append(f(*n1->head(), *n2->head()));
+        }
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns a list formed from this list, `bs` and `cs` by
+     *        combining corresponding elements in tuples.
+     *
+     * The returned list is as long as the shortest of the three lists.
+     * The list elements are copied into the tuples, which are constructed
+     * in place.
+     *
+     * @tparam B the element type of `bs`
+     * @tparam C the element type of `cs`
+     * @param bs the list providing the second element of each result tuple
+     * @param cs the list providing the third element of each result tuple
+     * @return a list formed from this list, `bs` and `cs` by combining
+     *         corresponding elements in tuples
+     */
+    template<typename B, typename BAlloc, typename C, typename CAlloc>
+    List<std::tuple<A, B, C>, Rebind<Alloc, std::tuple<A, B, C>>> zip3(
+            const List<B, BAlloc>& bs, const List<C, CAlloc>& cs) const
+    {
+        using ABC = std::tuple<A, B, C>;
+
+        const Rebind<Alloc, ABC> alloc(allocator());
+        ListBuilder<ABC, Rebind<Alloc, ABC>> buf(alloc);
+
+        std::size_t s = std::min(size(), std::min(bs.size(), cs.size()));
+        auto n1 = node_.get();
+        auto n2 = bs.node_.get();
+        auto n3 = cs.node_.get();
+        for (; s > 0; n1 = n1->tail.get(), n2 = n2->tail.get(), n3 = n3->tail.get(), --s) {
+            buf.append(*n1->head(), *n2->head(), *n3->head());
         }
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns a list of the elements of this list, each paired with
+     *        its index.
+     *
+     * @return a list of pairs of the elements of this list and their
+     *         indices, in order
+     */
+    List<std::pair<A, std::size_t>, Rebind<Alloc, std::pair<A, std::size_t>>> zipWithIndex() const
+    {
+        using AI = std::pair<A, std::size_t>;
 
-        return List<AB>::toList(
-                buf.size(),
-                std::make_move_iterator(buf.rbegin()),
-                std::make_move_iterator(buf.rend()));
+        const Rebind<Alloc, AI> alloc(allocator());
+        ListBuilder<AI, Rebind<Alloc, AI>> buf(alloc);
+        std::size_t i = 0;
+        foreachImpl([&buf, &i](const Node* n) {
+            buf.append(*n->head(), i++);
+        });
+        return buf.result();
+    }
+
+    /**
+     * @brief Splits this list of pairs into the list of their first
+     *        elements and the list of their second elements, in a single
+     *        pass.
+     *
+     * @tparam P the element type of this list, which must be a pair
+     * @tparam X the type of the first elements of the pairs
+     * @tparam Y the type of the second elements of the pairs
+     * @return a pair of the list of the first elements and the list of
+     *         the second elements of the pairs of this list
+     */
+    template<
+        typename P = A,
+        typename X = typename P::first_type,
+        typename Y = typename P::second_type
+    >
+    std::pair<List<X, Rebind<Alloc, X>>, List<Y, Rebind<Alloc, Y>>> unzip() const
+    {
+        const Rebind<Alloc, X> xalloc(allocator());
+        const Rebind<Alloc, Y> yalloc(allocator());
+        ListBuilder<X, Rebind<Alloc, X>> xs(xalloc);
+        ListBuilder<Y, Rebind<Alloc, Y>> ys(yalloc);
+        foreachImpl([&xs, &ys](const Node* n) {
+            xs.append(n->head()->first);
+            ys.append(n->head()->second);
+        });
+        return std::make_pair(xs.result(), ys.result());
     }
 
     /**
@@ -899,7 +1896,7 @@ public:
             std::is_same<A1, A>::value || std::is_base_of<A1, A>::value
         >::type
     >
-    List<A1> scan(A1 z, Fn op) const
+    List<A1, Rebind<Alloc, A1>> scan(A1 z, Fn op) const
     {
         return scanLeft(std::move(z), std::move(op));
     }
@@ -917,19 +1914,15 @@ public:
      *         over this list with the given start value and binary operator
      */
     template<typename B, typename Fn>
-    List<B> scanLeft(B z, Fn op) const
+    List<B, Rebind<Alloc, B>> scanLeft(B z, Fn op) const
     {
-        std::vector<Ptr<B>> acc;
-        acc.reserve(size() + 1);
-        acc.emplace_back(std::make_shared<B>(std::move(z)));
-        foreachImpl([&acc, &op] (const Ptr<A>& x) {
-            acc.emplace_back(std::make_shared<B>(op(*acc.back(), *x)));
+        const Rebind<Alloc, B> alloc(allocator());
+        ListBuilder<B, Rebind<Alloc, B>> acc(alloc);
+        acc.append(std::move(z));
+        foreachImpl([&acc, &op] (const Node* n) {
+            acc.append(op(acc.back(), *n->head()));
         });
-
-        return List<B>::toList(
-                size() + 1,
-                std::make_move_iterator(acc.rbegin()),
-                std::make_move_iterator(acc.rend()));
+        return acc.result();
     }
 
     /**
@@ -945,21 +1938,18 @@ public:
      *         over this list with the given start value and binary operator
      */
     template<typename B, typename Fn>
-    List<B> scanRight(B z, Fn op) const
+    List<B, Rebind<Alloc, B>> scanRight(B z, Fn op) const
     {
-        std::vector<const A*> buf;
-        buf.reserve(size());
-        foreachImpl([&buf](const Ptr<A>& x) {
-            buf.emplace_back(x.get());
-        });
+        using BL = List<B, Rebind<Alloc, B>>;
+        using BN = typename BL::Node;
 
-        using BN = typename List<B>::Node;
-        auto hd = BN::create(std::make_shared<B>(std::move(z)), BN::create());
-        for (auto it = buf.crbegin(); it != buf.crend(); ++it) {
-            auto ptr = std::make_shared<B>(op(**it, *hd->head));
-            hd = BN::create(std::move(ptr), std::move(hd));
-        }
-        return List<B>(size() + 1, std::move(hd));
+        const Rebind<Alloc, B> alloc(allocator());
+        auto hd = BN::emplace(alloc, BN::create(), std::move(z));
+        foreachRightImpl([&alloc, &hd, &op](const Node* n) {
+            B x = op(*n->head(), *hd->head());
+            hd = BN::emplace(alloc, std::move(hd), std::move(x));
+        });
+        return BL(size() + 1, std::move(hd), alloc);
     }
 
     /**
@@ -1040,16 +2030,15 @@ public:
             throw std::out_of_range("reduceRight on empty list");
         }
 
-        std::vector<const A*> buf;
-        buf.reserve(size());
-        foreachImpl([&buf] (const Ptr<A>& x) {
-            buf.emplace_back(x.get());
+        A1 acc = last();
+        bool first = true;
+        foreachRightImpl([&acc, &op, &first](const Node* n) {
+            if (first) {
+                first = false;
+            } else {
+                acc = op(*n->head(), std::move(acc));
+            }
         });
-
-        A1 acc = *buf.back();
-        for (auto it = ++buf.crbegin(); it != buf.crend(); ++it) {
-            acc = op(**it, std::move(acc));
-        }
         return acc;
     }
 
@@ -1067,7 +2056,7 @@ public:
         }
         auto n = node_.get();
         for (; index > 0; n = n->tail.get(), --index) {}
-        return *(n->head);
+        return *n->head();
     }
 
     /**
@@ -1077,7 +2066,7 @@ public:
      * @return `true` if `that` contains the same elements as this list
      *         in the same order, `false` otherwise
      */
-    bool operator==(const List<A>& that) const
+    bool operator==(const List& that) const
     {
         if (this == &that) {
             return true;
@@ -1085,10 +2074,14 @@ public:
         if (size() != that.size()) {
             return false;
         }
+        // Lists of the same size end with the same sentinel, and from the
+        // first node they share on they are trivially equal.
         for (auto n1 = node_.get(), n2 = that.node_.get();
-                n1->head;
+                n1 != n2;
                 n1 = n1->tail.get(), n2 = n2->tail.get()) {
-            if (*(n1->head) != *(n2->head)) {
+            const auto h1 = Node::cachedHash(n1);
+            const auto h2 = Node::cachedHash(n2);
+            if ((h1 && h2 && h1 != h2) || *n1->head() != *n2->head()) {
                 return false;
             }
         }
@@ -1102,215 +2095,2026 @@ public:
      * @return `true` if `that` does not contains the same elements as this list
      *         in the same order, `false` otherwise
      */
-    bool operator!=(const List<A>& that) const
+    bool operator!=(const List& that) const
     {
         return !(*this == that);
     }
 
-    class StdIterator;
-
     /**
-     * @brief Returns an iterator to the first element of this list.
+     * @brief Returns a hash of the elements of this list, computed with
+     *        `std::hash<A>`.
      *
-     * If this list is empty, the returned iterator will be equal to `end()`.
+     * Each node caches the hash of the elements from it onwards once it is
+     * computed, so hashing this list again takes O(1) time, and hashing a
+     * list sharing a suffix with a hashed one only hashes the elements
+     * before that suffix. Equality comparisons also use cached hashes to
+     * tell lists apart early.
      *
-     * @return an iterator to the first element of this list.
+     * @return a hash of the elements of this list
      */
-    StdIterator begin() const
+    std::size_t hash() const
     {
-        return StdIterator(node_.get());
+        return Node::hash(node_.get());
     }
 
     /**
-     * @brief Returns an iterator to the element following the last element
-     *        of this list.
+     * @brief Returns a lazy view of this list.
      *
-     * This element acts as a placeholder; attempting to access it results in
-     * undefined behavior.
+     * Transformations chained on the view, such as
+     * `xs.view().map(f).filter(p).take(n)`, are fused into a single pass
+     * over this list that runs only when a terminal operation (e.g.,
+     * `toList()` or `foldLeft()`) is invoked on the view.
      *
-     * @return an iterator to the element following the last element
-     *         of this list
+     * @return a lazy view of this list
      */
-    StdIterator end() const
-    {
-        static const auto nil = Node::create();
-        return StdIterator(nil.get());
-    }
-
-private:
-    template<typename>
-    friend class List;
-
-    template<typename T>
-    using Ptr = std::shared_ptr<const T>;
-
-    class Node;
-
-    List(std::size_t size, Ptr<Node> node) noexcept
-        : size_(size)
-        , node_(std::move(node))
-    {}
+    ListView<stage::Source<A, Alloc>> view() const;
 
-    template<typename Fn>
-    void foreachImpl(Fn f) const
+    /**
+     * @brief Returns a borrowed reference to this list.
+     *
+     * Walking the reference with `tail()`, `uncons()`, `drop()` or
+     * `dropWhile()` only follows node pointers, without retaining or
+     * releasing any node. The reference is valid only as long as this
+     * list is alive and not assigned to.
+     *
+     * @return a borrowed reference to this list
+     */
+    ListRef<A, Alloc> borrow() const
     {
-        for (auto n = node_.get(); n->head; n = n->tail.get()) {
-            f(n->head);
-        }
+        return ListRef<A, Alloc>(this, node_.get(), size_);
     }
 
-    template<typename ReverseIt>
-    static List toList(
-            std::size_t size,
-            ReverseIt rbegin,
-            ReverseIt rend,
-            Ptr<Node> head = Node::create())
+    /**
+     * @brief Returns the windows of `n` consecutive elements of this list,
+     *        starting every `step` elements.
+     *
+     * The windows are borrowed views into the nodes of this list: stepping
+     * from one window to the next follows at most `step` node pointers at
+     * each end, and allocates nothing. The last window is shorter than `n`
+     * if fewer than `n` elements remain for it; a list of at most `n`
+     * elements has a single window, and an empty list has none. The
+     * windows are valid only as long as this list is alive and not
+     * assigned to.
+     *
+     * @param n the number of elements of each window
+     * @param step the distance between the starts of consecutive windows
+     * @return the windows of this list
+     * @throws std::invalid_argument if `n` or `step` is zero
+     */
+    ListWindows<A, Alloc> sliding(std::size_t n, std::size_t step = 1) const&
     {
-        for (; rbegin != rend; ++rbegin) {
-            head = Node::create(*rbegin, std::move(head));
+        if (n == 0 || step == 0) {
+            throw std::invalid_argument("window size and step must be positive");
         }
-        return List(size, std::move(head));
+        return ListWindows<A, Alloc>(this, n, step);
     }
 
-    std::size_t size_;
-    Ptr<Node> node_;
-};
-
-/**
- * @brief A `ForwardIterator` for a `List`.
- *
- * @author Zizheng Tai
- * @since 1.0
- * @tparam A the element type of the list
- */
-template<typename A>
-class List<A>::StdIterator final
-    : public std::iterator<std::forward_iterator_tag,
-                           A,
-                           std::ptrdiff_t,
-                           const A*,
-                           const A&> {
-public:
-    /** @brief Default copy constructor. */
-    StdIterator(const StdIterator&) = default;
-
-    /** @brief Default move constructor. */
-    StdIterator(StdIterator&) = default;
-
-    /** @brief Default copy assignment operator. */
-    StdIterator& operator=(const StdIterator&) = default;
-
-    /** @brief Default move assignment operator. */
-    StdIterator& operator=(StdIterator&&) = default;
-
     /**
-     * @brief Tests whether two iterators point to the same element.
+     * @brief Returns the consecutive groups of `n` elements of this list,
+     *        the last of which may be shorter.
      *
-     * @return `true` if this iterator and `that` point to the same element,
-     *         `false` otherwise
+     * This is `sliding(n, n)`.
+     *
+     * @param n the number of elements of each group
+     * @return the groups of this list
+     * @throws std::invalid_argument if `n` is zero
      */
-    bool operator==(const StdIterator& that) const
+    ListWindows<A, Alloc> grouped(std::size_t n) const&
     {
-        return node_->head == that.node_->head;
+        return sliding(n, n);
     }
 
     /**
-     * @brief Tests whether two iterators point to different element.
+     * @brief Deleted, as the windows would outlive this temporary list.
+     */
+    ListWindows<A, Alloc> sliding(std::size_t n, std::size_t step = 1) const&& = delete;
+
+    /**
+     * @brief Deleted, as the groups would outlive this temporary list.
+     */
+    ListWindows<A, Alloc> grouped(std::size_t n) const&& = delete;
+
+    /**
+     * @brief Returns this list with an index of its nodes, for repeated
+     *        access by position.
      *
-     * @return `true` if this iterator and `that` point to different elements,
-     *         `false` otherwise
+     * `operator[]`, `drop()` and `slice()` of the returned `IndexedList`
+     * jump close to their target instead of walking from the head of the
+     * list each time. Creating it takes O(1) time; the index is built as
+     * positions are accessed.
+     *
+     * @return this list with an index of its nodes
      */
-    bool operator!=(const StdIterator& that) const
+    IndexedList<A, Alloc> indexed() const
     {
-        return node_->head != that.node_->head;
+        return IndexedList<A, Alloc>(*this);
     }
 
     /**
-     * @brief Increments this iterator and returns a reference to it.
+     * @brief Returns a transient copy of this list, which can be grown in
+     *        place and then frozen with `persistent()`.
      *
-     * @return a reference to this iterator
+     * The transient shares all nodes of this list, so this takes O(1) time.
+     *
+     * @return a transient list with the elements of this list
      */
-    StdIterator& operator++()
+    TransientList<A, Alloc> asTransient() const&
     {
-        node_ = node_->tail.get();
-        return *this;
+        return TransientList<A, Alloc>(*this);
     }
 
     /**
-     * @brief Increments this iterator and returns a copy of the original iterator.
+     * @brief Returns a transient list with the elements of this list,
+     *        which can be grown in place and then frozen with `persistent()`.
      *
-     * @return a copy of the original iterator
+     * @return a transient list with the elements of this list
      */
-    StdIterator operator++(int)
+    TransientList<A, Alloc> asTransient() &&
     {
-        StdIterator it = *this;
-        node_ = node_->tail.get();
-        return it;
+        return TransientList<A, Alloc>(std::move(*this));
     }
 
+    class StdIterator;
+
     /**
-     * @brief Returns a reference to the element this iterator points to.
+     * @brief Returns an iterator to the first element of this list.
      *
-     * @return a reference to the element this iterator points to
+     * If this list is empty, the returned iterator will be equal to `end()`.
+     *
+     * @return an iterator to the first element of this list.
      */
-    const A& operator*() const
+    StdIterator begin() const
     {
-        return *node_->head;
+        return StdIterator(node_.get());
     }
 
     /**
-     * @brief Returns a pointer to the element this iterator points to.
+     * @brief Returns an iterator to the element following the last element
+     *        of this list.
      *
-     * @return a pointer to the element this iterator points to
+     * This element acts as a placeholder; attempting to access it results in
+     * undefined behavior. The returned iterator is a sentinel that compares
+     * equal to every iterator past the end of a list, so comparing against
+     * it only tests whether an iterator has run out of elements.
+     *
+     * @return an iterator to the element following the last element
+     *         of this list
      */
-    const A* operator->() const
+    StdIterator end() const
     {
-        return node_->head.get();
+        return StdIterator();
     }
 
 private:
+    template<typename, typename>
     friend class List;
 
-    explicit StdIterator(const Node* node) noexcept : node_(node) {}
+    template<typename, typename>
+    friend class ListBuilder;
 
-    const Node* node_;
-};
+    template<typename, typename>
+    friend class TransientList;
 
-/// @cond GUNGNIR_PRIVATE
-template<typename A>
-class List<A>::Node final {
-    class Priv final {};
+    template<typename, typename>
+    friend class ListRef;
 
-public:
-    static Ptr<Node> create()
+    template<typename, typename>
+    friend class ListWindow;
+
+    template<typename, typename>
+    friend class ListWindows;
+
+    template<typename, typename>
+    friend class IndexedList;
+
+    template<typename, typename>
+    friend struct OptionNiche;
+
+    class Node;
+    class NodePtr;
+
+    using Builder = ListBuilder<A, Alloc>;
+
+    List(std::size_t size, NodePtr node, const Alloc& alloc) noexcept
+        : Compressed<Alloc>(alloc)
+        , size_(size)
+        , node_(std::move(node))
+    {}
+
+    // Returns a hash set of the elements of this list.
+    ProbeSet<A> probeSet() const
     {
-        return std::make_shared<const Node>(Priv());
+        ProbeSet<A> set(size());
+        stats::onBuffer(set.bytes());
+        foreachImpl([&set](const Node* n) { set.insert(n->head()); });
+        return set;
     }
 
-    static Ptr<Node> create(Ptr<A> head, Ptr<Node> tail)
+    template<typename Fn>
+    void foreachImpl(Fn f) const
     {
-        return std::make_shared<const Node>(
-                Priv(), std::move(head), std::move(tail));
+        for (auto n = node_.get(); n->head(); n = n->tail.get()) {
+            f(n);
+        }
     }
 
-    Node(Priv) noexcept {}
-
-    Node(Priv, Ptr<A> head, Ptr<Node> tail) noexcept
-        : head(std::move(head))
-        , tail(std::move(tail))
-    {}
+    // Applies `f` to each node of this list, going right to left. The
+    // list is cut into about sqrt(n) chunks of about sqrt(n) nodes each;
+    // the first pass records where each chunk starts, and the chunks are
+    // then buffered and visited one at a time, last chunk first. This
+    // takes two passes like buffering the whole list would, but only
+    // O(sqrt(n)) memory on the side.
+    template<typename Fn>
+    void foreachRightImpl(Fn f) const
+    {
+        const auto n = size();
+        std::size_t k = 1;
+        while (k * k < n) {
+            ++k;
+        }
 
-    Node(const Node&) = delete;
-    Node(Node&&) = delete;
+        std::vector<const Node*> starts;
+        starts.reserve((n + k - 1) / k);
+        std::vector<const Node*> buf;
+        buf.reserve(std::min(n, k));
+        stats::onBuffer((starts.capacity() + buf.capacity()) * sizeof (const Node*));
 
-    Node& operator=(const Node&) = delete;
-    Node& operator=(Node&&) = delete;
+        std::size_t i = 0;
+        foreachImpl([&starts, &i, k](const Node* m) {
+            if (i++ % k == 0) {
+                starts.emplace_back(m);
+            }
+        });
+        for (auto it = starts.crbegin(); it != starts.crend(); ++it) {
+            buf.clear();
+            auto m = *it;
+            for (std::size_t j = 0; j < k && m->head(); ++j, m = m->tail.get()) {
+                buf.emplace_back(m);
+            }
+            for (auto jt = buf.crbegin(); jt != buf.crend(); ++jt) {
+                f(*jt);
+            }
+        }
+    }
+
+    // Replaces `x` with an `A` constructed from `args` if `A` is move
+    // assignable, returning whether it did.
+    template<typename... Args>
+    static bool assign(std::true_type, A& x, Args&&... args)
+    {
+        x = A(std::forward<Args>(args)...);
+        return true;
+    }
+
+    template<typename... Args>
+    static bool assign(std::false_type, A&, Args&&...)
+    {
+        return false;
+    }
+
+    // Maps the elements of this list with `f` into new nodes.
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    List<B, Rebind<Alloc, B>> mapCopy(Fn f) const
+    {
+        const Rebind<Alloc, B> alloc(allocator());
+        ListBuilder<B, Rebind<Alloc, B>> buf(alloc);
+        foreachImpl([&buf, &f](const Node* n) {
+            buf.append(f(*n->head()));
+        });
+        return buf.result();
+    }
+
+    // Maps the elements of this list with `f`, replacing the elements of
+    // the leading nodes it owns in place.
+    template<typename Fn>
+    List mapImpl(Fn f, std::true_type) &&
+    {
+        auto n = node_.get();
+        const Node* last = nullptr;
+        std::size_t i = 0;
+        for (; n->head() && Node::owns(n); n = n->tail.get(), ++i) {
+            auto& x = Node::value(n);
+            Node::forget(n);
+            x = f(std::move(x));
+            last = n;
+        }
+        if (!n->head()) {
+            return std::move(*this);
+        } else if (!last) {
+            return static_cast<const List&>(*this).mapCopy(std::move(f));
+        }
+        const List xs(size() - i, Node::unlink(last), allocator());
+        const auto ys = xs.mapCopy(std::move(f));
+        Node::link(last, ys.node_);
+        return std::move(*this);
+    }
+
+    // Maps the elements of this list with `f`, moving the elements of the
+    // leading nodes it owns into `f` and freeing those nodes as it goes.
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    List<B, Rebind<Alloc, B>> mapImpl(Fn f, std::false_type) &&
+    {
+        const Rebind<Alloc, B> alloc(allocator());
+        ListBuilder<B, Rebind<Alloc, B>> buf(alloc);
+        auto rest = std::move(node_);
+        auto size = size_;
+        for (; rest->head() && Node::unique(rest.get()); --size) {
+            if (Node::owns(rest.get())) {
+                buf.append(f(std::move(Node::value(rest.get()))));
+            } else {
+                buf.append(f(*rest->head()));
+            }
+            rest = Node::unlink(rest.get());
+        }
+
+        const List xs(size, std::move(rest), allocator());
+        const auto ys = xs.mapCopy(std::move(f));
+        return buf.result(ys.node_, ys.size());
+    }
+
+    // The number of tasks `policy` splits this list into. Nodes whose
+    // counters are not atomic must not be retained or released on other
+    // threads, so such lists are always processed in a single task.
+    std::size_t tasks(const ParallelPolicy& policy) const
+    {
+        return std::is_same<RefCountOf<Alloc>, AtomicRefCount>::value ? policy.chunks(size()) : 1;
+    }
+
+    // Splits this list into the runs of consecutive nodes processed by one
+    // task each, as (first node, length) pairs.
+    std::vector<std::pair<const Node*, std::size_t>>
+    chunks(const ParallelPolicy& policy) const
+    {
+        std::vector<std::pair<const Node*, std::size_t>> runs;
+        const auto k = tasks(policy);
+        const auto len = (size() + k - 1) / k;
+        runs.reserve(k);
+        std::size_t i = 0;
+        foreachImpl([&](const Node* n) {
+            if (i % len == 0) {
+                runs.emplace_back(n, std::min(len, size() - i));
+            }
+            ++i;
+        });
+        return runs;
+    }
+
+    // Links the lists built by each of `bufs` together, in order.
+    template<typename B, typename BAlloc>
+    static List<B, BAlloc> stitch(std::vector<ListBuilder<B, BAlloc>>& bufs)
+    {
+        auto xs = bufs.back().result();
+        for (auto i = bufs.size() - 1; i-- > 0;) {
+            xs = bufs[i].result(std::move(xs.node_), xs.size());
+        }
+        return xs;
+    }
 
-    const Ptr<A> head;
-    const Ptr<Node> tail;
+    // The byte offset of `node_`, which always points to a node, at least
+    // the shared empty one, and thus leaves a niche for `Option<List>`.
+    static constexpr std::size_t nodeOffset()
+    {
+        return offsetof(List, node_);
+    }
+
+    std::size_t size_;
+    NodePtr node_;
 };
+
+/// @cond GUNGNIR_PRIVATE
+template<typename A, typename Alloc>
+struct OptionNiche<
+    List<A, Alloc>,
+    typename std::enable_if<std::is_standard_layout<List<A, Alloc>>::value>::type
+> : detail::PointerNiche<List<A, Alloc>::nodeOffset()> {};
 /// @endcond
 
+/**
+ * @brief A `ForwardIterator` for a `List`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the element type of the list
+ */
+template<typename A, typename Alloc>
+class List<A, Alloc>::StdIterator final {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = A;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const A*;
+    using reference = const A&;
+
+    /**
+     * @brief Constructs an iterator past the end of any list, equal to
+     *        `end()`.
+     */
+    StdIterator() noexcept : node_(nullptr) {}
+
+    /** @brief Default copy constructor. */
+    StdIterator(const StdIterator&) = default;
+
+    /** @brief Default move constructor. */
+    StdIterator(StdIterator&&) = default;
+
+    /** @brief Default copy assignment operator. */
+    StdIterator& operator=(const StdIterator&) = default;
+
+    /** @brief Default move assignment operator. */
+    StdIterator& operator=(StdIterator&&) = default;
+
+    /**
+     * @brief Tests whether two iterators point to the same position.
+     *
+     * Positions are told apart by node, not by element, since the nodes of
+     * different positions may share an element.
+     *
+     * @return `true` if this iterator and `that` point to the same node, or
+     *         are both past the end, `false` otherwise
+     */
+    bool operator==(const StdIterator& that) const
+    {
+        return node_ == that.node_ || (atEnd() && that.atEnd());
+    }
+
+    /**
+     * @brief Tests whether two iterators point to different positions.
+     *
+     * @return `true` if this iterator and `that` point to different nodes,
+     *         and are not both past the end, `false` otherwise
+     */
+    bool operator!=(const StdIterator& that) const
+    {
+        return !(*this == that);
+    }
+
+    /**
+     * @brief Increments this iterator and returns a reference to it.
+     *
+     * @return a reference to this iterator
+     */
+    StdIterator& operator++()
+    {
+        node_ = node_->tail.get();
+        return *this;
+    }
+
+    /**
+     * @brief Increments this iterator and returns a copy of the original iterator.
+     *
+     * @return a copy of the original iterator
+     */
+    StdIterator operator++(int)
+    {
+        StdIterator it = *this;
+        node_ = node_->tail.get();
+        return it;
+    }
+
+    /**
+     * @brief Returns a reference to the element this iterator points to.
+     *
+     * @return a reference to the element this iterator points to
+     */
+    const A& operator*() const
+    {
+        return *node_->head();
+    }
+
+    /**
+     * @brief Returns a pointer to the element this iterator points to.
+     *
+     * @return a pointer to the element this iterator points to
+     */
+    const A* operator->() const
+    {
+        return node_->head();
+    }
+
+private:
+    friend class List;
+
+    template<typename, typename>
+    friend class ListWindow;
+
+    explicit StdIterator(const Node* node) noexcept : node_(node) {}
+
+    // Past the end, `node_` is `nullptr` for a default-constructed iterator
+    // such as `end()`, and the empty node ending the list otherwise.
+    bool atEnd() const
+    {
+        return !node_ || !node_->head();
+    }
+
+    const Node* node_;
+};
+
+/// @cond GUNGNIR_PRIVATE
+/*
+ * An intrusively reference-counted list node.
+ *
+ * A node either owns its element, in which case it is allocated as a `Cell`
+ * holding the element inline, or shares the element of another node's cell.
+ * `refs_` counts the references to the node itself; a cell additionally
+ * counts the nodes that refer to its element, so that a shared element
+ * outlives its owning node without keeping the owner's tail alive. Both
+ * counters follow the policy `RefCountOf<Alloc>`.
+ */
+template<typename A, typename Alloc>
+class List<A, Alloc>::Node {
+    class Cell;
+
+public:
+    static NodePtr create()
+    {
+        return retained(nil());
+    }
+
+    // Returns a new reference to `n`.
+    static NodePtr retained(const Node* n)
+    {
+        retain(n);
+        return NodePtr(const_cast<Node*>(n));
+    }
+
+    // Returns the sentinel shared by all empty lists. It is never freed, and
+    // the reference it starts with is never released.
+    static Node* nil()
+    {
+        static typename std::aligned_storage<sizeof (Node), alignof (Node)>::type buf;
+        static const auto n = new (&buf) Node(nullptr, NodePtr());
+        return n;
+    }
+
+    // Creates a node sharing the element of `elem`, allocated with the
+    // allocator of the node owning that element.
+    static NodePtr create(const Node* elem, NodePtr tail)
+    {
+        const auto owner = elem->owner_;
+        NodeAlloc alloc(owner->get());
+        const auto p = NodeTraits::allocate(alloc, 1);
+        stats::onNodeAllocate();
+        owner->holds.retain();
+        stats::onRetain();
+        return NodePtr(new (p) Node(owner, std::move(tail)));
+    }
+
+    template<typename... Args>
+    static NodePtr emplace(const Alloc& a, NodePtr tail, Args&&... args)
+    {
+        CellAlloc alloc(a);
+        const auto p = CellTraits::allocate(alloc, 1);
+        try {
+            NodePtr n(new (p) Cell(a, std::move(tail), std::forward<Args>(args)...));
+            stats::onCellAllocate();
+            return n;
+        } catch (...) {
+            CellTraits::deallocate(alloc, p, 1);
+            throw;
+        }
+    }
+
+    Node(const Node&) = delete;
+    Node(Node&&) = delete;
+
+    Node& operator=(const Node&) = delete;
+    Node& operator=(Node&&) = delete;
+
+    const A* head() const
+    {
+        return owner_ ? &owner_->value : nullptr;
+    }
+
+    // Returns the last node of the non-empty chain starting at `n`, and
+    // caches it in `n`. The walk stops at the first node whose last node is
+    // already known.
+    static const Node* last(const Node* n)
+    {
+        auto l = n->last_.load(std::memory_order_relaxed);
+        if (!l) {
+            for (l = n; l->tail->head(); l = l->tail.get()) {
+                if (const auto m = l->last_.load(std::memory_order_relaxed)) {
+                    l = m;
+                    break;
+                }
+            }
+            n->last_.store(l, std::memory_order_relaxed);
+        }
+        return l;
+    }
+
+    // Passes the cached last node of the non-empty chain starting at `n` on
+    // to its tail, which ends with the same node.
+    static void shareLast(const Node* n)
+    {
+        const auto l = n->last_.load(std::memory_order_relaxed);
+        if (l && l != n) {
+            n->tail->last_.store(l, std::memory_order_relaxed);
+        }
+    }
+
+    // Links `tail` behind the last node of the non-empty chain starting at
+    // `n` if every node of the chain is referenced only once, i.e. nothing
+    // but the chain itself and its single owner can observe the change.
+    // Returns whether it did.
+    static bool splice(const Node* n, const NodePtr& tail)
+    {
+        const auto head = n;
+        for (;;) {
+            if (!n->refs_.unique()) {
+                return false;
+            }
+            // Forgetting cached values is harmless even if the chain turns
+            // out to be shared.
+            forget(n);
+            if (!n->tail->head()) {
+                break;
+            }
+            n = n->tail.get();
+        }
+        const_cast<Node*>(n)->tail = tail;
+        cacheLast(head, n);
+        return true;
+    }
+
+    // Whether `n` is referenced only once, so that the list holding that
+    // reference is the only one that can observe changes to it.
+    static bool unique(const Node* n)
+    {
+        return n->refs_.unique();
+    }
+
+    // Whether `n` is `unique()` and the only node holding its element, so
+    // that the element can be changed or moved from.
+    static bool owns(const Node* n)
+    {
+        return unique(n) && n->owner_ == n &&
+               n->owner_->holds.unique();
+    }
+
+    // Returns the element of `n`, which must `own()` it.
+    static A& value(const Node* n)
+    {
+        return n->owner_->value;
+    }
+
+    // Detaches and returns the tail of the `unique()` node `n`, which forgets
+    // its cached values.
+    static NodePtr unlink(const Node* n)
+    {
+        forget(n);
+        return std::move(const_cast<Node*>(n)->tail);
+    }
+
+    // Forgets the cached last node and hash of the `unique()` node `n`,
+    // whose tail or element is about to change.
+    static void forget(const Node* n)
+    {
+        n->last_.store(nullptr, std::memory_order_relaxed);
+        n->hash_.store(0, std::memory_order_relaxed);
+    }
+
+    // Returns the cached hash of the chain starting at `n`, or 0 if it has
+    // not been computed yet.
+    static std::uint32_t cachedHash(const Node* n)
+    {
+        return n->hash_.load(std::memory_order_relaxed);
+    }
+
+    // Returns the hash of the elements of the chain starting at `n`,
+    // computing and caching it for each node that has none yet. Cached
+    // hashes are never 0.
+    static std::uint32_t hash(const Node* n)
+    {
+        if (const auto h = cachedHash(n)) {
+            return h;
+        }
+        // The hash of a node depends on that of its tail, so the nodes
+        // whose hashes are missing are hashed back to front.
+        std::vector<const Node*> pending;
+        std::uint32_t h = 0x9e3779b9;
+        for (; n->head(); n = n->tail.get()) {
+            if (const auto t = cachedHash(n)) {
+                h = t;
+                break;
+            }
+            pending.push_back(n);
+        }
+        stats::onBuffer(pending.capacity() * sizeof (const Node*));
+        for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+            auto x = (static_cast<std::uint64_t>(h) << 32 | h) ^ std::hash<A>()(*(*it)->head());
+            x *= 0x9e3779b97f4a7c15;
+            x ^= x >> 29;
+            h = static_cast<std::uint32_t>(x ^ (x >> 32));
+            h = h ? h : 1;
+            (*it)->hash_.store(h, std::memory_order_relaxed);
+        }
+        return h;
+    }
+
+    // Links `tail` behind the `unique()` node `n`, whose tail was unlinked.
+    static void link(const Node* n, NodePtr tail)
+    {
+        const_cast<Node*>(n)->tail = std::move(tail);
+        cacheLast(n, n);
+    }
+
+    // Records in `head` the last node of its chain, given that `n` is a
+    // node of that chain and its tail is already linked.
+    static void cacheLast(const Node* head, const Node* n)
+    {
+        head->last_.store(n->tail->head() ? n->tail->last_.load(std::memory_order_relaxed) : n,
+                          std::memory_order_relaxed);
+    }
+
+    NodePtr tail;
+
+private:
+    friend class NodePtr;
+
+    static_assert(!std::is_same<ReclaimOf<Alloc>, DeferredReclaim>::value ||
+                  std::is_same<RefCountOf<Alloc>, AtomicRefCount>::value,
+                  "DeferredReclaim requires AtomicRefCount");
+
+    using Counter = typename RefCountOf<Alloc>::Counter;
+    using NodeAlloc = Rebind<Alloc, Node>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+    using CellAlloc = Rebind<Alloc, Cell>;
+    using CellTraits = std::allocator_traits<CellAlloc>;
+
+    Node(Cell* owner, NodePtr tail) noexcept
+        : tail(std::move(tail))
+        , owner_(owner)
+        , last_(initialLast())
+        , refs_(1)
+        , hash_(0)
+    {}
+
+    // A node prepended to a chain ends with the same node as the chain;
+    // one whose tail is not linked yet starts with an unknown last node.
+    const Node* initialLast() const noexcept
+    {
+        if (!tail.get()) {
+            return nullptr;
+        }
+        return tail->head() ? tail->last_.load(std::memory_order_relaxed) : this;
+    }
+
+    ~Node() = default;
+
+    // Whether references to `n` are counted. The sentinel is never freed,
+    // so references to it are not counted, which also keeps the empty lists
+    // of all threads from contending on its counter.
+    static bool counted(const Node* n)
+    {
+        return n->owner_ != nullptr;
+    }
+
+    static void retain(const Node* n)
+    {
+        if (counted(n)) {
+            n->refs_.retain();
+        }
+        stats::onRetain();
+    }
+
+    static void release(const Node* n)
+    {
+        if (counted(n) && n->refs_.release()) {
+            reclaim(const_cast<Node*>(n), ReclaimOf<Alloc>());
+        }
+    }
+
+    static void reclaim(Node* n, ImmediateReclaim)
+    {
+        destroy(n, static_cast<std::size_t>(-1));
+    }
+
+    // Destroys the first nodes of the chain and queues the rest, if any,
+    // for the background thread.
+    static void reclaim(Node* n, DeferredReclaim)
+    {
+        if (const auto rest = destroy(n, DeferredReclaim::inlineNodes())) {
+            Reclaimer::global().defer(rest, &destroyAll);
+        }
+    }
+
+    static void destroyAll(void* n)
+    {
+        destroy(static_cast<Node*>(n), static_cast<std::size_t>(-1));
+    }
+
+    // Destroys `n` and every node of its tail that is only referenced by
+    // the node before it, up to `budget` nodes, and returns the next node
+    // to destroy, whose last reference has been released, or null. The
+    // chain is unlinked in a loop rather than through nested `NodePtr`
+    // destructors, so that dropping a long list does not exhaust the stack.
+    static Node* destroy(Node* n, std::size_t budget)
+    {
+        for (; n && budget > 0; --budget) {
+            const auto next = n->tail.detach();
+            const auto owner = n->owner_;
+            if (owner != n) {
+                NodeAlloc alloc(owner->get());
+                n->~Node();
+                NodeTraits::deallocate(alloc, n, 1);
+                stats::onNodeDeallocate();
+            }
+            Cell::drop(owner);
+
+            n = next && counted(next) && next->refs_.release() ? next : nullptr;
+        }
+        return n;
+    }
+
+    Cell* const owner_;
+    // The last node of the chain starting here, or null if not known yet.
+    // Only ever changes from null to the right node, except while splicing
+    // a uniquely referenced chain.
+    mutable std::atomic<const Node*> last_;
+    const Counter refs_;
+    // The hash of the chain starting here, or 0 if not computed yet. Fits
+    // in the padding after `refs_`.
+    mutable std::atomic<std::uint32_t> hash_;
+};
+
+template<typename A, typename Alloc>
+class List<A, Alloc>::Node::Cell final : public Node, public Compressed<Alloc> {
+public:
+    template<typename... Args>
+    Cell(const Alloc& alloc, NodePtr tail, Args&&... args)
+        : Node(this, std::move(tail))
+        , Compressed<Alloc>(alloc)
+        , holds(1)
+        , value(std::forward<Args>(args)...)
+    {}
+
+    static void drop(Cell* c)
+    {
+        if (c->holds.release()) {
+            CellAlloc alloc(c->get());
+            c->~Cell();
+            CellTraits::deallocate(alloc, c, 1);
+            stats::onCellDeallocate();
+        }
+    }
+
+    const Counter holds;
+    // Only ever modified through `Node::value()`, by the single owner of
+    // the only node holding it.
+    A value;
+};
+
+template<typename A, typename Alloc>
+class List<A, Alloc>::NodePtr final {
+public:
+    NodePtr() noexcept : node_(nullptr) {}
+
+    explicit NodePtr(Node* node) noexcept : node_(node) {}
+
+    NodePtr(const NodePtr& that) noexcept : node_(that.node_)
+    {
+        if (node_) {
+            Node::retain(node_);
+        }
+    }
+
+    NodePtr(NodePtr&& that) noexcept : node_(that.node_)
+    {
+        that.node_ = nullptr;
+    }
+
+    ~NodePtr()
+    {
+        if (node_) {
+            Node::release(node_);
+        }
+    }
+
+    NodePtr& operator=(const NodePtr& that) noexcept
+    {
+        NodePtr(that).swap(*this);
+        return *this;
+    }
+
+    NodePtr& operator=(NodePtr&& that) noexcept
+    {
+        NodePtr(std::move(that)).swap(*this);
+        return *this;
+    }
+
+    void swap(NodePtr& that) noexcept
+    {
+        std::swap(node_, that.node_);
+    }
+
+    // Releases ownership of the node without decrementing its count.
+    Node* detach() noexcept
+    {
+        const auto node = node_;
+        node_ = nullptr;
+        return node;
+    }
+
+    const Node* get() const noexcept
+    {
+        return node_;
+    }
+
+    const Node* operator->() const noexcept
+    {
+        return node_;
+    }
+
+private:
+    Node* node_;
+};
+/// @endcond
+/**
+ * @brief A builder that appends elements to a list front-to-back.
+ *
+ * Each appended element is linked to the end of the list under
+ * construction, so a list can be built in a single forward pass without
+ * an intermediate buffer. Calling `result()` freezes the list and leaves
+ * this builder empty.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements; must be a non-reference type
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               the list
+ */
+template<typename A, typename Alloc>
+class ListBuilder final : private Compressed<Alloc> {
+    using L = List<A, Alloc>;
+    using Node = typename L::Node;
+    using NodePtr = typename L::NodePtr;
+
+public:
+    /**
+     * @brief Constructs an empty builder.
+     */
+    ListBuilder() : ListBuilder(Alloc()) {}
+
+    /**
+     * @brief Constructs an empty builder whose nodes will be allocated
+     *        with `alloc`.
+     *
+     * @param alloc the allocator used by the built list
+     */
+    explicit ListBuilder(const Alloc& alloc) noexcept
+        : Compressed<Alloc>(alloc)
+        , last_(nullptr)
+        , size_(0)
+    {}
+
+    /** @brief Deleted copy constructor. */
+    ListBuilder(const ListBuilder&) = delete;
+
+    /** @brief Move constructor. */
+    ListBuilder(ListBuilder&& that) noexcept
+        : Compressed<Alloc>(that)
+        , head_(std::move(that.head_))
+        , last_(that.last_)
+        , size_(that.size_)
+    {
+        that.last_ = nullptr;
+        that.size_ = 0;
+    }
+
+    /** @brief Deleted copy assignment operator. */
+    ListBuilder& operator=(const ListBuilder&) = delete;
+
+    /** @brief Deleted move assignment operator. */
+    ListBuilder& operator=(ListBuilder&&) = delete;
+
+    /**
+     * @brief Returns the number of elements appended so far.
+     *
+     * @return the number of elements appended so far
+     */
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Appends an element constructed in-place from `args`.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `A`
+     * @param args the arguments passed to the constructor of `A`
+     * @return a reference to this builder
+     */
+    template<typename... Args>
+    ListBuilder& append(Args&&... args)
+    {
+        return link(Node::emplace(this->get(), NodePtr(), std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Appends all elements of `xs`, sharing them with `xs`.
+     *
+     * @param xs the list whose elements to append
+     * @return a reference to this builder
+     */
+    ListBuilder& appendAll(const L& xs)
+    {
+        xs.foreachImpl([this](const Node* n) { share(n); });
+        return *this;
+    }
+
+    /**
+     * @brief Returns the list of all appended elements and empties this
+     *        builder.
+     *
+     * @return the list of all appended elements
+     */
+    L result()
+    {
+        return result(Node::create(), 0);
+    }
+
+private:
+    template<typename, typename>
+    friend class List;
+
+    // Appends a node sharing the element of `n`.
+    ListBuilder& share(const Node* n)
+    {
+        return link(Node::create(n, NodePtr()));
+    }
+
+    // The nodes are not reachable from any list until `result()`, so the
+    // tail of the last one can still be set in place.
+    ListBuilder& link(NodePtr node)
+    {
+        const auto n = const_cast<Node*>(node.get());
+        (last_ ? last_->tail : head_) = std::move(node);
+        last_ = n;
+        ++size_;
+        return *this;
+    }
+
+    // Returns the element appended last.
+    const A& back() const
+    {
+        return *last_->head();
+    }
+
+    // Returns the list of all appended elements followed by the `size`
+    // elements of `tail`.
+    L result(NodePtr tail, std::size_t size)
+    {
+        if (last_) {
+            last_->tail = std::move(tail);
+            Node::cacheLast(head_.get(), last_);
+        } else {
+            head_ = std::move(tail);
+        }
+        L xs(size_ + size, std::move(head_), this->get());
+        last_ = nullptr;
+        size_ = 0;
+        return xs;
+    }
+
+    NodePtr head_;
+    Node* last_;
+    std::size_t size_;
+};
+
+/**
+ * @brief A list under construction that is modified in place.
+ *
+ * A persistent list pays for persistence on every step of a bulk load:
+ * each `prepend()` retains the tail it shares and each `concat()` copies
+ * the list it extends. A transient list instead owns the nodes it adds,
+ * linking each new element without touching any reference count, and
+ * freezes them into a list once, with `persistent()`.
+ *
+ * Elements prepended go before the elements the transient started with,
+ * and elements appended after them.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements; must be a non-reference type
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               the list
+ */
+template<typename A, typename Alloc>
+class TransientList final {
+    using L = List<A, Alloc>;
+    using Node = typename L::Node;
+    using NodePtr = typename L::NodePtr;
+
+public:
+    /**
+     * @brief Constructs an empty transient list.
+     */
+    TransientList() : TransientList(L()) {}
+
+    /**
+     * @brief Constructs a transient list starting with the elements of `xs`.
+     *
+     * @param xs the list whose elements the transient starts with
+     */
+    explicit TransientList(L xs) noexcept
+        : front_(std::move(xs))
+        , back_(front_.allocator())
+    {}
+
+    /** @brief Deleted copy constructor. */
+    TransientList(const TransientList&) = delete;
+
+    /** @brief Move constructor. */
+    TransientList(TransientList&& that) noexcept
+        : front_(std::move(that.front_))
+        , back_(std::move(that.back_))
+    {
+        that.front_ = L(front_.allocator());
+    }
+
+    /** @brief Deleted copy assignment operator. */
+    TransientList& operator=(const TransientList&) = delete;
+
+    /** @brief Deleted move assignment operator. */
+    TransientList& operator=(TransientList&&) = delete;
+
+    /**
+     * @brief Returns the number of elements of this transient list.
+     *
+     * @return the number of elements of this transient list
+     */
+    std::size_t size() const
+    {
+        return front_.size() + back_.size();
+    }
+
+    /**
+     * @brief Prepends an element constructed in-place from `args`.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `A`
+     * @param args the arguments passed to the constructor of `A`
+     * @return a reference to this transient list
+     */
+    template<typename... Args>
+    TransientList& prepend(Args&&... args)
+    {
+        // The node is linked only once its element is constructed, so that
+        // a throwing constructor leaves this transient list as it was.
+        auto n = Node::emplace(front_.allocator(), NodePtr(), std::forward<Args>(args)...);
+        Node::link(n.get(), std::move(front_.node_));
+        front_.node_ = std::move(n);
+        ++front_.size_;
+        return *this;
+    }
+
+    /**
+     * @brief Appends an element constructed in-place from `args`.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `A`
+     * @param args the arguments passed to the constructor of `A`
+     * @return a reference to this transient list
+     */
+    template<typename... Args>
+    TransientList& append(Args&&... args)
+    {
+        back_.append(std::forward<Args>(args)...);
+        return *this;
+    }
+
+    /**
+     * @brief Returns the list of all elements of this transient list and
+     *        empties it.
+     *
+     * The appended elements are linked behind the others in place if none
+     * of their nodes is shared with another list, and behind a copy of
+     * them otherwise.
+     *
+     * @return the list of all elements of this transient list
+     */
+    L persistent()
+    {
+        L xs = back_.size() == 0
+            ? std::move(front_)
+            : std::move(front_).concat(back_.result());
+        front_ = L(xs.allocator());
+        return xs;
+    }
+
+private:
+    L front_;
+    ListBuilder<A, Alloc> back_;
+};
+
+/**
+ * @brief A borrowed reference to a suffix of a list.
+ *
+ * A list reference holds raw pointers into the list it was borrowed from,
+ * so stepping through it never retains or releases a node: recursive-style
+ * loops over `head()` and `tail()` run at the speed of a pointer chase.
+ * It is valid only as long as the list it was borrowed from is alive and
+ * not assigned to, and can be promoted to an owning list with `toList()`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements
+ * @tparam Alloc the type of the allocator of the list
+ */
+template<typename A, typename Alloc>
+class ListRef final {
+    using L = List<A, Alloc>;
+    using Node = typename L::Node;
+
+public:
+    /**
+     * @brief Returns `true` if the referenced list contains no elements,
+     *        `false` otherwise.
+     *
+     * @return `true` if the referenced list contains no elements,
+     *         `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Returns the number of elements of the referenced list.
+     *
+     * @return the number of elements of the referenced list
+     */
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Returns the first element of the referenced list.
+     *
+     * @return the first element of the referenced list
+     * @throws std::out_of_range if the referenced list is empty
+     */
+    const A& head() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("head of empty list");
+        }
+        return *node_->head();
+    }
+
+    /**
+     * @brief Returns a reference to all elements of the referenced list
+     *        except the first one.
+     *
+     * @return a reference to all elements of the referenced list except
+     *         the first one
+     * @throws std::out_of_range if the referenced list is empty
+     */
+    ListRef tail() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("tail of empty list");
+        }
+        return ListRef(list_, node_->tail.get(), size_ - 1);
+    }
+
+    /**
+     * @brief Returns a pair consisting of the head of the referenced list
+     *        and a reference to its tail.
+     *
+     * @return a pair consisting of the head of the referenced list and a
+     *         reference to its tail
+     * @throws std::out_of_range if the referenced list is empty
+     */
+    std::pair<std::reference_wrapper<const A>, ListRef> uncons() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("uncons on empty list");
+        }
+        return std::make_pair(std::cref(*node_->head()), tail());
+    }
+
+    /**
+     * @brief Returns a reference to all elements of the referenced list
+     *        except the first `n` ones.
+     *
+     * @param n the number of elements to drop
+     * @return a reference to all elements of the referenced list except
+     *         the first `n` ones, which is empty if `n > size()`
+     */
+    ListRef drop(std::size_t n) const
+    {
+        auto m = node_;
+        const auto k = std::min(n, size_);
+        for (auto i = k; i > 0; --i) {
+            m = m->tail.get();
+        }
+        return ListRef(list_, m, size_ - k);
+    }
+
+    /**
+     * @brief Returns a reference to the longest suffix of the referenced
+     *        list whose first element does not satisfy the given predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return a reference to the longest suffix of the referenced list
+     *         whose first element does not satisfy the given predicate
+     */
+    template<typename Fn>
+    ListRef dropWhile(Fn p) const
+    {
+        auto m = node_;
+        auto s = size_;
+        for (; m->head() && p(*m->head()); --s, m = m->tail.get()) {}
+        return ListRef(list_, m, s);
+    }
+
+    /**
+     * Applies a function to each element of the referenced list.
+     *
+     * @param f the function to apply, for its side-effect,
+     *          to each element of the referenced list
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        for (auto m = node_; m->head(); m = m->tail.get()) {
+            f(*m->head());
+        }
+    }
+
+    /**
+     * @brief Returns an owning list with the elements of the referenced
+     *        list, sharing its nodes.
+     *
+     * @return an owning list with the elements of the referenced list
+     */
+    L toList() const
+    {
+        return L(size_, Node::retained(node_), list_->allocator());
+    }
+
+private:
+    friend class List<A, Alloc>;
+
+    ListRef(const L* list, const Node* node, std::size_t size) noexcept
+        : list_(list)
+        , node_(node)
+        , size_(size)
+    {}
+
+    // Only used for its allocator, when promoted with `toList()`.
+    const L* list_;
+    const Node* node_;
+    std::size_t size_;
+};
+
+/**
+ * @brief A borrowed view of consecutive elements of a list, yielded by
+ *        `List::sliding()` and `List::grouped()`.
+ *
+ * Like a `ListRef`, a window holds raw pointers into the list it was
+ * borrowed from, and is valid only as long as that list is alive and not
+ * assigned to. Its elements are copied only by `toList()`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements
+ * @tparam Alloc the type of the allocator of the list
+ */
+template<typename A, typename Alloc>
+class ListWindow final {
+    using L = List<A, Alloc>;
+    using Node = typename L::Node;
+
+public:
+    /**
+     * @brief Returns `true` if this window contains no elements, `false`
+     *        otherwise.
+     *
+     * @return `true` if this window contains no elements, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Returns the number of elements of this window.
+     *
+     * @return the number of elements of this window
+     */
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Returns the first element of this window.
+     *
+     * @return the first element of this window
+     * @throws std::out_of_range if this window is empty
+     */
+    const A& head() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("head of empty window");
+        }
+        return *first_->head();
+    }
+
+    /**
+     * @brief Returns an iterator to the first element of this window.
+     *
+     * @return an iterator to the first element of this window
+     */
+    typename L::StdIterator begin() const
+    {
+        return typename L::StdIterator(first_);
+    }
+
+    /**
+     * @brief Returns an iterator to the element following the last element
+     *        of this window.
+     *
+     * @return an iterator to the element following the last element of
+     *         this window
+     */
+    typename L::StdIterator end() const
+    {
+        return typename L::StdIterator(last_);
+    }
+
+    /**
+     * Applies a function to each element of this window.
+     *
+     * @param f the function to apply, for its side-effect,
+     *          to each element of this window
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        auto m = first_;
+        for (auto i = size_; i > 0; --i, m = m->tail.get()) {
+            f(*m->head());
+        }
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this window, going left to right.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this window, going left to right with the start value `z` on
+     *         the left, or `z` if this window is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) const
+    {
+        auto m = first_;
+        for (auto i = size_; i > 0; --i, m = m->tail.get()) {
+            z = op(std::move(z), *m->head());
+        }
+        return z;
+    }
+
+    /**
+     * @brief Returns an owning list with a copy of the elements of this
+     *        window.
+     *
+     * @return an owning list with the elements of this window
+     */
+    L toList() const
+    {
+        ListBuilder<A, Alloc> buf(list_->allocator());
+        foreach([&buf](const A& x) {
+            buf.append(x);
+        });
+        return buf.result();
+    }
+
+private:
+    friend class ListWindows<A, Alloc>;
+
+    ListWindow(const L* list, const Node* first, const Node* last, std::size_t size) noexcept
+        : list_(list)
+        , first_(first)
+        , last_(last)
+        , size_(size)
+    {}
+
+    // Only used for its allocator, when copied with `toList()`.
+    const L* list_;
+    const Node* first_;
+    // The node after the last element of this window.
+    const Node* last_;
+    std::size_t size_;
+};
+
+/**
+ * @brief The windows of a list, returned by `List::sliding()` and
+ *        `List::grouped()`.
+ *
+ * The windows are produced one at a time as they are iterated over, each
+ * from the previous one, without allocating. They are borrowed from the
+ * list, and are valid only as long as it is alive and not assigned to.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements
+ * @tparam Alloc the type of the allocator of the list
+ */
+template<typename A, typename Alloc>
+class ListWindows final {
+    using L = List<A, Alloc>;
+    using Node = typename L::Node;
+
+public:
+    class StdIterator;
+
+    /**
+     * @brief Returns `true` if there are no windows, which is the case only
+     *        for an empty list, `false` otherwise.
+     *
+     * @return `true` if there are no windows, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return list_->isEmpty();
+    }
+
+    /**
+     * @brief Returns the number of windows.
+     *
+     * @return the number of windows
+     */
+    std::size_t size() const
+    {
+        const auto total = list_->size();
+        if (total <= n_) {
+            return total == 0 ? 0 : 1;
+        }
+        // Each further window must start within the list, and the window
+        // before it must not have reached the end of the list.
+        const auto starts = (total - 1) / step_;
+        const auto unfinished = (total - n_ + step_ - 1) / step_;
+        return 1 + std::min(starts, unfinished);
+    }
+
+    /**
+     * @brief Returns an iterator to the first window.
+     *
+     * @return an iterator to the first window
+     */
+    StdIterator begin() const
+    {
+        if (list_->isEmpty()) {
+            return end();
+        }
+        const auto k = std::min(n_, list_->size());
+        auto last = list_->node_.get();
+        for (auto i = k; i > 0; --i) {
+            last = last->tail.get();
+        }
+        return StdIterator(*this, 0, ListWindow<A, Alloc>(list_, list_->node_.get(), last, k));
+    }
+
+    /**
+     * @brief Returns an iterator past the last window.
+     *
+     * @return an iterator past the last window
+     */
+    StdIterator end() const
+    {
+        return StdIterator();
+    }
+
+    /**
+     * Applies a function to each window.
+     *
+     * @param f the function to apply, for its side-effect, to each window
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        for (auto it = begin(); it != end(); ++it) {
+            f(*it);
+        }
+    }
+
+    /**
+     * @brief Returns the left folds of all windows, each computed from the
+     *        previous one.
+     *
+     * The fold of the first window applies `add` to `z` and each of its
+     * elements. Each further fold is derived from the previous one by
+     * applying `remove` to the elements that left the window, then `add` to
+     * those that entered it; this takes O(`step`) time, instead of O(`n`)
+     * for folding each window from scratch, so that e.g. the moving sums of
+     * `xs.sliding(n)` take O(1) time each. Windows that do not overlap the
+     * previous one are folded from `z` again.
+     *
+     * `remove` must undo `add`: `remove(add(b, x), x)` must be equivalent
+     * to `b`, as with subtraction for addition, whatever the elements
+     * added in between.
+     *
+     * @tparam B the type of the folds
+     * @tparam Add the type of the function adding an element
+     * @tparam Remove the type of the function removing an element
+     * @param z the fold of no elements
+     * @param add the function adding an element to a fold
+     * @param remove the function removing an element from a fold
+     * @return a list of the folds of the windows, in order
+     */
+    template<typename B, typename Add, typename Remove>
+    List<B, Rebind<Alloc, B>> scanLeft(B z, Add add, Remove remove) const
+    {
+        const Rebind<Alloc, B> alloc(list_->allocator());
+        ListBuilder<B, Rebind<Alloc, B>> acc(alloc);
+        const auto total = list_->size();
+        if (total == 0) {
+            return acc.result();
+        }
+
+        // The current window spans [s, e), from `first` to before `last`.
+        auto first = list_->node_.get();
+        auto last = first;
+        std::size_t s = 0;
+        std::size_t e = 0;
+        B x = z;
+        for (const auto k = std::min(n_, total); e < k; ++e, last = last->tail.get()) {
+            x = add(std::move(x), *last->head());
+        }
+        acc.append(x);
+        while (e < total && s + step_ < total) {
+            const auto ns = s + step_;
+            const auto ne = std::min(ns + n_, total);
+            if (ns >= e) {
+                for (; e < ns; ++e) {
+                    last = last->tail.get();
+                }
+                first = last;
+                s = ns;
+                x = z;
+            } else {
+                for (; s < ns; ++s, first = first->tail.get()) {
+                    x = remove(std::move(x), *first->head());
+                }
+            }
+            for (; e < ne; ++e, last = last->tail.get()) {
+                x = add(std::move(x), *last->head());
+            }
+            acc.append(x);
+        }
+        return acc.result();
+    }
+
+    /**
+     * @brief Returns a list of owning copies of the windows.
+     *
+     * @return a list of the elements of each window
+     */
+    List<L, Rebind<Alloc, L>> toList() const
+    {
+        const Rebind<Alloc, L> alloc(list_->allocator());
+        ListBuilder<L, Rebind<Alloc, L>> buf(alloc);
+        foreach([&buf](const ListWindow<A, Alloc>& w) {
+            buf.append(w.toList());
+        });
+        return buf.result();
+    }
+
+private:
+    friend class List<A, Alloc>;
+
+    ListWindows(const L* list, std::size_t n, std::size_t step) noexcept
+        : list_(list)
+        , n_(n)
+        , step_(step)
+    {}
+
+    const L* list_;
+    std::size_t n_;
+    std::size_t step_;
+};
+
+/**
+ * @brief A `ForwardIterator` over the windows of a list.
+ *
+ * Incrementing it moves both ends of the current window forward by at
+ * most `step` nodes.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ */
+template<typename A, typename Alloc>
+class ListWindows<A, Alloc>::StdIterator final {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ListWindow<A, Alloc>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    /**
+     * @brief Constructs an iterator past the last window, equal to `end()`.
+     */
+    StdIterator() noexcept
+        : windows_(nullptr, 0, 0)
+        , start_(0)
+        , window_(nullptr, nullptr, nullptr, 0)
+    {}
+
+    /**
+     * @brief Tests whether two iterators point to the same window.
+     *
+     * @return `true` if this iterator and `that` point to the same window,
+     *         `false` otherwise
+     */
+    bool operator==(const StdIterator& that) const
+    {
+        return window_.first_ == that.window_.first_;
+    }
+
+    /**
+     * @brief Tests whether two iterators point to different windows.
+     *
+     * @return `true` if this iterator and `that` point to different windows,
+     *         `false` otherwise
+     */
+    bool operator!=(const StdIterator& that) const
+    {
+        return !(*this == that);
+    }
+
+    /**
+     * @brief Increments this iterator and returns a reference to it.
+     *
+     * @return a reference to this iterator
+     */
+    StdIterator& operator++()
+    {
+        const auto total = windows_.list_->size();
+        const auto e = start_ + window_.size_;
+        const auto ns = start_ + windows_.step_;
+        if (e >= total || ns >= total) {
+            *this = StdIterator();
+            return *this;
+        }
+        const auto ne = std::min(ns + windows_.n_, total);
+        auto first = window_.first_;
+        for (auto i = windows_.step_; i > 0; --i) {
+            first = first->tail.get();
+        }
+        auto last = ns >= e ? first : window_.last_;
+        for (auto i = ns >= e ? ns : e; i < ne; ++i) {
+            last = last->tail.get();
+        }
+        window_ = ListWindow<A, Alloc>(window_.list_, first, last, ne - ns);
+        start_ = ns;
+        return *this;
+    }
+
+    /**
+     * @brief Increments this iterator and returns a copy of the original iterator.
+     *
+     * @return a copy of the original iterator
+     */
+    StdIterator operator++(int)
+    {
+        StdIterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    /**
+     * @brief Returns a reference to the window this iterator points to.
+     *
+     * @return a reference to the window this iterator points to
+     */
+    const ListWindow<A, Alloc>& operator*() const
+    {
+        return window_;
+    }
+
+    /**
+     * @brief Returns a pointer to the window this iterator points to.
+     *
+     * @return a pointer to the window this iterator points to
+     */
+    const ListWindow<A, Alloc>* operator->() const
+    {
+        return &window_;
+    }
+
+private:
+    friend class ListWindows;
+
+    StdIterator(const ListWindows& windows, std::size_t start, ListWindow<A, Alloc> window) noexcept
+        : windows_(windows)
+        , start_(start)
+        , window_(window)
+    {}
+
+    ListWindows windows_;
+    // The position of the first element of `window_` in the list.
+    std::size_t start_;
+    // Empty, with a null `first_`, past the last window.
+    ListWindow<A, Alloc> window_;
+};
+
+/**
+ * @brief A list with an index of its nodes, for repeated access by
+ *        position, returned by `List::indexed()`.
+ *
+ * The index points to every `detail::indexStride`-th node of the list, so
+ * that `operator[]`, `drop()` and `slice()` jump to the nearest indexed node
+ * before the target, then follow fewer than `indexStride` node pointers,
+ * instead of walking from the head of the list. It is built as far as the
+ * farthest position accessed so far, so that each node is walked past
+ * only once in all; loops accessing the list by position thus take O(n)
+ * time instead of O(n^2). The index holds one pointer per `indexStride`
+ * elements.
+ *
+ * An indexed list owns a reference to its list, and the lists it returns
+ * share its nodes. Like a `ListBuilder`, it must not be used by several
+ * threads at a time, since accessing it may extend the index.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements
+ * @tparam Alloc the type of the allocator of the list
+ */
+template<typename A, typename Alloc>
+class IndexedList final {
+    using L = List<A, Alloc>;
+    using Node = typename L::Node;
+
+public:
+    /**
+     * @brief Returns the indexed list.
+     *
+     * @return the indexed list
+     */
+    const L& list() const
+    {
+        return xs_;
+    }
+
+    /**
+     * @brief Returns `true` if the indexed list contains no elements,
+     *        `false` otherwise.
+     *
+     * @return `true` if the indexed list contains no elements, `false`
+     *         otherwise
+     */
+    bool isEmpty() const
+    {
+        return xs_.isEmpty();
+    }
+
+    /**
+     * @brief Returns the number of elements of the indexed list.
+     *
+     * @return the number of elements of the indexed list
+     */
+    std::size_t size() const
+    {
+        return xs_.size();
+    }
+
+    /**
+     * @brief Returns the element at the specified position of the indexed
+     *        list.
+     *
+     * @param index index of the element to return
+     * @return the element at the specified position of the indexed list
+     * @throws std::out_of_range if `index` is out of range (`index >= size()`)
+     */
+    const A& operator[](std::size_t index) const
+    {
+        if (index >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+        return *nodeAt(index)->head();
+    }
+
+    /**
+     * @brief Returns all elements of the indexed list except the first `n`
+     *        ones, sharing its nodes.
+     *
+     * @param n the number of elements to drop
+     * @return a list consisting of all elements of the indexed list except
+     *         the first `n` ones, or an empty list if `n > size()`
+     */
+    L drop(std::size_t n) const
+    {
+        if (n >= size()) {
+            return L(xs_.allocator());
+        }
+        return L(size() - n, Node::retained(nodeAt(n)), xs_.allocator());
+    }
+
+    /**
+     * @brief Returns a list consisting of all elements of the indexed list
+     *        starting at position `from` and extending up until position
+     *        `until`.
+     *
+     * Finding the start of the slice takes O(1) time, and taking its
+     * elements O(`until - from`) time, as with `List::take()`.
+     *
+     * @param from the index of the starting position (included)
+     * @param until the index of the ending position (excluded)
+     * @return a list consisting of all elements of the indexed list starting
+     *         at position `from` and extending up until position `until`,
+     *         or an empty list if `from >= until` or `from >= size()`
+     */
+    L slice(std::size_t from, std::size_t until) const
+    {
+        if (from >= until) {
+            return L(xs_.allocator());
+        }
+        return drop(from).take(until - from);
+    }
+
+private:
+    friend class List<A, Alloc>;
+
+    explicit IndexedList(L xs) noexcept : xs_(std::move(xs)) {}
+
+    // Returns the node at position `index`, which must be in range,
+    // extending the index up to it if needed.
+    const Node* nodeAt(std::size_t index) const
+    {
+        const auto k = index / indexStride;
+        if (k >= marks_.size()) {
+            if (marks_.empty()) {
+                marks_.reserve((size() - 1) / indexStride + 1);
+                stats::onBuffer(marks_.capacity() * sizeof (const Node*));
+                marks_.push_back(xs_.node_.get());
+            }
+            auto n = marks_.back();
+            while (marks_.size() <= k) {
+                for (auto i = indexStride; i > 0; --i) {
+                    n = n->tail.get();
+                }
+                marks_.push_back(n);
+            }
+        }
+        auto n = marks_[k];
+        for (auto i = index % indexStride; i > 0; --i) {
+            n = n->tail.get();
+        }
+        return n;
+    }
+
+    L xs_;
+    // The nodes at positions 0, `indexStride`, `2 * indexStride`, and so on,
+    // as far as they have been reached.
+    mutable std::vector<const Node*> marks_;
+};
+
+}  // namespace gungnir
+
+namespace std {
+
+/**
+ * @brief Hashes a `List` with `List::hash()`, so that lists can be used as
+ *        keys of hash tables.
+ */
+template<typename A, typename Alloc>
+struct hash<gungnir::List<A, Alloc>> {
+    std::size_t operator()(const gungnir::List<A, Alloc>& xs) const
+    {
+        return xs.hash();
+    }
+};
+
+}  // namespace std
+
+#include "gungnir/ListView.hpp"
+
+// With `GUNGNIR_EXTERN_TEMPLATES` defined, lists of the most common element
+// types are not instantiated in every translation unit, but linked from the
+// `gungnir_list` library built from `src/List.cpp`, which must be built with
+// the same `GUNGNIR_*` configuration macros. Member templates, such as `map`
+// and `foldLeft`, are still instantiated where they are used.
+#ifdef GUNGNIR_EXTERN_TEMPLATES
+namespace gungnir {
+
+extern template class List<int>;
+extern template class List<long>;
+extern template class List<double>;
+extern template class ListBuilder<int>;
+extern template class ListBuilder<long>;
+extern template class ListBuilder<double>;
+
 }  // namespace gungnir
+#endif
 
 #endif  // GUNGNIR_LIST_HPP
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/ListStats.hpp
+ * Opt-in allocation and reference counting instrumentation for `List`.
+ *
+ * Instrumentation is compiled in only if `GUNGNIR_LIST_STATS` is defined
+ * (consistently, in every translation unit) before any Gungnir header is
+ * included; otherwise all hooks are empty and `listStats()` always reports
+ * zeros. Counters are kept per thread, so the difference between two
+ * snapshots taken around a call is exactly what that call did:
+ *
+ *     const auto before = gungnir::listStats();
+ *     const auto ys = xs.flatMap(f);
+ *     const auto cost = gungnir::listStats() - before;
+ */
+
+#ifndef GUNGNIR_LIST_STATS_HPP
+#define GUNGNIR_LIST_STATS_HPP
+
+#include <cstddef>
+
+namespace gungnir {
+
+/**
+ * @brief Counters describing the work done by `List` operations.
+ *
+ * @since 1.0
+ */
+struct ListStats final {
+    /** Number of nodes allocated, including cells. */
+    std::size_t nodeAllocations = 0;
+
+    /** Number of nodes deallocated, including cells. */
+    std::size_t nodeDeallocations = 0;
+
+    /** Number of cells (nodes holding a newly constructed element) allocated. */
+    std::size_t cellAllocations = 0;
+
+    /** Number of cells deallocated. */
+    std::size_t cellDeallocations = 0;
+
+    /** Number of reference count increments on nodes and shared elements. */
+    std::size_t refcountIncrements = 0;
+
+    /** Number of temporary buffers allocated by list operations. */
+    std::size_t bufferAllocations = 0;
+
+    /** Total size in bytes of the temporary buffers. */
+    std::size_t bufferBytes = 0;
+
+    /**
+     * @brief Returns the counter-wise difference between this and `that`.
+     *
+     * @param that an earlier snapshot
+     * @return the counters accumulated since `that` was taken
+     */
+    ListStats operator-(const ListStats& that) const
+    {
+        ListStats d;
+        d.nodeAllocations = nodeAllocations - that.nodeAllocations;
+        d.nodeDeallocations = nodeDeallocations - that.nodeDeallocations;
+        d.cellAllocations = cellAllocations - that.cellAllocations;
+        d.cellDeallocations = cellDeallocations - that.cellDeallocations;
+        d.refcountIncrements = refcountIncrements - that.refcountIncrements;
+        d.bufferAllocations = bufferAllocations - that.bufferAllocations;
+        d.bufferBytes = bufferBytes - that.bufferBytes;
+        return d;
+    }
+};
+
+/// @cond GUNGNIR_PRIVATE
+namespace detail {
+
+namespace stats {
+
+#ifdef GUNGNIR_LIST_STATS
+
+inline ListStats& current()
+{
+    static thread_local ListStats s;
+    return s;
+}
+
+inline void onNodeAllocate() { ++current().nodeAllocations; }
+inline void onNodeDeallocate() { ++current().nodeDeallocations; }
+
+inline void onCellAllocate()
+{
+    ++current().nodeAllocations;
+    ++current().cellAllocations;
+}
+
+inline void onCellDeallocate()
+{
+    ++current().nodeDeallocations;
+    ++current().cellDeallocations;
+}
+
+inline void onRetain() { ++current().refcountIncrements; }
+
+inline void onBuffer(std::size_t bytes)
+{
+    ++current().bufferAllocations;
+    current().bufferBytes += bytes;
+}
+
+#else
+
+inline void onNodeAllocate() {}
+inline void onNodeDeallocate() {}
+inline void onCellAllocate() {}
+inline void onCellDeallocate() {}
+inline void onRetain() {}
+inline void onBuffer(std::size_t) {}
+
+#endif  // GUNGNIR_LIST_STATS
+
+}  // namespace stats
+
+}  // namespace detail
+/// @endcond
+
+/**
+ * @brief Returns the counters accumulated by `List` operations on the
+ *        calling thread.
+ *
+ * All counters are zero unless `GUNGNIR_LIST_STATS` is defined.
+ *
+ * @return a snapshot of the calling thread's counters
+ */
+inline ListStats listStats()
+{
+#ifdef GUNGNIR_LIST_STATS
+    return detail::stats::current();
+#else
+    return ListStats();
+#endif
+}
+
+/**
+ * @brief Resets the counters of the calling thread to zero.
+ */
+inline void resetListStats()
+{
+#ifdef GUNGNIR_LIST_STATS
+    detail::stats::current() = ListStats();
+#endif
+}
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_LIST_STATS_HPP
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/ListTrace.hpp
+ * Opt-in tracing of the costliest `List` operations.
+ *
+ * Tracing is compiled in only if `GUNGNIR_LIST_TRACE` is defined
+ * (consistently, in every translation unit) before any Gungnir header is
+ * included; otherwise no operation is timed and the trace is always empty.
+ * When it is, every call of `map`, `flatMap` and `sorted`, including their
+ * parallel overloads, is recorded with the sizes of its input and output
+ * and how long it took. Each thread records its calls into a ring buffer of
+ * its own, without locking, which keeps its last
+ * `GUNGNIR_LIST_TRACE_CAPACITY` (4096 by default) events:
+ *
+ *     for (const auto& op : gungnir::listTraceSummary()) {
+ *         std::cout << op.name << ": " << op.count << " calls, "
+ *                   << op.totalNanos / op.count << " ns per call\n";
+ *     }
+ *     std::ofstream out("trace.json");
+ *     gungnir::writeChromeTrace(out);  // open in chrome://tracing or Perfetto
+ */
+
+#ifndef GUNGNIR_LIST_TRACE_HPP
+#define GUNGNIR_LIST_TRACE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+#include "gungnir/detail/trace.hpp"
+
+namespace gungnir {
+
+/**
+ * @brief A traced call of a `List` operation.
+ *
+ * @since 1.0
+ */
+struct ListTraceEvent final {
+    /** The name of the operation, such as `"List::map"`. */
+    const char* name;
+
+    /** The size of the list the operation was called on. */
+    std::size_t inputSize;
+
+    /** The size of the list the operation returned. */
+    std::size_t outputSize;
+
+    /** When the call started, in nanoseconds of `std::chrono::steady_clock`. */
+    std::uint64_t start;
+
+    /** How long the call took, in nanoseconds. */
+    std::uint64_t duration;
+
+    /** The thread that made the call, numbered from 0 in order of their first traced call. */
+    std::uint32_t thread;
+};
+
+/**
+ * @brief The traced calls of one `List` operation, aggregated.
+ *
+ * @since 1.0
+ */
+struct ListTraceSummary final {
+    /** The name of the operation. */
+    const char* name = nullptr;
+
+    /** The number of calls. */
+    std::size_t count = 0;
+
+    /** The total size of the lists the operation was called on. */
+    std::size_t inputElements = 0;
+
+    /** The total size of the lists the operation returned. */
+    std::size_t outputElements = 0;
+
+    /** The total duration of the calls, in nanoseconds. */
+    std::uint64_t totalNanos = 0;
+
+    /**
+     * The number of calls by the size of their input: `sizeHistogram[0]`
+     * counts calls on empty lists, and `sizeHistogram[i]` for `i > 0`
+     * those on lists of `2^(i-1)` to `2^i - 1` elements.
+     */
+    std::size_t sizeHistogram[std::numeric_limits<std::size_t>::digits + 1] = {};
+};
+
+/**
+ * @brief Returns the traced calls retained from all threads, in the order
+ *        they started.
+ *
+ * The trace is always empty unless `GUNGNIR_LIST_TRACE` is defined.
+ *
+ * @return the traced calls
+ */
+inline std::vector<ListTraceEvent> listTrace()
+{
+    std::vector<ListTraceEvent> events;
+#ifdef GUNGNIR_LIST_TRACE
+    for (const auto& e : detail::trace::registry().events()) {
+        const ListTraceEvent x = { e.name, e.inputSize, e.outputSize, e.start, e.duration, e.thread };
+        events.push_back(x);
+    }
+    std::sort(events.begin(), events.end(), [](const ListTraceEvent& x, const ListTraceEvent& y) {
+        return x.start < y.start;
+    });
+#endif
+    return events;
+}
+
+/**
+ * @brief Returns the traced calls retained from all threads, aggregated
+ *        by operation, in descending order of their total duration.
+ *
+ * @return the traced calls, aggregated by operation
+ */
+inline std::vector<ListTraceSummary> listTraceSummary()
+{
+    std::vector<ListTraceSummary> ops;
+    for (const auto& e : listTrace()) {
+        auto it = std::find_if(ops.begin(), ops.end(), [&e](const ListTraceSummary& op) {
+            return std::strcmp(op.name, e.name) == 0;
+        });
+        if (it == ops.end()) {
+            ops.emplace_back();
+            it = ops.end() - 1;
+            it->name = e.name;
+        }
+        ++it->count;
+        it->inputElements += e.inputSize;
+        it->outputElements += e.outputSize;
+        it->totalNanos += e.duration;
+        std::size_t bucket = 0;
+        for (auto n = e.inputSize; n != 0; n >>= 1) {
+            ++bucket;
+        }
+        ++it->sizeHistogram[bucket];
+    }
+    std::sort(ops.begin(), ops.end(), [](const ListTraceSummary& x, const ListTraceSummary& y) {
+        return x.totalNanos > y.totalNanos;
+    });
+    return ops;
+}
+
+/**
+ * @brief Writes the traced calls retained from all threads in the Trace
+ *        Event Format, as read by `chrome://tracing` and Perfetto.
+ *
+ * Each call is a complete ("X") event of the thread that made it, with
+ * the sizes of its input and output as arguments.
+ *
+ * @param out the stream to write to
+ */
+inline void writeChromeTrace(std::ostream& out)
+{
+    const auto events = listTrace();
+    const auto origin = events.empty() ? 0 : events.front().start;
+    const auto micros = [&out](std::uint64_t ns) {
+        out << ns / 1000 << '.';
+        const auto frac = ns % 1000;
+        out << (frac < 100 ? "0" : "") << (frac < 10 ? "0" : "") << frac;
+    };
+
+    out << "{\"traceEvents\":[";
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const auto& e = events[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "{\"name\":\"" << e.name << "\",\"cat\":\"gungnir\",\"ph\":\"X\",\"ts\":";
+        micros(e.start - origin);
+        out << ",\"dur\":";
+        micros(e.duration);
+        out << ",\"pid\":0,\"tid\":" << e.thread
+            << ",\"args\":{\"inputSize\":" << e.inputSize
+            << ",\"outputSize\":" << e.outputSize << "}}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+/**
+ * @brief Discards the traced calls of all threads.
+ *
+ * The rings of threads that have exited are freed.
+ */
+inline void resetListTrace()
+{
+#ifdef GUNGNIR_LIST_TRACE
+    detail::trace::registry().clear();
+#endif
+}
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_LIST_TRACE_HPP
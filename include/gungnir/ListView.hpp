@@ -0,0 +1,673 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GUNGNIR_LIST_VIEW_HPP
+#define GUNGNIR_LIST_VIEW_HPP
+
+#include <cstddef>
+#include <utility>
+
+#include "gungnir/List.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+namespace detail {
+
+namespace stage {
+
+// A stage of a view pipeline is a generator: `run(k)` feeds each of its
+// elements to the sink `k` in order, and stops as soon as `k` returns
+// `false`. Stages wrap the sink of the next stage, so that a whole pipeline
+// is fused into a single loop over the source list.
+
+template<typename A, typename Alloc>
+struct Source {
+    using Elem = A;
+    using Allocator = Alloc;
+
+    Alloc allocator() const { return xs.allocator(); }
+
+    template<typename Sink>
+    void run(Sink& k) const
+    {
+        for (const auto& x : xs) {
+            if (!k(x)) {
+                return;
+            }
+        }
+    }
+
+    List<A, Alloc> xs;
+};
+
+template<typename G, typename Fn>
+struct Map {
+    using Elem = Decay<Ret<Fn, typename G::Elem>>;
+    using Allocator = typename G::Allocator;
+
+    template<typename Sink>
+    struct S {
+        template<typename X>
+        bool operator()(X&& x) { return k(f(std::forward<X>(x))); }
+
+        const Fn& f;
+        Sink& k;
+    };
+
+    Allocator allocator() const { return g.allocator(); }
+
+    template<typename Sink>
+    void run(Sink& k) const
+    {
+        S<Sink> s{f, k};
+        g.run(s);
+    }
+
+    G g;
+    Fn f;
+};
+
+template<typename G, typename Fn, bool Keep>
+struct Filter {
+    using Elem = typename G::Elem;
+    using Allocator = typename G::Allocator;
+
+    template<typename Sink>
+    struct S {
+        template<typename X>
+        bool operator()(X&& x)
+        {
+            return static_cast<bool>(p(x)) != Keep || k(std::forward<X>(x));
+        }
+
+        const Fn& p;
+        Sink& k;
+    };
+
+    Allocator allocator() const { return g.allocator(); }
+
+    template<typename Sink>
+    void run(Sink& k) const
+    {
+        S<Sink> s{p, k};
+        g.run(s);
+    }
+
+    G g;
+    Fn p;
+};
+
+template<typename G, typename Fn>
+struct TakeWhile {
+    using Elem = typename G::Elem;
+    using Allocator = typename G::Allocator;
+
+    template<typename Sink>
+    struct S {
+        template<typename X>
+        bool operator()(X&& x) { return p(x) && k(std::forward<X>(x)); }
+
+        const Fn& p;
+        Sink& k;
+    };
+
+    Allocator allocator() const { return g.allocator(); }
+
+    template<typename Sink>
+    void run(Sink& k) const
+    {
+        S<Sink> s{p, k};
+        g.run(s);
+    }
+
+    G g;
+    Fn p;
+};
+
+template<typename G, typename Fn>
+struct DropWhile {
+    using Elem = typename G::Elem;
+    using Allocator = typename G::Allocator;
+
+    template<typename Sink>
+    struct S {
+        template<typename X>
+        bool operator()(X&& x)
+        {
+            if (dropping && p(x)) {
+                return true;
+            }
+            dropping = false;
+            return k(std::forward<X>(x));
+        }
+
+        const Fn& p;
+        Sink& k;
+        bool dropping;
+    };
+
+    Allocator allocator() const { return g.allocator(); }
+
+    template<typename Sink>
+    void run(Sink& k) const
+    {
+        S<Sink> s{p, k, true};
+        g.run(s);
+    }
+
+    G g;
+    Fn p;
+};
+
+template<typename G>
+struct Take {
+    using Elem = typename G::Elem;
+    using Allocator = typename G::Allocator;
+
+    template<typename Sink>
+    struct S {
+        template<typename X>
+        bool operator()(X&& x)
+        {
+            const bool more = k(std::forward<X>(x));
+            return --n > 0 && more;
+        }
+
+        Sink& k;
+        std::size_t n;
+    };
+
+    Allocator allocator() const { return g.allocator(); }
+
+    template<typename Sink>
+    void run(Sink& k) const
+    {
+        if (n > 0) {
+            S<Sink> s{k, n};
+            g.run(s);
+        }
+    }
+
+    G g;
+    std::size_t n;
+};
+
+template<typename G>
+struct Drop {
+    using Elem = typename G::Elem;
+    using Allocator = typename G::Allocator;
+
+    template<typename Sink>
+    struct S {
+        template<typename X>
+        bool operator()(X&& x)
+        {
+            if (n > 0) {
+                --n;
+                return true;
+            }
+            return k(std::forward<X>(x));
+        }
+
+        Sink& k;
+        std::size_t n;
+    };
+
+    Allocator allocator() const { return g.allocator(); }
+
+    template<typename Sink>
+    void run(Sink& k) const
+    {
+        S<Sink> s{k, n};
+        g.run(s);
+    }
+
+    G g;
+    std::size_t n;
+};
+
+template<typename G, typename Fn>
+struct FlatMap {
+    using Elem = Decay<typename HKT<Ret<Fn, typename G::Elem>>::L>;
+    using Allocator = typename G::Allocator;
+
+    template<typename Sink>
+    struct S {
+        template<typename X>
+        bool operator()(X&& x)
+        {
+            const auto ys = f(std::forward<X>(x));
+            for (const auto& y : ys) {
+                if (!k(y)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        const Fn& f;
+        Sink& k;
+    };
+
+    Allocator allocator() const { return g.allocator(); }
+
+    template<typename Sink>
+    void run(Sink& k) const
+    {
+        S<Sink> s{f, k};
+        g.run(s);
+    }
+
+    G g;
+    Fn f;
+};
+
+template<typename G, typename B, typename BAlloc>
+struct Zip {
+    using Elem = std::pair<typename G::Elem, B>;
+    using Allocator = typename G::Allocator;
+    using It = typename List<B, BAlloc>::StdIterator;
+
+    template<typename Sink>
+    struct S {
+        template<typename X>
+        bool operator()(X&& x)
+        {
+            const bool more = k(Elem(std::forward<X>(x), *it));
+            return ++it != end && more;
+        }
+
+        Sink& k;
+        It it;
+        It end;
+    };
+
+    Allocator allocator() const { return g.allocator(); }
+
+    template<typename Sink>
+    void run(Sink& k) const
+    {
+        if (!ys.isEmpty()) {
+            S<Sink> s{k, ys.begin(), ys.end()};
+            g.run(s);
+        }
+    }
+
+    G g;
+    List<B, BAlloc> ys;
+};
+
+// Terminal sinks.
+
+template<typename Builder>
+struct BuildSink {
+    template<typename X>
+    bool operator()(X&& x)
+    {
+        buf.append(std::forward<X>(x));
+        return true;
+    }
+
+    Builder& buf;
+};
+
+template<typename B, typename Fn>
+struct FoldSink {
+    template<typename X>
+    bool operator()(X&& x)
+    {
+        z = op(std::move(z), std::forward<X>(x));
+        return true;
+    }
+
+    B& z;
+    const Fn& op;
+};
+
+template<typename Fn>
+struct ForeachSink {
+    template<typename X>
+    bool operator()(X&& x)
+    {
+        f(std::forward<X>(x));
+        return true;
+    }
+
+    const Fn& f;
+};
+
+template<typename Fn>
+struct CountSink {
+    template<typename X>
+    bool operator()(X&& x)
+    {
+        if (p(std::forward<X>(x))) {
+            ++num;
+        }
+        return true;
+    }
+
+    const Fn& p;
+    std::size_t num;
+};
+
+template<typename Fn, bool Expected>
+struct FindSink {
+    template<typename X>
+    bool operator()(X&& x)
+    {
+        found = static_cast<bool>(p(std::forward<X>(x))) == Expected;
+        return !found;
+    }
+
+    const Fn& p;
+    bool found;
+};
+
+}  // namespace stage
+
+}  // namespace detail
+
+/**
+ * @brief A lazy view of a list.
+ *
+ * The transformations of a view are not applied until a terminal operation
+ * (e.g., `toList()` or `foldLeft()`) is invoked. The whole chain of
+ * transformations is then fused into a single pass over the underlying
+ * list, and only the final result is allocated. Terminal operations stop
+ * traversing the list as soon as the result is known.
+ *
+ * Views are obtained from `List::view()`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam G the type of the composed transformations
+ */
+template<typename G>
+class ListView final {
+public:
+    /** @brief The element type of this view. */
+    using Elem = typename G::Elem;
+
+    /**
+     * @brief Constructs a view from the given transformations.
+     *
+     * @param g the composed transformations
+     */
+    explicit ListView(G g) noexcept : g_(std::move(g)) {}
+
+    /**
+     * @brief Returns a view that applies a function to each element of
+     *        this view.
+     *
+     * @tparam Fn the type of the function
+     * @param f the function
+     * @return a view that applies `f` to each element of this view
+     */
+    template<typename Fn>
+    ListView<stage::Map<G, Fn>> map(Fn f) const
+    {
+        return ListView<stage::Map<G, Fn>>({g_, std::move(f)});
+    }
+
+    /**
+     * @brief Returns a view of the elements of this view that satisfy
+     *        a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return a view of the elements of this view that satisfy `p`
+     */
+    template<typename Fn>
+    ListView<stage::Filter<G, Fn, true>> filter(Fn p) const
+    {
+        return ListView<stage::Filter<G, Fn, true>>({g_, std::move(p)});
+    }
+
+    /**
+     * @brief Returns a view of the elements of this view that violate
+     *        a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return a view of the elements of this view that violate `p`
+     */
+    template<typename Fn>
+    ListView<stage::Filter<G, Fn, false>> filterNot(Fn p) const
+    {
+        return ListView<stage::Filter<G, Fn, false>>({g_, std::move(p)});
+    }
+
+    /**
+     * @brief Returns a view of the longest prefix of this view whose
+     *        elements satisfy a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return a view of the longest prefix of this view whose elements
+     *         satisfy `p`
+     */
+    template<typename Fn>
+    ListView<stage::TakeWhile<G, Fn>> takeWhile(Fn p) const
+    {
+        return ListView<stage::TakeWhile<G, Fn>>({g_, std::move(p)});
+    }
+
+    /**
+     * @brief Returns a view of the longest suffix of this view whose
+     *        first element does not satisfy a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return a view of the longest suffix of this view whose first element
+     *         does not satisfy `p`
+     */
+    template<typename Fn>
+    ListView<stage::DropWhile<G, Fn>> dropWhile(Fn p) const
+    {
+        return ListView<stage::DropWhile<G, Fn>>({g_, std::move(p)});
+    }
+
+    /**
+     * @brief Returns a view of the first `n` elements of this view.
+     *
+     * @param n the number of elements to take
+     * @return a view of the first `n` elements of this view
+     */
+    ListView<stage::Take<G>> take(std::size_t n) const
+    {
+        return ListView<stage::Take<G>>({g_, n});
+    }
+
+    /**
+     * @brief Returns a view of all elements of this view except the first
+     *        `n` ones.
+     *
+     * @param n the number of elements to drop
+     * @return a view of all elements of this view except the first `n` ones
+     */
+    ListView<stage::Drop<G>> drop(std::size_t n) const
+    {
+        return ListView<stage::Drop<G>>({g_, n});
+    }
+
+    /**
+     * @brief Returns a view that applies a list-returning function to each
+     *        element of this view and concatenates the results.
+     *
+     * @tparam Fn the type of the function
+     * @param f the function
+     * @return a view of the concatenation of the lists returned by `f`
+     */
+    template<typename Fn>
+    ListView<stage::FlatMap<G, Fn>> flatMap(Fn f) const
+    {
+        return ListView<stage::FlatMap<G, Fn>>({g_, std::move(f)});
+    }
+
+    /**
+     * @brief Returns a view that pairs up the elements of this view with
+     *        the corresponding elements of `that`.
+     *
+     * @tparam B the element type of `that`
+     * @tparam BAlloc the allocator type of `that`
+     * @param that the list providing the second element of each pair
+     * @return a view of pairs of corresponding elements
+     */
+    template<typename B, typename BAlloc>
+    ListView<stage::Zip<G, B, BAlloc>> zip(List<B, BAlloc> that) const
+    {
+        return ListView<stage::Zip<G, B, BAlloc>>({g_, std::move(that)});
+    }
+
+    /**
+     * @brief Returns a list of the elements of this view.
+     *
+     * @return a list of the elements of this view
+     */
+    List<Elem, Rebind<typename G::Allocator, Elem>> toList() const
+    {
+        using EAlloc = Rebind<typename G::Allocator, Elem>;
+
+        const EAlloc alloc(g_.allocator());
+        ListBuilder<Elem, EAlloc> buf(alloc);
+        stage::BuildSink<ListBuilder<Elem, EAlloc>> k{buf};
+        g_.run(k);
+        return buf.result();
+    }
+
+    /**
+     * @brief Applies a function to each element of this view.
+     *
+     * @tparam Fn the type of the function
+     * @param f the function to apply, for its side-effect, to each element
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        stage::ForeachSink<Fn> k{f};
+        g_.run(k);
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this view, going left to right.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this view, going left to right with the start value `z`
+     *         on the left, or `z` if this view is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) const
+    {
+        stage::FoldSink<B, Fn> k{z, op};
+        g_.run(k);
+        return z;
+    }
+
+    /**
+     * @brief Returns the number of elements of this view.
+     *
+     * @return the number of elements of this view
+     */
+    std::size_t count() const
+    {
+        return count([](const Elem&) { return true; });
+    }
+
+    /**
+     * @brief Returns the number of elements of this view that satisfy
+     *        the given predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return the number of elements of this view that satisfy `p`
+     */
+    template<typename Fn>
+    std::size_t count(Fn p) const
+    {
+        stage::CountSink<Fn> k{p, 0};
+        g_.run(k);
+        return k.num;
+    }
+
+    /**
+     * @brief Returns `true` if at least one element of this view satisfies
+     *        the given predicate, `false` otherwise.
+     *
+     * Stops at the first element that satisfies the predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return `true` if at least one element of this view satisfies `p`,
+     *         `false` otherwise
+     */
+    template<typename Fn>
+    bool exists(Fn p) const
+    {
+        stage::FindSink<Fn, true> k{p, false};
+        g_.run(k);
+        return k.found;
+    }
+
+    /**
+     * @brief Returns `true` if this view is empty or the given predicate
+     *        holds for all elements of this view, `false` otherwise.
+     *
+     * Stops at the first element that violates the predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return `true` if this view is empty or `p` holds for all elements of
+     *         this view, `false` otherwise
+     */
+    template<typename Fn>
+    bool forall(Fn p) const
+    {
+        stage::FindSink<Fn, false> k{p, false};
+        g_.run(k);
+        return !k.found;
+    }
+
+    /**
+     * @brief Returns the sum of all elements of this view,
+     *        or 0 if this view is empty.
+     *
+     * @return the sum of all elements of this view, or 0 if this view is empty
+     */
+    Elem sum() const
+    {
+        return foldLeft(Elem(0), [](Elem acc, const Elem& x) { return acc + x; });
+    }
+
+private:
+    G g_;
+};
+
+template<typename A, typename Alloc>
+ListView<stage::Source<A, Alloc>> List<A, Alloc>::view() const
+{
+    return ListView<stage::Source<A, Alloc>>({*this});
+}
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_LIST_VIEW_HPP
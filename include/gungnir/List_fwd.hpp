@@ -0,0 +1,57 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/List_fwd.hpp
+ * Forward declarations of `List` and its companions.
+ *
+ * Headers that only mention lists in declarations, such as functions
+ * taking or returning them, can include this instead of `List.hpp`, which
+ * is expensive to compile. Translation units calling members of a list
+ * still need `List.hpp`.
+ */
+
+#ifndef GUNGNIR_LIST_FWD_HPP
+#define GUNGNIR_LIST_FWD_HPP
+
+#include <memory>
+
+namespace gungnir {
+
+template<typename A, typename Alloc = std::allocator<A>>
+class List;
+
+template<typename A, typename Alloc = std::allocator<A>>
+class ListBuilder;
+
+template<typename A, typename Alloc = std::allocator<A>>
+class TransientList;
+
+template<typename A, typename Alloc = std::allocator<A>>
+class ListRef;
+
+template<typename A, typename Alloc = std::allocator<A>>
+class ListWindow;
+
+template<typename A, typename Alloc = std::allocator<A>>
+class ListWindows;
+
+template<typename A, typename Alloc = std::allocator<A>>
+class IndexedList;
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_LIST_FWD_HPP
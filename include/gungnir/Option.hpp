@@ -17,6 +17,9 @@
 #ifndef GUNGNIR_OPTION_HPP
 #define GUNGNIR_OPTION_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <type_traits>
 
@@ -27,8 +30,103 @@ namespace gungnir {
 template<typename T> class Option;
 template<typename T> class UnownedOption;
 
+/**
+ * Traits describing a spare bit pattern, or niche, of `T` that `Option<T>`
+ * can use to represent emptiness instead of a separate flag, which makes
+ * `sizeof (Option<T>) == sizeof (T)`.
+ *
+ * The primary template describes types without a niche. A specialization
+ * for a type with one must provide
+ *
+ * - `static constexpr bool value = true;`
+ * - `static void markEmpty(void* p) noexcept`, which writes the niche into
+ *   `p`, uninitialized storage suitable for a `T`, and
+ * - `static bool isEmpty(const void* p) noexcept`, which tests whether `p`,
+ *   holding either a `T` or the niche, holds the niche.
+ *
+ * No live `T` may ever have the niche as its object representation.
+ * Specializations are provided for pointers, `float` and `double`,
+ * `UnownedOption` and `List`; `EnumNiche` helps specializing it for enums.
+ *
+ * @tparam T the type of the contained value
+ */
+template<typename T, typename = void>
+struct OptionNiche {
+    static constexpr bool value = false;
+};
+
 namespace detail {
 
+// A niche where the `Bits` at byte offset `Off` of a value are `Mark`.
+template<typename Bits, Bits Mark, std::size_t Off = 0>
+struct BitNiche {
+    static constexpr bool value = true;
+
+    static void markEmpty(void* p) noexcept
+    {
+        const Bits mark = Mark;
+        std::memcpy(static_cast<char*>(p) + Off, &mark, sizeof mark);
+    }
+
+    static bool isEmpty(const void* p) noexcept
+    {
+        Bits bits;
+        std::memcpy(&bits, static_cast<const char*>(p) + Off, sizeof bits);
+        return bits == Mark;
+    }
+};
+
+// A niche in a pointer at byte offset `Off`: no object lives at the last
+// address, which is its all-ones pattern.
+template<std::size_t Off = 0>
+using PointerNiche = BitNiche<std::uintptr_t, ~std::uintptr_t(0), Off>;
+
+}  // namespace detail
+
+/**
+ * An `OptionNiche` implementation for an enum with an unused enumerator
+ * value, e.g.
+ * `template<> struct OptionNiche<Color> : EnumNiche<Color, Color(-1)> {};`.
+ *
+ * @tparam E the enum type
+ * @tparam Mark a value that no `E` held in an `Option` ever has
+ */
+template<typename E, E Mark>
+struct EnumNiche
+    : detail::BitNiche<
+          typename std::underlying_type<E>::type,
+          static_cast<typename std::underlying_type<E>::type>(Mark)
+      > {};
+
+// No object can live at the all-ones address.
+template<typename T>
+struct OptionNiche<T*> : detail::PointerNiche<> {};
+
+// Signalling NaNs with payloads that arithmetic never produces.
+template<>
+struct OptionNiche<float> : detail::BitNiche<std::uint32_t, 0x7fa04f4e> {};
+
+template<>
+struct OptionNiche<double> : detail::BitNiche<std::uint64_t, 0x7ff56f7074696f6e> {};
+
+// An unowned option is a pointer which is null when empty.
+template<typename T>
+struct OptionNiche<UnownedOption<T>> : detail::PointerNiche<> {};
+
+namespace detail {
+
+// Tags the constructors that construct the value of an option in place,
+// from arguments or from the result of calling a function with them.
+struct InPlace {};
+struct Invoke {};
+
+// Whether the first of `Args` is an `X`.
+template<typename X, typename... Args>
+struct StartsWith : std::false_type {};
+
+template<typename X, typename A, typename... Args>
+struct StartsWith<X, A, Args...> : std::is_same<X, Decay<A>> {};
+
 template<typename T, typename Impl>
 class OptionBase {
 public:
@@ -36,16 +134,16 @@ public:
     T* ptr() const;
     void clear();
 
-    operator bool() const { return !impl().isEmpty(); }
+    constexpr operator bool() const { return !impl().isEmpty(); }
 
     operator T*() { return impl().ptr(); }
     operator const T*() const { return impl().ptr(); }
 
     T& operator*() { return *impl().ptr(); }
-    const T& operator*() const { return *impl().ptr(); }
+    constexpr const T& operator*() const { return *impl().ptr(); }
 
     T* operator->() { return impl().ptr(); }
-    const T* operator->() const { return impl().ptr(); }
+    constexpr const T* operator->() const { return impl().ptr(); }
 
     bool operator==(T* that) const { return impl().ptr() == that; }
     bool operator!=(T* that) const { return impl().ptr() != that; }
@@ -53,13 +151,13 @@ public:
     bool operator!=(const OptionBase& that) const { return impl().ptr() != that.impl().ptr(); }
 
     T& get() { return *impl().ptr(); }
-    const T& get() const { return *impl().ptr(); }
+    constexpr const T& get() const { return *impl().ptr(); }
 
     template<
         typename T1 = T,
         typename = typename std::enable_if<std::is_scalar<T1>::value>::type
     >
-    T getOrElse(T that) const { return impl().isEmpty() ? that : get(); }
+    constexpr T getOrElse(T that) const { return impl().isEmpty() ? that : get(); }
 
     template<typename Fn>
     void foreach(Fn f) const
@@ -70,9 +168,9 @@ public:
     }
 
     template<typename Fn, typename U = Decay<Ret<Fn, T>>>
-    Option<U> map(Fn f) const
+    constexpr Option<U> map(Fn f) const
     {
-        return impl().isEmpty() ? Option<U>() : Option<U>(f(get()));
+        return impl().isEmpty() ? Option<U>() : Option<U>(Invoke(), f, get());
     }
 
     template<typename Fn>
@@ -92,12 +190,12 @@ public:
     template<typename Fn>
     Option<T> filterMove(Fn p)
     {
-        if (impl().isEmpty()) {
-            return Option<T>();
+        Option<T> opt;
+        if (!impl().isEmpty() && p(get())) {
+            opt.emplace(std::move(get()));
         }
-        T t = std::move(get());
         impl().clear();
-        return p(t) ? Option<T>(std::move(t)) : Option<T>();
+        return opt;
     }
 
     template<
@@ -137,19 +235,19 @@ public:
             std::is_same<U, T>::value || std::is_base_of<U, T>::value
         >::type
     >
-    U fold(U z, BinaryOp op) const
+    constexpr U fold(U z, BinaryOp op) const
     {
         return foldLeft(std::move(z), std::move(op));
     }
 
     template<typename U, typename BinaryOp>
-    U foldLeft(U z, BinaryOp op) const
+    constexpr U foldLeft(U z, BinaryOp op) const
     {
         return impl().isEmpty() ? z : op(std::move(z), get());
     }
 
     template<typename U, typename BinaryOp>
-    U foldRight(U z, BinaryOp op) const
+    constexpr U foldRight(U z, BinaryOp op) const
     {
         return impl().isEmpty() ? z : op(get(), std::move(z));
     }
@@ -167,73 +265,284 @@ private:
     template<typename, typename> friend class OptionBase;
 
     Impl& impl() { return static_cast<Impl&>(*this); }
-    const Impl& impl() const { return static_cast<const Impl&>(*this); }
+    constexpr const Impl& impl() const { return static_cast<const Impl&>(*this); }
 };
 
 }  // namespace detail
 
 using detail::OptionBase;
 
+namespace detail {
+
+// Whether an `Option<T>` can be copied and destroyed bit by bit.
+template<typename T>
+using IsTrivialOption = std::integral_constant<
+    bool,
+    std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value
+>;
+
+// The bytes of an `Option<T>`, which hold either nothing or a `T`. Trivial
+// for a trivial `T`, so that the option can be copied and used in constant
+// expressions.
+template<typename T, bool = IsTrivialOption<T>::value>
+union OptionValue {
+    constexpr OptionValue() noexcept : none() {}
+
+    template<typename... Args>
+    constexpr explicit OptionValue(InPlace, Args&&... args)
+        : value(static_cast<Args&&>(args)...)
+    {}
+
+    template<typename Fn, typename... Args>
+    constexpr OptionValue(Invoke, Fn&& f, Args&&... args)
+        : value(static_cast<Fn&&>(f)(static_cast<Args&&>(args)...))
+    {}
+
+    char none;
+    T value;
+};
+
+template<typename T>
+union OptionValue<T, false> {
+    OptionValue() noexcept : none() {}
+
+    template<typename... Args>
+    explicit OptionValue(InPlace, Args&&... args)
+        : value(std::forward<Args>(args)...)
+    {}
+
+    template<typename Fn, typename... Args>
+    OptionValue(Invoke, Fn&& f, Args&&... args)
+        : value(std::forward<Fn>(f)(std::forward<Args>(args)...))
+    {}
+
+    ~OptionValue() {}
+
+    char none;
+    mutable T value;
+};
+
+// The storage of an `Option<T>`, which tracks emptiness with a flag unless
+// `T` has an `OptionNiche`.
+template<typename T, bool = OptionNiche<T>::value>
+struct OptionStorage {
+    constexpr OptionStorage() noexcept : v(), empty(true) {}
+
+    // `Tag` is `InPlace` or `Invoke`.
+    template<typename Tag, typename... Args>
+    constexpr explicit OptionStorage(Tag tag, Args&&... args)
+        : v(tag, static_cast<Args&&>(args)...), empty(false)
+    {}
+
+    constexpr bool isEmpty() const noexcept { return empty; }
+    void markEmpty() noexcept { empty = true; }
+    void markFull() noexcept { empty = false; }
+
+    OptionValue<T> v;
+    bool empty;
+};
+
+template<typename T>
+struct OptionStorage<T, true> {
+    OptionStorage() noexcept { markEmpty(); }
+
+    // `Tag` is `InPlace` or `Invoke`.
+    template<typename Tag, typename... Args>
+    constexpr explicit OptionStorage(Tag tag, Args&&... args)
+        : v(tag, static_cast<Args&&>(args)...)
+    {}
+
+    bool isEmpty() const noexcept { return OptionNiche<T>::isEmpty(&v); }
+    void markEmpty() noexcept { OptionNiche<T>::markEmpty(&v); }
+    void markFull() noexcept {}
+
+    OptionValue<T> v;
+};
+
+// The special members of an `Option<T>`: implicit, and thus trivial, for a
+// trivial `T`; otherwise move-only, leaving moved-from options empty.
+template<typename T, bool = IsTrivialOption<T>::value>
+struct OptionOwner : OptionStorage<T> {
+    constexpr OptionOwner() noexcept : OptionStorage<T>() {}
+
+    template<typename Tag, typename... Args>
+    constexpr explicit OptionOwner(Tag tag, Args&&... args)
+        : OptionStorage<T>(tag, static_cast<Args&&>(args)...)
+    {}
+
+    void clear() noexcept
+    {
+        this->markEmpty();
+    }
+};
+
+template<typename T>
+struct OptionOwner<T, false> : OptionStorage<T> {
+    OptionOwner() noexcept {}
+
+    template<typename Tag, typename... Args>
+    explicit OptionOwner(Tag tag, Args&&... args)
+        : OptionStorage<T>(tag, std::forward<Args>(args)...)
+    {}
+
+    OptionOwner(const OptionOwner&) = delete;
+
+    OptionOwner(OptionOwner&& that) noexcept
+    {
+        if (!that.isEmpty()) {
+            new (&this->v.value) T(std::move(that.v.value));
+            this->markFull();
+            that.clear();
+        }
+    }
+
+    ~OptionOwner()
+    {
+        clear();
+    }
+
+    OptionOwner& operator=(const OptionOwner&) = delete;
+
+    OptionOwner& operator=(OptionOwner&& that)
+    {
+        if (this != &that) {
+            clear();
+            if (!that.isEmpty()) {
+                new (&this->v.value) T(std::move(that.v.value));
+                this->markFull();
+                that.clear();
+            }
+        }
+        return *this;
+    }
+
+    void clear()
+    {
+        if (!this->isEmpty()) {
+            this->v.value.~T();
+            this->markEmpty();
+        }
+    }
+};
+
+}  // namespace detail
+
 /**
  * An optional value with managed storage.
  *
+ * If `T` has an `OptionNiche`, emptiness is encoded in the storage of the
+ * value itself, so that the option is no larger than `T`.
+ *
+ * If `T` is trivially copyable and trivially destructible, so is the
+ * option: it is copied bit by bit, and moving from it leaves it as is.
+ * If `T` is moreover a literal type without an `OptionNiche`, options can
+ * be created and inspected in constant expressions. Otherwise, an option is
+ * move-only, and moving from it leaves it empty.
+ *
  * @author Zizheng Tai
  * @since 1.0
  * @tparam T the type of the contained value
  */
 template<typename T>
-class Option final : public OptionBase<T, Option<T>> {
+class Option final
+    : public OptionBase<T, Option<T>>,
+      private detail::OptionOwner<T> {
+
+    using Owner = detail::OptionOwner<T>;
+
 public:
-    Option() noexcept : empty_(true) {}
+    constexpr Option() noexcept : Owner() {}
 
-    template<typename... Args>
-    explicit Option(Args&&... args) noexcept
-        : empty_(!(new (&storage_) T(std::forward<Args>(args)...)))
+    template<
+        typename... Args,
+        typename = typename std::enable_if<
+            !detail::StartsWith<Option, Args...>::value &&
+            !detail::StartsWith<detail::Invoke, Args...>::value
+        >::type
+    >
+    constexpr explicit Option(Args&&... args) noexcept
+        : Owner(detail::InPlace(), static_cast<Args&&>(args)...)
     {}
 
-    Option(const Option&) = delete;
-
-    Option(Option&& that) noexcept
-        : empty_(that.empty_ || !(new (&storage_) T(std::move(that.get()))))
+    /**
+     * Replaces the value of this option, if any, with one constructed in
+     * place from the given arguments.
+     *
+     * @param args the arguments to construct the new value with
+     * @return the new value
+     */
+    template<typename... Args>
+    T& emplace(Args&&... args)
     {
-        that.clear();
+        clear();
+        try {
+            new (&this->v.value) T(std::forward<Args>(args)...);
+        } catch (...) {
+            // A niche may have been overwritten.
+            this->markEmpty();
+            throw;
+        }
+        this->markFull();
+        return this->v.value;
     }
 
-    ~Option()
+    /**
+     * Applies a function returning an option to the value of this option,
+     * handing the value over as an rvalue. Unlike `flatMap`, the value is
+     * neither copied nor cleared, so a chain of calls on a temporary
+     * option takes one branch per step and moves nothing it need not.
+     *
+     * @param f a function taking a `T&&` and returning an option
+     * @return `f` applied to the value, or an empty option if this is empty
+     */
+    template<
+        typename Fn,
+        typename Opt = detail::Decay<detail::Ret<Fn, T&&>>,
+        typename U = typename detail::HKT<Opt>::L,
+        typename = typename std::enable_if<
+            std::is_base_of<OptionBase<U, Opt>, Opt>::value
+        >::type
+    >
+    Opt andThen(Fn f) &&
     {
-        clear();
+        return isEmpty() ? Opt() : f(std::move(this->v.value));
     }
 
-    Option& operator=(const Option&) = delete;
-
-    Option& operator=(Option&& that)
+    /**
+     * Returns this option if it is not empty, or the result of a function
+     * otherwise, which is then constructed directly in the result.
+     *
+     * @param f a function returning an `Option<T>`
+     * @return this option, or the result of `f` if this is empty
+     */
+    template<typename Fn>
+    Option orElse(Fn f) &&
     {
-        empty_ = that.empty_ || !(new (&storage_) T(std::move(that.get())));
-        that.clear();
-        return *this;
+        return isEmpty() ? f() : std::move(*this);
     }
 
-    bool isEmpty() const
+    constexpr bool isEmpty() const
     {
-        return empty_;
+        return Owner::isEmpty();
     }
 
-    T* ptr() const
+    constexpr T* ptr() const
     {
-        return empty_ ? nullptr : reinterpret_cast<T*>(&storage_);
+        return isEmpty() ? nullptr : const_cast<T*>(&this->v.value);
     }
 
     void clear()
     {
-        if (!empty_) {
-            OptionBase<T, Option>::get().~T();
-            empty_ = true;
-        }
+        Owner::clear();
     }
 
 private:
-    bool empty_;
-    mutable typename std::aligned_storage<sizeof (T), alignof (T)>::type storage_;
+    template<typename, typename> friend class detail::OptionBase;
+
+    template<typename Fn, typename... Args>
+    constexpr Option(detail::Invoke tag, Fn&& f, Args&&... args)
+        : Owner(tag, static_cast<Fn&&>(f), static_cast<Args&&>(args)...)
+    {}
 };
 
 /**
@@ -245,11 +554,16 @@ private:
  */
 template<typename T>
 class UnownedOption final
-    : public OptionBase<T, UnownedOption<T>>
-    , public std::iterator<std::forward_iterator_tag, T> {
+    : public OptionBase<T, UnownedOption<T>> {
 
 public:
-    explicit UnownedOption(T* ptr = nullptr) noexcept : ptr_(ptr) {}
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    constexpr explicit UnownedOption(T* ptr = nullptr) noexcept : ptr_(ptr) {}
 
     UnownedOption(const UnownedOption&) = default;
 
@@ -279,12 +593,12 @@ public:
         return UnownedOption(old);
     }
 
-    bool isEmpty() const
+    constexpr bool isEmpty() const
     {
         return !ptr_;
     }
 
-    T* ptr() const
+    constexpr T* ptr() const
     {
         return ptr_;
     }
@@ -0,0 +1,239 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/PoolAllocator.hpp
+ * An allocator recycling the nodes of small, short-lived data structures
+ * through per-thread caches.
+ */
+
+#ifndef GUNGNIR_POOL_ALLOCATOR_HPP
+#define GUNGNIR_POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+/// @cond GUNGNIR_PRIVATE
+namespace detail {
+
+// A per-thread cache of up to `Cap` free blocks for single `T`s, obtained
+// from a `Base`. The state of a thread's cache is trivially destructible,
+// and a separate reaper returns the cached blocks to `Base` and closes the
+// cache when the thread exits, so that blocks freed afterwards, e.g. by
+// the destructors of static objects, bypass the cache.
+template<typename T, typename Base, std::size_t Cap>
+class BlockCache final {
+public:
+    static T* pop() noexcept
+    {
+        auto& s = state();
+        const auto b = s.head;
+        if (!b) {
+            return nullptr;
+        }
+        s.head = b->next;
+        --s.size;
+        return reinterpret_cast<T*>(b);
+    }
+
+    // Caches `p`, returning whether it did.
+    static bool push(T* p) noexcept
+    {
+        auto& s = state();
+        if (s.size == Cap || s.closed) {
+            return false;
+        } else if (s.size == 0) {
+            arm();
+        }
+        s.head = new (p) Block { s.head };
+        ++s.size;
+        return true;
+    }
+
+private:
+    struct Block {
+        Block* next;
+    };
+
+    struct State {
+        Block* head;
+        std::size_t size;
+        bool closed;
+    };
+
+    struct Reaper {
+        Reaper() noexcept {}
+
+        ~Reaper()
+        {
+            auto& s = state();
+            s.closed = true;
+            Base base;
+            while (s.head) {
+                const auto b = s.head;
+                s.head = b->next;
+                base.deallocate(reinterpret_cast<T*>(b), 1);
+            }
+            s.size = 0;
+        }
+    };
+
+    static State& state() noexcept
+    {
+        static thread_local State s;
+        return s;
+    }
+
+    static void arm() noexcept
+    {
+        static thread_local Reaper r;
+        (void) r;
+    }
+};
+
+// Whether blocks for single `T`s can hold a cache link, and blocks from
+// any two `Base`s are interchangeable.
+template<typename T, typename Base>
+using IsPoolable = std::integral_constant<
+    bool,
+    sizeof (T) >= sizeof (void*) && alignof(T) >= alignof(void*) &&
+    std::is_empty<Base>::value && std::is_default_constructible<Base>::value
+>;
+
+}  // namespace detail
+/// @endcond
+
+/**
+ * @brief An allocator that recycles single objects through a per-thread
+ *        cache of free blocks, and allocates everything else with `Base`.
+ *
+ * A `List` allocates one node per element, so building and dropping many
+ * small lists makes one trip to the general-purpose allocator per element
+ * each way. With a `PoolAllocator`, freed nodes are instead kept in a cache
+ * of the freeing thread, up to `Cap` of them per node type, and handed out
+ * again by the next allocations on that thread. Lists derived from a list
+ * using it, e.g. through `map()`, rebind the allocator and keep pooling.
+ *
+ * Pooling only applies if `Base` is stateless and the objects are at
+ * least as large and aligned as a pointer, which holds for the nodes of
+ * every data structure; other allocations go straight to `Base`. The
+ * reference counting policy of `Base` is kept, so e.g.
+ * `PoolAllocator<A, LocalAllocator<A>>` combines both.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the allocated objects
+ * @tparam Base the type of the allocator that actually allocates them
+ * @tparam Cap the maximum number of free blocks cached per thread and type
+ */
+template<typename A, typename Base = std::allocator<A>, std::size_t Cap = 1024>
+class PoolAllocator : public Base {
+public:
+    /** @brief Rebinds this allocator to another type of objects. */
+    template<typename B>
+    struct rebind {
+        using other = PoolAllocator<B, detail::Rebind<Base, B>, Cap>;
+    };
+
+    /**
+     * @brief Constructs an allocator with a default constructed `Base`.
+     */
+    PoolAllocator() = default;
+
+    /**
+     * @brief Constructs an allocator allocating with `base`.
+     *
+     * @param base the allocator that actually allocates objects
+     */
+    explicit PoolAllocator(const Base& base) noexcept : Base(base) {}
+
+    /**
+     * @brief Constructs an allocator allocating with a copy of the
+     *        allocator of `that`, rebound to `A`.
+     *
+     * @param that the allocator to copy
+     */
+    template<typename B, typename BBase>
+    PoolAllocator(const PoolAllocator<B, BBase, Cap>& that) noexcept
+        : Base(static_cast<const BBase&>(that))
+    {}
+
+    /**
+     * @brief Allocates storage for `n` objects, reusing a cached block if
+     *        `n` is 1.
+     *
+     * @param n the number of objects
+     * @return a pointer to the storage
+     */
+    A* allocate(std::size_t n)
+    {
+        return allocate(n, Poolable());
+    }
+
+    /**
+     * @brief Frees storage for `n` objects, caching it if `n` is 1 and the
+     *        cache of the calling thread is not full.
+     *
+     * @param p a pointer to the storage
+     * @param n the number of objects
+     */
+    void deallocate(A* p, std::size_t n)
+    {
+        deallocate(p, n, Poolable());
+    }
+
+private:
+    using Traits = std::allocator_traits<Base>;
+    using Poolable = detail::IsPoolable<A, Base>;
+    using Cache = detail::BlockCache<A, Base, Cap>;
+
+    A* allocate(std::size_t n, std::true_type)
+    {
+        if (n == 1) {
+            if (const auto p = Cache::pop()) {
+                return p;
+            }
+        }
+        return Traits::allocate(*this, n);
+    }
+
+    A* allocate(std::size_t n, std::false_type)
+    {
+        return Traits::allocate(*this, n);
+    }
+
+    void deallocate(A* p, std::size_t n, std::true_type)
+    {
+        if (n != 1 || !Cache::push(p)) {
+            Traits::deallocate(*this, p, n);
+        }
+    }
+
+    void deallocate(A* p, std::size_t n, std::false_type)
+    {
+        Traits::deallocate(*this, p, n);
+    }
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_POOL_ALLOCATOR_HPP
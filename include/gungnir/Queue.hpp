@@ -0,0 +1,272 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/Queue.hpp
+ * A persistent FIFO queue with amortized constant-time operations.
+ */
+
+#ifndef GUNGNIR_QUEUE_HPP
+#define GUNGNIR_QUEUE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "gungnir/List.hpp"
+
+namespace gungnir {
+
+/**
+ * @brief An immutable first-in, first-out queue.
+ *
+ * The elements are kept in two lists: the front, in order, and the rear,
+ * in reverse order. `appended()` prepends to the rear, and `tail()` drops
+ * the head of the front; once the front runs out, the rear is reversed to
+ * become the new front. Each element is thus moved between the lists at
+ * most once, so `appended()` and `tail()` take amortized O(1) time, while
+ * `head()` and `size()` take O(1) time.
+ *
+ * The amortized bound assumes that each queue is consumed once. Taking the
+ * `tail()` of the same queue repeatedly, when its front holds its last
+ * element, reverses the same rear each time; use a `Deque` for worst-case
+ * O(1) operations however the queues are shared.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements; must be a non-reference type
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               this queue
+ */
+template<typename A, typename Alloc = std::allocator<A>>
+class Queue final {
+public:
+    /**
+     * @brief Constructs an empty queue.
+     */
+    Queue() noexcept : Queue(Alloc()) {}
+
+    /**
+     * @brief Constructs an empty queue whose nodes will be allocated
+     *        with `alloc`.
+     *
+     * @param alloc the allocator used by this queue and the queues derived
+     *              from it
+     */
+    explicit Queue(const Alloc& alloc) noexcept : front_(alloc), rear_(alloc) {}
+
+    /**
+     * @brief Constructs a queue with the given elements, the first of which
+     *        is at its head.
+     *
+     * @param xs the elements of this queue
+     * @param alloc the allocator used by this queue and the queues derived
+     *              from it
+     */
+    Queue(std::initializer_list<A> xs, const Alloc& alloc = Alloc())
+        : Queue(List<A, Alloc>(xs, alloc))
+    {}
+
+    /**
+     * @brief Constructs a queue with the elements of a list, the head of
+     *        which is at its head.
+     *
+     * @param xs the elements of this queue
+     */
+    explicit Queue(List<A, Alloc> xs) noexcept
+        : front_(std::move(xs)), rear_(front_.allocator())
+    {}
+
+    /**
+     * @brief Returns a copy of the allocator used by this queue.
+     *
+     * @return a copy of the allocator used by this queue
+     */
+    Alloc allocator() const
+    {
+        return front_.allocator();
+    }
+
+    /**
+     * @brief Returns `true` if this queue contains no elements,
+     *        `false` otherwise.
+     *
+     * @return `true` if this queue contains no elements, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return front_.isEmpty();
+    }
+
+    /**
+     * @brief Returns the number of elements in this queue.
+     *
+     * @return the number of elements in this queue
+     */
+    std::size_t size() const
+    {
+        return front_.size() + rear_.size();
+    }
+
+    /**
+     * @brief Returns the element at the head of this queue, i.e., the one
+     *        appended first.
+     *
+     * @return the element at the head of this queue
+     * @throws std::out_of_range if this queue is empty
+     */
+    const A& head() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("head of empty queue");
+        }
+        return front_.head();
+    }
+
+    /**
+     * @brief Returns all elements of this queue except its head.
+     *
+     * @return all elements of this queue except its head
+     * @throws std::out_of_range if this queue is empty
+     */
+    Queue tail() const&
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("tail of empty queue");
+        }
+        return Queue(front_.tail(), rear_);
+    }
+
+    /**
+     * @brief Returns all elements of this queue except its head, reusing
+     *        what it can of this queue.
+     *
+     * If the front runs out, the nodes of the rear that no other queue
+     * shares are relinked in place to form the new front.
+     *
+     * @return all elements of this queue except its head
+     * @throws std::out_of_range if this queue is empty
+     */
+    Queue tail() &&
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("tail of empty queue");
+        }
+        return Queue(front_.tail(), std::move(rear_));
+    }
+
+    /**
+     * @brief Returns a pair consisting of the head and tail of this queue.
+     *
+     * @return a pair consisting of the head and tail of this queue
+     * @throws std::out_of_range if this queue is empty
+     */
+    std::pair<std::reference_wrapper<const A>, Queue> uncons() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("uncons on empty queue");
+        }
+        return std::make_pair(std::cref(head()), tail());
+    }
+
+    /**
+     * @brief Returns a queue with an element constructed from the given
+     *        arguments appended to this queue.
+     *
+     * @param args the arguments to construct the new element with
+     * @return a queue with the new element appended to this queue
+     */
+    template<typename... Args>
+    Queue appended(Args&&... args) const
+    {
+        if (isEmpty()) {
+            return Queue(front_.prepend(std::forward<Args>(args)...));
+        }
+        return Queue(front_, rear_.prepend(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Applies a function to each element of this queue, from its
+     *        head to its last element.
+     *
+     * @param f the function to apply, for its side-effect, to each element
+     *          of this queue
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        front_.foreach(f);
+        rear_.foldRight(0, [&f](const A& x, int) {
+            f(x);
+            return 0;
+        });
+    }
+
+    /**
+     * @brief Returns a list of the elements of this queue, from its head to
+     *        its last element.
+     *
+     * @return a list of the elements of this queue
+     */
+    List<A, Alloc> toList() const
+    {
+        return rear_.isEmpty() ? front_ : front_.concat(rear_.reverse());
+    }
+
+    /**
+     * @brief Returns `true` if this queue and `that` have equal elements
+     *        in the same order, `false` otherwise.
+     *
+     * @param that the queue to compare with
+     * @return `true` if the queues have equal elements in the same order
+     */
+    bool operator==(const Queue& that) const
+    {
+        return size() == that.size() && toList() == that.toList();
+    }
+
+    /**
+     * @brief Returns `true` if this queue and `that` differ, `false` otherwise.
+     *
+     * @param that the queue to compare with
+     * @return `false` if the queues have equal elements in the same order
+     */
+    bool operator!=(const Queue& that) const
+    {
+        return !(*this == that);
+    }
+
+private:
+    // Restores the invariant that the front is empty only if the whole
+    // queue is, by reversing the rear once the front runs out.
+    Queue(List<A, Alloc> front, List<A, Alloc> rear)
+        : front_(std::move(front)), rear_(std::move(rear))
+    {
+        if (front_.isEmpty() && !rear_.isEmpty()) {
+            front_ = std::move(rear_).reverse();
+            rear_ = List<A, Alloc>(front_.allocator());
+        }
+    }
+
+    List<A, Alloc> front_;
+    List<A, Alloc> rear_;
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_QUEUE_HPP
@@ -0,0 +1,719 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/Rope.hpp
+ * A persistent string for large texts, with logarithmic edits.
+ */
+
+#ifndef GUNGNIR_ROPE_HPP
+#define GUNGNIR_ROPE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gungnir/List.hpp"
+
+namespace gungnir {
+
+/// @cond GUNGNIR_PRIVATE
+
+namespace detail {
+
+// Parameters of `Rope`. Concatenating two leaves of at most `leafLimit`
+// characters in total copies them into one, so that a text typed in one
+// character at a time does not end up with a leaf per character;
+// `Rope::fromList()` packs the strings it is given into chunks of about
+// `chunkSize` characters.
+namespace rope {
+
+constexpr std::size_t leafLimit = 512;
+constexpr std::size_t chunkSize = 4096;
+
+}  // namespace rope
+
+}  // namespace detail
+
+/// @endcond
+
+/**
+ * @brief An immutable string made of shared chunks of text.
+ *
+ * The characters of a `Rope` are stored in immutable chunks, the leaves of
+ * a height-balanced binary tree whose inner nodes record the length of
+ * their subtrees. Each leaf refers to a run of a `std::string` shared with
+ * any number of other leaves and ropes, so taking a part of a rope never
+ * copies characters, and `concat()`, `take()`, `drop()`, `slice()`,
+ * `insertAt()`, `removed()` and `charAt()` take O(log n) time, where n is
+ * the number of chunks. Ropes derived from one another share all but the
+ * O(log n) nodes along the cuts.
+ *
+ * The chunks can be visited in order with `chunks()` without copying them,
+ * e.g. to write a rope out with a single gathering `writev()` call.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ */
+class Rope final {
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+public:
+    /** @brief A run of characters of a rope, valid while the rope lives. */
+    struct Chunk {
+        /** @brief The first character of the run. */
+        const char* data;
+
+        /** @brief The number of characters of the run. */
+        std::size_t size;
+    };
+
+    class ChunkIterator;
+    class Chunks;
+
+    /**
+     * @brief Constructs an empty rope.
+     */
+    Rope() noexcept = default;
+
+    /**
+     * @brief Constructs a rope of a copy of a string.
+     *
+     * @param s the string
+     */
+    Rope(const std::string& s) : Rope(std::string(s)) {}
+
+    /**
+     * @brief Constructs a rope of a string, taking it over without copying
+     *        its characters.
+     *
+     * @param s the string
+     */
+    Rope(std::string&& s) : Rope(std::make_shared<const std::string>(std::move(s))) {}
+
+    /**
+     * @brief Constructs a rope of a copy of a null-terminated string.
+     *
+     * @param s the string
+     */
+    Rope(const char* s) : Rope(std::string(s)) {}
+
+    /**
+     * @brief Constructs a rope of a shared string, without copying it.
+     *
+     * The string must not be modified through other means while it is part
+     * of a rope.
+     *
+     * @param s the string, kept alive by this rope and the ropes derived
+     *          from it
+     */
+    explicit Rope(std::shared_ptr<const std::string> s)
+        : root_(s ? leaf(s, 0, s->size()) : NodePtr())
+    {}
+
+    /**
+     * @brief Returns a rope of the strings of a list, one after another.
+     *
+     * The strings are copied and packed into chunks of a few kilobytes, and
+     * the tree is built bottom up, so this takes O(n) time in the total
+     * length of the strings.
+     *
+     * @param xs the strings
+     * @return a rope of the concatenation of the strings of `xs`
+     */
+    static Rope fromList(const List<std::string>& xs)
+    {
+        std::vector<NodePtr> leaves;
+        std::string buf;
+        const auto flush = [&leaves, &buf]() {
+            if (!buf.empty()) {
+                const auto s = std::make_shared<const std::string>(std::move(buf));
+                leaves.push_back(leaf(s, 0, s->size()));
+                buf = std::string();
+            }
+        };
+        xs.foreach([&](const std::string& x) {
+            if (buf.size() + x.size() > detail::rope::chunkSize) {
+                flush();
+            }
+            if (x.size() >= detail::rope::chunkSize) {
+                const auto s = std::make_shared<const std::string>(x);
+                leaves.push_back(leaf(s, 0, s->size()));
+            } else {
+                if (buf.empty()) {
+                    buf.reserve(detail::rope::chunkSize);
+                }
+                buf += x;
+            }
+        });
+        flush();
+        return Rope(build(leaves.data(), leaves.size()));
+    }
+
+    /**
+     * @brief Returns whether this rope is empty.
+     *
+     * @return `true` if this rope has no characters, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return !root_;
+    }
+
+    /**
+     * @brief Returns the number of characters of this rope, in O(1) time.
+     *
+     * @return the number of characters of this rope
+     */
+    std::size_t size() const
+    {
+        return lengthOf(root_.get());
+    }
+
+    /**
+     * @brief Returns the height of the tree of this rope, which is zero if
+     *        it has at most one chunk and O(log n) otherwise.
+     *
+     * @return the height of the tree of this rope
+     */
+    std::size_t depth() const
+    {
+        return root_ ? root_->height : 0;
+    }
+
+    /**
+     * @brief Returns the character at a position, in O(log n) time.
+     *
+     * @param index the index of the character
+     * @return the character at position `index`
+     * @throws std::out_of_range if `index >= size()`
+     */
+    char charAt(std::size_t index) const
+    {
+        if (index >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+        auto n = root_.get();
+        while (!n->chunk) {
+            if (index < n->left->length) {
+                n = n->left.get();
+            } else {
+                index -= n->left->length;
+                n = n->right.get();
+            }
+        }
+        return (*n->chunk)[n->offset + index];
+    }
+
+    /**
+     * @brief Returns the character at a position, in O(log n) time.
+     *
+     * @param index the index of the character
+     * @return the character at position `index`
+     * @throws std::out_of_range if `index >= size()`
+     */
+    char operator[](std::size_t index) const
+    {
+        return charAt(index);
+    }
+
+    /**
+     * @brief Returns a rope of the characters of this rope followed by those
+     *        of another, in O(log n) time.
+     *
+     * The trees of both ropes are shared, except for the nodes along the
+     * seam between them, which are rebalanced.
+     *
+     * @param that the rope whose characters follow those of this rope
+     * @return a rope resulting from concatenating this rope and `that`
+     */
+    Rope concat(const Rope& that) const
+    {
+        return Rope(join(root_, that.root_));
+    }
+
+    /**
+     * @brief Returns the first `n` characters of this rope, in O(log n) time.
+     *
+     * @param n the number of characters to take
+     * @return a rope of the first `n` characters of this rope, or the whole
+     *         rope if `n > size()`
+     */
+    Rope take(std::size_t n) const
+    {
+        return splitAt(n).first;
+    }
+
+    /**
+     * @brief Returns all characters of this rope except the first `n`, in
+     *        O(log n) time.
+     *
+     * @param n the number of characters to drop
+     * @return a rope of all characters of this rope except the first `n`,
+     *         or an empty rope if `n > size()`
+     */
+    Rope drop(std::size_t n) const
+    {
+        return splitAt(n).second;
+    }
+
+    /**
+     * @brief Returns the characters of this rope from position `from` up
+     *        until position `until`, in O(log n) time.
+     *
+     * @param from the index of the starting position (included)
+     * @param until the index of the ending position (excluded)
+     * @return a rope of the characters of this rope starting at position
+     *         `from` and extending up until position `until`, or an empty
+     *         rope if `from >= until` or `from >= size()`
+     */
+    Rope slice(std::size_t from, std::size_t until) const
+    {
+        until = std::min(until, size());
+        if (from >= until) {
+            return Rope();
+        }
+        return take(until).drop(from);
+    }
+
+    /**
+     * @brief Splits this rope at a position, in O(log n) time.
+     *
+     * @param n the position to split at
+     * @return a pair of the first `n` characters of this rope, or the whole
+     *         rope if `n > size()`, and the remaining characters
+     */
+    std::pair<Rope, Rope> splitAt(std::size_t n) const
+    {
+        NodePtr l;
+        NodePtr r;
+        split(root_, n, l, r);
+        return std::make_pair(Rope(std::move(l)), Rope(std::move(r)));
+    }
+
+    /**
+     * @brief Returns a new rope with another rope inserted at a position,
+     *        in O(log n) time.
+     *
+     * @param index the position of the inserted characters
+     * @param that the rope to insert
+     * @return a new rope consisting of the first `index` characters of this
+     *         rope, the characters of `that`, and the remaining characters
+     *         of this rope
+     * @throws std::out_of_range if `index > size()`
+     */
+    Rope insertAt(std::size_t index, const Rope& that) const
+    {
+        if (index > size()) {
+            throw std::out_of_range("index out of range");
+        }
+        const auto halves = splitAt(index);
+        return Rope(join(join(halves.first.root_, that.root_), halves.second.root_));
+    }
+
+    /**
+     * @brief Returns a new rope without the characters from position `from`
+     *        up until position `until`, in O(log n) time.
+     *
+     * @param from the index of the first character removed
+     * @param until the index of the first character kept after those
+     *              removed
+     * @return a rope of the characters of this rope before position `from`
+     *         and from position `until` on, or this rope if
+     *         `from >= until` or `from >= size()`
+     */
+    Rope removed(std::size_t from, std::size_t until) const
+    {
+        until = std::min(until, size());
+        if (from >= until) {
+            return *this;
+        }
+        return Rope(join(take(from).root_, drop(until).root_));
+    }
+
+    /**
+     * @brief Returns the chunks of this rope, in order.
+     *
+     * The chunks refer to the characters stored in this rope and are valid
+     * as long as any rope sharing them lives; none is empty.
+     *
+     * @return a range of the chunks of this rope
+     */
+    Chunks chunks() const;
+
+    /**
+     * @brief Returns a string of the characters of this rope.
+     *
+     * @return a string of the characters of this rope
+     */
+    std::string toString() const;
+
+    /**
+     * @brief Returns a list of the chunks of this rope, whose concatenation
+     *        is the text of this rope.
+     *
+     * @return a list of copies of the chunks of this rope
+     */
+    List<std::string> toList() const;
+
+    /**
+     * @brief Compares this rope with the given rope for equality.
+     *
+     * Ropes are compared by their characters, however they are split into
+     * chunks.
+     *
+     * @param that the rope to be compared for equality with this rope
+     * @return `true` if `that` has the same characters as this rope in the
+     *         same order, `false` otherwise
+     */
+    bool operator==(const Rope& that) const;
+
+    /**
+     * @brief Compares this rope with the given rope for inequality.
+     *
+     * @param that the rope to be compared for inequality with this rope
+     * @return `true` if `that` does not have the same characters as this
+     *         rope in the same order, `false` otherwise
+     */
+    bool operator!=(const Rope& that) const
+    {
+        return !(*this == that);
+    }
+
+    /**
+     * @brief Swaps the contents of this rope with another rope.
+     *
+     * @param that the other rope
+     */
+    void swap(Rope& that) noexcept
+    {
+        root_.swap(that.root_);
+    }
+
+private:
+    // A leaf refers to `length` characters of `chunk` from `offset` on, and
+    // has no children; an inner node has two, and no chunk. A leaf has
+    // height zero and is never empty.
+    struct Node {
+        Node(std::shared_ptr<const std::string> c, std::size_t off, std::size_t n)
+            : chunk(std::move(c))
+            , offset(off)
+            , length(n)
+            , height(0)
+        {}
+
+        Node(NodePtr l, NodePtr r)
+            : offset(0)
+            , left(std::move(l))
+            , right(std::move(r))
+            , length(left->length + right->length)
+            , height(std::max(left->height, right->height) + 1)
+        {}
+
+        const std::shared_ptr<const std::string> chunk;
+        const std::size_t offset;
+        const NodePtr left;
+        const NodePtr right;
+        const std::size_t length;
+        const std::size_t height;
+    };
+
+    explicit Rope(NodePtr root) noexcept : root_(std::move(root)) {}
+
+    static std::size_t lengthOf(const Node* n)
+    {
+        return n ? n->length : 0;
+    }
+
+    static NodePtr leaf(std::shared_ptr<const std::string> chunk, std::size_t offset, std::size_t n)
+    {
+        return n == 0 ? NodePtr() : std::make_shared<Node>(std::move(chunk), offset, n);
+    }
+
+    static NodePtr branch(NodePtr l, NodePtr r)
+    {
+        return std::make_shared<Node>(std::move(l), std::move(r));
+    }
+
+    // Joins two trees whose heights differ by at most two.
+    static NodePtr balance(NodePtr l, NodePtr r)
+    {
+        if (l->height > r->height + 1) {
+            if (l->left->height >= l->right->height) {
+                return branch(l->left, branch(l->right, std::move(r)));
+            }
+            const auto& m = l->right;
+            return branch(branch(l->left, m->left), branch(m->right, std::move(r)));
+        } else if (r->height > l->height + 1) {
+            if (r->right->height >= r->left->height) {
+                return branch(branch(std::move(l), r->left), r->right);
+            }
+            const auto& m = r->left;
+            return branch(branch(std::move(l), m->left), branch(m->right, r->right));
+        }
+        return branch(std::move(l), std::move(r));
+    }
+
+    // Joins two trees by descending the spine of the taller one to a
+    // subtree as tall as the other, which takes time proportional to the
+    // difference of their heights.
+    static NodePtr join(const NodePtr& l, const NodePtr& r)
+    {
+        if (!l) {
+            return r;
+        } else if (!r) {
+            return l;
+        } else if (l->height > r->height + 1) {
+            return balance(l->left, join(l->right, r));
+        } else if (r->height > l->height + 1) {
+            return balance(join(l, r->left), r->right);
+        } else if (l->chunk && r->chunk && l->length + r->length <= detail::rope::leafLimit) {
+            std::string s;
+            s.reserve(l->length + r->length);
+            s.append(*l->chunk, l->offset, l->length);
+            s.append(*r->chunk, r->offset, r->length);
+            return leaf(std::make_shared<const std::string>(std::move(s)), 0, l->length + r->length);
+        }
+        return branch(l, r);
+    }
+
+    // Splits a tree into its first `n` characters and the rest; the leaf
+    // cut in two, if any, is shared by both halves.
+    static void split(const NodePtr& t, std::size_t n, NodePtr& lo, NodePtr& hi)
+    {
+        if (n == 0) {
+            lo = NodePtr();
+            hi = t;
+        } else if (n >= lengthOf(t.get())) {
+            lo = t;
+            hi = NodePtr();
+        } else if (t->chunk) {
+            lo = leaf(t->chunk, t->offset, n);
+            hi = leaf(t->chunk, t->offset + n, t->length - n);
+        } else if (n <= t->left->length) {
+            NodePtr m;
+            split(t->left, n, lo, m);
+            hi = join(m, t->right);
+        } else {
+            NodePtr m;
+            split(t->right, n - t->left->length, m, hi);
+            lo = join(t->left, m);
+        }
+    }
+
+    static NodePtr build(const NodePtr* leaves, std::size_t n)
+    {
+        if (n == 0) {
+            return NodePtr();
+        } else if (n == 1) {
+            return leaves[0];
+        }
+        const auto half = n / 2;
+        return branch(build(leaves, half), build(leaves + half, n - half));
+    }
+
+    NodePtr root_;
+};
+
+/**
+ * @brief An iterator over the chunks of a rope.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ */
+class Rope::ChunkIterator final {
+public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = Chunk;
+    using pointer = const Chunk*;
+    using reference = const Chunk&;
+    using iterator_category = std::forward_iterator_tag;
+
+    /**
+     * @brief Constructs an iterator past the last chunk of any rope.
+     */
+    ChunkIterator() noexcept : chunk_{nullptr, 0}, index_(0) {}
+
+    /** @brief Returns the current chunk. */
+    reference operator*() const
+    {
+        return chunk_;
+    }
+
+    /** @brief Returns the current chunk. */
+    pointer operator->() const
+    {
+        return &chunk_;
+    }
+
+    /** @brief Advances to the next chunk. */
+    ChunkIterator& operator++()
+    {
+        if (pending_.empty()) {
+            *this = ChunkIterator();
+        } else {
+            const Node* n = pending_.back();
+            pending_.pop_back();
+            descend(n);
+            ++index_;
+        }
+        return *this;
+    }
+
+    /** @brief Advances to the next chunk. */
+    ChunkIterator operator++(int)
+    {
+        auto it = *this;
+        ++*this;
+        return it;
+    }
+
+    /** @brief Compares two iterators over the same rope for equality. */
+    bool operator==(const ChunkIterator& that) const
+    {
+        return chunk_.data == that.chunk_.data && index_ == that.index_;
+    }
+
+    /** @brief Compares two iterators over the same rope for inequality. */
+    bool operator!=(const ChunkIterator& that) const
+    {
+        return !(*this == that);
+    }
+
+private:
+    friend class Rope;
+
+    explicit ChunkIterator(const Node* root) : ChunkIterator()
+    {
+        if (root) {
+            descend(root);
+        }
+    }
+
+    // Moves to the first leaf of `n`, keeping the right subtrees passed by
+    // to be visited later.
+    void descend(const Node* n)
+    {
+        for (; !n->chunk; n = n->left.get()) {
+            pending_.push_back(n->right.get());
+        }
+        chunk_.data = n->chunk->data() + n->offset;
+        chunk_.size = n->length;
+    }
+
+    std::vector<const Node*> pending_;
+    Chunk chunk_;
+    std::size_t index_;
+};
+
+/**
+ * @brief The chunks of a rope, which it keeps alive.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ */
+class Rope::Chunks final {
+public:
+    /** @brief Returns an iterator to the first chunk. */
+    ChunkIterator begin() const
+    {
+        return ChunkIterator(rope_.root_.get());
+    }
+
+    /** @brief Returns an iterator past the last chunk. */
+    ChunkIterator end() const
+    {
+        return ChunkIterator();
+    }
+
+private:
+    friend class Rope;
+
+    explicit Chunks(const Rope& rope) : rope_(rope) {}
+
+    Rope rope_;
+};
+
+inline Rope::Chunks Rope::chunks() const
+{
+    return Chunks(*this);
+}
+
+inline std::string Rope::toString() const
+{
+    std::string s;
+    s.reserve(size());
+    for (const auto& c : chunks()) {
+        s.append(c.data, c.size);
+    }
+    return s;
+}
+
+inline List<std::string> Rope::toList() const
+{
+    ListBuilder<std::string> buf;
+    for (const auto& c : chunks()) {
+        buf.append(c.data, c.size);
+    }
+    return buf.result();
+}
+
+inline bool Rope::operator==(const Rope& that) const
+{
+    if (size() != that.size()) {
+        return false;
+    } else if (root_ == that.root_) {
+        return true;
+    }
+
+    // Walks both sequences of chunks at once, comparing the runs they
+    // overlap on.
+    const auto xs = chunks();
+    const auto ys = that.chunks();
+    auto it = xs.begin();
+    auto jt = ys.begin();
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (it != xs.end()) {
+        const auto n = std::min(it->size - i, jt->size - j);
+        if (std::memcmp(it->data + i, jt->data + j, n) != 0) {
+            return false;
+        }
+        i += n;
+        j += n;
+        if (i == it->size) {
+            ++it;
+            i = 0;
+        }
+        if (j == jt->size) {
+            ++jt;
+            j = 0;
+        }
+    }
+    return true;
+}
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_ROPE_HPP
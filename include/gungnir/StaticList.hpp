@@ -0,0 +1,435 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/StaticList.hpp
+ * An immutable list of a fixed number of elements, usable in constant
+ * expressions.
+ */
+
+#ifndef GUNGNIR_STATIC_LIST_HPP
+#define GUNGNIR_STATIC_LIST_HPP
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "gungnir/List.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+/// @cond GUNGNIR_PRIVATE
+namespace detail {
+
+// The elements of a `StaticList`, stored inline.
+template<typename A, std::size_t N>
+struct StaticStorage {
+    template<typename... Args>
+    constexpr explicit StaticStorage(Args&&... args)
+        : xs { A(static_cast<Args&&>(args))... }
+    {}
+
+    constexpr const A* data() const { return xs; }
+
+    A xs[N];
+};
+
+template<typename A>
+struct StaticStorage<A, 0> {
+    constexpr StaticStorage() {}
+
+    constexpr const A* data() const { return nullptr; }
+};
+
+}  // namespace detail
+/// @endcond
+
+/**
+ * @brief An immutable list of `N` elements stored inline.
+ *
+ * A `StaticList` never allocates: its elements live inside it, so it suits
+ * small lists known up front, such as dispatch tables and defaults. If `A`
+ * is a literal type, a `StaticList` can be a `constexpr` variable, and
+ * `map()`, `foldLeft()`, `foldRight()`, `exists()`, `forall()`,
+ * `contains()` and `count()` are evaluated at compile time when their
+ * arguments are constant expressions, e.g. when the functions passed to
+ * them are function objects with `constexpr` call operators. Operations
+ * whose result sizes depend on the elements, such as `filter()`, return
+ * `List`s, and `toList()` converts a `StaticList` to a `List`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements
+ * @tparam N the number of elements
+ */
+template<typename A, std::size_t N>
+class StaticList final {
+public:
+    /** @brief An iterator over the elements of a list. */
+    using StdIterator = const A*;
+
+    /**
+     * @brief Constructs a list with the given elements.
+     *
+     * @tparam Args the types of the elements
+     * @param xs the `N` elements of this list
+     */
+    template<
+        typename... Args,
+        typename = typename std::enable_if<
+            sizeof...(Args) == N &&
+            AllTrue<std::is_convertible<Args, A>::value...>::value
+        >::type
+    >
+    constexpr explicit StaticList(Args&&... xs)
+        : s_(static_cast<Args&&>(xs)...)
+    {}
+
+    /**
+     * @brief Returns `true` if this list contains no elements, `false`
+     *        otherwise.
+     *
+     * @return `true` if this list contains no elements, `false` otherwise
+     */
+    constexpr bool isEmpty() const
+    {
+        return N == 0;
+    }
+
+    /**
+     * @brief Returns the number of elements of this list.
+     *
+     * @return the number of elements of this list
+     */
+    constexpr std::size_t size() const
+    {
+        return N;
+    }
+
+    /**
+     * @brief Returns the first element of this list.
+     *
+     * @return the first element of this list
+     * @throws std::out_of_range if this list is empty
+     */
+    constexpr const A& head() const
+    {
+        return N > 0 ? at(0) : throw std::out_of_range("head of empty list");
+    }
+
+    /**
+     * @brief Returns the last element of this list.
+     *
+     * @return the last element of this list
+     * @throws std::out_of_range if this list is empty
+     */
+    constexpr const A& last() const
+    {
+        return N > 0 ? at(N - 1) : throw std::out_of_range("last of empty list");
+    }
+
+    /**
+     * @brief Returns the element at the specified position of this list.
+     *
+     * @param index index of the element to return
+     * @return the element at the specified position of this list
+     * @throws std::out_of_range if `index` is out of range (`index >= size()`)
+     */
+    constexpr const A& operator[](std::size_t index) const
+    {
+        return index < N ? at(index) : throw std::out_of_range("index out of range");
+    }
+
+    /**
+     * @brief Applies a function to each element of this list.
+     *
+     * @tparam Fn the type of the function to apply
+     * @param f the function to apply to each element of this list
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        for (const auto& x : *this) {
+            f(x);
+        }
+    }
+
+    /**
+     * @brief Returns a new list resulting from applying a function to
+     *        each element of this list.
+     *
+     * @tparam Fn the type of the function to apply
+     * @tparam B the result type of the function
+     * @param f the function to apply to each element of this list
+     * @return a new list of the results of applying `f` to each element of
+     *         this list
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, const A&>>>
+    constexpr StaticList<B, N> map(Fn f) const
+    {
+        return mapImpl<B>(f, typename GenSeq<N>::type());
+    }
+
+    /**
+     * @brief Returns all elements of this list that satisfy a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return a list consisting of all elements of this list that satisfy
+     *         the given predicate `p`, in order
+     */
+    template<typename Fn>
+    List<A> filter(Fn p) const
+    {
+        ListBuilder<A> buf;
+        for (const auto& x : *this) {
+            if (p(x)) {
+                buf.append(x);
+            }
+        }
+        return buf.result();
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this list, going left to right.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this list, going left to right with the start value `z`
+     *         on the left, or `z` if this list is empty
+     */
+    template<typename B, typename Fn>
+    constexpr B foldLeft(B z, Fn op) const
+    {
+        return foldLeftFrom(0, z, op);
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this list, going right to left.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this list, going right to left with the start value `z`
+     *         on the right, or `z` if this list is empty
+     */
+    template<typename B, typename Fn>
+    constexpr B foldRight(B z, Fn op) const
+    {
+        return foldRightFrom(N, z, op);
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for some element of this list.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return `true` if the given predicate `p` holds for some element of
+     *         this list, `false` otherwise
+     */
+    template<typename Fn>
+    constexpr bool exists(Fn p) const
+    {
+        return existsFrom(0, p);
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for all elements of this list.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return `true` if this list is empty or the given predicate `p`
+     *         holds for all elements of this list, `false` otherwise
+     */
+    template<typename Fn>
+    constexpr bool forall(Fn p) const
+    {
+        return forallFrom(0, p);
+    }
+
+    /**
+     * @brief Tests whether this list contains a given value as an element.
+     *
+     * @param x the value to test
+     * @return `true` if this list has an element that is equal (as
+     *         determined by `==`) to `x`, `false` otherwise
+     */
+    constexpr bool contains(const A& x) const
+    {
+        return containsFrom(0, x);
+    }
+
+    /**
+     * @brief Counts the number of elements in this list that satisfy
+     *        a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return the number of elements satisfying the given predicate `p`
+     */
+    template<typename Fn>
+    constexpr std::size_t count(Fn p) const
+    {
+        return countFrom(0, p);
+    }
+
+    /**
+     * @brief Returns a list of the elements of this list.
+     *
+     * @tparam Alloc the allocator type of the returned list
+     * @param alloc the allocator used by the returned list
+     * @return a list of copies of the elements of this list, in order
+     */
+    template<typename Alloc = std::allocator<A>>
+    List<A, Alloc> toList(const Alloc& alloc = Alloc()) const
+    {
+        ListBuilder<A, Alloc> buf(alloc);
+        for (const auto& x : *this) {
+            buf.append(x);
+        }
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns an iterator to the first element of this list.
+     *
+     * @return an iterator to the first element of this list
+     */
+    constexpr StdIterator begin() const
+    {
+        return s_.data();
+    }
+
+    /**
+     * @brief Returns an iterator past the last element of this list.
+     *
+     * @return an iterator past the last element of this list
+     */
+    constexpr StdIterator end() const
+    {
+        return N > 0 ? s_.data() + N : s_.data();
+    }
+
+    /**
+     * @brief Compares this list with the given list for equality.
+     *
+     * @param that the list to be compared for equality with this list
+     * @return `true` if the elements of `that` are equal to those of this
+     *         list, in order, `false` otherwise
+     */
+    constexpr bool operator==(const StaticList& that) const
+    {
+        return equalFrom(0, that);
+    }
+
+    /**
+     * @brief Compares this list with the given list for inequality.
+     *
+     * @param that the list to be compared for inequality with this list
+     * @return `true` if the elements of `that` are not equal to those of
+     *         this list, in order, `false` otherwise
+     */
+    constexpr bool operator!=(const StaticList& that) const
+    {
+        return !(*this == that);
+    }
+
+private:
+    // The members below recurse rather than loop, as C++11 `constexpr`
+    // functions consist of a single return statement; `N` is small.
+
+    constexpr const A& at(std::size_t i) const
+    {
+        return s_.data()[i];
+    }
+
+    template<typename B, typename Fn, std::size_t... S>
+    constexpr StaticList<B, N> mapImpl(const Fn& f, Seq<S...>) const
+    {
+        return StaticList<B, N>(f(at(S))...);
+    }
+
+    template<typename B, typename Fn>
+    constexpr B foldLeftFrom(std::size_t i, B z, const Fn& op) const
+    {
+        return i == N ? z : foldLeftFrom(i + 1, op(z, at(i)), op);
+    }
+
+    template<typename B, typename Fn>
+    constexpr B foldRightFrom(std::size_t i, B z, const Fn& op) const
+    {
+        return i == 0 ? z : foldRightFrom(i - 1, op(at(i - 1), z), op);
+    }
+
+    template<typename Fn>
+    constexpr bool existsFrom(std::size_t i, const Fn& p) const
+    {
+        return i < N && (p(at(i)) || existsFrom(i + 1, p));
+    }
+
+    template<typename Fn>
+    constexpr bool forallFrom(std::size_t i, const Fn& p) const
+    {
+        return i == N || (p(at(i)) && forallFrom(i + 1, p));
+    }
+
+    constexpr bool containsFrom(std::size_t i, const A& x) const
+    {
+        return i < N && (at(i) == x || containsFrom(i + 1, x));
+    }
+
+    template<typename Fn>
+    constexpr std::size_t countFrom(std::size_t i, const Fn& p) const
+    {
+        return i == N ? 0 : (p(at(i)) ? 1 : 0) + countFrom(i + 1, p);
+    }
+
+    constexpr bool equalFrom(std::size_t i, const StaticList& that) const
+    {
+        return i == N || (at(i) == that.at(i) && equalFrom(i + 1, that));
+    }
+
+    detail::StaticStorage<A, N> s_;
+};
+
+/**
+ * @brief Returns a `StaticList` of the given elements.
+ *
+ * @tparam A the type of the first element, and of all elements
+ * @tparam Args the types of the other elements
+ * @param x the first element
+ * @param xs the other elements
+ * @return a `StaticList` of `x` and `xs`, in order
+ */
+template<typename A, typename... Args>
+constexpr StaticList<Decay<A>, sizeof...(Args) + 1> staticList(A&& x, Args&&... xs)
+{
+    return StaticList<Decay<A>, sizeof...(Args) + 1>(
+        static_cast<A&&>(x), static_cast<Args&&>(xs)...);
+}
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_STATIC_LIST_HPP
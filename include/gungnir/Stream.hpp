@@ -0,0 +1,700 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/Stream.hpp
+ * A lazily evaluated persistent list.
+ */
+
+#ifndef GUNGNIR_STREAM_HPP
+#define GUNGNIR_STREAM_HPP
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gungnir/List.hpp"
+#include "gungnir/Option.hpp"
+#include "gungnir/lazy.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+/**
+ * @brief A lazily evaluated, memoizing, persistent list.
+ *
+ * The head of a non-empty stream is evaluated when the stream is created;
+ * its tail is computed on first access, through a `SyncLazyVal`, and then
+ * remembered, so a stream can be infinite and each element is computed at
+ * most once, even if the stream is shared across threads. Transformations
+ * such as `map()` and `filter()` are lazy as well.
+ *
+ * A stream keeps every element it has computed for as long as it is
+ * reachable, while elements in front of the last stream still held are
+ * freed as they are passed by. Consuming a prefix of a huge or infinite
+ * stream therefore runs in bounded memory, provided the head is not held
+ * on to, e.g. `Stream<int>::iterate(0, inc).take(n).foldLeft(0, plus)`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements; must be a non-reference type
+ */
+template<typename A>
+class Stream final {
+    class Cell;
+    class Later;
+
+public:
+    /**
+     * @brief A `ForwardIterator` for a `Stream`.
+     */
+    class StdIterator;
+
+    /**
+     * @brief Constructs an empty stream.
+     */
+    Stream() noexcept = default;
+
+    /**
+     * @brief Constructs a stream with the given head and an already
+     *        evaluated tail.
+     *
+     * @param head the first element of this stream
+     * @param tail all elements of this stream except the first one
+     */
+    Stream(A head, Stream tail)
+        : Stream(cons(std::move(head), [tail] { return tail; }))
+    {
+        // Forced right away, so that a long chain of such streams is freed
+        // in a loop rather than through nested destructors.
+        cell_->tail.get();
+    }
+
+    /**
+     * @brief Returns a stream with the given head and a tail computed by
+     *        `tail()` on first access.
+     *
+     * @tparam Fn the type of the function computing the tail
+     * @param head the first element of the returned stream
+     * @param tail the function returning all elements of the returned
+     *             stream except the first one
+     * @return a stream with the given head and lazily computed tail
+     */
+    template<typename Fn>
+    static Stream cons(A head, Fn tail)
+    {
+        return Stream(std::make_shared<Cell>(std::move(head), std::function<Stream()>(std::move(tail))));
+    }
+
+    /**
+     * @brief Returns the infinite stream `x`, `f(x)`, `f(f(x))`, ...
+     *
+     * @tparam Fn the type of the function computing each next element
+     * @param x the first element
+     * @param f the function computing each next element from the previous one
+     * @return the infinite stream of repeated applications of `f` to `x`
+     */
+    template<typename Fn>
+    static Stream iterate(A x, Fn f)
+    {
+        const auto y = x;
+        return cons(std::move(x), [y, f] { return iterate(f(y), f); });
+    }
+
+    /**
+     * @brief Returns the stream of elements produced by repeatedly applying
+     *        a function to a state, until it returns an empty `Option`.
+     *
+     * `f(s)` returns either the next element and the next state, or an
+     * empty `Option` to end the stream. Each call is made only once the
+     * element it produces is needed, so `f` can e.g. read one page of
+     * results at a time.
+     *
+     * @tparam S the type of the state
+     * @tparam Fn the type of the function producing elements
+     * @param s the initial state
+     * @param f the function producing elements
+     * @return the stream of elements produced by `f`
+     */
+    template<typename S, typename Fn>
+    static Stream unfold(S s, Fn f)
+    {
+        auto next = f(std::move(s));
+        if (next.isEmpty()) {
+            return Stream();
+        }
+        auto& p = next.get();
+        auto rest = std::move(p.second);
+        return cons(std::move(p.first), [rest, f] { return unfold(rest, f); });
+    }
+
+    /**
+     * @brief Returns the stream of records parsed from an input stream.
+     *
+     * `parse(in)` returns either the next record or an empty `Option` at
+     * the end of the input. Records are parsed `chunk` at a time, once the
+     * first of them is needed, so consuming the returned stream with
+     * `foldLeft()` or `foreach()` on an rvalue holds at most about `chunk`
+     * records at once, however long the input is. `in` must outlive the
+     * returned stream.
+     *
+     * @tparam Fn the type of the parser
+     * @param in the input stream to read from
+     * @param parse the parser reading one record from `in`
+     * @param chunk the number of records parsed at a time; must be positive
+     * @return the stream of records parsed from `in`
+     */
+    template<typename Fn>
+    static Stream fromInput(std::istream& in, Fn parse, std::size_t chunk = 256)
+    {
+        std::vector<A> buf;
+        buf.reserve(chunk);
+        while (buf.size() < chunk) {
+            auto x = parse(in);
+            if (x.isEmpty()) {
+                break;
+            }
+            buf.push_back(std::move(*x.ptr()));
+        }
+        const auto p = &in;
+        return fromChunk(buf, chunk, [p, parse, chunk] {
+            return fromInput(*p, parse, chunk);
+        });
+    }
+
+    /**
+     * @brief Returns the stream of the elements in the range
+     *        [`first`, `last`), read lazily.
+     *
+     * The range only needs to be single-pass, e.g. a range of
+     * `std::istream_iterator`s; it is read `chunk` elements at a time, as
+     * with `fromInput()`.
+     *
+     * @tparam InputIt the type of the iterators
+     * @param first the iterator pointing to the start of the range
+     * @param last the iterator pointing to the end of the range
+     * @param chunk the number of elements read at a time; must be positive
+     * @return the stream of the elements in the range
+     */
+    template<
+        typename InputIt,
+        typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<InputIt>::value_type, A
+        >::value>::type
+    >
+    static Stream from(InputIt first, InputIt last, std::size_t chunk = 256)
+    {
+        std::vector<A> buf;
+        buf.reserve(chunk);
+        for (; buf.size() < chunk && first != last; ++first) {
+            buf.push_back(*first);
+        }
+        return fromChunk(buf, chunk, [first, last, chunk] {
+            return from(first, last, chunk);
+        });
+    }
+
+    /**
+     * @brief Returns `true` if this stream contains no elements.
+     *
+     * @return `true` if this stream contains no elements, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return !cell_;
+    }
+
+    /**
+     * @brief Returns the first element of this stream.
+     *
+     * @return the first element of this stream
+     * @throws std::out_of_range if this stream is empty
+     */
+    const A& head() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("head of empty stream");
+        }
+        return cell_->head;
+    }
+
+    /**
+     * @brief Returns all elements of this stream except the first one,
+     *        computing them if necessary.
+     *
+     * @return all elements of this stream except the first one
+     * @throws std::out_of_range if this stream is empty
+     */
+    const Stream& tail() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("tail of empty stream");
+        }
+        return cell_->tail.get();
+    }
+
+    /**
+     * @brief Returns `true` if the tail of this stream has been computed.
+     *
+     * @return `true` if this stream is non-empty and its tail has been
+     *         computed, `false` otherwise
+     */
+    bool isTailForced() const
+    {
+        return cell_ && cell_->tail.isForced();
+    }
+
+    /**
+     * @brief Applies a function to each element of this stream.
+     *
+     * @tparam Fn the type of the function to apply
+     * @param f the function to apply to each element of this stream
+     */
+    template<typename Fn>
+    void foreach(Fn f) const&
+    {
+        for (auto c = cell_.get(); c; c = c->tail.get().cell_.get()) {
+            f(c->head);
+        }
+    }
+
+    /**
+     * @brief Applies a function to each element of this stream, freeing
+     *        elements after they have been passed to `f` if nothing else
+     *        holds them.
+     *
+     * @tparam Fn the type of the function to apply
+     * @param f the function to apply to each element of this stream
+     */
+    template<typename Fn>
+    void foreach(Fn f) &&
+    {
+        for (auto s = std::move(*this); !s.isEmpty(); s = Stream(s.tail())) {
+            f(s.cell_->head);
+        }
+    }
+
+    /**
+     * @brief Returns a stream resulting from lazily applying a function to
+     *        each element of this stream.
+     *
+     * @tparam Fn the type of the function to apply
+     * @tparam B the element type of the returned stream
+     * @param f the function to apply to each element of this stream
+     * @return a stream of the results of applying `f` to each element of
+     *         this stream
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    Stream<B> map(Fn f) const&
+    {
+        return mapImpl(*this, std::move(f));
+    }
+
+    /**
+     * @brief Returns a stream resulting from lazily applying a function to
+     *        each element of this stream, which is left empty.
+     *
+     * Unlike with `map() const&`, this stream does not keep the elements it
+     * computes alive once the returned stream has moved past them.
+     *
+     * @tparam Fn the type of the function to apply
+     * @tparam B the element type of the returned stream
+     * @param f the function to apply to each element of this stream
+     * @return a stream of the results of applying `f` to each element of
+     *         this stream
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    Stream<B> map(Fn f) &&
+    {
+        return mapImpl(std::move(*this), std::move(f));
+    }
+
+    /**
+     * @brief Returns a stream of the elements of this stream that satisfy a
+     *        predicate.
+     *
+     * Elements are tested lazily, except that finding the first element
+     * that satisfies `p` evaluates the stream up to it.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return a stream of the elements of this stream that satisfy `p`
+     */
+    template<typename Fn>
+    Stream filter(Fn p) const&
+    {
+        return filterImpl(*this, std::move(p));
+    }
+
+    /**
+     * @brief Returns a stream of the elements of this stream that satisfy a
+     *        predicate, leaving this stream empty.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return a stream of the elements of this stream that satisfy `p`
+     */
+    template<typename Fn>
+    Stream filter(Fn p) &&
+    {
+        return filterImpl(std::move(*this), std::move(p));
+    }
+
+    /**
+     * @brief Returns a stream of the first `n` elements of this stream.
+     *
+     * @param n the number of elements to take
+     * @return a stream of the first `n` elements of this stream, or all of
+     *         them if there are fewer
+     */
+    Stream take(std::size_t n) const&
+    {
+        return takeImpl(*this, n);
+    }
+
+    /**
+     * @brief Returns a stream of the first `n` elements of this stream,
+     *        leaving this stream empty.
+     *
+     * @param n the number of elements to take
+     * @return a stream of the first `n` elements of this stream, or all of
+     *         them if there are fewer
+     */
+    Stream take(std::size_t n) &&
+    {
+        return takeImpl(std::move(*this), n);
+    }
+
+    /**
+     * @brief Returns this stream without its first `n` elements.
+     *
+     * @param n the number of elements to drop
+     * @return this stream without its first `n` elements, or an empty
+     *         stream if there are fewer
+     */
+    Stream drop(std::size_t n) const&
+    {
+        return dropImpl(*this, n);
+    }
+
+    /**
+     * @brief Returns this stream without its first `n` elements, leaving
+     *        this stream empty.
+     *
+     * @param n the number of elements to drop
+     * @return this stream without its first `n` elements, or an empty
+     *         stream if there are fewer
+     */
+    Stream drop(std::size_t n) &&
+    {
+        return dropImpl(std::move(*this), n);
+    }
+
+    /**
+     * @brief Returns a stream of pairs of corresponding elements of this
+     *        stream and `that`, as long as the shorter of the two.
+     *
+     * @tparam B the element type of `that`
+     * @param that the stream to zip with
+     * @return a stream of pairs of corresponding elements
+     */
+    template<typename B>
+    Stream<std::pair<A, B>> zip(Stream<B> that) const&
+    {
+        return zipImpl(*this, std::move(that));
+    }
+
+    /**
+     * @brief Returns a stream of pairs of corresponding elements of this
+     *        stream and `that`, as long as the shorter of the two, leaving
+     *        this stream empty.
+     *
+     * @tparam B the element type of `that`
+     * @param that the stream to zip with
+     * @return a stream of pairs of corresponding elements
+     */
+    template<typename B>
+    Stream<std::pair<A, B>> zip(Stream<B> that) &&
+    {
+        return zipImpl(std::move(*this), std::move(that));
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this stream, going left to right.
+     *
+     * The stream must be finite.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this stream, going left to right with the start value `z`
+     *         on the left, or `z` if this stream is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) const&
+    {
+        foreach([&z, &op](const A& x) { z = op(std::move(z), x); });
+        return z;
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this stream, going left to right, freeing elements after
+     *        they have been folded if nothing else holds them.
+     *
+     * The stream must be finite.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this stream, going left to right with the start value `z`
+     *         on the left, or `z` if this stream is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) &&
+    {
+        std::move(*this).foreach([&z, &op](const A& x) { z = op(std::move(z), x); });
+        return z;
+    }
+
+    /**
+     * @brief Returns a list of all elements of this stream, which must be
+     *        finite.
+     *
+     * @return a list of all elements of this stream
+     */
+    List<A> toList() const
+    {
+        ListBuilder<A> buf;
+        foreach([&buf](const A& x) { buf.append(x); });
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns an iterator to the first element of this stream.
+     *
+     * @return an iterator to the first element of this stream
+     */
+    StdIterator begin() const
+    {
+        return StdIterator(*this);
+    }
+
+    /**
+     * @brief Returns an iterator past the last element of this stream.
+     *
+     * @return an iterator past the last element of this stream
+     */
+    StdIterator end() const
+    {
+        return StdIterator(Stream());
+    }
+
+private:
+    template<typename>
+    friend class Stream;
+
+    friend union detail::LazyStorage<Stream, Later>;
+
+    explicit Stream(std::shared_ptr<Cell> cell) noexcept : cell_(std::move(cell)) {}
+
+    // The transformations take their source by value, and only the thunks
+    // computing the tails hold on to it, so that an rvalue source does not
+    // keep the elements alive.
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    static Stream<B> mapImpl(Stream self, Fn f)
+    {
+        if (self.isEmpty()) {
+            return Stream<B>();
+        }
+        auto x = f(self.head());
+        return Stream<B>::cons(std::move(x), [self, f] { return self.tail().map(f); });
+    }
+
+    template<typename Fn>
+    static Stream filterImpl(Stream self, Fn p)
+    {
+        while (!self.isEmpty() && !p(self.head())) {
+            self = Stream(self.tail());
+        }
+        if (self.isEmpty()) {
+            return self;
+        }
+        auto x = self.head();
+        return cons(std::move(x), [self, p] { return self.tail().filter(p); });
+    }
+
+    static Stream takeImpl(Stream self, std::size_t n)
+    {
+        if (n == 0 || self.isEmpty()) {
+            return Stream();
+        } else if (n == 1) {
+            return cons(self.head(), [] { return Stream(); });
+        }
+        auto x = self.head();
+        return cons(std::move(x), [self, n] { return self.tail().take(n - 1); });
+    }
+
+    static Stream dropImpl(Stream self, std::size_t n)
+    {
+        for (; n > 0 && !self.isEmpty(); --n) {
+            self = Stream(self.tail());
+        }
+        return self;
+    }
+
+    // Returns the stream of the elements of `buf` followed by those of
+    // `rest()`, which is only called, once the last element is passed, if
+    // `buf` holds a full chunk; a shorter one ends its input.
+    template<typename Fn>
+    static Stream fromChunk(std::vector<A>& buf, std::size_t chunk, Fn rest)
+    {
+        if (buf.empty()) {
+            return Stream();
+        }
+        auto s = buf.size() < chunk
+            ? Stream(std::move(buf.back()), Stream())
+            : cons(std::move(buf.back()), std::move(rest));
+        for (auto i = buf.size() - 1; i > 0; --i) {
+            s = Stream(std::move(buf[i - 1]), std::move(s));
+        }
+        return s;
+    }
+
+    template<typename B>
+    static Stream<std::pair<A, B>> zipImpl(Stream self, Stream<B> that)
+    {
+        if (self.isEmpty() || that.isEmpty()) {
+            return Stream<std::pair<A, B>>();
+        }
+        std::pair<A, B> x(self.head(), that.head());
+        return Stream<std::pair<A, B>>::cons(std::move(x), [self, that] {
+            return self.tail().zip(that.tail());
+        });
+    }
+
+    // The tail of a cell, computed the first time it is forced.
+    explicit Stream(Later later) : Stream(later.f()) {}
+
+    std::shared_ptr<Cell> cell_;
+};
+
+/// @cond
+template<typename A>
+class Stream<A>::Later final {
+public:
+    explicit Later(std::function<Stream()> f) noexcept : f(std::move(f)) {}
+
+    std::function<Stream()> f;
+};
+
+template<typename A>
+class Stream<A>::Cell final {
+public:
+    Cell(A head, std::function<Stream()> f)
+        : head(std::move(head))
+        , tail(Later(std::move(f)))
+    {}
+
+    Cell(const Cell&) = delete;
+    Cell& operator=(const Cell&) = delete;
+
+    // Unlinks the chain of computed tails that only this cell holds in a
+    // loop rather than through nested destructors, so that dropping a long
+    // computed stream does not exhaust the stack.
+    ~Cell()
+    {
+        if (!tail.isForced()) {
+            return;
+        }
+        auto next = std::move(tail.get().cell_);
+        while (next && next.use_count() == 1 && next->tail.isForced()) {
+            auto after = std::move(next->tail.get().cell_);
+            next = std::move(after);
+        }
+    }
+
+    const A head;
+    SyncLazyVal<Stream, Later> tail;
+};
+
+template<typename A>
+class Stream<A>::StdIterator final {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = A;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const A*;
+    using reference = const A&;
+
+    StdIterator() = default;
+
+    StdIterator& operator++()
+    {
+        s_ = Stream(s_.tail());
+        return *this;
+    }
+
+    StdIterator operator++(int)
+    {
+        auto it = *this;
+        ++*this;
+        return it;
+    }
+
+    bool operator==(const StdIterator& that) const
+    {
+        return s_.cell_ == that.s_.cell_;
+    }
+
+    bool operator!=(const StdIterator& that) const
+    {
+        return !(*this == that);
+    }
+
+    const A& operator*() const
+    {
+        return s_.cell_->head;
+    }
+
+    const A* operator->() const
+    {
+        return &s_.cell_->head;
+    }
+
+private:
+    friend class Stream;
+
+    explicit StdIterator(Stream s) noexcept : s_(std::move(s)) {}
+
+    Stream s_;
+};
+/// @endcond
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_STREAM_HPP
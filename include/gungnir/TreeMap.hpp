@@ -0,0 +1,554 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/TreeMap.hpp
+ * A persistent sorted map with logarithmic updates and range queries.
+ */
+
+#ifndef GUNGNIR_TREE_MAP_HPP
+#define GUNGNIR_TREE_MAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "gungnir/List.hpp"
+#include "gungnir/Option.hpp"
+#include "gungnir/detail/util.hpp"
+#include "gungnir/detail/wbtree.hpp"
+
+namespace gungnir {
+
+using namespace detail;
+
+/**
+ * @brief An immutable map whose entries are sorted by key.
+ *
+ * The entries are stored in a weight-balanced binary search tree. Lookups,
+ * `updated()` and `removed()` take O(log n) time, and maps derived from
+ * one another share all but the modified paths of their trees. `range()`
+ * cuts out the entries between two keys in O(log n) time, sharing the
+ * subtrees that lie wholly inside the range, so that visiting the k
+ * entries of a range takes O(log n + k) time in all.
+ *
+ * The entries are visited in ascending order of keys.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam K the type of the keys; must be copy constructible
+ * @tparam V the type of the values; must be copy constructible
+ * @tparam Cmp the type of the strict weak ordering of the keys, which is
+ *             default constructed to compare each pair of keys
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               this map
+ */
+template<
+    typename K,
+    typename V,
+    typename Cmp = std::less<K>,
+    typename Alloc = std::allocator<std::pair<const K, V>>
+>
+class TreeMap final {
+public:
+    /** @brief The type of the entries. */
+    using value_type = std::pair<const K, V>;
+
+    /**
+     * @brief Constructs an empty map.
+     */
+    TreeMap() noexcept : TreeMap(Alloc()) {}
+
+    /**
+     * @brief Constructs an empty map whose nodes will be allocated
+     *        with `alloc`.
+     *
+     * @param alloc the allocator used by this map and the maps derived
+     *              from it
+     */
+    explicit TreeMap(const Alloc& alloc) noexcept : tree_(alloc) {}
+
+    /**
+     * @brief Constructs a map with the given entries. Of entries with equal
+     *        keys, the last one is kept.
+     *
+     * @param entries the entries of this map
+     * @param alloc the allocator used by this map and the maps derived
+     *              from it
+     */
+    TreeMap(std::initializer_list<value_type> entries, const Alloc& alloc = Alloc())
+        : TreeMap(entries.begin(), entries.end(), alloc)
+    {}
+
+    /**
+     * @brief Constructs a map with the entries in the range [`first`, `last`).
+     *        Of entries with equal keys, the last one is kept.
+     *
+     * This takes O(n log n) time; see `fromSorted()` for entries already
+     * sorted by key.
+     *
+     * @tparam InputIt the type of the iterators
+     * @param first the iterator pointing to the start of the range
+     * @param last the iterator pointing to the end of the range
+     * @param alloc the allocator used by this map and the maps derived
+     *              from it
+     */
+    template<
+        typename InputIt,
+        typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<InputIt>::value_type, value_type
+        >::value>::type
+    >
+    TreeMap(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : tree_(alloc)
+    {
+        for (; first != last; ++first) {
+            tree_.insert(*first);
+        }
+    }
+
+    /** @brief Default copy constructor. */
+    TreeMap(const TreeMap&) = default;
+
+    /** @brief Move constructor. The moved-from map is left empty. */
+    TreeMap(TreeMap&&) = default;
+
+    /** @brief Default copy assignment operator. */
+    TreeMap& operator=(const TreeMap&) = default;
+
+    /** @brief Move assignment operator. The moved-from map is left empty. */
+    TreeMap& operator=(TreeMap&&) = default;
+
+    /**
+     * @brief Returns a map with the entries of a list sorted by key, in
+     *        O(n) time.
+     *
+     * Of consecutive entries with equal keys, the last one is kept, so a list
+     * sorted by key with `List::sorted()` can be passed as is.
+     *
+     * @tparam B the type of the elements of the list; pairs of a key and
+     *           a value
+     * @tparam BAlloc the type of the allocator of the list
+     * @param entries the entries of the map, in ascending order of keys
+     * @param alloc the allocator used by the returned map and the maps
+     *              derived from it
+     * @return a map with the entries of `entries`
+     * @throws std::invalid_argument if `entries` is not sorted by key
+     */
+    template<typename B, typename BAlloc>
+    static TreeMap fromSorted(const List<B, BAlloc>& entries, const Alloc& alloc = Alloc())
+    {
+        TreeMap m(alloc);
+        m.tree_.assignSorted(entries.begin(), entries.end());
+        return m;
+    }
+
+    /**
+     * @brief Returns a copy of the allocator used by this map.
+     *
+     * @return a copy of the allocator used by this map
+     */
+    Alloc allocator() const
+    {
+        return tree_.allocator();
+    }
+
+    /**
+     * @brief Returns `true` if this map contains no entries, `false` otherwise.
+     *
+     * @return `true` if this map contains no entries, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Returns the number of entries of this map.
+     *
+     * @return the number of entries of this map
+     */
+    std::size_t size() const
+    {
+        return tree_.size();
+    }
+
+    /**
+     * @brief Tests whether this map has an entry with the given key.
+     *
+     * @param key the key to look up
+     * @return `true` if this map has an entry with key `key`, `false` otherwise
+     */
+    bool contains(const K& key) const
+    {
+        return tree_.find(key) != nullptr;
+    }
+
+    /**
+     * @brief Returns the value associated with a key, if any.
+     *
+     * @param key the key to look up
+     * @return an option referring to the value associated with `key`, which
+     *         is empty if there is none; valid as long as this map is alive
+     */
+    UnownedOption<const V> get(const K& key) const
+    {
+        const auto e = tree_.find(key);
+        return UnownedOption<const V>(e ? &e->second : nullptr);
+    }
+
+    /**
+     * @brief Returns the value associated with a key.
+     *
+     * @param key the key to look up
+     * @return the value associated with `key`
+     * @throws std::out_of_range if this map has no entry with key `key`
+     */
+    const V& operator[](const K& key) const
+    {
+        const auto e = tree_.find(key);
+        if (!e) {
+            throw std::out_of_range("key not found");
+        }
+        return e->second;
+    }
+
+    /**
+     * @brief Returns the entry with the least key, if any.
+     *
+     * @return an option referring to the entry with the least key, which
+     *         is empty if this map is empty; valid as long as this map is
+     *         alive
+     */
+    UnownedOption<const value_type> min() const
+    {
+        return UnownedOption<const value_type>(tree_.min());
+    }
+
+    /**
+     * @brief Returns the entry with the greatest key, if any.
+     *
+     * @return an option referring to the entry with the greatest key, which
+     *         is empty if this map is empty; valid as long as this map is
+     *         alive
+     */
+    UnownedOption<const value_type> max() const
+    {
+        return UnownedOption<const value_type>(tree_.max());
+    }
+
+    /**
+     * @brief Returns a copy of this map in which a key is associated with
+     *        a new value.
+     *
+     * Only the tree nodes on the path to the entry are copied, along with
+     * those rotated to rebalance it.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `V`
+     * @param key the key of the entry
+     * @param args the arguments passed to the constructor of `V`
+     * @return a copy of this map in which `key` is associated with a value
+     *         constructed in-place from `args`
+     */
+    template<typename... Args>
+    TreeMap updated(const K& key, Args&&... args) const
+    {
+        TreeMap m(*this);
+        m.tree_.insert(value_type(std::piecewise_construct,
+                                  std::forward_as_tuple(key),
+                                  std::forward_as_tuple(std::forward<Args>(args)...)));
+        return m;
+    }
+
+    /**
+     * @brief Returns a copy of this map without the entry with a key.
+     *
+     * Only the tree nodes on the path to the entry are copied, along with
+     * those rotated to rebalance it; if there is no such entry, the whole
+     * tree is shared.
+     *
+     * @param key the key of the entry to remove
+     * @return a copy of this map without an entry with key `key`
+     */
+    TreeMap removed(const K& key) const
+    {
+        TreeMap m(*this);
+        m.tree_.erase(key);
+        return m;
+    }
+
+    /**
+     * @brief Returns the entries of this map whose keys lie in
+     *        [`lo`, `hi`), in O(log n) time.
+     *
+     * @param lo the least key of the range
+     * @param hi the key right past the range
+     * @return a map of the entries of this map with keys not less than
+     *         `lo` and less than `hi`
+     */
+    TreeMap range(const K& lo, const K& hi) const
+    {
+        TreeMap m(*this);
+        m.tree_.restrict(&lo, &hi);
+        return m;
+    }
+
+    /**
+     * @brief Returns the entries of this map whose keys are not less
+     *        than `lo`, in O(log n) time.
+     *
+     * @param lo the least key of the range
+     * @return a map of the entries of this map with keys not less than `lo`
+     */
+    TreeMap from(const K& lo) const
+    {
+        TreeMap m(*this);
+        m.tree_.restrict(&lo, nullptr);
+        return m;
+    }
+
+    /**
+     * @brief Returns the entries of this map whose keys are less than `hi`,
+     *        in O(log n) time.
+     *
+     * @param hi the key right past the range
+     * @return a map of the entries of this map with keys less than `hi`
+     */
+    TreeMap until(const K& hi) const
+    {
+        TreeMap m(*this);
+        m.tree_.restrict(nullptr, &hi);
+        return m;
+    }
+
+    /**
+     * Applies a function to each entry of this map, in ascending order
+     * of keys.
+     *
+     * @param f the function to apply, for its side-effect,
+     *          to each entry of this map
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        tree_.foreachWhile([&f](const value_type& e) {
+            f(e);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Returns a map with the same keys as this map, whose values
+     *        result from applying a function to each entry of this map.
+     *
+     * The keys are not compared again: the returned map has the same shape
+     * as this one.
+     *
+     * @tparam Fn the type of the function
+     * @tparam B the result type of the function
+     * @param f the function to apply to each entry of this map
+     * @return a map associating the key of each entry `e` of this map with
+     *         `f(e)`
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, const value_type&>>>
+    TreeMap<K, B, Cmp, Rebind<Alloc, std::pair<const K, B>>> map(Fn f) const
+    {
+        using M = TreeMap<K, B, Cmp, Rebind<Alloc, std::pair<const K, B>>>;
+        M m(allocator());
+        m.tree_ = tree_.template mapEntries<typename M::Tree>([&f](const value_type& e) {
+            return std::pair<const K, B>(e.first, f(e));
+        });
+        return m;
+    }
+
+    /**
+     * @brief Returns all entries of this map that satisfy a predicate.
+     *
+     * The subtrees all of whose entries satisfy the predicate are shared.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test entries
+     * @return a new map consisting of all entries of this map that
+     *         satisfy the given predicate `p`
+     */
+    template<typename Fn>
+    TreeMap filter(Fn p) const
+    {
+        TreeMap m(allocator());
+        m.tree_ = tree_.filter(std::move(p));
+        return m;
+    }
+
+    /**
+     * @brief Returns all entries of this map that violate a predicate.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test entries
+     * @return a new map consisting of all entries of this map that
+     *         violate the given predicate `p`
+     */
+    template<typename Fn>
+    TreeMap filterNot(Fn p) const
+    {
+        return filter([&p](const value_type& e) { return !p(e); });
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for some entry of this map.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test entries
+     * @return `true` if the given predicate `p` holds for some entry of
+     *         this map, `false` otherwise
+     */
+    template<typename Fn>
+    bool exists(Fn p) const
+    {
+        return !tree_.foreachWhile([&p](const value_type& e) { return !p(e); });
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for all entries of this map.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test entries
+     * @return `true` if this map is empty or the given predicate `p`
+     *         holds for all entries of this map, `false` otherwise
+     */
+    template<typename Fn>
+    bool forall(Fn p) const
+    {
+        return tree_.foreachWhile([&p](const value_type& e) { return static_cast<bool>(p(e)); });
+    }
+
+    /**
+     * @brief Counts the number of entries in this map that satisfy
+     *        a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test entries
+     * @return the number of entries satisfying the given predicate `p`
+     */
+    template<typename Fn>
+    std::size_t count(Fn p) const
+    {
+        std::size_t n = 0;
+        foreach([&p, &n](const value_type& e) {
+            if (p(e)) {
+                ++n;
+            }
+        });
+        return n;
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all entries of
+     *        this map, in ascending order of keys.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive entries of
+     *         this map, with the start value `z` on the left, or `z` if
+     *         this map is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) const
+    {
+        foreach([&z, &op](const value_type& e) {
+            z = op(std::move(z), e);
+        });
+        return z;
+    }
+
+    /**
+     * @brief Returns a list of the entries of this map, in ascending order
+     *        of keys.
+     *
+     * @return a list of the entries of this map
+     */
+    List<value_type, Alloc> toList() const
+    {
+        ListBuilder<value_type, Alloc> buf(allocator());
+        foreach([&buf](const value_type& e) {
+            buf.append(e);
+        });
+        return buf.result();
+    }
+
+    /**
+     * @brief Compares this map with the given map for equality.
+     *
+     * @param that the map to be compared for equality with this map
+     * @return `true` if `that` has the same keys as this map, associated
+     *         with equal values, `false` otherwise
+     */
+    bool operator==(const TreeMap& that) const
+    {
+        return tree_.equals(that.tree_, [](const value_type& a, const value_type& b) {
+            return !Cmp()(a.first, b.first) && !Cmp()(b.first, a.first) && a.second == b.second;
+        });
+    }
+
+    /**
+     * @brief Compares this map with the given map for inequality.
+     *
+     * @param that the map to be compared for inequality with this map
+     * @return `true` if `that` does not have the same keys as this map,
+     *         associated with equal values, `false` otherwise
+     */
+    bool operator!=(const TreeMap& that) const
+    {
+        return !(*this == that);
+    }
+
+    /**
+     * @brief Swaps the contents of this map and `that`.
+     *
+     * @param that the map to swap contents with
+     */
+    void swap(TreeMap& that) noexcept
+    {
+        tree_.swap(that.tree_);
+    }
+
+private:
+    template<typename, typename, typename, typename>
+    friend class TreeMap;
+
+    struct KeyOf {
+        template<typename P>
+        auto operator()(const P& e) const -> decltype((e.first))
+        {
+            return e.first;
+        }
+    };
+
+    using Tree = WeightTree<value_type, KeyOf, Cmp, Alloc>;
+
+    Tree tree_;
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_TREE_MAP_HPP
@@ -0,0 +1,476 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/TreeSet.hpp
+ * A persistent sorted set with logarithmic updates and range queries.
+ */
+
+#ifndef GUNGNIR_TREE_SET_HPP
+#define GUNGNIR_TREE_SET_HPP
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "gungnir/List.hpp"
+#include "gungnir/Option.hpp"
+#include "gungnir/detail/util.hpp"
+#include "gungnir/detail/wbtree.hpp"
+
+namespace gungnir {
+
+using namespace detail;
+
+/**
+ * @brief An immutable set whose elements are sorted.
+ *
+ * The elements are stored in a weight-balanced binary search tree, like the
+ * entries of a `TreeMap`. Lookups, `added()` and `removed()` take O(log n)
+ * time, and sets derived from one another share all but the modified paths
+ * of their trees; `range()` takes O(log n) time.
+ *
+ * The elements are visited in ascending order.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements; must be copy constructible
+ * @tparam Cmp the type of the strict weak ordering of the elements, which
+ *             is default constructed to compare each pair of elements
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               this set
+ */
+template<
+    typename A,
+    typename Cmp = std::less<A>,
+    typename Alloc = std::allocator<A>
+>
+class TreeSet final {
+public:
+    /**
+     * @brief Constructs an empty set.
+     */
+    TreeSet() noexcept : TreeSet(Alloc()) {}
+
+    /**
+     * @brief Constructs an empty set whose nodes will be allocated
+     *        with `alloc`.
+     *
+     * @param alloc the allocator used by this set and the sets derived
+     *              from it
+     */
+    explicit TreeSet(const Alloc& alloc) noexcept : tree_(alloc) {}
+
+    /**
+     * @brief Constructs a set with the given elements.
+     *
+     * @param xs the elements of this set
+     * @param alloc the allocator used by this set and the sets derived
+     *              from it
+     */
+    TreeSet(std::initializer_list<A> xs, const Alloc& alloc = Alloc())
+        : TreeSet(xs.begin(), xs.end(), alloc)
+    {}
+
+    /**
+     * @brief Constructs a set with the elements in the range [`first`, `last`).
+     *
+     * This takes O(n log n) time; see `fromSorted()` for sorted elements.
+     *
+     * @tparam InputIt the type of the iterators
+     * @param first the iterator pointing to the start of the range
+     * @param last the iterator pointing to the end of the range
+     * @param alloc the allocator used by this set and the sets derived
+     *              from it
+     */
+    template<
+        typename InputIt,
+        typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<InputIt>::value_type, A
+        >::value>::type
+    >
+    TreeSet(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : tree_(alloc)
+    {
+        for (; first != last; ++first) {
+            tree_.insert(*first);
+        }
+    }
+
+    /** @brief Default copy constructor. */
+    TreeSet(const TreeSet&) = default;
+
+    /** @brief Move constructor. The moved-from set is left empty. */
+    TreeSet(TreeSet&&) = default;
+
+    /** @brief Default copy assignment operator. */
+    TreeSet& operator=(const TreeSet&) = default;
+
+    /** @brief Move assignment operator. The moved-from set is left empty. */
+    TreeSet& operator=(TreeSet&&) = default;
+
+    /**
+     * @brief Returns a set with the elements of a sorted list, in O(n) time.
+     *
+     * Duplicates are allowed, so the result of `List::sorted()` can be
+     * passed as is.
+     *
+     * @tparam ListAlloc the type of the allocator of the list
+     * @param xs the elements of the set, in ascending order
+     * @param alloc the allocator used by the returned set and the sets
+     *              derived from it
+     * @return a set with the elements of `xs`
+     * @throws std::invalid_argument if `xs` is not sorted
+     */
+    template<typename ListAlloc>
+    static TreeSet fromSorted(const List<A, ListAlloc>& xs, const Alloc& alloc = Alloc())
+    {
+        TreeSet s(alloc);
+        s.tree_.assignSorted(xs.begin(), xs.end());
+        return s;
+    }
+
+    /**
+     * @brief Returns a copy of the allocator used by this set.
+     *
+     * @return a copy of the allocator used by this set
+     */
+    Alloc allocator() const
+    {
+        return tree_.allocator();
+    }
+
+    /**
+     * @brief Returns `true` if this set contains no elements, `false` otherwise.
+     *
+     * @return `true` if this set contains no elements, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Returns the number of elements of this set.
+     *
+     * @return the number of elements of this set
+     */
+    std::size_t size() const
+    {
+        return tree_.size();
+    }
+
+    /**
+     * @brief Tests whether this set contains a given value as an element.
+     *
+     * @param x the value to test
+     * @return `true` if this set has an element equivalent to `x`,
+     *         `false` otherwise
+     */
+    bool contains(const A& x) const
+    {
+        return tree_.find(x) != nullptr;
+    }
+
+    /**
+     * @brief Returns the least element of this set, if any.
+     *
+     * @return an option referring to the least element, which is empty if
+     *         this set is empty; valid as long as this set is alive
+     */
+    UnownedOption<const A> min() const
+    {
+        return UnownedOption<const A>(tree_.min());
+    }
+
+    /**
+     * @brief Returns the greatest element of this set, if any.
+     *
+     * @return an option referring to the greatest element, which is empty
+     *         if this set is empty; valid as long as this set is alive
+     */
+    UnownedOption<const A> max() const
+    {
+        return UnownedOption<const A>(tree_.max());
+    }
+
+    /**
+     * @brief Returns a copy of this set with an element added.
+     *
+     * Only the tree nodes on the path to the element are copied, along with
+     * those rotated to rebalance it; if the set already contains it, the
+     * whole tree is shared.
+     *
+     * @param x the element to add
+     * @return a set consisting of all elements of this set and `x`
+     */
+    TreeSet added(A x) const
+    {
+        if (contains(x)) {
+            return *this;
+        }
+        TreeSet s(*this);
+        s.tree_.insert(std::move(x));
+        return s;
+    }
+
+    /**
+     * @brief Returns a copy of this set without an element.
+     *
+     * Only the tree nodes on the path to the element are copied, along with
+     * those rotated to rebalance it; if the set does not contain it, the
+     * whole tree is shared.
+     *
+     * @param x the element to remove
+     * @return a set consisting of all elements of this set except `x`
+     */
+    TreeSet removed(const A& x) const
+    {
+        TreeSet s(*this);
+        s.tree_.erase(x);
+        return s;
+    }
+
+    /**
+     * @brief Returns the elements of this set in [`lo`, `hi`), in O(log n)
+     *        time.
+     *
+     * @param lo the least element of the range
+     * @param hi the element right past the range
+     * @return a set of the elements of this set not less than `lo` and
+     *         less than `hi`
+     */
+    TreeSet range(const A& lo, const A& hi) const
+    {
+        TreeSet s(*this);
+        s.tree_.restrict(&lo, &hi);
+        return s;
+    }
+
+    /**
+     * @brief Returns the elements of this set not less than `lo`, in
+     *        O(log n) time.
+     *
+     * @param lo the least element of the range
+     * @return a set of the elements of this set not less than `lo`
+     */
+    TreeSet from(const A& lo) const
+    {
+        TreeSet s(*this);
+        s.tree_.restrict(&lo, nullptr);
+        return s;
+    }
+
+    /**
+     * @brief Returns the elements of this set less than `hi`, in O(log n)
+     *        time.
+     *
+     * @param hi the element right past the range
+     * @return a set of the elements of this set less than `hi`
+     */
+    TreeSet until(const A& hi) const
+    {
+        TreeSet s(*this);
+        s.tree_.restrict(nullptr, &hi);
+        return s;
+    }
+
+    /**
+     * Applies a function to each element of this set, in ascending order.
+     *
+     * @param f the function to apply, for its side-effect,
+     *          to each element of this set
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        tree_.foreachWhile([&f](const A& x) {
+            f(x);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Returns all elements of this set that satisfy a predicate.
+     *
+     * The subtrees all of whose elements satisfy the predicate are shared.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test elements
+     * @return a new set consisting of all elements of this set that
+     *         satisfy the given predicate `p`
+     */
+    template<typename Fn>
+    TreeSet filter(Fn p) const
+    {
+        TreeSet s(allocator());
+        s.tree_ = tree_.filter(std::move(p));
+        return s;
+    }
+
+    /**
+     * @brief Returns all elements of this set that violate a predicate.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test elements
+     * @return a new set consisting of all elements of this set that
+     *         violate the given predicate `p`
+     */
+    template<typename Fn>
+    TreeSet filterNot(Fn p) const
+    {
+        return filter([&p](const A& x) { return !p(x); });
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for some element of this set.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return `true` if the given predicate `p` holds for some element of
+     *         this set, `false` otherwise
+     */
+    template<typename Fn>
+    bool exists(Fn p) const
+    {
+        return !tree_.foreachWhile([&p](const A& x) { return !p(x); });
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for all elements of this set.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return `true` if this set is empty or the given predicate `p`
+     *         holds for all elements of this set, `false` otherwise
+     */
+    template<typename Fn>
+    bool forall(Fn p) const
+    {
+        return tree_.foreachWhile([&p](const A& x) { return static_cast<bool>(p(x)); });
+    }
+
+    /**
+     * @brief Counts the number of elements in this set that satisfy
+     *        a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return the number of elements satisfying the given predicate `p`
+     */
+    template<typename Fn>
+    std::size_t count(Fn p) const
+    {
+        std::size_t n = 0;
+        foreach([&p, &n](const A& x) {
+            if (p(x)) {
+                ++n;
+            }
+        });
+        return n;
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements
+     *        of this set, in ascending order.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this set, with the start value `z` on the left, or `z` if
+     *         this set is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) const
+    {
+        foreach([&z, &op](const A& x) {
+            z = op(std::move(z), x);
+        });
+        return z;
+    }
+
+    /**
+     * @brief Returns a list of the elements of this set, in ascending order.
+     *
+     * @return a list of the elements of this set
+     */
+    List<A, Alloc> toList() const
+    {
+        ListBuilder<A, Alloc> buf(allocator());
+        foreach([&buf](const A& x) {
+            buf.append(x);
+        });
+        return buf.result();
+    }
+
+    /**
+     * @brief Compares this set with the given set for equality.
+     *
+     * @param that the set to be compared for equality with this set
+     * @return `true` if `that` has the same elements as this set,
+     *         `false` otherwise
+     */
+    bool operator==(const TreeSet& that) const
+    {
+        return tree_.equals(that.tree_, [](const A& x, const A& y) {
+            return !Cmp()(x, y) && !Cmp()(y, x);
+        });
+    }
+
+    /**
+     * @brief Compares this set with the given set for inequality.
+     *
+     * @param that the set to be compared for inequality with this set
+     * @return `true` if `that` does not have the same elements as this set,
+     *         `false` otherwise
+     */
+    bool operator!=(const TreeSet& that) const
+    {
+        return !(*this == that);
+    }
+
+    /**
+     * @brief Swaps the contents of this set and `that`.
+     *
+     * @param that the set to swap contents with
+     */
+    void swap(TreeSet& that) noexcept
+    {
+        tree_.swap(that.tree_);
+    }
+
+private:
+    struct KeyOf {
+        const A& operator()(const A& x) const
+        {
+            return x;
+        }
+    };
+
+    using Tree = WeightTree<A, KeyOf, Cmp, Alloc>;
+
+    Tree tree_;
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_TREE_SET_HPP
@@ -0,0 +1,1124 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/UnrolledList.hpp
+ * An immutable linked list storing its elements in chunks.
+ */
+
+#ifndef GUNGNIR_UNROLLED_LIST_HPP
+#define GUNGNIR_UNROLLED_LIST_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gungnir/detail/simd.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+using namespace detail;
+
+/**
+ * @brief An immutable linked list whose nodes hold up to `K` elements
+ *        inline.
+ *
+ * Scanning an unrolled list touches one node per `K` elements instead of
+ * one per element, which makes linear traversals several times faster than
+ * on a `List`. Each node fills its slots from the back, so `prepend()` on a
+ * list that starts at the first used slot of its node claims the slot in
+ * front of it instead of allocating; `prepend()` and `tail()` take
+ * amortized constant time, and lists derived from one another share
+ * their nodes.
+ *
+ * Unlike `List`, elements are stored in the nodes themselves rather than
+ * shared individually, so operations that build a list out of existing
+ * elements (e.g., `filter()`, `take()`, `concat()`) copy them and require
+ * `A` to be copy constructible.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements; must be a non-reference type
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               this list
+ * @tparam K the number of elements per node
+ */
+template<typename A, typename Alloc = std::allocator<A>, std::size_t K = 16>
+class UnrolledList final : private Compressed<Alloc> {
+    static_assert(K > 0 && K <= UINT32_MAX, "invalid node capacity");
+
+public:
+    /**
+     * @brief Constructs an empty list.
+     */
+    UnrolledList() noexcept : UnrolledList(Alloc()) {}
+
+    /**
+     * @brief Constructs an empty list whose nodes will be allocated
+     *        with `alloc`.
+     *
+     * @param alloc the allocator used by this list and the lists derived
+     *              from it
+     */
+    explicit UnrolledList(const Alloc& alloc) noexcept
+        : Compressed<Alloc>(alloc)
+        , size_(0)
+        , offset_(0)
+    {}
+
+    /**
+     * @brief Constructs a list with the given element.
+     *
+     * @param x the only element of this list
+     */
+    explicit UnrolledList(A x)
+        : UnrolledList(UnrolledList().prepend(std::move(x)))
+    {}
+
+    /**
+     * @brief Constructs a list with the given head and tail.
+     *
+     * @param head the first element of this list
+     * @param tail all elements of this list except the first one
+     */
+    UnrolledList(A head, const UnrolledList& tail)
+        : UnrolledList(tail.prepend(std::move(head)))
+    {}
+
+    /**
+     * @brief Constructs a list with the given elements.
+     *
+     * @tparam Args the types of the given elements
+     * @param head the first element of this list
+     * @param tail all elements of this list except the first one
+     */
+    template<
+        typename... Args,
+        typename = typename std::enable_if<
+            AllTrue<std::is_convertible<Args, A>::value...>::value
+        >::type
+    >
+    UnrolledList(A head, Args&&... tail)
+        : UnrolledList(std::move(head), UnrolledList(std::forward<Args>(tail)...))
+    {}
+
+    /**
+     * @brief Constructs a list with the contents of the range [`first`, `last`).
+     *
+     * @tparam InputIt the type of the iterators
+     * @param first the iterator pointing to the start of the range
+     * @param last the iterator pointing to the end of the range
+     * @param alloc the allocator used by this list and the lists derived
+     *              from it
+     */
+    template<
+        typename InputIt,
+        typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<InputIt>::value_type, A
+        >::value>::type
+    >
+    UnrolledList(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : UnrolledList([&first, &last, &alloc] {
+            Builder buf(alloc);
+            for (; first != last; ++first) {
+                buf.append(*first);
+            }
+            return buf.result();
+        }())
+    {}
+
+    /** @brief Default copy constructor. */
+    UnrolledList(const UnrolledList&) = default;
+
+    /** @brief Move constructor. The moved-from list is left empty. */
+    UnrolledList(UnrolledList&& that) noexcept
+        : Compressed<Alloc>(that)
+        , size_(that.size_)
+        , node_(std::move(that.node_))
+        , offset_(that.offset_)
+    {
+        that.size_ = 0;
+        that.offset_ = 0;
+    }
+
+    /** @brief Default copy assignment operator. */
+    UnrolledList& operator=(const UnrolledList&) = default;
+
+    /** @brief Move assignment operator. The moved-from list is left empty. */
+    UnrolledList& operator=(UnrolledList&& that) noexcept
+    {
+        if (this != &that) {
+            static_cast<Compressed<Alloc>&>(*this) = that;
+            size_ = that.size_;
+            node_ = std::move(that.node_);
+            offset_ = that.offset_;
+            that.size_ = 0;
+            that.offset_ = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Returns a copy of the allocator used by this list.
+     *
+     * @return a copy of the allocator used by this list
+     */
+    Alloc allocator() const
+    {
+        return this->get();
+    }
+
+    /**
+     * @brief Returns `true` if this list contains no elements, `false` otherwise.
+     *
+     * @return `true` if this list contains no elements, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Returns the number of elements of this list.
+     *
+     * @return the number of elements of this list
+     */
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Returns the first element of this list.
+     *
+     * @return the first element of this list
+     * @throws std::out_of_range if this list is empty
+     */
+    const A& head() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("head of empty list");
+        }
+        return *node_->at(offset_);
+    }
+
+    /**
+     * @brief Returns all elements of this list except the first one.
+     *
+     * @return all elements of this list except the first one
+     * @throws std::out_of_range if this list is empty
+     */
+    UnrolledList tail() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("tail of empty list");
+        }
+        if (offset_ + 1 < node_->back) {
+            return UnrolledList(size() - 1, node_, offset_ + 1, allocator());
+        }
+        return UnrolledList(size() - 1, node_->next, node_->nextOffset, allocator());
+    }
+
+    /**
+     * @brief Returns the last element of this list.
+     *
+     * @return the last element of this list
+     * @throws std::out_of_range if this list is empty
+     */
+    const A& last() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("last of empty list");
+        }
+        auto n = node_.get();
+        for (; n->next.get(); n = n->next.get()) {}
+        return *n->at(n->back - 1);
+    }
+
+    /**
+     * Applies a function to each element of this list.
+     *
+     * @param f the function to apply, for its side-effect,
+     *          to each element of this list
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        foreachImpl([&f](const A& x) {
+            f(x);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Returns a new list resulting from applying a function to
+     *        each element of this list.
+     *
+     * @tparam Fn the type of the function
+     * @tparam B the result type of the function
+     * @param f the function to apply to each element of this list
+     * @return a new list resulting from applying the given function `f` to
+     *         each element of this list
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    UnrolledList<B, Rebind<Alloc, B>, K> map(Fn f) const
+    {
+        typename UnrolledList<B, Rebind<Alloc, B>, K>::Builder buf(allocator());
+        foreach([&f, &buf](const A& x) {
+            buf.append(f(x));
+        });
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns all elements of this list that satisfy a predicate.
+     *
+     * The order of the elements is preserved.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test elements
+     * @return a new list consisting of all elements of this list that satisfy
+     *         the given predicate `p`
+     */
+    template<typename Fn>
+    UnrolledList filter(Fn p) const
+    {
+        Builder buf(allocator());
+        foreach([&p, &buf](const A& x) {
+            if (p(x)) {
+                buf.append(x);
+            }
+        });
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns all elements of this list that violate a predicate.
+     *
+     * The order of the elements is preserved.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test elements
+     * @return a new list consisting of all elements of this list that violate
+     *         the given predicate `p`
+     */
+    template<typename Fn>
+    UnrolledList filterNot(Fn p) const
+    {
+        return filter([&p](const A& x) { return !p(x); });
+    }
+
+    /**
+     * @brief Returns a new list with elements of this list in reversed order.
+     *
+     * @return a new list with elements of this list in reversed order
+     */
+    UnrolledList reverse() const
+    {
+        UnrolledList xs(allocator());
+        foreach([&xs](const A& x) {
+            xs = xs.prepend(x);
+        });
+        return xs;
+    }
+
+    /**
+     * @brief Returns the first `n` elements of this list.
+     *
+     * @param n the number of elements to take
+     * @return a list consisting of the first `n` elements of this list,
+     *         or the whole list if `n > size()`
+     */
+    UnrolledList take(std::size_t n) const
+    {
+        if (n >= size()) {
+            return *this;
+        }
+
+        Builder buf(allocator());
+        foreachImpl([&n, &buf](const A& x) {
+            if (n == 0) {
+                return false;
+            }
+            buf.append(x);
+            --n;
+            return true;
+        });
+        return buf.result();
+    }
+
+    /**
+     * @brief Returns all elements of this list except the first `n` ones.
+     *
+     * Whole nodes are skipped at a time.
+     *
+     * @param n the number of elements to drop
+     * @return a list consisting of all elements of this list except
+     *         the first `n` ones, or an empty list if `n > size()`
+     */
+    UnrolledList drop(std::size_t n) const
+    {
+        if (n >= size()) {
+            return UnrolledList(allocator());
+        }
+        const auto s = size() - n;
+        auto p = &node_;
+        auto i = offset_;
+        for (;;) {
+            const auto avail = (*p)->back - i;
+            if (n < avail) {
+                return UnrolledList(s, *p, static_cast<std::uint32_t>(i + n), allocator());
+            }
+            n -= avail;
+            i = (*p)->nextOffset;
+            p = &(*p)->next;
+        }
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for some element of this list.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return `true` if the given predicate `p` holds for some element of
+     *         this list, `false` otherwise
+     */
+    template<typename Fn>
+    bool exists(Fn p) const
+    {
+        bool found = false;
+        foreachImpl([&p, &found](const A& x) {
+            found = p(x);
+            return !found;
+        });
+        return found;
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for all elements of this list.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return `true` if this list is empty or the given predicate `p`
+     *         holds for all elements of this list, `false` otherwise.
+     */
+    template<typename Fn>
+    bool forall(Fn p) const
+    {
+        return !exists([&p](const A& x) { return !p(x); });
+    }
+
+    /**
+     * @brief Tests whether this list contains a given value as an element.
+     *
+     * The elements of each node are compared in bulk, using SIMD
+     * instructions for arithmetic element types where available.
+     *
+     * @param x the object to test against
+     * @return `true` if this list has an element that is equal
+     *         (as determined by `==`) to `x`, `false` otherwise
+     */
+    bool contains(const A& x) const
+    {
+        auto i = offset_;
+        for (auto n = node_.get(); n; i = n->nextOffset, n = n->next.get()) {
+            if (simd::contains(n->at(i), n->back - i, x)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the number of elements of this list that are equal
+     *        (as determined by `==`) to `x`.
+     *
+     * The elements of each node are compared in bulk, using SIMD
+     * instructions for arithmetic element types where available.
+     *
+     * @param x the object to test against
+     * @return the number of elements of this list that are equal
+     *         (as determined by `==`) to `x`
+     */
+    std::size_t count(const A& x) const
+    {
+        std::size_t num = 0;
+        nodes([&x, &num](const Node* n, std::uint32_t begin) {
+            num += simd::count(n->at(begin), n->back - begin, x);
+        });
+        return num;
+    }
+
+    /**
+     * @brief Returns the number of elements of this list that satisfy
+     *        the given predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate
+     * @return the number of elements of this list that satisfy
+     *         the given predicate
+     */
+    template<typename Fn>
+    std::size_t count(Fn p) const
+    {
+        std::size_t num = 0;
+        foreach([&p, &num](const A& x) {
+            if (p(x)) {
+                ++num;
+            }
+        });
+        return num;
+    }
+
+    /**
+     * @brief Returns a list whose head is constructed in-place from `args`,
+     *        and tail is this list.
+     *
+     * If this list starts at the first used slot of its node and the node
+     * has a free slot in front of it, the new element is placed there and
+     * the node is shared; otherwise a new node is allocated.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `A`
+     * @param args the arguments passed to the constructor of `A`
+     * @return a list whose head is constructed in-place from `args`,
+     *         and tail is this list
+     */
+    template<typename... Args>
+    UnrolledList prepend(Args&&... args) const
+    {
+        if (!isEmpty() && node_->claim(offset_)) {
+            const auto n = const_cast<Node*>(node_.get());
+            const auto i = offset_ - 1;
+            try {
+                n->construct(i, std::forward<Args>(args)...);
+            } catch (...) {
+                n->unclaim(i);
+                throw;
+            }
+            return UnrolledList(size() + 1, node_, i, allocator());
+        }
+
+        auto n = Node::create(allocator(), K);
+        const auto p = const_cast<Node*>(n.get());
+        p->construct(K - 1, std::forward<Args>(args)...);
+        p->front.store(K - 1, std::memory_order_relaxed);
+        p->next = node_;
+        p->nextOffset = offset_;
+        return UnrolledList(size() + 1, std::move(n), K - 1, allocator());
+    }
+
+    /**
+     * @brief Returns a list resulting from concatenating this list and `that`.
+     *
+     * The nodes of `that` are shared; the elements of this list are copied.
+     *
+     * @param that the list whose elements follow those of this list
+     *             in the returned list
+     * @return a list resulting from concatenating this list and `that`
+     */
+    UnrolledList concat(const UnrolledList& that) const
+    {
+        if (isEmpty()) {
+            return that;
+        } else if (that.isEmpty()) {
+            return *this;
+        }
+
+        Builder buf(allocator());
+        foreach([&buf](const A& x) {
+            buf.append(x);
+        });
+        return buf.result(that);
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this list, going left to right.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this list, going left to right with the start value `z`
+     *         on the left, or `z` if this list is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) const
+    {
+        foreach([&z, &op](const A& x) {
+            z = op(std::move(z), x);
+        });
+        return z;
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this list, going right to left.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this list, going right to left with the start value `z`
+     *         on the right, or `z` if this list is empty
+     */
+    template<typename B, typename Fn>
+    B foldRight(B z, Fn op) const
+    {
+        // Only one entry per node is buffered.
+        std::vector<std::pair<const Node*, std::uint32_t>> buf;
+        nodes([&buf](const Node* n, std::uint32_t begin) {
+            buf.emplace_back(n, begin);
+        });
+
+        for (auto it = buf.crbegin(); it != buf.crend(); ++it) {
+            for (auto i = it->first->back; i > it->second; --i) {
+                z = op(*it->first->at(i - 1), std::move(z));
+            }
+        }
+        return z;
+    }
+
+    /**
+     * @brief Returns the sum of all elements of this list,
+     *        or 0 if this list is empty.
+     *
+     * The elements of each node are added in bulk, using SIMD instructions
+     * for arithmetic element types where available; floating-point results
+     * may therefore differ in the last bits from a left-to-right sum.
+     *
+     * @return the sum of all elements of this list, or 0 if this list is empty
+     */
+    A sum() const
+    {
+        A acc = 0;
+        nodes([&acc](const Node* n, std::uint32_t begin) {
+            acc += simd::sum(n->at(begin), n->back - begin);
+        });
+        return acc;
+    }
+
+    /**
+     * @brief Returns the product of all elements of this list,
+     *        or 1 if this list is empty.
+     *
+     * The elements of each node are multiplied in bulk, using SIMD
+     * instructions for arithmetic element types where available;
+     * floating-point results may therefore differ in the last bits from a
+     * left-to-right product.
+     *
+     * @return the product of all elements of this list, or 1 if this list
+     *         is empty
+     */
+    A product() const
+    {
+        A acc = 1;
+        nodes([&acc](const Node* n, std::uint32_t begin) {
+            acc *= simd::product(n->at(begin), n->back - begin);
+        });
+        return acc;
+    }
+
+    /**
+     * @brief Returns the element at the specified position of this list.
+     *
+     * Whole nodes are skipped at a time.
+     *
+     * @param index the position of the element to return
+     * @return the element at position `index`
+     * @throws std::out_of_range if `index >= size()`
+     */
+    const A& operator[](std::size_t index) const
+    {
+        if (index >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+        auto n = node_.get();
+        std::size_t i = offset_;
+        while (index >= n->back - i) {
+            index -= n->back - i;
+            i = n->nextOffset;
+            n = n->next.get();
+        }
+        return *n->at(i + index);
+    }
+
+    /**
+     * @brief Compares this list with the given list for equality.
+     *
+     * @param that the list to be compared for equality with this list
+     * @return `true` if `that` contains the same elements as this list
+     *         in the same order, `false` otherwise
+     */
+    bool operator==(const UnrolledList& that) const
+    {
+        if (size() != that.size()) {
+            return false;
+        }
+        if (node_.get() == that.node_.get() && offset_ == that.offset_) {
+            return true;
+        }
+        auto it = that.begin();
+        bool equal = true;
+        foreachImpl([&it, &equal](const A& x) {
+            equal = x == *it++;
+            return equal;
+        });
+        return equal;
+    }
+
+    /**
+     * @brief Compares this list with the given list for inequality.
+     *
+     * @param that the list to be compared for inequality with this list
+     * @return `true` if `that` does not contains the same elements as this list
+     *         in the same order, `false` otherwise
+     */
+    bool operator!=(const UnrolledList& that) const
+    {
+        return !(*this == that);
+    }
+
+    class StdIterator;
+
+    /**
+     * @brief Returns an iterator to the first element of this list.
+     *
+     * If this list is empty, the returned iterator will be equal to `end()`.
+     *
+     * @return an iterator to the first element of this list.
+     */
+    StdIterator begin() const
+    {
+        return StdIterator(node_.get(), offset_);
+    }
+
+    /**
+     * @brief Returns an iterator to the element following the last element
+     *        of this list.
+     *
+     * This element acts as a placeholder; attempting to access it results in
+     * undefined behavior.
+     *
+     * @return an iterator to the element following the last element
+     *         of this list
+     */
+    StdIterator end() const
+    {
+        return StdIterator(nullptr, 0);
+    }
+
+private:
+    template<typename, typename, std::size_t>
+    friend class UnrolledList;
+
+    class Node;
+    class NodePtr;
+    class Builder;
+
+    UnrolledList(std::size_t size, NodePtr node, std::uint32_t offset, const Alloc& alloc) noexcept
+        : Compressed<Alloc>(alloc)
+        , size_(size)
+        , node_(std::move(node))
+        , offset_(offset)
+    {}
+
+    // Calls `f` with each node of this list and the index of its first
+    // element in this list.
+    template<typename Fn>
+    void nodes(Fn f) const
+    {
+        auto i = offset_;
+        for (auto n = node_.get(); n; i = n->nextOffset, n = n->next.get()) {
+            f(n, i);
+        }
+    }
+
+    // Calls `f` with each element in order, stopping as soon as it returns
+    // `false`. The elements of a node are visited in a tight inner loop.
+    template<typename Fn>
+    void foreachImpl(Fn f) const
+    {
+        auto i = offset_;
+        for (auto n = node_.get(); n; i = n->nextOffset, n = n->next.get()) {
+            for (const auto end = n->back; i < end; ++i) {
+                if (!f(*n->at(i))) {
+                    return;
+                }
+            }
+        }
+    }
+
+    std::size_t size_;
+    NodePtr node_;
+    std::uint32_t offset_;
+};
+
+/**
+ * @brief A `ForwardIterator` for an `UnrolledList`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the element type of the list
+ */
+template<typename A, typename Alloc, std::size_t K>
+class UnrolledList<A, Alloc, K>::StdIterator final {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = A;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const A*;
+    using reference = const A&;
+
+    /**
+     * @brief Constructs an iterator past the end of any list, equal to
+     *        `end()`.
+     */
+    StdIterator() noexcept : node_(nullptr), index_(0) {}
+
+    /** @brief Default copy constructor. */
+    StdIterator(const StdIterator&) = default;
+
+    /** @brief Default move constructor. */
+    StdIterator(StdIterator&&) = default;
+
+    /** @brief Default copy assignment operator. */
+    StdIterator& operator=(const StdIterator&) = default;
+
+    /** @brief Default move assignment operator. */
+    StdIterator& operator=(StdIterator&&) = default;
+
+    /**
+     * @brief Compares this iterator with the given iterator for equality.
+     *
+     * @param that the iterator to be compared for equality with this iterator
+     * @return `true` if `that` points to the same element as this iterator,
+     *         `false` otherwise
+     */
+    bool operator==(const StdIterator& that) const
+    {
+        return node_ == that.node_ && index_ == that.index_;
+    }
+
+    /**
+     * @brief Compares this iterator with the given iterator for inequality.
+     *
+     * @param that the iterator to be compared for inequality with this iterator
+     * @return `true` if `that` does not point to the same element as this
+     *         iterator, `false` otherwise
+     */
+    bool operator!=(const StdIterator& that) const
+    {
+        return !(*this == that);
+    }
+
+    /**
+     * @brief Increments this iterator and returns a reference to it.
+     *
+     * @return a reference to this iterator
+     */
+    StdIterator& operator++()
+    {
+        if (++index_ == node_->back) {
+            index_ = node_->nextOffset;
+            node_ = node_->next.get();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Increments this iterator and returns a copy of the original iterator.
+     *
+     * @return a copy of the original iterator
+     */
+    StdIterator operator++(int)
+    {
+        StdIterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    /**
+     * @brief Returns a reference to the element this iterator points to.
+     *
+     * @return a reference to the element this iterator points to
+     */
+    const A& operator*() const
+    {
+        return *node_->at(index_);
+    }
+
+    /**
+     * @brief Returns a pointer to the element this iterator points to.
+     *
+     * @return a pointer to the element this iterator points to
+     */
+    const A* operator->() const
+    {
+        return node_->at(index_);
+    }
+
+private:
+    friend class UnrolledList;
+
+    StdIterator(const Node* node, std::uint32_t index) noexcept
+        : node_(node)
+        , index_(index)
+    {}
+
+    const Node* node_;
+    std::uint32_t index_;
+};
+
+/// @cond GUNGNIR_PRIVATE
+/*
+ * An intrusively reference-counted node holding up to `K` elements.
+ *
+ * The elements occupy the slots [`front`, `back`). `back` is fixed once the
+ * node is reachable from a list, while `front` only ever moves towards the
+ * start as `prepend()` claims the slot in front of it. A list referring to
+ * the node starts at some slot in [`front`, `back`) and continues with the
+ * elements of `next` starting at `nextOffset`.
+ */
+template<typename A, typename Alloc, std::size_t K>
+class UnrolledList<A, Alloc, K>::Node final : public Compressed<Alloc> {
+public:
+    // Creates an empty node whose first element will go in slot `front`.
+    static NodePtr create(const Alloc& a, std::size_t front)
+    {
+        NodeAlloc alloc(a);
+        const auto p = NodeTraits::allocate(alloc, 1);
+        return NodePtr(new (p) Node(a, static_cast<std::uint32_t>(front)));
+    }
+
+    Node(const Node&) = delete;
+    Node& operator=(const Node&) = delete;
+
+    const A* at(std::size_t i) const
+    {
+        return reinterpret_cast<const A*>(&slots_[i]);
+    }
+
+    template<typename... Args>
+    void construct(std::size_t i, Args&&... args)
+    {
+        new (&slots_[i]) A(std::forward<Args>(args)...);
+    }
+
+    // Claims slot `i - 1` for a new element, provided that slot `i` is the
+    // first used one and there is a slot in front of it.
+    bool claim(std::uint32_t i) const
+    {
+        return i > 0 && front.compare_exchange_strong(
+                i, i - 1, std::memory_order_acq_rel, std::memory_order_relaxed);
+    }
+
+    // Gives back slot `i`, claimed by the caller but left unconstructed.
+    // No one else can have claimed a slot in front of it in the meantime,
+    // as only the list being built starts at `i`.
+    void unclaim(std::uint32_t i) const
+    {
+        front.store(i + 1, std::memory_order_release);
+    }
+
+    mutable std::atomic<std::uint32_t> front;
+    std::uint32_t back;
+    NodePtr next;
+    std::uint32_t nextOffset;
+
+private:
+    friend class NodePtr;
+
+    using NodeAlloc = Rebind<Alloc, Node>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+    Node(const Alloc& alloc, std::uint32_t front) noexcept
+        : Compressed<Alloc>(alloc)
+        , front(front)
+        , back(front)
+        , nextOffset(0)
+        , refs_(1)
+    {}
+
+    ~Node()
+    {
+        for (auto i = back; i > front.load(std::memory_order_relaxed); --i) {
+            at(i - 1)->~A();
+        }
+    }
+
+    static void retain(const Node* n)
+    {
+        n->refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void release(const Node* n)
+    {
+        if (n->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            destroy(const_cast<Node*>(n));
+        }
+    }
+
+    // Destroys `n` and every following node only referenced by the node
+    // before it, in a loop so that long lists do not exhaust the stack.
+    static void destroy(Node* n)
+    {
+        while (n) {
+            const auto next = n->next.detach();
+            NodeAlloc alloc(n->get());
+            n->~Node();
+            NodeTraits::deallocate(alloc, n, 1);
+
+            n = next && next->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1
+                ? next
+                : nullptr;
+        }
+    }
+
+    mutable std::atomic<std::uint32_t> refs_;
+    typename std::aligned_storage<sizeof (A), alignof (A)>::type slots_[K];
+};
+
+template<typename A, typename Alloc, std::size_t K>
+class UnrolledList<A, Alloc, K>::NodePtr final {
+public:
+    NodePtr() noexcept : node_(nullptr) {}
+
+    explicit NodePtr(Node* node) noexcept : node_(node) {}
+
+    NodePtr(const NodePtr& that) noexcept : node_(that.node_)
+    {
+        if (node_) {
+            Node::retain(node_);
+        }
+    }
+
+    NodePtr(NodePtr&& that) noexcept : node_(that.node_)
+    {
+        that.node_ = nullptr;
+    }
+
+    ~NodePtr()
+    {
+        if (node_) {
+            Node::release(node_);
+        }
+    }
+
+    NodePtr& operator=(const NodePtr& that) noexcept
+    {
+        NodePtr(that).swap(*this);
+        return *this;
+    }
+
+    NodePtr& operator=(NodePtr&& that) noexcept
+    {
+        NodePtr(std::move(that)).swap(*this);
+        return *this;
+    }
+
+    void swap(NodePtr& that) noexcept
+    {
+        std::swap(node_, that.node_);
+    }
+
+    // Releases ownership of the node without decrementing its count.
+    Node* detach() noexcept
+    {
+        const auto node = node_;
+        node_ = nullptr;
+        return node;
+    }
+
+    const Node* get() const noexcept
+    {
+        return node_;
+    }
+
+    const Node* operator->() const noexcept
+    {
+        return node_;
+    }
+
+private:
+    Node* node_;
+};
+
+// Builds a list front to back, filling each node from its first slot.
+template<typename A, typename Alloc, std::size_t K>
+class UnrolledList<A, Alloc, K>::Builder final : private Compressed<Alloc> {
+public:
+    explicit Builder(const Alloc& alloc) noexcept
+        : Compressed<Alloc>(alloc)
+        , last_(nullptr)
+        , size_(0)
+    {}
+
+    template<typename... Args>
+    void append(Args&&... args)
+    {
+        if (!last_ || last_->back == K) {
+            auto n = Node::create(this->get(), 0);
+            const auto p = const_cast<Node*>(n.get());
+            (last_ ? last_->next : head_) = std::move(n);
+            last_ = p;
+        }
+        last_->construct(last_->back, std::forward<Args>(args)...);
+        ++last_->back;
+        ++size_;
+    }
+
+    // Returns the list of all appended elements.
+    UnrolledList result()
+    {
+        return result(UnrolledList(this->get()));
+    }
+
+    // Returns the list of all appended elements followed by those of `tail`.
+    UnrolledList result(const UnrolledList& tail)
+    {
+        if (!last_) {
+            return tail;
+        }
+        last_->next = tail.node_;
+        last_->nextOffset = tail.offset_;
+        UnrolledList xs(size_ + tail.size(), std::move(head_), 0, this->get());
+        last_ = nullptr;
+        size_ = 0;
+        return xs;
+    }
+
+private:
+    NodePtr head_;
+    Node* last_;
+    std::size_t size_;
+};
+/// @endcond
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_UNROLLED_LIST_HPP
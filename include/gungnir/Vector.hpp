@@ -0,0 +1,2099 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/Vector.hpp
+ * A persistent vector with effectively constant-time random access.
+ */
+
+#ifndef GUNGNIR_VECTOR_HPP
+#define GUNGNIR_VECTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gungnir/execution.hpp"
+#include "gungnir/detail/simd.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+using namespace detail;
+
+/// @cond GUNGNIR_PRIVATE
+namespace detail {
+
+namespace trie {
+
+// Each trie node has `width` slots, indexed by `bits` bits of an index.
+constexpr unsigned bits = 5;
+constexpr std::size_t width = std::size_t(1) << bits;
+constexpr std::size_t mask = width - 1;
+
+// Concatenation rebalances the nodes along the seam only until there are at
+// most `extras` more of them than needed, skipping nodes with at least
+// `width - invariant` slots in use, which bounds the extra steps a lookup
+// takes in a relaxed branch.
+constexpr std::size_t invariant = 1;
+constexpr std::size_t extras = 2;
+
+}  // namespace trie
+
+}  // namespace detail
+/// @endcond
+
+template<typename A, typename Alloc>
+class TransientVector;
+
+/**
+ * @brief An immutable vector.
+ *
+ * The elements are stored in a 32-way relaxed radix balanced (RRB) trie of
+ * leaves holding up to 32 elements inline, plus a separate tail leaf
+ * holding the last 1 to 32 elements. Vectors built by appending have
+ * full leaves and are indexed with bit arithmetic alone; `concat()`,
+ * `slice()`, `splitAt()` and `insertAt()` may leave partial leaves,
+ * whose branches record the sizes of their children to be indexed with a
+ * short search instead. Indexed access and point updates take O(log32 n)
+ * time either way, which is at most 7 steps for any vector that fits in
+ * memory, and appending takes amortized constant time. Vectors derived
+ * from one another share all but the modified paths of their tries.
+ *
+ * Operations that copy a leaf, such as `appended()`, `updated()` and the
+ * ones splitting and joining vectors, require `A` to be copy
+ * constructible.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements; must be a non-reference type
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               this vector
+ */
+template<typename A, typename Alloc = std::allocator<A>>
+class Vector final : private Compressed<Alloc> {
+public:
+    /**
+     * @brief Constructs an empty vector.
+     */
+    Vector() noexcept : Vector(Alloc()) {}
+
+    /**
+     * @brief Constructs an empty vector whose nodes will be allocated
+     *        with `alloc`.
+     *
+     * @param alloc the allocator used by this vector and the vectors derived
+     *              from it
+     */
+    explicit Vector(const Alloc& alloc) noexcept
+        : Compressed<Alloc>(alloc)
+        , size_(0)
+        , shift_(trie::bits)
+        , dense_(true)
+    {}
+
+    /**
+     * @brief Constructs a vector with the given element.
+     *
+     * @param x the only element of this vector
+     */
+    explicit Vector(A x)
+        : Vector()
+    {
+        pushFresh(std::move(x));
+    }
+
+    /**
+     * @brief Constructs a vector with the given elements.
+     *
+     * @tparam Args the types of the given elements
+     * @param x the first element of this vector
+     * @param xs all elements of this vector except the first one
+     */
+    template<
+        typename... Args,
+        typename = typename std::enable_if<
+            AllTrue<std::is_convertible<Args, A>::value...>::value
+        >::type
+    >
+    Vector(A x, Args&&... xs)
+        : Vector(std::move(x))
+    {
+        const int pushed[] = { (pushFresh(std::forward<Args>(xs)), 0)... };
+        (void) pushed;
+    }
+
+    /**
+     * @brief Constructs a vector with the contents of the range [`first`, `last`).
+     *
+     * @tparam InputIt the type of the iterators
+     * @param first the iterator pointing to the start of the range
+     * @param last the iterator pointing to the end of the range
+     * @param alloc the allocator used by this vector and the vectors derived
+     *              from it
+     */
+    template<
+        typename InputIt,
+        typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<InputIt>::value_type, A
+        >::value>::type
+    >
+    Vector(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : Vector(alloc)
+    {
+        for (; first != last; ++first) {
+            pushFresh(*first);
+        }
+    }
+
+    /** @brief Default copy constructor. */
+    Vector(const Vector&) = default;
+
+    /** @brief Move constructor. The moved-from vector is left empty. */
+    Vector(Vector&& that) noexcept
+        : Compressed<Alloc>(that)
+        , size_(that.size_)
+        , shift_(that.shift_)
+        , dense_(that.dense_)
+        , root_(std::move(that.root_))
+        , tail_(std::move(that.tail_))
+    {
+        that.size_ = 0;
+        that.shift_ = trie::bits;
+        that.dense_ = true;
+    }
+
+    /** @brief Default copy assignment operator. */
+    Vector& operator=(const Vector&) = default;
+
+    /** @brief Move assignment operator. The moved-from vector is left empty. */
+    Vector& operator=(Vector&& that) noexcept
+    {
+        Vector(std::move(that)).swap(*this);
+        return *this;
+    }
+
+    /**
+     * @brief Returns a copy of the allocator used by this vector.
+     *
+     * @return a copy of the allocator used by this vector
+     */
+    Alloc allocator() const
+    {
+        return this->get();
+    }
+
+    /**
+     * @brief Returns `true` if this vector contains no elements, `false` otherwise.
+     *
+     * @return `true` if this vector contains no elements, `false` otherwise
+     */
+    bool isEmpty() const
+    {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Returns the number of elements of this vector.
+     *
+     * @return the number of elements of this vector
+     */
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Returns the first element of this vector.
+     *
+     * @return the first element of this vector
+     * @throws std::out_of_range if this vector is empty
+     */
+    const A& head() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("head of empty vector");
+        }
+        std::size_t start;
+        return *leafFor(0, start)->at(0);
+    }
+
+    /**
+     * @brief Returns the last element of this vector.
+     *
+     * @return the last element of this vector
+     * @throws std::out_of_range if this vector is empty
+     */
+    const A& last() const
+    {
+        if (isEmpty()) {
+            throw std::out_of_range("last of empty vector");
+        }
+        return *tail()->at(tail()->count - 1);
+    }
+
+    /**
+     * @brief Returns the element at the specified position of this vector.
+     *
+     * @param index the position of the element to return
+     * @return the element at position `index`
+     * @throws std::out_of_range if `index >= size()`
+     */
+    const A& operator[](std::size_t index) const
+    {
+        if (index >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+        std::size_t start;
+        const auto leaf = leafFor(index, start);
+        return *leaf->at(index - start);
+    }
+
+    /**
+     * Applies a function to each element of this vector.
+     *
+     * @param f the function to apply, for its side-effect,
+     *          to each element of this vector
+     */
+    template<typename Fn>
+    void foreach(Fn f) const
+    {
+        foreachLeaf([&f](const Leaf* l) {
+            for (std::size_t i = 0; i < l->count; ++i) {
+                f(*l->at(i));
+            }
+            return true;
+        });
+    }
+
+    /**
+     * @brief Returns a new vector resulting from applying a function to
+     *        each element of this vector.
+     *
+     * @tparam Fn the type of the function
+     * @tparam B the result type of the function
+     * @param f the function to apply to each element of this vector
+     * @return a new vector resulting from applying the given function `f` to
+     *         each element of this vector
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    Vector<B, Rebind<Alloc, B>> map(Fn f) const
+    {
+        Vector<B, Rebind<Alloc, B>> ys(allocator());
+        foreach([&f, &ys](const A& x) {
+            ys.pushFresh(f(x));
+        });
+        return ys;
+    }
+
+    /**
+     * @brief Returns a new vector resulting from applying a function to
+     *        each element of this vector, in parallel.
+     *
+     * The vector is split into chunks with `slice()`, which are mapped
+     * concurrently and then joined in order with `concat()`, so the result
+     * is the same as `map(f)`.
+     *
+     * @tparam Fn the type of the function
+     * @tparam B the result type of the function
+     * @param policy the parallel execution policy
+     * @param f the function to apply to each element of this vector; may be
+     *          called concurrently
+     * @return a new vector resulting from applying the given function `f` to
+     *         each element of this vector
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, A>>>
+    Vector<B, Rebind<Alloc, B>> map(const ParallelPolicy& policy, Fn f) const
+    {
+        return splitJoin<Vector<B, Rebind<Alloc, B>>>(policy, [&f](const Vector& xs) {
+            return xs.map([&f](const A& x) { return f(x); });
+        });
+    }
+
+    /**
+     * @brief Returns all elements of this vector that satisfy a predicate.
+     *
+     * The order of the elements is preserved.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test elements
+     * @return a new vector consisting of all elements of this vector that
+     *         satisfy the given predicate `p`
+     */
+    template<typename Fn>
+    Vector filter(Fn p) const
+    {
+        Vector ys(allocator());
+        foreach([&p, &ys](const A& x) {
+            if (p(x)) {
+                ys.pushFresh(x);
+            }
+        });
+        return ys;
+    }
+
+    /**
+     * @brief Returns all elements of this vector that satisfy a predicate,
+     *        testing them in parallel.
+     *
+     * The vector is split into chunks with `slice()`, which are filtered
+     * concurrently and then joined in order with `concat()`.
+     *
+     * @tparam Fn type of the predicate
+     * @param policy the parallel execution policy
+     * @param p the predicate used to test elements; may be called concurrently
+     * @return a new vector consisting of all elements of this vector that
+     *         satisfy the given predicate `p`, in order
+     */
+    template<typename Fn>
+    Vector filter(const ParallelPolicy& policy, Fn p) const
+    {
+        return splitJoin<Vector>(policy, [&p](const Vector& xs) {
+            return xs.filter([&p](const A& x) { return p(x); });
+        });
+    }
+
+    /**
+     * @brief Returns all elements of this vector that violate a predicate.
+     *
+     * The order of the elements is preserved.
+     *
+     * @tparam Fn type of the predicate
+     * @param p the predicate used to test elements
+     * @return a new vector consisting of all elements of this vector that
+     *         violate the given predicate `p`
+     */
+    template<typename Fn>
+    Vector filterNot(Fn p) const
+    {
+        return filter([&p](const A& x) { return !p(x); });
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for some element of this vector.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return `true` if the given predicate `p` holds for some element of
+     *         this vector, `false` otherwise
+     */
+    template<typename Fn>
+    bool exists(Fn p) const
+    {
+        bool found = false;
+        foreachLeaf([&p, &found](const Leaf* l) {
+            for (std::size_t i = 0; i < l->count; ++i) {
+                if (p(*l->at(i))) {
+                    found = true;
+                    return false;
+                }
+            }
+            return true;
+        });
+        return found;
+    }
+
+    /**
+     * @brief Tests whether a predicate holds for all elements of this vector.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return `true` if this vector is empty or the given predicate `p`
+     *         holds for all elements of this vector, `false` otherwise
+     */
+    template<typename Fn>
+    bool forall(Fn p) const
+    {
+        return !exists([&p](const A& x) { return !p(x); });
+    }
+
+    /**
+     * @brief Tests whether this vector contains a given value as an element.
+     *
+     * The elements of each leaf are compared in bulk, using SIMD
+     * instructions for arithmetic element types where available.
+     *
+     * @param x the value to test
+     * @return `true` if this vector has an element that is equal (as
+     *         determined by `==`) to `x`, `false` otherwise
+     */
+    bool contains(const A& x) const
+    {
+        bool found = false;
+        foreachLeaf([&x, &found](const Leaf* l) {
+            found = simd::contains(l->at(0), l->count, x);
+            return !found;
+        });
+        return found;
+    }
+
+    /**
+     * @brief Returns the number of elements of this vector that are equal
+     *        (as determined by `==`) to `x`.
+     *
+     * The elements of each leaf are compared in bulk, using SIMD
+     * instructions for arithmetic element types where available.
+     *
+     * @param x the object to test against
+     * @return the number of elements of this vector that are equal
+     *         (as determined by `==`) to `x`
+     */
+    std::size_t count(const A& x) const
+    {
+        std::size_t num = 0;
+        foreachLeaf([&x, &num](const Leaf* l) {
+            num += simd::count(l->at(0), l->count, x);
+            return true;
+        });
+        return num;
+    }
+
+    /**
+     * @brief Counts the number of elements in this vector that satisfy
+     *        a predicate.
+     *
+     * @tparam Fn the type of the predicate
+     * @param p the predicate used to test elements
+     * @return the number of elements satisfying the given predicate `p`
+     */
+    template<typename Fn>
+    std::size_t count(Fn p) const
+    {
+        std::size_t n = 0;
+        foreach([&p, &n](const A& x) {
+            if (p(x)) {
+                ++n;
+            }
+        });
+        return n;
+    }
+
+    /**
+     * @brief Returns the sum of all elements of this vector,
+     *        or 0 if this vector is empty.
+     *
+     * The elements of each leaf are added in bulk, using SIMD instructions
+     * for arithmetic element types where available; floating-point results
+     * may therefore differ in the last bits from a left-to-right sum.
+     *
+     * @return the sum of all elements of this vector, or 0 if this vector
+     *         is empty
+     */
+    A sum() const
+    {
+        A acc = 0;
+        foreachLeaf([&acc](const Leaf* l) {
+            acc += simd::sum(l->at(0), l->count);
+            return true;
+        });
+        return acc;
+    }
+
+    /**
+     * @brief Returns the product of all elements of this vector,
+     *        or 1 if this vector is empty.
+     *
+     * The elements of each leaf are multiplied in bulk, using SIMD
+     * instructions for arithmetic element types where available;
+     * floating-point results may therefore differ in the last bits from a
+     * left-to-right product.
+     *
+     * @return the product of all elements of this vector, or 1 if this
+     *         vector is empty
+     */
+    A product() const
+    {
+        A acc = 1;
+        foreachLeaf([&acc](const Leaf* l) {
+            acc *= simd::product(l->at(0), l->count);
+            return true;
+        });
+        return acc;
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this vector, going left to right.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this vector, going left to right with the start value `z`
+     *         on the left, or `z` if this vector is empty
+     */
+    template<typename B, typename Fn>
+    B foldLeft(B z, Fn op) const
+    {
+        foreach([&z, &op](const A& x) {
+            z = op(std::move(z), x);
+        });
+        return z;
+    }
+
+    /**
+     * @brief Applies a binary operator to a start value and all elements of
+     *        this vector, going right to left.
+     *
+     * @tparam B the result type of the binary operator
+     * @tparam Fn the type of the binary operator
+     * @param z the start value
+     * @param op the binary operator
+     * @return the result of inserting `op` between consecutive elements of
+     *         this vector, going right to left with the start value `z`
+     *         on the right, or `z` if this vector is empty
+     */
+    template<typename B, typename Fn>
+    B foldRight(B z, Fn op) const
+    {
+        for (auto i = size(); i > 0; --i) {
+            z = op((*this)[i - 1], std::move(z));
+        }
+        return z;
+    }
+
+    /**
+     * @brief Returns a new vector with an element appended.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `A`
+     * @param args the arguments passed to the constructor of `A`
+     * @return a new vector consisting of all elements of this vector
+     *         followed by an element constructed in-place from `args`
+     */
+    template<typename... Args>
+    Vector appended(Args&&... args) const
+    {
+        Vector ys(*this);
+        ys.push(std::forward<Args>(args)...);
+        return ys;
+    }
+
+    /**
+     * @brief Returns a copy of this vector with one single replaced element.
+     *
+     * Only the leaf holding the element and the trie nodes on the path to
+     * it are copied.
+     *
+     * @tparam Args the types of the argument passed to the constructor of `A`
+     * @param index the position of the replacement
+     * @param args the argument passed to the constructor of `A`
+     * @return a copy of this vector with the element at position `index`
+     *         replaced by a new element constructed in-place from `args`
+     * @throws std::out_of_range if `index >= size()`
+     */
+    template<typename... Args>
+    Vector updated(std::size_t index, Args&&... args) const
+    {
+        if (index >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+
+        Vector ys(*this);
+        ys.set(index, std::forward<Args>(args)...);
+        return ys;
+    }
+
+    /**
+     * @brief Returns a vector resulting from concatenating this vector and
+     *        `that`.
+     *
+     * The tries of both vectors are shared, except for the nodes along the
+     * seam between them, which are merged and rebalanced, so this takes
+     * O(log32 n) time. If `that` only has a tail leaf, its elements are
+     * appended instead.
+     *
+     * @param that the vector whose elements follow those of this vector
+     *             in the returned vector
+     * @return a vector resulting from concatenating this vector and `that`
+     */
+    Vector concat(const Vector& that) const
+    {
+        if (isEmpty()) {
+            return that;
+        } else if (that.isEmpty()) {
+            return *this;
+        }
+
+        Vector ys(*this);
+        if (!that.root_.get()) {
+            that.foreach([&ys](const A& x) {
+                ys.push(x);
+            });
+            return ys;
+        }
+
+        const auto offset = ys.tailOffset();
+        const auto n = ys.tail()->count;
+        ys.pushLeaf(std::move(ys.tail_), offset, n);
+        ys.root_ = ys.concatTrie(ys.root_, ys.shift_, that.root_, that.shift_);
+        ys.shift_ = std::max(ys.shift_, that.shift_) + trie::bits;
+        ys.dense_ = false;
+        ys.tail_ = that.tail_;
+        ys.size_ += that.size_;
+        ys.shrink();
+        return ys;
+    }
+
+    /**
+     * @brief Returns the first `n` elements of this vector, in O(log32 n)
+     *        time.
+     *
+     * @param n the number of elements to take
+     * @return a vector of the first `n` elements of this vector, or the
+     *         whole vector if `n > size()`
+     */
+    Vector take(std::size_t n) const
+    {
+        if (n == 0) {
+            return Vector(allocator());
+        } else if (n >= size()) {
+            return *this;
+        }
+
+        Vector ys(allocator());
+        ys.size_ = n;
+        const auto offset = tailOffset();
+        if (n > offset) {
+            ys.shift_ = shift_;
+            ys.dense_ = dense_;
+            ys.root_ = root_;
+            ys.tail_ = Leaf::copyRange(allocator(), tail(), 0, n - offset);
+            return ys;
+        }
+
+        // The leaf holding the last element kept becomes the tail.
+        std::size_t start;
+        const auto leaf = leafFor(n - 1, start);
+        ys.tail_ = n - start == leaf->count
+            ? NodePtr::share(leaf)
+            : Leaf::copyRange(allocator(), leaf, 0, n - start);
+        if (start > 0) {
+            ys.shift_ = shift_;
+            ys.dense_ = dense_;
+            ys.root_ = takeTrie(root_, shift_, offset, start);
+            ys.shrink();
+        }
+        return ys;
+    }
+
+    /**
+     * @brief Returns all elements of this vector except the first `n`, in
+     *        O(log32 n) time.
+     *
+     * @param n the number of elements to drop
+     * @return a vector of all elements of this vector except the first
+     *         `n`, or an empty vector if `n > size()`
+     */
+    Vector drop(std::size_t n) const
+    {
+        if (n == 0) {
+            return *this;
+        } else if (n >= size()) {
+            return Vector(allocator());
+        }
+
+        Vector ys(allocator());
+        ys.size_ = size_ - n;
+        const auto offset = tailOffset();
+        if (n >= offset) {
+            ys.tail_ = Leaf::copyRange(allocator(), tail(), n - offset, tail()->count);
+            return ys;
+        }
+        ys.shift_ = shift_;
+        ys.dense_ = false;
+        ys.root_ = dropTrie(root_, shift_, offset, n);
+        ys.tail_ = tail_;
+        ys.shrink();
+        return ys;
+    }
+
+    /**
+     * @brief Returns the elements of this vector from position `from` up
+     *        until position `until`.
+     *
+     * Only the leaves at either end and the trie nodes on the paths to them
+     * are copied, so this takes O(log32 n) time.
+     *
+     * @param from the index of the starting position (included)
+     * @param until the index of the ending position (excluded)
+     * @return a vector of the elements of this vector starting at position
+     *         `from` and extending up until position `until`, or an empty
+     *         vector if `from >= until` or `from >= size()`
+     */
+    Vector slice(std::size_t from, std::size_t until) const
+    {
+        until = std::min(until, size());
+        if (from >= until) {
+            return Vector(allocator());
+        }
+        return take(until).drop(from);
+    }
+
+    /**
+     * @brief Splits this vector at a position, in O(log32 n) time.
+     *
+     * @param n the position to split at
+     * @return a pair of the first `n` elements of this vector, or the whole
+     *         vector if `n > size()`, and the remaining elements
+     */
+    std::pair<Vector, Vector> splitAt(std::size_t n) const
+    {
+        n = std::min(n, size());
+        return std::make_pair(take(n), drop(n));
+    }
+
+    /**
+     * @brief Returns a new vector with an element inserted at a position,
+     *        in O(log32 n) time.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `A`
+     * @param index the position of the inserted element
+     * @param args the arguments passed to the constructor of `A`
+     * @return a new vector consisting of the first `index` elements of this
+     *         vector, an element constructed in-place from `args`, and the
+     *         remaining elements of this vector
+     * @throws std::out_of_range if `index > size()`
+     */
+    template<typename... Args>
+    Vector insertAt(std::size_t index, Args&&... args) const
+    {
+        if (index > size()) {
+            throw std::out_of_range("index out of range");
+        }
+        return take(index).appended(std::forward<Args>(args)...).concat(drop(index));
+    }
+
+    /**
+     * @brief Compares this vector with the given vector for equality.
+     *
+     * @param that the vector to be compared for equality with this vector
+     * @return `true` if `that` contains the same elements as this vector
+     *         in the same order, `false` otherwise
+     */
+    bool operator==(const Vector& that) const
+    {
+        if (size() != that.size()) {
+            return false;
+        }
+        if (root_.get() == that.root_.get() && tail_.get() == that.tail_.get()) {
+            return true;
+        }
+        for (auto it1 = begin(), it2 = that.begin(); it1 != end(); ++it1, ++it2) {
+            if (*it1 != *it2) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Compares this vector with the given vector for inequality.
+     *
+     * @param that the vector to be compared for inequality with this vector
+     * @return `true` if `that` does not contains the same elements as this
+     *         vector in the same order, `false` otherwise
+     */
+    bool operator!=(const Vector& that) const
+    {
+        return !(*this == that);
+    }
+
+    /**
+     * @brief Swaps the contents of this vector and `that`.
+     *
+     * @param that the vector to swap contents with
+     */
+    void swap(Vector& that) noexcept
+    {
+        using std::swap;
+        swap(static_cast<Compressed<Alloc>&>(*this),
+             static_cast<Compressed<Alloc>&>(that));
+        swap(size_, that.size_);
+        swap(shift_, that.shift_);
+        swap(dense_, that.dense_);
+        root_.swap(that.root_);
+        tail_.swap(that.tail_);
+    }
+
+    /**
+     * @brief Returns a transient copy of this vector, which can be modified
+     *        in place and then frozen with `persistent()`.
+     *
+     * The transient shares all nodes of this vector, so this takes O(1)
+     * time; each node is copied at most once, the first time the transient
+     * modifies it.
+     *
+     * @return a transient vector with the elements of this vector
+     */
+    TransientVector<A, Alloc> asTransient() const&
+    {
+        return TransientVector<A, Alloc>(*this);
+    }
+
+    /**
+     * @brief Returns a transient vector with the elements of this vector,
+     *        which can be modified in place and then frozen with
+     *        `persistent()`.
+     *
+     * @return a transient vector with the elements of this vector
+     */
+    TransientVector<A, Alloc> asTransient() &&
+    {
+        return TransientVector<A, Alloc>(std::move(*this));
+    }
+
+    class StdIterator;
+
+    /**
+     * @brief Returns an iterator to the first element of this vector.
+     *
+     * If this vector is empty, the returned iterator will be equal to `end()`.
+     *
+     * @return an iterator to the first element of this vector.
+     */
+    StdIterator begin() const
+    {
+        return StdIterator(this, 0);
+    }
+
+    /**
+     * @brief Returns an iterator to the element following the last element
+     *        of this vector.
+     *
+     * This element acts as a placeholder; attempting to access it results in
+     * undefined behavior.
+     *
+     * @return an iterator to the element following the last element
+     *         of this vector
+     */
+    StdIterator end() const
+    {
+        return StdIterator(this, size());
+    }
+
+private:
+    template<typename, typename>
+    friend class Vector;
+
+    template<typename, typename>
+    friend class TransientVector;
+
+    class Node;
+    class Leaf;
+    class Branch;
+    class NodePtr;
+
+    // The index of the first element held by the tail leaf.
+    std::size_t tailOffset() const
+    {
+        return tail_.get() ? size_ - tail()->count : 0;
+    }
+
+    const Leaf* tail() const
+    {
+        return static_cast<const Leaf*>(tail_.get());
+    }
+
+    // Returns the leaf holding the element at `index`, which must be less
+    // than `size()`, and sets `start` to the index of its first element.
+    const Leaf* leafFor(std::size_t index, std::size_t& start) const
+    {
+        const auto offset = tailOffset();
+        if (index >= offset) {
+            start = offset;
+            return tail();
+        }
+        if (!dense_) {
+            return searchLeaf(index, start);
+        }
+        auto n = root_.get();
+        for (auto level = shift_; level > 0; level -= trie::bits) {
+            n = static_cast<const Branch*>(n)->children[(index >> level) & trie::mask].get();
+        }
+        start = index & ~trie::mask;
+        return static_cast<const Leaf*>(n);
+    }
+
+    // Like `leafFor()`, for an `index` in a trie that is not dense.
+    const Leaf* searchLeaf(std::size_t index, std::size_t& start) const
+    {
+        auto n = root_.get();
+        auto i = index;
+        for (auto level = shift_; level > 0; level -= trie::bits) {
+            const auto b = static_cast<const Branch*>(n);
+            n = b->children[b->slotFor(level, i)].get();
+        }
+        start = index - i;
+        return static_cast<const Leaf*>(n);
+    }
+
+    // Calls `f` with each leaf in order, stopping as soon as it returns
+    // `false`.
+    template<typename Fn>
+    void foreachLeaf(Fn f) const
+    {
+        if (root_.get() && !foreachLeaf(root_.get(), shift_, f)) {
+            return;
+        }
+        if (tail_.get()) {
+            f(tail());
+        }
+    }
+
+    template<typename Fn>
+    static bool foreachLeaf(const Node* n, unsigned level, Fn& f)
+    {
+        if (level == 0) {
+            return f(static_cast<const Leaf*>(n));
+        }
+        const auto b = static_cast<const Branch*>(n);
+        for (std::size_t i = 0; i < b->count; ++i) {
+            if (!foreachLeaf(b->children[i].get(), level - trie::bits, f)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns the branch held by `slot`, first replacing it with a copy if
+    // it is shared, so that it can be modified in place.
+    Branch& mutableBranch(NodePtr& slot)
+    {
+        if (!slot.get()) {
+            slot = Branch::create(allocator());
+        } else if (!slot->unique()) {
+            slot = Branch::copy(allocator(), static_cast<const Branch*>(slot.get()));
+        }
+        return *static_cast<Branch*>(slot.mutableGet());
+    }
+
+    // Appends an element constructed from `args` to this vector in place.
+    // Nodes referenced only by this vector are modified directly; shared
+    // ones are copied first.
+    template<typename... Args>
+    void push(Args&&... args)
+    {
+        if (tail_.get() && tail()->count < trie::width && !tail_->unique()) {
+            tail_ = Leaf::copy(allocator(), tail());
+        }
+        pushFresh(std::forward<Args>(args)...);
+    }
+
+    // Replaces the element at `index`, which must be less than `size()`,
+    // with one constructed from `args`, in place. Nodes referenced only by
+    // this vector are modified directly; shared ones are copied first.
+    template<typename... Args>
+    void set(std::size_t index, Args&&... args)
+    {
+        auto slot = &tail_;
+        const auto offset = tailOffset();
+        if (index < offset) {
+            slot = &root_;
+            for (auto level = shift_; level > 0; level -= trie::bits) {
+                auto& b = mutableBranch(*slot);
+                slot = &b.children[b.slotFor(level, index)];
+            }
+        } else {
+            index -= offset;
+        }
+        const auto leaf = static_cast<const Leaf*>(slot->get());
+        if (std::is_nothrow_move_constructible<A>::value && leaf->unique()) {
+            static_cast<Leaf*>(slot->mutableGet())->replace(index, std::forward<Args>(args)...);
+        } else {
+            *slot = Leaf::copy(allocator(), leaf, index, std::forward<Args>(args)...);
+        }
+    }
+
+    // Like `push()`, for a vector whose tail leaf is known not to be shared,
+    // e.g. one being built from scratch. Unlike `push()`, it does not
+    // require `A` to be copy constructible.
+    template<typename... Args>
+    void pushFresh(Args&&... args)
+    {
+        if (!tail_.get()) {
+            tail_ = Leaf::create(allocator());
+        } else if (tail()->count == trie::width) {
+            auto leaf = Leaf::create(allocator());
+            const auto offset = tailOffset();
+            pushLeaf(std::move(tail_), offset, trie::width);
+            tail_ = std::move(leaf);
+        }
+        static_cast<Leaf*>(tail_.mutableGet())->emplace(std::forward<Args>(args)...);
+        ++size_;
+    }
+
+    // Appends `leaf`, holding `n` elements, to the trie, which holds the
+    // first `offset` elements, adding a level on top if it is full.
+    void pushLeaf(NodePtr leaf, std::size_t offset, std::size_t n)
+    {
+        if (!root_.get() || hasRoom(root_.get(), shift_)) {
+            pushLeaf(root_, shift_, offset, std::move(leaf), n);
+            return;
+        }
+        auto root = Branch::create(allocator());
+        auto& b = *static_cast<Branch*>(root.mutableGet());
+        b.children[0] = std::move(root_);
+        b.children[1] = newPath(shift_, std::move(leaf));
+        b.count = 2;
+        shift_ += trie::bits;
+        if (offset != std::size_t(1) << shift_) {
+            b.sizes[0] = offset;
+            b.sizes[1] = offset + n;
+            b.relaxed = true;
+        }
+        root_ = std::move(root);
+    }
+
+    // Appends `leaf` to the subtrie of `size` elements held by `slot` at
+    // `level`, which must have room for it. A regular branch stays regular
+    // as long as the leaf lands after full children only.
+    void pushLeaf(NodePtr& slot, unsigned level, std::size_t size, NodePtr leaf, std::size_t n)
+    {
+        auto& b = mutableBranch(slot);
+        const std::size_t c = b.count;
+        if (level > trie::bits && c > 0 && hasRoom(b.children[c - 1].get(), level - trie::bits)) {
+            const auto before = b.childSize(level, size, c - 1);
+            pushLeaf(b.children[c - 1], level - trie::bits, before, std::move(leaf), n);
+            if (b.relaxed) {
+                b.sizes[c - 1] += n;
+            }
+            return;
+        }
+        if (!b.relaxed && size != c << level) {
+            b.relax(level, size);
+        }
+        b.children[c] = newPath(level - trie::bits, std::move(leaf));
+        b.count = static_cast<std::uint16_t>(c + 1);
+        b.sizes[c] = size + n;
+    }
+
+    // Whether the subtrie `n` at `level` can take another leaf.
+    static bool hasRoom(const Node* n, unsigned level)
+    {
+        for (; level > trie::bits && n->count == trie::width; level -= trie::bits) {
+            n = static_cast<const Branch*>(n)->children[trie::width - 1].get();
+        }
+        return n->count < trie::width;
+    }
+
+    // Returns a chain of single-child branches of height `level` ending
+    // with `leaf`.
+    NodePtr newPath(unsigned level, NodePtr leaf)
+    {
+        if (level == 0) {
+            return leaf;
+        }
+        auto n = Branch::create(allocator());
+        auto& b = *static_cast<Branch*>(n.mutableGet());
+        b.children[0] = newPath(level - trie::bits, std::move(leaf));
+        b.count = 1;
+        return n;
+    }
+
+    // The number of elements of the subtrie `n` at `level`.
+    static std::size_t sizeOf(const Node* n, unsigned level)
+    {
+        std::size_t size = 0;
+        for (; level > 0; level -= trie::bits) {
+            const auto b = static_cast<const Branch*>(n);
+            if (b->relaxed) {
+                return size + b->sizes[b->count - 1];
+            }
+            size += std::size_t(b->count - 1) << level;
+            n = b->children[b->count - 1].get();
+        }
+        return size + n->count;
+    }
+
+    // Removes single-child branches from the top of the trie.
+    void shrink()
+    {
+        while (shift_ > trie::bits && root_->count == 1) {
+            NodePtr child = static_cast<const Branch*>(root_.get())->children[0];
+            root_ = std::move(child);
+            shift_ -= trie::bits;
+        }
+    }
+
+    // Returns the first `k` elements of the subtrie of `size` elements held
+    // by `slot` at `level`, where `0 < k <= size` and the `k`th element is
+    // the last of its leaf.
+    NodePtr takeTrie(const NodePtr& slot, unsigned level, std::size_t size, std::size_t k) const
+    {
+        if (k == size) {
+            return slot;
+        }
+        const auto b = static_cast<const Branch*>(slot.get());
+        auto last = k - 1;
+        const auto i = b->slotFor(level, last);
+        auto n = Branch::create(allocator());
+        auto& c = *static_cast<Branch*>(n.mutableGet());
+        for (std::size_t j = 0; j < i; ++j) {
+            c.children[j] = b->children[j];
+            c.sizes[j] = b->sizes[j];
+        }
+        c.children[i] = takeTrie(b->children[i], level - trie::bits,
+                                 b->childSize(level, size, i), last + 1);
+        c.count = static_cast<std::uint16_t>(i + 1);
+        c.sizes[i] = k;
+        c.relaxed = b->relaxed;
+        return n;
+    }
+
+    // Returns all elements of the subtrie of `size` elements held by `slot`
+    // at `level` except the first `k`, where `k < size`.
+    NodePtr dropTrie(const NodePtr& slot, unsigned level, std::size_t size, std::size_t k) const
+    {
+        if (k == 0) {
+            return slot;
+        } else if (level == 0) {
+            const auto l = static_cast<const Leaf*>(slot.get());
+            return Leaf::copyRange(allocator(), l, k, l->count);
+        }
+        const auto b = static_cast<const Branch*>(slot.get());
+        auto first = k;
+        const auto i = b->slotFor(level, first);
+        auto n = Branch::create(allocator());
+        auto& c = *static_cast<Branch*>(n.mutableGet());
+        c.children[0] = dropTrie(b->children[i], level - trie::bits,
+                                 b->childSize(level, size, i), first);
+        std::size_t end = k;
+        for (std::size_t j = i; j < b->count; ++j) {
+            end += b->childSize(level, size, j) - (j == i ? first : 0);
+            if (j > i) {
+                c.children[j - i] = b->children[j];
+            }
+            c.sizes[j - i] = end - k;
+        }
+        c.count = static_cast<std::uint16_t>(b->count - i);
+        c.relaxed = true;
+        return n;
+    }
+
+    // Returns a branch at one level above the higher of `l` and `r`, at
+    // levels `ll` and `rl`, holding the elements of both. Only the nodes
+    // along the seam between them are merged; the rest are shared.
+    NodePtr concatTrie(const NodePtr& l, unsigned ll, const NodePtr& r, unsigned rl) const
+    {
+        if (ll > rl) {
+            const auto lb = static_cast<const Branch*>(l.get());
+            const auto c = concatTrie(lb->children[lb->count - 1], ll - trie::bits, r, rl);
+            return rebalance(lb, c, nullptr, ll);
+        } else if (ll < rl) {
+            const auto rb = static_cast<const Branch*>(r.get());
+            const auto c = concatTrie(l, ll, rb->children[0], rl - trie::bits);
+            return rebalance(nullptr, c, rb, rl);
+        } else if (ll == 0) {
+            auto n = Branch::create(allocator());
+            auto& b = *static_cast<Branch*>(n.mutableGet());
+            b.children[0] = l;
+            b.children[1] = r;
+            b.count = 2;
+            b.resize(trie::bits);
+            return n;
+        }
+        const auto lb = static_cast<const Branch*>(l.get());
+        const auto rb = static_cast<const Branch*>(r.get());
+        const auto c = concatTrie(lb->children[lb->count - 1], ll - trie::bits,
+                                  rb->children[0], rl - trie::bits);
+        return rebalance(lb, c, rb, ll);
+    }
+
+    // Merges the children of `l` but its last, of `centre`, and of `r` but
+    // its first, all at `level`, redistributing the slots of underfull
+    // nodes into fewer nodes, and returns a branch at the level above
+    // holding the one or two resulting branches.
+    NodePtr rebalance(const Branch* l, const NodePtr& centre, const Branch* r, unsigned level) const
+    {
+        const NodePtr* all[2 * trie::width];
+        std::size_t len = 0;
+        if (l) {
+            for (std::size_t i = 0; i + 1 < l->count; ++i) {
+                all[len++] = &l->children[i];
+            }
+        }
+        const auto cb = static_cast<const Branch*>(centre.get());
+        for (std::size_t i = 0; i < cb->count; ++i) {
+            all[len++] = &cb->children[i];
+        }
+        if (r) {
+            for (std::size_t i = 1; i < r->count; ++i) {
+                all[len++] = &r->children[i];
+            }
+        }
+
+        // Plan the slots in use of each merged node.
+        std::size_t counts[2 * trie::width];
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < len; ++i) {
+            counts[i] = (*all[i])->count;
+            total += counts[i];
+        }
+        const auto optimal = (total - 1) / trie::width + 1;
+        auto planned = len;
+        for (std::size_t i = 0; optimal + trie::extras < planned; --i) {
+            while (counts[i] > trie::width - trie::invariant) {
+                ++i;
+            }
+            // Spill the slots of the short node `i` and its successors to the
+            // left until one of them has been emptied, and drop it.
+            auto remaining = counts[i];
+            do {
+                const auto merged = std::min(remaining + counts[i + 1], trie::width);
+                remaining += counts[i + 1] - merged;
+                counts[i] = merged;
+                ++i;
+            } while (remaining > 0);
+            for (auto j = i; j + 1 < planned; ++j) {
+                counts[j] = counts[j + 1];
+            }
+            --planned;
+        }
+
+        // Build the merged nodes, sharing those the plan leaves as they are.
+        const auto childLevel = level - trie::bits;
+        NodePtr merged[2 * trie::width];
+        std::size_t src = 0;
+        std::size_t off = 0;
+        for (std::size_t i = 0; i < planned; ++i) {
+            if (off == 0 && (*all[src])->count == counts[i]) {
+                merged[i] = *all[src++];
+                continue;
+            }
+            if (childLevel == 0) {
+                merged[i] = Leaf::create(allocator());
+            } else {
+                merged[i] = Branch::create(allocator());
+            }
+            auto& m = *merged[i].mutableGet();
+            while (m.count < counts[i]) {
+                const auto& from = *all[src];
+                const auto k = std::min<std::size_t>(from->count - off, counts[i] - m.count);
+                if (childLevel == 0) {
+                    const auto fl = static_cast<const Leaf*>(from.get());
+                    for (auto j = off; j < off + k; ++j) {
+                        static_cast<Leaf&>(m).emplace(*fl->at(j));
+                    }
+                } else {
+                    const auto fb = static_cast<const Branch*>(from.get());
+                    auto& mb = static_cast<Branch&>(m);
+                    for (auto j = off; j < off + k; ++j) {
+                        mb.children[mb.count++] = fb->children[j];
+                    }
+                }
+                off += k;
+                if (off == from->count) {
+                    ++src;
+                    off = 0;
+                }
+            }
+            if (childLevel > 0) {
+                static_cast<Branch&>(m).resize(childLevel);
+            }
+        }
+
+        auto n = Branch::create(allocator());
+        auto& top = *static_cast<Branch*>(n.mutableGet());
+        for (std::size_t i = 0; i < planned; i += trie::width) {
+            auto part = Branch::create(allocator());
+            auto& b = *static_cast<Branch*>(part.mutableGet());
+            for (auto j = i; j < std::min(planned, i + trie::width); ++j) {
+                b.children[b.count++] = std::move(merged[j]);
+            }
+            b.resize(level);
+            top.children[top.count++] = std::move(part);
+        }
+        top.resize(level + trie::bits);
+        return n;
+    }
+
+    // Returns `f(xs)` joined over the chunks `xs` of this vector that
+    // `policy` splits it into, computed concurrently.
+    template<typename V, typename Fn>
+    V splitJoin(const ParallelPolicy& policy, Fn f) const
+    {
+        const auto k = policy.chunks(size());
+        if (k <= 1) {
+            return f(*this);
+        }
+
+        std::vector<V> parts(k, f(Vector(allocator())));
+        policy.executor().parallelFor(k, [&](std::size_t i) {
+            parts[i] = f(slice(size() * i / k, size() * (i + 1) / k));
+        });
+        auto ys = std::move(parts[0]);
+        for (std::size_t i = 1; i < k; ++i) {
+            ys = ys.concat(parts[i]);
+        }
+        return ys;
+    }
+
+    std::size_t size_;
+    unsigned shift_;
+    // Whether all leaves of the trie are full and no branch is relaxed, as
+    // when it was only built by appending, so that it can be indexed by bit
+    // arithmetic alone.
+    bool dense_;
+    NodePtr root_;
+    NodePtr tail_;
+};
+
+/**
+ * @brief A `RandomAccessIterator` for a `Vector`.
+ *
+ * Stepping within a leaf only bumps an index; moving to another leaf, or
+ * by an arbitrary distance, takes O(log32 n) time to look up the new leaf.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the element type of the vector
+ */
+template<typename A, typename Alloc>
+class Vector<A, Alloc>::StdIterator final {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = A;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const A*;
+    using reference = const A&;
+
+    /**
+     * @brief Constructs a singular iterator, which may only be assigned to.
+     */
+    StdIterator() noexcept : vec_(nullptr), index_(0), start_(0), leaf_(nullptr) {}
+
+    /** @brief Default copy constructor. */
+    StdIterator(const StdIterator&) = default;
+
+    /** @brief Default move constructor. */
+    StdIterator(StdIterator&&) = default;
+
+    /** @brief Default copy assignment operator. */
+    StdIterator& operator=(const StdIterator&) = default;
+
+    /** @brief Default move assignment operator. */
+    StdIterator& operator=(StdIterator&&) = default;
+
+    /**
+     * @brief Compares this iterator with the given iterator for equality.
+     *
+     * @param that the iterator to be compared for equality with this iterator
+     * @return `true` if `that` points to the same element as this iterator,
+     *         `false` otherwise
+     */
+    bool operator==(const StdIterator& that) const
+    {
+        return index_ == that.index_;
+    }
+
+    /**
+     * @brief Compares this iterator with the given iterator for inequality.
+     *
+     * @param that the iterator to be compared for inequality with this iterator
+     * @return `true` if `that` does not point to the same element as this
+     *         iterator, `false` otherwise
+     */
+    bool operator!=(const StdIterator& that) const
+    {
+        return index_ != that.index_;
+    }
+
+    /**
+     * @brief Tests whether this iterator points to an element before the one
+     *        `that` points to.
+     *
+     * @param that the iterator to be compared with this iterator
+     * @return `true` if this iterator precedes `that`, `false` otherwise
+     */
+    bool operator<(const StdIterator& that) const
+    {
+        return index_ < that.index_;
+    }
+
+    /**
+     * @brief Tests whether this iterator points to an element after the one
+     *        `that` points to.
+     *
+     * @param that the iterator to be compared with this iterator
+     * @return `true` if this iterator follows `that`, `false` otherwise
+     */
+    bool operator>(const StdIterator& that) const
+    {
+        return index_ > that.index_;
+    }
+
+    /**
+     * @brief Tests whether this iterator does not follow `that`.
+     *
+     * @param that the iterator to be compared with this iterator
+     * @return `true` if this iterator does not follow `that`, `false` otherwise
+     */
+    bool operator<=(const StdIterator& that) const
+    {
+        return index_ <= that.index_;
+    }
+
+    /**
+     * @brief Tests whether this iterator does not precede `that`.
+     *
+     * @param that the iterator to be compared with this iterator
+     * @return `true` if this iterator does not precede `that`, `false` otherwise
+     */
+    bool operator>=(const StdIterator& that) const
+    {
+        return index_ >= that.index_;
+    }
+
+    /**
+     * @brief Increments this iterator and returns a reference to it.
+     *
+     * @return a reference to this iterator
+     */
+    StdIterator& operator++()
+    {
+        ++index_;
+        if (!leaf_ || index_ - start_ == leaf_->count) {
+            seek();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Increments this iterator and returns a copy of the original iterator.
+     *
+     * @return a copy of the original iterator
+     */
+    StdIterator operator++(int)
+    {
+        StdIterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    /**
+     * @brief Decrements this iterator and returns a reference to it.
+     *
+     * @return a reference to this iterator
+     */
+    StdIterator& operator--()
+    {
+        if (!leaf_ || index_ == start_) {
+            --index_;
+            seek();
+        } else {
+            --index_;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Decrements this iterator and returns a copy of the original iterator.
+     *
+     * @return a copy of the original iterator
+     */
+    StdIterator operator--(int)
+    {
+        StdIterator it = *this;
+        --*this;
+        return it;
+    }
+
+    /**
+     * @brief Advances this iterator by `n` elements and returns a reference
+     *        to it.
+     *
+     * @param n the number of elements to advance by, which may be negative
+     * @return a reference to this iterator
+     */
+    StdIterator& operator+=(difference_type n)
+    {
+        index_ += n;
+        if (!leaf_ || index_ < start_ || index_ - start_ >= leaf_->count) {
+            seek();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Moves this iterator back by `n` elements and returns a reference
+     *        to it.
+     *
+     * @param n the number of elements to move back by, which may be negative
+     * @return a reference to this iterator
+     */
+    StdIterator& operator-=(difference_type n)
+    {
+        return *this += -n;
+    }
+
+    /**
+     * @brief Returns an iterator `n` elements after this one.
+     *
+     * @param n the number of elements to advance by, which may be negative
+     * @return an iterator `n` elements after this one
+     */
+    StdIterator operator+(difference_type n) const
+    {
+        StdIterator it = *this;
+        return it += n;
+    }
+
+    /**
+     * @brief Returns an iterator `n` elements after `it`.
+     *
+     * @param n the number of elements to advance by, which may be negative
+     * @param it the iterator to advance
+     * @return an iterator `n` elements after `it`
+     */
+    friend StdIterator operator+(difference_type n, const StdIterator& it)
+    {
+        return it + n;
+    }
+
+    /**
+     * @brief Returns an iterator `n` elements before this one.
+     *
+     * @param n the number of elements to move back by, which may be negative
+     * @return an iterator `n` elements before this one
+     */
+    StdIterator operator-(difference_type n) const
+    {
+        StdIterator it = *this;
+        return it -= n;
+    }
+
+    /**
+     * @brief Returns the number of elements between `that` and this iterator.
+     *
+     * @param that an iterator into the same vector
+     * @return the number of increments needed to go from `that` to this
+     *         iterator, which is negative if this iterator precedes `that`
+     */
+    difference_type operator-(const StdIterator& that) const
+    {
+        return difference_type(index_) - difference_type(that.index_);
+    }
+
+    /**
+     * @brief Returns a reference to the element this iterator points to.
+     *
+     * @return a reference to the element this iterator points to
+     */
+    const A& operator*() const
+    {
+        return *leaf_->at(index_ - start_);
+    }
+
+    /**
+     * @brief Returns a pointer to the element this iterator points to.
+     *
+     * @return a pointer to the element this iterator points to
+     */
+    const A* operator->() const
+    {
+        return leaf_->at(index_ - start_);
+    }
+
+    /**
+     * @brief Returns a reference to the element `n` elements after the one
+     *        this iterator points to.
+     *
+     * @param n the offset of the element, which may be negative
+     * @return a reference to the element `n` elements after this one
+     */
+    const A& operator[](difference_type n) const
+    {
+        return (*vec_)[index_ + n];
+    }
+
+private:
+    friend class Vector;
+
+    StdIterator(const Vector* vec, std::size_t index) noexcept
+        : vec_(vec)
+        , index_(index)
+        , start_(0)
+    {
+        seek();
+    }
+
+    // Looks up the leaf holding the element at `index_`, if any.
+    void seek()
+    {
+        leaf_ = index_ < vec_->size() ? vec_->leafFor(index_, start_) : nullptr;
+    }
+
+    const Vector* vec_;
+    std::size_t index_;
+    // The index of the first element of `leaf_`.
+    std::size_t start_;
+    const Leaf* leaf_;
+};
+
+/**
+ * @brief A vector under construction that is modified in place.
+ *
+ * A persistent vector pays for persistence on every step of a bulk load:
+ * each `appended()` or `updated()` copies the tail leaf or the path to the
+ * element it replaces. A transient vector instead modifies the nodes only
+ * it references in place, copying each shared node at most once, and
+ * freezes them into a vector once, with `persistent()`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the elements; must be a non-reference type
+ * @tparam Alloc the type of the allocator used to allocate the nodes of
+ *               the vector
+ */
+template<typename A, typename Alloc = std::allocator<A>>
+class TransientVector final {
+    using V = Vector<A, Alloc>;
+
+public:
+    /**
+     * @brief Constructs an empty transient vector.
+     */
+    TransientVector() : TransientVector(V()) {}
+
+    /**
+     * @brief Constructs a transient vector with the elements of `xs`.
+     *
+     * @param xs the vector whose elements the transient starts with
+     */
+    explicit TransientVector(V xs) noexcept : xs_(std::move(xs)) {}
+
+    /** @brief Deleted copy constructor. */
+    TransientVector(const TransientVector&) = delete;
+
+    /** @brief Move constructor. The moved-from transient is left empty. */
+    TransientVector(TransientVector&&) = default;
+
+    /** @brief Deleted copy assignment operator. */
+    TransientVector& operator=(const TransientVector&) = delete;
+
+    /** @brief Deleted move assignment operator. */
+    TransientVector& operator=(TransientVector&&) = delete;
+
+    /**
+     * @brief Returns the number of elements of this transient vector.
+     *
+     * @return the number of elements of this transient vector
+     */
+    std::size_t size() const
+    {
+        return xs_.size();
+    }
+
+    /**
+     * @brief Returns the element at the specified position.
+     *
+     * @param index the position of the element
+     * @return the element at position `index`
+     * @throws std::out_of_range if `index >= size()`
+     */
+    const A& operator[](std::size_t index) const
+    {
+        return xs_[index];
+    }
+
+    /**
+     * @brief Appends an element constructed in-place from `args`.
+     *
+     * @tparam Args the types of the arguments passed to the constructor of `A`
+     * @param args the arguments passed to the constructor of `A`
+     * @return a reference to this transient vector
+     */
+    template<typename... Args>
+    TransientVector& append(Args&&... args)
+    {
+        xs_.push(std::forward<Args>(args)...);
+        return *this;
+    }
+
+    /**
+     * @brief Replaces the element at the specified position.
+     *
+     * @tparam Args the types of the argument passed to the constructor of `A`
+     * @param index the position of the replacement
+     * @param args the argument passed to the constructor of `A`
+     * @return a reference to this transient vector
+     * @throws std::out_of_range if `index >= size()`
+     */
+    template<typename... Args>
+    TransientVector& update(std::size_t index, Args&&... args)
+    {
+        if (index >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+        xs_.set(index, std::forward<Args>(args)...);
+        return *this;
+    }
+
+    /**
+     * @brief Returns the vector of all elements of this transient vector
+     *        and empties it.
+     *
+     * @return the vector of all elements of this transient vector
+     */
+    V persistent()
+    {
+        return std::move(xs_);
+    }
+
+private:
+    V xs_;
+};
+
+/// @cond GUNGNIR_PRIVATE
+/*
+ * An intrusively reference-counted trie node, either a `Leaf` holding
+ * elements or a `Branch` holding child nodes. `count` is the number of
+ * elements or children in use; the rest of the slots are empty.
+ */
+template<typename A, typename Alloc>
+class Vector<A, Alloc>::Node {
+public:
+    Node(const Node&) = delete;
+    Node& operator=(const Node&) = delete;
+
+    bool unique() const
+    {
+        return refs_.load(std::memory_order_acquire) == 1;
+    }
+
+    std::uint16_t count;
+    // Whether this is a branch indexed through its size table. Kept here
+    // rather than in `Branch`, so that it shares a cache line with `count`.
+    bool relaxed;
+
+protected:
+    explicit Node(bool leaf) noexcept
+        : count(0)
+        , relaxed(false)
+        , leaf_(leaf)
+        , refs_(1)
+    {}
+
+    ~Node() = default;
+
+private:
+    friend class NodePtr;
+
+    static void retain(const Node* n)
+    {
+        n->refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void release(const Node* n)
+    {
+        if (n->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            const auto m = const_cast<Node*>(n);
+            if (n->leaf_) {
+                Leaf::destroy(static_cast<Leaf*>(m));
+            } else {
+                Branch::destroy(static_cast<Branch*>(m));
+            }
+        }
+    }
+
+    const bool leaf_;
+    mutable std::atomic<std::uint32_t> refs_;
+};
+
+template<typename A, typename Alloc>
+class Vector<A, Alloc>::Leaf final : public Node, public Compressed<Alloc> {
+public:
+    static NodePtr create(const Alloc& a)
+    {
+        LeafAlloc alloc(a);
+        const auto p = LeafTraits::allocate(alloc, 1);
+        return NodePtr(new (p) Leaf(a));
+    }
+
+    // Returns a copy of `l`.
+    static NodePtr copy(const Alloc& a, const Leaf* l)
+    {
+        auto n = create(a);
+        auto& c = *static_cast<Leaf*>(n.mutableGet());
+        for (std::size_t i = 0; i < l->count; ++i) {
+            c.emplace(*l->at(i));
+        }
+        return n;
+    }
+
+    // Returns a leaf holding copies of the elements of `l` from `from` up
+    // until `until`.
+    static NodePtr copyRange(const Alloc& a, const Leaf* l, std::size_t from, std::size_t until)
+    {
+        auto n = create(a);
+        auto& c = *static_cast<Leaf*>(n.mutableGet());
+        for (auto i = from; i < until; ++i) {
+            c.emplace(*l->at(i));
+        }
+        return n;
+    }
+
+    // Returns a copy of `l` whose element at `index` is constructed from
+    // `args` instead.
+    template<typename... Args>
+    static NodePtr copy(const Alloc& a, const Leaf* l, std::size_t index, Args&&... args)
+    {
+        auto n = create(a);
+        auto& c = *static_cast<Leaf*>(n.mutableGet());
+        for (std::size_t i = 0; i < l->count; ++i) {
+            if (i == index) {
+                c.emplace(std::forward<Args>(args)...);
+            } else {
+                c.emplace(*l->at(i));
+            }
+        }
+        return n;
+    }
+
+    static void destroy(Leaf* l)
+    {
+        LeafAlloc alloc(l->get());
+        l->~Leaf();
+        LeafTraits::deallocate(alloc, l, 1);
+    }
+
+    const A* at(std::size_t i) const
+    {
+        return reinterpret_cast<const A*>(&elems_[i]);
+    }
+
+    // Constructs an element in the first empty slot.
+    template<typename... Args>
+    void emplace(Args&&... args)
+    {
+        new (&elems_[this->count]) A(std::forward<Args>(args)...);
+        ++this->count;
+    }
+
+    // Replaces the element at `i` with one constructed from `args`, which
+    // is moved into place only once constructed; `A` must be nothrow move
+    // constructible.
+    template<typename... Args>
+    void replace(std::size_t i, Args&&... args)
+    {
+        A x(std::forward<Args>(args)...);
+        const auto p = const_cast<A*>(at(i));
+        p->~A();
+        new (p) A(std::move(x));
+    }
+
+private:
+    using LeafAlloc = Rebind<Alloc, Leaf>;
+    using LeafTraits = std::allocator_traits<LeafAlloc>;
+
+    explicit Leaf(const Alloc& alloc) noexcept
+        : Node(true)
+        , Compressed<Alloc>(alloc)
+    {}
+
+    ~Leaf()
+    {
+        for (std::size_t i = this->count; i > 0; --i) {
+            at(i - 1)->~A();
+        }
+    }
+
+    typename std::aligned_storage<sizeof (A), alignof (A)>::type elems_[trie::width];
+};
+
+template<typename A, typename Alloc>
+class Vector<A, Alloc>::Branch final : public Node, public Compressed<Alloc> {
+public:
+    static NodePtr create(const Alloc& a)
+    {
+        BranchAlloc alloc(a);
+        const auto p = BranchTraits::allocate(alloc, 1);
+        return NodePtr(new (p) Branch(a));
+    }
+
+    // Returns a copy of `b` sharing its children.
+    static NodePtr copy(const Alloc& a, const Branch* b)
+    {
+        auto n = create(a);
+        auto& c = *static_cast<Branch*>(n.mutableGet());
+        for (std::size_t i = 0; i < b->count; ++i) {
+            c.children[i] = b->children[i];
+            c.sizes[i] = b->sizes[i];
+        }
+        c.count = b->count;
+        c.relaxed = b->relaxed;
+        return n;
+    }
+
+    static void destroy(Branch* b)
+    {
+        BranchAlloc alloc(b->get());
+        b->~Branch();
+        BranchTraits::deallocate(alloc, b, 1);
+    }
+
+    // Returns the slot of the child holding the element at `index` of this
+    // branch, at `level`, and makes `index` relative to that child. In a
+    // relaxed branch, the first candidate slot is never past the right one,
+    // and the rebalancing of concatenation keeps it a few slots away.
+    std::size_t slotFor(unsigned level, std::size_t& index) const
+    {
+        auto i = index >> level;
+        if (this->relaxed) {
+            for (; sizes[i] <= index; ++i) {}
+            index -= i > 0 ? sizes[i - 1] : 0;
+        } else {
+            index -= i << level;
+        }
+        return i;
+    }
+
+    // The number of elements of the child at slot `i` of this branch of
+    // `size` elements, at `level`.
+    std::size_t childSize(unsigned level, std::size_t size, std::size_t i) const
+    {
+        if (this->relaxed) {
+            return sizes[i] - (i > 0 ? sizes[i - 1] : 0);
+        }
+        return i + 1 < this->count ? std::size_t(1) << level : size - (i << level);
+    }
+
+    // Makes this regular branch of `size` elements, at `level`, relaxed.
+    void relax(unsigned level, std::size_t size)
+    {
+        for (std::size_t i = 0; i < this->count; ++i) {
+            sizes[i] = std::min((i + 1) << level, size);
+        }
+        this->relaxed = true;
+    }
+
+    // Computes the sizes of the children of this branch, at `level`, which
+    // is relaxed unless all children but the last are full.
+    void resize(unsigned level)
+    {
+        std::size_t total = 0;
+        this->relaxed = false;
+        for (std::size_t i = 0; i < this->count; ++i) {
+            const auto n = sizeOf(children[i].get(), level - trie::bits);
+            if (i + 1 < this->count && n != std::size_t(1) << level) {
+                this->relaxed = true;
+            }
+            total += n;
+            sizes[i] = total;
+        }
+    }
+
+    NodePtr children[trie::width];
+    // The number of elements held by the children up to each slot; only
+    // maintained if `relaxed`. A regular branch is indexed by bit
+    // arithmetic instead, as all its children but the last are full.
+    std::size_t sizes[trie::width];
+
+private:
+    using BranchAlloc = Rebind<Alloc, Branch>;
+    using BranchTraits = std::allocator_traits<BranchAlloc>;
+
+    explicit Branch(const Alloc& alloc) noexcept
+        : Node(false)
+        , Compressed<Alloc>(alloc)
+    {}
+
+    ~Branch() = default;
+};
+
+template<typename A, typename Alloc>
+class Vector<A, Alloc>::NodePtr final {
+public:
+    NodePtr() noexcept : node_(nullptr) {}
+
+    explicit NodePtr(Node* node) noexcept : node_(node) {}
+
+    // Returns another reference to `node`.
+    static NodePtr share(const Node* node) noexcept
+    {
+        Node::retain(node);
+        return NodePtr(const_cast<Node*>(node));
+    }
+
+    NodePtr(const NodePtr& that) noexcept : node_(that.node_)
+    {
+        if (node_) {
+            Node::retain(node_);
+        }
+    }
+
+    NodePtr(NodePtr&& that) noexcept : node_(that.node_)
+    {
+        that.node_ = nullptr;
+    }
+
+    ~NodePtr()
+    {
+        if (node_) {
+            Node::release(node_);
+        }
+    }
+
+    NodePtr& operator=(const NodePtr& that) noexcept
+    {
+        NodePtr(that).swap(*this);
+        return *this;
+    }
+
+    NodePtr& operator=(NodePtr&& that) noexcept
+    {
+        NodePtr(std::move(that)).swap(*this);
+        return *this;
+    }
+
+    void swap(NodePtr& that) noexcept
+    {
+        std::swap(node_, that.node_);
+    }
+
+    const Node* get() const noexcept
+    {
+        return node_;
+    }
+
+    // Only valid while the node is not reachable from any other vector.
+    Node* mutableGet() noexcept
+    {
+        return node_;
+    }
+
+    const Node* operator->() const noexcept
+    {
+        return node_;
+    }
+
+private:
+    Node* node_;
+};
+/// @endcond
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_VECTOR_HPP
@@ -0,0 +1,790 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GUNGNIR_DETAIL_HAMT_HPP
+#define GUNGNIR_DETAIL_HAMT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+namespace detail {
+
+// Building blocks of `HashTrie`, the hash array mapped trie behind
+// `HashMap` and `HashSet`.
+namespace hamt {
+
+// Each trie node consumes `bits` bits of a hash and has `width` slots.
+constexpr unsigned bits = 5;
+constexpr std::size_t mask = (std::size_t(1) << bits) - 1;
+
+// The shift at which all bits of a hash have been consumed.
+constexpr unsigned hashBits = std::numeric_limits<std::size_t>::digits;
+
+inline unsigned popcount(std::uint32_t x)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_popcount(x));
+#else
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    return static_cast<unsigned>((((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+}
+
+// The bit of the slot that `hash` selects at `shift`.
+inline std::uint32_t bitFor(std::size_t hash, unsigned shift)
+{
+    return std::uint32_t(1) << ((hash >> shift) & mask);
+}
+
+// The position of the slot of `bit` among the slots set in `map`.
+inline unsigned indexOf(std::uint32_t map, std::uint32_t bit)
+{
+    return popcount(map & (bit - 1));
+}
+
+}  // namespace hamt
+
+/*
+ * A persistent hash table of entries of type `E`, keyed by `KeyOf()(e)`.
+ *
+ * Each node has two 32-bit bitmaps telling which of its slots hold an
+ * entry inline and which hold a child node, and stores only the occupied
+ * slots, entries first, in one allocation; the position of a slot is the
+ * number of bits set below it. Keys whose hashes agree on all bits share a
+ * collision node, which holds a plain array of entries. Nodes other than
+ * the root always hold at least two entries in their subtree, so that a
+ * trie has one shape per set of keys.
+ *
+ * Lookups and updates take O(log32 n) steps. Nodes reachable from more
+ * than one trie are copied on the path to a change and otherwise shared;
+ * nodes that a trie alone holds are changed in place.
+ */
+template<typename E, typename KeyOf, typename Hash, typename Eq, typename Alloc>
+class HashTrie final : private Compressed<Alloc> {
+public:
+    using Key = Decay<Ret<KeyOf, const E&>>;
+
+    explicit HashTrie(const Alloc& alloc) noexcept
+        : Compressed<Alloc>(alloc)
+        , size_(0)
+    {}
+
+    HashTrie(const HashTrie&) = default;
+
+    HashTrie(HashTrie&& that) noexcept
+        : Compressed<Alloc>(that)
+        , size_(that.size_)
+        , root_(std::move(that.root_))
+    {
+        that.size_ = 0;
+    }
+
+    HashTrie& operator=(const HashTrie&) = default;
+
+    HashTrie& operator=(HashTrie&& that) noexcept
+    {
+        HashTrie(std::move(that)).swap(*this);
+        return *this;
+    }
+
+    Alloc allocator() const
+    {
+        return this->get();
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    // Returns the entry with key `k`, or a null pointer if there is none.
+    const E* find(const Key& k) const
+    {
+        const auto h = Hash()(k);
+        auto n = root_.get();
+        for (unsigned shift = 0; n; shift += hamt::bits) {
+            if (n->collision) {
+                if (n->hash == h) {
+                    for (unsigned i = 0; i < n->entryCount; ++i) {
+                        if (Eq()(KeyOf()(n->entry(i)), k)) {
+                            return &n->entry(i);
+                        }
+                    }
+                }
+                return nullptr;
+            }
+            const auto bit = hamt::bitFor(h, shift);
+            if (n->dataMap & bit) {
+                const auto& e = n->entry(hamt::indexOf(n->dataMap, bit));
+                return Eq()(KeyOf()(e), k) ? &e : nullptr;
+            } else if (!(n->nodeMap & bit)) {
+                return nullptr;
+            }
+            n = n->child(hamt::indexOf(n->nodeMap, bit)).get();
+        }
+        return nullptr;
+    }
+
+    // Inserts `e`, replacing the entry with the same key if any, and
+    // returns whether the trie grew.
+    bool insert(E e)
+    {
+        const auto h = Hash()(KeyOf()(e));
+        if (!root_.get()) {
+            root_ = Node::create(allocator(), hamt::bitFor(h, 0), 0);
+            root_.mutableGet()->emplace(std::move(e));
+            size_ = 1;
+            return true;
+        }
+        const auto grew = insert(root_, 0, h, e);
+        if (grew) {
+            ++size_;
+        }
+        return grew;
+    }
+
+    // Removes the entry with key `k`, if any, and returns whether there
+    // was one.
+    bool erase(const Key& k)
+    {
+        // Checking first spares copying the path to a missing key.
+        if (!find(k)) {
+            return false;
+        }
+        erase(root_, 0, Hash()(k), k);
+        if (--size_ == 0) {
+            root_ = NodePtr();
+        }
+        return true;
+    }
+
+    // Calls `f` with each entry, stopping as soon as it returns `false`,
+    // and returns whether it never did.
+    template<typename Fn>
+    bool foreachWhile(Fn f) const
+    {
+        return !root_.get() || foreachWhile(root_.get(), f);
+    }
+
+    // Returns a trie of the results of `f`, which must have the same keys
+    // as the entries it is applied to, so that the shape is kept as is.
+    template<typename Trie, typename Fn>
+    Trie mapEntries(Fn f) const
+    {
+        using BAlloc = Decay<decltype(std::declval<Trie>().allocator())>;
+        Trie t{BAlloc(allocator())};
+        if (root_.get()) {
+            t.root_ = mapNode<Trie>(t.allocator(), root_.get(), f);
+            t.size_ = size_;
+        }
+        return t;
+    }
+
+    // Returns a trie of the entries satisfying `p`, sharing the subtrees
+    // all of whose entries do.
+    template<typename Fn>
+    HashTrie filter(Fn p) const
+    {
+        HashTrie t(allocator());
+        if (root_.get()) {
+            t.root_ = filterNode(root_, p, t.size_);
+        }
+        return t;
+    }
+
+    // Tests whether this trie and `that` are the same one, so that they are
+    // trivially equal.
+    bool same(const HashTrie& that) const
+    {
+        return root_.get() == that.root_.get();
+    }
+
+    void swap(HashTrie& that) noexcept
+    {
+        using std::swap;
+        swap(static_cast<Compressed<Alloc>&>(*this),
+             static_cast<Compressed<Alloc>&>(that));
+        swap(size_, that.size_);
+        root_.swap(that.root_);
+    }
+
+private:
+    template<typename, typename, typename, typename, typename>
+    friend class HashTrie;
+
+    class Node;
+    class NodePtr;
+
+    // Whether the entries of a node its trie alone holds can be moved out
+    // of it without risking to leave it half moved-from.
+    static constexpr bool canSteal = std::is_nothrow_move_constructible<E>::value;
+
+    static std::size_t hashOf(const E& e)
+    {
+        return Hash()(KeyOf()(e));
+    }
+
+    static bool singleton(const Node* n)
+    {
+        return n->entryCount == 1 && n->childCount == 0;
+    }
+
+    // Returns the node held by `slot`, first replacing it with a copy if
+    // it is shared, so that it can be modified in place.
+    Node& mutableNode(NodePtr& slot)
+    {
+        if (!slot->unique()) {
+            slot = rebuild(slot, 0, nullptr, NodePtr());
+        }
+        return *slot.mutableGet();
+    }
+
+    bool insert(NodePtr& slot, unsigned shift, std::size_t h, E& e)
+    {
+        const Node* n = slot.get();
+        if (n->collision) {
+            for (unsigned i = 0; i < n->entryCount; ++i) {
+                if (Eq()(KeyOf()(n->entry(i)), KeyOf()(e))) {
+                    slot = rebuildCollision(slot, i, &e);
+                    return false;
+                }
+            }
+            slot = rebuildCollision(slot, n->entryCount, &e);
+            return true;
+        }
+
+        const auto bit = hamt::bitFor(h, shift);
+        if (n->dataMap & bit) {
+            const auto i = hamt::indexOf(n->dataMap, bit);
+            auto& old = const_cast<E&>(n->entry(i));
+            if (Eq()(KeyOf()(old), KeyOf()(e))) {
+                if (canSteal && n->unique()) {
+                    old.~E();
+                    new (&old) E(std::move(e));
+                } else {
+                    slot = rebuild(slot, bit, &e, NodePtr());
+                }
+                return false;
+            }
+            // The old entry moves down into a new child along with `e`.
+            auto child = canSteal && n->unique()
+                ? merge(std::move(old), hashOf(old), std::move(e), h, shift + hamt::bits)
+                : merge(static_cast<const E&>(old), hashOf(old), std::move(e), h, shift + hamt::bits);
+            slot = rebuild(slot, bit, nullptr, std::move(child));
+            return true;
+        } else if (n->nodeMap & bit) {
+            const auto j = hamt::indexOf(n->nodeMap, bit);
+            return insert(mutableNode(slot).child(j), shift + hamt::bits, h, e);
+        }
+        slot = rebuild(slot, bit, &e, NodePtr());
+        return true;
+    }
+
+    // Removes the entry with key `k`, which must be present.
+    void erase(NodePtr& slot, unsigned shift, std::size_t h, const Key& k)
+    {
+        const Node* n = slot.get();
+        if (n->collision) {
+            for (unsigned i = 0; i < n->entryCount; ++i) {
+                if (Eq()(KeyOf()(n->entry(i)), k)) {
+                    slot = rebuildCollision(slot, i, nullptr);
+                    return;
+                }
+            }
+            return;
+        }
+
+        const auto bit = hamt::bitFor(h, shift);
+        if (n->dataMap & bit) {
+            slot = rebuild(slot, bit, nullptr, NodePtr());
+            return;
+        }
+        const auto j = hamt::indexOf(n->nodeMap, bit);
+        auto& c = mutableNode(slot).child(j);
+        erase(c, shift + hamt::bits, h, k);
+
+        // A child left with one entry is replaced with the entry itself.
+        if (singleton(c.get())) {
+            if (canSteal && c->unique()) {
+                slot = rebuild(slot, bit, &c.mutableGet()->entry(0), NodePtr());
+            } else {
+                E e(c->entry(0));
+                slot = rebuild(slot, bit, &e, NodePtr());
+            }
+        }
+    }
+
+    // Returns a subtree at `shift` holding the two entries with the given
+    // hashes, which are not equal.
+    template<typename E1, typename E2>
+    NodePtr merge(E1&& e1, std::size_t h1, E2&& e2, std::size_t h2, unsigned shift)
+    {
+        if (shift >= hamt::hashBits) {
+            auto n = Node::createCollision(allocator(), h1, 2);
+            n.mutableGet()->emplace(std::forward<E1>(e1));
+            n.mutableGet()->emplace(std::forward<E2>(e2));
+            return n;
+        }
+
+        const auto b1 = hamt::bitFor(h1, shift);
+        const auto b2 = hamt::bitFor(h2, shift);
+        if (b1 == b2) {
+            auto n = Node::create(allocator(), 0, b1);
+            n.mutableGet()->child(0) = merge(std::forward<E1>(e1), h1, std::forward<E2>(e2), h2,
+                                             shift + hamt::bits);
+            return n;
+        }
+        auto n = Node::create(allocator(), b1 | b2, 0);
+        if (b1 < b2) {
+            n.mutableGet()->emplace(std::forward<E1>(e1));
+            n.mutableGet()->emplace(std::forward<E2>(e2));
+        } else {
+            n.mutableGet()->emplace(std::forward<E2>(e2));
+            n.mutableGet()->emplace(std::forward<E1>(e1));
+        }
+        return n;
+    }
+
+    // Returns a copy of the bitmap node held by `slot` whose slot `bit`
+    // holds `*e` (moved from) if `e` is not null, `child` if it is not
+    // null, and nothing otherwise. If the node is not shared, the rest of
+    // its contents are moved rather than copied.
+    NodePtr rebuild(NodePtr& slot, std::uint32_t bit, E* e, NodePtr child)
+    {
+        const Node* n = slot.get();
+        const bool unique = n->unique();
+        const auto dataMap = (n->dataMap & ~bit) | (e ? bit : 0);
+        const auto nodeMap = (n->nodeMap & ~bit) | (child.get() ? bit : 0);
+
+        auto r = Node::create(allocator(), dataMap, nodeMap);
+        auto& m = *r.mutableGet();
+        for (auto map = dataMap; map; map &= map - 1) {
+            const auto b = map & (~map + 1);
+            if (b == bit) {
+                m.emplace(std::move(*e));
+                continue;
+            }
+            auto& x = const_cast<E&>(n->entry(hamt::indexOf(n->dataMap, b)));
+            if (canSteal && unique) {
+                m.emplace(std::move(x));
+            } else {
+                m.emplace(static_cast<const E&>(x));
+            }
+        }
+        unsigned j = 0;
+        for (auto map = nodeMap; map; map &= map - 1, ++j) {
+            const auto b = map & (~map + 1);
+            if (b == bit) {
+                m.child(j) = std::move(child);
+            } else if (unique) {
+                m.child(j) = std::move(slot.mutableGet()->child(hamt::indexOf(n->nodeMap, b)));
+            } else {
+                m.child(j) = n->child(hamt::indexOf(n->nodeMap, b));
+            }
+        }
+        return r;
+    }
+
+    // Returns a copy of the collision node held by `slot` without its entry
+    // at `index`, if any, and with `*e` (moved from) appended if `e` is not
+    // null.
+    NodePtr rebuildCollision(NodePtr& slot, unsigned index, E* e)
+    {
+        const Node* n = slot.get();
+        const bool unique = n->unique();
+        const auto count = n->entryCount - (index < n->entryCount ? 1 : 0) + (e ? 1 : 0);
+
+        auto r = Node::createCollision(allocator(), n->hash, count);
+        auto& m = *r.mutableGet();
+        for (unsigned i = 0; i < n->entryCount; ++i) {
+            if (i == index) {
+                continue;
+            }
+            auto& x = const_cast<E&>(n->entry(i));
+            if (canSteal && unique) {
+                m.emplace(std::move(x));
+            } else {
+                m.emplace(static_cast<const E&>(x));
+            }
+        }
+        if (e) {
+            m.emplace(std::move(*e));
+        }
+        return r;
+    }
+
+    template<typename Fn>
+    static bool foreachWhile(const Node* n, Fn& f)
+    {
+        for (unsigned i = 0; i < n->entryCount; ++i) {
+            if (!f(n->entry(i))) {
+                return false;
+            }
+        }
+        for (unsigned j = 0; j < n->childCount; ++j) {
+            if (!foreachWhile(n->child(j).get(), f)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename Trie, typename BAlloc, typename Fn>
+    static typename Trie::NodePtr mapNode(const BAlloc& alloc, const Node* n, Fn& f)
+    {
+        auto r = n->collision
+            ? Trie::Node::createCollision(alloc, n->hash, n->entryCount)
+            : Trie::Node::create(alloc, n->dataMap, n->nodeMap);
+        auto& m = *r.mutableGet();
+        for (unsigned i = 0; i < n->entryCount; ++i) {
+            m.emplace(f(n->entry(i)));
+        }
+        for (unsigned j = 0; j < n->childCount; ++j) {
+            m.child(j) = mapNode<Trie>(alloc, n->child(j).get(), f);
+        }
+        return r;
+    }
+
+    // Returns the node held by `slot` without the entries violating `p`:
+    // the node itself if there are none, or a null pointer if all of them
+    // do. Adds the number of entries kept to `kept`.
+    template<typename Fn>
+    NodePtr filterNode(const NodePtr& slot, Fn& p, std::size_t& kept) const
+    {
+        const Node* n = slot.get();
+        if (n->collision) {
+            unsigned i = 0;
+            while (i < n->entryCount && p(n->entry(i))) {
+                ++i;
+            }
+            if (i == n->entryCount) {
+                kept += i;
+                return slot;
+            }
+            // The entry at `i` is dropped, so the rest fit in one less slot.
+            auto r = Node::createCollision(allocator(), n->hash, n->entryCount - 1);
+            auto& m = *r.mutableGet();
+            for (unsigned k = 0; k < i; ++k) {
+                m.emplace(n->entry(k));
+            }
+            for (++i; i < n->entryCount; ++i) {
+                if (p(n->entry(i))) {
+                    m.emplace(n->entry(i));
+                }
+            }
+            kept += m.entryCount;
+            return m.entryCount > 0 ? std::move(r) : NodePtr();
+        }
+
+        std::uint32_t dataKeep = 0;
+        for (auto map = n->dataMap; map; map &= map - 1) {
+            const auto b = map & (~map + 1);
+            if (p(n->entry(hamt::indexOf(n->dataMap, b)))) {
+                dataKeep |= b;
+                ++kept;
+            }
+        }
+
+        NodePtr children[std::size_t(1) << hamt::bits];
+        std::uint32_t nodeKeep = 0;
+        std::uint32_t inlined = 0;
+        bool same = dataKeep == n->dataMap;
+        unsigned j = 0;
+        for (auto map = n->nodeMap; map; map &= map - 1, ++j) {
+            const auto b = map & (~map + 1);
+            children[j] = filterNode(n->child(j), p, kept);
+            const auto c = children[j].get();
+            if (c != n->child(j).get()) {
+                same = false;
+            }
+            if (c) {
+                (singleton(c) ? inlined : nodeKeep) |= b;
+            }
+        }
+        if (same) {
+            return slot;
+        } else if (!(dataKeep | inlined | nodeKeep)) {
+            return NodePtr();
+        }
+
+        auto r = Node::create(allocator(), dataKeep | inlined, nodeKeep);
+        auto& m = *r.mutableGet();
+        for (auto map = dataKeep | inlined; map; map &= map - 1) {
+            const auto b = map & (~map + 1);
+            if (dataKeep & b) {
+                m.emplace(n->entry(hamt::indexOf(n->dataMap, b)));
+            } else {
+                m.emplace(children[hamt::indexOf(n->nodeMap, b)]->entry(0));
+            }
+        }
+        j = 0;
+        for (auto map = nodeKeep; map; map &= map - 1, ++j) {
+            const auto b = map & (~map + 1);
+            m.child(j) = std::move(children[hamt::indexOf(n->nodeMap, b)]);
+        }
+        return r;
+    }
+
+    std::size_t size_;
+    NodePtr root_;
+};
+
+/*
+ * An intrusively reference-counted trie node, allocated together with its
+ * entries and children: the node, then `entryCap` entries, of which the
+ * first `entryCount` are constructed, then `childCount` children.
+ */
+template<typename E, typename KeyOf, typename Hash, typename Eq, typename Alloc>
+class HashTrie<E, KeyOf, Hash, Eq, Alloc>::Node final : public Compressed<Alloc> {
+public:
+    // Returns a bitmap node with room for the given slots, whose entries
+    // are then to be emplaced in order and whose children are empty.
+    static NodePtr create(const Alloc& a, std::uint32_t dataMap, std::uint32_t nodeMap)
+    {
+        return allocate(a, dataMap, nodeMap, hamt::popcount(dataMap),
+                        hamt::popcount(nodeMap), false, 0);
+    }
+
+    // Returns a collision node for keys with hash `hash` with room for
+    // `count` entries, which are then to be emplaced.
+    static NodePtr createCollision(const Alloc& a, std::size_t hash, unsigned count)
+    {
+        return allocate(a, 0, 0, count, 0, true, hash);
+    }
+
+    Node(const Node&) = delete;
+    Node& operator=(const Node&) = delete;
+
+    bool unique() const
+    {
+        return refs_.load(std::memory_order_acquire) == 1;
+    }
+
+    const E& entry(unsigned i) const
+    {
+        return entries()[i];
+    }
+
+    E& entry(unsigned i)
+    {
+        return entries()[i];
+    }
+
+    const NodePtr& child(unsigned j) const
+    {
+        return children()[j];
+    }
+
+    NodePtr& child(unsigned j)
+    {
+        return children()[j];
+    }
+
+    // Constructs an entry in the first empty slot.
+    template<typename... Args>
+    void emplace(Args&&... args)
+    {
+        new (&entries()[entryCount]) E(std::forward<Args>(args)...);
+        ++entryCount;
+    }
+
+    const std::uint32_t dataMap;
+    const std::uint32_t nodeMap;
+    const std::uint32_t entryCap;
+    std::uint32_t entryCount;
+    const std::uint32_t childCount;
+    const bool collision;
+    const std::size_t hash;
+
+private:
+    friend class NodePtr;
+
+    static constexpr std::size_t align =
+        alignof (E) > alignof (std::max_align_t) ? alignof (E) : alignof (std::max_align_t);
+
+    using Word = typename std::aligned_storage<align, align>::type;
+    using WordAlloc = Rebind<Alloc, Word>;
+    using WordTraits = std::allocator_traits<WordAlloc>;
+
+    static constexpr std::size_t roundUp(std::size_t n, std::size_t a)
+    {
+        return (n + a - 1) / a * a;
+    }
+
+    static std::size_t entriesOffset()
+    {
+        return roundUp(sizeof (Node), alignof (E));
+    }
+
+    static std::size_t childrenOffset(std::size_t entryCap)
+    {
+        return roundUp(entriesOffset() + entryCap * sizeof (E), alignof (NodePtr));
+    }
+
+    static std::size_t words(std::size_t entryCap, std::size_t childCount)
+    {
+        return roundUp(childrenOffset(entryCap) + childCount * sizeof (NodePtr), sizeof (Word))
+            / sizeof (Word);
+    }
+
+    static NodePtr allocate(const Alloc& a, std::uint32_t dataMap, std::uint32_t nodeMap,
+                            unsigned entryCap, unsigned childCount, bool collision,
+                            std::size_t hash)
+    {
+        WordAlloc alloc(a);
+        const auto p = WordTraits::allocate(alloc, words(entryCap, childCount));
+        const auto n = new (p) Node(a, dataMap, nodeMap, entryCap, childCount, collision, hash);
+        for (unsigned j = 0; j < childCount; ++j) {
+            new (&n->children()[j]) NodePtr();
+        }
+        return NodePtr(n);
+    }
+
+    static void retain(const Node* n)
+    {
+        n->refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void release(const Node* n)
+    {
+        if (n->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            destroy(const_cast<Node*>(n));
+        }
+    }
+
+    static void destroy(Node* n)
+    {
+        WordAlloc alloc(n->get());
+        const auto size = words(n->entryCap, n->childCount);
+        for (auto i = n->entryCount; i > 0; --i) {
+            n->entries()[i - 1].~E();
+        }
+        for (auto j = n->childCount; j > 0; --j) {
+            n->children()[j - 1].~NodePtr();
+        }
+        n->~Node();
+        WordTraits::deallocate(alloc, reinterpret_cast<Word*>(n), size);
+    }
+
+    Node(const Alloc& alloc, std::uint32_t dataMap, std::uint32_t nodeMap,
+         unsigned entryCap, unsigned childCount, bool collision, std::size_t hash) noexcept
+        : Compressed<Alloc>(alloc)
+        , dataMap(dataMap)
+        , nodeMap(nodeMap)
+        , entryCap(entryCap)
+        , entryCount(0)
+        , childCount(childCount)
+        , collision(collision)
+        , hash(hash)
+        , refs_(1)
+    {}
+
+    ~Node() = default;
+
+    E* entries() const
+    {
+        return reinterpret_cast<E*>(
+            reinterpret_cast<char*>(const_cast<Node*>(this)) + entriesOffset());
+    }
+
+    NodePtr* children() const
+    {
+        return reinterpret_cast<NodePtr*>(
+            reinterpret_cast<char*>(const_cast<Node*>(this)) + childrenOffset(entryCap));
+    }
+
+    mutable std::atomic<std::uint32_t> refs_;
+};
+
+template<typename E, typename KeyOf, typename Hash, typename Eq, typename Alloc>
+class HashTrie<E, KeyOf, Hash, Eq, Alloc>::NodePtr final {
+public:
+    NodePtr() noexcept : node_(nullptr) {}
+
+    explicit NodePtr(Node* node) noexcept : node_(node) {}
+
+    NodePtr(const NodePtr& that) noexcept : node_(that.node_)
+    {
+        if (node_) {
+            Node::retain(node_);
+        }
+    }
+
+    NodePtr(NodePtr&& that) noexcept : node_(that.node_)
+    {
+        that.node_ = nullptr;
+    }
+
+    ~NodePtr()
+    {
+        if (node_) {
+            Node::release(node_);
+        }
+    }
+
+    NodePtr& operator=(const NodePtr& that) noexcept
+    {
+        NodePtr(that).swap(*this);
+        return *this;
+    }
+
+    NodePtr& operator=(NodePtr&& that) noexcept
+    {
+        NodePtr(std::move(that)).swap(*this);
+        return *this;
+    }
+
+    void swap(NodePtr& that) noexcept
+    {
+        std::swap(node_, that.node_);
+    }
+
+    const Node* get() const noexcept
+    {
+        return node_;
+    }
+
+    // Only valid while the node is not reachable from any other trie.
+    Node* mutableGet() noexcept
+    {
+        return node_;
+    }
+
+    const Node* operator->() const noexcept
+    {
+        return node_;
+    }
+
+private:
+    Node* node_;
+};
+
+}  // namespace detail
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_DETAIL_HAMT_HPP
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GUNGNIR_DETAIL_PROBE_HPP
+#define GUNGNIR_DETAIL_PROBE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace gungnir {
+
+namespace detail {
+
+// A transient open-addressing hash set of pointers to keys that outlive
+// it, used by the algorithms that test membership once per element. It
+// is sized once for the number of keys it will hold, at a load factor of
+// at most 1/2, and probes linearly; slots cache the hashes of their keys,
+// so that most mismatches are rejected without comparing keys.
+template<typename K, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+class ProbeSet final {
+public:
+    // Constructs an empty set that can hold up to `n` keys.
+    explicit ProbeSet(std::size_t n)
+        : bits_(bitsFor(n))
+        , slots_(std::size_t(1) << bits_)
+    {}
+
+    // Inserts `*k` unless an equal key is present, returning whether it
+    // did. At most `n` keys may be inserted.
+    bool insert(const K* k)
+    {
+        const auto h = Hash()(*k);
+        auto i = indexOf(h);
+        for (; slots_[i].key; i = (i + 1) & mask()) {
+            if (slots_[i].hash == h && Eq()(*slots_[i].key, *k)) {
+                return false;
+            }
+        }
+        slots_[i].hash = h;
+        slots_[i].key = k;
+        return true;
+    }
+
+    // Tests whether a key equal to `k` is present.
+    bool contains(const K& k) const
+    {
+        const auto h = Hash()(k);
+        for (auto i = indexOf(h); slots_[i].key; i = (i + 1) & mask()) {
+            if (slots_[i].hash == h && Eq()(*slots_[i].key, k)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The number of bytes taken by the slots.
+    std::size_t bytes() const
+    {
+        return slots_.size() * sizeof (Slot);
+    }
+
+private:
+    struct Slot {
+        std::size_t hash = 0;
+        const K* key = nullptr;
+    };
+
+    // The number of index bits for at least twice `n` slots, at least 8.
+    static unsigned bitsFor(std::size_t n)
+    {
+        unsigned bits = 3;
+        for (; (std::size_t(1) << bits) < 2 * n; ++bits) {}
+        return bits;
+    }
+
+    std::size_t mask() const
+    {
+        return slots_.size() - 1;
+    }
+
+    // Spreads `h` with Fibonacci hashing, so that hashes differing only in
+    // their high bits, which `std::hash` leaves as is for integers, do not
+    // pile up in the same slots.
+    std::size_t indexOf(std::size_t h) const
+    {
+        return static_cast<std::size_t>(
+            (static_cast<std::uint64_t>(h) * 0x9e3779b97f4a7c15) >> (64 - bits_));
+    }
+
+    unsigned bits_;
+    std::vector<Slot> slots_;
+};
+
+}  // namespace detail
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_DETAIL_PROBE_HPP
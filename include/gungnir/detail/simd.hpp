@@ -0,0 +1,654 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GUNGNIR_DETAIL_SIMD_HPP
+#define GUNGNIR_DETAIL_SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GUNGNIR_SIMD_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define GUNGNIR_SIMD_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define GUNGNIR_SIMD_NEON 1
+#endif
+
+namespace gungnir {
+
+namespace detail {
+
+// Kernels over contiguous runs of elements, used by the containers that
+// store their elements in arrays (`UnrolledList` and `Vector`).
+//
+// The generic versions are plain loops; `int`, `float` and `double` get
+// vectorized overloads when the target supports AVX2, SSE2 or AArch64 NEON
+// (selected at compile time). Vectorized floating-point sums and products
+// combine the elements in a different order than a left-to-right loop, so
+// they may differ from it in the last bits. Integer sums and products wrap
+// around on overflow.
+namespace simd {
+
+template<typename T>
+T sum(const T* p, std::size_t n)
+{
+    T acc = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        acc += p[i];
+    }
+    return acc;
+}
+
+template<typename T>
+T product(const T* p, std::size_t n)
+{
+    T acc = 1;
+    for (std::size_t i = 0; i < n; ++i) {
+        acc *= p[i];
+    }
+    return acc;
+}
+
+template<typename T>
+std::size_t count(const T* p, std::size_t n, const T& x)
+{
+    std::size_t num = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (p[i] == x) {
+            ++num;
+        }
+    }
+    return num;
+}
+
+template<typename T>
+bool contains(const T* p, std::size_t n, const T& x)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        if (p[i] == x) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#if defined(GUNGNIR_SIMD_AVX2)
+
+inline int sum(const int* p, std::size_t n)
+{
+    auto acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_add_epi32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+    }
+    alignas(32) std::uint32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    std::uint32_t s = 0;
+    for (auto l : lanes) {
+        s += l;
+    }
+    for (; i < n; ++i) {
+        s += static_cast<std::uint32_t>(p[i]);
+    }
+    return static_cast<int>(s);
+}
+
+inline float sum(const float* p, std::size_t n)
+{
+    auto acc = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_add_ps(acc, _mm256_loadu_ps(p + i));
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+    float s = 0;
+    for (auto l : lanes) {
+        s += l;
+    }
+    for (; i < n; ++i) {
+        s += p[i];
+    }
+    return s;
+}
+
+inline double sum(const double* p, std::size_t n)
+{
+    auto acc = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm256_add_pd(acc, _mm256_loadu_pd(p + i));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    double s = 0;
+    for (auto l : lanes) {
+        s += l;
+    }
+    for (; i < n; ++i) {
+        s += p[i];
+    }
+    return s;
+}
+
+inline int product(const int* p, std::size_t n)
+{
+    auto acc = _mm256_set1_epi32(1);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_mullo_epi32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+    }
+    alignas(32) std::uint32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    std::uint32_t s = 1;
+    for (auto l : lanes) {
+        s *= l;
+    }
+    for (; i < n; ++i) {
+        s *= static_cast<std::uint32_t>(p[i]);
+    }
+    return static_cast<int>(s);
+}
+
+inline float product(const float* p, std::size_t n)
+{
+    auto acc = _mm256_set1_ps(1);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_mul_ps(acc, _mm256_loadu_ps(p + i));
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+    float s = 1;
+    for (auto l : lanes) {
+        s *= l;
+    }
+    for (; i < n; ++i) {
+        s *= p[i];
+    }
+    return s;
+}
+
+inline double product(const double* p, std::size_t n)
+{
+    auto acc = _mm256_set1_pd(1);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm256_mul_pd(acc, _mm256_loadu_pd(p + i));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    double s = 1;
+    for (auto l : lanes) {
+        s *= l;
+    }
+    for (; i < n; ++i) {
+        s *= p[i];
+    }
+    return s;
+}
+
+// Adds up the lanes of a vector of 64-bit counters.
+inline std::size_t lanes64(__m256i acc)
+{
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return static_cast<std::size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+
+// Matching lanes of a comparison are all ones, i.e. -1, so subtracting the
+// comparison results counts the matches in each lane.
+inline std::size_t count(const int* p, std::size_t n, const int& x)
+{
+    const auto v = _mm256_set1_epi32(x);
+    auto acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_sub_epi32(acc, _mm256_cmpeq_epi32(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), v));
+    }
+    acc = _mm256_add_epi64(_mm256_and_si256(acc, _mm256_set1_epi64x(0xffffffff)),
+                           _mm256_srli_epi64(acc, 32));
+    return lanes64(acc) + simd::count<int>(p + i, n - i, x);
+}
+
+inline std::size_t count(const float* p, std::size_t n, const float& x)
+{
+    const auto v = _mm256_set1_ps(x);
+    auto acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_sub_epi32(acc, _mm256_castps_si256(
+                _mm256_cmp_ps(_mm256_loadu_ps(p + i), v, _CMP_EQ_OQ)));
+    }
+    acc = _mm256_add_epi64(_mm256_and_si256(acc, _mm256_set1_epi64x(0xffffffff)),
+                           _mm256_srli_epi64(acc, 32));
+    return lanes64(acc) + simd::count<float>(p + i, n - i, x);
+}
+
+inline std::size_t count(const double* p, std::size_t n, const double& x)
+{
+    const auto v = _mm256_set1_pd(x);
+    auto acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm256_sub_epi64(acc, _mm256_castpd_si256(
+                _mm256_cmp_pd(_mm256_loadu_pd(p + i), v, _CMP_EQ_OQ)));
+    }
+    return lanes64(acc) + simd::count<double>(p + i, n - i, x);
+}
+
+inline bool contains(const int* p, std::size_t n, const int& x)
+{
+    const auto v = _mm256_set1_epi32(x);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const auto eq = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), v);
+        if (!_mm256_testz_si256(eq, eq)) {
+            return true;
+        }
+    }
+    return simd::contains<int>(p + i, n - i, x);
+}
+
+inline bool contains(const float* p, std::size_t n, const float& x)
+{
+    const auto v = _mm256_set1_ps(x);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p + i), v, _CMP_EQ_OQ))) {
+            return true;
+        }
+    }
+    return simd::contains<float>(p + i, n - i, x);
+}
+
+inline bool contains(const double* p, std::size_t n, const double& x)
+{
+    const auto v = _mm256_set1_pd(x);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(p + i), v, _CMP_EQ_OQ))) {
+            return true;
+        }
+    }
+    return simd::contains<double>(p + i, n - i, x);
+}
+
+#elif defined(GUNGNIR_SIMD_SSE2)
+
+inline int sum(const int* p, std::size_t n)
+{
+    auto acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_add_epi32(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+    }
+    alignas(16) std::uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    std::uint32_t s = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) {
+        s += static_cast<std::uint32_t>(p[i]);
+    }
+    return static_cast<int>(s);
+}
+
+inline float sum(const float* p, std::size_t n)
+{
+    auto acc = _mm_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_add_ps(acc, _mm_loadu_ps(p + i));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, acc);
+    float s = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) {
+        s += p[i];
+    }
+    return s;
+}
+
+inline double sum(const double* p, std::size_t n)
+{
+    auto acc = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        acc = _mm_add_pd(acc, _mm_loadu_pd(p + i));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, acc);
+    double s = lanes[0] + lanes[1];
+    for (; i < n; ++i) {
+        s += p[i];
+    }
+    return s;
+}
+
+// SSE2 has no multiplication keeping the low halves of 32-bit lanes, so
+// the even and odd lanes are multiplied into 64-bit products separately and
+// the low halves of those are interleaved back.
+inline __m128i mullo32(__m128i a, __m128i b)
+{
+    const auto even = _mm_mul_epu32(a, b);
+    const auto odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+inline int product(const int* p, std::size_t n)
+{
+    auto acc = _mm_set1_epi32(1);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = mullo32(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+    }
+    alignas(16) std::uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    std::uint32_t s = lanes[0] * lanes[1] * lanes[2] * lanes[3];
+    for (; i < n; ++i) {
+        s *= static_cast<std::uint32_t>(p[i]);
+    }
+    return static_cast<int>(s);
+}
+
+inline float product(const float* p, std::size_t n)
+{
+    auto acc = _mm_set1_ps(1);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_mul_ps(acc, _mm_loadu_ps(p + i));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, acc);
+    float s = lanes[0] * lanes[1] * lanes[2] * lanes[3];
+    for (; i < n; ++i) {
+        s *= p[i];
+    }
+    return s;
+}
+
+inline double product(const double* p, std::size_t n)
+{
+    auto acc = _mm_set1_pd(1);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        acc = _mm_mul_pd(acc, _mm_loadu_pd(p + i));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, acc);
+    double s = lanes[0] * lanes[1];
+    for (; i < n; ++i) {
+        s *= p[i];
+    }
+    return s;
+}
+
+// Adds up the lanes of a vector of 32-bit counters.
+inline std::size_t lanes32(__m128i acc)
+{
+    alignas(16) std::uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return std::size_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+}
+
+// Matching lanes of a comparison are all ones, i.e. -1, so subtracting the
+// comparison results counts the matches in each lane.
+inline std::size_t count(const int* p, std::size_t n, const int& x)
+{
+    const auto v = _mm_set1_epi32(x);
+    auto acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_sub_epi32(acc, _mm_cmpeq_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), v));
+    }
+    return lanes32(acc) + simd::count<int>(p + i, n - i, x);
+}
+
+inline std::size_t count(const float* p, std::size_t n, const float& x)
+{
+    const auto v = _mm_set1_ps(x);
+    auto acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_sub_epi32(acc, _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(p + i), v)));
+    }
+    return lanes32(acc) + simd::count<float>(p + i, n - i, x);
+}
+
+inline std::size_t count(const double* p, std::size_t n, const double& x)
+{
+    const auto v = _mm_set1_pd(x);
+    auto acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        acc = _mm_sub_epi64(acc, _mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(p + i), v)));
+    }
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return static_cast<std::size_t>(lanes[0] + lanes[1]) + simd::count<double>(p + i, n - i, x);
+}
+
+inline bool contains(const int* p, std::size_t n, const int& x)
+{
+    const auto v = _mm_set1_epi32(x);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const auto eq = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), v);
+        if (_mm_movemask_epi8(eq)) {
+            return true;
+        }
+    }
+    return simd::contains<int>(p + i, n - i, x);
+}
+
+inline bool contains(const float* p, std::size_t n, const float& x)
+{
+    const auto v = _mm_set1_ps(x);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        if (_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(p + i), v))) {
+            return true;
+        }
+    }
+    return simd::contains<float>(p + i, n - i, x);
+}
+
+inline bool contains(const double* p, std::size_t n, const double& x)
+{
+    const auto v = _mm_set1_pd(x);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        if (_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(p + i), v))) {
+            return true;
+        }
+    }
+    return simd::contains<double>(p + i, n - i, x);
+}
+
+#elif defined(GUNGNIR_SIMD_NEON)
+
+inline int sum(const int* p, std::size_t n)
+{
+    auto acc = vdupq_n_u32(0);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = vaddq_u32(acc, vreinterpretq_u32_s32(vld1q_s32(p + i)));
+    }
+    auto s = vaddvq_u32(acc);
+    for (; i < n; ++i) {
+        s += static_cast<std::uint32_t>(p[i]);
+    }
+    return static_cast<int>(s);
+}
+
+inline float sum(const float* p, std::size_t n)
+{
+    auto acc = vdupq_n_f32(0);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = vaddq_f32(acc, vld1q_f32(p + i));
+    }
+    auto s = vaddvq_f32(acc);
+    for (; i < n; ++i) {
+        s += p[i];
+    }
+    return s;
+}
+
+inline double sum(const double* p, std::size_t n)
+{
+    auto acc = vdupq_n_f64(0);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        acc = vaddq_f64(acc, vld1q_f64(p + i));
+    }
+    auto s = vaddvq_f64(acc);
+    for (; i < n; ++i) {
+        s += p[i];
+    }
+    return s;
+}
+
+inline int product(const int* p, std::size_t n)
+{
+    auto acc = vdupq_n_u32(1);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = vmulq_u32(acc, vreinterpretq_u32_s32(vld1q_s32(p + i)));
+    }
+    auto s = vgetq_lane_u32(acc, 0) * vgetq_lane_u32(acc, 1) *
+             vgetq_lane_u32(acc, 2) * vgetq_lane_u32(acc, 3);
+    for (; i < n; ++i) {
+        s *= static_cast<std::uint32_t>(p[i]);
+    }
+    return static_cast<int>(s);
+}
+
+inline float product(const float* p, std::size_t n)
+{
+    auto acc = vdupq_n_f32(1);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = vmulq_f32(acc, vld1q_f32(p + i));
+    }
+    auto s = vgetq_lane_f32(acc, 0) * vgetq_lane_f32(acc, 1) *
+             vgetq_lane_f32(acc, 2) * vgetq_lane_f32(acc, 3);
+    for (; i < n; ++i) {
+        s *= p[i];
+    }
+    return s;
+}
+
+inline double product(const double* p, std::size_t n)
+{
+    auto acc = vdupq_n_f64(1);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        acc = vmulq_f64(acc, vld1q_f64(p + i));
+    }
+    auto s = vgetq_lane_f64(acc, 0) * vgetq_lane_f64(acc, 1);
+    for (; i < n; ++i) {
+        s *= p[i];
+    }
+    return s;
+}
+
+inline std::size_t count(const int* p, std::size_t n, const int& x)
+{
+    const auto v = vdupq_n_s32(x);
+    auto acc = vdupq_n_u32(0);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        // Matching lanes of a comparison are all ones, i.e. -1.
+        acc = vsubq_u32(acc, vceqq_s32(vld1q_s32(p + i), v));
+    }
+    return vaddvq_u32(acc) + simd::count<int>(p + i, n - i, x);
+}
+
+inline std::size_t count(const float* p, std::size_t n, const float& x)
+{
+    const auto v = vdupq_n_f32(x);
+    auto acc = vdupq_n_u32(0);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = vsubq_u32(acc, vceqq_f32(vld1q_f32(p + i), v));
+    }
+    return vaddvq_u32(acc) + simd::count<float>(p + i, n - i, x);
+}
+
+inline std::size_t count(const double* p, std::size_t n, const double& x)
+{
+    const auto v = vdupq_n_f64(x);
+    auto acc = vdupq_n_u64(0);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        acc = vsubq_u64(acc, vceqq_f64(vld1q_f64(p + i), v));
+    }
+    return vaddvq_u64(acc) + simd::count<double>(p + i, n - i, x);
+}
+
+inline bool contains(const int* p, std::size_t n, const int& x)
+{
+    const auto v = vdupq_n_s32(x);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        if (vmaxvq_u32(vceqq_s32(vld1q_s32(p + i), v))) {
+            return true;
+        }
+    }
+    return simd::contains<int>(p + i, n - i, x);
+}
+
+inline bool contains(const float* p, std::size_t n, const float& x)
+{
+    const auto v = vdupq_n_f32(x);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        if (vmaxvq_u32(vceqq_f32(vld1q_f32(p + i), v))) {
+            return true;
+        }
+    }
+    return simd::contains<float>(p + i, n - i, x);
+}
+
+inline bool contains(const double* p, std::size_t n, const double& x)
+{
+    const auto v = vdupq_n_f64(x);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const auto eq = vceqq_f64(vld1q_f64(p + i), v);
+        if (vgetq_lane_u64(eq, 0) | vgetq_lane_u64(eq, 1)) {
+            return true;
+        }
+    }
+    return simd::contains<double>(p + i, n - i, x);
+}
+
+#endif
+
+}  // namespace simd
+
+}  // namespace detail
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_DETAIL_SIMD_HPP
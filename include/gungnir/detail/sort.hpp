@@ -0,0 +1,133 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GUNGNIR_DETAIL_SORT_HPP
+#define GUNGNIR_DETAIL_SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gungnir/Executor.hpp"
+
+namespace gungnir {
+
+namespace detail {
+
+// Sorting building blocks shared by the `sorted*()` algorithms.
+//
+// Keyed sorts work on contiguous `(key, value)` pairs, so that comparisons
+// read cached keys instead of chasing pointers to the elements.
+namespace sort {
+
+// Whether keys of type `K` are sorted by `radix()`.
+template<typename K>
+using IsRadixKey = std::integral_constant<bool,
+    std::is_integral<K>::value && !std::is_same<K, bool>::value
+>;
+
+// Below this size, `radix()` falls back to a comparison sort.
+constexpr std::size_t radixThreshold = 256;
+
+// Stably sorts `xs` by key with a least significant digit first radix sort
+// on bytes, skipping the passes in which all keys share the same digit.
+template<typename K, typename V>
+void radix(std::vector<std::pair<K, V>>& xs)
+{
+    using U = typename std::make_unsigned<K>::type;
+    constexpr std::size_t digits = sizeof (K);
+    // Flipping the sign bit orders signed keys as unsigned ones.
+    const U flip = std::is_signed<K>::value ? static_cast<U>(U(1) << (8 * digits - 1)) : U(0);
+    const auto digit = [flip](K key, std::size_t d) {
+        return static_cast<std::size_t>((static_cast<U>(static_cast<U>(key) ^ flip) >> (8 * d)) & 0xFF);
+    };
+
+    std::vector<std::size_t> counts(digits * 256);
+    for (const auto& x : xs) {
+        for (std::size_t d = 0; d < digits; ++d) {
+            ++counts[d * 256 + digit(x.first, d)];
+        }
+    }
+
+    std::vector<std::pair<K, V>> buf(xs.size());
+    for (std::size_t d = 0; d < digits; ++d) {
+        const auto count = &counts[d * 256];
+        if (count[digit(xs.front().first, d)] == xs.size()) {
+            continue;
+        }
+
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i < 256; ++i) {
+            const auto c = count[i];
+            count[i] = offset;
+            offset += c;
+        }
+        for (auto& x : xs) {
+            buf[count[digit(x.first, d)]++] = std::move(x);
+        }
+        xs.swap(buf);
+    }
+}
+
+// Stably sorts `xs` by key.
+template<typename K, typename V>
+typename std::enable_if<IsRadixKey<K>::value>::type
+byKey(std::vector<std::pair<K, V>>& xs)
+{
+    if (xs.size() >= radixThreshold) {
+        radix(xs);
+    } else {
+        std::stable_sort(xs.begin(), xs.end(), [](const std::pair<K, V>& x, const std::pair<K, V>& y) {
+            return x.first < y.first;
+        });
+    }
+}
+
+template<typename K, typename V>
+typename std::enable_if<!IsRadixKey<K>::value>::type
+byKey(std::vector<std::pair<K, V>>& xs)
+{
+    std::stable_sort(xs.begin(), xs.end(), [](const std::pair<K, V>& x, const std::pair<K, V>& y) {
+        return x.first < y.first;
+    });
+}
+
+// Merges the `k` consecutive sorted runs `[first + bound(i), first +
+// bound(i + 1))` into one, stably, with the merges of each round of
+// pairwise merging running in parallel on `executor`.
+template<typename It, typename Bound, typename Comp>
+void mergeRuns(Executor& executor, It first, std::size_t k, Bound bound, Comp comp)
+{
+    for (std::size_t width = 1; width < k; width *= 2) {
+        executor.parallelFor((k + 2 * width - 1) / (2 * width), [&](std::size_t i) {
+            const auto lo = 2 * width * i;
+            const auto mid = std::min(lo + width, k);
+            const auto hi = std::min(lo + 2 * width, k);
+            std::inplace_merge(first + bound(lo), first + bound(mid), first + bound(hi), comp);
+        });
+    }
+}
+
+}  // namespace sort
+
+}  // namespace detail
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_DETAIL_SORT_HPP
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GUNGNIR_DETAIL_TRACE_HPP
+#define GUNGNIR_DETAIL_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef GUNGNIR_LIST_TRACE
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif
+
+// The number of events kept per thread by the tracing of `GUNGNIR_LIST_TRACE`;
+// must be a power of two.
+#ifndef GUNGNIR_LIST_TRACE_CAPACITY
+#define GUNGNIR_LIST_TRACE_CAPACITY 4096
+#endif
+
+namespace gungnir {
+
+namespace detail {
+
+namespace trace {
+
+#ifdef GUNGNIR_LIST_TRACE
+
+static_assert((GUNGNIR_LIST_TRACE_CAPACITY & (GUNGNIR_LIST_TRACE_CAPACITY - 1)) == 0,
+              "GUNGNIR_LIST_TRACE_CAPACITY must be a power of two");
+
+// A recorded event; see `ListTraceEvent`.
+struct Event {
+    const char* name;
+    std::size_t inputSize;
+    std::size_t outputSize;
+    std::uint64_t start;
+    std::uint64_t duration;
+    std::uint32_t thread;
+};
+
+inline std::uint64_t now() noexcept
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// The last `GUNGNIR_LIST_TRACE_CAPACITY` events of a thread. Only that
+// thread records events, without locking; any thread may copy them out.
+// Each slot is a seqlock: its sequence number is odd while the slot is
+// being written, and `2 * (i + 1)` once it holds the `i`th event, so that
+// readers can tell a consistent slot from one being overwritten. The fields
+// are written with release and read with acquire, rather than fenced, so
+// that a reader seeing any field of a newer event also sees its odd
+// sequence number when checking it again; on x86 this costs nothing.
+class Ring final {
+public:
+    explicit Ring(std::uint32_t thread) : thread_(thread) {}
+
+    void record(const char* name, std::size_t in, std::size_t out,
+                std::uint64_t start, std::uint64_t duration) noexcept
+    {
+        const auto i = head_.load(std::memory_order_relaxed);
+        auto& s = slots_[i & mask];
+        s.seq.store(2 * i + 1, std::memory_order_relaxed);
+        s.name.store(name, std::memory_order_release);
+        s.inputSize.store(in, std::memory_order_release);
+        s.outputSize.store(out, std::memory_order_release);
+        s.start.store(start, std::memory_order_release);
+        s.duration.store(duration, std::memory_order_release);
+        s.seq.store(2 * (i + 1), std::memory_order_release);
+        head_.store(i + 1, std::memory_order_release);
+    }
+
+    // Appends the events recorded since the last `clear()` that have not
+    // been overwritten since.
+    void copyTo(std::vector<Event>& events) const
+    {
+        const auto head = head_.load(std::memory_order_acquire);
+        auto i = floor_.load(std::memory_order_relaxed);
+        if (head - i > capacity) {
+            i = head - capacity;
+        }
+        for (; i < head; ++i) {
+            const auto& s = slots_[i & mask];
+            const auto seq = s.seq.load(std::memory_order_acquire);
+            if (seq != 2 * (i + 1)) {
+                continue;
+            }
+            const Event e = {
+                s.name.load(std::memory_order_acquire),
+                s.inputSize.load(std::memory_order_acquire),
+                s.outputSize.load(std::memory_order_acquire),
+                s.start.load(std::memory_order_acquire),
+                s.duration.load(std::memory_order_acquire),
+                thread_
+            };
+            if (s.seq.load(std::memory_order_relaxed) == seq) {
+                events.push_back(e);
+            }
+        }
+    }
+
+    // Hides the events recorded so far from `copyTo()`.
+    void clear() noexcept
+    {
+        floor_.store(head_.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::uint64_t capacity = GUNGNIR_LIST_TRACE_CAPACITY;
+    static constexpr std::uint64_t mask = capacity - 1;
+
+    struct Slot {
+        std::atomic<std::uint64_t> seq { 0 };
+        std::atomic<const char*> name { nullptr };
+        std::atomic<std::size_t> inputSize { 0 };
+        std::atomic<std::size_t> outputSize { 0 };
+        std::atomic<std::uint64_t> start { 0 };
+        std::atomic<std::uint64_t> duration { 0 };
+    };
+
+    const std::uint32_t thread_;
+    std::atomic<std::uint64_t> head_ { 0 };
+    std::atomic<std::uint64_t> floor_ { 0 };
+    Slot slots_[GUNGNIR_LIST_TRACE_CAPACITY];
+};
+
+// The rings of all threads that have recorded events, including exited
+// ones, whose events are kept until the trace is reset.
+class Registry final {
+public:
+    std::shared_ptr<Ring> add()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.push_back(std::make_shared<Ring>(nextThread_++));
+        return rings_.back();
+    }
+
+    std::vector<Event> events() const
+    {
+        std::vector<Event> events;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& r : rings_) {
+            r->copyTo(events);
+        }
+        return events;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::shared_ptr<Ring>> live;
+        for (auto& r : rings_) {
+            if (r.use_count() > 1) {
+                r->clear();
+                live.push_back(std::move(r));
+            }
+        }
+        rings_.swap(live);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::uint32_t nextThread_ = 0;
+};
+
+inline Registry& registry()
+{
+    static Registry r;
+    return r;
+}
+
+inline Ring& ring()
+{
+    static thread_local const std::shared_ptr<Ring> r = registry().add();
+    return *r;
+}
+
+// Times a list operation from its construction until `done()`, recording it
+// in the ring of the calling thread. Operations that throw are not recorded.
+class Scope final {
+public:
+    Scope(const char* name, std::size_t inputSize) noexcept
+        : name_(name), inputSize_(inputSize), start_(now())
+    {}
+
+    void done(std::size_t outputSize)
+    {
+        const auto end = now();
+        ring().record(name_, inputSize_, outputSize, start_, end - start_);
+    }
+
+private:
+    const char* const name_;
+    const std::size_t inputSize_;
+    const std::uint64_t start_;
+};
+
+#else
+
+class Scope final {
+public:
+    Scope(const char*, std::size_t) noexcept {}
+
+    void done(std::size_t) noexcept {}
+};
+
+#endif  // GUNGNIR_LIST_TRACE
+
+}  // namespace trace
+
+}  // namespace detail
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_DETAIL_TRACE_HPP
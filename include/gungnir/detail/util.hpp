@@ -17,6 +17,7 @@
 #ifndef GUNGNIR_DETAIL_UTIL_HPP
 #define GUNGNIR_DETAIL_UTIL_HPP
 
+#include <memory>
 #include <type_traits>
 
 namespace gungnir {
@@ -58,6 +59,35 @@ struct BoolPack;
 template<bool... V>
 using AllTrue = std::is_same<BoolPack<true, V...>, BoolPack<V..., true>>;
 
+// Convenience alias for `std::allocator_traits<Alloc>::rebind_alloc<T>`.
+template<typename Alloc, typename T>
+using Rebind = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+// Holds a value of type `T`, taking up no space if `T` is a stateless
+// (empty and default constructible) class. Used as a base class so that
+// the empty base optimization applies.
+template<
+    typename T,
+    bool = std::is_empty<T>::value && std::is_default_constructible<T>::value
+>
+class Compressed {
+public:
+    explicit Compressed(const T&) noexcept {}
+
+    T get() const { return T(); }
+};
+
+template<typename T>
+class Compressed<T, false> {
+public:
+    explicit Compressed(const T& x) : x_(x) {}
+
+    const T& get() const { return x_; }
+
+private:
+    T x_;
+};
+
 template<std::size_t...>
 struct Seq {};
 
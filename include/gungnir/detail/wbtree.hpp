@@ -0,0 +1,669 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GUNGNIR_DETAIL_WBTREE_HPP
+#define GUNGNIR_DETAIL_WBTREE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+namespace detail {
+
+// Parameters of `WeightTree`, the weight-balanced tree behind `TreeMap`
+// and `TreeSet`. The weight of a subtree is its size plus one; neither
+// child of a node may weigh more than `delta` times its sibling, and a
+// rebalancing rotation is double when the inner grandchild weighs at
+// least `gamma` times the outer one. (3, 2) is the only integral pair
+// for which insertion and deletion provably keep the tree balanced.
+namespace wbtree {
+
+constexpr std::size_t delta = 3;
+constexpr std::size_t gamma = 2;
+
+}  // namespace wbtree
+
+/*
+ * A persistent search tree of entries of type `E`, ordered by `Cmp` on
+ * their keys `KeyOf()(e)`, all distinct.
+ *
+ * Each node records the size of its subtree, which keeps the tree balanced
+ * by weight and makes joining two trees around an entry take time
+ * proportional to the difference of their heights. Lookups, updates and
+ * cutting the tree at a key take O(log n) steps; updates copy the path to
+ * the change and share everything else, so nodes are never modified once
+ * built.
+ */
+template<typename E, typename KeyOf, typename Cmp, typename Alloc>
+class WeightTree final : private Compressed<Alloc> {
+public:
+    using Key = Decay<Ret<KeyOf, const E&>>;
+
+    explicit WeightTree(const Alloc& alloc) noexcept : Compressed<Alloc>(alloc) {}
+
+    WeightTree(const WeightTree&) = default;
+
+    WeightTree(WeightTree&& that) noexcept
+        : Compressed<Alloc>(that)
+        , root_(std::move(that.root_))
+    {}
+
+    WeightTree& operator=(const WeightTree&) = default;
+
+    WeightTree& operator=(WeightTree&& that) noexcept
+    {
+        WeightTree(std::move(that)).swap(*this);
+        return *this;
+    }
+
+    Alloc allocator() const
+    {
+        return this->get();
+    }
+
+    std::size_t size() const
+    {
+        return sizeOf(root_.get());
+    }
+
+    // Returns the entry with key `k`, or a null pointer if there is none.
+    const E* find(const Key& k) const
+    {
+        for (auto n = root_.get(); n; ) {
+            if (Cmp()(k, KeyOf()(n->entry))) {
+                n = n->left.get();
+            } else if (Cmp()(KeyOf()(n->entry), k)) {
+                n = n->right.get();
+            } else {
+                return &n->entry;
+            }
+        }
+        return nullptr;
+    }
+
+    // Returns the entry with the least key, or a null pointer if empty.
+    const E* min() const
+    {
+        auto n = root_.get();
+        if (!n) {
+            return nullptr;
+        }
+        while (n->left.get()) {
+            n = n->left.get();
+        }
+        return &n->entry;
+    }
+
+    // Returns the entry with the greatest key, or a null pointer if empty.
+    const E* max() const
+    {
+        auto n = root_.get();
+        if (!n) {
+            return nullptr;
+        }
+        while (n->right.get()) {
+            n = n->right.get();
+        }
+        return &n->entry;
+    }
+
+    // Inserts `e`, replacing the entry with the same key if any.
+    void insert(E e)
+    {
+        root_ = insert(root_, e);
+    }
+
+    // Removes the entry with key `k`, if any, and returns whether there
+    // was one.
+    bool erase(const Key& k)
+    {
+        // Checking first spares copying the path to a missing key.
+        if (!find(k)) {
+            return false;
+        }
+        root_ = erase(root_, k);
+        return true;
+    }
+
+    // Drops the entries whose keys are less than `*lo`, unless `lo` is null,
+    // and those whose keys are not less than `*hi`, unless `hi` is null.
+    void restrict(const Key* lo, const Key* hi)
+    {
+        if (lo) {
+            root_ = dropLess(root_, *lo);
+        }
+        if (hi) {
+            root_ = takeLess(root_, *hi);
+        }
+    }
+
+    // Replaces the entries of this tree with those in [`first`, `last`),
+    // which must be sorted by key, in O(n) time. Of entries with equal keys,
+    // the last one is kept.
+    template<typename ForwardIt>
+    void assignSorted(ForwardIt first, ForwardIt last)
+    {
+        using B = Decay<decltype(*first)>;
+        std::vector<const B*> xs;
+        for (; first != last; ++first) {
+            const B& x = *first;
+            if (!xs.empty()) {
+                if (Cmp()(KeyOf()(x), KeyOf()(*xs.back()))) {
+                    throw std::invalid_argument("entries are not sorted");
+                } else if (!Cmp()(KeyOf()(*xs.back()), KeyOf()(x))) {
+                    xs.back() = &x;
+                    continue;
+                }
+            }
+            xs.push_back(&x);
+        }
+        root_ = build(xs.data(), xs.size());
+    }
+
+    // Calls `f` with each entry in ascending order of keys, stopping as
+    // soon as it returns `false`, and returns whether it never did.
+    template<typename Fn>
+    bool foreachWhile(Fn f) const
+    {
+        return foreachWhile(root_.get(), f);
+    }
+
+    // Returns a tree of the results of `f`, which must have the same keys
+    // as the entries it is applied to, so that the shape is kept as is.
+    template<typename Tree, typename Fn>
+    Tree mapEntries(Fn f) const
+    {
+        using BAlloc = Decay<decltype(std::declval<Tree>().allocator())>;
+        Tree t{BAlloc(allocator())};
+        t.root_ = mapNode<Tree>(t, root_.get(), f);
+        return t;
+    }
+
+    // Returns a tree of the entries satisfying `p`, sharing the subtrees
+    // all of whose entries do.
+    template<typename Fn>
+    WeightTree filter(Fn p) const
+    {
+        WeightTree t(allocator());
+        t.root_ = filterNode(root_, p);
+        return t;
+    }
+
+    // Tests whether this tree and `that` have equal entries, in the same
+    // order, according to `eq`.
+    template<typename Fn>
+    bool equals(const WeightTree& that, Fn eq) const
+    {
+        if (size() != that.size()) {
+            return false;
+        } else if (same(that)) {
+            return true;
+        }
+        Cursor c(that.root_.get());
+        return foreachWhile([&c, &eq](const E& e) {
+            return eq(e, c.next());
+        });
+    }
+
+    // Tests whether this tree and `that` are the same one, so that they are
+    // trivially equal.
+    bool same(const WeightTree& that) const
+    {
+        return root_.get() == that.root_.get();
+    }
+
+    void swap(WeightTree& that) noexcept
+    {
+        using std::swap;
+        swap(static_cast<Compressed<Alloc>&>(*this),
+             static_cast<Compressed<Alloc>&>(that));
+        root_.swap(that.root_);
+    }
+
+    // Tests the ordering, sizes and balance of every node; for the tests.
+    bool isValid() const
+    {
+        const Key* prev = nullptr;
+        return isValid(root_.get(), prev);
+    }
+
+private:
+    template<typename, typename, typename, typename>
+    friend class WeightTree;
+
+    class Node;
+    class NodePtr;
+    class Cursor;
+
+    static std::size_t sizeOf(const Node* n)
+    {
+        return n ? n->size : 0;
+    }
+
+    static bool balanced(std::size_t a, std::size_t b)
+    {
+        return wbtree::delta * (a + 1) >= b + 1;
+    }
+
+    template<typename X>
+    NodePtr make(NodePtr l, X&& e, NodePtr r) const
+    {
+        return Node::create(allocator(), std::move(l), std::forward<X>(e), std::move(r));
+    }
+
+    // Builds a node from children that were balanced before one of them
+    // gained or lost an entry, or before they were joined, rotating once
+    // if the node would be out of balance.
+    template<typename X>
+    NodePtr balance(NodePtr l, X&& e, NodePtr r) const
+    {
+        const auto sl = sizeOf(l.get());
+        const auto sr = sizeOf(r.get());
+        if (!balanced(sl, sr)) {
+            const Node* n = r.get();
+            if (sizeOf(n->left.get()) + 1 < wbtree::gamma * (sizeOf(n->right.get()) + 1)) {
+                return make(make(std::move(l), std::forward<X>(e), n->left), n->entry, n->right);
+            }
+            const Node* m = n->left.get();
+            return make(make(std::move(l), std::forward<X>(e), m->left),
+                        m->entry,
+                        make(m->right, n->entry, n->right));
+        } else if (!balanced(sr, sl)) {
+            const Node* n = l.get();
+            if (sizeOf(n->right.get()) + 1 < wbtree::gamma * (sizeOf(n->left.get()) + 1)) {
+                return make(n->left, n->entry, make(n->right, std::forward<X>(e), std::move(r)));
+            }
+            const Node* m = n->right.get();
+            return make(make(n->left, n->entry, m->left),
+                        m->entry,
+                        make(m->right, std::forward<X>(e), std::move(r)));
+        }
+        return make(std::move(l), std::forward<X>(e), std::move(r));
+    }
+
+    NodePtr insert(const NodePtr& t, E& e) const
+    {
+        const Node* n = t.get();
+        if (!n) {
+            return make(NodePtr(), std::move(e), NodePtr());
+        } else if (Cmp()(KeyOf()(e), KeyOf()(n->entry))) {
+            return balance(insert(n->left, e), n->entry, n->right);
+        } else if (Cmp()(KeyOf()(n->entry), KeyOf()(e))) {
+            return balance(n->left, n->entry, insert(n->right, e));
+        }
+        return make(n->left, std::move(e), n->right);
+    }
+
+    // Removes the entry with key `k`, which must be in `t`.
+    NodePtr erase(const NodePtr& t, const Key& k) const
+    {
+        const Node* n = t.get();
+        if (Cmp()(k, KeyOf()(n->entry))) {
+            return balance(erase(n->left, k), n->entry, n->right);
+        } else if (Cmp()(KeyOf()(n->entry), k)) {
+            return balance(n->left, n->entry, erase(n->right, k));
+        }
+        return glue(n->left, n->right);
+    }
+
+    // Joins the balanced children of a removed node, lifting the entry
+    // next to it out of the heavier one.
+    NodePtr glue(const NodePtr& l, const NodePtr& r) const
+    {
+        if (!l.get()) {
+            return r;
+        } else if (!r.get()) {
+            return l;
+        }
+        const E* e;
+        if (l->size > r->size) {
+            auto rest = eraseMax(l, e);
+            return balance(std::move(rest), *e, r);
+        }
+        auto rest = eraseMin(r, e);
+        return balance(l, *e, std::move(rest));
+    }
+
+    // Removes the greatest entry of the nonempty `t`, pointing `e` at it;
+    // it stays alive as long as `t` does.
+    NodePtr eraseMax(const NodePtr& t, const E*& e) const
+    {
+        const Node* n = t.get();
+        if (!n->right.get()) {
+            e = &n->entry;
+            return n->left;
+        }
+        return balance(n->left, n->entry, eraseMax(n->right, e));
+    }
+
+    NodePtr eraseMin(const NodePtr& t, const E*& e) const
+    {
+        const Node* n = t.get();
+        if (!n->left.get()) {
+            e = &n->entry;
+            return n->right;
+        }
+        return balance(eraseMin(n->left, e), n->entry, n->right);
+    }
+
+    NodePtr insertMin(const E& e, const NodePtr& t) const
+    {
+        const Node* n = t.get();
+        if (!n) {
+            return make(NodePtr(), e, NodePtr());
+        }
+        return balance(insertMin(e, n->left), n->entry, n->right);
+    }
+
+    NodePtr insertMax(const E& e, const NodePtr& t) const
+    {
+        const Node* n = t.get();
+        if (!n) {
+            return make(NodePtr(), e, NodePtr());
+        }
+        return balance(n->left, n->entry, insertMax(e, n->right));
+    }
+
+    // Joins `l`, `e` and `r`, whose keys are in ascending order, descending
+    // the heavier tree to a subtree of comparable weight.
+    NodePtr link(const NodePtr& l, const E& e, const NodePtr& r) const
+    {
+        if (!l.get()) {
+            return insertMin(e, r);
+        } else if (!r.get()) {
+            return insertMax(e, l);
+        } else if (!balanced(l->size, r->size)) {
+            return balance(link(l, e, r->left), r->entry, r->right);
+        } else if (!balanced(r->size, l->size)) {
+            return balance(l->left, l->entry, link(l->right, e, r));
+        }
+        return make(l, e, r);
+    }
+
+    // Joins `l` and `r`, whose keys are in ascending order.
+    NodePtr merge(const NodePtr& l, const NodePtr& r) const
+    {
+        if (!l.get()) {
+            return r;
+        } else if (!r.get()) {
+            return l;
+        } else if (!balanced(l->size, r->size)) {
+            return balance(merge(l, r->left), r->entry, r->right);
+        } else if (!balanced(r->size, l->size)) {
+            return balance(l->left, l->entry, merge(l->right, r));
+        }
+        return glue(l, r);
+    }
+
+    // Returns the entries of `t` whose keys are not less than `lo`.
+    NodePtr dropLess(const NodePtr& t, const Key& lo) const
+    {
+        const Node* n = t.get();
+        if (!n) {
+            return t;
+        } else if (Cmp()(KeyOf()(n->entry), lo)) {
+            return dropLess(n->right, lo);
+        } else if (Cmp()(lo, KeyOf()(n->entry))) {
+            return link(dropLess(n->left, lo), n->entry, n->right);
+        }
+        return insertMin(n->entry, n->right);
+    }
+
+    // Returns the entries of `t` whose keys are less than `hi`.
+    NodePtr takeLess(const NodePtr& t, const Key& hi) const
+    {
+        const Node* n = t.get();
+        if (!n) {
+            return t;
+        } else if (Cmp()(KeyOf()(n->entry), hi)) {
+            return link(n->left, n->entry, takeLess(n->right, hi));
+        }
+        return takeLess(n->left, hi);
+    }
+
+    // Builds a perfectly balanced tree of the `n` entries `*xs[i]`.
+    template<typename B>
+    NodePtr build(const B* const* xs, std::size_t n) const
+    {
+        if (n == 0) {
+            return NodePtr();
+        }
+        const auto m = n / 2;
+        auto l = build(xs, m);
+        auto r = build(xs + m + 1, n - m - 1);
+        return make(std::move(l), *xs[m], std::move(r));
+    }
+
+    template<typename Fn>
+    static bool foreachWhile(const Node* n, Fn& f)
+    {
+        for (; n; n = n->right.get()) {
+            if (!foreachWhile(n->left.get(), f) || !f(n->entry)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename Tree, typename Fn>
+    static typename Tree::NodePtr mapNode(const Tree& t, const Node* n, Fn& f)
+    {
+        if (!n) {
+            return typename Tree::NodePtr();
+        }
+        auto l = mapNode(t, n->left.get(), f);
+        auto e = f(n->entry);
+        auto r = mapNode(t, n->right.get(), f);
+        return t.make(std::move(l), std::move(e), std::move(r));
+    }
+
+    template<typename Fn>
+    NodePtr filterNode(const NodePtr& t, Fn& p) const
+    {
+        const Node* n = t.get();
+        if (!n) {
+            return t;
+        }
+        auto l = filterNode(n->left, p);
+        const bool keep = p(n->entry);
+        auto r = filterNode(n->right, p);
+        if (!keep) {
+            return merge(l, r);
+        } else if (l.get() == n->left.get() && r.get() == n->right.get()) {
+            return t;
+        }
+        return link(l, n->entry, r);
+    }
+
+    bool isValid(const Node* n, const Key*& prev) const
+    {
+        if (!n) {
+            return true;
+        }
+        const auto sl = sizeOf(n->left.get());
+        const auto sr = sizeOf(n->right.get());
+        if (n->size != sl + sr + 1 || !balanced(sl, sr) || !balanced(sr, sl)
+                || !isValid(n->left.get(), prev)
+                || (prev && !Cmp()(*prev, KeyOf()(n->entry)))) {
+            return false;
+        }
+        prev = &KeyOf()(n->entry);
+        return isValid(n->right.get(), prev);
+    }
+
+    NodePtr root_;
+};
+
+template<typename E, typename KeyOf, typename Cmp, typename Alloc>
+class WeightTree<E, KeyOf, Cmp, Alloc>::NodePtr final {
+public:
+    NodePtr() noexcept : node_(nullptr) {}
+
+    explicit NodePtr(const Node* node) noexcept : node_(node) {}
+
+    NodePtr(const NodePtr& that) noexcept : node_(that.node_)
+    {
+        if (node_) {
+            Node::retain(node_);
+        }
+    }
+
+    NodePtr(NodePtr&& that) noexcept : node_(that.node_)
+    {
+        that.node_ = nullptr;
+    }
+
+    ~NodePtr()
+    {
+        if (node_) {
+            Node::release(node_);
+        }
+    }
+
+    NodePtr& operator=(const NodePtr& that) noexcept
+    {
+        NodePtr(that).swap(*this);
+        return *this;
+    }
+
+    NodePtr& operator=(NodePtr&& that) noexcept
+    {
+        NodePtr(std::move(that)).swap(*this);
+        return *this;
+    }
+
+    void swap(NodePtr& that) noexcept
+    {
+        std::swap(node_, that.node_);
+    }
+
+    const Node* get() const noexcept
+    {
+        return node_;
+    }
+
+    const Node* operator->() const noexcept
+    {
+        return node_;
+    }
+
+private:
+    const Node* node_;
+};
+
+// A node is immutable once built; `size` is the number of entries of its
+// subtree. The allocator is kept in each node so that it can free itself
+// when the last reference to it goes away.
+template<typename E, typename KeyOf, typename Cmp, typename Alloc>
+class WeightTree<E, KeyOf, Cmp, Alloc>::Node final : private Compressed<Alloc> {
+public:
+    template<typename X>
+    static NodePtr create(const Alloc& a, NodePtr l, X&& e, NodePtr r)
+    {
+        NodeAlloc alloc(a);
+        const auto p = NodeTraits::allocate(alloc, 1);
+        try {
+            return NodePtr(new (p) Node(a, std::move(l), std::forward<X>(e), std::move(r)));
+        } catch (...) {
+            NodeTraits::deallocate(alloc, p, 1);
+            throw;
+        }
+    }
+
+    const E entry;
+    const NodePtr left;
+    const NodePtr right;
+    const std::size_t size;
+
+private:
+    friend class NodePtr;
+
+    using NodeAlloc = Rebind<Alloc, Node>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+    template<typename X>
+    Node(const Alloc& alloc, NodePtr l, X&& e, NodePtr r)
+        : Compressed<Alloc>(alloc)
+        , entry(std::forward<X>(e))
+        , left(std::move(l))
+        , right(std::move(r))
+        , size(sizeOf(left.get()) + sizeOf(right.get()) + 1)
+        , refs_(1)
+    {}
+
+    ~Node() = default;
+
+    static void retain(const Node* n)
+    {
+        n->refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void release(const Node* n)
+    {
+        if (n->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            const auto m = const_cast<Node*>(n);
+            NodeAlloc alloc(m->get());
+            m->~Node();
+            NodeTraits::deallocate(alloc, m, 1);
+        }
+    }
+
+    mutable std::atomic<std::uint32_t> refs_;
+};
+
+// Walks the entries of a tree in ascending order of keys, keeping the
+// nodes whose entries and right subtrees are still to be visited.
+template<typename E, typename KeyOf, typename Cmp, typename Alloc>
+class WeightTree<E, KeyOf, Cmp, Alloc>::Cursor final {
+public:
+    explicit Cursor(const Node* root)
+    {
+        descend(root);
+    }
+
+    // Returns the next entry; there must be one.
+    const E& next()
+    {
+        const Node* n = path_.back();
+        path_.pop_back();
+        descend(n->right.get());
+        return n->entry;
+    }
+
+private:
+    void descend(const Node* n)
+    {
+        for (; n; n = n->left.get()) {
+            path_.push_back(n);
+        }
+    }
+
+    std::vector<const Node*> path_;
+};
+
+}  // namespace detail
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_DETAIL_WBTREE_HPP
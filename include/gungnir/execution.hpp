@@ -0,0 +1,127 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/execution.hpp
+ * Execution policies selecting parallel versions of algorithms.
+ */
+
+#ifndef GUNGNIR_EXECUTION_HPP
+#define GUNGNIR_EXECUTION_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+#include "gungnir/Executor.hpp"
+
+namespace gungnir {
+
+/**
+ * @brief An execution policy requesting that an algorithm run in parallel.
+ *
+ * Algorithms taking a policy split their input into chunks of at least
+ * `grain()` elements, process the chunks on an `Executor` and combine the
+ * results in order. Inputs too small to be split run
+ * sequentially on the calling thread. Functions passed to such algorithms
+ * may be called concurrently and must be safe to do so.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ */
+class ParallelPolicy final {
+public:
+    /**
+     * @brief Constructs a policy with the default grain size.
+     */
+    constexpr ParallelPolicy() noexcept
+        : grain_(std::size_t(1) << 13)
+        , executor_(nullptr)
+    {}
+
+    /**
+     * @brief Constructs a policy with the given grain size.
+     *
+     * @param grain the minimum number of elements per chunk
+     */
+    constexpr explicit ParallelPolicy(std::size_t grain) noexcept
+        : grain_(grain > 0 ? grain : 1)
+        , executor_(nullptr)
+    {}
+
+    /**
+     * @brief Returns the minimum number of elements per chunk.
+     *
+     * @return the minimum number of elements per chunk
+     */
+    constexpr std::size_t grain() const
+    {
+        return grain_;
+    }
+
+    /**
+     * @brief Returns a policy like this one that runs work on `executor`.
+     *
+     * @param executor the executor to run work on; must outlive all
+     *                 algorithms using the returned policy
+     * @return a policy running work on `executor`
+     */
+    constexpr ParallelPolicy on(Executor& executor) const
+    {
+        return ParallelPolicy(grain_, &executor);
+    }
+
+    /**
+     * @brief Returns the executor work runs on, which is
+     *        `Executor::global()` unless another was given to `on()`.
+     *
+     * @return the executor work runs on
+     */
+    Executor& executor() const
+    {
+        return executor_ ? *executor_ : Executor::global();
+    }
+
+    /**
+     * @brief Returns the number of chunks an input of `n` elements should be
+     *        split into.
+     *
+     * @param n the number of elements of the input
+     * @return the number of chunks, at least 1
+     */
+    std::size_t chunks(std::size_t n) const
+    {
+        const auto most = executor().concurrency() * 4;
+        return std::max<std::size_t>(1, std::min(n / grain_, most));
+    }
+
+private:
+    constexpr ParallelPolicy(std::size_t grain, Executor* executor) noexcept
+        : grain_(grain)
+        , executor_(executor)
+    {}
+
+    std::size_t grain_;
+    Executor* executor_;
+};
+
+/**
+ * The default parallel execution policy, as in `xs.map(par, f)`.
+ */
+constexpr ParallelPolicy par {};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_EXECUTION_HPP
@@ -22,8 +22,14 @@
 #ifndef GUNGNIR_LAZY_HPP
 #define GUNGNIR_LAZY_HPP
 
-#include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <mutex>
+#include <new>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -33,9 +39,50 @@ namespace gungnir {
 
 using namespace detail;
 
+namespace detail {
+
+// The storage of a lazy value: the arguments to the constructor of `T`
+// until the value is constructed, then the value.
+template<typename T, typename... Args>
+union LazyStorage {
+    using Tuple = std::tuple<Decay<Args>...>;
+
+    LazyStorage() {}
+    ~LazyStorage() {}
+
+    // Constructs the value from the arguments. They share storage with the
+    // value, so they are moved out of the way first, and put back if the
+    // constructor of `T` throws.
+    void create()
+    {
+        create(typename GenSeq<sizeof... (Args)>::type());
+    }
+
+    template<std::size_t... S>
+    void create(Seq<S...>)
+    {
+        Tuple tmp(std::move(args));
+        args.~Tuple();
+        try {
+            new (&value) T(std::move(std::get<S>(tmp))...);
+        } catch (...) {
+            new (&args) Tuple(std::move(tmp));
+            throw;
+        }
+    }
+
+    Tuple args;
+    T value;
+};
+
+}  // namespace detail
+
 /**
  * A lazily constructed value.
  *
+ * The arguments are stored inline until the value is constructed in their
+ * place, so creating a lazy value does not allocate.
+ *
  * @author Zizheng Tai
  * @since 1.0
  * @tparam T the type of the underlying value
@@ -50,30 +97,61 @@ public:
      * @param args the arguments passed to the constructor of `T`
      */
     explicit LazyVal(Args&&... args) noexcept
-        : args_(new std::tuple<Decay<Args>...>(std::forward<Args>(args)...))
-    {}
+        : ready_(false)
+    {
+        new (&storage_.args) Tuple(std::forward<Args>(args)...);
+    }
 
     /**
-     * Destructs the underlying value, if needed.
+     * Destructs the underlying value or the arguments.
      */
     ~LazyVal()
     {
-        if (val_) {
-            val_->~T();
-        }
+        destroy();
     }
 
     /** Deleted copy constructor. */
     LazyVal(const LazyVal &) = delete;
 
-    /** Default move constructor. */
-    LazyVal(LazyVal &&) = default;
+    /**
+     * Move constructor.
+     *
+     * @param that the lazy value to move from
+     */
+    LazyVal(LazyVal && that)
+        : ready_(that.ready_)
+    {
+        construct(std::move(that));
+    }
 
     /** Deleted copy assignment operator. */
     LazyVal & operator=(const LazyVal &) = delete;
 
-    /** Default move assignment operator. */
-    LazyVal & operator=(LazyVal &&) = default;
+    /**
+     * Move assignment operator.
+     *
+     * @param that the lazy value to move from
+     * @return this lazy value
+     */
+    LazyVal & operator=(LazyVal && that)
+    {
+        if (this != &that) {
+            destroy();
+            ready_ = that.ready_;
+            construct(std::move(that));
+        }
+        return *this;
+    }
+
+    /**
+     * Returns whether the underlying value has been constructed.
+     *
+     * @return `true` if the underlying value has been constructed
+     */
+    bool isForced() const
+    {
+        return ready_;
+    }
 
     /**
      * Returns the underlying value, constructing it if necessary.
@@ -82,10 +160,11 @@ public:
      */
     const T & get() const
     {
-        if (!val_) {
-            create(typename GenSeq<sizeof... (Args)>::type());
+        if (!ready_) {
+            storage_.create();
+            ready_ = true;
         }
-        return *val_;
+        return storage_.value;
     }
 
     /**
@@ -140,16 +219,28 @@ public:
     }
 
 private:
-    template<std::size_t... S>
-    void create(Seq<S...>) const
+    using Tuple = typename LazyStorage<T, Args...>::Tuple;
+
+    void construct(LazyVal && that)
     {
-        val_ = new (&buf_) T(std::move(std::get<S>(*args_))...);
-        args_.reset(nullptr);
+        if (ready_) {
+            new (&storage_.value) T(std::move(that.storage_.value));
+        } else {
+            new (&storage_.args) Tuple(std::move(that.storage_.args));
+        }
     }
 
-    mutable std::unique_ptr<std::tuple<Decay<Args>...>> args_;
-    mutable typename std::aligned_storage<sizeof (T), alignof (T)>::type buf_;
-    mutable T *val_ = nullptr;
+    void destroy()
+    {
+        if (ready_) {
+            storage_.value.~T();
+        } else {
+            storage_.args.~Tuple();
+        }
+    }
+
+    mutable LazyStorage<T, Args...> storage_;
+    mutable bool ready_;
 };
 
 /**
@@ -165,6 +256,606 @@ LazyVal<T, Args...> lazyVal(Args&&... args)
     return LazyVal<T, Args...>(std::forward<Args>(args)...);
 }
 
+namespace detail {
+
+// The size of the inline buffer holding the thunk of a `Lazy`, enough for a
+// lambda capturing a few pointers or small values.
+constexpr std::size_t lazyInlineSize = 4 * sizeof(void*);
+
+using LazyBuffer = typename std::aligned_storage<
+    lazyInlineSize, alignof(std::max_align_t)>::type;
+
+// The operations on the thunk of a `Lazy`, one table per type of thunk.
+template<typename T>
+struct LazyOps {
+    T (*call)(LazyBuffer&);
+    void (*move)(LazyBuffer& from, LazyBuffer& to) noexcept;
+    void (*destroy)(LazyBuffer&) noexcept;
+};
+
+// Thunks that fit the buffer and are nothrow movable are stored inline;
+// others on the heap, with a pointer to them in the buffer.
+template<typename Fn>
+using IsInlineThunk = std::integral_constant<
+    bool,
+    sizeof (Fn) <= lazyInlineSize && alignof(Fn) <= alignof(LazyBuffer) &&
+    std::is_nothrow_move_constructible<Fn>::value
+>;
+
+template<typename T, typename Fn, bool = IsInlineThunk<Fn>::value>
+struct LazyThunk {
+    static Fn& get(LazyBuffer& b) noexcept
+    {
+        return *reinterpret_cast<Fn*>(&b);
+    }
+
+    static void create(LazyBuffer& b, Fn&& f)
+    {
+        new (&b) Fn(std::move(f));
+    }
+
+    static T call(LazyBuffer& b)
+    {
+        return get(b)();
+    }
+
+    static void move(LazyBuffer& from, LazyBuffer& to) noexcept
+    {
+        new (&to) Fn(std::move(get(from)));
+        get(from).~Fn();
+    }
+
+    static void destroy(LazyBuffer& b) noexcept
+    {
+        get(b).~Fn();
+    }
+
+    static const LazyOps<T> ops;
+};
+
+template<typename T, typename Fn, bool Inline>
+const LazyOps<T> LazyThunk<T, Fn, Inline>::ops = { &call, &move, &destroy };
+
+template<typename T, typename Fn>
+struct LazyThunk<T, Fn, false> {
+    static Fn*& get(LazyBuffer& b) noexcept
+    {
+        return *reinterpret_cast<Fn**>(&b);
+    }
+
+    static void create(LazyBuffer& b, Fn&& f)
+    {
+        new (&b) Fn*(new Fn(std::move(f)));
+    }
+
+    static T call(LazyBuffer& b)
+    {
+        return (*get(b))();
+    }
+
+    static void move(LazyBuffer& from, LazyBuffer& to) noexcept
+    {
+        new (&to) Fn*(get(from));
+    }
+
+    static void destroy(LazyBuffer& b) noexcept
+    {
+        delete get(b);
+    }
+
+    static const LazyOps<T> ops;
+};
+
+template<typename T, typename Fn>
+const LazyOps<T> LazyThunk<T, Fn, false>::ops = { &call, &move, &destroy };
+
+template<typename T> struct LazyMap;
+template<typename T> struct LazyFlatMap;
+
+}  // namespace detail
+
+/**
+ * A lazily computed value, computed by calling a nullary function.
+ *
+ * Unlike `LazyVal`, the type of a `Lazy` depends on the type of the value
+ * only: the function is type-erased, so lazy values computed in different
+ * ways can be stored together, and each type of function adds just three
+ * small functions to the program. Functions up to four pointers in size
+ * that are nothrow movable, such as most lambdas, are stored inline, so
+ * creating such a lazy value does not allocate; larger ones are moved to
+ * the heap. The function is destroyed once it has computed the value,
+ * which takes its place.
+ *
+ * `map()` and `flatMap()` compose lazy values without forcing them, e.g.
+ * `lazy(load).map(parse)`; they take over the lazy value they are called
+ * on, which they move to the heap along with the function applied to it.
+ * If the function throws, the exception propagates to the caller of
+ * `get()` and the next call tries again.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam T the type of the underlying value
+ */
+template<typename T>
+class Lazy final {
+public:
+    /** The type of the underlying value. */
+    using ValueType = T;
+
+    /**
+     * Constructs a lazy value computed by `f()`.
+     *
+     * @tparam Fn the type of the function
+     * @param f the function computing the value
+     */
+    template<
+        typename Fn,
+        typename = typename std::enable_if<
+            !std::is_same<Decay<Fn>, Lazy>::value &&
+            std::is_convertible<Ret<Decay<Fn>&>, T>::value
+        >::type
+    >
+    explicit Lazy(Fn&& f)
+        : ops_(&LazyThunk<T, Decay<Fn>>::ops)
+        , ready_(false)
+    {
+        Decay<Fn> g(std::forward<Fn>(f));
+        LazyThunk<T, Decay<Fn>>::create(storage_.thunk, std::move(g));
+    }
+
+    /**
+     * Destructs the underlying value or the function.
+     */
+    ~Lazy()
+    {
+        destroy();
+    }
+
+    /** Deleted copy constructor. */
+    Lazy(const Lazy &) = delete;
+
+    /**
+     * Move constructor. `that` is left empty, and must not be forced.
+     *
+     * @param that the lazy value to move from
+     */
+    Lazy(Lazy && that) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : ops_(nullptr)
+        , ready_(false)
+    {
+        construct(std::move(that));
+    }
+
+    /** Deleted copy assignment operator. */
+    Lazy & operator=(const Lazy &) = delete;
+
+    /**
+     * Move assignment operator. `that` is left empty, and must not be
+     * forced.
+     *
+     * @param that the lazy value to move from
+     * @return this lazy value
+     */
+    Lazy & operator=(Lazy && that)
+    {
+        if (this != &that) {
+            destroy();
+            construct(std::move(that));
+        }
+        return *this;
+    }
+
+    /**
+     * Returns whether the underlying value has been computed.
+     *
+     * @return `true` if the underlying value has been computed
+     */
+    bool isForced() const
+    {
+        return ready_;
+    }
+
+    /**
+     * Returns the underlying value, computing it if necessary.
+     *
+     * @return the underlying value
+     */
+    const T & get() const
+    {
+        if (!ready_) {
+            force();
+        }
+        return storage_.value;
+    }
+
+    /**
+     * Returns the underlying value, computing it if necessary.
+     *
+     * @return the underlying value
+     */
+    T & get()
+    {
+        return const_cast<T &>(static_cast<const Lazy *>(this)->get());
+    }
+
+    /**
+     * Returns the underlying value, computing it if necessary.
+     *
+     * @return the underlying value
+     */
+    const T & operator()() const
+    {
+        return get();
+    }
+
+    /**
+     * Returns the underlying value, computing it if necessary.
+     *
+     * @return the underlying value
+     */
+    T & operator()()
+    {
+        return get();
+    }
+
+    /**
+     * Returns a lazy value computed by applying a function to the
+     * underlying value, which it takes over. Neither is computed until the
+     * returned value is forced.
+     *
+     * @tparam Fn the type of the function
+     * @tparam B the result type of the function
+     * @param f the function to apply to the underlying value
+     * @return a lazy value of `f` applied to the underlying value
+     */
+    template<typename Fn, typename B = Decay<Ret<Fn, T &&>>>
+    Lazy<B> map(Fn f) &&
+    {
+        return Lazy<B>(detail::LazyMap<T>::make(std::move(*this), std::move(f)));
+    }
+
+    /**
+     * Returns a lazy value computed by forcing the lazy value returned by
+     * a function applied to the underlying value, which it takes over.
+     * Nothing is computed until the returned value is forced.
+     *
+     * @tparam Fn the type of the function, returning `Lazy`s
+     * @tparam B the type of the value of the lazy values returned by `f`
+     * @param f the function to apply to the underlying value
+     * @return a lazy value of the value of the lazy value returned by `f`
+     */
+    template<
+        typename Fn,
+        typename B = typename Decay<Ret<Fn, T &&>>::ValueType
+    >
+    Lazy<B> flatMap(Fn f) &&
+    {
+        return Lazy<B>(detail::LazyFlatMap<T>::make(std::move(*this), std::move(f)));
+    }
+
+private:
+    union Storage {
+        Storage() {}
+        ~Storage() {}
+
+        LazyBuffer thunk;
+        T value;
+    };
+
+    // The value takes the place of the function in the buffer, so it is
+    // computed into a temporary first.
+    void force() const
+    {
+        T x(ops_->call(storage_.thunk));
+        ops_->destroy(storage_.thunk);
+        ops_ = nullptr;
+        new (&storage_.value) T(std::move(x));
+        ready_ = true;
+    }
+
+    void construct(Lazy && that)
+    {
+        if (that.ready_) {
+            new (&storage_.value) T(std::move(that.storage_.value));
+            ready_ = true;
+        } else if (that.ops_) {
+            that.ops_->move(that.storage_.thunk, storage_.thunk);
+            ops_ = that.ops_;
+            that.ops_ = nullptr;
+        }
+    }
+
+    void destroy()
+    {
+        if (ready_) {
+            storage_.value.~T();
+            ready_ = false;
+        } else if (ops_) {
+            ops_->destroy(storage_.thunk);
+            ops_ = nullptr;
+        }
+    }
+
+    mutable Storage storage_;
+    mutable const LazyOps<T>* ops_;
+    mutable bool ready_;
+};
+
+namespace detail {
+
+template<typename A>
+struct LazyMap {
+    template<typename Fn>
+    struct Thunk {
+        Decay<Ret<Fn, A &&>> operator()()
+        {
+            return f(std::move(x.get()));
+        }
+
+        Lazy<A> x;
+        Fn f;
+    };
+
+    template<typename Fn>
+    static Thunk<Fn> make(Lazy<A> && x, Fn && f)
+    {
+        return Thunk<Fn> { std::move(x), std::move(f) };
+    }
+};
+
+template<typename A>
+struct LazyFlatMap {
+    template<typename Fn>
+    struct Thunk {
+        using B = typename Decay<Ret<Fn, A &&>>::ValueType;
+
+        B operator()()
+        {
+            auto y = f(std::move(x.get()));
+            return std::move(y.get());
+        }
+
+        Lazy<A> x;
+        Fn f;
+    };
+
+    template<typename Fn>
+    static Thunk<Fn> make(Lazy<A> && x, Fn && f)
+    {
+        return Thunk<Fn> { std::move(x), std::move(f) };
+    }
+};
+
+}  // namespace detail
+
+/**
+ * Returns a value that will be lazily computed by calling the given
+ * function.
+ *
+ * @tparam Fn the type of the function
+ * @tparam T the type of the value
+ * @param f the function computing the value
+ */
+template<typename Fn, typename T = Decay<Ret<Decay<Fn>&>>>
+Lazy<T> lazy(Fn&& f)
+{
+    return Lazy<T>(std::forward<Fn>(f));
+}
+
+namespace detail {
+
+// Threads waiting for a `SyncLazyVal` under construction block on one of a
+// fixed set of condition variables, chosen by the address of the value, so
+// that lazy values themselves stay small and movable.
+struct OnceWaiters {
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+inline OnceWaiters& onceWaiters(const void* p)
+{
+    static OnceWaiters table[16];
+    return table[(reinterpret_cast<std::uintptr_t>(p) >> 4) % 16];
+}
+
+}  // namespace detail
+
+/**
+ * A lazily constructed value that can be shared across threads.
+ *
+ * The first call to `get()` from any thread constructs the value exactly
+ * once; concurrent callers wait for it to be constructed. Once it is, `get()`
+ * costs a single acquire load. If the constructor of `T` throws, the
+ * exception propagates to the thread that ran it and a later call tries
+ * again, with arguments that may have been moved from.
+ *
+ * Use `LazyVal` instead for values only accessed from a single thread.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam T the type of the underlying value
+ * @tparam Args the types of the arguments passed to the constructor of `T`
+ */
+template<typename T, typename... Args>
+class SyncLazyVal final {
+public:
+    /**
+     * Constructs a lazy value from the given arguments.
+     *
+     * @param args the arguments passed to the constructor of `T`
+     */
+    explicit SyncLazyVal(Args&&... args)
+        : state_(pending)
+    {
+        new (&storage_.args) Tuple(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Move constructor. `that` must not be accessed concurrently.
+     *
+     * @param that the lazy value to move from
+     */
+    SyncLazyVal(SyncLazyVal&& that)
+        : state_(that.state_.load(std::memory_order_acquire))
+    {
+        if (state_ == ready) {
+            new (&storage_.value) T(std::move(that.storage_.value));
+        } else {
+            new (&storage_.args) Tuple(std::move(that.storage_.args));
+        }
+    }
+
+    /**
+     * Destructs the underlying value or the arguments.
+     */
+    ~SyncLazyVal()
+    {
+        if (state_.load(std::memory_order_acquire) == ready) {
+            storage_.value.~T();
+        } else {
+            storage_.args.~Tuple();
+        }
+    }
+
+    /** Deleted copy constructor. */
+    SyncLazyVal(const SyncLazyVal &) = delete;
+
+    /** Deleted copy assignment operator. */
+    SyncLazyVal & operator=(const SyncLazyVal &) = delete;
+
+    /** Deleted move assignment operator. */
+    SyncLazyVal & operator=(SyncLazyVal &&) = delete;
+
+    /**
+     * Returns whether the underlying value has been constructed.
+     *
+     * @return `true` if the underlying value has been constructed
+     */
+    bool isForced() const
+    {
+        return state_.load(std::memory_order_acquire) == ready;
+    }
+
+    /**
+     * Returns the underlying value, constructing it if necessary.
+     *
+     * @return the underlying value
+     */
+    const T & get() const
+    {
+        if (state_.load(std::memory_order_acquire) != ready) {
+            force();
+        }
+        return storage_.value;
+    }
+
+    /**
+     * Returns the underlying value, constructing it if necessary.
+     *
+     * @return the underlying value
+     */
+    T & get()
+    {
+        return const_cast<T &>(
+                static_cast<const SyncLazyVal<T, Args...> *>(this)->get());
+    }
+
+    /**
+     * Returns the underlying value, constructing it if necessary.
+     *
+     * @return the underlying value
+     */
+    operator const T &() const
+    {
+        return get();
+    }
+
+    /**
+     * Returns the underlying value, constructing it if necessary.
+     *
+     * @return the underlying value
+     */
+    operator T &()
+    {
+        return get();
+    }
+
+    /**
+     * Returns the underlying value, constructing it if necessary.
+     *
+     * @return the underlying value
+     */
+    const T & operator()() const
+    {
+        return get();
+    }
+
+    /**
+     * Returns the underlying value, constructing it if necessary.
+     *
+     * @return the underlying value
+     */
+    T & operator()()
+    {
+        return get();
+    }
+
+private:
+    using Tuple = typename LazyStorage<T, Args...>::Tuple;
+
+    enum State : unsigned char { pending, constructing, ready };
+
+    void force() const
+    {
+        auto& waiters = onceWaiters(this);
+        for (;;) {
+            auto s = static_cast<unsigned char>(pending);
+            if (state_.compare_exchange_strong(s, constructing, std::memory_order_acquire)) {
+                try {
+                    storage_.create();
+                } catch (...) {
+                    state_.store(pending, std::memory_order_release);
+                    wake(waiters);
+                    throw;
+                }
+                state_.store(ready, std::memory_order_release);
+                wake(waiters);
+                return;
+            } else if (s == ready) {
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock(waiters.mutex);
+            waiters.cv.wait(lock, [this] {
+                return state_.load(std::memory_order_acquire) != constructing;
+            });
+        }
+    }
+
+    static void wake(OnceWaiters& waiters)
+    {
+        { std::lock_guard<std::mutex> lock(waiters.mutex); }
+        waiters.cv.notify_all();
+    }
+
+    mutable std::atomic<unsigned char> state_;
+    mutable LazyStorage<T, Args...> storage_;
+};
+
+/**
+ * Returns a value that will be lazily constructed from the given arguments,
+ * at most once even if first accessed from several threads at a time.
+ *
+ * @tparam T the type of the underlying value
+ * @tparam Args the types of the arguments passed to the constructor of `T`
+ * @param args the arguments passed to the constructor of `T`
+*/
+template<typename T, typename... Args>
+SyncLazyVal<T, Args...> syncLazyVal(Args&&... args)
+{
+    return SyncLazyVal<T, Args...>(std::forward<Args>(args)...);
+}
+
 }  // namespace gungnir
 
 #endif  // GUNGNIR_LAZY_HPP
@@ -0,0 +1,264 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/memoize.hpp
+ * Memoization of pure functions, safe to share across threads.
+ */
+
+#ifndef GUNGNIR_MEMOIZE_HPP
+#define GUNGNIR_MEMOIZE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "gungnir/lazy.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+/// @cond GUNGNIR_PRIVATE
+namespace detail {
+
+// The result of `f(k)`, constructed by a `SyncLazyVal`. The key is taken by
+// reference so that it is left intact for a retry if `f` throws.
+template<typename Fn, typename K, typename V>
+struct MemoResult {
+    MemoResult(const Fn* f, const K& k) : value((*f)(k)) {}
+
+    V value;
+};
+
+// The number of shards of a memoization table.
+constexpr std::size_t memoShards = 16;
+
+// The table behind a `Memoized`: `memoShards` independently locked hash maps
+// from keys to lazily computed results, each optionally bounded and kept
+// in least recently used order. Lookups of computed results copy them under
+// the lock of their shard. Otherwise, the result is computed outside it, by
+// the `SyncLazyVal` of the entry, which makes concurrent callers with the
+// same key wait for a single computation.
+template<typename K, typename Fn, typename Hash>
+class MemoTable final {
+public:
+    using V = Decay<Ret<const Fn&, const K&>>;
+
+    MemoTable(Fn f, std::size_t capacity)
+        : f_(std::move(f))
+        , perShard_(capacity == 0 ? 0 : (capacity + memoShards - 1) / memoShards)
+    {}
+
+    V get(const K& k)
+    {
+        const auto h = hash_(k);
+        auto& s = shards_[shardOf(h)];
+        std::shared_ptr<Entry> e;
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            const auto it = s.map.find(k);
+            if (it != s.map.end()) {
+                if (perShard_ != 0) {
+                    s.lru.splice(s.lru.begin(), s.lru, it->second.pos);
+                }
+                if (it->second.entry->isForced()) {
+                    return it->second.entry->get().value;
+                }
+                e = it->second.entry;
+            } else {
+                e = std::make_shared<Entry>(static_cast<const Fn*>(&f_), K(k));
+                insert(s, k, e);
+            }
+        }
+        return e->get().value;
+    }
+
+    std::size_t size()
+    {
+        std::size_t n = 0;
+        for (auto& s : shards_) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            n += s.map.size();
+        }
+        return n;
+    }
+
+    void clear()
+    {
+        for (auto& s : shards_) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.map.clear();
+            s.lru.clear();
+        }
+    }
+
+private:
+    // Shared with the callers computing or reading it, so that an entry
+    // evicted meanwhile stays alive until they are done with it.
+    using Entry = SyncLazyVal<MemoResult<Fn, K, V>, const Fn*, K>;
+
+    // The keys of a shard, most recently used first, pointing into the map.
+    using Lru = std::list<const K*>;
+
+    struct Slot {
+        std::shared_ptr<Entry> entry;
+        typename Lru::iterator pos;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<K, Slot, Hash> map;
+        Lru lru;
+    };
+
+    static std::size_t shardOf(std::size_t h)
+    {
+        // The high bits of a Fibonacci hash, since the low bits of `h` also
+        // pick the bucket within the shard; 60 = 64 - log2(memoShards).
+        return static_cast<std::size_t>((std::uint64_t(h) * 0x9E3779B97F4A7C15ull) >> 60);
+    }
+
+    void insert(Shard& s, const K& k, std::shared_ptr<Entry> e)
+    {
+        const auto it = s.map.emplace(k, Slot { std::move(e), {} }).first;
+        if (perShard_ == 0) {
+            return;
+        }
+        s.lru.push_front(&it->first);
+        it->second.pos = s.lru.begin();
+        if (s.map.size() > perShard_) {
+            s.map.erase(*s.lru.back());
+            s.lru.pop_back();
+        }
+    }
+
+    const Fn f_;
+    const Hash hash_ {};
+    const std::size_t perShard_;
+    Shard shards_[memoShards];
+};
+
+}  // namespace detail
+/// @endcond
+
+/**
+ * @brief A memoized function, returned by `memoize()`.
+ *
+ * Calling it with a key returns the value of the underlying function for
+ * that key, computed on first use and remembered afterwards. It is safe to
+ * call from several threads at a time: the table of results is split into
+ * independently locked shards, and callers asking for the same key while
+ * its value is being computed wait for that computation instead of
+ * repeating it. If the function throws, the exception propagates to the
+ * caller that ran it, and the next caller with that key tries again.
+ *
+ * With a capacity, each shard forgets its least recently used results
+ * once it holds more than its share of the capacity. Copies of a memoized
+ * function share its results.
+ *
+ * Values are returned by copy, since they may be evicted by other threads
+ * at any time; memoize functions returning values that are cheap to copy,
+ * such as `List`s or `std::shared_ptr`s.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam K the type of the keys
+ * @tparam Fn the type of the underlying function
+ * @tparam Hash the type of the hash function of the keys
+ */
+template<typename K, typename Fn, typename Hash = std::hash<K>>
+class Memoized final {
+    using Table = detail::MemoTable<K, Fn, Hash>;
+
+public:
+    /** @brief The result type of the function. */
+    using ValueType = typename Table::V;
+
+    /**
+     * @brief Constructs a memoized function.
+     *
+     * @param f the underlying function
+     * @param capacity the approximate maximum number of results to
+     *                 remember, or 0 to remember all of them
+     */
+    explicit Memoized(Fn f, std::size_t capacity = 0)
+        : table_(std::make_shared<Table>(std::move(f), capacity))
+    {}
+
+    /**
+     * @brief Returns the value of the underlying function for `k`,
+     *        computing it if it is not remembered.
+     *
+     * @param k the key
+     * @return the value of the underlying function for `k`
+     */
+    ValueType operator()(const K& k) const
+    {
+        return table_->get(k);
+    }
+
+    /**
+     * @brief Returns the number of results remembered, including those
+     *        being computed.
+     *
+     * @return the number of results remembered
+     */
+    std::size_t size() const
+    {
+        return table_->size();
+    }
+
+    /**
+     * @brief Forgets all remembered results.
+     */
+    void clear() const
+    {
+        table_->clear();
+    }
+
+private:
+    std::shared_ptr<Table> table_;
+};
+
+/**
+ * @brief Returns a memoized version of a pure function of one argument.
+ *
+ * The type of the argument is given explicitly, as in
+ * `memoize<std::string>(parse)`, and must be copyable and hashable by
+ * `Hash`. `f` must be safe to call concurrently for different keys.
+ *
+ * @tparam K the type of the keys
+ * @tparam Hash the type of the hash function of the keys
+ * @tparam Fn the type of the function
+ * @param f the function to memoize
+ * @param capacity the approximate maximum number of results to remember,
+ *                 or 0 to remember all of them
+ * @return a memoized version of `f`
+ */
+template<typename K, typename Hash = std::hash<K>, typename Fn>
+Memoized<K, Fn, Hash> memoize(Fn f, std::size_t capacity = 0)
+{
+    return Memoized<K, Fn, Hash>(std::move(f), capacity);
+}
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_MEMOIZE_HPP
@@ -0,0 +1,247 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/reclaim.hpp
+ * Reclamation policies for the nodes of persistent data structures.
+ */
+
+#ifndef GUNGNIR_RECLAIM_HPP
+#define GUNGNIR_RECLAIM_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gungnir/refcount.hpp"
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+/**
+ * @brief A reclamation policy freeing the nodes of a data structure on the
+ *        thread that releases their last reference, as soon as it does.
+ *
+ * This is the default policy.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ */
+struct ImmediateReclaim {};
+
+/**
+ * @brief A reclamation policy freeing at most a bounded number of nodes on
+ *        the thread that releases their last reference, and handing the
+ *        rest to a background thread.
+ *
+ * Dropping the last reference to a list of a million elements otherwise
+ * frees a million nodes before the destructor returns. Under this policy,
+ * the releasing thread frees the first `inlineNodes()` of them, and queues
+ * the remaining chain for a single background thread, started on first
+ * use, which frees the chains queued by all threads in order.
+ * `waitForReclamation()` blocks until the chains queued so far are freed.
+ *
+ * The background thread deallocates with copies of the allocators of the
+ * nodes and runs the destructors of the elements, which must therefore be
+ * safe to call on another thread, and the reference counting policy must
+ * be `AtomicRefCount`. Chains still queued when the program exits may
+ * not be freed; call `waitForReclamation()` first if the destructors of
+ * the elements have observable effects.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ */
+struct DeferredReclaim {
+    /**
+     * @brief Returns the number of nodes freed by the releasing thread.
+     *
+     * @return the number of nodes freed by the releasing thread
+     */
+    static constexpr std::size_t inlineNodes()
+    {
+        return 256;
+    }
+};
+
+/// @cond GUNGNIR_PRIVATE
+namespace detail {
+
+template<typename Alloc, typename = void>
+struct ReclaimOf_ {
+    using type = ImmediateReclaim;
+};
+
+template<typename Alloc>
+struct ReclaimOf_<Alloc, typename VoidT<typename Alloc::reclaim_policy>::type> {
+    using type = typename Alloc::reclaim_policy;
+};
+
+// The reclamation policy of the nodes allocated with `Alloc`: its member
+// type `reclaim_policy` if it has one, `ImmediateReclaim` otherwise.
+template<typename Alloc>
+using ReclaimOf = typename ReclaimOf_<Alloc>::type;
+
+// The background thread of `DeferredReclaim`, which calls the functions
+// queued with `defer()` on their arguments, in order. It is never
+// destroyed, so that objects released by the destructors of static
+// objects can still be queued, and its thread is detached.
+class Reclaimer final {
+public:
+    using Free = void (*)(void*);
+
+    static Reclaimer& global()
+    {
+        static Reclaimer* const r = new Reclaimer;
+        return *r;
+    }
+
+    // Queues `free(p)` to be called on the background thread.
+    void defer(void* p, Free free)
+    {
+        std::unique_lock<std::mutex> lock(m_);
+        if (!started_) {
+            std::thread([this] { run(); }).detach();
+            started_ = true;
+        }
+        queue_.push_back(Task { p, free });
+        ++queued_;
+        const auto wake = idle_;
+        lock.unlock();
+        if (wake) {
+            work_.notify_one();
+        }
+    }
+
+    // Blocks until the calls queued so far have returned.
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m_);
+        const auto target = queued_;
+        done_.wait(lock, [this, target] { return freed_ >= target; });
+    }
+
+private:
+    struct Task {
+        void* p;
+        Free free;
+    };
+
+    Reclaimer() = default;
+
+    void run()
+    {
+        std::vector<Task> tasks;
+        std::unique_lock<std::mutex> lock(m_);
+        for (;;) {
+            idle_ = true;
+            work_.wait(lock, [this] { return !queue_.empty(); });
+            idle_ = false;
+            tasks.swap(queue_);
+            lock.unlock();
+            for (const auto& t : tasks) {
+                t.free(t.p);
+            }
+            const auto n = tasks.size();
+            tasks.clear();
+            lock.lock();
+            freed_ += n;
+            done_.notify_all();
+        }
+    }
+
+    std::mutex m_;
+    std::condition_variable work_;
+    std::condition_variable done_;
+    std::vector<Task> queue_;
+    std::uint64_t queued_ = 0;
+    std::uint64_t freed_ = 0;
+    bool started_ = false;
+    bool idle_ = false;
+};
+
+}  // namespace detail
+/// @endcond
+
+/**
+ * @brief Blocks until the nodes that threads have handed to the background
+ *        thread of `DeferredReclaim` so far are freed.
+ */
+inline void waitForReclamation()
+{
+    detail::Reclaimer::global().wait();
+}
+
+/**
+ * @brief An allocator that allocates with `Base` and selects the
+ *        `DeferredReclaim` policy for the nodes it allocates.
+ *
+ * Dropping the last reference to a long `List<A, DeferredAllocator<A>>`
+ * frees a bounded number of its nodes on the calling thread and the rest
+ * in the background, which keeps latency-sensitive threads from stalling
+ * on the teardown of large lists. Lists derived from it, e.g. through
+ * `map()`, rebind the allocator and keep the policy.
+ *
+ * Any other allocator can select a policy the same way, by naming it as
+ * its member type `reclaim_policy`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the allocated objects
+ * @tparam Base the type of the allocator that actually allocates them
+ */
+template<typename A, typename Base = std::allocator<A>>
+class DeferredAllocator : public Base {
+public:
+    /** @brief The reclamation policy this allocator selects. */
+    using reclaim_policy = DeferredReclaim;
+
+    /** @brief Rebinds this allocator to another type of objects. */
+    template<typename B>
+    struct rebind {
+        using other = DeferredAllocator<B, detail::Rebind<Base, B>>;
+    };
+
+    /**
+     * @brief Constructs an allocator with a default constructed `Base`.
+     */
+    DeferredAllocator() = default;
+
+    /**
+     * @brief Constructs an allocator allocating with `base`.
+     *
+     * @param base the allocator that actually allocates objects
+     */
+    explicit DeferredAllocator(const Base& base) noexcept : Base(base) {}
+
+    /**
+     * @brief Constructs an allocator allocating with a copy of the
+     *        allocator of `that`, rebound to `A`.
+     *
+     * @param that the allocator to copy
+     */
+    template<typename B, typename BBase>
+    DeferredAllocator(const DeferredAllocator<B, BBase>& that) noexcept
+        : Base(static_cast<const BBase&>(that))
+    {}
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_RECLAIM_HPP
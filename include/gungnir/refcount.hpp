@@ -0,0 +1,195 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/refcount.hpp
+ * Reference counting policies for the nodes of persistent data structures.
+ */
+
+#ifndef GUNGNIR_REFCOUNT_HPP
+#define GUNGNIR_REFCOUNT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "gungnir/detail/util.hpp"
+
+namespace gungnir {
+
+/**
+ * @brief A reference counting policy whose counters are atomic, so that
+ *        nodes can be shared across threads.
+ *
+ * This is the policy of every allocator that does not name another one.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ */
+struct AtomicRefCount {
+    /** @brief A counter of references. */
+    class Counter {
+    public:
+        explicit Counter(std::uint32_t n) noexcept : n_(n) {}
+
+        Counter(const Counter&) = delete;
+        Counter& operator=(const Counter&) = delete;
+
+        void retain() const noexcept
+        {
+            n_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Returns whether the last reference was released.
+        bool release() const noexcept
+        {
+            return n_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        bool unique() const noexcept
+        {
+            return n_.load(std::memory_order_acquire) == 1;
+        }
+
+    private:
+        mutable std::atomic<std::uint32_t> n_;
+    };
+};
+
+/**
+ * @brief A reference counting policy whose counters are plain integers.
+ *
+ * Retaining and releasing a node then costs an ordinary increment and
+ * decrement rather than a locked instruction. A data structure using it,
+ * and every data structure sharing nodes with it, must be confined to a
+ * single thread; this includes not passing it to the parallel overloads
+ * of its algorithms.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ */
+struct LocalRefCount {
+    /** @brief A counter of references. */
+    class Counter {
+    public:
+        explicit Counter(std::uint32_t n) noexcept : n_(n) {}
+
+        Counter(const Counter&) = delete;
+        Counter& operator=(const Counter&) = delete;
+
+        void retain() const noexcept
+        {
+            ++n_;
+        }
+
+        // Returns whether the last reference was released.
+        bool release() const noexcept
+        {
+            return --n_ == 0;
+        }
+
+        bool unique() const noexcept
+        {
+            return n_ == 1;
+        }
+
+    private:
+        mutable std::uint32_t n_;
+    };
+};
+
+/// @cond GUNGNIR_PRIVATE
+namespace detail {
+
+template<typename...>
+struct VoidT {
+    using type = void;
+};
+
+template<typename Alloc, typename = void>
+struct RefCountOf_ {
+    using type = AtomicRefCount;
+};
+
+template<typename Alloc>
+struct RefCountOf_<Alloc, typename VoidT<typename Alloc::refcount_policy>::type> {
+    using type = typename Alloc::refcount_policy;
+};
+
+// The reference counting policy of the nodes allocated with `Alloc`: its
+// member type `refcount_policy` if it has one, `AtomicRefCount` otherwise.
+template<typename Alloc>
+using RefCountOf = typename RefCountOf_<Alloc>::type;
+
+}  // namespace detail
+/// @endcond
+
+/**
+ * @brief An allocator that allocates with `Base` and selects the
+ *        `LocalRefCount` policy for the nodes it allocates.
+ *
+ * A `List<A, LocalAllocator<A>>` skips atomic operations entirely when
+ * it and the lists it shares nodes with are copied, iterated and dropped,
+ * at the price of being confined to a single thread. Lists derived from
+ * it, e.g. through `map()`, rebind the allocator and keep the policy.
+ *
+ * Any other allocator can select a policy the same way, by naming it as
+ * its member type `refcount_policy`.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the allocated objects
+ * @tparam Base the type of the allocator that actually allocates them
+ */
+template<typename A, typename Base = std::allocator<A>>
+class LocalAllocator : public Base {
+public:
+    /** @brief The reference counting policy this allocator selects. */
+    using refcount_policy = LocalRefCount;
+
+    /** @brief Rebinds this allocator to another type of objects. */
+    template<typename B>
+    struct rebind {
+        using other = LocalAllocator<B, detail::Rebind<Base, B>>;
+    };
+
+    /**
+     * @brief Constructs an allocator with a default constructed `Base`.
+     */
+    LocalAllocator() = default;
+
+    /**
+     * @brief Constructs an allocator allocating with `base`.
+     *
+     * @param base the allocator that actually allocates objects
+     */
+    explicit LocalAllocator(const Base& base) noexcept : Base(base) {}
+
+    /**
+     * @brief Constructs an allocator allocating with a copy of the
+     *        allocator of `that`, rebound to `A`.
+     *
+     * @param that the allocator to copy
+     */
+    template<typename B, typename BBase>
+    LocalAllocator(const LocalAllocator<B, BBase>& that) noexcept
+        : Base(static_cast<const BBase&>(that))
+    {}
+};
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_REFCOUNT_HPP
@@ -0,0 +1,411 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file gungnir/serialize.hpp
+ * A compact binary snapshot format for `List` and `Option`, which can be
+ * viewed in place, e.g. from a memory-mapped file.
+ *
+ * A snapshot consists of a 16-byte header, holding the magic bytes `GNGR`,
+ * the size of each element as a 32-bit integer and the number of elements
+ * as a 64-bit integer, followed by the elements. Snapshots of trivially
+ * copyable elements store them as one contiguous block, padded to the
+ * alignment of the elements, which `viewSnapshot()` and `mapSnapshot()`
+ * expose as a `BufferView` without copying; their element size is that of
+ * the type. Snapshots of other elements store each of them as encoded by
+ * its `Codec`; their element size is 0. Integers and elements are stored
+ * in the byte order of the host, so snapshots are not portable between
+ * hosts of different byte orders.
+ */
+
+#ifndef GUNGNIR_SERIALIZE_HPP
+#define GUNGNIR_SERIALIZE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GUNGNIR_HAS_MMAP 1
+#endif
+
+#include "gungnir/BufferView.hpp"
+#include "gungnir/List.hpp"
+#include "gungnir/Option.hpp"
+
+namespace gungnir {
+
+/**
+ * @brief Encodes values of type `A` into snapshots and decodes them back.
+ *
+ * Specialize it to serialize lists and options of types that are not
+ * trivially copyable, with the members
+ *
+ * ```cpp
+ * static void encode(std::ostream& out, const A& x);
+ * static A decode(std::istream& in);
+ * ```
+ *
+ * `decode()` must read exactly the bytes written by `encode()`. Trivially
+ * copyable types and `std::string` are supported out of the box.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the values
+ */
+template<typename A, typename = void>
+struct Codec {
+    static_assert(sizeof (A) == 0, "specialize gungnir::Codec to serialize this type");
+};
+
+/// @cond GUNGNIR_PRIVATE
+namespace detail {
+
+namespace serial {
+
+constexpr std::size_t headerSize = 16;
+
+// Whether snapshots store `A`s as a contiguous block.
+template<typename A>
+using IsBlock = std::is_trivially_copyable<A>;
+
+// The offset of the first element of a snapshot of `A`s.
+template<typename A>
+constexpr std::size_t dataOffset()
+{
+    return IsBlock<A>::value
+        ? (headerSize + alignof(A) - 1) / alignof(A) * alignof(A)
+        : headerSize;
+}
+
+// The element size recorded in the headers of snapshots of `A`s.
+template<typename A>
+constexpr std::uint32_t elemSize()
+{
+    return IsBlock<A>::value ? sizeof (A) : 0;
+}
+
+inline void write(std::ostream& out, const void* p, std::size_t n)
+{
+    out.write(static_cast<const char*>(p), static_cast<std::streamsize>(n));
+}
+
+inline void read(std::istream& in, void* p, std::size_t n)
+{
+    if (!in.read(static_cast<char*>(p), static_cast<std::streamsize>(n))) {
+        throw std::runtime_error("truncated snapshot");
+    }
+}
+
+template<typename A>
+void writeHeader(std::ostream& out, std::uint64_t count)
+{
+    char header[dataOffset<A>()] = { 'G', 'N', 'G', 'R' };
+    const auto size = elemSize<A>();
+    std::memcpy(header + 4, &size, sizeof size);
+    std::memcpy(header + 8, &count, sizeof count);
+    write(out, header, sizeof header);
+}
+
+// Checks the header at `p` and returns the number of elements it records.
+template<typename A>
+std::uint64_t checkHeader(const char* p)
+{
+    std::uint32_t size;
+    std::uint64_t count;
+    std::memcpy(&size, p + 4, sizeof size);
+    std::memcpy(&count, p + 8, sizeof count);
+    if (std::memcmp(p, "GNGR", 4) != 0) {
+        throw std::runtime_error("not a snapshot");
+    } else if (size != elemSize<A>()) {
+        throw std::runtime_error("snapshot of another element type");
+    }
+    return count;
+}
+
+template<typename A>
+std::uint64_t readHeader(std::istream& in)
+{
+    char header[dataOffset<A>()];
+    read(in, header, sizeof header);
+    return checkHeader<A>(header);
+}
+
+template<typename A>
+BufferView<A> view(std::shared_ptr<const char> bytes, std::size_t size)
+{
+    static_assert(IsBlock<A>::value, "only snapshots of trivially copyable types can be viewed");
+
+    if (size < dataOffset<A>()) {
+        throw std::runtime_error("truncated snapshot");
+    }
+    const auto count = checkHeader<A>(bytes.get());
+    if (count > (size - dataOffset<A>()) / sizeof (A)) {
+        throw std::runtime_error("truncated snapshot");
+    }
+    const auto p = reinterpret_cast<const A*>(bytes.get() + dataOffset<A>());
+    return BufferView<A>(std::shared_ptr<const A>(std::move(bytes), p), count);
+}
+
+}  // namespace serial
+
+}  // namespace detail
+/// @endcond
+
+/**
+ * @brief The codec of trivially copyable types, which stores their bytes.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ * @tparam A the type of the values
+ */
+template<typename A>
+struct Codec<A, typename std::enable_if<std::is_trivially_copyable<A>::value>::type> {
+    /**
+     * @brief Writes the bytes of `x` to `out`.
+     *
+     * @param out the stream to write to
+     * @param x the value to encode
+     */
+    static void encode(std::ostream& out, const A& x)
+    {
+        detail::serial::write(out, &x, sizeof x);
+    }
+
+    /**
+     * @brief Reads a value written by `encode()` from `in`.
+     *
+     * @param in the stream to read from
+     * @return the decoded value
+     * @throws std::runtime_error if `in` ends prematurely
+     */
+    static A decode(std::istream& in)
+    {
+        typename std::aligned_storage<sizeof (A), alignof(A)>::type buf;
+        detail::serial::read(in, &buf, sizeof (A));
+        return *reinterpret_cast<const A*>(&buf);
+    }
+};
+
+/**
+ * @brief The codec of strings, which stores their lengths followed by
+ *        their characters.
+ *
+ * @author Zizheng Tai
+ * @since 1.0
+ */
+template<>
+struct Codec<std::string> {
+    /**
+     * @brief Writes the length and characters of `s` to `out`.
+     *
+     * @param out the stream to write to
+     * @param s the string to encode
+     */
+    static void encode(std::ostream& out, const std::string& s)
+    {
+        const std::uint64_t n = s.size();
+        detail::serial::write(out, &n, sizeof n);
+        detail::serial::write(out, s.data(), s.size());
+    }
+
+    /**
+     * @brief Reads a string written by `encode()` from `in`.
+     *
+     * @param in the stream to read from
+     * @return the decoded string
+     * @throws std::runtime_error if `in` ends prematurely
+     */
+    static std::string decode(std::istream& in)
+    {
+        std::uint64_t n;
+        detail::serial::read(in, &n, sizeof n);
+        std::string s;
+        // Grows the string as its characters arrive rather than trusting
+        // the length read, which may be corrupt.
+        char buf[4096];
+        while (n > 0) {
+            const auto k = static_cast<std::size_t>(std::min<std::uint64_t>(n, sizeof buf));
+            detail::serial::read(in, buf, k);
+            s.append(buf, k);
+            n -= k;
+        }
+        return s;
+    }
+};
+
+/**
+ * @brief Writes a snapshot of a list to a stream.
+ *
+ * @tparam A the element type of the list
+ * @param out the stream to write to
+ * @param xs the list to write
+ */
+template<typename A, typename Alloc>
+void serialize(std::ostream& out, const List<A, Alloc>& xs)
+{
+    detail::serial::writeHeader<A>(out, xs.size());
+    xs.foreach([&out](const A& x) {
+        Codec<A>::encode(out, x);
+    });
+}
+
+/**
+ * @brief Writes a snapshot of an option, as a list of zero or one
+ *        element, to a stream.
+ *
+ * @tparam A the type of the optional value
+ * @param out the stream to write to
+ * @param x the option to write
+ */
+template<typename A>
+void serialize(std::ostream& out, const Option<A>& x)
+{
+    detail::serial::writeHeader<A>(out, x ? 1 : 0);
+    if (x) {
+        Codec<A>::encode(out, *x);
+    }
+}
+
+/**
+ * @brief Reads a list from a snapshot written by `serialize()`.
+ *
+ * @tparam A the element type of the list
+ * @tparam Alloc the allocator type of the list
+ * @param in the stream to read from
+ * @param alloc the allocator used by the returned list
+ * @return the list read from `in`
+ * @throws std::runtime_error if `in` does not hold a snapshot of `A`s or
+ *                            ends prematurely
+ */
+template<typename A, typename Alloc = std::allocator<A>>
+List<A, Alloc> deserializeList(std::istream& in, const Alloc& alloc = Alloc())
+{
+    auto n = detail::serial::readHeader<A>(in);
+    ListBuilder<A, Alloc> buf(alloc);
+    for (; n > 0; --n) {
+        buf.append(Codec<A>::decode(in));
+    }
+    return buf.result();
+}
+
+/**
+ * @brief Reads an option from a snapshot written by `serialize()`.
+ *
+ * @tparam A the type of the optional value
+ * @param in the stream to read from
+ * @return the option read from `in`
+ * @throws std::runtime_error if `in` does not hold a snapshot of an
+ *                            option of `A` or ends prematurely
+ */
+template<typename A>
+Option<A> deserializeOption(std::istream& in)
+{
+    switch (detail::serial::readHeader<A>(in)) {
+    case 0:
+        return Option<A>();
+    case 1:
+        return Option<A>(Codec<A>::decode(in));
+    default:
+        throw std::runtime_error("snapshot of a list, not an option");
+    }
+}
+
+/**
+ * @brief Returns a view of the elements of a snapshot held in memory,
+ *        without copying them.
+ *
+ * @tparam A the element type of the snapshot; must be trivially copyable
+ * @param bytes a pointer to the snapshot, aligned to at least `alignof(A)`
+ *              and sharing ownership of it with the returned view
+ * @param size the number of bytes of the snapshot
+ * @return a view of the elements of the snapshot
+ * @throws std::runtime_error if `bytes` does not hold a snapshot of `A`s
+ *                            or is truncated
+ */
+template<typename A>
+BufferView<A> viewSnapshot(std::shared_ptr<const char> bytes, std::size_t size)
+{
+    return detail::serial::view<A>(std::move(bytes), size);
+}
+
+#ifdef GUNGNIR_HAS_MMAP
+
+/**
+ * @brief Maps a snapshot file into memory and returns a view of its
+ *        elements, without reading or copying them.
+ *
+ * The pages of the file are loaded on demand as the elements are visited,
+ * and the mapping is released when the returned view and all views derived
+ * from it are destroyed. The file must not be modified meanwhile.
+ *
+ * @tparam A the element type of the snapshot; must be trivially copyable
+ * @param path the path of the snapshot file
+ * @return a view of the elements of the snapshot
+ * @throws std::system_error if the file cannot be opened or mapped
+ * @throws std::runtime_error if the file does not hold a snapshot of `A`s
+ *                            or is truncated
+ */
+template<typename A>
+BufferView<A> mapSnapshot(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        const int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), "cannot stat " + path);
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    if (size == 0) {
+        ::close(fd);
+        throw std::runtime_error("truncated snapshot");
+    }
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    const int err = errno;
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        throw std::system_error(err, std::generic_category(), "cannot map " + path);
+    }
+
+    std::shared_ptr<const char> bytes(static_cast<const char*>(p), [size](const char* q) {
+        ::munmap(const_cast<char*>(q), size);
+    });
+    return detail::serial::view<A>(std::move(bytes), size);
+}
+
+#endif  // GUNGNIR_HAS_MMAP
+
+}  // namespace gungnir
+
+#endif  // GUNGNIR_SERIALIZE_HPP
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2016 Zizheng Tai
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The instantiations of `List` declared `extern` by `List.hpp` when
+// `GUNGNIR_EXTERN_TEMPLATES` is defined. Element types whose lists are used
+// throughout a code base can be added likewise, to a source file of its own,
+// with matching `extern template` declarations in a header of its own.
+
+#include "gungnir/List.hpp"
+
+namespace gungnir {
+
+template class List<int>;
+template class List<long>;
+template class List<double>;
+template class ListBuilder<int>;
+template class ListBuilder<long>;
+template class ListBuilder<double>;
+
+}  // namespace gungnir
@@ -0,0 +1,93 @@
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/AtomicList.hpp"
+using gungnir::AtomicList;
+using gungnir::List;
+
+TEST_CASE("test AtomicList", "[AtomicList]") {
+
+    using LI = List<int>;
+
+    SECTION("single thread") {
+        AtomicList<int> a;
+        REQUIRE(a.load().isEmpty());
+
+        a.store(LI(1, 2));
+        REQUIRE(a.load() == LI(1, 2));
+        REQUIRE(a.exchange(LI(3)) == LI(1, 2));
+        REQUIRE(a.update([](const LI& xs) { return xs.prepend(4); }) == LI(4, 3));
+        REQUIRE(a.load() == LI(4, 3));
+
+        const AtomicList<int> b(LI(5, 6, 7));
+        REQUIRE(b.load().size() == 3);
+    }
+    SECTION("loads share the nodes of the stored list") {
+        const LI xs(1, 2, 3);
+        AtomicList<int> a(xs);
+        const auto ys = a.load();
+        REQUIRE(&ys.head() == &xs.head());
+    }
+    SECTION("many loads flush the pins of the installed list") {
+        AtomicList<int> a(LI(1));
+        std::size_t total = 0;
+        for (int i = 0; i < 200000; ++i) {
+            total += a.load().size();
+        }
+        REQUIRE(total == 200000);
+        a.store(LI(2));
+        REQUIRE(a.load().head() == 2);
+    }
+    SECTION("concurrent readers and writers") {
+        // Each writer prepends `n` elements one `update()` at a time;
+        // readers check that every snapshot is well formed, i.e. that its
+        // size and head agree.
+        const int writers = 2;
+        const int readers = 4;
+        const int n = 5000;
+
+        AtomicList<int> a;
+        std::atomic<bool> done(false);
+        std::vector<std::size_t> bad(readers, 0);
+
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&a, &done, &bad, r] {
+                while (!done.load()) {
+                    const auto xs = a.load();
+                    if (!xs.isEmpty() && static_cast<std::size_t>(xs.head()) != xs.size()) {
+                        ++bad[r];
+                    }
+                }
+            });
+        }
+        std::vector<std::thread> ws;
+        for (int w = 0; w < writers; ++w) {
+            ws.emplace_back([&a] {
+                for (int i = 0; i < n; ++i) {
+                    a.update([](const LI& xs) {
+                        return xs.prepend(static_cast<int>(xs.size()) + 1);
+                    });
+                }
+            });
+        }
+        for (auto& t : ws) {
+            t.join();
+        }
+        done.store(true);
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        const auto xs = a.load();
+        REQUIRE(xs.size() == static_cast<std::size_t>(writers * n));
+        REQUIRE(xs.head() == writers * n);
+        for (int r = 0; r < readers; ++r) {
+            REQUIRE(bad[r] == 0);
+        }
+    }
+}
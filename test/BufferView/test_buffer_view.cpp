@@ -0,0 +1,112 @@
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/BufferView.hpp"
+using gungnir::BufferView;
+using gungnir::List;
+
+TEST_CASE("test BufferView", "[BufferView]") {
+
+    using BI = BufferView<int>;
+
+    std::vector<int> v(100);
+    std::iota(v.begin(), v.end(), 0);
+    const auto shared = std::make_shared<const std::vector<int>>(v);
+
+    SECTION("empty views") {
+        const BI xs;
+        REQUIRE(xs.isEmpty());
+        REQUIRE(xs.size() == 0);
+        REQUIRE(xs.begin() == xs.end());
+        REQUIRE_THROWS_AS(xs.head(), std::out_of_range);
+        REQUIRE_THROWS_AS(xs.tail(), std::out_of_range);
+        REQUIRE(xs.sum() == 0);
+        REQUIRE_FALSE(xs.contains(0));
+        REQUIRE(xs.map([](int x) { return x; }).isEmpty());
+        REQUIRE(xs == BI(std::vector<int>()));
+    }
+    SECTION("views share the buffer") {
+        const BI xs(shared);
+        REQUIRE(xs.size() == 100);
+        REQUIRE(xs.data() == shared->data());
+        REQUIRE(shared.use_count() == 2);
+
+        const auto ys = xs.drop(10).take(5);
+        REQUIRE(ys.data() == shared->data() + 10);
+        REQUIRE(ys.size() == 5);
+        REQUIRE(shared.use_count() == 3);
+        REQUIRE(ys.toList() == List<int>(10, 11, 12, 13, 14));
+
+        const auto* data = v.data();
+        const BI zs(std::move(v));
+        REQUIRE(zs.data() == data);
+        REQUIRE(zs.size() == 100);
+    }
+    SECTION("a view keeps its buffer alive") {
+        BI ys;
+        {
+            const BI xs(std::make_shared<const std::vector<int>>(5, 7));
+            ys = xs.tail();
+        }
+        REQUIRE(ys.size() == 4);
+        REQUIRE(ys.sum() == 28);
+    }
+    SECTION("raw buffers") {
+        std::shared_ptr<const int> buf(new int[4] {1, 2, 3, 4}, std::default_delete<int[]>());
+        const BI xs(buf, 4);
+        REQUIRE(xs.last() == 4);
+        REQUIRE(xs.slice(1, 3).toList() == List<int>(2, 3));
+        REQUIRE(xs.slice(3, 1).isEmpty());
+        REQUIRE(xs.slice(2, 10).size() == 2);
+    }
+    SECTION("access") {
+        const BI xs(shared);
+        REQUIRE(xs.head() == 0);
+        REQUIRE(xs.last() == 99);
+        REQUIRE(xs[42] == 42);
+        REQUIRE_THROWS_AS(xs[100], std::out_of_range);
+        REQUIRE(xs.tail().head() == 1);
+        REQUIRE(xs.take(200).size() == 100);
+        REQUIRE(xs.drop(200).isEmpty());
+    }
+    SECTION("combinators") {
+        const BI xs(shared);
+        REQUIRE(xs.sum() == 4950);
+        REQUIRE(xs.count(3) == 1);
+        REQUIRE(xs.count([](int x) { return x % 10 < 3; }) == 30);
+        REQUIRE(xs.contains(99));
+        REQUIRE_FALSE(xs.contains(100));
+        REQUIRE(xs.exists([](int x) { return x > 98; }));
+        REQUIRE(xs.forall([](int x) { return x < 100; }));
+        REQUIRE(xs.foldLeft(0L, [](long a, int x) { return a + x; }) == 4950);
+        REQUIRE(xs.take(3).map([](int x) { return std::to_string(x); }) ==
+                List<std::string>("0", "1", "2"));
+        REQUIRE(xs.filter([](int x) { return x % 25 == 0; }) == List<int>(0, 25, 50, 75));
+
+        int sum = 0;
+        xs.foreach([&sum](int x) { sum += x; });
+        REQUIRE(sum == 4950);
+
+        const auto ys = xs.view().filter([](int x) { return x % 2 == 0; })
+                                 .map([](int x) { return x / 2; })
+                                 .take(3)
+                                 .toList();
+        REQUIRE(ys == List<int>(0, 1, 2));
+    }
+    SECTION("equality") {
+        const BI xs(shared);
+        REQUIRE(xs == BI(std::make_shared<const std::vector<int>>(v)));
+        REQUIRE(xs != xs.tail());
+        REQUIRE(xs.take(3) == BI(std::vector<int>{0, 1, 2}));
+    }
+    SECTION("standard algorithms") {
+        const BI xs(shared);
+        REQUIRE(std::lower_bound(xs.begin(), xs.end(), 37) - xs.begin() == 37);
+        REQUIRE(std::distance(xs.begin(), xs.end()) == 100);
+    }
+}
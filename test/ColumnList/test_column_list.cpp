@@ -0,0 +1,113 @@
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/ColumnList.hpp"
+using gungnir::ColumnList;
+using gungnir::List;
+using gungnir::ListBuilder;
+
+namespace {
+
+struct Trade {
+    double px;
+    int qty;
+    std::string venue;
+};
+
+using Trades = ColumnList<double, int, std::string>;
+
+Trades makeTrades(int n)
+{
+    ListBuilder<Trade> buf;
+    for (int i = 0; i < n; ++i) {
+        buf.append(Trade{ i * 0.5, i % 7, i % 3 == 0 ? "XNYS" : "XNAS" });
+    }
+    return Trades::fromList(buf.result(),
+                            [](const Trade& t) { return t.px; },
+                            [](const Trade& t) { return t.qty; },
+                            [](const Trade& t) { return t.venue; });
+}
+
+}  // namespace
+
+TEST_CASE("test ColumnList", "[ColumnList]") {
+
+    using Row = Trades::Row;
+
+    SECTION("empty ColumnList") {
+        const Trades xs;
+        REQUIRE(xs.isEmpty());
+        REQUIRE(xs.size() == 0);
+        REQUIRE(xs.column<0>().isEmpty());
+        REQUIRE_THROWS_AS(xs[0], std::out_of_range);
+        REQUIRE(xs.count([](double, int, const std::string&) { return true; }) == 0);
+        REQUIRE(xs.toList().isEmpty());
+        REQUIRE(xs == Trades(std::vector<double>(), std::vector<int>(), std::vector<std::string>()));
+        REQUIRE(xs.take(3).isEmpty());
+    }
+    SECTION("construction from columns") {
+        const ColumnList<int, char> xs(std::vector<int> { 1, 2, 3 }, std::vector<char> { 'a', 'b', 'c' });
+        REQUIRE(xs.size() == 3);
+        REQUIRE((xs[1] == std::make_tuple(2, 'b')));
+        REQUIRE(xs.column<1>().toList() == List<char>('a', 'b', 'c'));
+        REQUIRE(xs.column<0>().sum() == 6);
+        REQUIRE_THROWS_AS((ColumnList<int, char>(std::vector<int> { 1 }, std::vector<char>())),
+                          std::invalid_argument);
+    }
+    SECTION("fromList stores each field contiguously") {
+        const auto xs = makeTrades(1000);
+        REQUIRE(xs.size() == 1000);
+        REQUIRE((xs[10] == Row(5.0, 3, "XNAS")));
+        const auto& px = xs.column<0>();
+        REQUIRE(px.data() + 999 == &px[999]);
+        REQUIRE(px.count([](double p) { return p >= 250.0; }) == 500);
+        REQUIRE(xs.column<1>().count(0) == 143);
+        REQUIRE(xs.column<2>().count(std::string("XNYS")) == 334);
+    }
+    SECTION("combinators") {
+        const auto xs = makeTrades(100);
+        REQUIRE(xs.count([](double px, int, const std::string&) { return px > 10; }) == 79);
+        REQUIRE(xs.exists([](double, int qty, const std::string&) { return qty == 6; }));
+        REQUIRE_FALSE(xs.exists([](double, int qty, const std::string&) { return qty == 7; }));
+        REQUIRE(xs.forall([](double px, int, const std::string&) { return px < 50; }));
+        REQUIRE(xs.foldLeft(0, [](int acc, double, int qty, const std::string&) { return acc + qty; }) ==
+                xs.column<1>().sum());
+
+        const auto notional = xs.map([](double px, int qty, const std::string&) { return px * qty; });
+        REQUIRE(notional.size() == 100);
+        REQUIRE(notional[9] == 4.5 * 2);
+
+        const auto nyse = xs.filter([](double, int, const std::string& v) { return v == "XNYS"; });
+        REQUIRE(nyse.size() == 34);
+        REQUIRE(nyse.column<2>().count(std::string("XNAS")) == 0);
+        REQUIRE((nyse[1] == Row(1.5, 3, "XNYS")));
+        REQUIRE(nyse == xs.filterBy<2>([](const std::string& v) { return v == "XNYS"; }));
+        REQUIRE(xs.filterNot([](double, int, const std::string& v) { return v == "XNYS"; }).size() == 66);
+        REQUIRE(xs.filter([](double, int, const std::string&) { return true; }) == xs);
+        REQUIRE(xs.filterBy<0>([](double px) { return px < 0; }).isEmpty());
+
+        std::size_t n = 0;
+        xs.foreach([&n](double px, int, const std::string&) { n += px == n * 0.5; });
+        REQUIRE(n == 100);
+    }
+    SECTION("slices share the columns") {
+        const auto xs = makeTrades(100);
+        const auto ys = xs.drop(10).take(20);
+        REQUIRE(ys.size() == 20);
+        REQUIRE(ys.column<0>().data() == xs.column<0>().data() + 10);
+        REQUIRE((ys[0] == xs[10]));
+        REQUIRE(xs.slice(90, 200).size() == 10);
+        REQUIRE(xs.slice(50, 40).isEmpty());
+        REQUIRE(ys != xs.slice(11, 31));
+        REQUIRE(ys == xs.slice(10, 30));
+
+        const auto rows = ys.toList();
+        REQUIRE(rows.size() == 20);
+        REQUIRE((rows.head() == Row(5.0, 3, "XNAS")));
+    }
+}
@@ -0,0 +1,145 @@
+#include <cstddef>
+#include <deque>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/Deque.hpp"
+using gungnir::Deque;
+using gungnir::List;
+
+namespace {
+
+template<typename A>
+bool matches(const Deque<A>& d, const std::deque<A>& model)
+{
+    std::vector<A> xs;
+    d.foreach([&xs](const A& x) { xs.push_back(x); });
+    return d.size() == model.size()
+        && xs.size() == model.size()
+        && std::equal(xs.begin(), xs.end(), model.begin());
+}
+
+}  // namespace
+
+TEST_CASE("test Deque", "[Deque]") {
+
+    using DI = Deque<int>;
+
+    SECTION("empty Deque") {
+        const DI d;
+        REQUIRE(d.isEmpty());
+        REQUIRE(d.size() == 0);
+        REQUIRE_THROWS_AS(d.head(), std::out_of_range);
+        REQUIRE_THROWS_AS(d.last(), std::out_of_range);
+        REQUIRE_THROWS_AS(d.tail(), std::out_of_range);
+        REQUIRE_THROWS_AS(d.init(), std::out_of_range);
+        REQUIRE(d.toList().isEmpty());
+    }
+    SECTION("both ends") {
+        const auto d = DI().appended(2).prepend(1).appended(3);
+        REQUIRE(d.toList() == List<int>(1, 2, 3));
+        REQUIRE(d.head() == 1);
+        REQUIRE(d.last() == 3);
+        REQUIRE((d.tail() == DI{2, 3}));
+        REQUIRE((d.init() == DI{1, 2}));
+        REQUIRE(d.tail().init() == DI{2});
+        REQUIRE(DI{1}.init().isEmpty());
+        REQUIRE(DI{1}.tail().isEmpty());
+        REQUIRE(DI(List<int>(1, 2, 3)) == d);
+        REQUIRE(d != d.tail());
+        REQUIRE((Deque<std::string>{"a", "b"}.prepend("z").last() == "b"));
+    }
+    SECTION("one end drains the other") {
+        DI d;
+        for (int i = 0; i < 1000; ++i) {
+            d = d.prepend(i);
+        }
+        const auto start = d;
+        bool same = true;
+        for (int i = 0; i < 1000; ++i) {
+            same = same && d.last() == i;
+            d = d.init().prepend(d.last());
+        }
+        REQUIRE(d == start);
+        for (int i = 0; i < 1000; ++i) {
+            same = same && d.head() == 999 - i;
+            d = d.tail().appended(d.head());
+        }
+        REQUIRE(d == start);
+        REQUIRE(same);
+        for (int i = 0; i < 1000; ++i) {
+            d = d.init();
+        }
+        REQUIRE(d.isEmpty());
+    }
+    SECTION("random operations on random versions match std::deque") {
+        std::mt19937 rng(7);
+        std::vector<DI> versions(1);
+        std::vector<std::deque<int>> models(1);
+        bool same = true;
+        for (int i = 0; i < 20000; ++i) {
+            const auto k = rng() % versions.size();
+            auto d = versions[k];
+            auto model = models[k];
+            switch (model.empty() ? rng() % 2 : rng() % 4) {
+            case 0:
+                d = d.prepend(i);
+                model.push_front(i);
+                break;
+            case 1:
+                d = d.appended(i);
+                model.push_back(i);
+                break;
+            case 2:
+                same = same && d.head() == model.front();
+                d = d.tail();
+                model.pop_front();
+                break;
+            default:
+                same = same && d.last() == model.back();
+                d = d.init();
+                model.pop_back();
+                break;
+            }
+            if (versions.size() < 64) {
+                versions.push_back(d);
+                models.push_back(model);
+            } else {
+                versions[k] = d;
+                models[k] = model;
+            }
+        }
+        REQUIRE(same);
+        for (std::size_t k = 0; k < versions.size(); ++k) {
+            REQUIRE(matches(versions[k], models[k]));
+        }
+    }
+    SECTION("shared across threads") {
+        DI d;
+        for (int i = 0; i < 10000; ++i) {
+            d = d.appended(i);
+        }
+        std::vector<std::thread> threads;
+        std::vector<long> sums(4);
+        for (std::size_t t = 0; t < sums.size(); ++t) {
+            threads.emplace_back([d, t, &sums] {
+                auto e = d;
+                while (!e.isEmpty()) {
+                    sums[t] += t % 2 == 0 ? e.head() : e.last();
+                    e = t % 2 == 0 ? e.tail() : e.init();
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (auto s : sums) {
+            REQUIRE(s == 49995000L);
+        }
+    }
+}
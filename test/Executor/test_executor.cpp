@@ -0,0 +1,127 @@
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/Executor.hpp"
+#include "gungnir/List.hpp"
+using gungnir::Executor;
+using gungnir::List;
+using gungnir::ListBuilder;
+using gungnir::ParallelPolicy;
+
+TEST_CASE("test Executor", "[Executor]") {
+
+    SECTION("parallelFor calls every index exactly once") {
+        for (std::size_t threads : {0, 1, 3}) {
+            Executor ex(threads);
+            REQUIRE(ex.concurrency() == threads + 1);
+
+            std::vector<std::atomic<int>> hits(1000);
+            for (auto& h : hits) {
+                h = 0;
+            }
+            ex.parallelFor(hits.size(), [&hits](std::size_t i) { ++hits[i]; });
+            for (auto& h : hits) {
+                REQUIRE(h == 1);
+            }
+            ex.parallelFor(0, [](std::size_t) { FAIL(); });
+        }
+    }
+    SECTION("tasks run on worker threads") {
+        Executor ex(3);
+        std::atomic<int> others(0);
+        const auto caller = std::this_thread::get_id();
+        ex.parallelFor(64, [&](std::size_t) {
+            if (std::this_thread::get_id() != caller) {
+                ++others;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+        REQUIRE(others > 0);
+    }
+    SECTION("nested parallelFor") {
+        Executor ex(3);
+        std::atomic<int> sum(0);
+        ex.parallelFor(16, [&](std::size_t i) {
+            ex.parallelFor(16, [&](std::size_t j) { sum += static_cast<int>(i * j); });
+        });
+        REQUIRE(sum == 120 * 120);
+    }
+    SECTION("exceptions are rethrown after all calls finish") {
+        Executor ex(3);
+        std::atomic<int> calls(0);
+        REQUIRE_THROWS_AS(ex.parallelFor(100, [&calls](std::size_t i) {
+            ++calls;
+            if (i % 10 == 3) {
+                throw std::runtime_error("bad");
+            }
+        }), std::runtime_error);
+        REQUIRE(calls == 100);
+    }
+    SECTION("concurrent submitters") {
+        Executor ex(2);
+        std::atomic<int> sum(0);
+        std::vector<std::thread> submitters;
+        for (int t = 0; t < 4; ++t) {
+            submitters.emplace_back([&] {
+                for (int k = 0; k < 20; ++k) {
+                    ex.parallelFor(10, [&sum](std::size_t i) { sum += static_cast<int>(i); });
+                }
+            });
+        }
+        for (auto& t : submitters) {
+            t.join();
+        }
+        REQUIRE(sum == 4 * 20 * 45);
+    }
+    SECTION("posted tasks") {
+        for (std::size_t threads : {0, 2}) {
+            std::atomic<int> calls(0);
+            {
+                Executor ex(threads);
+                for (int k = 0; k < 100; ++k) {
+                    ex.post([&calls] { ++calls; });
+                }
+                ex.post([] { throw std::runtime_error("ignored"); });
+            }
+            // Workers run the queued tasks before they return.
+            REQUIRE(calls == 100);
+        }
+    }
+    SECTION("workers running on host threads") {
+        std::vector<std::thread> host;
+        {
+            Executor ex(2, [&host](Executor::Worker w) { host.emplace_back(w); });
+            REQUIRE(host.size() == 2);
+            std::atomic<int> sum(0);
+            ex.parallelFor(100, [&sum](std::size_t i) { sum += static_cast<int>(i); });
+            REQUIRE(sum == 4950);
+        }
+        // Every worker has returned once the executor is destroyed.
+        for (auto& t : host) {
+            t.join();
+        }
+    }
+    SECTION("parallel List algorithms on a given executor") {
+        Executor ex(3);
+        const auto policy = ParallelPolicy(16).on(ex);
+        REQUIRE(&policy.executor() == &ex);
+        REQUIRE(&gungnir::par.executor() == &Executor::global());
+
+        ListBuilder<int> buf;
+        for (int i = 0; i < 1000; ++i) {
+            buf.append(999 - i);
+        }
+        const auto xs = buf.result();
+        const auto twice = [](int x) { return x * 2; };
+        REQUIRE(xs.map(policy, twice) == xs.map(twice));
+        REQUIRE(xs.filter(policy, [](int x) { return x < 10; }).size() == 10);
+        REQUIRE(xs.sorted(policy) == xs.reverse());
+        REQUIRE(xs.foldLeft(policy, 0, [](int a, int x) { return a + x; },
+                                      [](int a, int b) { return a + b; }) == 499500);
+    }
+}
@@ -0,0 +1,191 @@
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/Future.hpp"
+using gungnir::Executor;
+using gungnir::Future;
+using gungnir::List;
+using gungnir::Promise;
+using gungnir::async;
+using gungnir::sequence;
+using gungnir::traverse;
+
+namespace {
+
+std::string messageOf(const std::exception_ptr& e)
+{
+    try {
+        std::rethrow_exception(e);
+    } catch (const std::exception& ex) {
+        return ex.what();
+    }
+}
+
+}  // namespace
+
+TEST_CASE("test Future", "[Future]") {
+
+    using FI = Future<int>;
+
+    const auto inc = [](int x) { return x + 1; };
+    const auto fail = [](int) -> int { throw std::runtime_error("boom"); };
+
+    SECTION("promises complete their futures once") {
+        Promise<int> p;
+        const auto f = p.future();
+        REQUIRE_FALSE(f.isReady());
+        p.success(42);
+        REQUIRE(f.isReady());
+        REQUIRE(f.get() == 42);
+        REQUIRE_FALSE(p.trySuccess(43));
+        REQUIRE_FALSE(p.tryFailure(std::make_exception_ptr(std::runtime_error("late"))));
+        REQUIRE_THROWS_AS(p.success(44), std::logic_error);
+        REQUIRE(f.get() == 42);
+    }
+    SECTION("successful and failed futures") {
+        REQUIRE(FI::successful(1).get() == 1);
+        const auto f = FI::failed(std::make_exception_ptr(std::runtime_error("boom")));
+        REQUIRE(f.isReady());
+        REQUIRE_THROWS_AS(f.get(), std::runtime_error);
+    }
+    SECTION("broken promises fail their futures") {
+        auto p = std::unique_ptr<Promise<int>>(new Promise<int>);
+        const auto f = p->future();
+        p.reset();
+        REQUIRE_THROWS_AS(f.get(), std::runtime_error);
+    }
+    SECTION("combinators before and after completion") {
+        Promise<int> p;
+        const auto pending = p.future();
+        const auto mapped = pending.map(inc).map([](int x) { return std::to_string(x); });
+        const auto kept = pending.filter([](int x) { return x > 0; });
+        const auto dropped = pending.filter([](int x) { return x < 0; });
+        const auto chained = pending.flatMap([inc](int x) { return FI::successful(x * 10).map(inc); });
+        REQUIRE_FALSE(mapped.isReady());
+        p.success(4);
+
+        REQUIRE(mapped.get() == "5");
+        REQUIRE(kept.get() == 4);
+        REQUIRE_THROWS_AS(dropped.get(), std::out_of_range);
+        REQUIRE(chained.get() == 41);
+        REQUIRE(pending.map(inc).get() == 5);
+        REQUIRE(pending.flatMap([](int x) { return FI::successful(-x); }).get() == -4);
+    }
+    SECTION("flatMap waits for the inner future") {
+        Promise<int> outer;
+        Promise<std::string> inner;
+        const auto innerFuture = inner.future();
+        const auto f = outer.future().flatMap([innerFuture](int) { return innerFuture; });
+        outer.success(1);
+        REQUIRE_FALSE(f.isReady());
+        inner.success("done");
+        REQUIRE(f.get() == "done");
+    }
+    SECTION("failures propagate until recovered") {
+        Promise<int> p;
+        const auto f = p.future().map(fail).map(inc).filter([](int) { return true; });
+        const auto r = f.recover([](const std::exception_ptr& e) {
+            return static_cast<int>(messageOf(e).size());
+        });
+        const auto rethrown = f.recover([](const std::exception_ptr& e) -> int {
+            std::rethrow_exception(e);
+        });
+        p.success(1);
+        REQUIRE_THROWS_AS(f.get(), std::runtime_error);
+        REQUIRE(r.get() == 4);
+        REQUIRE_THROWS_AS(rethrown.get(), std::runtime_error);
+        REQUIRE(FI::successful(7).recover([](const std::exception_ptr&) { return 0; }).get() == 7);
+    }
+    SECTION("zip") {
+        Promise<int> a;
+        Promise<std::string> b;
+        const auto z = a.future().zip(b.future());
+        b.success("x");
+        REQUIRE_FALSE(z.isReady());
+        a.success(1);
+        REQUIRE((z.get() == std::make_pair(1, std::string("x"))));
+
+        Promise<int> c;
+        const auto failed = c.future().zip(FI::failed(std::make_exception_ptr(std::runtime_error("boom"))));
+        REQUIRE(failed.isReady());
+        REQUIRE_THROWS_AS(failed.get(), std::runtime_error);
+        c.success(1);
+
+        const auto same = FI::successful(2).zip(FI::successful(3));
+        REQUIRE((same.get() == std::make_pair(2, 3)));
+    }
+    SECTION("sequence and traverse") {
+        REQUIRE(sequence(List<FI>()).get().isEmpty());
+
+        std::vector<Promise<int>> ps(3);
+        const auto s = sequence(List<FI>(ps[0].future(), ps[1].future(), ps[2].future()));
+        ps[2].success(3);
+        ps[0].success(1);
+        REQUIRE_FALSE(s.isReady());
+        ps[1].success(2);
+        REQUIRE(s.get() == List<int>(1, 2, 3));
+
+        const auto t = traverse(List<int>(1, 2, 3), [inc](int x) { return FI::successful(x).map(inc); });
+        REQUIRE(t.get() == List<int>(2, 3, 4));
+
+        Promise<int> never;
+        const auto f = sequence(List<FI>(never.future(), FI::successful(1).map(fail)));
+        REQUIRE_THROWS_AS(f.get(), std::runtime_error);
+        never.success(0);
+    }
+    SECTION("async runs on the executor") {
+        for (std::size_t threads : {0, 1, 4}) {
+            Executor ex(threads);
+            const auto caller = std::this_thread::get_id();
+            const auto f = async(ex, [] { return std::this_thread::get_id(); });
+            REQUIRE((f.get() != caller) == (threads > 0));
+            REQUIRE_THROWS_AS(async(ex, [] () -> int { throw std::runtime_error("boom"); }).get(),
+                              std::runtime_error);
+        }
+    }
+    SECTION("many concurrent calls") {
+        Executor ex(4);
+        const int n = 2000;
+        std::atomic<int> calls(0);
+        gungnir::ListBuilder<int> buf;
+        for (int i = 0; i < n; ++i) {
+            buf.append(i);
+        }
+        const auto f = traverse(buf.result(), [&ex, &calls](int i) {
+            return async(ex, [&calls, i] {
+                ++calls;
+                return i;
+            }).map([](int x) { return x * 2; }).flatMap([&ex](int x) {
+                return async(ex, [x] { return x + 1; });
+            });
+        });
+        const auto xs = f.get();
+        REQUIRE(calls == n);
+        REQUIRE(xs.size() == n);
+        REQUIRE(xs.foldLeft(0L, [](long a, int x) { return a + x; }) == long(n) * n);
+    }
+    SECTION("completion races with registration") {
+        for (int i = 0; i < 200; ++i) {
+            Promise<int> p;
+            const auto f = p.future();
+            std::vector<Future<int>> derived;
+            std::thread t([&p, i] { p.success(i); });
+            for (int k = 0; k < 8; ++k) {
+                derived.push_back(f.map([k](int x) { return x + k; }));
+            }
+            t.join();
+            for (int k = 0; k < 8; ++k) {
+                REQUIRE(derived[k].get() == i + k);
+            }
+        }
+    }
+}
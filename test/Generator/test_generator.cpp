@@ -0,0 +1,161 @@
+#include "gungnir/Generator.hpp"
+
+#if GUNGNIR_HAS_COROUTINES
+
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+using gungnir::Generator;
+using gungnir::List;
+using gungnir::elementsOf;
+
+namespace {
+
+Generator<int> range(int from, int until)
+{
+    for (auto i = from; i < until; ++i) {
+        co_yield i;
+    }
+}
+
+// Yields the elements of `pages` pages of `size` elements each, fetching
+// each page only once the previous one has been consumed.
+Generator<int> paged(int pages, int size, int& fetched)
+{
+    for (auto p = 0; p < pages; ++p) {
+        ++fetched;
+        co_yield elementsOf(range(p * size, (p + 1) * size));
+    }
+}
+
+Generator<int> nested(int depth)
+{
+    co_yield depth;
+    if (depth > 0) {
+        co_yield elementsOf(nested(depth - 1));
+    }
+    co_yield -depth;
+}
+
+Generator<std::string> words(std::istream& in)
+{
+    std::string w;
+    while (in >> w) {
+        co_yield w;
+    }
+}
+
+Generator<int> failing(int n)
+{
+    for (auto i = 0; i < n; ++i) {
+        co_yield i;
+    }
+    throw std::runtime_error("read failed");
+}
+
+}  // namespace
+
+TEST_CASE("test Generator", "[Generator]") {
+
+    const auto plus = [](int a, int x) { return a + x; };
+
+    SECTION("empty generators") {
+        Generator<int> g;
+        REQUIRE(g.begin() == g.end());
+        REQUIRE(range(3, 3).toList().isEmpty());
+    }
+    SECTION("iteration, foreach, foldLeft and toList") {
+        auto g = range(0, 4);
+        std::vector<int> v(g.begin(), g.end());
+        REQUIRE((v == std::vector<int>{0, 1, 2, 3}));
+
+        int sum = 0;
+        range(0, 5).foreach([&sum](int x) { sum += x; });
+        REQUIRE(sum == 10);
+        REQUIRE(range(1, 101).foldLeft(0, plus) == 5050);
+        REQUIRE(range(1, 4).toList() == List<int>(1, 2, 3));
+    }
+    SECTION("bodies run only as elements are requested") {
+        int fetched = 0;
+        auto g = paged(3, 2, fetched);
+        REQUIRE(fetched == 0);
+        auto it = g.begin();
+        REQUIRE(*it == 0);
+        REQUIRE(fetched == 1);
+        ++it;
+        ++it;
+        REQUIRE(*it == 2);
+        REQUIRE(fetched == 2);
+        REQUIRE(std::vector<int>(it, g.end()) == (std::vector<int>{2, 3, 4, 5}));
+        REQUIRE(fetched == 3);
+    }
+    SECTION("yielded lvalues are not copied") {
+        std::istringstream in("to be or not to be");
+        auto g = words(in);
+        auto it = g.begin();
+        const auto p = &*it;
+        ++it;
+        REQUIRE(&*it == p);
+        REQUIRE(*it == "be");
+    }
+    SECTION("nested generators") {
+        REQUIRE(nested(2).toList() == List<int>(2, 1, 0, 0, -1, -2));
+        REQUIRE(nested(10000).foldLeft(std::size_t(0), [](std::size_t n, int) {
+            return n + 1;
+        }) == 20002);
+    }
+    SECTION("views") {
+        const auto xs = range(0, 1000000).view()
+            .map([](int x) { return x * 3; })
+            .filter([](int x) { return x % 2 == 0; })
+            .take(4)
+            .toList();
+        REQUIRE(xs == List<int>(0, 6, 12, 18));
+
+        int fetched = 0;
+        REQUIRE(paged(1000, 10, fetched).view().exists([](int x) { return x == 25; }));
+        REQUIRE(fetched == 3);
+    }
+    SECTION("streams") {
+        int fetched = 0;
+        const auto s = paged(3, 2, fetched).toStream();
+        REQUIRE(fetched == 1);
+        REQUIRE(s.drop(2).head() == 2);
+        REQUIRE(fetched == 2);
+        REQUIRE(s.toList() == List<int>(0, 1, 2, 3, 4, 5));
+        REQUIRE(s.foldLeft(0, plus) == 15);
+    }
+    SECTION("exceptions propagate to the consumer") {
+        auto g = failing(2);
+        auto it = g.begin();
+        REQUIRE(*it == 0);
+        ++it;
+        REQUIRE_THROWS_AS(++it, std::runtime_error);
+
+        auto outer = [](int n) -> Generator<int> {
+            co_yield -1;
+            co_yield elementsOf(failing(n));
+            co_yield -2;
+        };
+        std::vector<int> seen;
+        REQUIRE_THROWS_AS(outer(3).foreach([&seen](int x) { seen.push_back(x); }), std::runtime_error);
+        REQUIRE((seen == std::vector<int>{-1, 0, 1, 2}));
+    }
+    SECTION("abandoned generators free their frames") {
+        int fetched = 0;
+        for (auto i = 0; i < 1000; ++i) {
+            auto g = paged(10, 10, fetched);
+            auto it = g.begin();
+            ++it;
+        }
+        REQUIRE(fetched == 1000);
+    }
+}
+
+#endif  // GUNGNIR_HAS_COROUTINES
@@ -0,0 +1,202 @@
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/HashMap.hpp"
+using gungnir::HashMap;
+using gungnir::TransientHashMap;
+
+namespace {
+
+// Hashes all keys to one of a few values, so that they collide.
+struct BadHash {
+    std::size_t operator()(int x) const
+    {
+        return static_cast<std::size_t>(x % 3);
+    }
+};
+
+template<typename M, typename K, typename V>
+bool matches(const M& m, const std::unordered_map<K, V>& expected)
+{
+    if (m.size() != expected.size()) {
+        return false;
+    }
+    for (const auto& e : expected) {
+        const auto v = m.get(e.first);
+        if (v.isEmpty() || v.get() != e.second) {
+            return false;
+        }
+    }
+    return m.forall([&expected](const std::pair<const K, V>& e) {
+        return expected.count(e.first) == 1;
+    });
+}
+
+}  // namespace
+
+TEST_CASE("test HashMap", "[HashMap]") {
+
+    using MIS = HashMap<int, std::string>;
+
+    SECTION("empty HashMap") {
+        const MIS m;
+        REQUIRE(m.isEmpty());
+        REQUIRE(m.size() == 0);
+        REQUIRE_FALSE(m.contains(1));
+        REQUIRE(m.get(1).isEmpty());
+        REQUIRE_THROWS_AS(m[1], std::out_of_range);
+        REQUIRE(m.removed(1).isEmpty());
+        REQUIRE(m == MIS());
+    }
+    SECTION("constructors") {
+        const MIS m { {1, "one"}, {2, "two"}, {1, "uno"} };
+        REQUIRE(m.size() == 2);
+        REQUIRE(m[1] == "uno");
+        REQUIRE(m[2] == "two");
+
+        const std::vector<std::pair<const int, std::string>> v { {3, "three"}, {4, "four"} };
+        const MIS n(v.begin(), v.end());
+        REQUIRE(n.size() == 2);
+        REQUIRE(n[4] == "four");
+    }
+    SECTION("updated and removed are persistent") {
+        const MIS m1;
+        const auto m2 = m1.updated(1, "one");
+        const auto m3 = m2.updated(2, 3, 'x');
+        const auto m4 = m3.updated(1, "uno");
+        const auto m5 = m4.removed(2);
+        REQUIRE(m1.isEmpty());
+        REQUIRE(m2.size() == 1);
+        REQUIRE(m2[1] == "one");
+        REQUIRE(m3.size() == 2);
+        REQUIRE(m3[2] == "xxx");
+        REQUIRE(m4.size() == 2);
+        REQUIRE(m4[1] == "uno");
+        REQUIRE(m3[1] == "one");
+        REQUIRE(m5.size() == 1);
+        REQUIRE_FALSE(m5.contains(2));
+        REQUIRE(m4.contains(2));
+        REQUIRE(m5.removed(3) == m5);
+    }
+    SECTION("many entries against std::unordered_map") {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> key(0, 5000);
+        std::unordered_map<int, int> expected;
+        HashMap<int, int> m;
+        std::vector<std::pair<HashMap<int, int>, std::unordered_map<int, int>>> snapshots;
+        for (int i = 0; i < 20000; ++i) {
+            const auto k = key(rng);
+            if (i % 3 == 0) {
+                m = m.removed(k);
+                expected.erase(k);
+            } else {
+                m = m.updated(k, i);
+                expected[k] = i;
+            }
+            if (i % 4000 == 0) {
+                snapshots.emplace_back(m, expected);
+            }
+        }
+        REQUIRE(matches(m, expected));
+        for (const auto& s : snapshots) {
+            REQUIRE(matches(s.first, s.second));
+        }
+    }
+    SECTION("colliding hashes") {
+        using MB = HashMap<int, int, BadHash>;
+        MB m;
+        std::unordered_map<int, int> expected;
+        for (int i = 0; i < 100; ++i) {
+            m = m.updated(i, i * 10);
+            expected[i] = i * 10;
+        }
+        REQUIRE(matches(m, expected));
+        for (int i = 0; i < 100; i += 2) {
+            m = m.removed(i);
+            expected.erase(i);
+        }
+        REQUIRE(matches(m, expected));
+        REQUIRE(matches(m.filter([](const std::pair<const int, int>& e) { return e.first % 3 == 1; }),
+                        std::unordered_map<int, int> {
+                            {1, 10}, {7, 70}, {13, 130}, {19, 190}, {25, 250}, {31, 310},
+                            {37, 370}, {43, 430}, {49, 490}, {55, 550}, {61, 610}, {67, 670},
+                            {73, 730}, {79, 790}, {85, 850}, {91, 910}, {97, 970} }));
+        for (int i = 1; i < 100; i += 2) {
+            m = m.removed(i);
+        }
+        REQUIRE(m.isEmpty());
+    }
+    SECTION("map, filter and folds") {
+        HashMap<int, int> m;
+        for (int i = 0; i < 1000; ++i) {
+            m = m.updated(i, i);
+        }
+
+        const auto s = m.map([](const std::pair<const int, int>& e) {
+            return std::to_string(e.second * 2);
+        });
+        REQUIRE(s.size() == 1000);
+        REQUIRE(s[123] == "246");
+
+        const auto evens = m.filter([](const std::pair<const int, int>& e) { return e.first % 2 == 0; });
+        const auto odds = m.filterNot([](const std::pair<const int, int>& e) { return e.first % 2 == 0; });
+        REQUIRE(evens.size() == 500);
+        REQUIRE(odds.size() == 500);
+        REQUIRE(evens.contains(998));
+        REQUIRE_FALSE(evens.contains(999));
+        REQUIRE(odds.contains(999));
+        REQUIRE(m.filter([](const std::pair<const int, int>&) { return true; }) == m);
+        REQUIRE(m.filter([](const std::pair<const int, int>&) { return false; }).isEmpty());
+
+        auto rebuilt = evens;
+        odds.foreach([&rebuilt](const std::pair<const int, int>& e) {
+            rebuilt = rebuilt.updated(e.first, e.second);
+        });
+        REQUIRE(rebuilt == m);
+        REQUIRE(rebuilt != evens);
+
+        const auto sum = m.foldLeft(0L, [](long acc, const std::pair<const int, int>& e) {
+            return acc + e.second;
+        });
+        REQUIRE(sum == 999L * 1000 / 2);
+        REQUIRE(m.count([](const std::pair<const int, int>& e) { return e.second < 10; }) == 10);
+        REQUIRE(m.exists([](const std::pair<const int, int>& e) { return e.second == 500; }));
+        REQUIRE_FALSE(m.exists([](const std::pair<const int, int>& e) { return e.second == 1000; }));
+        REQUIRE(m.forall([](const std::pair<const int, int>& e) { return e.second >= 0; }));
+    }
+    SECTION("transient") {
+        TransientHashMap<int, int> t;
+        std::unordered_map<int, int> expected;
+        for (int i = 0; i < 20000; ++i) {
+            t.update(i % 7000, i);
+            expected[i % 7000] = i;
+        }
+        for (int i = 0; i < 7000; i += 5) {
+            t.remove(i);
+            expected.erase(i);
+        }
+        t.remove(-1);
+        REQUIRE(t.size() == expected.size());
+        REQUIRE(t.contains(1));
+        REQUIRE_FALSE(t.contains(0));
+        REQUIRE(t.get(1).get() == 14001);
+        const auto m = t.persistent();
+        REQUIRE(t.size() == 0);
+        REQUIRE(matches(m, expected));
+
+        auto u = m.asTransient();
+        u.update(1, -1).remove(2);
+        const auto n = u.persistent();
+        REQUIRE(matches(m, expected));
+        REQUIRE(n[1] == -1);
+        REQUIRE_FALSE(n.contains(2));
+        REQUIRE(n.size() == m.size() - 1);
+    }
+}
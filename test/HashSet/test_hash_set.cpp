@@ -0,0 +1,71 @@
+#include <cstddef>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/HashSet.hpp"
+using gungnir::HashSet;
+
+TEST_CASE("test HashSet", "[HashSet]") {
+
+    using SI = HashSet<int>;
+
+    SECTION("empty HashSet") {
+        const SI s;
+        REQUIRE(s.isEmpty());
+        REQUIRE(s.size() == 0);
+        REQUIRE_FALSE(s.contains(0));
+        REQUIRE(s.removed(0).isEmpty());
+    }
+    SECTION("constructors") {
+        const SI s { 1, 2, 3, 2, 1 };
+        REQUIRE(s.size() == 3);
+        REQUIRE(s.contains(3));
+
+        const std::vector<std::string> v { "a", "b", "a" };
+        const HashSet<std::string> t(v.begin(), v.end());
+        REQUIRE(t.size() == 2);
+        REQUIRE(t.contains("b"));
+    }
+    SECTION("added and removed are persistent") {
+        SI s;
+        std::vector<SI> versions;
+        for (int i = 0; i < 3000; ++i) {
+            versions.push_back(s);
+            s = s.added(i * 7919);
+        }
+        REQUIRE(s.size() == 3000);
+        REQUIRE(s.added(0) == s);
+        for (std::size_t i = 0; i < versions.size(); i += 500) {
+            REQUIRE(versions[i].size() == i);
+            REQUIRE(versions[i].contains(static_cast<int>(i - 1) * 7919) == (i > 0));
+            REQUIRE_FALSE(versions[i].contains(static_cast<int>(i) * 7919));
+        }
+
+        auto t = s;
+        for (int i = 0; i < 3000; i += 3) {
+            t = t.removed(i * 7919);
+        }
+        REQUIRE(t.size() == 2000);
+        REQUIRE(s.size() == 3000);
+        REQUIRE(t.forall([](int x) { return (x / 7919) % 3 != 0; }));
+        REQUIRE(t != s);
+    }
+    SECTION("map, filter and folds") {
+        const SI s { 1, 2, 3, 4, 5, 6 };
+        REQUIRE(s.map([](int x) { return x / 2; }) == SI({ 0, 1, 2, 3 }));
+        REQUIRE(s.map([](int x) { return std::to_string(x); }).contains("6"));
+        REQUIRE(s.filter([](int x) { return x % 2 == 0; }) == SI({ 2, 4, 6 }));
+        REQUIRE(s.filterNot([](int x) { return x % 2 == 0; }) == SI({ 1, 3, 5 }));
+        REQUIRE(s.foldLeft(0, [](int acc, int x) { return acc + x; }) == 21);
+        REQUIRE(s.count([](int x) { return x > 4; }) == 2);
+        REQUIRE(s.exists([](int x) { return x == 6; }));
+        REQUIRE_FALSE(s.forall([](int x) { return x < 6; }));
+
+        std::set<int> seen;
+        s.foreach([&seen](int x) { seen.insert(x); });
+        REQUIRE(seen == (std::set<int> { 1, 2, 3, 4, 5, 6 }));
+    }
+}
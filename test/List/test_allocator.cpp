@@ -0,0 +1,119 @@
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+
+namespace {
+
+struct Arena {
+    std::size_t allocated = 0;
+    std::size_t deallocated = 0;
+};
+
+template<typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena* arena) noexcept : arena(arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& that) noexcept : arena(that.arena) {}
+
+    T* allocate(std::size_t n)
+    {
+        ++arena->allocated;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        ++arena->deallocated;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    Arena* arena;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& x, const ArenaAllocator<U>& y)
+{
+    return x.arena == y.arena;
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& x, const ArenaAllocator<U>& y)
+{
+    return x.arena != y.arena;
+}
+
+}  // namespace
+
+TEST_CASE("test List allocator", "[List][allocator]") {
+
+    using AI = ArenaAllocator<int>;
+    using LI = List<int, AI>;
+
+    SECTION("default allocator takes no space") {
+        REQUIRE(sizeof (List<int>) == sizeof (std::size_t) + sizeof (void*));
+    }
+    SECTION("empty List") {
+        Arena arena;
+        {
+            const LI xs{AI(&arena)};
+            REQUIRE(xs.isEmpty());
+            REQUIRE(xs.allocator().arena == &arena);
+        }
+        REQUIRE(arena.allocated == 0);
+    }
+    SECTION("nodes are allocated from the allocator") {
+        Arena arena;
+        {
+            const auto xs = LI(AI(&arena)).prepend(3).prepend(2).prepend(1);
+            REQUIRE(arena.allocated == 3);
+            REQUIRE(xs.size() == 3);
+            REQUIRE(xs.head() == 1);
+
+            const auto ys = xs.filter([](int x) { return x != 2; });
+            REQUIRE(arena.allocated == 5);
+            REQUIRE(ys.allocator().arena == &arena);
+
+            const auto zs = xs.tail().drop(1);
+            REQUIRE(arena.allocated == 5);
+            REQUIRE(zs.allocator().arena == &arena);
+            REQUIRE(zs.head() == 3);
+        }
+        REQUIRE(arena.deallocated == arena.allocated);
+    }
+    SECTION("range constructor") {
+        Arena arena;
+        {
+            const std::vector<int> v{1, 2, 3, 4};
+            const LI xs(v.begin(), v.end(), AI(&arena));
+            REQUIRE(arena.allocated == 4);
+            REQUIRE(xs.size() == 4);
+            REQUIRE(xs[3] == 4);
+        }
+        REQUIRE(arena.deallocated == 4);
+    }
+    SECTION("allocator is rebound for other element types") {
+        Arena arena;
+        {
+            const std::vector<int> v{1, 2, 3};
+            const LI xs(v.begin(), v.end(), AI(&arena));
+            const auto ys = xs.map([](int x) { return x * 0.5; });
+            REQUIRE(ys.allocator().arena == &arena);
+            REQUIRE(ys[2] == 1.5);
+            REQUIRE(arena.allocated == 6);
+
+            const auto zs = xs.zip(ys);
+            REQUIRE(zs.allocator().arena == &arena);
+            REQUIRE(zs[1].second == 1.0);
+            REQUIRE(arena.allocated == 9);
+        }
+        REQUIRE(arena.deallocated == arena.allocated);
+    }
+}
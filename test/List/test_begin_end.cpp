@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <iterator>
 #include <memory>
 #include <type_traits>
@@ -71,4 +72,28 @@ TEST_CASE("test List begin and end", "[List][begin][end]") {
         REQUIRE(v4 == v5);
         REQUIRE(v4 == v6);
     }
+    SECTION("end is a sentinel") {
+        REQUIRE((std::is_same<std::forward_iterator_tag, IT::iterator_category>::value));
+        REQUIRE((std::is_same<std::ptrdiff_t, IT::difference_type>::value));
+
+        const List<int> xs(1, 2, 3), ys(xs.tail());
+        REQUIRE(List<int>::StdIterator() == xs.end());
+        REQUIRE(xs.end() == ys.end());
+        auto it = xs.begin();
+        std::advance(it, 3);
+        REQUIRE(it == xs.end());
+        REQUIRE(it == List<int>().begin());
+        REQUIRE(++xs.begin() == ys.begin());
+        REQUIRE(xs.begin() != ys.begin());
+    }
+    SECTION("positions sharing an element are distinct") {
+        const List<int> xs(1, 2);
+        const auto ys = xs.concat(xs);
+        const auto b = ys.begin();
+        REQUIRE(std::next(b, 2) != b);
+        REQUIRE(*std::next(b, 2) == *b);
+        REQUIRE(std::next(b, 4) == ys.end());
+        REQUIRE(std::distance(b, std::next(b, 3)) == 3);
+        REQUIRE(std::distance(b, ys.end()) == 4);
+    }
 }
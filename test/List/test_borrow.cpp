@@ -0,0 +1,83 @@
+#include <stdexcept>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+using gungnir::ListRef;
+using gungnir::listStats;
+
+namespace {
+
+// Sums the elements of a list in recursive style.
+long sum(ListRef<int> xs)
+{
+    long s = 0;
+    for (; !xs.isEmpty(); xs = xs.tail()) {
+        s += xs.head();
+    }
+    return s;
+}
+
+}  // namespace
+
+TEST_CASE("test List borrow", "[List][borrow]") {
+
+    using LI = List<int>;
+
+    SECTION("empty List") {
+        const LI xs;
+        const auto r = xs.borrow();
+        REQUIRE(r.isEmpty());
+        REQUIRE(r.size() == 0);
+        REQUIRE_THROWS_AS(r.head(), std::out_of_range);
+        REQUIRE_THROWS_AS(r.tail(), std::out_of_range);
+        REQUIRE_THROWS_AS(r.uncons(), std::out_of_range);
+        REQUIRE(r.drop(3).isEmpty());
+        REQUIRE(r.toList().isEmpty());
+    }
+    SECTION("walking a List") {
+        const LI xs(1, 2, 3, 4, 5);
+        const auto r = xs.borrow();
+        REQUIRE(r.size() == 5);
+        REQUIRE(&r.head() == &xs.head());
+        REQUIRE(r.tail().tail().head() == 3);
+        REQUIRE(&r.tail().head() == &xs.tail().head());
+        REQUIRE(sum(r) == 15);
+
+        const auto p = r.uncons();
+        REQUIRE(p.first.get() == 1);
+        REQUIRE(p.second.size() == 4);
+
+        REQUIRE(r.drop(2).head() == 3);
+        REQUIRE(r.drop(2).size() == 3);
+        REQUIRE(r.drop(10).isEmpty());
+        REQUIRE(r.dropWhile([](int x) { return x < 4; }).size() == 2);
+        REQUIRE(r.dropWhile([](int) { return true; }).isEmpty());
+
+        std::vector<int> seen;
+        r.tail().foreach([&seen](int x) { seen.push_back(x); });
+        REQUIRE(seen == (std::vector<int> { 2, 3, 4, 5 }));
+    }
+    SECTION("promoting to a List") {
+        LI ys;
+        {
+            const LI xs(1, 2, 3);
+            ys = xs.borrow().tail().toList();
+            REQUIRE(&ys.head() == &xs.tail().head());
+        }
+        REQUIRE(ys == LI(2, 3));
+        REQUIRE(ys.last() == 3);
+        REQUIRE(ys.prepend(1) == LI(1, 2, 3));
+    }
+    SECTION("no node is retained while walking") {
+        const LI xs(1, 2, 3, 4, 5);
+        const auto before = listStats();
+        const auto s = sum(xs.borrow());
+        const auto x = xs.borrow().drop(3).head();
+        REQUIRE((listStats() - before).refcountIncrements == 0);
+        REQUIRE(s == 15);
+        REQUIRE(x == 4);
+    }
+}
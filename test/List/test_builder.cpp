@@ -0,0 +1,71 @@
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+using gungnir::ListBuilder;
+
+TEST_CASE("test ListBuilder", "[List][ListBuilder]") {
+
+    using LI = List<int>;
+    using PI = std::unique_ptr<int>;
+
+    SECTION("empty builder") {
+        ListBuilder<int> buf;
+        REQUIRE(buf.size() == 0);
+        REQUIRE(buf.result().isEmpty());
+    }
+    SECTION("elements are appended in order") {
+        ListBuilder<int> buf;
+        buf.append(1).append(2).append(3);
+        REQUIRE(buf.size() == 3);
+        REQUIRE(buf.result() == LI(1, 2, 3));
+        REQUIRE(buf.size() == 0);
+        REQUIRE(buf.result().isEmpty());
+
+        buf.append(4);
+        REQUIRE(buf.result() == LI(4));
+    }
+    SECTION("elements are constructed in-place") {
+        ListBuilder<std::string> buf;
+        buf.append(3, 'a').append("bc");
+        const auto xs = buf.result();
+        REQUIRE(xs.size() == 2);
+        REQUIRE(xs[0] == "aaa");
+        REQUIRE(xs[1] == "bc");
+
+        ListBuilder<PI> ys;
+        ys.append(new int(123)).append(PI(new int(456)));
+        const auto zs = ys.result();
+        REQUIRE(zs.size() == 2);
+        REQUIRE(*zs[0] == 123);
+        REQUIRE(*zs[1] == 456);
+    }
+    SECTION("appendAll shares elements") {
+        const List<PI> xs(PI(new int(1)), PI(new int(2)));
+
+        ListBuilder<PI> buf;
+        buf.appendAll(xs).append(new int(3)).appendAll(xs);
+        const auto ys = buf.result();
+        REQUIRE(ys.size() == 5);
+        REQUIRE(&ys[0] == &xs[0]);
+        REQUIRE(&ys[1] == &xs[1]);
+        REQUIRE(*ys[2] == 3);
+        REQUIRE(&ys[3] == &xs[0]);
+        REQUIRE(&ys[4] == &xs[1]);
+    }
+    SECTION("moved builder") {
+        ListBuilder<int> buf1;
+        buf1.append(1).append(2);
+        ListBuilder<int> buf2(std::move(buf1));
+        buf2.append(3);
+        REQUIRE(buf1.size() == 0);
+        REQUIRE(buf2.result() == LI(1, 2, 3));
+
+        buf1.append(4);
+        REQUIRE(buf1.result() == LI(4));
+    }
+}
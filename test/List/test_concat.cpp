@@ -1,9 +1,11 @@
 #include <memory>
+#include <utility>
 
 #include "catch.hpp"
 
 #include "gungnir/List.hpp"
 using gungnir::List;
+using gungnir::listStats;
 
 TEST_CASE("test List concat", "[List][concat]") {
 
@@ -49,4 +51,48 @@ TEST_CASE("test List concat", "[List][concat]") {
             REQUIRE(*ys3[i] == 6 - i);
         }
     }
+    SECTION("uniquely owned left operand is spliced") {
+        LPI xs(PI(new int(1)), PI(new int(2)));
+        const LPI ys(PI(new int(3)));
+        const auto p = &xs[1];
+
+        const auto before = listStats();
+        const auto zs = std::move(xs).concat(ys);
+        REQUIRE((listStats() - before).nodeAllocations == 0);
+        REQUIRE(zs.size() == 3);
+        REQUIRE(&zs[1] == p);
+        REQUIRE(&zs[2] == &ys[0]);
+        REQUIRE(*zs[0] == 1);
+        REQUIRE(*zs[2] == 3);
+        REQUIRE(ys.size() == 1);
+    }
+    SECTION("shared left operand is copied") {
+        const LI xs(1, 2, 3);
+        auto ys = xs;
+        const auto zs = std::move(ys).concat(LI(4));
+        REQUIRE(zs == LI(1, 2, 3, 4));
+        REQUIRE(xs == LI(1, 2, 3));
+
+        auto us = LI(1, 2, 3);
+        const auto tl = us.tail().tail();
+        const auto vs = std::move(us).concat(LI(4, 5));
+        REQUIRE(vs == LI(1, 2, 3, 4, 5));
+        REQUIRE(tl == LI(3));
+
+        auto ws = LI(1, 2);
+        const auto& alias = ws;
+        ws = std::move(ws).concat(alias);
+        REQUIRE(ws == LI(1, 2, 1, 2));
+    }
+    SECTION("repeated concatenation") {
+        LI acc;
+        for (int i = 0; i < 100; ++i) {
+            acc = std::move(acc).concat(LI(i, i + 1));
+        }
+        REQUIRE(acc.size() == 200);
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(acc[2 * i] == i);
+            REQUIRE(acc[2 * i + 1] == i + 1);
+        }
+    }
 }
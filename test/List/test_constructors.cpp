@@ -1,6 +1,7 @@
 #include <iterator>
 #include <memory>
 #include <stdexcept>
+#include <string>
 
 #include "catch.hpp"
 
@@ -132,4 +133,37 @@ TEST_CASE("test List constructors", "[List][constructor]") {
         REQUIRE(*ys[4] == 1);
         REQUIRE_THROWS_AS(*ys[5], std::out_of_range);
     }
+    SECTION("List from an initializer list") {
+        const List<int> xs {3, 1, 2};
+        REQUIRE(xs.size() == 3);
+        REQUIRE(xs == List<int>(3, 1, 2));
+        REQUIRE(xs.last() == 2);
+
+        const List<std::string> ys = {"a", "bc"};
+        REQUIRE(ys == List<std::string>("a", "bc"));
+
+        const List<int> zs {};
+        REQUIRE(zs.isEmpty());
+    }
+    SECTION("List::of") {
+        REQUIRE(List<int>::of().isEmpty());
+        REQUIRE(List<int>::of(1, 2, 3) == List<int>(1, 2, 3));
+
+        const auto xs = List<std::string>::of("abc", std::string(2, 'x'));
+        REQUIRE(xs == List<std::string>("abc", "xx"));
+        REQUIRE(xs.last() == "xx");
+
+        std::unique_ptr<int> p(new int(1));
+        const auto ps = List<std::unique_ptr<int>>::of(std::move(p), new int(2));
+        REQUIRE(ps.size() == 2);
+        REQUIRE(*ps[0] == 1);
+        REQUIRE(*ps[1] == 2);
+        REQUIRE_FALSE(p);
+    }
+    SECTION("List::fill") {
+        REQUIRE(List<int>::fill(0, 7).isEmpty());
+        REQUIRE(List<int>::fill(3, 7) == List<int>(7, 7, 7));
+        REQUIRE(List<std::string>::fill(2, 3, 'a') == List<std::string>("aaa", "aaa"));
+        REQUIRE(List<std::string>::fill(2) == List<std::string>("", ""));
+    }
 }
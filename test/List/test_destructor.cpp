@@ -0,0 +1,37 @@
+#include <cstddef>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+
+TEST_CASE("test List destructor", "[List][destructor]") {
+
+    // Deep enough that a recursive teardown would overflow a default stack.
+    const std::size_t n = 1 << 21;
+
+    SECTION("long List") {
+        List<int> xs;
+        for (std::size_t i = 0; i < n; ++i) {
+            xs = xs.prepend(static_cast<int>(i));
+        }
+        REQUIRE(xs.size() == n);
+        xs = List<int>();
+        REQUIRE(xs.isEmpty());
+    }
+    SECTION("long List sharing a suffix") {
+        List<int> xs;
+        for (std::size_t i = 0; i < n; ++i) {
+            xs = xs.prepend(static_cast<int>(i));
+        }
+        auto ys = xs.drop(n / 2);
+        xs = List<int>();
+        REQUIRE(ys.size() == n - n / 2);
+        REQUIRE(ys.head() == static_cast<int>(n / 2 - 1));
+
+        auto zs = ys.reverse();
+        ys = List<int>();
+        REQUIRE(zs.size() == n - n / 2);
+        REQUIRE(zs.head() == 0);
+    }
+}
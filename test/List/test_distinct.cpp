@@ -0,0 +1,52 @@
+#include <string>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+
+TEST_CASE("test List distinct and set operations", "[List][distinct]") {
+
+    using LI = List<int>;
+    using LS = List<std::string>;
+
+    SECTION("distinct") {
+        REQUIRE(LI().distinct().isEmpty());
+        REQUIRE(LI(3, 1, 3, 2, 1, 3).distinct() == LI(3, 1, 2));
+        REQUIRE(LI(1, 2, 3).distinct() == LI(1, 2, 3));
+
+        const LS xs("a", "b", "a");
+        const auto ys = xs.distinct();
+        REQUIRE(ys == LS("a", "b"));
+        REQUIRE(&ys.head() == &xs.head());
+        REQUIRE(ys.last() == "b");
+
+        LI many;
+        for (int i = 0; i < 100000; ++i) {
+            many = many.prepend((i * 7919) % 1000 * 1024);
+        }
+        const auto d = many.distinct();
+        REQUIRE(d.size() == 1000);
+        REQUIRE(d.head() == many.head());
+    }
+    SECTION("distinctBy") {
+        REQUIRE(LS().distinctBy([](const std::string& x) { return x.size(); }).isEmpty());
+        const LS xs("a", "bb", "c", "dd", "eee", "f");
+        int calls = 0;
+        REQUIRE(xs.distinctBy([&calls](const std::string& x) { ++calls; return x.size(); }) ==
+                LS("a", "bb", "eee"));
+        REQUIRE(calls == 6);
+        REQUIRE(xs.distinctBy([](const std::string& x) { return x; }) == xs);
+    }
+    SECTION("intersect and diff") {
+        const LI xs(1, 2, 3, 2, 4);
+        REQUIRE(xs.intersect(LI(2, 4, 5)) == LI(2, 2, 4));
+        REQUIRE(xs.diff(LI(2, 4, 5)) == LI(1, 3));
+        REQUIRE(xs.intersect(LI()).isEmpty());
+        REQUIRE(xs.diff(LI()) == xs);
+        REQUIRE(LI().intersect(xs).isEmpty());
+        REQUIRE(LI().diff(xs).isEmpty());
+        REQUIRE(xs.intersect(xs) == xs);
+        REQUIRE(xs.diff(xs).isEmpty());
+    }
+}
@@ -71,3 +71,26 @@ TEST_CASE("test List foldRight", "[List][foldRight]") {
         }) == "543210");
     }
 }
+
+TEST_CASE("test List right folds across chunk boundaries", "[List][foldRight]") {
+
+    for (int n = 0; n <= 40; ++n) {
+        List<int> xs;
+        for (int i = n; i > 0; --i) {
+            xs = xs.prepend(i);
+        }
+        const auto expected = xs.reverse();
+
+        REQUIRE(xs.foldRight(List<int>(), [](int x, List<int> acc) {
+            return acc.concat(List<int>(x));
+        }) == expected);
+        const auto scanned = xs.scanRight(0, [](int x, int acc) { return x + acc; });
+        REQUIRE(scanned.size() == xs.size() + 1);
+        REQUIRE(scanned.head() == n * (n + 1) / 2);
+        REQUIRE(scanned.last() == 0);
+        if (n > 0) {
+            REQUIRE(xs.reduceRight([](int x, int acc) { return x - acc; }) ==
+                    expected.foldLeft(0, [](int acc, int x) { return x - acc; }));
+        }
+    }
+}
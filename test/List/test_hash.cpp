@@ -0,0 +1,115 @@
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "catch.hpp"
+
+#include "gungnir/HashMap.hpp"
+#include "gungnir/List.hpp"
+using gungnir::HashMap;
+using gungnir::List;
+
+namespace {
+
+// An element that counts how often it is compared.
+struct Counted {
+    int x;
+    static int comparisons;
+};
+
+int Counted::comparisons = 0;
+
+bool operator==(const Counted& a, const Counted& b)
+{
+    ++Counted::comparisons;
+    return a.x == b.x;
+}
+
+bool operator!=(const Counted& a, const Counted& b)
+{
+    return !(a == b);
+}
+
+}  // namespace
+
+namespace std {
+
+template<>
+struct hash<Counted> {
+    std::size_t operator()(const Counted& c) const
+    {
+        return std::hash<int>()(c.x);
+    }
+};
+
+}  // namespace std
+
+TEST_CASE("test List hash", "[List][hash]") {
+
+    using LI = List<int>;
+
+    SECTION("equal lists have equal hashes") {
+        REQUIRE(LI().hash() == LI().hash());
+        REQUIRE(LI(1, 2, 3).hash() == LI(1, 2, 3).hash());
+        REQUIRE(LI(1, 2, 3).hash() != LI(3, 2, 1).hash());
+        REQUIRE(LI(1, 2, 3).hash() != LI(1, 2).hash());
+        REQUIRE(LI(0).hash() != LI().hash());
+
+        const LI xs(2, 3);
+        const auto ys = xs.prepend(1);
+        REQUIRE(xs.hash() == LI(2, 3).hash());
+        REQUIRE(ys.hash() == LI(1, 2, 3).hash());
+        REQUIRE(ys.hash() == ys.hash());
+        REQUIRE(std::hash<LI>()(ys) == ys.hash());
+    }
+    SECTION("in-place updates forget cached hashes") {
+        auto xs = LI(1, 2, 3);
+        const auto h = xs.hash();
+        xs = std::move(xs).updated(2, 4);
+        REQUIRE(xs.hash() == LI(1, 2, 4).hash());
+        xs = std::move(xs).map([](int x) { return x * 2; });
+        REQUIRE(xs.hash() == LI(2, 4, 8).hash());
+        xs = std::move(xs).concat(LI(5));
+        REQUIRE(xs.hash() == LI(2, 4, 8, 5).hash());
+        xs = std::move(xs).reverse();
+        REQUIRE(xs.hash() == LI(5, 8, 4, 2).hash());
+        xs = std::move(xs).filter([](int x) { return x != 8; });
+        REQUIRE(xs.hash() == LI(5, 4, 2).hash());
+        xs = std::move(xs).take(2);
+        REQUIRE(xs.hash() == LI(5, 4).hash());
+        REQUIRE(xs.hash() != h);
+    }
+    SECTION("lists as keys") {
+        std::unordered_set<LI> s { LI(1), LI(1, 2), LI(1) };
+        REQUIRE(s.size() == 2);
+        REQUIRE(s.count(LI(1, 2)) == 1);
+
+        const auto m = HashMap<LI, std::string>().updated(LI(1, 2), "a").updated(LI(3), "b");
+        REQUIRE(m[LI(1, 2)] == "a");
+        REQUIRE_FALSE(m.contains(LI(2, 1)));
+    }
+    SECTION("equality stops at shared suffixes") {
+        List<Counted> xs;
+        for (int i = 0; i < 1000; ++i) {
+            xs = xs.prepend(Counted { i });
+        }
+        const auto ys = xs.prepend(Counted { -1 });
+        const auto zs = xs.prepend(Counted { -1 });
+        Counted::comparisons = 0;
+        REQUIRE(ys == zs);
+        REQUIRE(Counted::comparisons == 1);
+
+        const auto ws = xs.prepend(Counted { -2 });
+        REQUIRE(ws.hash() != ys.hash());
+        Counted::comparisons = 0;
+        REQUIRE(ws != ys);
+        REQUIRE(Counted::comparisons == 0);
+
+        // Copies of equal elements compare element by element.
+        const List<Counted> copy(ys.begin(), ys.end());
+        Counted::comparisons = 0;
+        REQUIRE(copy == ys);
+        REQUIRE(Counted::comparisons == 1001);
+    }
+}
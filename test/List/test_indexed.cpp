@@ -0,0 +1,79 @@
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+using gungnir::ListBuilder;
+using gungnir::listStats;
+
+namespace {
+
+List<int> range(int n)
+{
+    ListBuilder<int> buf;
+    for (int i = 0; i < n; ++i) {
+        buf.append(i);
+    }
+    return buf.result();
+}
+
+}  // namespace
+
+TEST_CASE("test List indexed", "[List][indexed]") {
+
+    using LI = List<int>;
+
+    SECTION("empty List") {
+        const auto ix = LI().indexed();
+        REQUIRE(ix.isEmpty());
+        REQUIRE(ix.size() == 0);
+        REQUIRE_THROWS_AS(ix[0], std::out_of_range);
+        REQUIRE(ix.drop(0).isEmpty());
+        REQUIRE(ix.slice(0, 3).isEmpty());
+    }
+    SECTION("agrees with List") {
+        for (int n : {1, 2, 31, 32, 33, 64, 65, 1000}) {
+            const auto xs = range(n);
+            const auto ix = xs.indexed();
+            REQUIRE(ix.size() == xs.size());
+            REQUIRE(ix.list() == xs);
+            bool ok = true;
+            // Backwards first, so that the index is built in one go.
+            for (auto i = n - 1; i >= 0; --i) {
+                ok = ok && ix[i] == i && &ix[i] == &xs[i];
+            }
+            for (auto i = 0; i <= n + 1; i += 7) {
+                ok = ok && ix.drop(i) == xs.drop(i);
+                for (auto j = i; j <= n + 2; j += 13) {
+                    ok = ok && ix.slice(i, j) == xs.slice(i, j);
+                }
+            }
+            REQUIRE(ok);
+            REQUIRE_THROWS_AS(ix[n], std::out_of_range);
+            REQUIRE(ix.slice(5, 2).isEmpty());
+        }
+    }
+    SECTION("drop shares the nodes") {
+        const auto xs = range(100);
+        const auto ix = xs.indexed();
+        const auto ys = ix.drop(70);
+        REQUIRE(ys.size() == 30);
+        REQUIRE(&ys.head() == &xs[70]);
+
+        const auto before = listStats();
+        const auto zs = ix.drop(40);
+        const auto d = listStats() - before;
+        REQUIRE(d.nodeAllocations == 0);
+        REQUIRE(zs.head() == 40);
+    }
+    SECTION("the index outlives the original list") {
+        auto xs = List<std::string>("a", "b", "c");
+        const auto ix = xs.indexed();
+        xs = List<std::string>();
+        REQUIRE(ix[2] == "c");
+        REQUIRE(ix.drop(1) == List<std::string>("b", "c"));
+    }
+}
@@ -1,4 +1,5 @@
 #include <memory>
+#include <utility>
 #include <stdexcept>
 
 #include "catch.hpp"
@@ -34,4 +35,44 @@ TEST_CASE("test List last", "[List][last]") {
         );
         REQUIRE(*ys.last() == 1);
     }
+    SECTION("last is kept across derived Lists") {
+        using LI = List<int>;
+        const LI xs(1, 2, 3, 4, 5);
+        const auto p = &xs.last();
+
+        REQUIRE(&xs.tail().last() == p);
+        REQUIRE(&xs.tail().tail().tail().tail().last() == p);
+        REQUIRE(&xs.prepend(0).last() == p);
+        REQUIRE(&LI(-1, xs).last() == p);
+        REQUIRE(&xs.drop(3).last() == p);
+        REQUIRE(&xs.filter([](int x) { return x < 5; }).concat(xs).last() == p);
+        REQUIRE(xs.init().last() == 4);
+        REQUIRE(xs.reverse().last() == 1);
+        REQUIRE(xs.take(2).last() == 2);
+        REQUIRE(xs.map([](int x) { return x * 10; }).last() == 50);
+        REQUIRE(xs.updated(4, 6).last() == 6);
+        REQUIRE(xs.updated(0, 6).last() == 5);
+    }
+    SECTION("last after splicing concatenation") {
+        using LI = List<int>;
+        LI xs(1, 2);
+        REQUIRE(xs.last() == 2);
+        xs = std::move(xs).concat(LI(3, 4));
+        REQUIRE(xs.last() == 4);
+        REQUIRE(xs.tail().last() == 4);
+
+        LI ys(1, 2, 3);
+        const auto zs = ys.tail().tail();
+        REQUIRE(zs.last() == 3);
+        ys = std::move(ys).concat(LI(4));
+        REQUIRE(ys.last() == 4);
+        REQUIRE(zs.last() == 3);
+
+        LI acc(-1);
+        for (int i = 0; i < 10; ++i) {
+            acc = std::move(acc).concat(LI(i));
+            REQUIRE(acc.last() == i);
+            REQUIRE(acc.tail().last() == i);
+        }
+    }
 }
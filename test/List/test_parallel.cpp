@@ -0,0 +1,138 @@
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+using gungnir::LocalAllocator;
+using gungnir::ListBuilder;
+using gungnir::ParallelPolicy;
+using gungnir::par;
+
+namespace {
+
+List<int> range(int n)
+{
+    ListBuilder<int> buf;
+    for (int i = 0; i < n; ++i) {
+        buf.append(i);
+    }
+    return buf.result();
+}
+
+}  // namespace
+
+TEST_CASE("test List parallel algorithms", "[List][parallel]") {
+
+    using PI = std::unique_ptr<int>;
+
+    // A small grain so that short lists are still split into many chunks.
+    const ParallelPolicy fine(7);
+    const auto xs = range(1000);
+
+    SECTION("map") {
+        const auto times3 = [](int x) { return x * 3; };
+        REQUIRE(List<int>().map(fine, times3).isEmpty());
+        REQUIRE(List<int>(5).map(fine, times3) == List<int>(15));
+        REQUIRE(List<int>(1, 2, 3).map(par, times3) == List<int>(3, 6, 9));
+
+        const auto ys = xs.map(fine, times3);
+        REQUIRE(ys == xs.map(times3));
+        REQUIRE(ys.size() == xs.size());
+        REQUIRE(ys.last() == 2997);
+
+        const auto ps = xs.map(fine, [](int x) { return PI(new int(x)); });
+        REQUIRE(ps.size() == 1000);
+        REQUIRE(ps.map([](const PI& p) { return *p; }) == xs);
+    }
+    SECTION("filter") {
+        const auto odd = [](int x) { return x % 2 != 0; };
+        REQUIRE(List<int>().filter(fine, odd).isEmpty());
+        REQUIRE(List<int>(2).filter(fine, odd).isEmpty());
+        REQUIRE(List<int>(1, 2, 3).filter(par, odd) == List<int>(1, 3));
+
+        const auto ys = xs.filter(fine, odd);
+        REQUIRE(ys == xs.filter(odd));
+        REQUIRE(ys.size() == 500);
+        REQUIRE(ys.last() == 999);
+        REQUIRE(xs.filter(fine, [](int x) { return x < 10; }) == range(10));
+        REQUIRE(xs.filter(fine, [](int) { return false; }).isEmpty());
+        REQUIRE(xs.filter(fine, [](int) { return true; }) == xs);
+    }
+    SECTION("foldLeft") {
+        const auto plus = [](long a, long b) { return a + b; };
+        const auto add = [](long a, int x) { return a + x; };
+        REQUIRE(List<int>().foldLeft(fine, 0L, add, plus) == 0);
+        REQUIRE(xs.foldLeft(fine, 0L, add, plus) == 499500);
+        REQUIRE(xs.foldLeft(par, 0L, add, plus) == 499500);
+
+        const auto ss = range(40).foldLeft(fine, List<int>(),
+            [](const List<int>& acc, int x) { return acc.prepend(x); },
+            [](const List<int>& l, const List<int>& r) { return r.concat(l); });
+        REQUIRE(ss == range(40).reverse());
+
+        const auto either = [](bool a, bool b) { return a || b; };
+        REQUIRE(xs.foldLeft(fine, false, [](bool a, int x) { return a || x == 999; }, either));
+        REQUIRE_FALSE(xs.foldLeft(fine, false, [](bool a, int x) { return a || x < 0; }, either));
+    }
+    SECTION("sorted") {
+        using P = std::pair<int, int>;
+        REQUIRE(List<int>().sorted(fine).isEmpty());
+        REQUIRE(List<int>(3, 1, 2).sorted(par) == List<int>(1, 2, 3));
+
+        const auto ys = xs.reverse().sorted(fine);
+        REQUIRE(ys == xs);
+        REQUIRE(xs.sorted(fine, [](int x, int y) { return x > y; }) == xs.reverse());
+
+        const auto ps = xs.map([](int x) { return P((x * 37) % 10, x); });
+        const auto byKey = [](const P& a, const P& b) { return a.first < b.first; };
+        const auto qs = ps.sorted(fine, byKey);
+        REQUIRE(qs == ps.sorted(byKey, true));
+        REQUIRE(qs.head() == P(0, 0));
+        REQUIRE(qs.last() == P(9, 997));
+    }
+    SECTION("exceptions propagate to the caller") {
+        const auto bad = [](int x) -> int {
+            if (x == 500) {
+                throw std::runtime_error("bad");
+            }
+            return x;
+        };
+        REQUIRE_THROWS_AS(xs.map(fine, bad), std::runtime_error);
+        REQUIRE_THROWS_AS(xs.filter(fine, bad), std::runtime_error);
+        REQUIRE(xs.map(fine, [](int x) { return x; }) == xs);
+    }
+    SECTION("lists with local counters run on the calling thread") {
+        using LI = List<int, LocalAllocator<int>>;
+        LI ls;
+        for (int i = 0; i < 200; ++i) {
+            ls = ls.prepend(i);
+        }
+        // The copied prefix shares the cells of `ls`, which must not be
+        // retained concurrently.
+        const auto ys = ls.concat(ls);
+        const auto caller = std::this_thread::get_id();
+        bool here = true;
+        const auto even = [&](int x) {
+            here = here && std::this_thread::get_id() == caller;
+            return x % 2 == 0;
+        };
+        REQUIRE(ys.filter(fine, even) == ys.filter(even));
+        REQUIRE(ys.map(fine, [&](int x) { return even(x) ? x : 0; }).size() == 400);
+        REQUIRE(ys.foldLeft(fine, 0, [&](int a, int x) { return even(x) ? a + 1 : a; },
+                                     [](int a, int b) { return a + b; }) == 200);
+        REQUIRE(ys.sorted(fine, [&](int x, int y) { return even(x) && x < y; }).size() == 400);
+        REQUIRE(here);
+    }
+    SECTION("nested parallel algorithms") {
+        const auto xss = range(50).map([](int n) { return range(n); });
+        const auto sums = xss.map(fine, [&fine](const List<int>& ys) {
+            return ys.foldLeft(fine, 0, [](int a, int x) { return a + x; },
+                                        [](int a, int b) { return a + b; });
+        });
+        REQUIRE(sums == range(50).map([](int n) { return n * (n - 1) / 2; }));
+    }
+}
@@ -0,0 +1,61 @@
+#include <string>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+
+TEST_CASE("test List partition, span, splitAt and groupBy", "[List][partition]") {
+
+    using LI = List<int>;
+
+    const auto even = [](int x) { return x % 2 == 0; };
+    const auto small = [](int x) { return x < 3; };
+
+    SECTION("partition") {
+        REQUIRE(LI().partition(even) == std::make_pair(LI(), LI()));
+        const LI xs(1, 2, 3, 4, 5);
+        const auto p = xs.partition(even);
+        REQUIRE(p.first == LI(2, 4));
+        REQUIRE(p.second == LI(1, 3, 5));
+        REQUIRE(p.first.size() == 2);
+        REQUIRE(p.second.last() == 5);
+        REQUIRE(&p.first.head() == &xs.tail().head());
+
+        int calls = 0;
+        xs.partition([&calls](int) { return ++calls > 0; });
+        REQUIRE(calls == 5);
+    }
+    SECTION("span") {
+        REQUIRE(LI().span(small) == std::make_pair(LI(), LI()));
+        const LI xs(1, 2, 3, 1);
+        const auto p = xs.span(small);
+        REQUIRE(p.first == LI(1, 2));
+        REQUIRE(p.second == LI(3, 1));
+        REQUIRE(p.second.size() == 2);
+        REQUIRE(&p.second.head() == &xs.drop(2).head());
+        REQUIRE(xs.span([](int) { return true; }) == std::make_pair(xs, LI()));
+        REQUIRE(xs.span([](int) { return false; }) == std::make_pair(LI(), xs));
+    }
+    SECTION("splitAt") {
+        REQUIRE(LI().splitAt(0) == std::make_pair(LI(), LI()));
+        REQUIRE(LI().splitAt(3) == std::make_pair(LI(), LI()));
+        const LI xs(1, 2, 3);
+        REQUIRE(xs.splitAt(0) == std::make_pair(LI(), xs));
+        REQUIRE(xs.splitAt(1) == std::make_pair(LI(1), LI(2, 3)));
+        REQUIRE(xs.splitAt(3) == std::make_pair(xs, LI()));
+        REQUIRE(xs.splitAt(5) == std::make_pair(xs, LI()));
+        REQUIRE(xs.splitAt(2).first.last() == 2);
+        REQUIRE(&xs.splitAt(1).second.head() == &xs.tail().head());
+    }
+    SECTION("groupBy") {
+        REQUIRE(LI().groupBy(even).isEmpty());
+        const List<std::string> xs("a", "bb", "c", "dd", "eee");
+        const auto g = xs.groupBy([](const std::string& x) { return x.size(); });
+        REQUIRE(g.size() == 3);
+        REQUIRE(g[1] == List<std::string>("a", "c"));
+        REQUIRE(g[2] == List<std::string>("bb", "dd"));
+        REQUIRE(g[3] == List<std::string>("eee"));
+        REQUIRE(&g[3].head() == &xs.last());
+    }
+}
@@ -0,0 +1,89 @@
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::DeferredAllocator;
+using gungnir::DeferredReclaim;
+using gungnir::List;
+using gungnir::listStats;
+using gungnir::waitForReclamation;
+
+namespace {
+
+std::atomic<long> live(0);
+
+// Counts the live instances, which may be destroyed on another thread.
+struct Tracked {
+    explicit Tracked(int x) : x(x) { ++live; }
+    Tracked(const Tracked& that) : x(that.x) { ++live; }
+    Tracked& operator=(const Tracked&) = default;
+    ~Tracked() { --live; }
+
+    int x;
+};
+
+using L = List<Tracked, DeferredAllocator<Tracked>>;
+
+L build(int n)
+{
+    L xs;
+    for (int i = 0; i < n; ++i) {
+        xs = xs.prepend(Tracked(i));
+    }
+    return xs;
+}
+
+}  // namespace
+
+TEST_CASE("test List deferred reclamation", "[List][reclaim]") {
+
+    waitForReclamation();
+    const auto base = live.load();
+
+    SECTION("short lists are freed right away") {
+        {
+            const auto xs = build(DeferredReclaim::inlineNodes());
+            REQUIRE(live == base + long(DeferredReclaim::inlineNodes()));
+        }
+        REQUIRE(live == base);
+    }
+    SECTION("long lists are mostly freed in the background") {
+        const int n = 100000;
+        auto xs = build(n);
+        const auto before = listStats();
+        xs = L();
+#ifdef GUNGNIR_LIST_STATS
+        const auto d = listStats() - before;
+        REQUIRE(d.cellDeallocations == DeferredReclaim::inlineNodes());
+#else
+        (void) before;
+#endif
+        waitForReclamation();
+        REQUIRE(live == base);
+    }
+    SECTION("shared tails are kept") {
+        const auto xs = build(1000);
+        {
+            auto ys = xs;
+            for (int i = 0; i < 1000; ++i) {
+                ys = ys.prepend(Tracked(-i));
+            }
+        }
+        waitForReclamation();
+        REQUIRE(live == base + 1000);
+        REQUIRE(xs.size() == 1000);
+        REQUIRE(xs.last().x == 0);
+    }
+    SECTION("derived lists keep the policy") {
+        const auto xs = build(1000).map([](const Tracked& t) { return Tracked(t.x * 2); });
+        using M = decltype(xs);
+        REQUIRE((std::is_same<M, const L>::value));
+        REQUIRE(xs.head().x == 1998);
+    }
+
+    waitForReclamation();
+    REQUIRE(live == base);
+}
@@ -0,0 +1,123 @@
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::AtomicRefCount;
+using gungnir::List;
+using gungnir::LocalAllocator;
+using gungnir::LocalRefCount;
+
+namespace {
+
+// Counts the live allocations made through it, and selects the local
+// reference counting policy.
+template<typename T>
+struct CountingAllocator {
+    using value_type = T;
+    using refcount_policy = LocalRefCount;
+
+    explicit CountingAllocator(long* live) noexcept : live(live) {}
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>& that) noexcept : live(that.live) {}
+
+    T* allocate(std::size_t n)
+    {
+        ++*live;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        --*live;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    long* live;
+};
+
+template<typename T, typename U>
+bool operator==(const CountingAllocator<T>& x, const CountingAllocator<U>& y)
+{
+    return x.live == y.live;
+}
+
+template<typename T, typename U>
+bool operator!=(const CountingAllocator<T>& x, const CountingAllocator<U>& y)
+{
+    return x.live != y.live;
+}
+
+}  // namespace
+
+TEST_CASE("test List reference counting policies", "[List][refcount]") {
+
+    using LI = List<int, LocalAllocator<int>>;
+
+    SECTION("policies are selected by the allocator") {
+        static_assert(std::is_same<gungnir::detail::RefCountOf<std::allocator<int>>,
+                                   AtomicRefCount>::value, "");
+        static_assert(std::is_same<gungnir::detail::RefCountOf<LocalAllocator<int>>,
+                                   LocalRefCount>::value, "");
+        static_assert(std::is_same<gungnir::detail::RefCountOf<CountingAllocator<int>>,
+                                   LocalRefCount>::value, "");
+        static_assert(std::is_empty<LocalAllocator<int>>::value, "");
+    }
+    SECTION("local lists behave like atomic ones") {
+        const LI xs(1, 2, 3);
+        const auto ys = xs.prepend(0);
+        REQUIRE(ys.size() == 4);
+        REQUIRE(ys.tail() == xs);
+        REQUIRE(&ys.tail().head() == &xs.head());
+        REQUIRE(xs.drop(1).tail() == LI(3));
+
+        const auto zs = xs.map([](int x) { return x * 0.5; });
+        static_assert(std::is_same<decltype(zs),
+                                   const List<double, LocalAllocator<double>>>::value, "");
+        REQUIRE(zs.last() == 1.5);
+        REQUIRE(std::move(LI(xs)).filter([](int x) { return x != 2; }) == LI(1, 3));
+        REQUIRE(xs.reverse() == LI(3, 2, 1));
+        REQUIRE(xs.concat(ys).size() == 7);
+    }
+    SECTION("every node is freed") {
+        long live = 0;
+        {
+            using L = List<int, CountingAllocator<int>>;
+            const CountingAllocator<int> alloc(&live);
+            L xs(alloc);
+            for (int i = 0; i < 1000; ++i) {
+                xs = xs.prepend(i);
+            }
+            auto ys = xs.drop(500);
+            const auto zs = ys.updated(10, -1);
+            xs = L(alloc);
+            REQUIRE(live > 0);
+            ys = std::move(ys).map([](int x) { return x + 1; });
+            REQUIRE(zs.size() == 500);
+            REQUIRE(ys.head() == 500);
+        }
+        REQUIRE(live == 0);
+    }
+    SECTION("empty local lists on several threads") {
+        std::vector<std::thread> threads;
+        std::vector<int> empty(4, 0);
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&empty, t] {
+                for (int i = 0; i < 10000; ++i) {
+                    LI xs;
+                    const auto ys = xs;
+                    empty[t] += ys.prepend(i).tail().isEmpty();
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        REQUIRE(empty == std::vector<int>(4, 10000));
+    }
+}
@@ -0,0 +1,185 @@
+#include <string>
+#include <utility>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+using gungnir::ListStats;
+using gungnir::listStats;
+
+namespace {
+
+struct Copies {
+    static int count;
+
+    explicit Copies(int x) : x(x) {}
+    Copies(const Copies& that) : x(that.x) { ++count; }
+    Copies(Copies&&) = default;
+
+    int x;
+};
+
+int Copies::count = 0;
+
+}  // namespace
+
+TEST_CASE("test List rvalue transformations", "[List][rvalue]") {
+
+    using LI = List<int>;
+
+    const auto since = [](const ListStats& before) {
+        return listStats() - before;
+    };
+    const auto times2 = [](int x) { return x * 2; };
+    const auto odd = [](int x) { return x % 2 != 0; };
+
+    SECTION("map replaces uniquely owned elements in place") {
+        LI xs(1, 2, 3, 4);
+        const auto before = listStats();
+        xs = std::move(xs).map(times2);
+        REQUIRE(since(before).nodeAllocations == 0);
+        REQUIRE(xs == LI(2, 4, 6, 8));
+        REQUIRE(xs.last() == 8);
+
+        const auto ss = List<std::string>("a", "b").map([](std::string s) { return s + s; });
+        REQUIRE(ss == List<std::string>("aa", "bb"));
+    }
+    SECTION("map moves uniquely owned elements out") {
+        List<Copies> cs(Copies(1), Copies(2));
+        Copies::count = 0;
+        const auto ds = std::move(cs).map([](Copies c) { return c.x; });
+        REQUIRE(Copies::count == 0);
+        REQUIRE(ds == LI(1, 2));
+
+        const List<Copies> shared(Copies(3));
+        auto es = shared;
+        const auto fs = std::move(es).map([](Copies c) { return c.x; });
+        REQUIRE(Copies::count == 1);
+        REQUIRE(fs == LI(3));
+
+        LI xs(1, 2, 3);
+        const auto before = listStats();
+        const auto ys = std::move(xs).map([](int x) { return x * 0.5; });
+#ifdef GUNGNIR_LIST_STATS
+        const auto d = since(before);
+        REQUIRE(d.nodeAllocations == 3);
+        REQUIRE(d.nodeDeallocations == 3);
+#else
+        (void) before;
+#endif
+        REQUIRE(ys == List<double>(0.5, 1.0, 1.5));
+    }
+    SECTION("map does not change shared lists") {
+        const LI xs(1, 2, 3);
+        LI ys = xs;
+        ys = std::move(ys).map(times2);
+        REQUIRE(xs == LI(1, 2, 3));
+        REQUIRE(ys == LI(2, 4, 6));
+
+        // Only the first two nodes of `zs` are not shared with `xs`.
+        LI zs = xs.prepend(5).prepend(4);
+        zs = std::move(zs).map(times2);
+        REQUIRE(zs == LI(8, 10, 2, 4, 6));
+        REQUIRE(zs.last() == 6);
+        REQUIRE(xs == LI(1, 2, 3));
+        REQUIRE(xs.last() == 3);
+
+        // The elements of `ws` are shared with `xs`.
+        auto ws = xs.filter([](int) { return true; });
+        ws = std::move(ws).map(times2);
+        REQUIRE(ws == LI(2, 4, 6));
+        REQUIRE(xs == LI(1, 2, 3));
+    }
+    SECTION("filter relinks uniquely owned nodes") {
+        LI xs(1, 2, 3, 4, 5);
+        const auto before = listStats();
+        xs = std::move(xs).filter(odd);
+#ifdef GUNGNIR_LIST_STATS
+        const auto d = since(before);
+        REQUIRE(d.nodeAllocations == 0);
+        REQUIRE(d.nodeDeallocations == 2);
+#else
+        (void) before;
+#endif
+        REQUIRE(xs == LI(1, 3, 5));
+        REQUIRE(xs.size() == 3);
+        REQUIRE(xs.last() == 5);
+
+        xs = std::move(xs).filter([](int x) { return x > 10; });
+        REQUIRE(xs.isEmpty());
+
+        const LI shared(5, 6, 7);
+        auto ys = shared.prepend(4).prepend(3);
+        ys = std::move(ys).filter(odd);
+        REQUIRE(ys == LI(3, 5, 7));
+        REQUIRE(ys.last() == 7);
+        REQUIRE(shared == LI(5, 6, 7));
+    }
+    SECTION("reverse relinks uniquely owned nodes") {
+        LI xs(1, 2, 3, 4);
+        const auto before = listStats();
+        xs = std::move(xs).reverse();
+        REQUIRE(since(before).nodeAllocations == 0);
+        REQUIRE(xs == LI(4, 3, 2, 1));
+        REQUIRE(xs.last() == 1);
+        REQUIRE(xs.tail().last() == 1);
+
+        const LI shared(3, 4);
+        auto ys = shared.prepend(2).prepend(1);
+        ys = std::move(ys).reverse();
+        REQUIRE(ys == LI(4, 3, 2, 1));
+        REQUIRE(ys.last() == 1);
+        REQUIRE(shared == LI(3, 4));
+
+        REQUIRE(LI().reverse().isEmpty());
+    }
+    SECTION("take cuts uniquely owned lists") {
+        LI xs(1, 2, 3, 4);
+        const auto before = listStats();
+        xs = std::move(xs).take(2);
+#ifdef GUNGNIR_LIST_STATS
+        const auto d = since(before);
+        REQUIRE(d.nodeAllocations == 0);
+        REQUIRE(d.nodeDeallocations == 2);
+#else
+        (void) before;
+#endif
+        REQUIRE(xs == LI(1, 2));
+        REQUIRE(xs.size() == 2);
+        REQUIRE(xs.last() == 2);
+
+        REQUIRE(LI(1, 2).take(5) == LI(1, 2));
+        REQUIRE(LI(1, 2).take(0).isEmpty());
+
+        const LI shared(3, 4, 5);
+        auto ys = shared.prepend(2).prepend(1);
+        ys = std::move(ys).take(4);
+        REQUIRE(ys == LI(1, 2, 3, 4));
+        REQUIRE(ys.last() == 4);
+        REQUIRE(shared == LI(3, 4, 5));
+    }
+    SECTION("updated replaces uniquely owned elements in place") {
+        LI xs(1, 2, 3);
+        const auto before = listStats();
+        xs = std::move(xs).updated(2, 30);
+        REQUIRE(since(before).nodeAllocations == 0);
+        REQUIRE(xs == LI(1, 2, 30));
+        REQUIRE(xs.last() == 30);
+
+        const LI shared(2, 3);
+        auto ys = shared.prepend(1);
+        ys = std::move(ys).updated(1, 20);
+        REQUIRE(ys == LI(1, 20, 3));
+        REQUIRE(shared == LI(2, 3));
+
+        REQUIRE_THROWS_AS(LI(1).updated(1, 0), std::out_of_range);
+    }
+    SECTION("map pipelines on temporaries") {
+        LI xs(1, 2, 3, 4, 5, 6);
+        const auto before = listStats();
+        xs = std::move(xs).map(times2).filter([](int x) { return x % 3 != 0; }).reverse();
+        REQUIRE(since(before).nodeAllocations == 0);
+        REQUIRE(xs == LI(10, 8, 4, 2));
+    }
+}
@@ -0,0 +1,61 @@
+#include <cstddef>
+#include <memory>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+
+TEST_CASE("test List element sharing", "[List][sharing]") {
+
+    static std::size_t alive = 0;
+
+    struct Foo {
+        explicit Foo(int x) noexcept : x(x) { ++alive; }
+        Foo(Foo&& that) noexcept : x(that.x) { ++alive; }
+        ~Foo() { --alive; }
+
+        int x;
+    };
+
+    SECTION("derived Lists share elements") {
+        alive = 0;
+        {
+            const List<Foo> xs(Foo(1), Foo(2), Foo(3));
+            REQUIRE(alive == 3);
+
+            const auto ys = xs.filter([](const Foo& f) { return f.x != 2; });
+            REQUIRE(alive == 3);
+            REQUIRE(&ys.head() == &xs.head());
+            REQUIRE(&ys[1] == &xs[2]);
+
+            const auto zs = xs.reverse();
+            REQUIRE(alive == 3);
+            REQUIRE(&zs[0] == &xs[2]);
+        }
+        REQUIRE(alive == 0);
+    }
+    SECTION("shared elements outlive their original List") {
+        alive = 0;
+        {
+            auto xs = List<Foo>(Foo(1), Foo(2), Foo(3)).prepend(0);
+            auto ys = xs.take(2);
+            xs = List<Foo>();
+            REQUIRE(alive == 2);
+            REQUIRE(ys.size() == 2);
+            REQUIRE(ys[0].x == 0);
+            REQUIRE(ys[1].x == 1);
+        }
+        REQUIRE(alive == 0);
+    }
+    SECTION("move-only elements are shared across Lists") {
+        using PI = std::unique_ptr<int>;
+
+        const List<PI> xs(PI(new int(1)), PI(new int(2)));
+        const auto ys = xs.concat(xs);
+        REQUIRE(ys.size() == 4);
+        REQUIRE(&ys[0] == &xs[0]);
+        REQUIRE(&ys[2] == &xs[0]);
+        REQUIRE(&ys[3] == &xs[1]);
+    }
+}
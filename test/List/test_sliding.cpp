@@ -0,0 +1,174 @@
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+using gungnir::ListBuilder;
+using gungnir::ListWindow;
+using gungnir::listStats;
+
+namespace {
+
+// The windows of `xs`, assembled the slow way with `drop()` and `take()`.
+List<List<int>> naiveWindows(const List<int>& xs, std::size_t n, std::size_t step)
+{
+    ListBuilder<List<int>> buf;
+    for (std::size_t i = 0; i < xs.size(); i += step) {
+        buf.append(xs.drop(i).take(n));
+        if (i + n >= xs.size()) {
+            break;
+        }
+    }
+    return buf.result();
+}
+
+List<int> range(int n)
+{
+    ListBuilder<int> buf;
+    for (int i = 0; i < n; ++i) {
+        buf.append(i);
+    }
+    return buf.result();
+}
+
+}  // namespace
+
+TEST_CASE("test List sliding", "[List][sliding]") {
+
+    using LI = List<int>;
+    using LLI = List<LI>;
+    using W = ListWindow<int>;
+
+    const auto plus = [](int a, int x) { return a + x; };
+    const auto minus = [](int a, int x) { return a - x; };
+
+    SECTION("empty List") {
+        const LI xs;
+        REQUIRE(xs.sliding(3).isEmpty());
+        REQUIRE(xs.sliding(3).size() == 0);
+        REQUIRE(xs.sliding(3).begin() == xs.sliding(3).end());
+        REQUIRE(xs.grouped(2).toList().isEmpty());
+        REQUIRE(xs.sliding(2).scanLeft(0, plus, minus).isEmpty());
+    }
+    SECTION("zero sizes and steps are rejected") {
+        const LI xs(1, 2, 3);
+        REQUIRE_THROWS_AS(xs.sliding(0), std::invalid_argument);
+        REQUIRE_THROWS_AS(xs.sliding(2, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(xs.grouped(0), std::invalid_argument);
+    }
+    SECTION("windows and groups") {
+        const LI xs(1, 2, 3, 4, 5);
+        REQUIRE(xs.sliding(3).toList() == LLI(LI(1, 2, 3), LI(2, 3, 4), LI(3, 4, 5)));
+        REQUIRE(xs.sliding(3, 2).toList() == LLI(LI(1, 2, 3), LI(3, 4, 5)));
+        REQUIRE(xs.sliding(2, 2).toList() == LLI(LI(1, 2), LI(3, 4), LI(5)));
+        REQUIRE(xs.sliding(1, 3).toList() == LLI(LI(1), LI(4)));
+        REQUIRE(xs.sliding(2, 4).toList() == LLI(LI(1, 2), LI(5)));
+        REQUIRE(xs.sliding(7).toList() == LLI(xs));
+        REQUIRE(xs.grouped(2).toList() == LLI(LI(1, 2), LI(3, 4), LI(5)));
+        REQUIRE(xs.grouped(5).toList() == LLI(xs));
+        REQUIRE(xs.grouped(1).size() == 5);
+    }
+    SECTION("against drop and take") {
+        const auto xs = range(23);
+        bool ok = true;
+        for (std::size_t n = 1; n < 26; ++n) {
+            for (std::size_t step = 1; step < 26; ++step) {
+                const auto expected = naiveWindows(xs, n, step);
+                const auto ws = xs.sliding(n, step);
+                ok = ok && ws.toList() == expected && ws.size() == expected.size();
+            }
+        }
+        REQUIRE(ok);
+    }
+    SECTION("windows are views") {
+        const LI xs(1, 2, 3, 4);
+        auto it = xs.sliding(2).begin();
+        ++it;
+        const W w = *it;
+        REQUIRE(w.size() == 2);
+        REQUIRE(w.head() == 2);
+        REQUIRE(&w.head() == &*++xs.begin());
+        REQUIRE(std::vector<int>(w.begin(), w.end()) == (std::vector<int>{2, 3}));
+        REQUIRE(w.foldLeft(std::string(), [](std::string s, int x) {
+            return s + std::to_string(x);
+        }) == "23");
+
+        std::vector<std::size_t> sizes;
+        xs.grouped(3).foreach([&sizes](const W& g) { sizes.push_back(g.size()); });
+        REQUIRE((sizes == std::vector<std::size_t>{3, 1}));
+
+        int windows = 0;
+        for (const auto& g : xs.sliding(3)) {
+            int n = 0;
+            g.foreach([&n](int) { ++n; });
+            REQUIRE(n == 3);
+            ++windows;
+        }
+        REQUIRE(windows == 2);
+    }
+    SECTION("windows over nodes sharing elements") {
+        const LI xs(1, 2);
+        const auto ys = xs.concat(xs);
+        REQUIRE(ys.sliding(2, 2).toList() == LLI(xs, xs));
+        REQUIRE(ys.sliding(3).toList() == LLI(LI(1, 2, 1), LI(2, 1, 2)));
+        for (const auto& w : ys.sliding(2, 2)) {
+            REQUIRE(w.size() == 2);
+            REQUIRE(std::distance(w.begin(), w.end()) == 2);
+            REQUIRE(w.begin() != std::next(w.begin(), 2));
+            REQUIRE(w.toList() == xs);
+        }
+
+        const auto zs = LI(1, 2, 3, 1, 2, 3).filter([](int x) { return x != 3; });
+        REQUIRE(zs.grouped(3).toList() == LLI(LI(1, 2, 1), LI(2)));
+        int n = 0;
+        for (const auto& w : zs.sliding(2)) {
+            n += static_cast<int>(std::distance(w.begin(), w.end()));
+        }
+        REQUIRE(n == 6);
+    }
+    SECTION("iterating windows does not allocate") {
+        const auto xs = range(1000);
+        const auto before = listStats();
+        long total = 0;
+        for (const auto& w : xs.sliding(50, 7)) {
+            total += w.foldLeft(0L, [](long a, int x) { return a + x; });
+        }
+        const auto d = listStats() - before;
+        REQUIRE(d.nodeAllocations == 0);
+        REQUIRE(d.refcountIncrements == 0);
+        REQUIRE(total > 0);
+    }
+    SECTION("incremental folds") {
+        const auto xs = range(100);
+        bool ok = true;
+        for (std::size_t n = 1; n < 12; ++n) {
+            for (std::size_t step = 1; step < 14; ++step) {
+                const auto ws = xs.sliding(n, step);
+                const auto sums = ws.scanLeft(0, plus, minus);
+                ListBuilder<int> expected;
+                ws.foreach([&expected, &plus](const W& w) { expected.append(w.foldLeft(0, plus)); });
+                ok = ok && sums == expected.result();
+            }
+        }
+        REQUIRE(ok);
+
+        // Moving averages of four elements.
+        const LI ys(4, 8, 0, 4, 12, 4);
+        const auto avgs = ys.sliding(4).scanLeft(0, plus, minus).map([](int s) { return s / 4; });
+        REQUIRE(avgs == LI(4, 6, 5));
+
+        std::size_t adds = 0;
+        std::size_t removes = 0;
+        const auto zs = range(1000);
+        zs.sliding(100).scanLeft(0L,
+            [&adds](long a, int x) { ++adds; return a + x; },
+            [&removes](long a, int x) { ++removes; return a - x; });
+        REQUIRE(adds == 1000);
+        REQUIRE(removes == 900);
+    }
+}
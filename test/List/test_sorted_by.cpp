@@ -0,0 +1,110 @@
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+using gungnir::ListBuilder;
+using gungnir::ParallelPolicy;
+
+namespace {
+
+// A list of `n` pairs whose first components repeat, so that stability is
+// observable, and whose second components are their original positions.
+template<typename K>
+List<std::pair<K, int>> records(int n, K (*key)(int))
+{
+    ListBuilder<std::pair<K, int>> buf;
+    for (int i = 0; i < n; ++i) {
+        buf.append(key(i), i);
+    }
+    return buf.result();
+}
+
+template<typename K>
+bool isStablySorted(const List<std::pair<K, int>>& xs)
+{
+    for (auto it = xs.begin(), next = it; it != xs.end() && ++next != xs.end(); ++it) {
+        if (next->first < it->first ||
+            (next->first == it->first && next->second < it->second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE("test List sortedBy", "[List][sortedBy]") {
+
+    using PI = std::unique_ptr<int>;
+
+    const ParallelPolicy fine(7);
+
+    SECTION("empty List") {
+        REQUIRE(List<int>().sortedBy([](int x) { return -x; }).isEmpty());
+        REQUIRE(List<int>().sortedBy(fine, [](int x) { return -x; }).isEmpty());
+    }
+    SECTION("small Lists") {
+        const List<int> xs(3, 1, 4, 1, 5, 9, 2, 6);
+        REQUIRE(xs.sortedBy([](int x) { return x; }) == List<int>(1, 1, 2, 3, 4, 5, 6, 9));
+        REQUIRE(xs.sortedBy([](int x) { return -x; }) == List<int>(9, 6, 5, 4, 3, 2, 1, 1));
+        REQUIRE(xs.sortedBy([](int x) { return x % 3; }) == List<int>(3, 9, 6, 1, 4, 1, 5, 2));
+        REQUIRE(xs.sortedBy([](int x) { return std::to_string(x * 7); }) ==
+                List<int>(2, 3, 4, 5, 6, 9, 1, 1));
+
+        List<PI> ps(PI(new int(2)), PI(new int(0)), PI(new int(1)));
+        const auto qs = ps.sortedBy([](const PI& p) { return *p; });
+        REQUIRE(qs.map([](const PI& p) { return *p; }) == List<int>(0, 1, 2));
+        REQUIRE(&qs[2] == &ps[0]);
+    }
+    SECTION("radix sorted keys") {
+        const auto signedKeys = records<int>(3000, [](int i) { return (i * 7919) % 201 - 100; });
+        const auto bySigned = signedKeys.sortedBy([](const std::pair<int, int>& x) { return x.first; });
+        REQUIRE(bySigned.size() == 3000);
+        REQUIRE(isStablySorted(bySigned));
+        REQUIRE(bySigned.head().first == -100);
+        REQUIRE(bySigned.last().first == 100);
+
+        const auto wideKeys = records<std::int64_t>(1000, [](int i) {
+            return (i % 2 ? -1 : 1) * (std::int64_t(i) << 40) + i % 5;
+        });
+        const auto byWide = wideKeys.sortedBy([](const std::pair<std::int64_t, int>& x) { return x.first; });
+        REQUIRE(isStablySorted(byWide));
+        REQUIRE(byWide == wideKeys.sorted([](const std::pair<std::int64_t, int>& x,
+                                             const std::pair<std::int64_t, int>& y) {
+            return x.first < y.first;
+        }, true));
+
+        const auto unsignedKeys = records<unsigned>(1000, [](int i) {
+            return i % 3 ? std::numeric_limits<unsigned>::max() - unsigned(i % 7) : unsigned(i % 7);
+        });
+        REQUIRE(isStablySorted(unsignedKeys.sortedBy([](const std::pair<unsigned, int>& x) { return x.first; })));
+
+        const auto charKeys = records<signed char>(1000, [](int i) {
+            return static_cast<signed char>(i % 256 - 128);
+        });
+        REQUIRE(isStablySorted(charKeys.sortedBy([](const std::pair<signed char, int>& x) { return x.first; })));
+
+        const auto sameKeys = records<int>(1000, [](int) { return 42; });
+        REQUIRE(sameKeys.sortedBy([](const std::pair<int, int>& x) { return x.first; }) == sameKeys);
+    }
+    SECTION("parallel") {
+        const auto xs = records<int>(2000, [](int i) { return (i * 37) % 101 - 50; });
+        const auto first = [](const std::pair<int, int>& x) { return x.first; };
+        const auto ys = xs.sortedBy(fine, first);
+        REQUIRE(isStablySorted(ys));
+        REQUIRE(ys == xs.sortedBy(first));
+
+        const auto byString = xs.sortedBy(fine, [](const std::pair<int, int>& x) {
+            return std::to_string(x.first);
+        });
+        REQUIRE(byString == xs.sortedBy([](const std::pair<int, int>& x) {
+            return std::to_string(x.first);
+        }));
+    }
+}
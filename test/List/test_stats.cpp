@@ -0,0 +1,114 @@
+#include <cstddef>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+using gungnir::ListStats;
+using gungnir::listStats;
+using gungnir::resetListStats;
+
+TEST_CASE("test List stats", "[List][stats]") {
+
+    using LI = List<int>;
+
+    const auto since = [](const ListStats& before) {
+        return listStats() - before;
+    };
+
+#ifdef GUNGNIR_LIST_STATS
+    SECTION("empty lists do not allocate") {
+        const auto before = listStats();
+        {
+            const LI xs;
+            const LI ys = xs;
+            REQUIRE(ys.isEmpty());
+        }
+        const auto d = since(before);
+        REQUIRE(d.nodeAllocations == 0);
+        REQUIRE(d.nodeDeallocations == 0);
+    }
+    SECTION("elements are allocated as cells") {
+        const auto before = listStats();
+        {
+            const LI xs(1, 2, 3);
+            const auto d = since(before);
+            REQUIRE(d.cellAllocations == 3);
+            REQUIRE(d.nodeAllocations == 3);
+            REQUIRE(d.bufferAllocations == 0);
+        }
+        const auto d = since(before);
+        REQUIRE(d.cellDeallocations == 3);
+        REQUIRE(d.nodeDeallocations == 3);
+    }
+    SECTION("copying a list only increments a reference count") {
+        const LI xs(1, 2, 3);
+        const auto before = listStats();
+        const LI ys = xs;
+        const auto d = since(before);
+        REQUIRE(d.nodeAllocations == 0);
+        REQUIRE(d.refcountIncrements == 1);
+        REQUIRE(ys == xs);
+    }
+    SECTION("filter shares elements instead of copying them") {
+        const LI xs(1, 2, 3, 4);
+        const auto before = listStats();
+        {
+            const auto ys = xs.filter([](int x) { return x % 2 == 0; });
+            const auto d = since(before);
+            REQUIRE(d.nodeAllocations == 2);
+            REQUIRE(d.cellAllocations == 0);
+            REQUIRE(d.refcountIncrements >= 2);
+        }
+        const auto d = since(before);
+        REQUIRE(d.nodeDeallocations == 2);
+        REQUIRE(d.cellDeallocations == 0);
+    }
+    SECTION("map allocates one cell per element") {
+        const LI xs(1, 2, 3, 4);
+        const auto before = listStats();
+        const auto ys = xs.map([](int x) { return x + 1; });
+        const auto d = since(before);
+        REQUIRE(d.cellAllocations == 4);
+        REQUIRE(d.nodeAllocations == 4);
+    }
+    SECTION("temporary buffers are recorded") {
+        const LI xs(3, 1, 2);
+        const auto before = listStats();
+        const auto ys = xs.sorted();
+        const auto d = since(before);
+        REQUIRE(ys == LI(1, 2, 3));
+        REQUIRE(d.bufferAllocations == 1);
+        REQUIRE(d.bufferBytes >= 3 * sizeof (void*));
+    }
+    SECTION("right folds buffer O(sqrt(n)) nodes") {
+        LI xs;
+        for (int i = 0; i < 10000; ++i) {
+            xs = xs.prepend(i);
+        }
+        const auto before = listStats();
+        REQUIRE(xs.foldRight(0L, [](int x, long acc) { return acc + x; }) == 49995000L);
+        const auto d = since(before);
+        REQUIRE(d.bufferAllocations == 1);
+        REQUIRE(d.bufferBytes <= 2 * 101 * sizeof (void*));
+    }
+    SECTION("resetListStats") {
+        const LI xs(1, 2, 3);
+        resetListStats();
+        const auto s = listStats();
+        REQUIRE(s.nodeAllocations == 0);
+        REQUIRE(s.cellAllocations == 0);
+        REQUIRE(s.refcountIncrements == 0);
+    }
+#else
+    SECTION("nothing is counted") {
+        const LI xs(1, 2, 3);
+        const LI ys = xs.map([](int x) { return x + 1; });
+        const auto s = listStats();
+        REQUIRE(s.nodeAllocations == 0);
+        REQUIRE(s.cellAllocations == 0);
+        REQUIRE(s.refcountIncrements == 0);
+        (void) since;
+    }
+#endif
+}
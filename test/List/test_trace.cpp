@@ -0,0 +1,108 @@
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+#include "gungnir/ListTrace.hpp"
+using gungnir::List;
+using gungnir::ListTraceEvent;
+using gungnir::listTrace;
+using gungnir::listTraceSummary;
+using gungnir::resetListTrace;
+using gungnir::writeChromeTrace;
+
+TEST_CASE("test List trace", "[List][trace]") {
+
+    using LI = List<int>;
+
+    resetListTrace();
+    const auto inc = [](int x) { return x + 1; };
+    const auto named = [](const ListTraceEvent& e, const char* name) {
+        return std::strcmp(e.name, name) == 0;
+    };
+
+#ifdef GUNGNIR_LIST_TRACE
+    SECTION("map, flatMap and sorted are recorded once per call") {
+        const LI xs(3, 1, 2);
+        const auto ys = xs.map(inc);
+        const auto zs = LI(xs).map(inc);
+        const auto ws = xs.flatMap([](int x) { return LI(x, x); });
+        const auto ss = xs.sorted();
+        REQUIRE(xs.filter([](int x) { return x > 1; }).size() == 2);
+        REQUIRE(LI().flatMap([](int x) { return LI(x); }).isEmpty());
+
+        const auto events = listTrace();
+        REQUIRE(events.size() == 4);
+        REQUIRE(named(events[0], "List::map"));
+        REQUIRE(named(events[1], "List::map"));
+        REQUIRE(named(events[2], "List::flatMap"));
+        REQUIRE(events[2].inputSize == 3);
+        REQUIRE(events[2].outputSize == 6);
+        REQUIRE(named(events[3], "List::sorted"));
+        for (std::size_t i = 1; i < events.size(); ++i) {
+            REQUIRE(events[i - 1].start + events[i - 1].duration <= events[i].start);
+            REQUIRE(events[i].thread == events[0].thread);
+        }
+    }
+    SECTION("summaries aggregate calls by operation") {
+        const LI xs(1, 2, 3, 4, 5);
+        for (int i = 0; i < 3; ++i) {
+            xs.map(inc);
+        }
+        LI().map(inc);
+        xs.sorted();
+
+        const auto ops = listTraceSummary();
+        REQUIRE(ops.size() == 2);
+        const auto& map = std::strcmp(ops[0].name, "List::map") == 0 ? ops[0] : ops[1];
+        REQUIRE(map.count == 4);
+        REQUIRE(map.inputElements == 15);
+        REQUIRE(map.outputElements == 15);
+        REQUIRE(map.sizeHistogram[0] == 1);
+        REQUIRE(map.sizeHistogram[3] == 3);
+        REQUIRE(ops[0].totalNanos >= ops[1].totalNanos);
+    }
+    SECTION("threads record into rings of their own") {
+        const LI xs(1, 2, 3);
+        xs.map(inc);
+        std::thread t([&xs, inc] {
+            for (int i = 0; i < 10000; ++i) {
+                xs.map(inc);
+            }
+        });
+        for (int i = 0; i < 20; ++i) {
+            bool consistent = true;
+            for (const auto& e : listTrace()) {
+                consistent = consistent && named(e, "List::map") && e.outputSize == 3;
+            }
+            REQUIRE(consistent);
+        }
+        t.join();
+
+        const auto events = listTrace();
+        REQUIRE(events.size() == 1 + GUNGNIR_LIST_TRACE_CAPACITY);
+        REQUIRE(events.front().thread != events.back().thread);
+        resetListTrace();
+        REQUIRE(listTrace().empty());
+    }
+    SECTION("Chrome traces") {
+        LI(1, 2).map(inc);
+        std::ostringstream out;
+        writeChromeTrace(out);
+        const auto json = out.str();
+        REQUIRE(json.find("{\"traceEvents\":[") == 0);
+        REQUIRE(json.find("\"name\":\"List::map\",\"cat\":\"gungnir\",\"ph\":\"X\",\"ts\":0.000,") != std::string::npos);
+        REQUIRE(json.find("\"args\":{\"inputSize\":2,\"outputSize\":2}}") != std::string::npos);
+    }
+#else
+    SECTION("nothing is recorded") {
+        LI(1, 2).map(inc);
+        REQUIRE(listTrace().empty());
+        REQUIRE(listTraceSummary().empty());
+        (void) named;
+    }
+#endif
+}
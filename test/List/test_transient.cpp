@@ -0,0 +1,73 @@
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+using gungnir::TransientList;
+
+TEST_CASE("test TransientList", "[List][TransientList]") {
+
+    using LI = List<int>;
+    using PI = std::unique_ptr<int>;
+
+    SECTION("empty transient") {
+        TransientList<int> t;
+        REQUIRE(t.size() == 0);
+        REQUIRE(t.persistent().isEmpty());
+        REQUIRE(LI().asTransient().persistent().isEmpty());
+    }
+    SECTION("prepended and appended elements surround the original ones") {
+        const LI xs(3, 4);
+        auto t = xs.asTransient();
+        t.prepend(2).append(5).prepend(1).append(6);
+        REQUIRE(t.size() == 6);
+        const auto ys = t.persistent();
+        REQUIRE(ys == LI(1, 2, 3, 4, 5, 6));
+        REQUIRE(ys.size() == 6);
+        REQUIRE(ys.last() == 6);
+        REQUIRE(xs == LI(3, 4));
+        REQUIRE(t.size() == 0);
+        REQUIRE(t.persistent().isEmpty());
+    }
+    SECTION("prepended elements share the original list") {
+        const LI xs(2, 3);
+        auto t = xs.asTransient();
+        t.prepend(1);
+        const auto ys = t.persistent();
+        REQUIRE(&ys.tail().head() == &xs.head());
+    }
+    SECTION("a uniquely owned list is reused when appending") {
+        auto t = LI(1, 2).asTransient();
+        t.append(3).append(4);
+        REQUIRE(t.persistent() == LI(1, 2, 3, 4));
+    }
+    SECTION("bulk load") {
+        TransientList<int> t;
+        for (int i = 0; i < 100000; ++i) {
+            t.prepend(i);
+        }
+        const auto xs = t.persistent();
+        REQUIRE(xs.size() == 100000);
+        REQUIRE(xs.head() == 99999);
+        REQUIRE(xs.last() == 0);
+    }
+    SECTION("move-only elements") {
+        TransientList<PI> t;
+        t.prepend(new int(2)).append(PI(new int(3))).prepend(new int(1));
+        const auto xs = t.persistent();
+        REQUIRE(xs.size() == 3);
+        REQUIRE(*xs.head() == 1);
+        REQUIRE(*xs.last() == 3);
+    }
+    SECTION("moved transient") {
+        TransientList<std::string> t;
+        t.prepend("b").append("c");
+        auto u = std::move(t);
+        u.prepend("a");
+        REQUIRE(t.size() == 0);
+        REQUIRE(u.persistent() == List<std::string>("a", "b", "c"));
+    }
+}
@@ -0,0 +1,66 @@
+#include <memory>
+#include <string>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+#include "gungnir/Option.hpp"
+using gungnir::List;
+using gungnir::Option;
+
+TEST_CASE("test List sequence, traverse and flatMapOption", "[List][traverse]") {
+
+    using LI = List<int>;
+    using OI = Option<int>;
+    using LOI = List<OI>;
+    using PI = std::unique_ptr<int>;
+    using LPI = List<PI>;
+    using S = std::string;
+
+    const auto half = [](int x) { return x % 2 == 0 ? OI(x / 2) : OI(); };
+
+    SECTION("sequence") {
+        REQUIRE(LOI().sequence().get() == LI());
+        REQUIRE(LOI(OI(1)).sequence().get() == LI(1));
+        REQUIRE(LOI(OI(1), OI(2), OI(3)).sequence().get() == LI(1, 2, 3));
+        REQUIRE(LOI(OI()).sequence().isEmpty());
+        REQUIRE(LOI(OI(1), OI(), OI(3)).sequence().isEmpty());
+
+        const List<Option<S>> xs(Option<S>("a"), Option<S>("b"));
+        const auto ys = xs.sequence();
+        REQUIRE(ys->size() == 2);
+        REQUIRE((*ys)[0] == "a");
+        REQUIRE((*ys)[1] == "b");
+        REQUIRE(xs[0].get() == "a");
+    }
+    SECTION("traverse") {
+        REQUIRE(LI().traverse(half).get() == LI());
+        REQUIRE(LI(2, 4, 6).traverse(half).get() == LI(1, 2, 3));
+        REQUIRE(LI(1).traverse(half).isEmpty());
+
+        int calls = 0;
+        const auto ys = LI(2, 3, 4, 6).traverse([&calls, &half](int x) {
+            ++calls;
+            return half(x);
+        });
+        REQUIRE(ys.isEmpty());
+        REQUIRE(calls == 2);
+
+        const auto zs = LI(1, 2).traverse([](int x) { return Option<PI>(new int(x)); });
+        REQUIRE(zs->size() == 2);
+        REQUIRE(*(*zs)[0] == 1);
+        REQUIRE(*(*zs)[1] == 2);
+    }
+    SECTION("flatMapOption") {
+        REQUIRE(LI().flatMapOption(half) == LI());
+        REQUIRE(LI(1, 3).flatMapOption(half) == LI());
+        REQUIRE(LI(1, 2, 3, 4, 6).flatMapOption(half) == LI(1, 2, 3));
+
+        const LPI xs = LI(1, 2, 3).flatMapOption([](int x) {
+            return x == 2 ? Option<PI>() : Option<PI>(new int(x));
+        });
+        REQUIRE(xs.size() == 2);
+        REQUIRE(*xs[0] == 1);
+        REQUIRE(*xs[1] == 3);
+    }
+}
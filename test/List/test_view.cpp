@@ -0,0 +1,106 @@
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+using gungnir::List;
+
+TEST_CASE("test List view", "[List][view]") {
+
+    using LI = List<int>;
+    using PI = std::unique_ptr<int>;
+
+    SECTION("empty List") {
+        REQUIRE(LI().view().toList().isEmpty());
+        REQUIRE(LI().view().map([](int x) { return x + 1; }).toList().isEmpty());
+        REQUIRE(LI().view().count() == 0);
+        REQUIRE_FALSE(LI().view().exists([](int) { return true; }));
+        REQUIRE(LI().view().forall([](int) { return false; }));
+        REQUIRE(LI().view().sum() == 0);
+    }
+    SECTION("fused transformations") {
+        const LI xs(1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+
+        REQUIRE(xs.view().toList() == xs);
+        REQUIRE(xs.view()
+                .map([](int x) { return x * 10; })
+                .filter([](int x) { return x % 20 == 0; })
+                .take(3)
+                .toList() == LI(20, 40, 60));
+        REQUIRE(xs.view()
+                .filterNot([](int x) { return x % 2 == 0; })
+                .drop(1)
+                .toList() == LI(3, 5, 7, 9));
+        REQUIRE(xs.view()
+                .dropWhile([](int x) { return x < 4; })
+                .takeWhile([](int x) { return x < 7; })
+                .toList() == LI(4, 5, 6));
+        REQUIRE(xs.view()
+                .take(3)
+                .flatMap([](int x) { return LI(x, -x); })
+                .toList() == LI(1, -1, 2, -2, 3, -3));
+        REQUIRE(xs.view().take(0).toList().isEmpty());
+        REQUIRE(xs.view().drop(20).toList().isEmpty());
+
+        const auto ys = xs.view()
+            .map([](int x) { return std::to_string(x); })
+            .take(2)
+            .toList();
+        REQUIRE(ys == List<std::string>("1", "2"));
+
+        const auto zs = xs.view()
+            .zip(List<char>('a', 'b', 'c'))
+            .toList();
+        REQUIRE(zs.size() == 3);
+        REQUIRE(zs[2] == std::make_pair(3, 'c'));
+    }
+    SECTION("move-only results") {
+        const LI xs(1, 2, 3);
+        const auto ys = xs.view()
+            .map([](int x) { return PI(new int(x)); })
+            .filter([](const PI& p) { return *p != 2; })
+            .toList();
+        REQUIRE(ys.size() == 2);
+        REQUIRE(*ys[0] == 1);
+        REQUIRE(*ys[1] == 3);
+    }
+    SECTION("terminal operations") {
+        const LI xs(1, 2, 3, 4, 5);
+        const auto v = xs.view().map([](int x) { return x * 2; });
+
+        REQUIRE(v.foldLeft(std::string(), [](std::string acc, int x) {
+            return acc + std::to_string(x);
+        }) == "246810");
+        REQUIRE(v.count() == 5);
+        REQUIRE(v.count([](int x) { return x > 4; }) == 3);
+        REQUIRE(v.exists([](int x) { return x == 8; }));
+        REQUIRE_FALSE(v.exists([](int x) { return x == 7; }));
+        REQUIRE(v.forall([](int x) { return x % 2 == 0; }));
+        REQUIRE_FALSE(v.forall([](int x) { return x < 10; }));
+        REQUIRE(v.sum() == 30);
+
+        int acc = 0;
+        v.foreach([&acc](int x) { acc = acc * 100 + x; });
+        REQUIRE(acc == 204060810);
+    }
+    SECTION("transformations are lazy and short-circuit") {
+        const LI xs(1, 2, 3, 4, 5);
+        std::size_t calls = 0;
+        const auto v = xs.view().map([&calls](int x) { ++calls; return x; });
+        REQUIRE(calls == 0);
+
+        REQUIRE(v.take(2).toList() == LI(1, 2));
+        REQUIRE(calls == 2);
+
+        calls = 0;
+        REQUIRE(v.exists([](int x) { return x == 3; }));
+        REQUIRE(calls == 3);
+
+        calls = 0;
+        REQUIRE_FALSE(v.forall([](int x) { return x < 2; }));
+        REQUIRE(calls == 2);
+    }
+}
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 
 #include "catch.hpp"
@@ -108,3 +109,67 @@ TEST_CASE("test List zip", "[List][zip]") {
         }
     }
 }
+
+TEST_CASE("test List zipWith, zip3, zipWithIndex and unzip", "[List][zip]") {
+
+    using PI = std::unique_ptr<int>;
+    using PS = std::unique_ptr<std::string>;
+
+    const List<int> xs(1, 2, 3, 4, 5);
+    const List<std::string> ss = xs.map([](int x) { return std::to_string(x); });
+
+    SECTION("zipRef") {
+        REQUIRE(List<PI>().zipRef(List<PS>()).isEmpty());
+
+        const List<PI> ys1 = xs.map([](int x) { return PI(new int(x)); });
+        const List<PS> ys2 = ss.map([](const std::string& s) { return PS(new std::string(s)); });
+        for (int i: {0, 2, 4, 6}) {
+            const auto ys3 = ys1.drop(i);
+            REQUIRE(eqRef(ys3.zipRef(ys2), ys3, ys2));
+            REQUIRE(eqRef(ys2.zipRef(ys3), ys2, ys3));
+        }
+        REQUIRE(&ys1.zipRef(ys2).head().first.get() == &ys1.head());
+    }
+    SECTION("zipWith") {
+        REQUIRE(List<int>().zipWith(ss, [](int, const std::string&) { return 0; }).isEmpty());
+        REQUIRE(xs.zipWith(xs.drop(1), [](int x, int y) { return x * y; }) == List<int>(2, 6, 12, 20));
+        REQUIRE(ss.zipWith(xs.drop(3), [](const std::string& s, int x) {
+            return s + std::to_string(x);
+        }) == List<std::string>("14", "25"));
+
+        const List<PI> ys = xs.map([](int x) { return PI(new int(x)); });
+        REQUIRE(ys.zipWith(ys.drop(1), [](const PI& x, const PI& y) {
+            return *x + *y;
+        }) == List<int>(3, 5, 7, 9));
+    }
+    SECTION("zip3") {
+        REQUIRE(xs.zip3(ss, List<char>()).isEmpty());
+        const auto ts = xs.zip3(ss.drop(1), List<char>('a', 'b', 'c'));
+        const List<std::tuple<int, std::string, char>> expected(
+            std::make_tuple(1, "2", 'a'),
+            std::make_tuple(2, "3", 'b'),
+            std::make_tuple(3, "4", 'c'));
+        REQUIRE(ts == expected);
+    }
+    SECTION("zipWithIndex") {
+        REQUIRE(List<int>().zipWithIndex().isEmpty());
+        const auto is = ss.zipWithIndex();
+        REQUIRE(is.size() == 5);
+        REQUIRE(is.forall([](const std::pair<std::string, std::size_t>& p) {
+            return p.first == std::to_string(p.second + 1);
+        }));
+    }
+    SECTION("unzip") {
+        const auto e = List<std::pair<int, std::string>>().unzip();
+        REQUIRE(e.first.isEmpty());
+        REQUIRE(e.second.isEmpty());
+
+        const auto ps = xs.zip(ss).unzip();
+        REQUIRE(ps.first == xs);
+        REQUIRE(ps.second == ss);
+
+        const auto is = ss.zipWithIndex().unzip();
+        REQUIRE(is.first == ss);
+        REQUIRE(is.second == List<std::size_t>(0, 1, 2, 3, 4));
+    }
+}
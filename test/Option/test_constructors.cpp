@@ -59,11 +59,10 @@ TEST_CASE("test Option constructors", "[Option][constructors]") {
         REQUIRE(*x1 == 123);
         REQUIRE(x1.get() == 123);
 
-        // move constructor
+        // move constructor, which copies a trivially copyable option
         Option<int> x2(std::move(x1));
-        REQUIRE(x1.isEmpty());
-        REQUIRE(x1.ptr() == nullptr);
-        REQUIRE((x1 == nullptr));
+        REQUIRE_FALSE(x1.isEmpty());
+        REQUIRE(x1.get() == 123);
         REQUIRE_FALSE(x2.isEmpty());
         REQUIRE(x2.ptr() != nullptr);
         REQUIRE((x2 != nullptr));
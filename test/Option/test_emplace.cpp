@@ -0,0 +1,107 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "catch.hpp"
+
+#include "gungnir/Option.hpp"
+using gungnir::Option;
+
+namespace {
+
+// Counts the moves of its instances.
+struct Tracked {
+    explicit Tracked(int x) : x(x) {}
+
+    Tracked(Tracked&& that) : x(that.x) { ++moves; }
+
+    Tracked(const Tracked&) = delete;
+
+    int x;
+
+    static int moves;
+};
+
+int Tracked::moves = 0;
+
+struct Throws {
+    explicit Throws(bool b)
+    {
+        if (b) {
+            throw std::runtime_error("Throws");
+        }
+    }
+};
+
+}  // namespace
+
+TEST_CASE("test Option emplace and chaining", "[Option][emplace]") {
+
+    using PI = std::unique_ptr<int>;
+    using S = std::string;
+
+    SECTION("emplace") {
+        Option<S> x;
+        REQUIRE(x.emplace(3, 'a') == "aaa");
+        REQUIRE(x.get() == "aaa");
+        REQUIRE(x.emplace("hello") == "hello");
+        REQUIRE(x.get() == "hello");
+
+        Option<int*> p;
+        int n = 1;
+        *p.emplace(&n) = 2;
+        REQUIRE(n == 2);
+
+        Option<Throws> t(false);
+        REQUIRE_THROWS(t.emplace(true));
+        REQUIRE(t.isEmpty());
+    }
+    SECTION("in-place map") {
+        Tracked::moves = 0;
+        const Option<int> x(123);
+        const auto y = x.map([](int x) { return Tracked(x); });
+        REQUIRE(y->x == 123);
+        REQUIRE(Tracked::moves == 0);
+    }
+    SECTION("filterMove") {
+        Tracked::moves = 0;
+        Option<Tracked> x(1);
+        const auto y = x.filterMove([](const Tracked& t) { return t.x == 1; });
+        REQUIRE(x.isEmpty());
+        REQUIRE(y->x == 1);
+        REQUIRE(Tracked::moves == 1);
+
+        Option<Tracked> z(2);
+        REQUIRE(z.filterMove([](const Tracked& t) { return t.x == 1; }).isEmpty());
+        REQUIRE(z.isEmpty());
+    }
+    SECTION("andThen") {
+        Tracked::moves = 0;
+        const auto x = Option<Tracked>(1)
+            .andThen([](Tracked&& t) { t.x += 1; return Option<Tracked>(std::move(t)); })
+            .andThen([](Tracked&& t) { return Option<int>(t.x * 10); });
+        REQUIRE(x.get() == 20);
+        REQUIRE(Tracked::moves == 1);
+
+        REQUIRE(Option<PI>()
+            .andThen([](PI&& p) { return Option<PI>(std::move(p)); })
+            .isEmpty());
+
+        Option<PI> y(new int(456));
+        const auto z = std::move(y).andThen([](PI&& p) { return Option<PI>(std::move(p)); });
+        REQUIRE(**z == 456);
+    }
+    SECTION("orElse") {
+        const auto x = Option<S>().orElse([] { return Option<S>("fallback"); });
+        REQUIRE(x.get() == "fallback");
+
+        const auto y = Option<S>("value").orElse([] { return Option<S>("fallback"); });
+        REQUIRE(y.get() == "value");
+
+        const auto z = Option<S>()
+            .orElse([] { return Option<S>(); })
+            .andThen([](S&& s) { return Option<S>(s + "!"); });
+        REQUIRE(z.isEmpty());
+    }
+}
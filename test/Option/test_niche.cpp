@@ -0,0 +1,99 @@
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+#include "gungnir/Option.hpp"
+using gungnir::List;
+using gungnir::Option;
+using gungnir::UnownedOption;
+
+namespace {
+
+enum class Color : unsigned char { Red, Green, Blue };
+
+}  // namespace
+
+namespace gungnir {
+
+template<>
+struct OptionNiche<Color> : EnumNiche<Color, Color(0xff)> {};
+
+}  // namespace gungnir
+
+TEST_CASE("test Option niche", "[Option][niche]") {
+
+    SECTION("sizes") {
+        REQUIRE(sizeof (Option<int*>) == sizeof (int*));
+        REQUIRE(sizeof (Option<void (*)()>) == sizeof (void (*)()));
+        REQUIRE(sizeof (Option<float>) == sizeof (float));
+        REQUIRE(sizeof (Option<double>) == sizeof (double));
+        REQUIRE(sizeof (Option<Color>) == sizeof (Color));
+        REQUIRE(sizeof (Option<UnownedOption<int>>) == sizeof (int*));
+        REQUIRE(sizeof (Option<List<int>>) == sizeof (List<int>));
+        REQUIRE(sizeof (Option<std::string>) > sizeof (std::string));
+    }
+    SECTION("pointers") {
+        int x = 123;
+        Option<int*> p1, p2(&x), p3(nullptr);
+        REQUIRE(p1.isEmpty());
+        REQUIRE_FALSE(p2.isEmpty());
+        REQUIRE(*p2.get() == 123);
+        REQUIRE_FALSE(p3.isEmpty());
+        REQUIRE(p3.get() == nullptr);
+
+        p1 = p2;
+        REQUIRE(p1.get() == &x);
+        REQUIRE(p2.get() == &x);
+        p1.clear();
+        REQUIRE(p1.isEmpty());
+    }
+    SECTION("floating-point numbers") {
+        const auto nan = std::numeric_limits<double>::quiet_NaN();
+        Option<double> d1, d2(nan), d3(1.5);
+        REQUIRE(d1.isEmpty());
+        REQUIRE_FALSE(d2.isEmpty());
+        REQUIRE(std::isnan(d2.get()));
+        REQUIRE(d3.get() == 1.5);
+
+        Option<float> f1, f2(std::numeric_limits<float>::signaling_NaN()), f3(-0.0f);
+        REQUIRE(f1.isEmpty());
+        REQUIRE_FALSE(f2.isEmpty());
+        REQUIRE_FALSE(f3.isEmpty());
+        REQUIRE(f3.map([](float f) { return f + 1; }).get() == 1.0f);
+    }
+    SECTION("enums") {
+        Option<Color> c1, c2(Color::Blue);
+        REQUIRE(c1.isEmpty());
+        REQUIRE(c2.get() == Color::Blue);
+    }
+    SECTION("unowned options") {
+        int x = 456;
+        Option<UnownedOption<int>> u1, u2((UnownedOption<int>())), u3 {UnownedOption<int>(&x)};
+        REQUIRE(u1.isEmpty());
+        REQUIRE_FALSE(u2.isEmpty());
+        REQUIRE(u2.get().isEmpty());
+        REQUIRE(u3.get().get() == 456);
+        REQUIRE(u3.flatten().get() == 456);
+    }
+    SECTION("lists") {
+        Option<List<int>> xs1, xs2((List<int>())), xs3(List<int>(1, 2, 3));
+        REQUIRE(xs1.isEmpty());
+        REQUIRE_FALSE(xs2.isEmpty());
+        REQUIRE(xs2->isEmpty());
+        REQUIRE(xs3->size() == 3);
+
+        xs1 = std::move(xs3);
+        REQUIRE(xs3.isEmpty());
+        REQUIRE(xs1.get() == List<int>(1, 2, 3));
+    }
+    SECTION("containers of options") {
+        std::vector<Option<int*>> v(100);
+        for (const auto& p : v) {
+            REQUIRE(p.isEmpty());
+        }
+    }
+}
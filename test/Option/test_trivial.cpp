@@ -0,0 +1,90 @@
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "catch.hpp"
+
+#include "gungnir/Option.hpp"
+using gungnir::Option;
+
+namespace {
+
+struct Point {
+    int x;
+    int y;
+};
+
+struct Twice {
+    constexpr int operator()(int x) const { return 2 * x; }
+};
+
+struct Plus {
+    constexpr int operator()(int x, int y) const { return x + y; }
+};
+
+constexpr Option<int> parseDigit(char c)
+{
+    return c >= '0' && c <= '9' ? Option<int>(c - '0') : Option<int>();
+}
+
+}  // namespace
+
+static_assert(std::is_trivially_copyable<Option<int>>::value, "");
+static_assert(std::is_trivially_copyable<Option<Point>>::value, "");
+static_assert(std::is_trivially_copyable<Option<double>>::value, "");
+static_assert(std::is_trivially_copyable<Option<int*>>::value, "");
+static_assert(std::is_trivially_destructible<Option<int>>::value, "");
+static_assert(std::is_trivially_destructible<Option<Point>>::value, "");
+static_assert(!std::is_trivially_destructible<Option<std::string>>::value, "");
+static_assert(!std::is_copy_constructible<Option<std::string>>::value, "");
+static_assert(!std::is_copy_constructible<Option<std::unique_ptr<int>>>::value, "");
+
+static_assert(parseDigit('7').getOrElse(-1) == 7, "");
+static_assert(parseDigit('x').getOrElse(-1) == -1, "");
+static_assert(parseDigit('x').isEmpty(), "");
+static_assert(parseDigit('4').map(Twice()).getOrElse(0) == 8, "");
+static_assert(parseDigit('x').map(Twice()).isEmpty(), "");
+#if __cplusplus >= 201402L
+static_assert(parseDigit('4').foldLeft(10, Plus()) == 14, "");
+static_assert(parseDigit('x').foldLeft(10, Plus()) == 10, "");
+#endif
+
+TEST_CASE("test trivial Option", "[Option][trivial]") {
+
+    SECTION("copies") {
+        Option<int> x1(123), x2;
+        Option<int> x3(x1);
+        REQUIRE(x3.get() == 123);
+
+        x2 = x1;
+        REQUIRE(x1.get() == 123);
+        REQUIRE(x2.get() == 123);
+
+        x1 = Option<int>();
+        REQUIRE(x1.isEmpty());
+        REQUIRE(x2.get() == 123);
+    }
+    SECTION("bytes") {
+        const Option<Point> p1(Point{1, 2});
+        Option<Point> p2;
+        std::memcpy(&p2, &p1, sizeof p1);
+        REQUIRE(p2->x == 1);
+        REQUIRE(p2->y == 2);
+
+        const Option<Point> p3;
+        std::memcpy(&p2, &p3, sizeof p3);
+        REQUIRE(p2.isEmpty());
+    }
+    SECTION("constant expressions") {
+        constexpr Option<int> x(21);
+        constexpr Option<int> y;
+        static_assert(!x.isEmpty(), "");
+        static_assert(x.get() == 21, "");
+        static_assert(*x == 21, "");
+        static_assert(y.isEmpty(), "");
+        static_assert(!y, "");
+        REQUIRE(x.map(Twice()).get() == 42);
+        REQUIRE(y.foldLeft(1, Plus()) == 1);
+    }
+}
@@ -0,0 +1,98 @@
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+#include "gungnir/PoolAllocator.hpp"
+using gungnir::List;
+using gungnir::LocalAllocator;
+using gungnir::LocalRefCount;
+using gungnir::PoolAllocator;
+
+namespace {
+
+long baseAllocations = 0;
+
+// Counts the allocations made through it, which are all made on the
+// thread running the tests.
+template<typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n)
+    {
+        ++baseAllocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        std::allocator<T>().deallocate(p, n);
+    }
+};
+
+template<typename T, std::size_t Cap = 1024>
+using Pool = PoolAllocator<T, CountingAllocator<T>, Cap>;
+
+}  // namespace
+
+TEST_CASE("test PoolAllocator", "[PoolAllocator]") {
+
+    SECTION("freed nodes are reused") {
+        using L = List<int, Pool<int>>;
+        for (int i = 0; i < 100; ++i) {
+            if (i == 1) {
+                baseAllocations = 0;
+            }
+            const L xs(1, 2, 3, 4);
+            REQUIRE(xs.map([](int x) { return x * 2; }) == L(2, 4, 6, 8));
+        }
+        REQUIRE(baseAllocations == 0);
+    }
+    SECTION("the cache is bounded") {
+        using L = List<std::string, Pool<std::string, 8>>;
+        {
+            L xs;
+            for (int i = 0; i < 32; ++i) {
+                xs = xs.prepend(std::to_string(i));
+            }
+        }
+        baseAllocations = 0;
+        L ys;
+        for (int i = 0; i < 32; ++i) {
+            ys = ys.prepend(std::to_string(i));
+        }
+        REQUIRE(baseAllocations == 24);
+        REQUIRE(ys.size() == 32);
+    }
+    SECTION("nodes can be freed on another thread") {
+        using L = List<int, PoolAllocator<int>>;
+        L xs;
+        std::thread t([&xs] {
+            L ys;
+            for (int i = 0; i < 2000; ++i) {
+                ys = ys.prepend(i);
+            }
+            xs = ys;
+        });
+        t.join();
+        REQUIRE(xs.size() == 2000);
+        REQUIRE(xs.head() == 1999);
+        xs = L();
+        REQUIRE(L(1, 2, 3).sum() == 6);
+    }
+    SECTION("the reference counting policy of the base is kept") {
+        using A = PoolAllocator<int, LocalAllocator<int>>;
+        REQUIRE((std::is_same<A::refcount_policy, LocalRefCount>::value));
+        const List<int, A> xs(1, 2, 3);
+        REQUIRE(xs.tail().tail().head() == 3);
+    }
+}
@@ -0,0 +1,100 @@
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/Queue.hpp"
+using gungnir::List;
+using gungnir::Queue;
+
+namespace {
+
+template<typename A>
+std::vector<A> elementsOf(const Queue<A>& q)
+{
+    std::vector<A> xs;
+    q.foreach([&xs](const A& x) { xs.push_back(x); });
+    return xs;
+}
+
+}  // namespace
+
+TEST_CASE("test Queue", "[Queue]") {
+
+    using QI = Queue<int>;
+
+    SECTION("empty Queue") {
+        const QI q;
+        REQUIRE(q.isEmpty());
+        REQUIRE(q.size() == 0);
+        REQUIRE_THROWS_AS(q.head(), std::out_of_range);
+        REQUIRE_THROWS_AS(q.tail(), std::out_of_range);
+        REQUIRE_THROWS_AS(q.uncons(), std::out_of_range);
+        REQUIRE(q.toList().isEmpty());
+        REQUIRE(q == QI());
+    }
+    SECTION("first in, first out") {
+        const auto q = QI().appended(1).appended(2).appended(3);
+        REQUIRE(q.size() == 3);
+        REQUIRE(q.head() == 1);
+        REQUIRE(q.tail().head() == 2);
+        REQUIRE(q.tail().tail().appended(4).toList() == List<int>(3, 4));
+        const auto p = q.uncons();
+        REQUIRE(p.first.get() == 1);
+        REQUIRE((p.second == QI{2, 3}));
+        REQUIRE(QI(List<int>(1, 2)).appended(3) == q);
+        REQUIRE(q != q.tail());
+        REQUIRE(Queue<std::string>().appended(3, 'x').head() == "xxx");
+    }
+    SECTION("earlier versions are left intact") {
+        std::vector<QI> versions(1);
+        for (int i = 0; i < 100; ++i) {
+            versions.push_back(versions.back().appended(i));
+        }
+        auto q = versions.back();
+        for (int i = 0; i < 50; ++i) {
+            REQUIRE(q.head() == i);
+            q = q.tail();
+            REQUIRE(q.size() == std::size_t(99 - i));
+        }
+        for (int i = 0; i <= 100; ++i) {
+            REQUIRE(versions[i].size() == std::size_t(i));
+            if (i > 0) {
+                REQUIRE(versions[i].head() == 0);
+            }
+        }
+        REQUIRE(versions[3].toList() == List<int>(0, 1, 2));
+    }
+    SECTION("random operations match std::deque") {
+        std::mt19937 rng(42);
+        QI q;
+        std::deque<int> model;
+        bool same = true;
+        for (int i = 0; i < 20000; ++i) {
+            if (model.empty() || rng() % 3 != 0) {
+                q = q.appended(i);
+                model.push_back(i);
+            } else {
+                same = same && q.head() == model.front();
+                q = std::move(q).tail();
+                model.pop_front();
+            }
+            same = same && q.size() == model.size();
+        }
+        REQUIRE(same);
+        const auto xs = elementsOf(q);
+        REQUIRE(std::equal(xs.begin(), xs.end(), model.begin()));
+    }
+    SECTION("rvalue tails do not disturb shared queues") {
+        const auto q = QI().appended(1).appended(2).appended(3).tail();
+        auto r = q;
+        r = std::move(r).tail();
+        REQUIRE(r.toList() == List<int>(3));
+        REQUIRE(q.toList() == List<int>(2, 3));
+    }
+}
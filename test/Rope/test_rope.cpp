@@ -0,0 +1,169 @@
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/Rope.hpp"
+using gungnir::List;
+using gungnir::Rope;
+
+namespace {
+
+std::size_t chunkCount(const Rope& r)
+{
+    std::size_t n = 0;
+    for (const auto& c : r.chunks()) {
+        n += c.size > 0;
+    }
+    return n;
+}
+
+// A height-balanced tree of n leaves is less than 1.45 log2(n + 2) high.
+bool isBalanced(const Rope& r)
+{
+    const auto n = static_cast<double>(chunkCount(r));
+    return static_cast<double>(r.depth()) < 1.45 * std::log2(n + 2);
+}
+
+}  // namespace
+
+TEST_CASE("test Rope", "[Rope]") {
+
+    SECTION("empty Rope") {
+        const Rope r;
+        REQUIRE(r.isEmpty());
+        REQUIRE(r.size() == 0);
+        REQUIRE(r.depth() == 0);
+        REQUIRE(r.toString().empty());
+        REQUIRE(r.toList().isEmpty());
+        REQUIRE(r.chunks().begin() == r.chunks().end());
+        REQUIRE_THROWS_AS(r.charAt(0), std::out_of_range);
+        REQUIRE(r == Rope(""));
+        REQUIRE(r.concat(r).isEmpty());
+        REQUIRE(r.slice(0, 5).isEmpty());
+        REQUIRE(r.insertAt(0, "abc") == Rope("abc"));
+        REQUIRE_THROWS_AS(r.insertAt(1, "abc"), std::out_of_range);
+    }
+    SECTION("basic operations") {
+        const Rope hello("hello, ");
+        const Rope world(std::string("world"));
+        const auto r = hello.concat(world);
+        REQUIRE(r.size() == 12);
+        REQUIRE(r.toString() == "hello, world");
+        REQUIRE(r.charAt(7) == 'w');
+        REQUIRE(r[0] == 'h');
+        REQUIRE_THROWS_AS(r[12], std::out_of_range);
+        REQUIRE(r.take(5) == Rope("hello"));
+        REQUIRE(r.drop(7) == world);
+        REQUIRE(r.slice(3, 9).toString() == "lo, wo");
+        REQUIRE(r.slice(9, 3).isEmpty());
+        REQUIRE(r.slice(5, 100).toString() == ", world");
+        REQUIRE(r.splitAt(5).second.toString() == ", world");
+        REQUIRE(r.insertAt(7, "wide ").toString() == "hello, wide world");
+        REQUIRE(r.removed(5, 7).toString() == "helloworld");
+        REQUIRE(r.removed(7, 5) == r);
+        REQUIRE(r != hello);
+        REQUIRE(hello.toString() == "hello, ");
+    }
+    SECTION("random edits against std::string") {
+        std::mt19937 rng(3);
+        std::string expected;
+        Rope r;
+        std::vector<std::pair<Rope, std::string>> snapshots;
+        bool ok = true;
+        for (int i = 0; i < 5000; ++i) {
+            const auto at = std::uniform_int_distribution<std::size_t>(0, expected.size())(rng);
+            const auto n = std::uniform_int_distribution<std::size_t>(0, 700)(rng);
+            if (i % 3 == 0) {
+                r = r.removed(at, at + n / 4);
+                expected.erase(at, n / 4);
+            } else {
+                const std::string s(n, static_cast<char>('a' + i % 26));
+                r = r.insertAt(at, s);
+                expected.insert(at, s);
+            }
+            ok = ok && r.size() == expected.size();
+            if (i % 250 == 0) {
+                ok = ok && r.toString() == expected && isBalanced(r);
+                snapshots.emplace_back(r, expected);
+            }
+        }
+        REQUIRE(ok);
+        REQUIRE(r.toString() == expected);
+        REQUIRE(isBalanced(r));
+        for (const auto& s : snapshots) {
+            REQUIRE(s.first.toString() == s.second);
+        }
+        for (std::size_t i = 0; i < expected.size(); i += 997) {
+            ok = ok && r.charAt(i) == expected[i];
+            ok = ok && r.slice(i, i + 1500).toString() == expected.substr(i, 1500);
+        }
+        REQUIRE(ok);
+    }
+    SECTION("one character at a time stays in few leaves") {
+        Rope r;
+        std::string expected;
+        for (int i = 0; i < 10000; ++i) {
+            const auto c = std::string(1, static_cast<char>('a' + i % 26));
+            r = r.concat(c);
+            expected += c;
+        }
+        REQUIRE(r.toString() == expected);
+        REQUIRE(chunkCount(r) < 10000 / 100);
+        REQUIRE(isBalanced(r));
+    }
+    SECTION("slices share the text") {
+        const auto text = std::make_shared<const std::string>(std::string(1 << 20, 'x') + "needle");
+        const Rope r(text);
+        const auto tail = r.drop(1 << 20);
+        REQUIRE(tail.toString() == "needle");
+        REQUIRE(tail.chunks().begin()->data == text->data() + (1 << 20));
+        const auto edited = r.insertAt(1000, "!");
+        REQUIRE(edited.charAt(1000) == '!');
+        REQUIRE(chunkCount(edited) == 3);
+        REQUIRE(edited.chunks().begin()->data == text->data());
+        REQUIRE(edited.removed(1000, 1001) == r);
+    }
+    SECTION("chunks and lists") {
+        const auto lines = List<std::string>("first line\n", "second line\n", "", "third\n");
+        const auto r = Rope::fromList(lines);
+        REQUIRE(r.toString() == "first line\nsecond line\nthird\n");
+        REQUIRE(chunkCount(r) == 1);
+        REQUIRE(Rope::fromList(r.toList()) == r);
+
+        List<std::string> big;
+        for (int i = 0; i < 3000; ++i) {
+            big = big.prepend(std::to_string(i) + "\n");
+        }
+        big = big.prepend(std::string(10000, '#'));
+        const auto b = Rope::fromList(big);
+        std::string expected;
+        big.foreach([&expected](const std::string& s) { expected += s; });
+        REQUIRE(b.toString() == expected);
+        REQUIRE(b.toList().foldLeft(std::string(), [](std::string acc, const std::string& s) {
+            return acc + s;
+        }) == expected);
+        REQUIRE(isBalanced(b));
+
+        std::size_t total = 0;
+        for (auto it = b.chunks().begin(); it != b.chunks().end(); ++it) {
+            REQUIRE(it->size > 0);
+            total += it->size;
+        }
+        REQUIRE(total == b.size());
+    }
+    SECTION("equality ignores chunk boundaries") {
+        const auto a = Rope("abc").concat(std::string(600, 'd')).concat("efg");
+        const auto b = Rope(std::string("ab")).concat(Rope("c" + std::string(600, 'd') + "e")).concat("fg");
+        REQUIRE(a == b);
+        REQUIRE(a != b.removed(5, 6).insertAt(5, "x"));
+        REQUIRE(a.concat(a) == b.concat(a));
+        REQUIRE(a.concat(a).size() == 2 * a.size());
+    }
+}
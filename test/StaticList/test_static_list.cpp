@@ -0,0 +1,81 @@
+#include <stdexcept>
+#include <string>
+
+#include "catch.hpp"
+
+#include "gungnir/StaticList.hpp"
+using gungnir::List;
+using gungnir::StaticList;
+using gungnir::staticList;
+
+namespace {
+
+struct Square {
+    constexpr int operator()(int x) const { return x * x; }
+};
+
+struct Plus {
+    constexpr int operator()(int x, int y) const { return x + y; }
+};
+
+struct Minus {
+    constexpr int operator()(int x, int y) const { return x - y; }
+};
+
+struct IsEven {
+    constexpr bool operator()(int x) const { return x % 2 == 0; }
+};
+
+struct Positive {
+    constexpr bool operator()(int x) const { return x > 0; }
+};
+
+constexpr StaticList<int, 4> xs(1, 2, 3, 4);
+constexpr StaticList<int, 0> empty;
+
+}  // namespace
+
+// Everything below is evaluated at compile time.
+static_assert(xs.size() == 4 && !xs.isEmpty() && empty.isEmpty(), "");
+static_assert(xs.head() == 1 && xs.last() == 4 && xs[2] == 3, "");
+static_assert(xs.map(Square()) == StaticList<int, 4>(1, 4, 9, 16), "");
+static_assert(xs.foldLeft(0, Plus()) == 10, "");
+static_assert(xs.foldLeft(0, Minus()) == -10, "");
+static_assert(xs.foldRight(0, Minus()) == -2, "");
+static_assert(xs.exists(IsEven()) && !empty.exists(IsEven()), "");
+static_assert(xs.forall(Positive()) && empty.forall(IsEven()), "");
+static_assert(xs.contains(3) && !xs.contains(5) && !empty.contains(0), "");
+static_assert(xs.count(IsEven()) == 2, "");
+static_assert(staticList(1, 2, 3, 4) == xs && staticList(1, 2, 3, 5) != xs, "");
+static_assert(xs.end() - xs.begin() == 4 && empty.begin() == empty.end(), "");
+
+TEST_CASE("test StaticList", "[StaticList]") {
+
+    SECTION("empty StaticList") {
+        REQUIRE(empty.toList().isEmpty());
+        REQUIRE_THROWS_AS(empty.head(), std::out_of_range);
+        REQUIRE_THROWS_AS(empty.last(), std::out_of_range);
+        REQUIRE_THROWS_AS(empty[0], std::out_of_range);
+        REQUIRE(empty.map(Square()).isEmpty());
+    }
+    SECTION("access") {
+        REQUIRE_THROWS_AS(xs[4], std::out_of_range);
+        int sum = 0;
+        xs.foreach([&sum](int x) { sum += x; });
+        REQUIRE(sum == 10);
+    }
+    SECTION("conversion to List") {
+        REQUIRE(xs.toList() == List<int>(1, 2, 3, 4));
+        REQUIRE(xs.filter(IsEven()) == List<int>(2, 4));
+    }
+    SECTION("non-literal elements") {
+        const auto ss = staticList(std::string("a"), std::string("bb"));
+        const StaticList<std::size_t, 2> sizes(1, 2);
+        REQUIRE(ss.map([](const std::string& s) { return s.size(); }) == sizes);
+        REQUIRE(ss.foldLeft(std::string(), [](std::string acc, const std::string& s) {
+            return acc + s;
+        }) == "abb");
+        REQUIRE(ss.contains("bb"));
+        REQUIRE(ss.toList() == List<std::string>("a", "bb"));
+    }
+}
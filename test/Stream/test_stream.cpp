@@ -0,0 +1,211 @@
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/Option.hpp"
+#include "gungnir/Stream.hpp"
+using gungnir::List;
+using gungnir::Option;
+using gungnir::Stream;
+
+TEST_CASE("test Stream", "[Stream]") {
+
+    using SI = Stream<int>;
+
+    const auto inc = [](int x) { return x + 1; };
+    const auto naturals = [inc] { return SI::iterate(0, inc); };
+
+    SECTION("empty Stream") {
+        const SI s;
+        REQUIRE(s.isEmpty());
+        REQUIRE_THROWS_AS(s.head(), std::out_of_range);
+        REQUIRE_THROWS_AS(s.tail(), std::out_of_range);
+        REQUIRE(s.begin() == s.end());
+        REQUIRE(s.map(inc).isEmpty());
+        REQUIRE(s.take(3).isEmpty());
+        REQUIRE(s.toList().isEmpty());
+    }
+    SECTION("strict construction") {
+        const SI s(1, SI(2, SI()));
+        REQUIRE(s.head() == 1);
+        REQUIRE(s.tail().head() == 2);
+        REQUIRE(s.tail().tail().isEmpty());
+        REQUIRE(s.toList() == List<int>(1, 2));
+    }
+    SECTION("tails are computed once, on first access") {
+        int calls = 0;
+        const auto s = SI::cons(1, [&calls] {
+            ++calls;
+            return SI(2, SI());
+        });
+        REQUIRE(calls == 0);
+        REQUIRE_FALSE(s.isTailForced());
+        REQUIRE(s.tail().head() == 2);
+        REQUIRE(s.tail().head() == 2);
+        REQUIRE(calls == 1);
+        REQUIRE(s.isTailForced());
+    }
+    SECTION("infinite streams") {
+        const auto s = naturals();
+        REQUIRE(s.take(5).toList() == List<int>(0, 1, 2, 3, 4));
+        REQUIRE(s.drop(10).head() == 10);
+        REQUIRE(s.map([](int x) { return x * x; }).take(4).toList() == List<int>(0, 1, 4, 9));
+        REQUIRE(s.filter([](int x) { return x % 3 == 0; }).take(3).toList() == List<int>(0, 3, 6));
+
+        const auto zs = s.zip(s.map([](int x) { return std::to_string(x); })).take(2).toList();
+        using P = std::pair<int, std::string>;
+        REQUIRE((zs == List<P>(P(0, "0"), P(1, "1"))));
+    }
+    SECTION("map and filter are lazy") {
+        int calls = 0;
+        const auto s = naturals().map([&calls](int x) {
+            ++calls;
+            return x * 2;
+        });
+        REQUIRE(calls == 1);
+        REQUIRE(s.drop(3).head() == 6);
+        REQUIRE(calls == 4);
+        REQUIRE(s.drop(3).head() == 6);
+        REQUIRE(calls == 4);
+    }
+    SECTION("unfold") {
+        // Reads "pages" of three elements until a page comes back empty.
+        std::size_t reads = 0;
+        const auto pages = Stream<std::vector<int>>::unfold(0, [&reads](int page) {
+            ++reads;
+            using R = std::pair<std::vector<int>, int>;
+            if (page == 3) {
+                return Option<R>();
+            }
+            return Option<R>(R(std::vector<int>{page, page, page}, page + 1));
+        });
+        REQUIRE(reads == 1);
+        REQUIRE((pages.head() == std::vector<int>{0, 0, 0}));
+        const auto sizes = pages.foldLeft(std::size_t(0), [](std::size_t n, const std::vector<int>& v) {
+            return n + v.size();
+        });
+        REQUIRE(sizes == 9);
+        REQUIRE(reads == 4);
+    }
+    SECTION("foldLeft and foreach") {
+        REQUIRE(naturals().take(101).foldLeft(0, [](int a, int x) { return a + x; }) == 5050);
+
+        const auto s = naturals().take(4);
+        int sum = 0;
+        s.foreach([&sum](int x) { sum += x; });
+        REQUIRE(sum == 6);
+        REQUIRE(s.foldLeft(std::string(), [](std::string a, int x) {
+            return a + std::to_string(x);
+        }) == "0123");
+    }
+    SECTION("iterators") {
+        const auto s = naturals().take(3);
+        std::vector<int> v(s.begin(), s.end());
+        REQUIRE((v == std::vector<int>{0, 1, 2}));
+
+        int sum = 0;
+        for (const auto x : s) {
+            sum += x;
+        }
+        REQUIRE(sum == 3);
+    }
+    SECTION("consuming a long prefix frees the elements passed by") {
+        static std::size_t alive = 0;
+        static std::size_t peak = 0;
+        struct Big {
+            explicit Big(int x) : x(x) { peak = std::max(peak, ++alive); }
+            Big(const Big& that) : x(that.x) { peak = std::max(peak, ++alive); }
+            ~Big() { --alive; }
+            int x;
+        };
+        alive = peak = 0;
+        const auto n = Stream<int>::iterate(0, inc)
+            .map([](int x) { return Big(x); })
+            .take(200000)
+            .foldLeft(0L, [](long a, const Big& b) { return a + b.x; });
+        REQUIRE(n == 199999L * 200000 / 2);
+        REQUIRE(peak < 16);
+        REQUIRE(alive == 0);
+    }
+    SECTION("dropping a long computed stream") {
+        auto s = naturals();
+        REQUIRE(s.drop(500000).head() == 500000);
+        s = SI();
+        REQUIRE(s.isEmpty());
+    }
+}
+
+TEST_CASE("test Stream from input", "[Stream]") {
+
+    using SI = Stream<int>;
+
+    std::size_t parsed = 0;
+    const auto parseInt = [&parsed](std::istream& in) {
+        int x;
+        if (in >> x) {
+            ++parsed;
+            return Option<int>(x);
+        }
+        return Option<int>();
+    };
+
+    SECTION("empty input") {
+        std::istringstream in("");
+        REQUIRE(SI::fromInput(in, parseInt).isEmpty());
+        REQUIRE(SI::from(std::istream_iterator<int>(in), std::istream_iterator<int>()).isEmpty());
+    }
+    SECTION("records are parsed a chunk at a time") {
+        std::istringstream in("1 2 3 4 5 6 7 8 9 10");
+        const auto s = SI::fromInput(in, parseInt, 4);
+        REQUIRE(parsed == 4);
+        REQUIRE(s.take(4).toList() == List<int>(1, 2, 3, 4));
+        REQUIRE(parsed == 4);
+        REQUIRE(s.drop(4).head() == 5);
+        REQUIRE(parsed == 8);
+        REQUIRE(s.toList() == List<int>(1, 2, 3, 4, 5, 6, 7, 8, 9, 10));
+        REQUIRE(parsed == 10);
+
+        std::istringstream exact("1 2 3 4");
+        REQUIRE(SI::fromInput(exact, parseInt, 2).toList() == List<int>(1, 2, 3, 4));
+    }
+    SECTION("single-pass iterators") {
+        std::istringstream in("1 2 3 4 5 6 7");
+        const auto s = SI::from(std::istream_iterator<int>(in), std::istream_iterator<int>(), 3);
+        REQUIRE(s.toList() == List<int>(1, 2, 3, 4, 5, 6, 7));
+
+        std::istringstream again("7 6 5");
+        const List<int> xs(std::istream_iterator<int>(again), (std::istream_iterator<int>()));
+        REQUIRE(xs == List<int>(7, 6, 5));
+    }
+    SECTION("folding a long input holds one chunk at a time") {
+        static std::size_t alive = 0;
+        static std::size_t peak = 0;
+        struct Big {
+            explicit Big(int x) : x(x) { peak = std::max(peak, ++alive); }
+            Big(const Big& that) : x(that.x) { peak = std::max(peak, ++alive); }
+            Big(Big&& that) : x(that.x) { peak = std::max(peak, ++alive); }
+            ~Big() { --alive; }
+            int x;
+        };
+        std::ostringstream out;
+        for (int i = 0; i < 100000; ++i) {
+            out << i << ' ';
+        }
+        std::istringstream in(out.str());
+        alive = peak = 0;
+        const auto n = Stream<Big>::fromInput(in, [](std::istream& is) {
+            int x;
+            return is >> x ? Option<Big>(x) : Option<Big>();
+        }, 64).foldLeft(0L, [](long a, const Big& b) { return a + b.x; });
+        REQUIRE(n == 99999L * 100000 / 2);
+        REQUIRE(peak < 3 * 64);
+        REQUIRE(alive == 0);
+    }
+}
@@ -0,0 +1,193 @@
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/TreeMap.hpp"
+using gungnir::List;
+using gungnir::TreeMap;
+
+namespace {
+
+template<typename M, typename K, typename V>
+bool matches(const M& m, const std::map<K, V>& expected)
+{
+    if (m.size() != expected.size()) {
+        return false;
+    }
+    auto it = expected.begin();
+    return m.forall([&it](const std::pair<const K, V>& e) {
+        const auto ok = e.first == it->first && e.second == it->second;
+        ++it;
+        return ok;
+    });
+}
+
+}  // namespace
+
+TEST_CASE("test TreeMap", "[TreeMap]") {
+
+    using MIS = TreeMap<int, std::string>;
+    using E = std::pair<const int, int>;
+
+    SECTION("empty TreeMap") {
+        const MIS m;
+        REQUIRE(m.isEmpty());
+        REQUIRE(m.size() == 0);
+        REQUIRE_FALSE(m.contains(1));
+        REQUIRE(m.get(1).isEmpty());
+        REQUIRE_THROWS_AS(m[1], std::out_of_range);
+        REQUIRE(m.min().isEmpty());
+        REQUIRE(m.max().isEmpty());
+        REQUIRE(m.removed(1).isEmpty());
+        REQUIRE(m.range(0, 10).isEmpty());
+        REQUIRE(m.toList().isEmpty());
+        REQUIRE(m == MIS());
+    }
+    SECTION("constructors") {
+        const MIS m { {2, "two"}, {1, "one"}, {2, "dos"} };
+        REQUIRE(m.size() == 2);
+        REQUIRE(m[1] == "one");
+        REQUIRE(m[2] == "dos");
+        REQUIRE(m.min().get().first == 1);
+        REQUIRE(m.max().get().second == "dos");
+
+        const std::vector<std::pair<const int, std::string>> v { {4, "four"}, {3, "three"} };
+        const MIS n(v.begin(), v.end());
+        REQUIRE(n.size() == 2);
+        REQUIRE(n.toList().head().second == "three");
+    }
+    SECTION("updated and removed are persistent") {
+        const MIS m1;
+        const auto m2 = m1.updated(1, "one");
+        const auto m3 = m2.updated(2, 3, 'x');
+        const auto m4 = m3.updated(1, "uno");
+        const auto m5 = m4.removed(2);
+        REQUIRE(m1.isEmpty());
+        REQUIRE(m2.size() == 1);
+        REQUIRE(m3[2] == "xxx");
+        REQUIRE(m4[1] == "uno");
+        REQUIRE(m3[1] == "one");
+        REQUIRE(m5.size() == 1);
+        REQUIRE_FALSE(m5.contains(2));
+        REQUIRE(m4.contains(2));
+        REQUIRE(m5.removed(3) == m5);
+    }
+    SECTION("many entries against std::map") {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> key(0, 5000);
+        std::map<int, int> expected;
+        TreeMap<int, int> m;
+        std::vector<std::pair<TreeMap<int, int>, std::map<int, int>>> snapshots;
+        for (int i = 0; i < 20000; ++i) {
+            const auto k = key(rng);
+            if (i % 3 == 0) {
+                m = m.removed(k);
+                expected.erase(k);
+            } else {
+                m = m.updated(k, i);
+                expected[k] = i;
+            }
+            if (i % 4000 == 0) {
+                snapshots.emplace_back(m, expected);
+            }
+        }
+        REQUIRE(matches(m, expected));
+        for (const auto& s : snapshots) {
+            REQUIRE(matches(s.first, s.second));
+        }
+        REQUIRE(m.min().get().first == expected.begin()->first);
+        REQUIRE(m.max().get().first == expected.rbegin()->first);
+    }
+    SECTION("range queries") {
+        TreeMap<int, int> m;
+        std::map<int, int> all;
+        for (int i = 0; i < 1000; i += 3) {
+            m = m.updated(i, -i);
+            all[i] = -i;
+        }
+        bool ok = true;
+        for (int lo = -5; lo < 1010; lo += 41) {
+            for (int hi = lo - 1; hi < 1010; hi += 53) {
+                const std::map<int, int> expected(all.lower_bound(lo),
+                                                  hi < lo ? all.lower_bound(lo) : all.lower_bound(hi));
+                ok = ok && matches(m.range(lo, hi), expected);
+            }
+            ok = ok && matches(m.from(lo), std::map<int, int>(all.lower_bound(lo), all.end()));
+            ok = ok && matches(m.until(lo), std::map<int, int>(all.begin(), all.lower_bound(lo)));
+        }
+        REQUIRE(ok);
+
+        const auto r = m.range(300, 310);
+        REQUIRE(r.size() == 4);
+        REQUIRE(r.toList() == List<E>(E(300, -300), E(303, -303), E(306, -306), E(309, -309)));
+        REQUIRE(m.size() == 334);
+    }
+    SECTION("fromSorted") {
+        using P = std::pair<int, std::string>;
+        const auto xs = List<P>(P(3, "c"), P(1, "a"), P(2, "b"), P(1, "x"))
+            .sorted([](const P& a, const P& b) { return a.first < b.first; });
+        const auto m = MIS::fromSorted(xs);
+        REQUIRE((m == MIS { {1, "x"}, {2, "b"}, {3, "c"} }));
+        REQUIRE(MIS::fromSorted(List<P>()).isEmpty());
+        REQUIRE_THROWS_AS(MIS::fromSorted(List<P>(P(2, "b"), P(1, "a"))), std::invalid_argument);
+
+        gungnir::ListBuilder<E> buf;
+        for (int i = 0; i < 10000; ++i) {
+            buf.append(i, i * i);
+        }
+        const auto big = TreeMap<int, int>::fromSorted(buf.result());
+        REQUIRE(big.size() == 10000);
+        REQUIRE(big[9999] == 9999 * 9999);
+        REQUIRE(big.updated(-1, 1).removed(5000).size() == 10000);
+    }
+    SECTION("map, filter and folds") {
+        TreeMap<int, int> m;
+        for (int i = 0; i < 1000; ++i) {
+            m = m.updated(i, i);
+        }
+
+        const auto s = m.map([](const E& e) { return std::to_string(e.second * 2); });
+        REQUIRE(s.size() == 1000);
+        REQUIRE(s[123] == "246");
+        REQUIRE(s.min().get().second == "0");
+
+        const auto evens = m.filter([](const E& e) { return e.first % 2 == 0; });
+        const auto odds = m.filterNot([](const E& e) { return e.first % 2 == 0; });
+        REQUIRE(evens.size() == 500);
+        REQUIRE(odds.size() == 500);
+        REQUIRE(odds.min().get().first == 1);
+        REQUIRE(m.filter([](const E&) { return true; }) == m);
+        REQUIRE(m.filter([](const E&) { return false; }).isEmpty());
+
+        auto rebuilt = evens;
+        odds.foreach([&rebuilt](const E& e) {
+            rebuilt = rebuilt.updated(e.first, e.second);
+        });
+        REQUIRE(rebuilt == m);
+        REQUIRE(rebuilt != evens);
+        REQUIRE(rebuilt.updated(5, 6) != m);
+
+        const auto keys = m.foldLeft(List<int>(), [](List<int> acc, const E& e) {
+            return acc.prepend(e.first);
+        });
+        REQUIRE(keys.head() == 999);
+        REQUIRE(keys.last() == 0);
+        REQUIRE(m.count([](const E& e) { return e.second < 10; }) == 10);
+        REQUIRE(m.exists([](const E& e) { return e.second == 500; }));
+        REQUIRE_FALSE(m.exists([](const E& e) { return e.second == 1000; }));
+        REQUIRE(m.forall([](const E& e) { return e.second >= 0; }));
+    }
+    SECTION("custom ordering") {
+        TreeMap<int, int, std::greater<int>> m { {1, 1}, {3, 3}, {2, 2} };
+        REQUIRE(m.min().get().first == 3);
+        REQUIRE(m.range(3, 1).size() == 2);
+        REQUIRE(m.range(3, 1).max().get().first == 2);
+    }
+}
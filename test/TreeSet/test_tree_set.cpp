@@ -0,0 +1,89 @@
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/TreeSet.hpp"
+using gungnir::List;
+using gungnir::TreeSet;
+
+namespace {
+
+template<typename A>
+bool matches(const TreeSet<A>& s, const std::set<A>& expected)
+{
+    return s.size() == expected.size()
+        && s.toList() == List<A>(expected.begin(), expected.end());
+}
+
+}  // namespace
+
+TEST_CASE("test TreeSet", "[TreeSet]") {
+
+    using SI = TreeSet<int>;
+
+    SECTION("empty TreeSet") {
+        const SI s;
+        REQUIRE(s.isEmpty());
+        REQUIRE_FALSE(s.contains(0));
+        REQUIRE(s.min().isEmpty());
+        REQUIRE(s.removed(0).isEmpty());
+        REQUIRE(s.range(0, 1).isEmpty());
+        REQUIRE(s == SI());
+    }
+    SECTION("added and removed are persistent") {
+        const SI s1 { 3, 1, 2 };
+        const auto s2 = s1.added(5);
+        const auto s3 = s2.removed(1);
+        REQUIRE(s1.toList() == List<int>(1, 2, 3));
+        REQUIRE(s2.toList() == List<int>(1, 2, 3, 5));
+        REQUIRE(s3.toList() == List<int>(2, 3, 5));
+        REQUIRE(s1.added(2) == s1);
+        REQUIRE(s3.min().get() == 2);
+        REQUIRE(s3.max().get() == 5);
+    }
+    SECTION("many elements against std::set") {
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<int> x(-2000, 2000);
+        std::set<int> expected;
+        SI s;
+        for (int i = 0; i < 10000; ++i) {
+            const auto k = x(rng);
+            if (i % 4 == 0) {
+                s = s.removed(k);
+                expected.erase(k);
+            } else {
+                s = s.added(k);
+                expected.insert(k);
+            }
+        }
+        REQUIRE(matches(s, expected));
+
+        const auto r = s.range(-100, 250);
+        REQUIRE(matches(r, std::set<int>(expected.lower_bound(-100), expected.lower_bound(250))));
+        REQUIRE(matches(s.from(0), std::set<int>(expected.lower_bound(0), expected.end())));
+        REQUIRE(matches(s.until(0), std::set<int>(expected.begin(), expected.lower_bound(0))));
+        REQUIRE(s.from(0).size() + s.until(0).size() == s.size());
+    }
+    SECTION("fromSorted replaces per-insert sorting") {
+        const auto words = List<std::string>("pear", "apple", "fig", "apple", "kiwi").sorted();
+        const auto s = TreeSet<std::string>::fromSorted(words);
+        REQUIRE(s.size() == 4);
+        REQUIRE(s.toList() == List<std::string>("apple", "fig", "kiwi", "pear"));
+        REQUIRE(s.range("b", "l").toList() == List<std::string>("fig", "kiwi"));
+        REQUIRE_THROWS_AS(SI::fromSorted(List<int>(1, 0)), std::invalid_argument);
+    }
+    SECTION("filter and folds") {
+        const auto s = SI::fromSorted(List<int>(1, 2, 3, 4, 5, 6));
+        REQUIRE((s.filter([](int x) { return x % 2 == 0; }) == SI { 2, 4, 6 }));
+        REQUIRE((s.filterNot([](int x) { return x % 2 == 0; }) == SI { 1, 3, 5 }));
+        REQUIRE(s.foldLeft(0, [](int a, int x) { return a * 10 + x; }) == 123456);
+        REQUIRE(s.count([](int x) { return x > 4; }) == 2);
+        REQUIRE(s.exists([](int x) { return x == 6; }));
+        REQUIRE(s.forall([](int x) { return x > 0; }));
+        REQUIRE(s != s.removed(6));
+    }
+}
@@ -0,0 +1,70 @@
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/UnrolledList.hpp"
+using gungnir::UnrolledList;
+
+TEST_CASE("test UnrolledList constructors", "[UnrolledList][constructors]") {
+
+    using LI = UnrolledList<int>;
+    using PI = std::unique_ptr<int>;
+
+    SECTION("empty UnrolledList") {
+        const LI xs;
+        REQUIRE(xs.isEmpty());
+        REQUIRE(xs.size() == 0);
+        REQUIRE(xs.begin() == xs.end());
+    }
+    SECTION("UnrolledList with one element") {
+        const LI xs(123);
+        REQUIRE(xs.size() == 1);
+        REQUIRE(xs.head() == 123);
+
+        const UnrolledList<PI> ys(PI(new int(456)));
+        REQUIRE(*ys.head() == 456);
+    }
+    SECTION("UnrolledList with multiple elements") {
+        const LI xs(1, 2, 3, 4, 5);
+        REQUIRE(xs.size() == 5);
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(xs[i] == i + 1);
+        }
+
+        const UnrolledList<PI> ys(PI(new int(1)), PI(new int(2)));
+        REQUIRE(*ys[0] == 1);
+        REQUIRE(*ys[1] == 2);
+
+        const UnrolledList<std::string> zs("a", "bc");
+        REQUIRE(zs[1] == "bc");
+    }
+    SECTION("UnrolledList from a range") {
+        for (std::size_t n : { 0, 1, 15, 16, 17, 100, 1000 }) {
+            std::vector<int> v;
+            for (std::size_t i = 0; i < n; ++i) {
+                v.push_back(static_cast<int>(i));
+            }
+            const LI xs(v.begin(), v.end());
+            REQUIRE(xs.size() == n);
+            REQUIRE(std::vector<int>(xs.begin(), xs.end()) == v);
+        }
+    }
+    SECTION("moved UnrolledList") {
+        LI xs(1, 2, 3);
+        const LI ys = std::move(xs);
+        REQUIRE(ys == LI(1, 2, 3));
+        REQUIRE(xs.isEmpty());
+    }
+    SECTION("long UnrolledList is destroyed without recursion") {
+        LI xs;
+        for (int i = 0; i < (1 << 21); ++i) {
+            xs = xs.prepend(i);
+        }
+        REQUIRE(xs.size() == (1 << 21));
+        REQUIRE(xs.head() == (1 << 21) - 1);
+    }
+}
@@ -0,0 +1,71 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "catch.hpp"
+
+#include "gungnir/UnrolledList.hpp"
+using gungnir::UnrolledList;
+
+TEST_CASE("test UnrolledList prepend and tail", "[UnrolledList][prepend]") {
+
+    using LI = UnrolledList<int, std::allocator<int>, 4>;
+
+    SECTION("empty UnrolledList") {
+        REQUIRE_THROWS_AS(LI().head(), std::out_of_range);
+        REQUIRE_THROWS_AS(LI().tail(), std::out_of_range);
+        REQUIRE_THROWS_AS(LI().last(), std::out_of_range);
+    }
+    SECTION("prepend fills nodes and shares them") {
+        LI xs;
+        for (int i = 9; i >= 0; --i) {
+            xs = xs.prepend(i);
+        }
+        REQUIRE(xs.size() == 10);
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(xs[i] == i);
+        }
+        REQUIRE(xs.last() == 9);
+
+        auto ys = xs;
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(ys.head() == i);
+            REQUIRE(&ys.head() == &xs[i]);
+            ys = ys.tail();
+        }
+        REQUIRE(ys.isEmpty());
+    }
+    SECTION("prepending to a list twice keeps both results intact") {
+        const LI xs(1, 2, 3);
+        const auto ys = xs.prepend(10);
+        const auto zs = xs.prepend(20);
+        const auto ws = xs.tail().prepend(30);
+        REQUIRE(xs == LI(1, 2, 3));
+        REQUIRE(ys == LI(10, 1, 2, 3));
+        REQUIRE(zs == LI(20, 1, 2, 3));
+        REQUIRE(ws == LI(30, 2, 3));
+        REQUIRE(&ys[1] == &xs[0]);
+        REQUIRE(&zs[1] == &xs[0]);
+    }
+    SECTION("failed construction gives the slot back") {
+        struct Thrower {
+            explicit Thrower(bool fail) : s("x")
+            {
+                if (fail) {
+                    throw std::runtime_error("fail");
+                }
+            }
+            std::string s;
+        };
+        using LT = UnrolledList<Thrower, std::allocator<Thrower>, 4>;
+        const auto xs = LT().prepend(false);
+        REQUIRE_THROWS_AS(xs.prepend(true), std::runtime_error);
+        const auto ys = xs.prepend(false);
+        REQUIRE(ys.size() == 2);
+        REQUIRE(ys.head().s == "x");
+    }
+    SECTION("elements are constructed in-place") {
+        const auto xs = UnrolledList<std::string>().prepend(3, 'a');
+        REQUIRE(xs.head() == "aaa");
+    }
+}
@@ -0,0 +1,62 @@
+#include <string>
+
+#include "catch.hpp"
+
+#include "gungnir/UnrolledList.hpp"
+using gungnir::UnrolledList;
+
+TEST_CASE("test UnrolledList operations", "[UnrolledList][transform]") {
+
+    using LI = UnrolledList<int, std::allocator<int>, 8>;
+
+    LI xs;
+    for (int i = 99; i >= 0; --i) {
+        xs = xs.prepend(i);
+    }
+
+    SECTION("map, filter and filterNot") {
+        REQUIRE(LI().map([](int x) { return x; }).isEmpty());
+        const auto ys = xs.map([](int x) { return std::to_string(x); });
+        REQUIRE(ys.size() == 100);
+        REQUIRE(ys[42] == "42");
+
+        const auto even = [](int x) { return x % 2 == 0; };
+        REQUIRE(xs.filter(even).size() == 50);
+        REQUIRE(xs.filter(even)[10] == 20);
+        REQUIRE(xs.filterNot(even)[10] == 21);
+    }
+    SECTION("reverse, take and drop") {
+        REQUIRE(LI(1, 2, 3).reverse() == LI(3, 2, 1));
+        REQUIRE(xs.take(0).isEmpty());
+        REQUIRE(xs.take(3) == LI(0, 1, 2));
+        REQUIRE(xs.take(200) == xs);
+        REQUIRE(xs.drop(97) == LI(97, 98, 99));
+        REQUIRE(xs.drop(8).head() == 8);
+        REQUIRE(xs.drop(100).isEmpty());
+        REQUIRE(xs.tail().drop(7).head() == 8);
+    }
+    SECTION("scans") {
+        REQUIRE(xs.exists([](int x) { return x == 77; }));
+        REQUIRE_FALSE(xs.exists([](int x) { return x == 100; }));
+        REQUIRE(xs.forall([](int x) { return x < 100; }));
+        REQUIRE(xs.contains(64));
+        REQUIRE_FALSE(xs.contains(-1));
+        REQUIRE(LI(1, 2, 1).count(1) == 2);
+        REQUIRE(xs.count([](int x) { return x % 10 == 0; }) == 10);
+        REQUIRE(xs.sum() == 4950);
+        REQUIRE(xs.foldLeft(std::string(), [](std::string acc, int x) {
+            return x < 3 ? acc + std::to_string(x) : acc;
+        }) == "012");
+        REQUIRE(LI(1, 2, 3).foldRight(std::string(), [](int x, std::string acc) {
+            return acc + std::to_string(x);
+        }) == "321");
+    }
+    SECTION("concat and equality") {
+        REQUIRE(LI().concat(LI()).isEmpty());
+        const auto ys = xs.take(10).concat(xs.drop(10));
+        REQUIRE(ys == xs);
+        REQUIRE(&ys[10] == &xs[10]);
+        REQUIRE(LI(1, 2) != LI(1, 3));
+        REQUIRE(LI(1, 2) != LI(1, 2, 3));
+    }
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/Vector.hpp"
+using gungnir::Vector;
+
+TEST_CASE("test Vector element access", "[Vector][access]") {
+
+    using VI = Vector<int>;
+
+    SECTION("empty Vector") {
+        const VI xs;
+        REQUIRE_THROWS_AS(xs.head(), std::out_of_range);
+        REQUIRE_THROWS_AS(xs.last(), std::out_of_range);
+        REQUIRE_THROWS_AS(xs[0], std::out_of_range);
+    }
+    SECTION("head, last and operator[]") {
+        VI xs;
+        for (int i = 0; i < 5000; ++i) {
+            xs = xs.appended(i);
+        }
+        REQUIRE(xs.head() == 0);
+        REQUIRE(xs.last() == 4999);
+        REQUIRE(xs[31] == 31);
+        REQUIRE(xs[32] == 32);
+        REQUIRE(xs[1024] == 1024);
+        REQUIRE(xs[4096] == 4096);
+        REQUIRE_THROWS_AS(xs[5000], std::out_of_range);
+    }
+    SECTION("iterators") {
+        VI xs;
+        for (int i = 0; i < 100; ++i) {
+            xs = xs.appended(i);
+        }
+        int i = 0;
+        for (const auto& x : xs) {
+            REQUIRE(x == i++);
+        }
+        REQUIRE(i == 100);
+
+        auto it = xs.begin();
+        REQUIRE(*it++ == 0);
+        REQUIRE(*it == 1);
+        REQUIRE(*++it == 2);
+    }
+    SECTION("random access iterators") {
+        using IT = std::iterator_traits<VI::StdIterator>;
+        REQUIRE((std::is_same<std::random_access_iterator_tag, IT::iterator_category>::value));
+
+        VI xs;
+        for (int i = 0; i < 1000; ++i) {
+            xs = xs.appended(2 * i);
+        }
+        const auto b = xs.begin(), e = xs.end();
+        REQUIRE(e - b == 1000);
+        REQUIRE(std::distance(b, e) == 1000);
+        REQUIRE(b[999] == 1998);
+        REQUIRE(*(b + 33) == 66);
+        REQUIRE(*(33 + b) == 66);
+        REQUIRE(*(e - 1) == 1998);
+        REQUIRE(*(e - 968) == 64);
+        REQUIRE(b < e);
+        REQUIRE(e >= b);
+
+        for (int i : {0, 1, 31, 32, 33, 500, 991, 992, 999}) {
+            REQUIRE(*std::lower_bound(b, e, 2 * i) == 2 * i);
+            REQUIRE(std::lower_bound(b, e, 2 * i - 1) - b == i);
+        }
+        REQUIRE(std::lower_bound(b, e, 5000) == e);
+
+        auto it = e;
+        for (int i = 999; i >= 0; --i) {
+            REQUIRE(*--it == 2 * i);
+        }
+        REQUIRE(it == b);
+        it += 64;
+        REQUIRE(*it-- == 128);
+        REQUIRE(*it == 126);
+        it -= 63;
+        REQUIRE(it == b);
+
+        std::vector<int> v(xs.begin(), xs.end());
+        std::reverse(v.begin(), v.end());
+        REQUIRE(std::equal(v.begin(), v.end(),
+                           std::reverse_iterator<VI::StdIterator>(e)));
+    }
+}
@@ -0,0 +1,41 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/Vector.hpp"
+using gungnir::Vector;
+
+TEST_CASE("test Vector appended", "[Vector][appended]") {
+
+    using VI = Vector<int>;
+
+    SECTION("appending keeps earlier versions intact") {
+        std::vector<VI> versions(1);
+        for (int i = 0; i < 1100; ++i) {
+            versions.push_back(versions.back().appended(i));
+        }
+        for (std::size_t n = 0; n < versions.size(); n += 37) {
+            const auto& xs = versions[n];
+            REQUIRE(xs.size() == n);
+            bool ok = true;
+            for (std::size_t i = 0; i < n; ++i) {
+                ok = ok && xs[i] == static_cast<int>(i);
+            }
+            REQUIRE(ok);
+        }
+    }
+    SECTION("appending to the same version twice") {
+        const VI xs(1, 2, 3);
+        const auto ys = xs.appended(4);
+        const auto zs = xs.appended(5);
+        REQUIRE(xs == VI(1, 2, 3));
+        REQUIRE(ys == VI(1, 2, 3, 4));
+        REQUIRE(zs == VI(1, 2, 3, 5));
+    }
+    SECTION("elements are constructed in-place") {
+        const auto xs = Vector<std::string>().appended(3, 'a');
+        REQUIRE(xs[0] == "aaa");
+    }
+}
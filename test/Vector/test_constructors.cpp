@@ -0,0 +1,74 @@
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/Vector.hpp"
+using gungnir::Vector;
+
+TEST_CASE("test Vector constructors", "[Vector][constructors]") {
+
+    using VI = Vector<int>;
+    using PI = std::unique_ptr<int>;
+
+    SECTION("empty Vector") {
+        const VI xs;
+        REQUIRE(xs.isEmpty());
+        REQUIRE(xs.size() == 0);
+        REQUIRE(xs.begin() == xs.end());
+    }
+    SECTION("Vector with one element") {
+        const VI xs(123);
+        REQUIRE_FALSE(xs.isEmpty());
+        REQUIRE(xs.size() == 1);
+        REQUIRE(xs[0] == 123);
+
+        const Vector<PI> ys(PI(new int(456)));
+        REQUIRE(ys.size() == 1);
+        REQUIRE(*ys[0] == 456);
+    }
+    SECTION("Vector with multiple elements") {
+        const VI xs(1, 2, 3, 4, 5);
+        REQUIRE(xs.size() == 5);
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(xs[i] == i + 1);
+        }
+
+        const Vector<PI> ys(PI(new int(1)), PI(new int(2)));
+        REQUIRE(ys.size() == 2);
+        REQUIRE(*ys[0] == 1);
+        REQUIRE(*ys[1] == 2);
+
+        const Vector<std::string> zs("a", "bc");
+        REQUIRE(zs[1] == "bc");
+    }
+    SECTION("Vector from a range") {
+        for (std::size_t n : { 0, 1, 31, 32, 33, 64, 1024, 1056, 1057, 40000 }) {
+            std::vector<int> v;
+            for (std::size_t i = 0; i < n; ++i) {
+                v.push_back(static_cast<int>(i));
+            }
+            const VI xs(v.begin(), v.end());
+            REQUIRE(xs.size() == n);
+            bool ok = true;
+            for (std::size_t i = 0; i < n; ++i) {
+                ok = ok && xs[i] == static_cast<int>(i);
+            }
+            REQUIRE(ok);
+        }
+    }
+    SECTION("copied and moved Vectors") {
+        VI xs(1, 2, 3);
+        const VI ys = xs;
+        REQUIRE(ys == xs);
+
+        const VI zs = std::move(xs);
+        REQUIRE(zs == VI(1, 2, 3));
+        REQUIRE(xs.isEmpty());
+
+        xs = zs;
+        REQUIRE(xs == zs);
+    }
+}
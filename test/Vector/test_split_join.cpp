@@ -0,0 +1,213 @@
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/Vector.hpp"
+using gungnir::ParallelPolicy;
+using gungnir::Vector;
+
+namespace {
+
+using VI = Vector<int>;
+
+VI range(int from, int until)
+{
+    VI xs;
+    for (int i = from; i < until; ++i) {
+        xs = xs.appended(i);
+    }
+    return xs;
+}
+
+std::vector<int> range(const std::vector<int>& v, std::size_t from, std::size_t until)
+{
+    return std::vector<int>(v.begin() + from, v.begin() + until);
+}
+
+// Whether `xs` holds the elements of `v`, by index and by iteration in
+// both directions.
+bool same(const VI& xs, const std::vector<int>& v)
+{
+    if (xs.size() != v.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        if (xs[i] != v[i]) {
+            return false;
+        }
+    }
+    std::size_t i = 0;
+    for (auto it = xs.begin(); it != xs.end(); ++it, ++i) {
+        if (*it != v[i]) {
+            return false;
+        }
+    }
+    for (auto it = xs.end(); it != xs.begin();) {
+        --it;
+        if (*it != v[--i]) {
+            return false;
+        }
+    }
+    for (std::size_t k = 0; k < v.size(); k += 97) {
+        if (*(xs.begin() + static_cast<std::ptrdiff_t>(k)) != v[k]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE("test Vector split and join", "[Vector][split]") {
+
+    SECTION("concat of tries") {
+        for (int n : { 33, 100, 1025, 5000 }) {
+            for (int m : { 33, 64, 1000, 40000 }) {
+                const auto xs = range(0, n);
+                const auto ys = range(n, n + m);
+                const auto zs = xs.concat(ys);
+                std::vector<int> v;
+                for (int i = 0; i < n + m; ++i) {
+                    v.push_back(i);
+                }
+                REQUIRE(same(zs, v));
+                REQUIRE(same(xs, range(v, 0, n)));
+                REQUIRE(same(ys, range(v, n, n + m)));
+            }
+        }
+    }
+    SECTION("slice, splitAt and drop at every kind of boundary") {
+        const auto xs = range(0, 3000);
+        std::vector<int> v;
+        for (int i = 0; i < 3000; ++i) {
+            v.push_back(i);
+        }
+        bool ok = true;
+        for (std::size_t from : { 0, 1, 31, 32, 33, 1000, 1023, 1024, 2976, 2999 }) {
+            for (std::size_t until : { 0, 1, 32, 64, 1024, 1025, 2975, 2976, 2977, 3000, 4000 }) {
+                const auto ys = xs.slice(from, until);
+                const auto end = std::min<std::size_t>(until, 3000);
+                ok = ok && same(ys, from < end ? range(v, from, end) : std::vector<int>());
+            }
+        }
+        REQUIRE(ok);
+        const auto p = xs.splitAt(1500);
+        REQUIRE(same(p.first, range(v, 0, 1500)));
+        REQUIRE(same(p.second, range(v, 1500, 3000)));
+        REQUIRE(p.first.concat(p.second) == xs);
+        REQUIRE(xs.splitAt(5000).first == xs);
+        REQUIRE(xs.splitAt(5000).second.isEmpty());
+    }
+    SECTION("insertAt") {
+        const auto xs = range(0, 100);
+        const auto ys = xs.insertAt(40, -1);
+        REQUIRE(ys.size() == 101);
+        REQUIRE(ys[39] == 39);
+        REQUIRE(ys[40] == -1);
+        REQUIRE(ys[41] == 40);
+        REQUIRE(xs.insertAt(0, -1).head() == -1);
+        REQUIRE(xs.insertAt(100, -1).last() == -1);
+        REQUIRE_THROWS_AS(xs.insertAt(101, -1), std::out_of_range);
+    }
+    SECTION("random splits and joins agree with std::vector") {
+        std::mt19937 gen(42);
+        VI xs = range(0, 2000);
+        std::vector<int> v;
+        for (int i = 0; i < 2000; ++i) {
+            v.push_back(i);
+        }
+        int next = 2000;
+        bool ok = true;
+        for (int step = 0; step < 400; ++step) {
+            const auto pick = [&gen](std::size_t n) {
+                return std::uniform_int_distribution<std::size_t>(0, n)(gen);
+            };
+            switch (gen() % 6) {
+            case 0: {
+                const auto i = pick(v.size());
+                const auto j = pick(v.size());
+                const auto lo = std::min(i, j);
+                const auto hi = std::max(i, j);
+                xs = xs.slice(lo, hi).concat(xs);
+                auto w = range(v, lo, hi);
+                w.insert(w.end(), v.begin(), v.end());
+                v = w;
+                break;
+            }
+            case 1: {
+                const auto p = xs.splitAt(pick(v.size()));
+                xs = p.second.concat(p.first);
+                const auto k = p.first.size();
+                auto w = range(v, k, v.size());
+                w.insert(w.end(), v.begin(), v.begin() + k);
+                v = w;
+                break;
+            }
+            case 2: {
+                const auto i = pick(v.size());
+                xs = xs.insertAt(i, next);
+                v.insert(v.begin() + i, next++);
+                break;
+            }
+            case 3:
+                for (int k = 0; k < 40; ++k) {
+                    xs = xs.appended(next);
+                    v.push_back(next++);
+                }
+                break;
+            case 4:
+                if (!v.empty()) {
+                    const auto i = pick(v.size() - 1);
+                    xs = xs.updated(i, next);
+                    v[i] = next++;
+                }
+                break;
+            default:
+                if (v.size() > 20000) {
+                    const auto i = pick(v.size() / 2);
+                    xs = xs.slice(i, i + v.size() / 2);
+                    v = range(v, i, i + v.size() / 2);
+                }
+                break;
+            }
+            ok = ok && xs.size() == v.size() && xs[v.size() / 3] == v[v.size() / 3];
+        }
+        REQUIRE(ok);
+        REQUIRE(same(xs, v));
+    }
+    SECTION("many small concatenations") {
+        VI xs;
+        std::vector<int> v;
+        for (int i = 0; i < 500; ++i) {
+            const int n = 1 + (i * 37) % 70;
+            xs = xs.concat(range(i * 100, i * 100 + n));
+            for (int k = 0; k < n; ++k) {
+                v.push_back(i * 100 + k);
+            }
+        }
+        REQUIRE(same(xs, v));
+    }
+    SECTION("elements are copied, not shared, across the seam") {
+        Vector<std::string> xs;
+        for (int i = 0; i < 100; ++i) {
+            xs = xs.appended(std::to_string(i));
+        }
+        const auto ys = xs.drop(17).concat(xs.take(50));
+        REQUIRE(ys.size() == 133);
+        REQUIRE(ys[0] == "17");
+        REQUIRE(ys[83] == "0");
+        REQUIRE(ys.last() == "49");
+    }
+    SECTION("parallel map and filter") {
+        const auto xs = range(0, 100000);
+        const ParallelPolicy policy(1000);
+        const auto ys = xs.map(policy, [](int x) { return x * 2; });
+        const auto zs = xs.filter(policy, [](int x) { return x % 3 == 0; });
+        REQUIRE(ys == xs.map([](int x) { return x * 2; }));
+        REQUIRE(zs == xs.filter([](int x) { return x % 3 == 0; }));
+    }
+}
@@ -0,0 +1,64 @@
+#include <string>
+
+#include "catch.hpp"
+
+#include "gungnir/Vector.hpp"
+using gungnir::Vector;
+
+TEST_CASE("test Vector transformations", "[Vector][transform]") {
+
+    using VI = Vector<int>;
+
+    VI xs;
+    for (int i = 0; i < 100; ++i) {
+        xs = xs.appended(i);
+    }
+
+    SECTION("map") {
+        REQUIRE(VI().map([](int x) { return x; }).isEmpty());
+        const auto ys = xs.map([](int x) { return std::to_string(x); });
+        REQUIRE(ys.size() == 100);
+        REQUIRE(ys[42] == "42");
+    }
+    SECTION("filter and filterNot") {
+        const auto even = [](int x) { return x % 2 == 0; };
+        const auto ys = xs.filter(even);
+        const auto zs = xs.filterNot(even);
+        REQUIRE(ys.size() == 50);
+        REQUIRE(zs.size() == 50);
+        REQUIRE(ys[10] == 20);
+        REQUIRE(zs[10] == 21);
+    }
+    SECTION("folds and predicates") {
+        REQUIRE(xs.foldLeft(0, [](int acc, int x) { return acc + x; }) == 4950);
+        REQUIRE(VI(1, 2, 3).foldLeft(std::string(), [](std::string acc, int x) {
+            return acc + std::to_string(x);
+        }) == "123");
+        REQUIRE(VI(1, 2, 3).foldRight(std::string(), [](int x, std::string acc) {
+            return acc + std::to_string(x);
+        }) == "321");
+        REQUIRE(xs.exists([](int x) { return x == 99; }));
+        REQUIRE_FALSE(xs.exists([](int x) { return x == 100; }));
+        REQUIRE(xs.forall([](int x) { return x < 100; }));
+        REQUIRE(xs.contains(64));
+        REQUIRE(xs.count([](int x) { return x % 10 == 0; }) == 10);
+    }
+    SECTION("concat") {
+        REQUIRE(VI().concat(VI()).isEmpty());
+        REQUIRE(VI(1).concat(VI()) == VI(1));
+        REQUIRE(VI().concat(VI(1)) == VI(1));
+        const auto ys = xs.concat(xs);
+        REQUIRE(ys.size() == 200);
+        REQUIRE(ys[99] == 99);
+        REQUIRE(ys[100] == 0);
+        REQUIRE(ys[199] == 99);
+        REQUIRE(xs.size() == 100);
+    }
+    SECTION("equality") {
+        REQUIRE(VI() == VI());
+        REQUIRE(VI(1, 2) == VI(1, 2));
+        REQUIRE(VI(1, 2) != VI(1, 3));
+        REQUIRE(VI(1, 2) != VI(1, 2, 3));
+        REQUIRE(xs.updated(5, 5) == xs);
+    }
+}
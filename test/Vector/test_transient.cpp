@@ -0,0 +1,66 @@
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "catch.hpp"
+
+#include "gungnir/Vector.hpp"
+using gungnir::TransientVector;
+using gungnir::Vector;
+
+TEST_CASE("test TransientVector", "[Vector][TransientVector]") {
+
+    using VI = Vector<int>;
+
+    SECTION("empty transient") {
+        TransientVector<int> t;
+        REQUIRE(t.size() == 0);
+        REQUIRE_THROWS_AS(t.update(0, 1), std::out_of_range);
+        REQUIRE(t.persistent().isEmpty());
+    }
+    SECTION("bulk load") {
+        TransientVector<int> t;
+        for (int i = 0; i < 5000; ++i) {
+            t.append(i);
+        }
+        for (std::size_t i = 0; i < 5000; i += 3) {
+            t.update(i, -static_cast<int>(i));
+        }
+        REQUIRE(t.size() == 5000);
+        REQUIRE(t[3] == -3);
+        const auto xs = t.persistent();
+        REQUIRE(t.size() == 0);
+        REQUIRE(xs.size() == 5000);
+        for (std::size_t i = 0; i < 5000; ++i) {
+            REQUIRE(xs[i] == (i % 3 == 0 ? -static_cast<int>(i) : static_cast<int>(i)));
+        }
+    }
+    SECTION("the original vector is left intact") {
+        VI xs;
+        for (int i = 0; i < 1100; ++i) {
+            xs = xs.appended(i);
+        }
+        auto t = xs.asTransient();
+        for (std::size_t i : { 0, 31, 32, 1023, 1024, 1099 }) {
+            t.update(i, -1);
+            t.update(i, -2);
+        }
+        t.append(1100);
+        const auto ys = t.persistent();
+        REQUIRE(xs.size() == 1100);
+        REQUIRE(ys.size() == 1101);
+        for (std::size_t i : { 0, 31, 32, 1023, 1024, 1099 }) {
+            REQUIRE(xs[i] == static_cast<int>(i));
+            REQUIRE(ys[i] == -2);
+        }
+        REQUIRE(ys[1] == 1);
+        REQUIRE(ys[1100] == 1100);
+    }
+    SECTION("moved vector") {
+        auto t = Vector<std::string>("a", "b").asTransient();
+        t.update(1, 3, 'c').append("d");
+        auto u = std::move(t);
+        REQUIRE(u.persistent() == Vector<std::string>("a", "ccc", "d"));
+    }
+}
@@ -0,0 +1,40 @@
+#include <cstddef>
+#include <stdexcept>
+
+#include "catch.hpp"
+
+#include "gungnir/Vector.hpp"
+using gungnir::Vector;
+
+TEST_CASE("test Vector updated", "[Vector][updated]") {
+
+    using VI = Vector<int>;
+
+    SECTION("empty Vector") {
+        REQUIRE_THROWS_AS(VI().updated(0, 1), std::out_of_range);
+    }
+    SECTION("updating elements in the trie and in the tail") {
+        VI xs;
+        for (int i = 0; i < 2000; ++i) {
+            xs = xs.appended(i);
+        }
+        for (std::size_t i : { 0, 31, 32, 1000, 1023, 1024, 1990, 1999 }) {
+            const auto ys = xs.updated(i, -1);
+            REQUIRE(ys.size() == xs.size());
+            REQUIRE(ys[i] == -1);
+            REQUIRE(xs[i] == static_cast<int>(i));
+            if (i > 0) {
+                REQUIRE(ys[i - 1] == static_cast<int>(i - 1));
+            }
+            if (i + 1 < ys.size()) {
+                REQUIRE(ys[i + 1] == static_cast<int>(i + 1));
+            }
+        }
+        REQUIRE_THROWS_AS(xs.updated(2000, 0), std::out_of_range);
+    }
+    SECTION("updates compose") {
+        const VI xs(1, 2, 3);
+        REQUIRE(xs.updated(0, 10).updated(2, 30) == VI(10, 2, 30));
+        REQUIRE(xs == VI(1, 2, 3));
+    }
+}
@@ -0,0 +1,127 @@
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/BufferView.hpp"
+#include "gungnir/UnrolledList.hpp"
+#include "gungnir/Vector.hpp"
+#include "gungnir/detail/simd.hpp"
+namespace simd = gungnir::detail::simd;
+using gungnir::BufferView;
+using gungnir::UnrolledList;
+using gungnir::Vector;
+
+namespace {
+
+template<typename T>
+void checkKernels()
+{
+    for (std::size_t n = 0; n <= 40; ++n) {
+        std::vector<T> v;
+        for (std::size_t i = 0; i < n; ++i) {
+            v.push_back(static_cast<T>(i % 5));
+        }
+        const auto p = v.data();
+
+        T sum = 0;
+        std::size_t threes = 0;
+        for (const auto& x : v) {
+            sum += x;
+            threes += x == 3 ? 1 : 0;
+        }
+        REQUIRE(simd::sum(p, n) == sum);
+        REQUIRE(simd::count(p, n, T(3)) == threes);
+        REQUIRE(simd::contains(p, n, T(3)) == (threes > 0));
+        REQUIRE_FALSE(simd::contains(p, n, T(7)));
+        REQUIRE(simd::count(p, n, T(7)) == 0);
+        if (n > 0) {
+            REQUIRE(simd::contains(p, n, v.back()));
+        }
+
+        // Factors of 1, 2 and -1 keep every product exact.
+        std::vector<T> f;
+        T product = 1;
+        for (std::size_t i = 0; i < n; ++i) {
+            f.push_back(static_cast<T>(i % 3 == 0 ? 2 : i % 7 == 4 ? -1 : 1));
+            product *= f.back();
+        }
+        REQUIRE(simd::product(f.data(), n) == product);
+        if (n > 0) {
+            f[n / 2] = 0;
+            REQUIRE(simd::product(f.data(), n) == 0);
+        }
+    }
+}
+
+}  // unnamed namespace
+
+TEST_CASE("test SIMD kernels", "[simd]") {
+
+    SECTION("int, float and double kernels agree with scalar loops") {
+        checkKernels<int>();
+        checkKernels<float>();
+        checkKernels<double>();
+        checkKernels<long>();
+    }
+    SECTION("integer products wrap around") {
+        const std::vector<int> v(40, 3);
+        unsigned expected = 1;
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            expected *= 3u;
+        }
+        REQUIRE(static_cast<unsigned>(simd::product(v.data(), v.size())) == expected);
+    }
+    SECTION("NaN is never equal") {
+        const auto nan = std::numeric_limits<double>::quiet_NaN();
+        const std::vector<double> v(9, nan);
+        REQUIRE(simd::count(v.data(), v.size(), nan) == 0);
+        REQUIRE_FALSE(simd::contains(v.data(), v.size(), nan));
+    }
+    SECTION("non-arithmetic types use the generic loops") {
+        const std::vector<std::string> v { "a", "b", "a" };
+        REQUIRE(simd::count(v.data(), v.size(), std::string("a")) == 2);
+        REQUIRE(simd::contains(v.data(), v.size(), std::string("b")));
+    }
+    SECTION("containers use the kernels") {
+        std::vector<int> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(i % 10);
+        }
+        const UnrolledList<int> xs(v.begin(), v.end());
+        REQUIRE(xs.sum() == 4500);
+        REQUIRE(xs.tail().sum() == 4500);
+        REQUIRE(xs.drop(5).sum() == 4490);
+        REQUIRE(xs.count(3) == 100);
+        REQUIRE(xs.drop(4).count(3) == 99);
+        REQUIRE(xs.contains(9));
+        REQUIRE_FALSE(xs.contains(10));
+        REQUIRE(xs.prepend(10).contains(10));
+
+        const Vector<int> ys(v.begin(), v.end());
+        REQUIRE(ys.sum() == 4500);
+        REQUIRE(ys.count(3) == 100);
+        REQUIRE(ys.contains(9));
+        REQUIRE_FALSE(ys.contains(10));
+
+        const Vector<double> zs(v.begin(), v.end());
+        REQUIRE(zs.sum() == 4500.0);
+        REQUIRE(zs.count(3.0) == 100);
+
+        std::vector<double> w;
+        for (int i = 0; i < 100; ++i) {
+            w.push_back(i % 10 == 0 ? 2.0 : 1.0);
+        }
+        REQUIRE(UnrolledList<double>(w.begin(), w.end()).product() == 1024.0);
+        REQUIRE(UnrolledList<double>(w.begin(), w.end()).drop(1).product() == 512.0);
+        REQUIRE(UnrolledList<double>().product() == 1.0);
+        REQUIRE(Vector<double>(w.begin(), w.end()).product() == 1024.0);
+        REQUIRE(Vector<int>().product() == 1);
+        REQUIRE(ys.product() == 0);
+        REQUIRE(BufferView<double>(std::vector<double>(w)).product() == 1024.0);
+        REQUIRE(BufferView<double>(std::vector<double>(w)).drop(91).product() == 1.0);
+        REQUIRE(BufferView<int>().product() == 1);
+    }
+}
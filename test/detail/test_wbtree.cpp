@@ -0,0 +1,129 @@
+#include <functional>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/detail/wbtree.hpp"
+
+namespace {
+
+struct Identity {
+    const int& operator()(const int& x) const
+    {
+        return x;
+    }
+};
+
+using Tree = gungnir::detail::WeightTree<int, Identity, std::less<int>, std::allocator<int>>;
+
+bool matches(const Tree& t, const std::set<int>& expected)
+{
+    if (!t.isValid() || t.size() != expected.size()) {
+        return false;
+    }
+    auto it = expected.begin();
+    return t.foreachWhile([&it](int x) { return x == *it++; });
+}
+
+}  // namespace
+
+TEST_CASE("test WeightTree", "[detail]") {
+
+    SECTION("ascending, descending and random insertions stay balanced") {
+        Tree up{std::allocator<int>()};
+        Tree down{std::allocator<int>()};
+        std::set<int> expected;
+        for (int i = 0; i < 5000; ++i) {
+            up.insert(i);
+            down.insert(-i);
+            expected.insert(i);
+        }
+        REQUIRE(matches(up, expected));
+        REQUIRE(down.isValid());
+        REQUIRE(*down.min() == -4999);
+        REQUIRE(*down.max() == 0);
+
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> key(0, 3000);
+        Tree t{std::allocator<int>()};
+        expected.clear();
+        bool ok = true;
+        for (int i = 0; i < 20000; ++i) {
+            const auto k = key(rng);
+            if (i % 3 == 0) {
+                REQUIRE(t.erase(k) == (expected.erase(k) == 1));
+            } else {
+                t.insert(k);
+                expected.insert(k);
+            }
+            if (i % 500 == 0) {
+                ok = ok && matches(t, expected);
+            }
+        }
+        REQUIRE(ok);
+        REQUIRE(matches(t, expected));
+    }
+    SECTION("restrict joins the cut subtrees into balanced trees") {
+        Tree t{std::allocator<int>()};
+        for (int i = 0; i < 2000; i += 2) {
+            t.insert(i);
+        }
+        bool ok = true;
+        for (int lo = -3; lo < 2003; lo += 37) {
+            for (int hi = lo; hi < 2010; hi += 101) {
+                auto r = t;
+                r.restrict(&lo, &hi);
+                std::set<int> expected;
+                for (int i = 0; i < 2000; i += 2) {
+                    if (i >= lo && i < hi) {
+                        expected.insert(i);
+                    }
+                }
+                ok = ok && matches(r, expected);
+            }
+        }
+        REQUIRE(ok);
+
+        const int mid = 1000;
+        auto low = t;
+        auto high = t;
+        low.restrict(nullptr, &mid);
+        high.restrict(&mid, nullptr);
+        REQUIRE(low.size() == 500);
+        REQUIRE(high.size() == 500);
+        REQUIRE(*high.min() == 1000);
+        REQUIRE(low.isValid());
+        REQUIRE(high.isValid());
+    }
+    SECTION("sorted construction and filter") {
+        for (int n = 0; n < 200; ++n) {
+            std::vector<int> xs;
+            std::set<int> expected;
+            for (int i = 0; i < n; ++i) {
+                xs.push_back(i / 2);
+                expected.insert(i / 2);
+            }
+            Tree t{std::allocator<int>()};
+            t.assignSorted(xs.begin(), xs.end());
+            REQUIRE(matches(t, expected));
+        }
+        const std::vector<int> unsorted { 1, 3, 2 };
+        Tree t{std::allocator<int>()};
+        REQUIRE_THROWS_AS(t.assignSorted(unsorted.begin(), unsorted.end()), std::invalid_argument);
+
+        for (int i = 0; i < 3000; ++i) {
+            t.insert(i);
+        }
+        const auto odd = t.filter([](int x) { return x % 2 == 1; });
+        const auto small = t.filter([](int x) { return x < 100 || x % 97 == 0; });
+        REQUIRE(odd.isValid());
+        REQUIRE(odd.size() == 1500);
+        REQUIRE(small.isValid());
+        REQUIRE(small.size() == 100 + 29);
+        REQUIRE(t.filter([](int) { return true; }).same(t));
+    }
+}
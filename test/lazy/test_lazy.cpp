@@ -0,0 +1,101 @@
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/lazy.hpp"
+using gungnir::Lazy;
+using gungnir::lazy;
+
+TEST_CASE("test Lazy", "[Lazy]") {
+
+    SECTION("values are computed once, on first access") {
+        int calls = 0;
+        const auto x = lazy([&calls] {
+            ++calls;
+            return std::string("abc");
+        });
+        REQUIRE_FALSE(x.isForced());
+        REQUIRE(calls == 0);
+        REQUIRE(x.get() == "abc");
+        REQUIRE(x() == "abc");
+        REQUIRE(x.isForced());
+        REQUIRE(calls == 1);
+    }
+    SECTION("lazy values of one type store any function") {
+        std::vector<Lazy<int>> xs;
+        const std::array<int, 16> big {{1, 2, 3}};
+        auto p = std::unique_ptr<int>(new int(7));
+        xs.emplace_back([] { return 1; });
+        xs.emplace_back([big] { return big[2]; });
+        xs.push_back(lazy([&p] { return *p; }));
+        xs.push_back(lazy(std::bind([](int a, int b) { return a * b; }, 6, 7)));
+        int sum = 0;
+        for (const auto& x : xs) {
+            sum += x.get();
+        }
+        REQUIRE(sum == 1 + 3 + 7 + 42);
+    }
+    SECTION("moves") {
+        auto x = lazy([] { return std::unique_ptr<int>(new int(5)); });
+        auto y = std::move(x);
+        REQUIRE(*y.get() == 5);
+        auto z = std::move(y);
+        REQUIRE(z.isForced());
+        REQUIRE(*z.get() == 5);
+
+        auto big = lazy([] { return std::string(100, 'x'); }).map([](std::string s) { return s.size(); });
+        big = lazy([] { return std::size_t(3); });
+        REQUIRE(big.get() == 3);
+    }
+    SECTION("map and flatMap compose lazily") {
+        int calls = 0;
+        auto x = lazy([&calls] {
+            ++calls;
+            return 20;
+        });
+        auto y = std::move(x).map([&calls](int v) {
+            ++calls;
+            return v + 1;
+        }).map([](int v) { return std::to_string(v * 2); });
+        REQUIRE(calls == 0);
+        REQUIRE(y.get() == "42");
+        REQUIRE(calls == 2);
+
+        auto z = lazy([] { return 3; }).flatMap([&calls](int n) {
+            ++calls;
+            return lazy([n] { return std::string(n, 'z'); });
+        });
+        REQUIRE(calls == 2);
+        REQUIRE(z.get() == "zzz");
+        REQUIRE(calls == 3);
+
+        auto moved = lazy([] { return std::unique_ptr<int>(new int(9)); })
+            .map([](std::unique_ptr<int> p) { return *p + 1; });
+        REQUIRE(moved.get() == 10);
+    }
+    SECTION("failures are retried") {
+        int calls = 0;
+        const auto x = lazy([&calls] {
+            if (++calls == 1) {
+                throw std::runtime_error("first try");
+            }
+            return calls;
+        });
+        REQUIRE_THROWS_AS(x.get(), std::runtime_error);
+        REQUIRE_FALSE(x.isForced());
+        REQUIRE(x.get() == 2);
+        REQUIRE(x.get() == 2);
+    }
+    SECTION("functions are destroyed once the value is computed") {
+        auto token = std::make_shared<int>(0);
+        const auto x = lazy([token] { return 1; });
+        REQUIRE(token.use_count() == 2);
+        x.get();
+        REQUIRE(token.use_count() == 1);
+    }
+}
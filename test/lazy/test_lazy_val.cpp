@@ -1,4 +1,5 @@
 #include <memory>
+#include <string>
 
 #include "catch.hpp"
 
@@ -145,4 +146,25 @@ TEST_CASE("test lazyVal", "[lazyVal]") {
         REQUIRE(*poi.sp == 456);
         REQUIRE(poi.sp.use_count() == 1);
     }
+    SECTION("moving forced values") {
+        auto foo = lazyVal<Foo>(UP(new int(123)));
+        REQUIRE(*foo().up == 123);
+
+        auto bar = std::move(foo);
+        REQUIRE(*bar().up == 123);
+        REQUIRE(foo().up == nullptr);
+
+        auto poi = lazyVal<Foo>(UP(new int(456)));
+        poi = std::move(bar);
+        REQUIRE(*poi().up == 123);
+
+        auto baz = lazyVal<Foo>(UP(new int(789)));
+        poi = std::move(baz);
+        REQUIRE(*poi().up == 789);
+    }
+    SECTION("arguments are stored inline") {
+        using gungnir::LazyVal;
+        REQUIRE(sizeof (LazyVal<std::string, int, char>) <= sizeof (std::string) + alignof (std::string));
+        REQUIRE(sizeof (LazyVal<int, int>) == 2 * sizeof (int));
+    }
 }
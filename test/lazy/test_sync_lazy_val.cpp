@@ -0,0 +1,85 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/lazy.hpp"
+using gungnir::syncLazyVal;
+
+TEST_CASE("test syncLazyVal", "[syncLazyVal]") {
+
+    using UP = std::unique_ptr<int>;
+
+    static std::atomic<int> count(0);
+
+    struct Slow {
+        explicit Slow(int x) : x(x)
+        {
+            ++count;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+
+        int x;
+    };
+
+    struct Flaky {
+        explicit Flaky(int x) : x(x)
+        {
+            if (++count == 1) {
+                throw std::runtime_error("first try");
+            }
+        }
+
+        int x;
+    };
+
+    SECTION("values are constructed on first access") {
+        count = 0;
+        const auto p = syncLazyVal<UP>(new int(123));
+        REQUIRE(*p() == 123);
+
+        const auto s = syncLazyVal<Slow>(1);
+        REQUIRE(count == 0);
+        REQUIRE(s().x == 1);
+        REQUIRE(s.get().x == 1);
+        REQUIRE(count == 1);
+    }
+    SECTION("concurrent first accesses construct the value once") {
+        count = 0;
+        const auto s = syncLazyVal<Slow>(42);
+        std::atomic<int> sum(0);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 8; ++i) {
+            threads.emplace_back([&] { sum += s().x; });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        REQUIRE(count == 1);
+        REQUIRE(sum == 8 * 42);
+    }
+    SECTION("a throwing constructor is retried") {
+        count = 0;
+        const auto f = syncLazyVal<Flaky>(7);
+        REQUIRE_THROWS_AS(f(), std::runtime_error);
+        REQUIRE(f().x == 7);
+        REQUIRE(count == 2);
+    }
+    SECTION("moving values") {
+        auto p = syncLazyVal<UP>(new int(1));
+        auto q = std::move(p);
+        REQUIRE(*q() == 1);
+
+        auto r = std::move(q);
+        REQUIRE(q() == nullptr);
+        REQUIRE(*r() == 1);
+
+        auto& x = r.get();
+        x.reset(new int(2));
+        REQUIRE(*r() == 2);
+    }
+}
@@ -0,0 +1,38 @@
+#!/bin/sh
+# Builds and runs the tests under every supported combination of C++
+# standard, optimization level and sanitizer, then with the instrumented List,
+# stopping at the first failure.
+#
+# Usage: test/matrix.sh [build-root]
+
+set -e
+
+src=$(cd "$(dirname "$0")" && pwd)
+root=${1:-build-matrix}
+jobs=${JOBS:-$(nproc 2>/dev/null || echo 2)}
+
+for std in 11 14 17 20; do
+  for type in Debug RelWithDebInfo Release; do
+    for san in none address,undefined thread; do
+      dir="$root/c++$std-$type-$san"
+      [ "$san" = none ] && san=
+      echo "==> $dir"
+      cmake -S "$src" -B "$dir" -DCMAKE_BUILD_TYPE="$type" \
+            -DGUNGNIR_CXX_STANDARD="$std" -DGUNGNIR_SANITIZE="$san" \
+            -DGUNGNIR_TEST_INSTRUMENTED=OFF > /dev/null
+      cmake --build "$dir" -j"$jobs"
+      "$dir/test_all"
+    done
+  done
+done
+
+# The instrumented List, checked once per standard.
+for std in 11 14 17 20; do
+  dir="$root/c++$std-Debug-instrumented"
+  echo "==> $dir"
+  cmake -S "$src" -B "$dir" -DCMAKE_BUILD_TYPE=Debug \
+        -DGUNGNIR_CXX_STANDARD="$std" -DGUNGNIR_SANITIZE= \
+        -DGUNGNIR_TEST_INSTRUMENTED=ON > /dev/null
+  cmake --build "$dir" -j"$jobs"
+  "$dir/test_all"
+done
@@ -0,0 +1,125 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gungnir/List.hpp"
+#include "gungnir/memoize.hpp"
+using gungnir::List;
+using gungnir::memoize;
+
+TEST_CASE("test memoize", "[memoize]") {
+
+    SECTION("results are computed once per key") {
+        int calls = 0;
+        const auto square = memoize<int>([&calls](int x) {
+            ++calls;
+            return x * x;
+        });
+        REQUIRE(square(3) == 9);
+        REQUIRE(square(3) == 9);
+        REQUIRE(square(4) == 16);
+        REQUIRE(calls == 2);
+        REQUIRE(square.size() == 2);
+
+        const auto copy = square;
+        REQUIRE(copy(4) == 16);
+        REQUIRE(calls == 2);
+
+        square.clear();
+        REQUIRE(square.size() == 0);
+        REQUIRE(copy(4) == 16);
+        REQUIRE(calls == 3);
+    }
+    SECTION("keys of other types") {
+        const auto words = memoize<std::string>([](const std::string& s) {
+            return List<char>(s.begin(), s.end()).reverse();
+        });
+        REQUIRE(words("abc") == List<char>('c', 'b', 'a'));
+        REQUIRE(words("abc").size() == 3);
+    }
+    SECTION("bounded tables forget the least recently used results") {
+        std::vector<int> calls(1000);
+        const auto f = memoize<int>([&calls](int x) {
+            ++calls[x];
+            return x;
+        }, 64);
+        for (int round = 0; round < 3; ++round) {
+            for (int x = 0; x < 1000; ++x) {
+                REQUIRE(f(x) == x);
+            }
+        }
+        REQUIRE(f.size() <= 64);
+        REQUIRE(calls[999] == 3);
+
+        // Recently used keys survive a stream of others in their shard.
+        for (int x = 0; x < 1000; ++x) {
+            f(0);
+            f(x);
+        }
+        REQUIRE(calls[0] == 4);
+    }
+    SECTION("failures are not remembered") {
+        int calls = 0;
+        const auto flaky = memoize<int>([&calls](int x) {
+            if (++calls == 1) {
+                throw std::runtime_error("first try");
+            }
+            return x + 1;
+        });
+        REQUIRE_THROWS_AS(flaky(1), std::runtime_error);
+        REQUIRE(flaky(1) == 2);
+        REQUIRE(flaky(1) == 2);
+        REQUIRE(calls == 2);
+    }
+    SECTION("concurrent callers with the same key compute it once") {
+        std::atomic<int> calls(0);
+        const auto slow = memoize<int>([&calls](int x) {
+            ++calls;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return x * 2;
+        });
+        std::atomic<int> sum(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&slow, &sum, t] {
+                sum += slow(21);
+                sum += slow(t % 2);
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        REQUIRE(calls == 3);
+        REQUIRE(sum == 8 * 42 + 4 * 2);
+    }
+    SECTION("concurrent callers on a bounded table") {
+        std::atomic<int> calls(0);
+        const auto f = memoize<int>([&calls](int x) {
+            ++calls;
+            return x * 3;
+        }, 128);
+        std::vector<std::thread> threads;
+        std::atomic<bool> ok(true);
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&f, &ok, t] {
+                for (int i = 0; i < 5000; ++i) {
+                    const auto x = (i * 7 + t) % 500;
+                    if (f(x) != x * 3) {
+                        ok = false;
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        REQUIRE(ok);
+        REQUIRE(f.size() <= 128);
+    }
+}
@@ -0,0 +1,165 @@
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "catch.hpp"
+
+#include "gungnir/serialize.hpp"
+using gungnir::BufferView;
+using gungnir::Codec;
+using gungnir::List;
+using gungnir::Option;
+
+namespace {
+
+struct Point {
+    double x;
+    int y;
+};
+
+struct Named {
+    std::string name;
+    int id;
+
+    bool operator==(const Named& that) const
+    {
+        return name == that.name && id == that.id;
+    }
+
+    bool operator!=(const Named& that) const
+    {
+        return !(*this == that);
+    }
+};
+
+template<typename A>
+List<A> roundTrip(const List<A>& xs)
+{
+    std::stringstream ss;
+    gungnir::serialize(ss, xs);
+    return gungnir::deserializeList<A>(ss);
+}
+
+template<typename A>
+Option<A> roundTrip(const Option<A>& x)
+{
+    std::stringstream ss;
+    gungnir::serialize(ss, x);
+    return gungnir::deserializeOption<A>(ss);
+}
+
+// Copies the contents of `ss` into a buffer aligned for any element type.
+std::pair<std::shared_ptr<const char>, std::size_t> bytesOf(const std::stringstream& ss)
+{
+    const auto s = ss.str();
+    std::shared_ptr<std::max_align_t> buf(
+        new std::max_align_t[s.size() / sizeof (std::max_align_t) + 1],
+        std::default_delete<std::max_align_t[]>());
+    std::memcpy(buf.get(), s.data(), s.size());
+    return std::make_pair(
+        std::shared_ptr<const char>(buf, reinterpret_cast<const char*>(buf.get())),
+        s.size());
+}
+
+}  // namespace
+
+namespace gungnir {
+
+template<>
+struct Codec<Named> {
+    static void encode(std::ostream& out, const Named& x)
+    {
+        Codec<std::string>::encode(out, x.name);
+        Codec<int>::encode(out, x.id);
+    }
+
+    static Named decode(std::istream& in)
+    {
+        auto name = Codec<std::string>::decode(in);
+        return Named { std::move(name), Codec<int>::decode(in) };
+    }
+};
+
+}  // namespace gungnir
+
+TEST_CASE("test serialize", "[serialize]") {
+
+    List<int> xs;
+    for (int i = 999; i >= 0; --i) {
+        xs = xs.prepend(i);
+    }
+
+    SECTION("lists of trivially copyable elements") {
+        REQUIRE(roundTrip(List<int>()).isEmpty());
+        REQUIRE(roundTrip(xs) == xs);
+
+        const List<Point> ps = xs.map([](int i) { return Point { i / 2.0, -i }; });
+        const auto qs = roundTrip(ps);
+        REQUIRE(qs.size() == ps.size());
+        REQUIRE(qs.zipWith(ps, [](const Point& p, const Point& q) {
+            return p.x == q.x && p.y == q.y;
+        }).forall([](bool b) { return b; }));
+    }
+    SECTION("lists of encoded elements") {
+        const List<std::string> ss = xs.map([](int i) { return std::string(i % 7, 'a' + i % 26); });
+        REQUIRE(roundTrip(ss) == ss);
+
+        const List<Named> ns(Named { "x", 1 }, Named { "", 2 }, Named { "zzz", 3 });
+        REQUIRE(roundTrip(ns) == ns);
+    }
+    SECTION("options") {
+        REQUIRE(roundTrip(Option<int>()).isEmpty());
+        REQUIRE(roundTrip(Option<int>(42)).get() == 42);
+        REQUIRE(roundTrip(Option<std::string>("hi")).get() == "hi");
+
+        std::stringstream ss;
+        gungnir::serialize(ss, List<int>(1, 2));
+        REQUIRE_THROWS_AS(gungnir::deserializeOption<int>(ss), std::runtime_error);
+    }
+    SECTION("malformed snapshots") {
+        std::stringstream ss;
+        gungnir::serialize(ss, xs);
+        REQUIRE_THROWS_AS(gungnir::deserializeList<long long>(ss), std::runtime_error);
+
+        std::stringstream truncated(ss.str().substr(0, 100));
+        REQUIRE_THROWS_AS(gungnir::deserializeList<int>(truncated), std::runtime_error);
+
+        std::stringstream garbage("not a snapshot at all");
+        REQUIRE_THROWS_AS(gungnir::deserializeList<int>(garbage), std::runtime_error);
+    }
+    SECTION("viewSnapshot") {
+        std::stringstream ss;
+        gungnir::serialize(ss, xs);
+        const auto bytes = bytesOf(ss);
+        const auto view = gungnir::viewSnapshot<int>(bytes.first, bytes.second);
+        REQUIRE(view.size() == 1000);
+        REQUIRE(view.toList() == xs);
+        REQUIRE(view.data() == reinterpret_cast<const int*>(bytes.first.get() + 16));
+
+        REQUIRE_THROWS_AS(gungnir::viewSnapshot<int>(bytes.first, bytes.second - 1), std::runtime_error);
+        REQUIRE_THROWS_AS(gungnir::viewSnapshot<short>(bytes.first, bytes.second), std::runtime_error);
+    }
+#ifdef GUNGNIR_HAS_MMAP
+    SECTION("mapSnapshot") {
+        const std::string path = "test_serialize.snapshot";
+        {
+            std::ofstream out(path, std::ios::binary);
+            gungnir::serialize(out, xs);
+        }
+        BufferView<int> view;
+        {
+            const auto whole = gungnir::mapSnapshot<int>(path);
+            view = whole.drop(500);
+        }
+        std::remove(path.c_str());
+        REQUIRE(view.size() == 500);
+        REQUIRE(view.head() == 500);
+        REQUIRE(view.sum() == 374750);
+
+        REQUIRE_THROWS_AS(gungnir::mapSnapshot<int>(path), std::system_error);
+    }
+#endif
+}